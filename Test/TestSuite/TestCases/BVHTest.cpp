@@ -0,0 +1,1079 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#include "BVHTest.h"
+#include "../Suites.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/MetricRegistry.h>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <gmtl/BVH.h>
+#include <gmtl/BVHOps.h>
+#include <gmtl/LinearBVH.h>
+#include <gmtl/Containment.h>
+#include <gmtl/Intersection.h>
+#include <gmtl/TriOps.h>
+#include <gmtl/Frustum.h>
+#include <gmtl/FrustumOps.h>
+#include <gmtl/Generate.h>
+
+namespace gmtlTest
+{
+   CPPUNIT_TEST_SUITE_REGISTRATION(BVHTest);
+   CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(BVHMetricTest, Suites::metric());
+
+   /** Fills tris with a bumpy grid of (2 * res * res) triangles facing +z
+    *  over [-1, 1]^2, a few triangles floating above it (facing down every
+    *  other one) and some degenerate ones.
+    */
+   template<class DATA_TYPE>
+   static void fillMesh( std::vector< gmtl::Tri<DATA_TYPE> >& tris, const unsigned int res )
+   {
+      typedef gmtl::Point<DATA_TYPE, 3> PointType;
+      tris.clear();
+      const DATA_TYPE step = DATA_TYPE( 2.0 ) / DATA_TYPE( res );
+      for (unsigned int j = 0; j < res; ++j)
+      {
+         for (unsigned int i = 0; i < res; ++i)
+         {
+            PointType p[4];
+            for (unsigned int k = 0; k < 4; ++k)
+            {
+               const DATA_TYPE x = DATA_TYPE( -1.0 ) + step * DATA_TYPE( i + (k & 1) );
+               const DATA_TYPE y = DATA_TYPE( -1.0 ) + step * DATA_TYPE( j + (k >> 1) );
+               p[k].set( x, y, DATA_TYPE( 0.1 ) * gmtl::Math::sin( x * DATA_TYPE( 5.0 ) ) *
+                                                   gmtl::Math::cos( y * DATA_TYPE( 3.0 ) ) );
+            }
+            tris.push_back( gmtl::Tri<DATA_TYPE>( p[0], p[1], p[3] ) );
+            tris.push_back( gmtl::Tri<DATA_TYPE>( p[0], p[3], p[2] ) );
+         }
+      }
+      for (unsigned int i = 0; i < 64; ++i)
+      {
+         const DATA_TYPE f = DATA_TYPE( i );
+         const PointType c( gmtl::Math::sin( f * DATA_TYPE( 1.3 ) ), gmtl::Math::cos( f * DATA_TYPE( 0.7 ) ),
+                            DATA_TYPE( 0.3 ) + DATA_TYPE( 0.01 ) * f );
+         const DATA_TYPE s = DATA_TYPE( 0.05 ) + DATA_TYPE( 0.002 ) * f;
+         const PointType a( c[0] - s, c[1] - s, c[2] ), b( c[0] + s, c[1] - s, c[2] ), d( c[0], c[1] + s, c[2] + s );
+         tris.push_back( (i & 1) ? gmtl::Tri<DATA_TYPE>( a, b, d ) : gmtl::Tri<DATA_TYPE>( a, d, b ) );
+      }
+      const PointType z( DATA_TYPE( 0.2 ), DATA_TYPE( 0.2 ), DATA_TYPE( 0.5 ) );
+      tris.push_back( gmtl::Tri<DATA_TYPE>( z, z, z ) );
+      tris.push_back( gmtl::Tri<DATA_TYPE>( z, z + gmtl::Vec<DATA_TYPE, 3>( 0, 0, 1 ), z ) );
+   }
+
+   /** Fills rays with count rays from above the mesh, most of them pointing
+    *  down towards it, some of them along the axes and some missing it.
+    */
+   template<class DATA_TYPE>
+   static void fillRays( std::vector< gmtl::Ray<DATA_TYPE> >& rays, const std::size_t count )
+   {
+      typedef gmtl::Point<DATA_TYPE, 3> PointType;
+      typedef gmtl::Vec<DATA_TYPE, 3> VecType;
+      rays.resize( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         const DATA_TYPE f = DATA_TYPE( i );
+         const PointType origin( DATA_TYPE( 1.2 ) * gmtl::Math::sin( f * DATA_TYPE( 2.1 ) ),
+                                 DATA_TYPE( 1.2 ) * gmtl::Math::cos( f * DATA_TYPE( 0.9 ) + DATA_TYPE( 1.0 ) ),
+                                 DATA_TYPE( 1.0 ) + DATA_TYPE( 0.5 ) * gmtl::Math::sin( f * DATA_TYPE( 0.37 ) ) );
+         VecType dir( DATA_TYPE( 0.6 ) * gmtl::Math::sin( f * DATA_TYPE( 1.7 ) ),
+                      DATA_TYPE( 0.6 ) * gmtl::Math::cos( f * DATA_TYPE( 2.3 ) ),
+                      DATA_TYPE( -1.0 ) + DATA_TYPE( 0.4 ) * gmtl::Math::sin( f * DATA_TYPE( 0.53 ) ) );
+         switch (i % 8)
+         {
+         case 0:
+            dir.set( 0, 0, -1 );
+            break;
+         case 1:
+            dir.set( 0, 0, DATA_TYPE( -0.5 ) );
+            break;
+         case 2:
+            dir.set( dir[0], 0, dir[2] );
+            break;
+         case 3:
+            dir = -dir;
+            break;
+         }
+         rays[i].setOrigin( origin );
+         rays[i].setDir( dir );
+      }
+   }
+
+   /** The center of the bounds of tri. */
+   template<class DATA_TYPE>
+   static gmtl::Point<DATA_TYPE, 3> boundsCenter( const gmtl::Tri<DATA_TYPE>& tri )
+   {
+      gmtl::AABox<DATA_TYPE> box( tri[0], tri[0] );
+      gmtl::extendVolume( box, tri[1] );
+      gmtl::extendVolume( box, tri[2] );
+      return (box.mMin + box.mMax) * DATA_TYPE( 0.5 );
+   }
+
+   /** Checks the structure of bvh, built from tris. */
+   template<class DATA_TYPE>
+   static void checkTree( const gmtl::BVH<DATA_TYPE>& bvh, const std::vector< gmtl::Tri<DATA_TYPE> >& tris,
+                          const unsigned int maxLeafSize )
+   {
+      typedef gmtl::BVHNode<DATA_TYPE> Node;
+      CPPUNIT_ASSERT( bvh.getNumTris() == tris.size() );
+      CPPUNIT_ASSERT( bvh.mTriIndices.size() == tris.size() );
+      if (tris.empty())
+      {
+         CPPUNIT_ASSERT( bvh.empty() && bvh.getNumNodes() == 0 && bvh.getDepth() == 0 );
+         return;
+      }
+      CPPUNIT_ASSERT( !bvh.empty() );
+      CPPUNIT_ASSERT( bvh.getDepth() >= 1 && bvh.getDepth() <= gmtl::BVH<DATA_TYPE>::MaxDepth );
+
+      // mTris is a permutation of tris
+      std::vector<unsigned int> seen( tris.size(), 0 );
+      for (std::size_t i = 0; i < tris.size(); ++i)
+      {
+         CPPUNIT_ASSERT( bvh.mTriIndices[i] < tris.size() );
+         ++seen[bvh.mTriIndices[i]];
+         CPPUNIT_ASSERT( bvh.mTris[i] == tris[bvh.mTriIndices[i]] );
+      }
+      for (std::size_t i = 0; i < tris.size(); ++i)
+      {
+         CPPUNIT_ASSERT( seen[i] == 1 );
+      }
+
+      // every node is reached once, the leaves cover all the triangles once,
+      // and the bounds of the children are inside their parent
+      std::vector<unsigned int> covered( tris.size(), 0 ), reached( bvh.getNumNodes(), 0 );
+      std::vector<unsigned int> stack( 1, 0 );
+      while (!stack.empty())
+      {
+         const unsigned int index = stack.back();
+         stack.pop_back();
+         CPPUNIT_ASSERT( index < bvh.getNumNodes() );
+         ++reached[index];
+         const Node& node = bvh.mNodes[index];
+         if (node.isLeaf())
+         {
+            CPPUNIT_ASSERT( node.mFirst + node.mCount <= tris.size() );
+            for (unsigned int i = node.mFirst; i < node.mFirst + node.mCount; ++i)
+            {
+               ++covered[i];
+               for (unsigned int k = 0; k < 3; ++k)
+               {
+                  CPPUNIT_ASSERT( gmtl::isInVolume( node.mBounds, bvh.mTris[i][k] ) );
+               }
+            }
+            if (node.mCount > maxLeafSize)
+            {
+               // only triangles with the same bounds centroid share a leaf
+               const gmtl::Point<DATA_TYPE, 3> c = boundsCenter( bvh.mTris[node.mFirst] );
+               for (unsigned int i = node.mFirst + 1; i < node.mFirst + node.mCount; ++i)
+               {
+                  CPPUNIT_ASSERT( gmtl::isEqual( c, boundsCenter( bvh.mTris[i] ), DATA_TYPE( 1e-5 ) ) );
+               }
+            }
+         }
+         else
+         {
+            CPPUNIT_ASSERT( node.mFirst > index && node.mFirst + 1 < bvh.getNumNodes() );
+            CPPUNIT_ASSERT( gmtl::isInVolume( node.mBounds, bvh.mNodes[node.mFirst].mBounds ) );
+            CPPUNIT_ASSERT( gmtl::isInVolume( node.mBounds, bvh.mNodes[node.mFirst + 1].mBounds ) );
+            stack.push_back( node.mFirst );
+            stack.push_back( node.mFirst + 1 );
+         }
+      }
+      for (std::size_t i = 0; i < covered.size(); ++i)
+      {
+         CPPUNIT_ASSERT( covered[i] == 1 );
+      }
+      for (std::size_t i = 0; i < reached.size(); ++i)
+      {
+         CPPUNIT_ASSERT( reached[i] == 1 );
+      }
+   }
+
+   void BVHTest::testBuild()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillMesh( tris, 32 );
+
+      gmtl::BVHf bvh( &tris[0], tris.size() );
+      checkTree( bvh, tris, 4 );
+      CPPUNIT_ASSERT( bvh.getDepth() < 32 );
+      for (unsigned int k = 0; k < 3; ++k)
+      {
+         CPPUNIT_ASSERT( gmtl::isInVolume( bvh.getBounds(), tris[0][k] ) );
+      }
+
+      gmtl::BVHf bvh1;
+      bvh1.build( &tris[0], tris.size(), 1 );
+      checkTree( bvh1, tris, 1 );
+      bvh1.build( &tris[0], tris.size(), 16 );
+      checkTree( bvh1, tris, 16 );
+
+      // rebuilding replaces the triangles
+      bvh1.build( &tris[0], 1 );
+      checkTree( bvh1, std::vector<gmtl::Trif>( tris.begin(), tris.begin() + 1 ), 4 );
+      CPPUNIT_ASSERT( bvh1.getNumNodes() == 1 && bvh1.getDepth() == 1 );
+      bvh1.clear();
+      checkTree( bvh1, std::vector<gmtl::Trif>(), 4 );
+
+      std::vector<gmtl::Trid> trisd;
+      fillMesh( trisd, 8 );
+      gmtl::BVHd bvhd( &trisd[0], trisd.size(), 2 );
+      checkTree( bvhd, trisd, 2 );
+   }
+
+   void BVHTest::testBuildDegenerate()
+   {
+      // empty
+      gmtl::BVHf empty( NULL, 0 );
+      checkTree( empty, std::vector<gmtl::Trif>(), 4 );
+      float u, v, t;
+      unsigned int tri;
+      const gmtl::Rayf ray( gmtl::Point3f( 0, 0, 1 ), gmtl::Vec3f( 0, 0, -1 ) );
+      CPPUNIT_ASSERT( !gmtl::intersect( empty, ray, u, v, t, tri ) );
+      CPPUNIT_ASSERT( !gmtl::intersectAny( empty, ray ) );
+
+      // the same triangle many times can not be split
+      std::vector<gmtl::Trif> same( 100, gmtl::Trif( gmtl::Point3f( -1, -1, 0 ), gmtl::Point3f( 1, -1, 0 ),
+                                                     gmtl::Point3f( 0, 1, 0 ) ) );
+      gmtl::BVHf bvh( &same[0], same.size() );
+      checkTree( bvh, same, 4 );
+      CPPUNIT_ASSERT( bvh.getNumNodes() == 1 );
+      CPPUNIT_ASSERT( gmtl::intersect( bvh, ray, u, v, t, tri ) );
+      CPPUNIT_ASSERT( t == 1.0f && tri < 100 );
+
+      // flat in each axis, all in a plane, and along a line
+      std::vector<gmtl::Trif> flat;
+      for (unsigned int i = 0; i < 50; ++i)
+      {
+         const float f = float( i ) * 0.1f;
+         flat.push_back( gmtl::Trif( gmtl::Point3f( f, 0, 0 ), gmtl::Point3f( f + 0.1f, 0, 0 ),
+                                     gmtl::Point3f( f, 1, 0 ) ) );
+      }
+      gmtl::BVHf flat_bvh( &flat[0], flat.size() );
+      checkTree( flat_bvh, flat, 4 );
+      const gmtl::Rayf flat_ray( gmtl::Point3f( 2.52f, 0.25f, 1 ), gmtl::Vec3f( 0, 0, -1 ) );
+      CPPUNIT_ASSERT( gmtl::intersect( flat_bvh, flat_ray, u, v, t, tri ) );
+      CPPUNIT_ASSERT( tri == 25 && t == 1.0f );
+
+      std::vector<gmtl::Trif> line;
+      for (unsigned int i = 0; i < 50; ++i)
+      {
+         const float f = float( i );
+         const gmtl::Point3f p( f, f, f );
+         line.push_back( gmtl::Trif( p, p, p ) );
+      }
+      gmtl::BVHf line_bvh( &line[0], line.size() );
+      checkTree( line_bvh, line, 4 );
+      CPPUNIT_ASSERT( !gmtl::intersectAny( line_bvh, ray ) );
+   }
+
+   /** The triangle test the BVH queries use. */
+   template<class DATA_TYPE, class RAY_TYPE>
+   static bool triHit( const gmtl::Tri<DATA_TYPE>& tri, const RAY_TYPE& ray, const bool doubleSided,
+                       DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t )
+   {
+      return doubleSided ? gmtl::intersectDoubleSided( tri, ray, u, v, t ) : gmtl::intersect( tri, ray, u, v, t );
+   }
+
+   /** Checks a hit of a BVH query against the closest hit of a loop over
+    *  all the triangles: the same t, and the u and v of the same triangle.
+    */
+   template<class DATA_TYPE, class RAY_TYPE>
+   static void checkHit( const std::vector< gmtl::Tri<DATA_TYPE> >& tris, const RAY_TYPE& ray,
+                         const bool doubleSided, const bool hit, const DATA_TYPE u, const DATA_TYPE v,
+                         const DATA_TYPE t, const unsigned int tri )
+   {
+      bool expected_hit = false;
+      DATA_TYPE expected_t = DATA_TYPE( 0 );
+      for (std::size_t i = 0; i < tris.size(); ++i)
+      {
+         DATA_TYPE tri_u, tri_v, tri_t;
+         const bool tri_hit = triHit( tris[i], ray, doubleSided, tri_u, tri_v, tri_t );
+         if (tri_hit && (!expected_hit || tri_t < expected_t))
+         {
+            expected_hit = true;
+            expected_t = tri_t;
+         }
+      }
+      CPPUNIT_ASSERT( hit == expected_hit );
+      if (hit)
+      {
+         CPPUNIT_ASSERT( t == expected_t );
+         CPPUNIT_ASSERT( tri < tris.size() );
+         DATA_TYPE tri_u, tri_v, tri_t;
+         const bool tri_hit = triHit( tris[tri], ray, doubleSided, tri_u, tri_v, tri_t );
+         CPPUNIT_ASSERT( tri_hit && tri_u == u && tri_v == v && tri_t == t );
+      }
+   }
+
+   void BVHTest::testRay()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillMesh( tris, 24 );
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 500 );
+
+      const unsigned int leaf_sizes[] = { 1, 4, 12 };
+      unsigned int num_hits = 0;
+      for (unsigned int l = 0; l < 3; ++l)
+      {
+         const gmtl::BVHf bvh( &tris[0], tris.size(), leaf_sizes[l] );
+         for (std::size_t i = 0; i < rays.size(); ++i)
+         {
+            float u = -1.0f, v = -1.0f, t = -1.0f;
+            unsigned int tri = 0;
+            const bool hit = gmtl::intersect( bvh, rays[i], u, v, t, tri );
+            checkHit( tris, rays[i], false, hit, u, v, t, tri );
+            num_hits += hit ? 1 : 0;
+         }
+      }
+      // most of the rays hit, not all
+      CPPUNIT_ASSERT( num_hits > rays.size() && num_hits < 3 * rays.size() );
+   }
+
+   void BVHTest::testLineSeg()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillMesh( tris, 24 );
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 500 );
+      const gmtl::BVHf bvh( &tris[0], tris.size() );
+
+      unsigned int num_hits = 0;
+      for (std::size_t i = 0; i < rays.size(); ++i)
+      {
+         // segments that end before, around and after the surface
+         const float lengths[] = { 0.3f, 1.0f, 2.0f, 0.00001f };
+         for (unsigned int l = 0; l < 4; ++l)
+         {
+            const gmtl::LineSegf seg( rays[i].getOrigin(), gmtl::Vec3f( rays[i].getDir() * lengths[l] ) );
+            float u = -1.0f, v = -1.0f, t = -1.0f;
+            unsigned int tri = 0;
+            const bool hit = gmtl::intersect( bvh, seg, u, v, t, tri );
+            checkHit( tris, seg, false, hit, u, v, t, tri );
+            CPPUNIT_ASSERT( !hit || t <= 1.0f );
+            CPPUNIT_ASSERT( hit == gmtl::intersectAny( bvh, seg ) );
+            num_hits += hit ? 1 : 0;
+         }
+      }
+      CPPUNIT_ASSERT( num_hits > rays.size() / 2 );
+   }
+
+   void BVHTest::testDoubleSided()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillMesh( tris, 24 );
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 500 );
+      const gmtl::BVHf bvh( &tris[0], tris.size() );
+      for (std::size_t i = 0; i < rays.size(); ++i)
+      {
+         float u = -1.0f, v = -1.0f, t = -1.0f;
+         unsigned int tri = 0;
+         bool hit = gmtl::intersectDoubleSided( bvh, rays[i], u, v, t, tri );
+         checkHit( tris, rays[i], true, hit, u, v, t, tri );
+
+         const gmtl::LineSegf seg( rays[i].getOrigin(), rays[i].getDir() );
+         hit = gmtl::intersectDoubleSided( bvh, seg, u, v, t, tri );
+         checkHit( tris, seg, true, hit, u, v, t, tri );
+      }
+
+      // double
+      std::vector<gmtl::Trid> trisd;
+      fillMesh( trisd, 12 );
+      std::vector<gmtl::Rayd> raysd;
+      fillRays( raysd, 200 );
+      const gmtl::BVHd bvhd( &trisd[0], trisd.size() );
+      for (std::size_t i = 0; i < raysd.size(); ++i)
+      {
+         double u = -1.0, v = -1.0, t = -1.0;
+         unsigned int tri = 0;
+         bool hit = gmtl::intersectDoubleSided( bvhd, raysd[i], u, v, t, tri );
+         checkHit( trisd, raysd[i], true, hit, u, v, t, tri );
+         CPPUNIT_ASSERT( hit == gmtl::intersectAnyDoubleSided( bvhd, raysd[i] ) );
+         hit = gmtl::intersect( bvhd, raysd[i], u, v, t, tri );
+         checkHit( trisd, raysd[i], false, hit, u, v, t, tri );
+         CPPUNIT_ASSERT( hit == gmtl::intersectAny( bvhd, raysd[i] ) );
+      }
+   }
+
+   void BVHTest::testAnyHit()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillMesh( tris, 24 );
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 500 );
+      const gmtl::BVHf bvh( &tris[0], tris.size() );
+      for (std::size_t i = 0; i < rays.size(); ++i)
+      {
+         float u, v, t;
+         unsigned int tri;
+         CPPUNIT_ASSERT( gmtl::intersect( bvh, rays[i], u, v, t, tri ) == gmtl::intersectAny( bvh, rays[i] ) );
+         CPPUNIT_ASSERT( gmtl::intersectDoubleSided( bvh, rays[i], u, v, t, tri ) ==
+                         gmtl::intersectAnyDoubleSided( bvh, rays[i] ) );
+      }
+
+      // a segment that stops short of the surface
+      const gmtl::LineSegf seg( gmtl::Point3f( 0.0f, 0.0f, 1.0f ), gmtl::Point3f( 0.0f, 0.0f, 0.2f ) );
+      CPPUNIT_ASSERT( !gmtl::intersectAnyDoubleSided( bvh, seg ) );
+      // one that goes through it, inside a triangle: the triangle test is
+      // not watertight, so through the shared vertex at (0, 0) it may miss
+      const gmtl::LineSegf seg2( gmtl::Point3f( 0.013f, 0.029f, 1.0f ), gmtl::Point3f( 0.013f, 0.029f, -0.2f ) );
+      CPPUNIT_ASSERT( gmtl::intersectAnyDoubleSided( bvh, seg2 ) );
+   }
+
+   /** Counts how many times each task runs, and checks the thread. */
+   class CountTasks
+   {
+   public:
+      CountTasks( std::vector<unsigned int>& counts, const unsigned int numThreads )
+         : mCounts( counts ), mNumThreads( numThreads )
+      {
+      }
+
+      void operator()( const std::size_t task, const unsigned int thread ) const
+      {
+         // each task has its own counter, no two threads write to one
+         ++mCounts[task];
+         CPPUNIT_ASSERT( thread < mNumThreads );
+      }
+
+   private:
+      std::vector<unsigned int>& mCounts;
+      unsigned int mNumThreads;
+   };
+
+   /** Throws on one task, and counts the others. */
+   class ThrowingTask
+   {
+   public:
+      ThrowingTask( std::vector<unsigned int>& counts, const std::size_t bad )
+         : mCounts( counts ), mBad( bad )
+      {
+      }
+
+      void operator()( const std::size_t task, const unsigned int ) const
+      {
+         if (task == mBad)
+         {
+            throw std::runtime_error( "bad task" );
+         }
+         ++mCounts[task];
+      }
+
+   private:
+      std::vector<unsigned int>& mCounts;
+      std::size_t mBad;
+   };
+
+   void BVHTest::testThreadPool()
+   {
+      const unsigned int thread_counts[] = { 1, 2, 3, 8 };
+      for (unsigned int c = 0; c < 4; ++c)
+      {
+         gmtl::ThreadPool pool( thread_counts[c] );
+#ifdef GMTL_HAVE_THREADS
+         CPPUNIT_ASSERT( pool.getNumThreads() == thread_counts[c] );
+#else
+         CPPUNIT_ASSERT( pool.getNumThreads() == 1 );
+#endif
+         // the pool can be reused, and runs every task once
+         const std::size_t task_counts[] = { 0, 1, 2, 5, 1000 };
+         for (unsigned int t = 0; t < 5; ++t)
+         {
+            std::vector<unsigned int> counts( task_counts[t], 0 );
+            pool.run( task_counts[t], CountTasks( counts, pool.getNumThreads() ) );
+            for (std::size_t i = 0; i < counts.size(); ++i)
+            {
+               CPPUNIT_ASSERT( counts[i] == 1 );
+            }
+         }
+
+         // a task that throws, on whichever thread, ends the run with its
+         // exception, and the pool can still be used
+         for (std::size_t bad = 0; bad < 1000; bad += 333)
+         {
+            std::vector<unsigned int> counts( 1000, 0 );
+            bool thrown = false;
+            try
+            {
+               pool.run( counts.size(), ThrowingTask( counts, bad ) );
+            }
+            catch (const std::runtime_error&)
+            {
+               thrown = true;
+            }
+            CPPUNIT_ASSERT( thrown );
+            for (std::size_t i = 0; i < counts.size(); ++i)
+            {
+               CPPUNIT_ASSERT( counts[i] <= 1 );
+            }
+            std::vector<unsigned int> counts2( 100, 0 );
+            pool.run( counts2.size(), CountTasks( counts2, pool.getNumThreads() ) );
+            CPPUNIT_ASSERT( std::count( counts2.begin(), counts2.end(), 1u ) == 100 );
+         }
+      }
+      CPPUNIT_ASSERT( gmtl::ThreadPool().getNumThreads() == gmtl::ThreadPool::getHardwareThreads() );
+
+      // the ranges cover everything once, in order
+      const std::size_t counts[] = { 0, 1, 5, 16, 17 };
+      for (unsigned int c = 0; c < 5; ++c)
+      {
+         for (std::size_t num_tasks = 1; num_tasks < 7; ++num_tasks)
+         {
+            std::size_t next = 0;
+            for (std::size_t task = 0; task < num_tasks; ++task)
+            {
+               std::size_t begin, end;
+               gmtl::ThreadPool::getRange( counts[c], task, num_tasks, begin, end );
+               CPPUNIT_ASSERT( begin == next && end >= begin && end - begin <= counts[c] / num_tasks + 1 );
+               next = end;
+            }
+            CPPUNIT_ASSERT( next == counts[c] );
+         }
+      }
+   }
+
+   /** Checks that two BVHs have the same nodes and triangles. */
+   template<class DATA_TYPE>
+   static void checkSameTree( const gmtl::BVH<DATA_TYPE>& bvh1, const gmtl::BVH<DATA_TYPE>& bvh2 )
+   {
+      CPPUNIT_ASSERT( bvh1.getNumNodes() == bvh2.getNumNodes() );
+      CPPUNIT_ASSERT( bvh1.getDepth() == bvh2.getDepth() );
+      CPPUNIT_ASSERT( bvh1.mTriIndices == bvh2.mTriIndices );
+      for (std::size_t i = 0; i < bvh1.getNumNodes(); ++i)
+      {
+         CPPUNIT_ASSERT( bvh1.mNodes[i].mFirst == bvh2.mNodes[i].mFirst );
+         CPPUNIT_ASSERT( bvh1.mNodes[i].mCount == bvh2.mNodes[i].mCount );
+         CPPUNIT_ASSERT( bvh1.mNodes[i].mBounds.mMin == bvh2.mNodes[i].mBounds.mMin );
+         CPPUNIT_ASSERT( bvh1.mNodes[i].mBounds.mMax == bvh2.mNodes[i].mBounds.mMax );
+      }
+   }
+
+   void BVHTest::testBuildLinear()
+   {
+      // sizes around the subtree size, and degenerate input
+      const unsigned int resolutions[] = { 1, 8, 24, 100 };
+      for (unsigned int r = 0; r < 4; ++r)
+      {
+         std::vector<gmtl::Trif> tris;
+         fillMesh( tris, resolutions[r] );
+         gmtl::BVHf bvh;
+         gmtl::buildLinear( bvh, &tris[0], tris.size() );
+         checkTree( bvh, tris, 4 );
+
+         const unsigned int thread_counts[] = { 2, 3, 8 };
+         for (unsigned int c = 0; c < 3; ++c)
+         {
+            gmtl::ThreadPool pool( thread_counts[c] );
+            gmtl::BVHf bvh_threads;
+            gmtl::buildLinear( bvh_threads, &tris[0], tris.size(), pool );
+            checkSameTree( bvh, bvh_threads );
+         }
+
+         gmtl::buildLinear( bvh, &tris[0], tris.size(), 1 );
+         checkTree( bvh, tris, 1 );
+      }
+
+      gmtl::BVHf bvh;
+      gmtl::buildLinear( bvh, (const gmtl::Trif*)NULL, 0 );
+      checkTree( bvh, std::vector<gmtl::Trif>(), 4 );
+
+      std::vector<gmtl::Trif> same( 1000, gmtl::Trif( gmtl::Point3f( -1, -1, 0 ), gmtl::Point3f( 1, -1, 0 ),
+                                                      gmtl::Point3f( 0, 1, 0 ) ) );
+      gmtl::buildLinear( bvh, &same[0], same.size() );
+      checkTree( bvh, same, 4 );
+
+      // the queries give the same results as with BVH::build()
+      std::vector<gmtl::Trif> tris;
+      fillMesh( tris, 24 );
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 500 );
+      gmtl::ThreadPool pool( 4 );
+      gmtl::buildLinear( bvh, &tris[0], tris.size(), pool );
+      for (std::size_t i = 0; i < rays.size(); ++i)
+      {
+         float u = -1.0f, v = -1.0f, t = -1.0f;
+         unsigned int tri = 0;
+         bool hit = gmtl::intersect( bvh, rays[i], u, v, t, tri );
+         checkHit( tris, rays[i], false, hit, u, v, t, tri );
+         hit = gmtl::intersectDoubleSided( bvh, rays[i], u, v, t, tri );
+         checkHit( tris, rays[i], true, hit, u, v, t, tri );
+      }
+
+      std::vector<gmtl::Trid> trisd;
+      fillMesh( trisd, 12 );
+      gmtl::BVHd bvhd;
+      gmtl::buildLinear( bvhd, &trisd[0], trisd.size(), pool, 2 );
+      checkTree( bvhd, trisd, 2 );
+   }
+
+   /** Moves the vertices of tris: a wave of the given amplitude, then a
+    *  rigid motion and a scale.
+    */
+   template<class DATA_TYPE>
+   static void deformMesh( std::vector< gmtl::Tri<DATA_TYPE> >& tris, const std::vector< gmtl::Tri<DATA_TYPE> >& rest,
+                           const DATA_TYPE amplitude, const DATA_TYPE scale )
+   {
+      tris.resize( rest.size() );
+      for (std::size_t i = 0; i < rest.size(); ++i)
+      {
+         for (unsigned int k = 0; k < 3; ++k)
+         {
+            const gmtl::Point<DATA_TYPE, 3>& p = rest[i][k];
+            const DATA_TYPE wave = amplitude * gmtl::Math::sin( p[0] * DATA_TYPE( 4.0 ) + p[1] * DATA_TYPE( 2.0 ) );
+            tris[i][k].set( (p[1] + DATA_TYPE( 3.0 )) * scale, (-p[0] + DATA_TYPE( 1.0 )) * scale,
+                            (p[2] + wave) * scale );
+         }
+      }
+   }
+
+   /** Checks that every node of bvh has the exact bounds of its triangles. */
+   template<class DATA_TYPE>
+   static void checkTightBounds( const gmtl::BVH<DATA_TYPE>& bvh )
+   {
+      for (std::size_t i = 0; i < bvh.getNumNodes(); ++i)
+      {
+         const gmtl::BVHNode<DATA_TYPE>& node = bvh.mNodes[i];
+         gmtl::AABox<DATA_TYPE> box;
+         if (node.isLeaf())
+         {
+            for (unsigned int t = node.mFirst; t < node.mFirst + node.mCount; ++t)
+            {
+               for (unsigned int k = 0; k < 3; ++k)
+               {
+                  gmtl::extendVolume( box, bvh.mTris[t][k] );
+               }
+            }
+         }
+         else
+         {
+            box = bvh.mNodes[node.mFirst].mBounds;
+            gmtl::extendVolume( box, bvh.mNodes[node.mFirst + 1].mBounds );
+         }
+         CPPUNIT_ASSERT( box.mMin == node.mBounds.mMin && box.mMax == node.mBounds.mMax );
+      }
+   }
+
+   void BVHTest::testRefit()
+   {
+      std::vector<gmtl::Trif> rest, tris;
+      fillMesh( rest, 40 );
+      gmtl::BVHf bvh( &rest[0], rest.size() );
+      CPPUNIT_ASSERT( bvh.getBuildSAHCost() > 1.0f );
+      CPPUNIT_ASSERT( bvh.getSAHCost() == bvh.getBuildSAHCost() );
+      CPPUNIT_ASSERT( bvh.getBuildSAHCost() == bvh.computeSAHCost() );
+
+      // refitting to the same triangles changes nothing
+      const std::vector<gmtl::BVHNode<float> > nodes( bvh.mNodes );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( bvh.refit( &rest[0] ), 1.0f, 1e-5f ) );
+      for (std::size_t i = 0; i < nodes.size(); ++i)
+      {
+         CPPUNIT_ASSERT( nodes[i].mBounds.mMin == bvh.mNodes[i].mBounds.mMin );
+         CPPUNIT_ASSERT( nodes[i].mBounds.mMax == bvh.mNodes[i].mBounds.mMax );
+      }
+
+      // a rigid motion and scale keeps the quality
+      deformMesh( tris, rest, 0.0f, 2.0f );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( bvh.refit( &tris[0] ), 1.0f, 1e-4f ) );
+      checkTree( bvh, tris, 4 );
+      checkTightBounds( bvh );
+
+      // deforming lowers it, more with a larger deformation
+      deformMesh( tris, rest, 0.2f, 1.0f );
+      const float small_quality = bvh.refit( &tris[0] );
+      deformMesh( tris, rest, 1.0f, 1.0f );
+      const float large_quality = bvh.refit( &tris[0] );
+      CPPUNIT_ASSERT( 1.0f < small_quality && small_quality < large_quality );
+      CPPUNIT_ASSERT( bvh.getSAHCost() / bvh.getBuildSAHCost() == large_quality );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( bvh.getSAHCost(), bvh.computeSAHCost(), 1e-3f * bvh.getSAHCost() ) );
+      checkTree( bvh, tris, 4 );
+      checkTightBounds( bvh );
+
+      // the queries match the deformed triangles
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 300 );
+      for (std::size_t i = 0; i < rays.size(); ++i)
+      {
+         rays[i].setOrigin( gmtl::Point3f( rays[i].getOrigin()[1] + 3.0f, -rays[i].getOrigin()[0] + 1.0f,
+                                           rays[i].getOrigin()[2] ) );
+         float u = -1.0f, v = -1.0f, t = -1.0f;
+         unsigned int tri = 0;
+         const bool hit = gmtl::intersectDoubleSided( bvh, rays[i], u, v, t, tri );
+         checkHit( tris, rays[i], true, hit, u, v, t, tri );
+      }
+
+      // on several threads, and for a linear BVH
+      gmtl::BVHf bvh_threads( &rest[0], rest.size() );
+      gmtl::ThreadPool pool( 3 );
+      CPPUNIT_ASSERT( bvh_threads.refit( &tris[0], pool ) == large_quality );
+      checkSameTree( bvh, bvh_threads );
+
+      gmtl::buildLinear( bvh, &rest[0], rest.size(), pool );
+      bvh.refit( &tris[0], pool );
+      checkTree( bvh, tris, 4 );
+      checkTightBounds( bvh );
+
+      // small trees, with fewer leaves than subtrees
+      gmtl::BVHf small( &rest[0], 3 );
+      small.refit( &tris[0] );
+      checkTree( small, std::vector<gmtl::Trif>( tris.begin(), tris.begin() + 3 ), 4 );
+      checkTightBounds( small );
+      gmtl::BVHf empty;
+      CPPUNIT_ASSERT( empty.refit( NULL ) == 1.0f );
+
+      std::vector<gmtl::Trid> restd, trisd;
+      fillMesh( restd, 12 );
+      deformMesh( trisd, restd, 0.5, 1.0 );
+      gmtl::BVHd bvhd( &restd[0], restd.size() );
+      CPPUNIT_ASSERT( bvhd.refit( &trisd[0], pool ) > 1.0 );
+      checkTree( bvhd, trisd, 4 );
+      checkTightBounds( bvhd );
+   }
+
+   /** A frustum looking down at the mesh of fillMesh() from above eye. */
+   template<class DATA_TYPE>
+   static gmtl::Frustum<DATA_TYPE> makeMeshFrustum( const gmtl::Vec<DATA_TYPE, 3>& eye )
+   {
+      gmtl::Matrix<DATA_TYPE, 4, 4> proj;
+      gmtl::setPerspective( proj, DATA_TYPE( 40 ), DATA_TYPE( 1.3 ), DATA_TYPE( 0.1 ), DATA_TYPE( 10 ) );
+      gmtl::Frustum<DATA_TYPE> f( gmtl::makeTrans< gmtl::Matrix<DATA_TYPE, 4, 4> >( -eye ), proj );
+      gmtl::normalize( f );
+      return f;
+   }
+
+   /** Checks cull( bvh, f, ... ) against classifying every leaf. */
+   template<class DATA_TYPE>
+   static void checkCull( const gmtl::BVH<DATA_TYPE>& bvh, const gmtl::Frustum<DATA_TYPE>& f,
+                          unsigned char* planeCache )
+   {
+      std::vector<unsigned int> expected;
+      for (std::size_t i = 0; i < bvh.mNodes.size(); ++i)
+      {
+         const gmtl::BVHNode<DATA_TYPE>& node = bvh.mNodes[i];
+         if (node.isLeaf() && gmtl::classify( f, node.mBounds ) != gmtl::CULL_OUTSIDE)
+         {
+            expected.insert( expected.end(), bvh.mTriIndices.begin() + node.mFirst,
+                             bvh.mTriIndices.begin() + node.mFirst + node.mCount );
+         }
+      }
+
+      std::vector<unsigned int> found( 1, 12345 );
+      CPPUNIT_ASSERT( gmtl::cull( bvh, f, found, planeCache ) == expected.size() );
+      CPPUNIT_ASSERT( found.size() == expected.size() + 1 && found[0] == 12345 );
+      std::sort( expected.begin(), expected.end() );
+      std::sort( found.begin() + 1, found.end() );
+      CPPUNIT_ASSERT( std::equal( expected.begin(), expected.end(), found.begin() + 1 ) );
+   }
+
+   void BVHTest::testCull()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillMesh( tris, 40 );
+      const gmtl::BVHf bvh( &tris[0], tris.size() );
+      std::vector<unsigned char> cache( bvh.mNodes.size(), 0 );
+
+      // a camera moving over the mesh, with and without the plane cache
+      for (unsigned int frame = 0; frame < 20; ++frame)
+      {
+         const float s = float( frame ) * 0.1f;
+         const gmtl::Frustumf f = makeMeshFrustum( gmtl::Vec3f( gmtl::Math::sin( s ) - 0.5f, s - 1.0f, 1.0f + s ) );
+         checkCull( bvh, f, NULL );
+         checkCull( bvh, f, &cache[0] );
+         checkCull( bvh, f, &cache[0] );
+
+         // every triangle with a vertex in the frustum is reported
+         std::vector<unsigned int> found;
+         gmtl::cull( bvh, f, found, &cache[0] );
+         std::vector<bool> reported( tris.size(), false );
+         for (std::size_t i = 0; i < found.size(); ++i)
+         {
+            reported[found[i]] = true;
+         }
+         for (std::size_t i = 0; i < tris.size(); ++i)
+         {
+            unsigned int idx;
+            for (unsigned int k = 0; k < 3; ++k)
+            {
+               CPPUNIT_ASSERT( reported[i] || !gmtl::isInVolume( f, tris[i][k], idx ) );
+            }
+         }
+         CPPUNIT_ASSERT( !found.empty() && found.size() < tris.size() );
+      }
+
+      // the whole mesh, nothing of it, an empty BVH, and in double
+      std::vector<unsigned int> found;
+      CPPUNIT_ASSERT( gmtl::cull( bvh, makeMeshFrustum( gmtl::Vec3f( 0.0f, 0.0f, 5.0f ) ), found ) == tris.size() );
+      found.clear();
+      CPPUNIT_ASSERT( gmtl::cull( bvh, makeMeshFrustum( gmtl::Vec3f( 0.0f, 0.0f, -0.5f ) ), found ) == 0 );
+      CPPUNIT_ASSERT( gmtl::cull( gmtl::BVHf(), makeMeshFrustum( gmtl::Vec3f( 0.0f, 0.0f, 5.0f ) ), found ) == 0 );
+      CPPUNIT_ASSERT( found.empty() );
+
+      std::vector<gmtl::Trid> trisd;
+      fillMesh( trisd, 12 );
+      const gmtl::BVHd bvhd( &trisd[0], trisd.size() );
+      checkCull( bvhd, makeMeshFrustum( gmtl::Vec3d( 0.2, -0.3, 1.5 ) ), NULL );
+   }
+
+   void BVHMetricTest::testTimingBuild()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillMesh( tris, 128 );
+      gmtl::BVHf bvh;
+      const long iters(10);
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         bvh.build( &tris[0], tris.size() );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("BVHTest/build(32832 tris)", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      CPPUNIT_ASSERT( bvh.getNumTris() == tris.size() );
+   }
+
+   void BVHMetricTest::testTimingBuildLinear()
+   {
+      // 1M triangles, on 1, 2, 4, ... threads up to the hardware threads
+      std::vector<gmtl::Trif> tris;
+      fillMesh( tris, 707 );
+      gmtl::BVHf bvh;
+      const long iters(3);
+      const unsigned int max_threads = gmtl::ThreadPool::getHardwareThreads();
+      for (unsigned int threads = 1; ; threads = gmtl::Math::Min( threads * 2, max_threads ))
+      {
+         gmtl::ThreadPool pool( threads );
+         CPPUNIT_METRIC_START_TIMING();
+         for (long iter = 0; iter < iters; ++iter)
+         {
+            gmtl::buildLinear( bvh, &tris[0], tris.size(), pool );
+         }
+         CPPUNIT_METRIC_STOP_TIMING();
+         std::ostringstream name;
+         name << "BVHTest/buildLinear(1M tris) " << pool.getNumThreads() << " threads";
+         CPPUNIT_ASSERT_METRIC_TIMING_LE(name.str(), iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+         if (threads >= max_threads)
+         {
+            break;
+         }
+      }
+      CPPUNIT_ASSERT( bvh.getNumTris() == tris.size() );
+
+      // the same triangles as the build() timing, and the queries
+      fillMesh( tris, 128 );
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < 10; ++iter)
+      {
+         gmtl::buildLinear( bvh, &tris[0], tris.size() );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("BVHTest/buildLinear(32832 tris) 1 thread", 10, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 4096 );
+      unsigned int hits = 0;
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < 20; ++iter)
+      {
+         for (std::size_t i = 0; i < rays.size(); ++i)
+         {
+            float u, v, t;
+            unsigned int tri;
+            hits += gmtl::intersect( bvh, rays[i], u, v, t, tri ) ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("BVHTest/intersect(linear BVH, Ray) 32832 tris", 20 * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      CPPUNIT_ASSERT( hits > 0 );
+   }
+
+   void BVHMetricTest::testTimingRefit()
+   {
+      std::vector<gmtl::Trif> rest, tris;
+      fillMesh( rest, 128 );
+      deformMesh( tris, rest, 0.1f, 1.0f );
+      gmtl::BVHf bvh( &rest[0], rest.size() );
+      float quality = 0.0f;
+      const long iters(100);
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         quality += bvh.refit( (iter & 1) ? &rest[0] : &tris[0] );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("BVHTest/refit(32832 tris)", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      // 1M triangles, on 1, 2, 4, ... threads up to the hardware threads
+      fillMesh( rest, 707 );
+      deformMesh( tris, rest, 0.1f, 1.0f );
+      gmtl::buildLinear( bvh, &rest[0], rest.size() );
+      const unsigned int max_threads = gmtl::ThreadPool::getHardwareThreads();
+      for (unsigned int threads = 1; ; threads = gmtl::Math::Min( threads * 2, max_threads ))
+      {
+         gmtl::ThreadPool pool( threads );
+         CPPUNIT_METRIC_START_TIMING();
+         for (long iter = 0; iter < 4; ++iter)
+         {
+            quality += bvh.refit( (iter & 1) ? &rest[0] : &tris[0], pool );
+         }
+         CPPUNIT_METRIC_STOP_TIMING();
+         std::ostringstream name;
+         name << "BVHTest/refit(1M tris) " << pool.getNumThreads() << " threads";
+         CPPUNIT_ASSERT_METRIC_TIMING_LE(name.str(), 4, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+         if (threads >= max_threads)
+         {
+            break;
+         }
+      }
+      CPPUNIT_ASSERT( quality > 0.0f );
+   }
+
+   void BVHMetricTest::testTimingCull()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillMesh( tris, 128 );
+      const gmtl::BVHf bvh( &tris[0], tris.size() );
+      std::vector<gmtl::Frustumf> frames;
+      for (unsigned int frame = 0; frame < 64; ++frame)
+      {
+         const float s = float( frame ) * 0.01f;
+         frames.push_back( makeMeshFrustum( gmtl::Vec3f( s - 0.5f, 0.3f * s - 0.2f, 0.6f + s ) ) );
+      }
+      std::vector<unsigned int> found;
+      found.reserve( tris.size() );
+      std::size_t visible = 0;
+      const long iters(10);
+
+      // a camera moving a little each frame, without and with the plane cache
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < frames.size(); ++i)
+         {
+            found.clear();
+            visible += gmtl::cull( bvh, frames[i], found );
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("BVHTest/cull(BVH, Frustum) 32832 tris", iters * frames.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      std::vector<unsigned char> cache( bvh.mNodes.size(), 0 );
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < frames.size(); ++i)
+         {
+            found.clear();
+            visible += gmtl::cull( bvh, frames[i], found, &cache[0] );
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("BVHTest/cull(BVH, Frustum) plane cache 32832 tris", iters * frames.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      // every node tested against all the planes, for comparison
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < frames.size(); ++i)
+         {
+            found.clear();
+            std::vector<unsigned int> stack( 1, 0 );
+            while (!stack.empty())
+            {
+               const gmtl::BVHNode<float>& node = bvh.mNodes[stack.back()];
+               stack.pop_back();
+               if (gmtl::classify( frames[i], node.mBounds ) == gmtl::CULL_OUTSIDE)
+               {
+                  continue;
+               }
+               if (node.isLeaf())
+               {
+                  found.insert( found.end(), bvh.mTriIndices.begin() + node.mFirst,
+                                bvh.mTriIndices.begin() + node.mFirst + node.mCount );
+               }
+               else
+               {
+                  stack.push_back( node.mFirst + 1 );
+                  stack.push_back( node.mFirst );
+               }
+            }
+            visible += found.size();
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("BVHTest/classify(Frustum, AABox) tree walk 32832 tris", iters * frames.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( visible > 0 );
+   }
+
+   void BVHMetricTest::testTimingRay()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillMesh( tris, 128 );
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 4096 );
+      const gmtl::BVHf bvh( &tris[0], tris.size() );
+      unsigned int hits = 0;
+
+      // BVH, closest hit
+      long iters(20);
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < rays.size(); ++i)
+         {
+            float u, v, t;
+            unsigned int tri;
+            hits += gmtl::intersect( bvh, rays[i], u, v, t, tri ) ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("BVHTest/intersect(BVH, Ray) 32832 tris", iters * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      // BVH, any hit
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < rays.size(); ++i)
+         {
+            hits += gmtl::intersectAny( bvh, rays[i] ) ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("BVHTest/intersectAny(BVH, Ray) 32832 tris", iters * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      // every triangle, for comparison
+      const std::size_t num_rays(64);
+      iters = 1;
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < num_rays; ++i)
+         {
+            float best_t = 0.0f;
+            bool hit = false;
+            for (std::size_t j = 0; j < tris.size(); ++j)
+            {
+               float u, v, t;
+               if (gmtl::intersect( tris[j], rays[i], u, v, t ) && (!hit || t < best_t))
+               {
+                  hit = true;
+                  best_t = t;
+               }
+            }
+            hits += hit ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("BVHTest/intersect(Tri, Ray) loop 32832 tris", iters * num_rays, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( hits > 0 );
+   }
+}
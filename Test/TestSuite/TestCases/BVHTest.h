@@ -0,0 +1,70 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_BVH_TEST_H_
+#define _GMTL_BVH_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace gmtlTest
+{
+   /**
+    * Functionality tests for BVH.
+    */
+   class BVHTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(BVHTest);
+
+      CPPUNIT_TEST(testBuild);
+      CPPUNIT_TEST(testBuildDegenerate);
+      CPPUNIT_TEST(testRay);
+      CPPUNIT_TEST(testLineSeg);
+      CPPUNIT_TEST(testDoubleSided);
+      CPPUNIT_TEST(testAnyHit);
+      CPPUNIT_TEST(testThreadPool);
+      CPPUNIT_TEST(testBuildLinear);
+      CPPUNIT_TEST(testRefit);
+      CPPUNIT_TEST(testCull);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testBuild();
+      void testBuildDegenerate();
+      void testRay();
+      void testLineSeg();
+      void testDoubleSided();
+      void testAnyHit();
+      void testThreadPool();
+      void testBuildLinear();
+      void testRefit();
+      void testCull();
+   };
+
+   /**
+    * Metric tests.
+    */
+   class BVHMetricTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(BVHMetricTest);
+
+      CPPUNIT_TEST(testTimingBuild);
+      CPPUNIT_TEST(testTimingRay);
+      CPPUNIT_TEST(testTimingBuildLinear);
+      CPPUNIT_TEST(testTimingRefit);
+      CPPUNIT_TEST(testTimingCull);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testTimingBuild();
+      void testTimingRay();
+      void testTimingBuildLinear();
+      void testTimingRefit();
+      void testTimingCull();
+   };
+}
+
+#endif
@@ -0,0 +1,1096 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#include "FrustumTest.h"
+#include "../Suites.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/MetricRegistry.h>
+
+#include <vector>
+#include <gmtl/Frustum.h>
+#include <gmtl/FrustumOps.h>
+#include <gmtl/PlaneOps.h>
+#include <gmtl/Containment.h>
+#include <gmtl/Intersection.h>
+#include <gmtl/OOBox.h>
+#include <gmtl/Generate.h>
+#include <gmtl/EulerAngle.h>
+#include <gmtl/Vec3Array.h>
+
+namespace gmtlTest
+{
+   CPPUNIT_TEST_SUITE_REGISTRATION(FrustumTest);
+   CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(FrustumMetricTest, Suites::metric());
+
+   /** A normalized perspective frustum from eye, with the view turned by
+    *  the XYZ Euler angles; its corners (in the order of
+    *  helpers::getFrustumCorners()) are set in corners if not NULL.
+    */
+   template<class DATA_TYPE>
+   static gmtl::Frustum<DATA_TYPE> makeFrustum( const gmtl::Vec<DATA_TYPE, 3>& eye, const gmtl::Vec<DATA_TYPE, 3>& angles,
+                                                const DATA_TYPE fovy, const DATA_TYPE farDist,
+                                                gmtl::Point<DATA_TYPE, 3>* corners = NULL )
+   {
+      gmtl::Matrix<DATA_TYPE, 4, 4> proj;
+      gmtl::setPerspective( proj, fovy, DATA_TYPE( 1.5 ), DATA_TYPE( 1 ), farDist );
+      const gmtl::Matrix<DATA_TYPE, 4, 4> rot = gmtl::makeRot< gmtl::Matrix<DATA_TYPE, 4, 4> >(
+         gmtl::EulerAngle<DATA_TYPE, gmtl::XYZ>( angles[0], angles[1], angles[2] ) );
+      const gmtl::Matrix<DATA_TYPE, 4, 4> trans = gmtl::makeTrans< gmtl::Matrix<DATA_TYPE, 4, 4> >( -eye );
+      gmtl::Frustum<DATA_TYPE> f( rot * trans, proj );
+      gmtl::normalize( f );
+
+      if (corners != NULL)
+      {
+         gmtl::Matrix<DATA_TYPE, 4, 4> inv;
+         gmtl::invertFull( inv, gmtl::Matrix<DATA_TYPE, 4, 4>( proj * rot * trans ) );
+         for (unsigned int i = 0; i < 8; ++i)
+         {
+            const DATA_TYPE x = (i == 1 || i == 2 || i == 5 || i == 6) ? DATA_TYPE( 1 ) : DATA_TYPE( -1 );
+            const DATA_TYPE y = ((i & 3) >= 2) ? DATA_TYPE( 1 ) : DATA_TYPE( -1 );
+            gmtl::Vec<DATA_TYPE, 4> p;
+            gmtl::xform( p, inv, gmtl::Vec<DATA_TYPE, 4>( x, y, (i < 4) ? DATA_TYPE( -1 ) : DATA_TYPE( 1 ), DATA_TYPE( 1 ) ) );
+            corners[i].set( p[0] / p[3], p[1] / p[3], p[2] / p[3] );
+         }
+      }
+      return f;
+   }
+
+   /** A normalized perspective frustum looking down -z from (1, 2, 3),
+    *  turned a little.
+    */
+   template<class DATA_TYPE>
+   static gmtl::Frustum<DATA_TYPE> makeFrustum()
+   {
+      return makeFrustum( gmtl::Vec<DATA_TYPE, 3>( DATA_TYPE( 1 ), DATA_TYPE( 2 ), DATA_TYPE( 3 ) ),
+                          gmtl::Vec<DATA_TYPE, 3>( DATA_TYPE( 0.2 ), DATA_TYPE( -0.3 ), DATA_TYPE( 0.1 ) ),
+                          DATA_TYPE( 60 ), DATA_TYPE( 50 ) );
+   }
+
+   /** The i-th of a set of frustums of various shapes around makeFrustum(),
+    *  with its corners.
+    */
+   template<class DATA_TYPE>
+   static gmtl::Frustum<DATA_TYPE> makeOtherFrustum( const std::size_t i, gmtl::Point<DATA_TYPE, 3> corners[8] )
+   {
+      const DATA_TYPE f = DATA_TYPE( i );
+      const gmtl::Vec<DATA_TYPE, 3> eye( DATA_TYPE( 25 ) * gmtl::Math::sin( f * DATA_TYPE( 0.37 ) ),
+                                         DATA_TYPE( 25 ) * gmtl::Math::cos( f * DATA_TYPE( 0.71 ) ),
+                                         DATA_TYPE( -20 ) + DATA_TYPE( 25 ) * gmtl::Math::sin( f * DATA_TYPE( 0.13 ) ) );
+      const gmtl::Vec<DATA_TYPE, 3> angles( DATA_TYPE( 3 ) * gmtl::Math::sin( f * DATA_TYPE( 1.3 ) ),
+                                            DATA_TYPE( 3 ) * gmtl::Math::sin( f * DATA_TYPE( 0.9 ) ),
+                                            gmtl::Math::cos( f * DATA_TYPE( 2.1 ) ) );
+      return makeFrustum( eye, angles, DATA_TYPE( 20 ) + DATA_TYPE( 50 ) * gmtl::Math::abs( gmtl::Math::sin( f * DATA_TYPE( 2.9 ) ) ),
+                          DATA_TYPE( 3 ) + DATA_TYPE( 20 ) * gmtl::Math::abs( gmtl::Math::cos( f * DATA_TYPE( 1.7 ) ) ), corners );
+   }
+
+   /** Fills boxes with count boxes of various sizes around the frustum,
+    *  some inside, some outside and some across its planes.
+    */
+   template<class DATA_TYPE>
+   static void fillBoxes( std::vector< gmtl::AABox<DATA_TYPE> >& boxes, const std::size_t count )
+   {
+      boxes.resize( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         const DATA_TYPE f = DATA_TYPE( i );
+         const gmtl::Point<DATA_TYPE, 3> c( DATA_TYPE( 30 ) * gmtl::Math::sin( f * DATA_TYPE( 0.37 ) ),
+                                            DATA_TYPE( 30 ) * gmtl::Math::cos( f * DATA_TYPE( 0.71 ) ),
+                                            DATA_TYPE( -30 ) + DATA_TYPE( 35 ) * gmtl::Math::sin( f * DATA_TYPE( 0.13 ) ) );
+         const gmtl::Vec<DATA_TYPE, 3> e( DATA_TYPE( 0.5 ) + DATA_TYPE( 4 ) * gmtl::Math::abs( gmtl::Math::sin( f * DATA_TYPE( 1.9 ) ) ),
+                                          DATA_TYPE( 0.1 ) + DATA_TYPE( 3 ) * gmtl::Math::abs( gmtl::Math::cos( f * DATA_TYPE( 2.3 ) ) ),
+                                          DATA_TYPE( 2 ) * gmtl::Math::abs( gmtl::Math::sin( f * DATA_TYPE( 0.9 ) ) ) );
+         boxes[i] = gmtl::AABox<DATA_TYPE>( c - e, c + e );
+      }
+   }
+
+   /** Fills spheres with count spheres as fillBoxes() does boxes. */
+   template<class DATA_TYPE>
+   static void fillSpheres( std::vector< gmtl::Sphere<DATA_TYPE> >& spheres, const std::size_t count )
+   {
+      std::vector< gmtl::AABox<DATA_TYPE> > boxes;
+      fillBoxes( boxes, count );
+      spheres.resize( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         const gmtl::Vec<DATA_TYPE, 3> e = (boxes[i].getMax() - boxes[i].getMin()) * DATA_TYPE( 0.5 );
+         spheres[i] = gmtl::Sphere<DATA_TYPE>( gmtl::Point<DATA_TYPE, 3>( boxes[i].getMin() + e ), e[0] + e[2] );
+      }
+   }
+
+   /** Fills boxes with count oriented boxes as fillBoxes() does boxes,
+    *  turned every which way.
+    */
+   template<class DATA_TYPE>
+   static void fillOOBoxes( std::vector< gmtl::OOBox<DATA_TYPE> >& boxes, const std::size_t count )
+   {
+      std::vector< gmtl::AABox<DATA_TYPE> > aaboxes;
+      fillBoxes( aaboxes, count );
+      boxes.resize( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         const DATA_TYPE f = DATA_TYPE( i );
+         const gmtl::Matrix<DATA_TYPE, 3, 3> rot = gmtl::makeRot< gmtl::Matrix<DATA_TYPE, 3, 3> >(
+            gmtl::EulerAngle<DATA_TYPE, gmtl::XYZ>( f * DATA_TYPE( 0.7 ), f * DATA_TYPE( 1.1 ), f * DATA_TYPE( 0.3 ) ) );
+         gmtl::OOBox<DATA_TYPE>& box = boxes[i];
+         box.mCenter = (aaboxes[i].mMin + aaboxes[i].mMax) * DATA_TYPE( 0.5 );
+         for (unsigned int k = 0; k < 3; ++k)
+         {
+            box.mAxis[k].set( rot( 0, k ), rot( 1, k ), rot( 2, k ) );
+            box.mHalfLen[k] = (aaboxes[i].mMax[k] - aaboxes[i].mMin[k]) * DATA_TYPE( 0.5 );
+         }
+      }
+   }
+
+   /** Whether one of a grid of points filling the convex hull of the 8
+    *  corners (in the order of OOBox::getVerts()) is in f.
+    */
+   template<class DATA_TYPE>
+   static bool hasPointInside( const gmtl::Frustum<DATA_TYPE>& f, const gmtl::Point<DATA_TYPE, 3> corners[8] )
+   {
+      const unsigned int steps = 6;
+      for (unsigned int i = 0; i <= steps; ++i)
+      {
+         for (unsigned int j = 0; j <= steps; ++j)
+         {
+            for (unsigned int k = 0; k <= steps; ++k)
+            {
+               const DATA_TYPE u = DATA_TYPE( i ) / DATA_TYPE( steps ), v = DATA_TYPE( j ) / DATA_TYPE( steps ),
+                               w = DATA_TYPE( k ) / DATA_TYPE( steps );
+               // bilinear on the near and far faces, then between them
+               const gmtl::Point<DATA_TYPE, 3> p =
+                  (corners[0] * ((1 - u) * (1 - v)) + corners[1] * (u * (1 - v)) +
+                   corners[2] * (u * v) + corners[3] * ((1 - u) * v)) * (1 - w) +
+                  (corners[4] * ((1 - u) * (1 - v)) + corners[5] * (u * (1 - v)) +
+                   corners[6] * (u * v) + corners[7] * ((1 - u) * v)) * w;
+               unsigned int idx;
+               if (gmtl::isInVolume( f, p, idx ))
+               {
+                  return true;
+               }
+            }
+         }
+      }
+      return false;
+   }
+
+   /** The classification of a box from its 8 corners. */
+   template<class DATA_TYPE>
+   static gmtl::CullResult classifyCorners( const gmtl::Frustum<DATA_TYPE>& f, const gmtl::AABox<DATA_TYPE>& box )
+   {
+      gmtl::CullResult result = gmtl::CULL_INSIDE;
+      for (unsigned int i = 0; i < 6; ++i)
+      {
+         const gmtl::Vec<DATA_TYPE, 3>& n = f.mPlanes[i].mNorm;
+         unsigned int behind = 0;
+         for (unsigned int corner = 0; corner < 8; ++corner)
+         {
+            const DATA_TYPE x = (corner & 1) ? box.mMax[0] : box.mMin[0];
+            const DATA_TYPE y = (corner & 2) ? box.mMax[1] : box.mMin[1];
+            const DATA_TYPE z = (corner & 4) ? box.mMax[2] : box.mMin[2];
+            behind += (n[0] * x + n[1] * y + n[2] * z + f.mPlanes[i].mOffset < DATA_TYPE( 0 )) ? 1 : 0;
+         }
+         if (behind == 8)
+         {
+            return gmtl::CULL_OUTSIDE;
+         }
+         if (behind > 0)
+         {
+            result = gmtl::CULL_INTERSECTING;
+         }
+      }
+      return result;
+   }
+
+   /** Checks the batch box tests against the single box one, for the SoA
+    *  views, strided views and the array of boxes.
+    */
+   template<class DATA_TYPE>
+   static void checkBatchBoxes( const gmtl::Frustum<DATA_TYPE>& f,
+                                const std::vector< gmtl::AABox<DATA_TYPE> >& boxes )
+   {
+      gmtl::Vec3Array<DATA_TYPE> mins, maxs;
+      std::vector< gmtl::Vec<DATA_TYPE, 3> > aos_mins, aos_maxs;
+      for (std::size_t i = 0; i < boxes.size(); ++i)
+      {
+         const gmtl::Vec<DATA_TYPE, 3> min( boxes[i].mMin[0], boxes[i].mMin[1], boxes[i].mMin[2] );
+         const gmtl::Vec<DATA_TYPE, 3> max( boxes[i].mMax[0], boxes[i].mMax[1], boxes[i].mMax[2] );
+         mins.push_back( min );
+         maxs.push_back( max );
+         aos_mins.push_back( min );
+         aos_maxs.push_back( max );
+      }
+
+      std::vector<unsigned char> soa( boxes.size() + 1, 7 ), strided( boxes.size() + 1, 7 ),
+                                 aos( boxes.size() + 1, 7 );
+      const std::size_t soa_visible = gmtl::classify( f, gmtl::makeView( mins ), gmtl::makeView( maxs ), &soa[0] );
+      const std::size_t strided_visible = gmtl::classify( f, gmtl::makeView( aos_mins ), gmtl::makeView( aos_maxs ),
+                                                          &strided[0] );
+      const std::size_t aos_visible = gmtl::classify( f, &boxes[0], boxes.size(), &aos[0] );
+
+      std::size_t visible = 0;
+      for (std::size_t i = 0; i < boxes.size(); ++i)
+      {
+         // the views have no initialized flag
+         gmtl::AABox<DATA_TYPE> box = boxes[i];
+         box.setInitialized();
+         const gmtl::CullResult expected = gmtl::classify( f, box );
+         CPPUNIT_ASSERT( soa[i] == expected && strided[i] == expected );
+         CPPUNIT_ASSERT( aos[i] == (boxes[i].isInitialized() ? expected : gmtl::CULL_OUTSIDE) );
+         visible += (aos[i] != gmtl::CULL_OUTSIDE) ? 1 : 0;
+      }
+      CPPUNIT_ASSERT( soa_visible == strided_visible && aos_visible == visible );
+
+      // nothing past the end is written
+      CPPUNIT_ASSERT( soa.back() == 7 && strided.back() == 7 && aos.back() == 7 );
+   }
+
+   void FrustumTest::testClassifyBox()
+   {
+      const gmtl::Frustumf f = makeFrustum<float>();
+      std::vector<gmtl::AABoxf> boxes;
+      fillBoxes( boxes, 2000 );
+
+      unsigned int counts[3] = { 0, 0, 0 };
+      for (std::size_t i = 0; i < boxes.size(); ++i)
+      {
+         const gmtl::CullResult result = gmtl::classify( f, boxes[i] );
+         CPPUNIT_ASSERT( result == classifyCorners( f, boxes[i] ) );
+         ++counts[result];
+
+         // the existing test only rejects boxes behind one plane
+         if (!gmtl::isInVolume( f, boxes[i] ))
+         {
+            CPPUNIT_ASSERT( result == gmtl::CULL_OUTSIDE );
+         }
+      }
+      CPPUNIT_ASSERT( counts[gmtl::CULL_OUTSIDE] > 0 && counts[gmtl::CULL_INTERSECTING] > 0 &&
+                      counts[gmtl::CULL_INSIDE] > 0 );
+
+      // around the eye point, which is behind the near plane
+      const gmtl::AABoxf eye( gmtl::Point3f( 0.9f, 1.9f, 2.9f ), gmtl::Point3f( 1.1f, 2.1f, 3.1f ) );
+      CPPUNIT_ASSERT( gmtl::classify( f, eye ) == gmtl::CULL_OUTSIDE );
+
+      // a box enclosing the frustum
+      const gmtl::AABoxf all( gmtl::Point3f( -100, -100, -100 ), gmtl::Point3f( 100, 100, 100 ) );
+      CPPUNIT_ASSERT( gmtl::classify( f, all ) == gmtl::CULL_INTERSECTING );
+
+      // uninitialized boxes are outside
+      CPPUNIT_ASSERT( gmtl::classify( f, gmtl::AABoxf() ) == gmtl::CULL_OUTSIDE );
+   }
+
+   void FrustumTest::testClassifySphere()
+   {
+      const gmtl::Frustumf f = makeFrustum<float>();
+      std::vector<gmtl::Spheref> spheres;
+      fillSpheres( spheres, 2000 );
+
+      unsigned int counts[3] = { 0, 0, 0 };
+      for (std::size_t i = 0; i < spheres.size(); ++i)
+      {
+         const gmtl::CullResult result = gmtl::classify( f, spheres[i] );
+         CPPUNIT_ASSERT( (result != gmtl::CULL_OUTSIDE) == gmtl::isInVolume( f, spheres[i] ) );
+         ++counts[result];
+
+         // inside is in front of every plane by at least the radius
+         bool inside = true;
+         for (unsigned int p = 0; p < 6; ++p)
+         {
+            const float dist = gmtl::dot( f.mPlanes[p].mNorm, gmtl::Vec3f( spheres[i].mCenter ) ) + f.mPlanes[p].mOffset;
+            inside = inside && dist >= spheres[i].mRadius;
+         }
+         CPPUNIT_ASSERT( inside == (result == gmtl::CULL_INSIDE) );
+      }
+      CPPUNIT_ASSERT( counts[gmtl::CULL_OUTSIDE] > 0 && counts[gmtl::CULL_INTERSECTING] > 0 &&
+                      counts[gmtl::CULL_INSIDE] > 0 );
+
+      CPPUNIT_ASSERT( gmtl::classify( f, gmtl::Spheref() ) == gmtl::CULL_OUTSIDE );
+   }
+
+   void FrustumTest::testClassifyMasked()
+   {
+      const gmtl::Frustumf f = makeFrustum<float>();
+      std::vector<gmtl::AABoxf> boxes;
+      fillBoxes( boxes, 2000 );
+      std::vector<gmtl::Spheref> spheres;
+      fillSpheres( spheres, 2000 );
+
+      unsigned int inherited = 0;
+      for (std::size_t i = 0; i < boxes.size(); ++i)
+      {
+         // all the planes: the same as the plain test, with the planes crossed
+         const gmtl::CullResult result = gmtl::classify( f, boxes[i] );
+         unsigned int mask = gmtl::CULL_ALL_PLANES, last_plane = 6;
+         CPPUNIT_ASSERT( gmtl::classify( f, boxes[i], mask, last_plane ) == result );
+         if (result == gmtl::CULL_OUTSIDE)
+         {
+            // the plane that culled it is kept, and culls it on its own
+            CPPUNIT_ASSERT( last_plane < 6 && mask == gmtl::CULL_ALL_PLANES );
+            unsigned int one_plane = 1u << last_plane, cached = last_plane;
+            CPPUNIT_ASSERT( gmtl::classify( f, boxes[i], one_plane, cached ) == gmtl::CULL_OUTSIDE );
+            CPPUNIT_ASSERT( cached == last_plane );
+            unsigned int all = gmtl::CULL_ALL_PLANES;
+            CPPUNIT_ASSERT( gmtl::classify( f, boxes[i], all, cached ) == gmtl::CULL_OUTSIDE );
+            CPPUNIT_ASSERT( cached == last_plane );
+            continue;
+         }
+         CPPUNIT_ASSERT( last_plane == 6 );
+         CPPUNIT_ASSERT( (mask == 0) == (result == gmtl::CULL_INSIDE) );
+         for (unsigned int p = 0; p < 6; ++p)
+         {
+            unsigned int one_plane = 1u << p, unused = 6;
+            const gmtl::CullResult plane_result = gmtl::classify( f, boxes[i], one_plane, unused );
+            CPPUNIT_ASSERT( ((mask >> p) & 1u) == (plane_result == gmtl::CULL_INTERSECTING ? 1u : 0u) );
+         }
+
+         // the eight octants of the box only need the planes it crosses
+         const gmtl::Point3f& lo = boxes[i].mMin;
+         const gmtl::Point3f& hi = boxes[i].mMax;
+         const gmtl::Point3f mid( (lo + hi) * 0.5f );
+         for (unsigned int k = 0; k < 8; ++k)
+         {
+            const gmtl::AABoxf child( gmtl::Point3f( (k & 1) ? mid[0] : lo[0], (k & 2) ? mid[1] : lo[1], (k & 4) ? mid[2] : lo[2] ),
+                                      gmtl::Point3f( (k & 1) ? hi[0] : mid[0], (k & 2) ? hi[1] : mid[1], (k & 4) ? hi[2] : mid[2] ) );
+            unsigned int child_mask = mask, child_last = 6;
+            CPPUNIT_ASSERT( gmtl::classify( f, child, child_mask, child_last ) == gmtl::classify( f, child ) );
+            CPPUNIT_ASSERT( (child_mask & ~mask) == 0 );
+            inherited += (mask != gmtl::CULL_ALL_PLANES) ? 1 : 0;
+         }
+      }
+      CPPUNIT_ASSERT( inherited > 0 );
+
+      for (std::size_t i = 0; i < spheres.size(); ++i)
+      {
+         const gmtl::CullResult result = gmtl::classify( f, spheres[i] );
+         unsigned int mask = gmtl::CULL_ALL_PLANES, last_plane = 6;
+         CPPUNIT_ASSERT( gmtl::classify( f, spheres[i], mask, last_plane ) == result );
+         CPPUNIT_ASSERT( (result == gmtl::CULL_OUTSIDE) == (last_plane < 6) );
+         if (result == gmtl::CULL_OUTSIDE)
+         {
+            const float dist = gmtl::dot( f.mPlanes[last_plane].mNorm, gmtl::Vec3f( spheres[i].mCenter ) ) +
+                               f.mPlanes[last_plane].mOffset;
+            CPPUNIT_ASSERT( dist <= -spheres[i].mRadius );
+         }
+         else
+         {
+            CPPUNIT_ASSERT( (mask == 0) == (result == gmtl::CULL_INSIDE) );
+         }
+      }
+
+      // no planes left: inside without a test; uninitialized: outside
+      unsigned int none = 0, last_plane = 2;
+      CPPUNIT_ASSERT( gmtl::classify( f, boxes[0], none, last_plane ) == gmtl::CULL_INSIDE );
+      CPPUNIT_ASSERT( none == 0 && last_plane == 2 );
+      unsigned int all = gmtl::CULL_ALL_PLANES;
+      CPPUNIT_ASSERT( gmtl::classify( f, gmtl::AABoxf(), all, last_plane ) == gmtl::CULL_OUTSIDE );
+      CPPUNIT_ASSERT( gmtl::classify( f, gmtl::Spheref(), all, last_plane ) == gmtl::CULL_OUTSIDE );
+   }
+
+   /** Whether an oriented box is behind one of the planes of f. */
+   template<class DATA_TYPE>
+   static bool isBehindPlane( const gmtl::Frustum<DATA_TYPE>& f, const gmtl::OOBox<DATA_TYPE>& box )
+   {
+      gmtl::Point<DATA_TYPE, 3> verts[8];
+      box.getVerts( verts );
+      for (unsigned int i = 0; i < 6; ++i)
+      {
+         bool behind = true;
+         for (unsigned int k = 0; k < 8 && behind; ++k)
+         {
+            behind = gmtl::dot( f.mPlanes[i].mNorm, gmtl::Vec<DATA_TYPE, 3>( verts[k] ) ) + f.mPlanes[i].mOffset < DATA_TYPE( 0 );
+         }
+         if (behind)
+         {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   /** The sphere around an oriented box. */
+   template<class DATA_TYPE>
+   static gmtl::Sphere<DATA_TYPE> boundingSphere( const gmtl::OOBox<DATA_TYPE>& box )
+   {
+      return gmtl::Sphere<DATA_TYPE>( box.mCenter, gmtl::Math::sqrt( box.mHalfLen[0] * box.mHalfLen[0] +
+                                                                     box.mHalfLen[1] * box.mHalfLen[1] +
+                                                                     box.mHalfLen[2] * box.mHalfLen[2] ) );
+   }
+
+   /** The sphere around the corners of a frustum. */
+   template<class DATA_TYPE>
+   static gmtl::Sphere<DATA_TYPE> boundingSphere( const gmtl::Point<DATA_TYPE, 3> corners[8] )
+   {
+      gmtl::Point<DATA_TYPE, 3> center( corners[0] );
+      for (unsigned int i = 1; i < 8; ++i)
+      {
+         center += corners[i];
+      }
+      center /= DATA_TYPE( 8 );
+      DATA_TYPE radius( 0 );
+      for (unsigned int i = 0; i < 8; ++i)
+      {
+         radius = gmtl::Math::Max( radius, gmtl::length( gmtl::Vec<DATA_TYPE, 3>( corners[i] - center ) ) );
+      }
+      return gmtl::Sphere<DATA_TYPE>( center, radius );
+   }
+
+   void FrustumTest::testOOBox()
+   {
+      gmtl::Point3f expected[8];
+      const gmtl::Frustumf f = makeFrustum( gmtl::Vec3f( 1, 2, 3 ), gmtl::Vec3f( 0.2f, -0.3f, 0.1f ), 60.0f, 50.0f, expected );
+      gmtl::Point3f corners[8];
+      CPPUNIT_ASSERT( gmtl::helpers::getFrustumCorners( f, corners ) );
+      for (unsigned int i = 0; i < 8; ++i)
+      {
+         CPPUNIT_ASSERT( gmtl::isEqual( corners[i], expected[i], 1e-3f ) );
+      }
+
+      std::vector<gmtl::OOBoxf> boxes;
+      fillOOBoxes( boxes, 2000 );
+      unsigned int inside = 0, outside = 0, sphere_culled = 0, planes_culled = 0;
+      for (std::size_t i = 0; i < boxes.size(); ++i)
+      {
+         const bool result = gmtl::isInVolume( f, boxes[i] );
+         (result ? inside : outside) += 1;
+
+         // a box with a point in the frustum is never culled
+         gmtl::Point3f verts[8];
+         boxes[i].getVerts( verts );
+         if (hasPointInside( f, verts ))
+         {
+            CPPUNIT_ASSERT( result );
+         }
+
+         // it culls all the boxes the sphere and plane tests do, and more
+         if (!gmtl::isInVolume( f, boundingSphere( boxes[i] ) ))
+         {
+            CPPUNIT_ASSERT( !result );
+         }
+         else
+         {
+            sphere_culled += result ? 0 : 1;
+         }
+         if (isBehindPlane( f, boxes[i] ))
+         {
+            CPPUNIT_ASSERT( !result );
+         }
+         else
+         {
+            planes_culled += result ? 0 : 1;
+         }
+      }
+      CPPUNIT_ASSERT( inside > 0 && outside > 0 && sphere_culled > 0 && planes_culled > 0 );
+
+      // the corners of a box aligned with the axes agree with the AABox tests
+      std::vector<gmtl::AABoxf> aaboxes;
+      fillBoxes( aaboxes, 500 );
+      for (std::size_t i = 0; i < aaboxes.size(); ++i)
+      {
+         gmtl::OOBoxf box;
+         box.mCenter = (aaboxes[i].mMin + aaboxes[i].mMax) * 0.5f;
+         for (unsigned int k = 0; k < 3; ++k)
+         {
+            box.mHalfLen[k] = (aaboxes[i].mMax[k] - aaboxes[i].mMin[k]) * 0.5f;
+         }
+         if (gmtl::classify( f, aaboxes[i] ) == gmtl::CULL_OUTSIDE)
+         {
+            CPPUNIT_ASSERT( !gmtl::isInVolume( f, box ) );
+         }
+      }
+
+      // a box around the frustum, one inside it, and one around the eye
+      gmtl::OOBoxf box;
+      box.mCenter.set( 1, 2, -20 );
+      box.mHalfLen[0] = box.mHalfLen[1] = box.mHalfLen[2] = 100.0f;
+      CPPUNIT_ASSERT( gmtl::isInVolume( f, box ) );
+      box.mCenter = (corners[0] + corners[6]) * 0.5f;
+      box.mHalfLen[0] = box.mHalfLen[1] = box.mHalfLen[2] = 0.01f;
+      CPPUNIT_ASSERT( gmtl::isInVolume( f, box ) );
+      box.mCenter.set( 1, 2, 3 );
+      box.mHalfLen[0] = box.mHalfLen[1] = box.mHalfLen[2] = 0.1f;
+      CPPUNIT_ASSERT( !gmtl::isInVolume( f, box ) );
+
+      // in double
+      const gmtl::Frustumd fd = makeFrustum<double>();
+      std::vector<gmtl::OOBoxd> boxesd;
+      fillOOBoxes( boxesd, 500 );
+      for (std::size_t i = 0; i < boxesd.size(); ++i)
+      {
+         gmtl::Point3d verts[8];
+         boxesd[i].getVerts( verts );
+         if (hasPointInside( fd, verts ))
+         {
+            CPPUNIT_ASSERT( gmtl::isInVolume( fd, boxesd[i] ) );
+         }
+         if (isBehindPlane( fd, boxesd[i] ))
+         {
+            CPPUNIT_ASSERT( !gmtl::isInVolume( fd, boxesd[i] ) );
+         }
+      }
+   }
+
+   void FrustumTest::testFrustumFrustum()
+   {
+      gmtl::Point3f c1[8];
+      const gmtl::Frustumf f1 = makeFrustum( gmtl::Vec3f( 1, 2, 3 ), gmtl::Vec3f( 0.2f, -0.3f, 0.1f ), 60.0f, 50.0f, c1 );
+      CPPUNIT_ASSERT( gmtl::intersect( f1, f1 ) );
+
+      unsigned int hits = 0, misses = 0, sphere_culled = 0, planes_culled = 0;
+      for (std::size_t i = 0; i < 1000; ++i)
+      {
+         gmtl::Point3f c2[8];
+         const gmtl::Frustumf f2 = makeOtherFrustum( i, c2 );
+         const bool result = gmtl::intersect( f1, f2 );
+         CPPUNIT_ASSERT( result == gmtl::intersect( f2, f1 ) );
+         (result ? hits : misses) += 1;
+
+         // frustums sharing a point always intersect
+         if (hasPointInside( f1, c2 ) || hasPointInside( f2, c1 ))
+         {
+            CPPUNIT_ASSERT( result );
+         }
+
+         // it culls all the frustums the sphere and plane tests do, and more
+         if (!gmtl::isInVolume( f1, boundingSphere( c2 ) ))
+         {
+            CPPUNIT_ASSERT( !result );
+         }
+         else
+         {
+            sphere_culled += result ? 0 : 1;
+         }
+         bool behind = false;
+         for (unsigned int p = 0; p < 6 && !behind; ++p)
+         {
+            bool behind1 = true, behind2 = true;
+            for (unsigned int k = 0; k < 8; ++k)
+            {
+               behind1 = behind1 && gmtl::dot( f1.mPlanes[p].mNorm, gmtl::Vec3f( c2[k] ) ) + f1.mPlanes[p].mOffset < 0.0f;
+               behind2 = behind2 && gmtl::dot( f2.mPlanes[p].mNorm, gmtl::Vec3f( c1[k] ) ) + f2.mPlanes[p].mOffset < 0.0f;
+            }
+            behind = behind1 || behind2;
+         }
+         if (behind)
+         {
+            CPPUNIT_ASSERT( !result );
+         }
+         else
+         {
+            planes_culled += result ? 0 : 1;
+         }
+      }
+      CPPUNIT_ASSERT( hits > 0 && misses > 0 && sphere_culled > 0 && planes_culled > 0 );
+
+      // a frustum with planes in their default state has no corners
+      CPPUNIT_ASSERT( gmtl::intersect( f1, gmtl::Frustumf() ) );
+
+      // in double
+      gmtl::Point3d c1d[8];
+      const gmtl::Frustumd f1d = makeFrustum( gmtl::Vec3d( 1, 2, 3 ), gmtl::Vec3d( 0.2, -0.3, 0.1 ), 60.0, 50.0, c1d );
+      for (std::size_t i = 0; i < 200; ++i)
+      {
+         gmtl::Point3d c2d[8];
+         const gmtl::Frustumd f2d = makeOtherFrustum( i, c2d );
+         if (hasPointInside( f1d, c2d ) || hasPointInside( f2d, c1d ))
+         {
+            CPPUNIT_ASSERT( gmtl::intersect( f1d, f2d ) );
+         }
+         if (!gmtl::isInVolume( f1d, boundingSphere( c2d ) ))
+         {
+            CPPUNIT_ASSERT( !gmtl::intersect( f1d, f2d ) );
+         }
+      }
+   }
+
+   void FrustumTest::testBatchBoxes()
+   {
+      const gmtl::Frustumf f = makeFrustum<float>();
+      const std::size_t sizes[] = { 1, 3, 8, 13, 64, 65, 203, 1000 };
+      for (std::size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+      {
+         std::vector<gmtl::AABoxf> boxes;
+         fillBoxes( boxes, sizes[s] );
+         if (sizes[s] > 10)
+         {
+            boxes[9] = gmtl::AABoxf();
+         }
+         checkBatchBoxes( f, boxes );
+      }
+
+      // frustums with normal components of zero and of both signs
+      gmtl::Frustumf axis_f;
+      axis_f.mPlanes[0] = gmtl::Planef( gmtl::Vec3f( 1, 0, 0 ), 20 );
+      axis_f.mPlanes[1] = gmtl::Planef( gmtl::Vec3f( -1, 0, 0 ), 20 );
+      axis_f.mPlanes[2] = gmtl::Planef( gmtl::Vec3f( 0, 1, 0 ), 20 );
+      axis_f.mPlanes[3] = gmtl::Planef( gmtl::Vec3f( 0, -1, 0 ), 20 );
+      axis_f.mPlanes[4] = gmtl::Planef( gmtl::Vec3f( 0, 0, -1 ), -1 );
+      axis_f.mPlanes[5] = gmtl::Planef( gmtl::Vec3f( 0, 0, 1 ), 50 );
+      std::vector<gmtl::AABoxf> boxes;
+      fillBoxes( boxes, 500 );
+      checkBatchBoxes( axis_f, boxes );
+
+      std::vector<unsigned char> results( 1, 7 );
+      CPPUNIT_ASSERT( gmtl::classify( f, gmtl::makeView( gmtl::Vec3fArray() ), gmtl::makeView( gmtl::Vec3fArray() ),
+                                      &results[0] ) == 0 );
+      CPPUNIT_ASSERT( results[0] == 7 );
+   }
+
+   void FrustumTest::testBatchSpheres()
+   {
+      const gmtl::Frustumf f = makeFrustum<float>();
+      const std::size_t sizes[] = { 1, 5, 8, 64, 77, 1000 };
+      for (std::size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+      {
+         std::vector<gmtl::Spheref> spheres;
+         fillSpheres( spheres, sizes[s] );
+         if (sizes[s] > 10)
+         {
+            spheres[4] = gmtl::Spheref();
+            spheres[5].setRadius( 0.0f );
+         }
+
+         gmtl::Vec3fArray centers;
+         std::vector<float> radii;
+         for (std::size_t i = 0; i < spheres.size(); ++i)
+         {
+            centers.push_back( gmtl::Vec3f( spheres[i].mCenter ) );
+            radii.push_back( spheres[i].mRadius );
+         }
+         std::vector<unsigned char> soa( spheres.size() + 1, 7 ), aos( spheres.size() + 1, 7 );
+         const std::size_t soa_visible = gmtl::classify( f, gmtl::makeView( centers ), &radii[0], &soa[0] );
+         const std::size_t aos_visible = gmtl::classify( f, &spheres[0], spheres.size(), &aos[0] );
+
+         std::size_t visible = 0;
+         for (std::size_t i = 0; i < spheres.size(); ++i)
+         {
+            const gmtl::CullResult expected = gmtl::classify( f, spheres[i] );
+            CPPUNIT_ASSERT( aos[i] == expected );
+            if (spheres[i].isInitialized())
+            {
+               CPPUNIT_ASSERT( soa[i] == expected );
+            }
+            visible += (aos[i] != gmtl::CULL_OUTSIDE) ? 1 : 0;
+         }
+         CPPUNIT_ASSERT( aos_visible == visible && soa_visible >= visible );
+         CPPUNIT_ASSERT( soa.back() == 7 && aos.back() == 7 );
+      }
+   }
+
+   void FrustumTest::testBatchDouble()
+   {
+      const gmtl::Frustumd f = makeFrustum<double>();
+      std::vector<gmtl::AABoxd> boxes;
+      fillBoxes( boxes, 301 );
+      checkBatchBoxes( f, boxes );
+      for (std::size_t i = 0; i < boxes.size(); ++i)
+      {
+         CPPUNIT_ASSERT( gmtl::classify( f, boxes[i] ) == classifyCorners( f, boxes[i] ) );
+      }
+
+      std::vector<gmtl::Sphered> spheres;
+      fillSpheres( spheres, 301 );
+      std::vector<unsigned char> results( spheres.size() );
+      gmtl::classify( f, &spheres[0], spheres.size(), &results[0] );
+      for (std::size_t i = 0; i < spheres.size(); ++i)
+      {
+         CPPUNIT_ASSERT( results[i] == gmtl::classify( f, spheres[i] ) );
+      }
+   }
+
+   /** The plane block tests do the same arithmetic as the frustum ones,
+    *  but the compiler may contract either into FMAs (-ffp-contract), so
+    *  a volume that touches a plane to within rounding may be classified
+    *  either way.  Checks that result is the class of box, or of box grown
+    *  or shrunk by a little.
+    */
+   template<class DATA_TYPE>
+   static bool isClassifiedAs( const gmtl::CullResult result, const gmtl::Frustum<DATA_TYPE>& f,
+                               const gmtl::AABox<DATA_TYPE>& box )
+   {
+      if (result == gmtl::classify( f, box ))
+      {
+         return true;
+      }
+      const DATA_TYPE eps = (sizeof( DATA_TYPE ) == sizeof( float )) ? DATA_TYPE( 1e-3 ) : DATA_TYPE( 1e-11 );
+      const gmtl::Vec<DATA_TYPE, 3> d( eps, eps, eps );
+      const gmtl::AABox<DATA_TYPE> grown( box.mMin - d, box.mMax + d );
+      gmtl::AABox<DATA_TYPE> shrunk( box );
+      for (unsigned int k = 0; k < 3; ++k)
+      {
+         if (box.mMax[k] - box.mMin[k] > DATA_TYPE( 2 ) * eps)
+         {
+            shrunk.mMin[k] += eps;
+            shrunk.mMax[k] -= eps;
+         }
+      }
+      return result == gmtl::classify( f, grown ) || result == gmtl::classify( f, shrunk );
+   }
+
+   /** isClassifiedAs() for spheres. */
+   template<class DATA_TYPE>
+   static bool isClassifiedAs( const gmtl::CullResult result, const gmtl::Frustum<DATA_TYPE>& f,
+                               const gmtl::Sphere<DATA_TYPE>& sphere )
+   {
+      if (result == gmtl::classify( f, sphere ))
+      {
+         return true;
+      }
+      const DATA_TYPE eps = (sizeof( DATA_TYPE ) == sizeof( float )) ? DATA_TYPE( 1e-3 ) : DATA_TYPE( 1e-11 );
+      const DATA_TYPE r = sphere.mRadius;
+      return result == gmtl::classify( f, gmtl::Sphere<DATA_TYPE>( sphere.mCenter, r + eps ) ) ||
+             result == gmtl::classify( f, gmtl::Sphere<DATA_TYPE>( sphere.mCenter, gmtl::Math::Max( DATA_TYPE( 0 ), r - eps ) ) );
+   }
+
+   /** Checks the tests against a FrustumPlaneBlock of f against the ones
+    *  against f.
+    */
+   template<class DATA_TYPE>
+   static void checkPlaneBlock( const gmtl::Frustum<DATA_TYPE>& f, unsigned int counts[3] )
+   {
+      const gmtl::FrustumPlaneBlock<DATA_TYPE> planes( f );
+      for (unsigned int i = 0; i < 6; ++i)
+      {
+         CPPUNIT_ASSERT( planes.getPlane( i ) == f.mPlanes[i] );
+      }
+
+      std::vector< gmtl::AABox<DATA_TYPE> > boxes;
+      fillBoxes( boxes, 2000 );
+      std::vector< gmtl::Sphere<DATA_TYPE> > spheres;
+      fillSpheres( spheres, 2000 );
+      for (std::size_t i = 0; i < boxes.size(); ++i)
+      {
+         const gmtl::CullResult result = gmtl::classify( planes, boxes[i] );
+         CPPUNIT_ASSERT( isClassifiedAs( result, f, boxes[i] ) );
+         CPPUNIT_ASSERT( isClassifiedAs( gmtl::classify( planes, spheres[i] ), f, spheres[i] ) );
+         ++counts[result];
+
+         DATA_TYPE dists[gmtl::FrustumPlaneBlock<DATA_TYPE>::Size];
+         gmtl::getDistances( planes, spheres[i].mCenter, dists );
+         for (unsigned int p = 0; p < 6; ++p)
+         {
+            const gmtl::Vec<DATA_TYPE, 3>& n = f.mPlanes[p].mNorm;
+            const gmtl::Point<DATA_TYPE, 3>& c = spheres[i].mCenter;
+            const DATA_TYPE offset = f.mPlanes[p].mOffset;
+            const DATA_TYPE scale = gmtl::Math::abs( n[0] * c[0] ) + gmtl::Math::abs( n[1] * c[1] ) +
+                                    gmtl::Math::abs( n[2] * c[2] ) + gmtl::Math::abs( offset );
+            const DATA_TYPE eps = (sizeof( DATA_TYPE ) == sizeof( float )) ? DATA_TYPE( 1e-6 ) : DATA_TYPE( 1e-14 );
+            CPPUNIT_ASSERT( gmtl::Math::abs( dists[p] - (n[0] * c[0] + n[1] * c[1] + n[2] * c[2] + offset) ) <=
+                            eps * scale );
+         }
+         CPPUNIT_ASSERT( dists[6] > DATA_TYPE( 1e30 ) && dists[7] > DATA_TYPE( 1e30 ) );
+      }
+
+      CPPUNIT_ASSERT( gmtl::classify( planes, gmtl::AABox<DATA_TYPE>() ) == gmtl::CULL_OUTSIDE );
+      CPPUNIT_ASSERT( gmtl::classify( planes, gmtl::Sphere<DATA_TYPE>() ) == gmtl::CULL_OUTSIDE );
+
+      // a block of padding only culls nothing
+      const gmtl::FrustumPlaneBlock<DATA_TYPE> none;
+      CPPUNIT_ASSERT( gmtl::classify( none, boxes[0] ) == gmtl::CULL_INSIDE );
+      CPPUNIT_ASSERT( gmtl::classify( none, spheres[0] ) == gmtl::CULL_INSIDE );
+   }
+
+   void FrustumTest::testNormalizedPlanes()
+   {
+      gmtl::Matrix44f proj;
+      gmtl::setPerspective( proj, 60.0f, 1.5f, 1.0f, 50.0f );
+      const gmtl::Matrix44f view = gmtl::makeTrans<gmtl::Matrix44f>( gmtl::Vec3f( -1, -2, -3 ) );
+
+      // the default extraction is unchanged
+      const gmtl::Frustumf raw( view, proj );
+      gmtl::Frustumf expected( raw );
+      gmtl::normalize( expected );
+      const gmtl::Frustumf normalized( view, proj, true );
+      const gmtl::Frustumf raw_proj( proj ), normalized_proj( proj, true );
+      gmtl::Frustumf extracted;
+      extracted.extractPlanes( view, proj, true );
+      bool is_normalized = true;
+      for (unsigned int i = 0; i < 6; ++i)
+      {
+         CPPUNIT_ASSERT( normalized.mPlanes[i] == expected.mPlanes[i] );
+         CPPUNIT_ASSERT( extracted.mPlanes[i] == expected.mPlanes[i] );
+         CPPUNIT_ASSERT( gmtl::Math::isEqual( gmtl::length( normalized.mPlanes[i].mNorm ), 1.0f, 1e-6f ) );
+         is_normalized = is_normalized && gmtl::Math::isEqual( gmtl::length( raw.mPlanes[i].mNorm ), 1.0f, 1e-6f );
+
+         gmtl::Plane<float> plane = raw_proj.mPlanes[i];
+         const float len = gmtl::length( plane.mNorm );
+         plane.mNorm /= len;
+         plane.mOffset /= len;
+         CPPUNIT_ASSERT( gmtl::isEqual( plane, normalized_proj.mPlanes[i], 1e-6f ) );
+      }
+      CPPUNIT_ASSERT( !is_normalized );
+
+      // the plane equations are true distances: the eye is the apex of the
+      // side planes, 1 behind the near plane and 50 in front of the far one
+      const gmtl::Vec3f eye( 1, 2, 3 );
+      float dists[6];
+      for (unsigned int i = 0; i < 6; ++i)
+      {
+         dists[i] = gmtl::dot( normalized.mPlanes[i].mNorm, eye ) + normalized.mPlanes[i].mOffset;
+      }
+      for (unsigned int i = 0; i < 4; ++i)
+      {
+         CPPUNIT_ASSERT( gmtl::Math::isEqual( dists[i], 0.0f, 1e-5f ) );
+      }
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( dists[gmtl::Frustumf::PLANE_NEAR], -1.0f, 1e-5f ) );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( dists[gmtl::Frustumf::PLANE_FAR], 50.0f, 1e-4f ) );
+   }
+
+   void FrustumTest::testPlaneBlock()
+   {
+      unsigned int counts[3] = { 0, 0, 0 };
+      checkPlaneBlock( makeFrustum<float>(), counts );
+      checkPlaneBlock( makeFrustum<double>(), counts );
+      for (std::size_t i = 0; i < 8; ++i)
+      {
+         gmtl::Point3f corners[8];
+         checkPlaneBlock( makeOtherFrustum<float>( i, corners ), counts );
+      }
+      CPPUNIT_ASSERT( counts[gmtl::CULL_OUTSIDE] > 0 && counts[gmtl::CULL_INTERSECTING] > 0 &&
+                      counts[gmtl::CULL_INSIDE] > 0 );
+   }
+
+   void FrustumMetricTest::testTimingCullBoxes()
+   {
+      const gmtl::Frustumf f = makeFrustum<float>();
+      std::vector<gmtl::AABoxf> boxes;
+      fillBoxes( boxes, 65536 );
+      gmtl::Vec3fArray mins, maxs;
+      for (std::size_t i = 0; i < boxes.size(); ++i)
+      {
+         mins.push_back( gmtl::Vec3f( boxes[i].mMin ) );
+         maxs.push_back( gmtl::Vec3f( boxes[i].mMax ) );
+      }
+      std::vector<unsigned char> results( boxes.size() );
+      std::size_t visible = 0;
+
+      const long iters(20);
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < boxes.size(); ++i)
+         {
+            visible += gmtl::isInVolume( f, boxes[i] ) ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("FrustumTest/isInVolume(Frustum, AABox) 64k boxes", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < boxes.size(); ++i)
+         {
+            results[i] = static_cast<unsigned char>( gmtl::classify( f, boxes[i] ) );
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("FrustumTest/classify(Frustum, AABox) 64k boxes", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         visible += gmtl::classify( f, &boxes[0], boxes.size(), &results[0] );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("FrustumTest/classify(Frustum, AABox*) 64k boxes", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         visible += gmtl::classify( f, gmtl::makeView( mins ), gmtl::makeView( maxs ), &results[0] );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("FrustumTest/classify(Frustum, Vec3Array mins, maxs) 64k boxes", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( visible > 0 );
+   }
+
+   void FrustumMetricTest::testTimingOOBox()
+   {
+      const gmtl::Frustumf f = makeFrustum<float>();
+      std::vector<gmtl::OOBoxf> boxes;
+      fillOOBoxes( boxes, 16384 );
+      std::vector<gmtl::Spheref> spheres( boxes.size() );
+      for (std::size_t i = 0; i < boxes.size(); ++i)
+      {
+         spheres[i] = boundingSphere( boxes[i] );
+      }
+      std::size_t visible = 0, sphere_visible = 0;
+
+      const long iters(20);
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < boxes.size(); ++i)
+         {
+            visible += gmtl::isInVolume( f, boxes[i] ) ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("FrustumTest/isInVolume(Frustum, OOBox) 16k boxes", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      // the spheres around the boxes, for comparison
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < spheres.size(); ++i)
+         {
+            sphere_visible += gmtl::isInVolume( f, spheres[i] ) ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("FrustumTest/isInVolume(Frustum, Sphere) 16k bounding spheres", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( 0 < visible && visible < sphere_visible );
+   }
+
+   void FrustumMetricTest::testTimingFrustumFrustum()
+   {
+      std::vector<gmtl::Frustumf> frustums;
+      std::vector<gmtl::Spheref> spheres;
+      for (std::size_t i = 0; i < 256; ++i)
+      {
+         gmtl::Point3f corners[8];
+         frustums.push_back( makeOtherFrustum( i, corners ) );
+         spheres.push_back( boundingSphere( corners ) );
+      }
+      std::size_t hits = 0, sphere_hits = 0;
+
+      const long iters(4);
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < frustums.size(); ++i)
+         {
+            for (std::size_t j = 0; j < frustums.size(); ++j)
+            {
+               hits += gmtl::intersect( frustums[i], frustums[j] ) ? 1 : 0;
+            }
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("FrustumTest/intersect(Frustum, Frustum) 64k pairs", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      // a frustum against the sphere around the other, for comparison
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < frustums.size(); ++i)
+         {
+            for (std::size_t j = 0; j < frustums.size(); ++j)
+            {
+               sphere_hits += gmtl::isInVolume( frustums[i], spheres[j] ) ? 1 : 0;
+            }
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("FrustumTest/isInVolume(Frustum, Sphere) 64k bounding spheres", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( 0 < hits && hits < sphere_hits );
+   }
+
+   void FrustumMetricTest::testTimingCullSpheres()
+   {
+      const gmtl::Frustumf f = makeFrustum<float>();
+      std::vector<gmtl::Spheref> spheres;
+      fillSpheres( spheres, 65536 );
+      gmtl::Vec3fArray centers;
+      std::vector<float> radii;
+      for (std::size_t i = 0; i < spheres.size(); ++i)
+      {
+         centers.push_back( gmtl::Vec3f( spheres[i].mCenter ) );
+         radii.push_back( spheres[i].mRadius );
+      }
+      std::vector<unsigned char> results( spheres.size() );
+      std::size_t visible = 0;
+
+      const long iters(20);
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < spheres.size(); ++i)
+         {
+            visible += gmtl::isInVolume( f, spheres[i] ) ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("FrustumTest/isInVolume(Frustum, Sphere) 64k spheres", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         visible += gmtl::classify( f, &spheres[0], spheres.size(), &results[0] );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("FrustumTest/classify(Frustum, Sphere*) 64k spheres", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         visible += gmtl::classify( f, gmtl::makeView( centers ), &radii[0], &results[0] );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("FrustumTest/classify(Frustum, Vec3Array centers, radii) 64k spheres", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( visible > 0 );
+   }
+
+   void FrustumMetricTest::testTimingPlaneBlock()
+   {
+      const gmtl::Frustumf f = makeFrustum<float>();
+      const gmtl::FrustumPlaneBlockf planes( f );
+      std::vector<gmtl::AABoxf> boxes;
+      fillBoxes( boxes, 65536 );
+      std::vector<gmtl::Spheref> spheres;
+      fillSpheres( spheres, 65536 );
+      std::size_t visible = 0;
+
+      const long iters(20);
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < spheres.size(); ++i)
+         {
+            visible += (gmtl::classify( f, spheres[i] ) != gmtl::CULL_OUTSIDE) ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("FrustumTest/classify(Frustum, Sphere) 64k spheres", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < spheres.size(); ++i)
+         {
+            visible += (gmtl::classify( planes, spheres[i] ) != gmtl::CULL_OUTSIDE) ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("FrustumTest/classify(FrustumPlaneBlock, Sphere) 64k spheres", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < boxes.size(); ++i)
+         {
+            visible += (gmtl::classify( f, boxes[i] ) != gmtl::CULL_OUTSIDE) ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("FrustumTest/classify(Frustum, AABox) 64k boxes (plane block)", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < boxes.size(); ++i)
+         {
+            visible += (gmtl::classify( planes, boxes[i] ) != gmtl::CULL_OUTSIDE) ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("FrustumTest/classify(FrustumPlaneBlock, AABox) 64k boxes", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( visible > 0 );
+   }
+}
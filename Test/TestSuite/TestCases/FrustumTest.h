@@ -0,0 +1,70 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_FRUSTUM_TEST_H_
+#define _GMTL_FRUSTUM_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace gmtlTest
+{
+   /**
+    * Functionality tests for Frustum culling.
+    */
+   class FrustumTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(FrustumTest);
+
+      CPPUNIT_TEST(testClassifyBox);
+      CPPUNIT_TEST(testClassifySphere);
+      CPPUNIT_TEST(testClassifyMasked);
+      CPPUNIT_TEST(testOOBox);
+      CPPUNIT_TEST(testFrustumFrustum);
+      CPPUNIT_TEST(testBatchBoxes);
+      CPPUNIT_TEST(testBatchSpheres);
+      CPPUNIT_TEST(testBatchDouble);
+      CPPUNIT_TEST(testNormalizedPlanes);
+      CPPUNIT_TEST(testPlaneBlock);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testClassifyBox();
+      void testClassifySphere();
+      void testClassifyMasked();
+      void testOOBox();
+      void testFrustumFrustum();
+      void testBatchBoxes();
+      void testBatchSpheres();
+      void testBatchDouble();
+      void testNormalizedPlanes();
+      void testPlaneBlock();
+   };
+
+   /**
+    * Metric tests.
+    */
+   class FrustumMetricTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(FrustumMetricTest);
+
+      CPPUNIT_TEST(testTimingCullBoxes);
+      CPPUNIT_TEST(testTimingCullSpheres);
+      CPPUNIT_TEST(testTimingOOBox);
+      CPPUNIT_TEST(testTimingFrustumFrustum);
+      CPPUNIT_TEST(testTimingPlaneBlock);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testTimingCullBoxes();
+      void testTimingCullSpheres();
+      void testTimingOOBox();
+      void testTimingFrustumFrustum();
+      void testTimingPlaneBlock();
+   };
+}
+
+#endif
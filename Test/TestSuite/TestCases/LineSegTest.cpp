@@ -616,6 +616,111 @@ namespace gmtlTest
          CPPUNIT_ASSERT( result == false );
       }
    }
+
+   void LineSegTest::intersectRayTriDouble()
+   {
+      // u, v and t are computed in double, far from the origin too
+      {
+         const double far_y = 1.0e8 + 0.1;
+         gmtl::Ray<double> r( gmtl::Point3d( 1.0e7 + 0.25, far_y, -0.25 ), gmtl::Vec3d( 0,-1,0 ) );
+         gmtl::Tri<double> tri( gmtl::Point3d( 1.0e7,0,0 ), gmtl::Point3d( 1.0e7 + 1.0,0,0 ),
+                                gmtl::Point3d( 1.0e7,0,-1 ) );
+         double u, v, t;
+         CPPUNIT_ASSERT( gmtl::intersect( tri, r, u, v, t ) );
+         CPPUNIT_ASSERT( gmtl::Math::isEqual( t, far_y, 1e-6 ) );
+         CPPUNIT_ASSERT( u == 0.25 && v == 0.25 );
+
+         // the same results as from both sides, and back faces culled
+         double u2, v2, t2;
+         CPPUNIT_ASSERT( gmtl::intersectDoubleSided( tri, r, u2, v2, t2 ) );
+         CPPUNIT_ASSERT( gmtl::Math::isEqual( t2, far_y, 1e-6 ) && u2 == 0.25 && v2 == 0.25 );
+         const gmtl::Ray<double> up( gmtl::Point3d( 1.0e7 + 0.25, -far_y, -0.25 ), gmtl::Vec3d( 0,1,0 ) );
+         CPPUNIT_ASSERT( !gmtl::intersect( tri, up, u, v, t ) );
+         CPPUNIT_ASSERT( gmtl::intersectDoubleSided( tri, up, u, v, t ) );
+      }
+
+      // line segments
+      {
+         gmtl::LineSeg<double> l( gmtl::Point3d( 0.25,1,-0.25 ), gmtl::Point3d( 0.25,-1,-0.25 ) );
+         gmtl::Tri<double> tri( gmtl::Point3d( 0,0,0 ), gmtl::Point3d( 1,0,0 ), gmtl::Point3d( 0,0,-1 ) );
+         double u, v, t;
+         CPPUNIT_ASSERT( gmtl::intersect( tri, l, u, v, t ) );
+         CPPUNIT_ASSERT( t == 0.5 && u == 0.25 && v == 0.25 );
+         const gmtl::LineSeg<double> short_l( gmtl::Point3d( 0.25,1,-0.25 ), gmtl::Point3d( 0.25,0.5,-0.25 ) );
+         CPPUNIT_ASSERT( !gmtl::intersect( tri, short_l, u, v, t ) );
+      }
+   }
+
+   void LineSegTest::intersectRayTriWatertight()
+   {
+      // the cases of intersectRayTri()
+      {
+         gmtl::Tri<float> tri( gmtl::Point3f( 0,0,0 ), gmtl::Point3f( 1,0,0 ), gmtl::Point3f( 0,0,-1 ) );
+         float u, v, t;
+         CPPUNIT_ASSERT( gmtl::intersectWatertight( tri, gmtl::Ray<float>( gmtl::Point3f( 0.25,1,-0.25 ), gmtl::Vec3f( 0,-1,0 ) ), u, v, t ) );
+         CPPUNIT_ASSERT( t == 1.0 && u == 0.25 && v == 0.25 );
+         CPPUNIT_ASSERT( !gmtl::intersectWatertight( tri, gmtl::Ray<float>( gmtl::Point3f( -0.25,1,0 ), gmtl::Vec3f( 0,-1,0 ) ), u, v, t ) );
+         CPPUNIT_ASSERT( !gmtl::intersectWatertight( tri, gmtl::Ray<float>( gmtl::Point3f( 0,1,0.25 ), gmtl::Vec3f( 0,-1,0 ) ), u, v, t ) );
+         CPPUNIT_ASSERT( gmtl::intersectWatertight( tri, gmtl::Ray<float>( gmtl::Point3f( 0,1,0 ), gmtl::Vec3f( 0,-1,0 ) ), u, v, t ) );
+         CPPUNIT_ASSERT( t == 1.0 );
+         CPPUNIT_ASSERT( !gmtl::intersectWatertight( tri, gmtl::Ray<float>( gmtl::Point3f( -0.000001,1,0 ), gmtl::Vec3f( 0,-1,0 ) ), u, v, t ) );
+
+         // back faces, behind the origin, in the plane and no direction
+         CPPUNIT_ASSERT( !gmtl::intersectWatertight( tri, gmtl::Ray<float>( gmtl::Point3f( 0.25,-1,-0.25 ), gmtl::Vec3f( 0,1,0 ) ), u, v, t ) );
+         CPPUNIT_ASSERT( gmtl::intersectWatertightDoubleSided( tri, gmtl::Ray<float>( gmtl::Point3f( 0.25,-1,-0.25 ), gmtl::Vec3f( 0,1,0 ) ), u, v, t ) );
+         CPPUNIT_ASSERT( t == 1.0 && u == 0.25 && v == 0.25 );
+         CPPUNIT_ASSERT( !gmtl::intersectWatertightDoubleSided( tri, gmtl::Ray<float>( gmtl::Point3f( 0.25,1,-0.25 ), gmtl::Vec3f( 0,1,0 ) ), u, v, t ) );
+         CPPUNIT_ASSERT( !gmtl::intersectWatertightDoubleSided( tri, gmtl::Ray<float>( gmtl::Point3f( -1,0,-0.25 ), gmtl::Vec3f( 1,0,0 ) ), u, v, t ) );
+         CPPUNIT_ASSERT( !gmtl::intersectWatertightDoubleSided( tri, gmtl::Ray<float>( gmtl::Point3f( 0.25,1,-0.25 ), gmtl::Vec3f( 0,0,0 ) ), u, v, t ) );
+      }
+
+      // agrees with intersect() away from the edges
+      for (int i = 0; i < 200; ++i)
+      {
+         const double f = double( i );
+         const gmtl::Tri<double> tri( gmtl::Point3d( gmtl::Math::sin( f ), gmtl::Math::cos( f * 1.3 ), 0.2 ),
+                                      gmtl::Point3d( gmtl::Math::cos( f * 0.7 ), 0.3, gmtl::Math::sin( f * 2.1 ) ),
+                                      gmtl::Point3d( -0.4, gmtl::Math::sin( f * 0.9 ), gmtl::Math::cos( f * 1.7 ) ) );
+         const gmtl::Ray<double> r( gmtl::Point3d( 2.0 * gmtl::Math::sin( f * 0.37 ), 2.0, 2.0 * gmtl::Math::cos( f * 0.53 ) ),
+                                    gmtl::Vec3d( -gmtl::Math::sin( f * 0.37 ), -1.0, -gmtl::Math::cos( f * 0.53 ) ) );
+         for (int sided = 0; sided < 2; ++sided)
+         {
+            double u, v, t, u2, v2, t2;
+            const bool hit = sided ? gmtl::intersectDoubleSided( tri, r, u, v, t ) : gmtl::intersect( tri, r, u, v, t );
+            const bool hit2 = sided ? gmtl::intersectWatertightDoubleSided( tri, r, u2, v2, t2 ) :
+                                      gmtl::intersectWatertight( tri, r, u2, v2, t2 );
+            if (hit && u > 1e-6 && v > 1e-6 && u + v < 1.0 - 1e-6)
+            {
+               CPPUNIT_ASSERT( hit2 );
+               CPPUNIT_ASSERT( gmtl::Math::isEqual( u, u2, 1e-9 ) && gmtl::Math::isEqual( v, v2, 1e-9 ) &&
+                               gmtl::Math::isEqual( t, t2, 1e-9 ) );
+            }
+            if (hit2 && u2 > 1e-6 && v2 > 1e-6 && u2 + v2 < 1.0 - 1e-6)
+            {
+               CPPUNIT_ASSERT( hit );
+            }
+         }
+      }
+
+      // no ray through the shared edge of a quad far from the origin misses
+      // both of its triangles
+      for (int i = 0; i < 1000; ++i)
+      {
+         const float offset = 1000.0f;
+         const float s = 0.01f + 0.98f * float( i ) / 1000.0f;
+         const gmtl::Point3f p00( offset, offset, 0 ), p10( offset + 1.0f, offset, 0 ),
+                             p11( offset + 1.0f, offset + 1.0f, 0 ), p01( offset, offset + 1.0f, 0 );
+         const gmtl::Tri<float> tri1( p00, p10, p11 ), tri2( p00, p11, p01 );
+         const gmtl::Vec3f dir( 0.1f * gmtl::Math::sin( float( i ) ), 0.1f * gmtl::Math::cos( float( i ) * 1.7f ), -1.0f );
+         const gmtl::Point3f on_edge( offset + s, offset + s, 0.0f );
+         const gmtl::Ray<float> r( gmtl::Point3f( on_edge - dir * 3.7f ), dir );
+         float u, v, t;
+         CPPUNIT_ASSERT( gmtl::intersectWatertight( tri1, r, u, v, t ) ||
+                         gmtl::intersectWatertight( tri2, r, u, v, t ) );
+         CPPUNIT_ASSERT( gmtl::intersectWatertightDoubleSided( tri1, r, u, v, t ) ||
+                         gmtl::intersectWatertightDoubleSided( tri2, r, u, v, t ) );
+      }
+   }
 /*
    void LineSegTest::testDistance()
    {
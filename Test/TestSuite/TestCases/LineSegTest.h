@@ -38,6 +38,8 @@ namespace gmtlTest
       CPPUNIT_TEST(intersectLineSegTri);
       CPPUNIT_TEST(intersectRayPlane);
       CPPUNIT_TEST(intersectRayTri);
+      CPPUNIT_TEST(intersectRayTriDouble);
+      CPPUNIT_TEST(intersectRayTriWatertight);
 
 //      CPPUNIT_TEST(testDistance);
 //      CPPUNIT_TEST(testWhichSide);
@@ -69,6 +71,8 @@ namespace gmtlTest
       void intersectLineSegTri();
       void intersectRayPlane();
       void intersectRayTri();
+      void intersectRayTriDouble();
+      void intersectRayTriWatertight();
 
 //      void testDistance();
 //      void testWhichSide();
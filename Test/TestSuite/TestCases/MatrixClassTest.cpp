@@ -48,6 +48,38 @@ namespace gmtlTest
       CPPUNIT_ASSERT( use_value > 0.0f );
    }
 
+   void MatrixClassMetricTest::testTimingNoInitConstructor()
+   {
+      // Same as testTimingDefaultConstructor, but without the initialization
+      const long iters(25000);
+      float use_value(0);
+      CPPUNIT_METRIC_START_TIMING();
+
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::Matrix<float, 1, 1> test_mat11( gmtl::NO_INIT );
+         test_mat11.mData[0] = 1.0f;
+         gmtl::Matrix<float, 2, 2> test_mat22( gmtl::NO_INIT );
+         test_mat22.mData[0] = 1.0f;
+         gmtl::Matrix<float, 3, 3> test_mat33( gmtl::NO_INIT );
+         test_mat33.mData[4] = 2.0f;
+         gmtl::Matrix<float, 3, 4> test_mat34( gmtl::NO_INIT );
+         test_mat34.mData[5] = 2.0f;
+         gmtl::Matrix<float, 4, 4> test_mat44( gmtl::NO_INIT );
+         test_mat44.mData[15] = 3.0f;
+         gmtl::Matrix<double, 10, 1> test_mat101( gmtl::NO_INIT );
+         test_mat101.mData[9] = 1.0;
+
+         use_value = use_value + test_mat11.mData[0] + test_mat22.mData[0] + test_mat33.mData[4] +
+                     test_mat34.mData[5] + test_mat44.mData[15] + (float)test_mat101.mData[9];
+      }
+
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("MatrixTest/NoInitConstructorOverhead", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( use_value > 0.0f );
+   }
+
    void MatrixClassMetricTest::testTimingCopyConstructor()
    {
       gmtl::Matrix<float, 1, 1> src_mat11;
@@ -279,6 +311,74 @@ namespace gmtlTest
       CPPUNIT_ASSERT_METRIC_TIMING_LE("MatrixTest/SetOverhead", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
    }
 
+   void MatrixClassTest::testMatrixNoInitCreation()
+   {
+      gmtl::Matrix44f mat( gmtl::NO_INIT );
+      CPPUNIT_ASSERT( mat.mState == gmtl::Matrix44f::FULL );
+
+      // identity() and zero() must not trust the garbage
+      gmtl::identity( mat );
+      CPPUNIT_ASSERT( mat == gmtl::Matrix44f() );
+      gmtl::Matrix33d mat33( gmtl::NO_INIT );
+      gmtl::zero( mat33 );
+      for (unsigned i = 0; i < 9; ++i)
+      {
+         CPPUNIT_ASSERT( mat33.mData[i] == 0.0 );
+      }
+
+      gmtl::Matrix44f mat2( gmtl::NO_INIT );
+      mat2.set( mat.getData() );
+      CPPUNIT_ASSERT( mat2 == mat );
+   }
+
+   void MatrixClassTest::testLargeMatrix()
+   {
+      // one template instantiation per element would exceed the depth limit
+      typedef gmtl::Matrix<double, 32, 32> Matrix32d;
+      const Matrix32d ident;
+      for (unsigned r = 0; r < 32; ++r)
+      {
+         for (unsigned c = 0; c < 32; ++c)
+         {
+            CPPUNIT_ASSERT( ident( r, c ) == (r == c ? 1.0 : 0.0) );
+         }
+      }
+
+      double data[32 * 32];
+      for (unsigned i = 0; i < 32 * 32; ++i)
+      {
+         data[i] = double( i );
+      }
+      Matrix32d mat;
+      mat.set( data );
+      const Matrix32d copy( mat );
+      CPPUNIT_ASSERT( copy == mat && copy != ident );
+      CPPUNIT_ASSERT( mat( 3, 5 ) == double( 5 * 32 + 3 ) );
+
+      Matrix32d result;
+      gmtl::add( result, mat, ident );
+      CPPUNIT_ASSERT( result( 7, 7 ) == mat( 7, 7 ) + 1.0 && result( 7, 8 ) == mat( 7, 8 ) );
+      gmtl::sub( result, result, ident );
+      CPPUNIT_ASSERT( result == mat );
+      gmtl::mult( result, mat, 2.0 );
+      CPPUNIT_ASSERT( result( 31, 30 ) == 2.0 * mat( 31, 30 ) );
+
+      gmtl::transpose( result, mat );
+      CPPUNIT_ASSERT( result( 3, 5 ) == mat( 5, 3 ) );
+      gmtl::transpose( result );
+      CPPUNIT_ASSERT( result == mat );
+
+      gmtl::zero( result );
+      CPPUNIT_ASSERT( result( 31, 31 ) == 0.0 );
+      gmtl::identity( result );
+      CPPUNIT_ASSERT( result == ident );
+
+      gmtl::Matrix<float, 8, 40> wide;
+      gmtl::Matrix<float, 40, 8> tall;
+      gmtl::transpose( tall, wide );
+      CPPUNIT_ASSERT( tall( 5, 5 ) == 1.0f && tall( 5, 6 ) == 0.0f );
+   }
+
    void MatrixClassTest::testMatrixIdentity()
    {
       // make sure identity constants are set up correctly.
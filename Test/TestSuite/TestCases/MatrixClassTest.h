@@ -25,6 +25,8 @@ namespace gmtlTest
       CPPUNIT_TEST(testMatrix33Creation);
       CPPUNIT_TEST(testMatrix23Creation);
       CPPUNIT_TEST(testMatrix22Creation);
+      CPPUNIT_TEST(testMatrixNoInitCreation);
+      CPPUNIT_TEST(testLargeMatrix);
 
       CPPUNIT_TEST_SUITE_END();
 
@@ -46,6 +48,12 @@ namespace gmtlTest
       void testMatrix33Creation();
       void testMatrix23Creation();
       void testMatrix22Creation();
+
+      // no-init constructor leaves a FULL matrix that ops can overwrite
+      void testMatrixNoInitCreation();
+
+      // matrices too large to unroll compile and use the plain loops
+      void testLargeMatrix();
    };
 
    /**
@@ -56,6 +64,7 @@ namespace gmtlTest
       CPPUNIT_TEST_SUITE(MatrixClassMetricTest);
 
       CPPUNIT_TEST(testTimingDefaultConstructor);
+      CPPUNIT_TEST(testTimingNoInitConstructor);
       CPPUNIT_TEST(testTimingCopyConstructor);
       CPPUNIT_TEST(testTimingOpEqual);
       CPPUNIT_TEST(testTimingOpParen);
@@ -69,6 +78,7 @@ namespace gmtlTest
 
    public:
       void testTimingDefaultConstructor();
+      void testTimingNoInitConstructor();
       void testTimingCopyConstructor();
 
       void testTimingOpEqual();
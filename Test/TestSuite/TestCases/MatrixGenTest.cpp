@@ -453,9 +453,9 @@ namespace gmtlTest
          // make sure set and make are the same...
          gmtl::Matrix34f new_mat;
          gmtl::setRot( new_mat, gmtl::makeNormal( gmtl::AxisAnglef( gmtl::Math::deg2Rad( 45.0f ), 0.7f, -0.7f, -0.7f ) ) );
-         CPPUNIT_ASSERT( gmtl::makeRot<gmtl::Matrix34f>( gmtl::makeNormal( gmtl::AxisAnglef( gmtl::Math::deg2Rad( 45.0f ), 0.7f, -0.7f, -0.7f ) ) ) == new_mat );
+         CPPUNIT_ASSERT( gmtl::isEqual( gmtl::makeRot<gmtl::Matrix34f>( gmtl::makeNormal( gmtl::AxisAnglef( gmtl::Math::deg2Rad( 45.0f ), 0.7f, -0.7f, -0.7f ) ) ), new_mat, eps ) );
          gmtl::setRot( new_mat, gmtl::AxisAnglef( gmtl::Math::deg2Rad( 45.0f ), vec ) );
-         CPPUNIT_ASSERT( gmtl::makeRot<gmtl::Matrix34f>( gmtl::AxisAnglef( gmtl::Math::deg2Rad( 45.0f ), vec ) ) == new_mat );
+         CPPUNIT_ASSERT( gmtl::isEqual( gmtl::makeRot<gmtl::Matrix34f>( gmtl::AxisAnglef( gmtl::Math::deg2Rad( 45.0f ), vec ) ), new_mat, eps ) );
       }
       // test that unnormalized vec works...
       {
@@ -1036,6 +1036,32 @@ namespace gmtlTest
          // Test inversion
          result = gmtl::makeInvert( mat1 );
          CPPUNIT_ASSERT( gmtl::isEqual( result, expected_value, eps ) );
+
+         // A singular matrix gives the identity, flagged as an error
+         typedef gmtl::Matrix<DATA_TYPE, 3, 3> Matrix33;
+         typedef gmtl::Matrix<DATA_TYPE, 5, 5> Matrix55;
+         DATA_TYPE data33[9], data44[16], data55[25];
+         for (unsigned i = 0; i < 25; ++i)
+         {
+            // rank one: each column is a multiple of (1, 2, 3, ...)
+            if (i < 9)
+               data33[i] = DATA_TYPE( i % 3 + 1 ) * DATA_TYPE( i / 3 + 2 );
+            if (i < 16)
+               data44[i] = DATA_TYPE( i % 4 + 1 ) * DATA_TYPE( i / 4 + 2 );
+            data55[i] = DATA_TYPE( i % 5 + 1 ) * DATA_TYPE( i / 5 + 2 );
+         }
+         gmtl::Matrix<DATA_TYPE, 4, 4> singular;
+         Matrix33 singular33;
+         Matrix55 singular55;
+         singular.set( data44 );
+         singular33.set( data33 );
+         singular55.set( data55 );
+         result = gmtl::makeInvert( singular );
+         CPPUNIT_ASSERT( result.isError() && result == identity );
+         Matrix33 result33 = gmtl::makeInvert( singular33 );
+         CPPUNIT_ASSERT( result33.isError() && result33 == Matrix33() );
+         Matrix55 result55 = gmtl::makeInvert( singular55 );
+         CPPUNIT_ASSERT( result55.isError() && result55 == Matrix55() );
       }
    };
 
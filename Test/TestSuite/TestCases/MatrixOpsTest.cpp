@@ -12,6 +12,8 @@
 #include <gmtl/Matrix.h>
 #include <gmtl/MatrixOps.h>
 #include <gmtl/Generate.h>
+#include <gmtl/QuatOps.h>
+#include <gmtl/Xforms.h>
 #include <gmtl/Output.h>
 
 namespace gmtlTest
@@ -19,6 +21,61 @@ namespace gmtlTest
    CPPUNIT_TEST_SUITE_REGISTRATION(MatrixOpsTest);
    CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(MatrixOpsMetricTest, Suites::metric());
 
+   // Loop versions of the element-wise kernels, used as reference for the
+   // unrolled versions in MatrixOpsMeta.h.
+   namespace loop
+   {
+      template <typename T, unsigned ROWS, unsigned COLS>
+      void identity( gmtl::Matrix<T, ROWS, COLS>& result )
+      {
+         for (unsigned r = 0; r < ROWS; ++r)
+            for (unsigned c = 0; c < COLS; ++c)
+               result( r, c ) = (r == c) ? T(1) : T(0);
+      }
+
+      template <typename T, unsigned ROWS, unsigned COLS>
+      void add( gmtl::Matrix<T, ROWS, COLS>& result, const gmtl::Matrix<T, ROWS, COLS>& lhs,
+                const gmtl::Matrix<T, ROWS, COLS>& rhs )
+      {
+         for (unsigned i = 0; i < ROWS; ++i)
+            for (unsigned j = 0; j < COLS; ++j)
+               result( i, j ) = lhs( i, j ) + rhs( i, j );
+      }
+
+      template <typename T, unsigned ROWS, unsigned COLS>
+      void sub( gmtl::Matrix<T, ROWS, COLS>& result, const gmtl::Matrix<T, ROWS, COLS>& lhs,
+                const gmtl::Matrix<T, ROWS, COLS>& rhs )
+      {
+         for (unsigned i = 0; i < ROWS; ++i)
+            for (unsigned j = 0; j < COLS; ++j)
+               result( i, j ) = lhs( i, j ) - rhs( i, j );
+      }
+
+      template <typename T, unsigned ROWS, unsigned COLS>
+      void mult( gmtl::Matrix<T, ROWS, COLS>& result, const gmtl::Matrix<T, ROWS, COLS>& mat, const T scalar )
+      {
+         for (unsigned i = 0; i < ROWS * COLS; ++i)
+            result.mData[i] = mat.mData[i] * scalar;
+      }
+
+      template <typename T, unsigned ROWS, unsigned COLS>
+      void transpose( gmtl::Matrix<T, ROWS, COLS>& result, const gmtl::Matrix<T, COLS, ROWS>& source )
+      {
+         for (unsigned i = 0; i < ROWS; ++i)
+            for (unsigned j = 0; j < COLS; ++j)
+               result( i, j ) = source( j, i );
+      }
+
+      template <typename T, unsigned ROWS, unsigned COLS>
+      bool equal( const gmtl::Matrix<T, ROWS, COLS>& lhs, const gmtl::Matrix<T, ROWS, COLS>& rhs )
+      {
+         for (unsigned i = 0; i < ROWS * COLS; ++i)
+            if (lhs.mData[i] != rhs.mData[i])
+               return false;
+         return true;
+      }
+   }
+
    void MatrixOpsTest::testMatrixIdentity()
    {
       {
@@ -252,6 +309,102 @@ namespace gmtlTest
       CPPUNIT_ASSERT( res_mat.mData[2] != 1000.0f );
    }
 
+   // Times mult() on 4x4 matrices.  When scalar is true, the generic
+   // template is called explicitly so that the SSE/AVX overloads are
+   // bypassed and the two code paths can be compared.
+   template <typename T, bool scalar>
+   struct matrixTimeMult44
+   {
+      static void go( const char* metricName )
+      {
+         gmtl::Matrix<T, 4, 4> test_mat1, test_mat2, res_mat;
+         test_mat1.set( 0,  1,  2,  3,
+                        4,  5,  6,  7,
+                        8,  9, 10, 11,
+                       12, 13, 14, 15 );
+         gmtl::mult( test_mat1, (T)0.05 );
+         res_mat = test_mat2 = test_mat1;
+
+         const long iters(50000);
+         CPPUNIT_METRIC_START_TIMING();
+         for( long iter=0;iter<iters; ++iter)
+         {
+            if (scalar)
+               gmtl::mult<T, 4, 4, 4>( res_mat, res_mat, test_mat1 );
+            else
+               gmtl::mult( res_mat, res_mat, test_mat1 );
+         }
+         CPPUNIT_METRIC_STOP_TIMING();
+         CPPUNIT_ASSERT_METRIC_TIMING_LE(metricName, iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+         CPPUNIT_ASSERT( test_mat1.mData[2] != test_mat2.mData[0] );
+         CPPUNIT_ASSERT( res_mat.mData[2] != (T)1000 );
+      }
+   };
+
+   void MatrixOpsMetricTest::testMatrixTimeMult44f_scalarMult()
+   {
+      matrixTimeMult44<float, true>::go( "MatrixOpsTest/mult<float,4,4,4>(res,mat44f,mat44f)" );
+   }
+
+   void MatrixOpsMetricTest::testMatrixTimeMult44d_mult()
+   {
+      matrixTimeMult44<double, false>::go( "MatrixOpsTest/mult(res,mat44d,mat44d)" );
+   }
+
+   void MatrixOpsMetricTest::testMatrixTimeMult44d_scalarMult()
+   {
+      matrixTimeMult44<double, true>::go( "MatrixOpsTest/mult<double,4,4,4>(res,mat44d,mat44d)" );
+   }
+
+   // Times mult() of two AFFINE matrices, which takes the multAffine()
+   // path, against the multFull() product of the same matrices.
+   template <typename T>
+   struct matrixTimeMult44Affine
+   {
+      static void go( const char* affineName, const char* fullName )
+      {
+         typedef gmtl::Matrix<T, 4, 4> MatType;
+         MatType test_mat1, res_mat;
+         gmtl::setRot( test_mat1, gmtl::EulerAngle<T, gmtl::XYZ>( (T)0.1, (T)0.2, (T)0.3 ) );
+         gmtl::setTrans( test_mat1, gmtl::Vec<T, 3>( 1, 2, 3 ) );
+         CPPUNIT_ASSERT( test_mat1.mState == MatType::AFFINE );
+
+         const long iters(50000);
+         res_mat = test_mat1;
+         CPPUNIT_METRIC_START_TIMING();
+         for( long iter=0;iter<iters; ++iter)
+         {
+            gmtl::mult( res_mat, res_mat, test_mat1 );
+         }
+         CPPUNIT_METRIC_STOP_TIMING();
+         CPPUNIT_ASSERT_METRIC_TIMING_LE(affineName, iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+         CPPUNIT_ASSERT( res_mat.mData[2] != (T)1000 );
+
+         res_mat = test_mat1;
+         CPPUNIT_METRIC_START_TIMING();
+         for( long iter=0;iter<iters; ++iter)
+         {
+            gmtl::multFull( res_mat, res_mat, test_mat1 );
+         }
+         CPPUNIT_METRIC_STOP_TIMING();
+         CPPUNIT_ASSERT_METRIC_TIMING_LE(fullName, iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+         CPPUNIT_ASSERT( res_mat.mData[2] != (T)1000 );
+      }
+   };
+
+   void MatrixOpsMetricTest::testMatrixTimeMult44f_affine()
+   {
+      matrixTimeMult44Affine<float>::go( "MatrixOpsTest/mult(res,affine44f,affine44f)",
+                                         "MatrixOpsTest/multFull(res,affine44f,affine44f)" );
+   }
+
+   void MatrixOpsMetricTest::testMatrixTimeMult44d_affine()
+   {
+      matrixTimeMult44Affine<double>::go( "MatrixOpsTest/mult(res,affine44d,affine44d)",
+                                          "MatrixOpsTest/multFull(res,affine44d,affine44d)" );
+   }
+
    void MatrixOpsMetricTest::testMatrixTimeMult44_operatorStar()
    {
       gmtl::Matrix<float, 4, 4> test_mat1, test_mat2, res_mat;
@@ -402,6 +555,94 @@ namespace gmtlTest
    }
 
 
+   void MatrixOpsMetricTest::testMatrixTimeExpr44f()
+   {
+      gmtl::Matrix<float, 4, 4> a, b, c, res_mat, temp1, temp2;
+      a.set( 0,  1,  2,  3,
+             4,  5,  6,  7,
+             8,  9, 10, 11,
+            12, 13, 14, 15 );
+      b = c = a;
+      res_mat = a;
+
+      const long iters(50000);
+
+      // with explicit temporaries
+      CPPUNIT_METRIC_START_TIMING();
+      for( long iter=0;iter<iters; ++iter)
+      {
+         gmtl::mult( temp1, a, 0.5f );
+         gmtl::add( temp2, temp1, b );
+         gmtl::sub( temp1, temp2, c );
+         gmtl::add( res_mat, temp1, res_mat );
+         a.mData[0] += 0.01f;
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("MatrixOpsTest/a*s+b-c+res (temporaries)", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      // single pass expression
+      CPPUNIT_METRIC_START_TIMING();
+      for( long iter=0;iter<iters; ++iter)
+      {
+         res_mat = gmtl::makeMatExpr( a ) * 0.5f + b - c + res_mat;
+         a.mData[0] += 0.01f;
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("MatrixOpsTest/a*s+b-c+res (expression)", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( res_mat.mData[2] != 1000.0f );
+   }
+
+   void MatrixOpsMetricTest::testMatrixTimeUnrolled44f()
+   {
+      gmtl::Matrix<float, 4, 4> a, b, res_mat, trans_mat;
+      a.set( 0,  1,  2,  3,
+             4,  5,  6,  7,
+             8,  9, 10, 11,
+            12, 13, 14, 15 );
+      b = a;
+
+      const long iters(50000);
+      unsigned equal_count(0);
+
+      // loop versions
+      CPPUNIT_METRIC_START_TIMING();
+      for( long iter=0;iter<iters; ++iter)
+      {
+         loop::add( res_mat, a, b );
+         loop::sub( res_mat, res_mat, a );
+         loop::mult( res_mat, res_mat, 0.5f );
+         loop::transpose( trans_mat, res_mat );
+         if (loop::equal( trans_mat, a ))
+            ++equal_count;
+         loop::identity( b );
+         loop::add( b, b, trans_mat );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("MatrixOpsTest/add,sub,mult,transpose,==,identity 44f (loops)", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      // unrolled versions
+      b = a;
+      CPPUNIT_METRIC_START_TIMING();
+      for( long iter=0;iter<iters; ++iter)
+      {
+         gmtl::add( res_mat, a, b );
+         gmtl::sub( res_mat, res_mat, a );
+         gmtl::mult( res_mat, res_mat, 0.5f );
+         gmtl::transpose( trans_mat, res_mat );
+         if (trans_mat == a)
+            ++equal_count;
+         b.setState( gmtl::Matrix<float, 4, 4>::FULL );
+         gmtl::identity( b );
+         gmtl::add( b, b, trans_mat );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("MatrixOpsTest/add,sub,mult,transpose,==,identity 44f (unrolled)", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( res_mat.mData[2] != 1000.0f );
+      CPPUNIT_ASSERT( equal_count != 1000000 );
+   }
+
    void MatrixOpsMetricTest::testMatrixTimeSub44()
    {
       gmtl::Matrix<float, 4, 4> test_mat1, test_mat2, res_mat;
@@ -427,6 +668,85 @@ namespace gmtlTest
       CPPUNIT_ASSERT( res_mat.mData[2] != 1000.0f );
    }
 
+   // Times invertFull_cofactor against the two pivoting routines.
+   template <typename T, unsigned SIZE>
+   struct matrixTimeInvert
+   {
+      static void go( const char* cofName, const char* origName, const char* gjName )
+      {
+         typedef gmtl::Matrix<T, SIZE, SIZE> MatType;
+         MatType src[4], res_mat;
+         for (unsigned m = 0; m < 4; ++m)
+         {
+            for (unsigned r = 0; r < SIZE; ++r)
+            for (unsigned c = 0; c < SIZE; ++c)
+            {
+               src[m]( r, c ) = gmtl::Math::rangeRandom( -1.0, 1.0 ) + ((r == c) ? T( 3 ) : T( 0 ));
+            }
+            src[m].setState( MatType::FULL );
+         }
+
+         const long iters(50000);
+         T use_value( 0 );
+         CPPUNIT_METRIC_START_TIMING();
+         for( long iter=0;iter<iters; ++iter)
+         {
+            gmtl::invertFull_cofactor( res_mat, src[iter & 3] );
+            use_value += res_mat.mData[1];
+         }
+         CPPUNIT_METRIC_STOP_TIMING();
+         CPPUNIT_ASSERT_METRIC_TIMING_LE(cofName, iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+         CPPUNIT_METRIC_START_TIMING();
+         for( long iter=0;iter<iters; ++iter)
+         {
+            gmtl::invertFull_orig( res_mat, src[iter & 3] );
+            use_value += res_mat.mData[1];
+         }
+         CPPUNIT_METRIC_STOP_TIMING();
+         CPPUNIT_ASSERT_METRIC_TIMING_LE(origName, iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+         CPPUNIT_METRIC_START_TIMING();
+         for( long iter=0;iter<iters; ++iter)
+         {
+            gmtl::invertFull_GJ( res_mat, src[iter & 3] );
+            use_value += res_mat.mData[1];
+         }
+         CPPUNIT_METRIC_STOP_TIMING();
+         CPPUNIT_ASSERT_METRIC_TIMING_LE(gjName, iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+         CPPUNIT_ASSERT( use_value != T( 1234.5 ) );
+      }
+   };
+
+   void MatrixOpsMetricTest::testMatrixTimeInvert44f()
+   {
+      matrixTimeInvert<float, 4>::go( "MatrixOpsTest/invertFull_cofactor(res,mat44f)",
+                                      "MatrixOpsTest/invertFull_orig(res,mat44f)",
+                                      "MatrixOpsTest/invertFull_GJ(res,mat44f)" );
+   }
+
+   void MatrixOpsMetricTest::testMatrixTimeInvert44d()
+   {
+      matrixTimeInvert<double, 4>::go( "MatrixOpsTest/invertFull_cofactor(res,mat44d)",
+                                       "MatrixOpsTest/invertFull_orig(res,mat44d)",
+                                       "MatrixOpsTest/invertFull_GJ(res,mat44d)" );
+   }
+
+   void MatrixOpsMetricTest::testMatrixTimeInvert33f()
+   {
+      matrixTimeInvert<float, 3>::go( "MatrixOpsTest/invertFull_cofactor(res,mat33f)",
+                                      "MatrixOpsTest/invertFull_orig(res,mat33f)",
+                                      "MatrixOpsTest/invertFull_GJ(res,mat33f)" );
+   }
+
+   void MatrixOpsMetricTest::testMatrixTimeInvert33d()
+   {
+      matrixTimeInvert<double, 3>::go( "MatrixOpsTest/invertFull_cofactor(res,mat33d)",
+                                       "MatrixOpsTest/invertFull_orig(res,mat33d)",
+                                       "MatrixOpsTest/invertFull_GJ(res,mat33d)" );
+   }
+
 
 
    ///////////////////////////////////////////////////
@@ -938,6 +1258,55 @@ namespace gmtlTest
       matrixMultUnlike<double>::go();
    }
 
+   // Checks the specialized 4x4 mult() against the generic template,
+   // including the aliased forms used by postMult() and preMult().
+   template <typename T>
+   class matrixMultKernels44
+   {
+   public:
+      static void go()
+      {
+         const T eps = (T)0.0001;
+         gmtl::Matrix<T, 4, 4> mat1, mat2, expected, result;
+         mat1.set((T) 0.25, (T)-1.50, (T) 3.00, (T) 4.25,
+                  (T) 5.50, (T) 0.75, (T)-2.00, (T) 1.00,
+                  (T)-3.25, (T) 2.50, (T) 1.25, (T)-0.50,
+                  (T) 0.00, (T) 0.00, (T) 0.00, (T) 1.00 );
+         mat2.set((T) 1.00, (T) 2.00, (T)-3.00, (T) 4.00,
+                  (T)-0.50, (T) 1.50, (T) 2.50, (T)-3.50,
+                  (T) 7.00, (T)-1.00, (T) 0.25, (T) 2.00,
+                  (T) 0.10, (T) 0.20, (T) 0.30, (T) 0.40 );
+         mat1.setState( gmtl::Matrix<T, 4, 4>::AFFINE );
+
+         gmtl::mult<T, 4, 4, 4>( expected, mat1, mat2 );
+         gmtl::mult( result, mat1, mat2 );
+         CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+         CPPUNIT_ASSERT( expected.mState == result.mState );
+
+         // result aliases lhs
+         result = mat1;
+         gmtl::mult( result, result, mat2 );
+         CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+
+         // result aliases rhs
+         result = mat2;
+         gmtl::mult( result, mat1, result );
+         CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+
+         // result aliases both
+         gmtl::mult<T, 4, 4, 4>( expected, mat2, mat2 );
+         result = mat2;
+         gmtl::mult( result, result, result );
+         CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+      }
+   };
+
+   void MatrixOpsTest::testMatrixMultKernels()
+   {
+      matrixMultKernels44<float>::go();
+      matrixMultKernels44<double>::go();
+   }
+
    template <typename T>
    class matrixScalarMult
    {
@@ -979,6 +1348,239 @@ namespace gmtlTest
       matrixScalarMult<double>::go();
    }
 
+   template <typename DATA_TYPE>
+   class matrixExpression
+   {
+      typedef DATA_TYPE T;
+   public:
+      static void go()
+      {
+         typedef gmtl::Matrix<T, 4, 4> Mat44;
+         const T eps = (T)0.0001;
+
+         Mat44 a, b, c, d, res, expected, temp;
+         gmtl::setRot( a, gmtl::AxisAngle<T>( (T)1.3, (T)0.6, (T)0.8, (T)0 ) );
+         gmtl::setTrans( b, gmtl::Vec<T, 3>( (T)1, (T)2, (T)3 ) );
+         gmtl::setScale( c, (T)2 );
+         d.set( (T)1,  (T)2,  (T)3,  (T)4,
+                (T)5,  (T)6,  (T)7,  (T)8,
+                (T)9,  (T)10, (T)11, (T)12,
+                (T)13, (T)14, (T)15, (T)17 );
+
+         // chained products and sums
+         gmtl::mult( temp, a, b );
+         gmtl::mult( temp, temp, c );
+         gmtl::add( expected, temp, d );
+         res = gmtl::makeMatExpr( a ) * b * c + d;
+         CPPUNIT_ASSERT( gmtl::isEqual( res, expected, eps ) );
+
+         gmtl::mult( expected, temp, d );
+         res = (gmtl::makeMatExpr( a ) * b) * (gmtl::makeMatExpr( c ) * d);
+         CPPUNIT_ASSERT( gmtl::isEqual( res, expected, eps ) );
+
+         // element-wise ops
+         for (unsigned i = 0; i < 16; ++i)
+         {
+            expected.mData[i] = (T)2 * a.mData[i] - d.mData[i] * (T)3 - b.mData[i];
+         }
+         res = (T)2 * gmtl::makeMatExpr( a ) - gmtl::makeMatExpr( d ) * (T)3 + -gmtl::makeMatExpr( b );
+         CPPUNIT_ASSERT( gmtl::isEqual( res, expected, eps ) );
+         CPPUNIT_ASSERT( res.mState == Mat44::FULL );
+
+         // a product keeps the tracked state
+         res = gmtl::makeMatExpr( a ) * b;
+         CPPUNIT_ASSERT( res.mState == Mat44::AFFINE );
+         CPPUNIT_ASSERT( Mat44( gmtl::makeMatExpr( b ) * b ).mState == Mat44::TRANS );
+
+         // aliasing: the result is the same as with temporaries
+         res = d;
+         gmtl::mult( expected, d, a );
+         gmtl::add( expected, expected, b );
+         res = gmtl::makeMatExpr( res ) * a + b;
+         CPPUNIT_ASSERT( gmtl::isEqual( res, expected, eps ) );
+
+         res = d;
+         gmtl::mult( expected, a, d );
+         res = gmtl::makeMatExpr( a ) * res;
+         CPPUNIT_ASSERT( gmtl::isEqual( res, expected, eps ) );
+
+         res = d;
+         gmtl::add( expected, d, d );
+         res = gmtl::makeMatExpr( res ) + res;
+         CPPUNIT_ASSERT( gmtl::isEqual( res, expected, eps ) );
+
+         // non square sizes
+         gmtl::Matrix<T, 3, 4> m34;
+         gmtl::Matrix<T, 4, 2> m42;
+         gmtl::Matrix<T, 3, 2> m32, m32_expected;
+         for (unsigned i = 0; i < 12; ++i)
+            m34.mData[i] = (T)i;
+         for (unsigned i = 0; i < 8; ++i)
+            m42.mData[i] = (T)(8 - i);
+         gmtl::mult( m32_expected, m34, m42 );
+         gmtl::add( m32_expected, m32_expected, m32_expected );
+         m32 = gmtl::makeMatExpr( m34 ) * m42 + gmtl::makeMatExpr( m34 ) * m42;
+         CPPUNIT_ASSERT( gmtl::isEqual( m32, m32_expected, eps ) );
+
+         // expressions used where a matrix is expected
+         gmtl::mult( expected, a, b );
+         CPPUNIT_ASSERT( gmtl::isEqual( gmtl::makeMatExpr( a ) * b, expected, eps ) );
+         CPPUNIT_ASSERT( gmtl::makeMatExpr( a ) * c == gmtl::makeMatExpr( c ) * a );
+         const gmtl::Point<T, 3> pnt( (T)1, (T)0, (T)0 );
+         CPPUNIT_ASSERT( gmtl::isEqual( (gmtl::makeMatExpr( a ) * b) * pnt, expected * pnt, eps ) );
+
+#ifndef GMTL_MAT_EXPR
+         // by default the operators on plain matrices return a Matrix, so
+         // the result can be passed to anything that takes one
+         {
+            Mat44 ab, inv_ab, r( d );
+            gmtl::mult( ab, a, b );
+            gmtl::invert( inv_ab, ab );
+
+            r *= a * b;
+            gmtl::mult( expected, d, ab );
+            CPPUNIT_ASSERT( gmtl::isEqual( r, expected, eps ) );
+
+            gmtl::invert( r, a * b );
+            CPPUNIT_ASSERT( gmtl::isEqual( r, inv_ab, eps ) );
+            CPPUNIT_ASSERT( gmtl::isEqual( gmtl::makeInvert( a * b ), inv_ab, eps ) );
+
+            gmtl::Point<T, 3> p( (T)1, (T)2, (T)3 );
+            gmtl::xform( p, a * b, p );
+            CPPUNIT_ASSERT( gmtl::isEqual( p, ab * gmtl::Point<T, 3>( (T)1, (T)2, (T)3 ), eps ) );
+
+            gmtl::transpose( r, a * b );
+            gmtl::transpose( expected, ab );
+            CPPUNIT_ASSERT( gmtl::isEqual( r, expected, eps ) );
+
+            gmtl::mult( r, a * b, c );
+            gmtl::mult( expected, ab, c );
+            CPPUNIT_ASSERT( gmtl::isEqual( r, expected, eps ) );
+
+            CPPUNIT_ASSERT( gmtl::isEqual( gmtl::makeTrans<gmtl::Vec<T, 3> >( a * b ),
+                                           gmtl::makeTrans<gmtl::Vec<T, 3> >( ab ), eps ) );
+            CPPUNIT_ASSERT( gmtl::isEquiv( gmtl::make<gmtl::Quat<T> >( a * b ),
+                                           gmtl::make<gmtl::Quat<T> >( a ), eps ) );
+
+            r = (T)2 * a - d * (T)3 + -b;
+            for (unsigned i = 0; i < 16; ++i)
+               expected.mData[i] = (T)2 * a.mData[i] - d.mData[i] * (T)3 - b.mData[i];
+            CPPUNIT_ASSERT( gmtl::isEqual( r, expected, eps ) );
+         }
+#endif
+      }
+   };
+
+   void MatrixOpsTest::testMatrixExpression()
+   {
+      matrixExpression<float>::go();
+      matrixExpression<double>::go();
+   }
+
+   template <typename T, unsigned ROWS, unsigned COLS>
+   class matrixUnrolledKernels
+   {
+   public:
+      static void go()
+      {
+         typedef gmtl::Matrix<T, ROWS, COLS> MatType;
+         MatType a, b, res, expected;
+         for (unsigned i = 0; i < ROWS * COLS; ++i)
+         {
+            a.mData[i] = (T)(i + 1);
+            b.mData[i] = (T)(3 * i) - (T)5;
+         }
+         a.setState( MatType::FULL );
+         b.setState( MatType::FULL );
+
+         // identity, default constructor and zero
+         res = a;
+         gmtl::identity( res );
+         loop::identity( expected );
+         CPPUNIT_ASSERT( loop::equal( res, expected ) );
+         CPPUNIT_ASSERT( loop::equal( MatType(), expected ) );
+         res = a;
+         gmtl::zero( res );
+         for (unsigned i = 0; i < ROWS * COLS; ++i)
+            CPPUNIT_ASSERT( res.mData[i] == (T)0 );
+
+         // copy
+         const MatType copy( a );
+         CPPUNIT_ASSERT( loop::equal( copy, a ) );
+         res.set( b.getData() );
+         CPPUNIT_ASSERT( loop::equal( res, b ) );
+
+         // add, sub and scalar mult, also with the result aliasing an operand
+         gmtl::add( res, a, b );
+         loop::add( expected, a, b );
+         CPPUNIT_ASSERT( loop::equal( res, expected ) );
+         res = a;
+         gmtl::add( res, res, b );
+         CPPUNIT_ASSERT( loop::equal( res, expected ) );
+
+         gmtl::sub( res, a, b );
+         loop::sub( expected, a, b );
+         CPPUNIT_ASSERT( loop::equal( res, expected ) );
+
+         gmtl::mult( res, a, (T)3 );
+         loop::mult( expected, a, (T)3 );
+         CPPUNIT_ASSERT( loop::equal( res, expected ) );
+         res = a;
+         gmtl::mult( res, (T)3 );
+         CPPUNIT_ASSERT( loop::equal( res, expected ) );
+
+         // transpose
+         gmtl::Matrix<T, COLS, ROWS> trans, trans_expected;
+         gmtl::transpose( trans, a );
+         loop::transpose( trans_expected, a );
+         CPPUNIT_ASSERT( loop::equal( trans, trans_expected ) );
+
+         // operator==
+         CPPUNIT_ASSERT( a == copy );
+         res = a;
+         res.mData[ROWS * COLS - 1] += (T)1;
+         CPPUNIT_ASSERT( !(a == res) );
+         res = a;
+         res.mData[0] += (T)1;
+         CPPUNIT_ASSERT( a != res );
+      }
+   };
+
+   template <typename T, unsigned SIZE>
+   class matrixUnrolledTransposeInPlace
+   {
+   public:
+      static void go()
+      {
+         gmtl::Matrix<T, SIZE, SIZE> a, res, expected;
+         for (unsigned i = 0; i < SIZE * SIZE; ++i)
+            a.mData[i] = (T)i;
+         res = a;
+         gmtl::transpose( res );
+         loop::transpose( expected, a );
+         CPPUNIT_ASSERT( loop::equal( res, expected ) );
+      }
+   };
+
+   void MatrixOpsTest::testMatrixUnrolledKernels()
+   {
+      matrixUnrolledKernels<float, 1, 1>::go();
+      matrixUnrolledKernels<float, 2, 2>::go();
+      matrixUnrolledKernels<float, 3, 3>::go();
+      matrixUnrolledKernels<float, 4, 4>::go();
+      matrixUnrolledKernels<double, 4, 4>::go();
+      matrixUnrolledKernels<float, 3, 4>::go();
+      matrixUnrolledKernels<float, 4, 3>::go();
+      matrixUnrolledKernels<double, 2, 5>::go();
+      matrixUnrolledKernels<int, 6, 6>::go();
+
+      matrixUnrolledTransposeInPlace<float, 1>::go();
+      matrixUnrolledTransposeInPlace<float, 2>::go();
+      matrixUnrolledTransposeInPlace<float, 3>::go();
+      matrixUnrolledTransposeInPlace<double, 4>::go();
+      matrixUnrolledTransposeInPlace<int, 5>::go();
+   }
+
    template <typename DATA_TYPE>
    class matInvertKnownFull
    {
@@ -1154,6 +1756,134 @@ namespace gmtlTest
       matInvertFull<double,8>::go();
    }
 
+   // Largest element of |mat * inv - I|
+   template <typename DATA_TYPE, unsigned SIZE>
+   DATA_TYPE invertResidual( const gmtl::Matrix<DATA_TYPE, SIZE, SIZE>& mat,
+                             const gmtl::Matrix<DATA_TYPE, SIZE, SIZE>& inv )
+   {
+      gmtl::Matrix<DATA_TYPE, SIZE, SIZE> prod;
+      gmtl::mult<DATA_TYPE, SIZE, SIZE, SIZE>( prod, mat, inv );
+      DATA_TYPE err( 0 );
+      for (unsigned r = 0; r < SIZE; ++r)
+      for (unsigned c = 0; c < SIZE; ++c)
+      {
+         err = gmtl::Math::Max( err, gmtl::Math::abs( prod( r, c ) - DATA_TYPE( r == c ? 1 : 0 ) ) );
+      }
+      return err;
+   }
+
+   // Compares invertFull_cofactor (SIMD and scalar) with invertFull_orig
+   // and invertFull_GJ on random well conditioned matrices.
+   template <typename DATA_TYPE, unsigned SIZE>
+   class matInvertCofactor
+   {
+   public:
+      static void go()
+      {
+         typedef gmtl::Matrix<DATA_TYPE, SIZE, SIZE> MatType;
+         unsigned const iters(200);
+         const DATA_TYPE eps = (sizeof(DATA_TYPE) == sizeof(float)) ? DATA_TYPE(1e-3) : DATA_TYPE(1e-9);
+
+         DATA_TYPE max_err_cof( 0 ), max_err_orig( 0 ), max_err_gj( 0 );
+         MatType mat, inv_cof, inv_scalar, inv_orig, inv_gj;
+
+         for (unsigned i = 0; i < iters; ++i)
+         {
+            // random values plus a dominant diagonal keeps the condition
+            // number small, so all methods should agree closely
+            for (unsigned r = 0; r < SIZE; ++r)
+            for (unsigned c = 0; c < SIZE; ++c)
+            {
+               mat( r, c ) = gmtl::Math::rangeRandom( -1.0, 1.0 ) + ((r == c) ? DATA_TYPE( 3 ) : DATA_TYPE( 0 ));
+            }
+            mat.setState( MatType::FULL );
+
+            gmtl::invertFull_cofactor( inv_cof, mat );
+            gmtl::invertFull_cofactor<DATA_TYPE>( inv_scalar, mat );
+            gmtl::invertFull_orig( inv_orig, mat );
+            gmtl::invertFull_GJ( inv_gj, mat );
+            CPPUNIT_ASSERT( ! inv_cof.isError() );
+            CPPUNIT_ASSERT( inv_cof.mState == MatType::FULL );
+            CPPUNIT_ASSERT( gmtl::isEqual( inv_cof, inv_orig, eps ) );
+            CPPUNIT_ASSERT( gmtl::isEqual( inv_cof, inv_gj, eps ) );
+            CPPUNIT_ASSERT( gmtl::isEqual( inv_cof, inv_scalar, eps ) );
+
+            max_err_cof = gmtl::Math::Max( max_err_cof, invertResidual( mat, inv_cof ) );
+            max_err_orig = gmtl::Math::Max( max_err_orig, invertResidual( mat, inv_orig ) );
+            max_err_gj = gmtl::Math::Max( max_err_gj, invertResidual( mat, inv_gj ) );
+
+            // in place, and through invert() and invertFull()
+            MatType aliased( mat );
+            gmtl::invertFull_cofactor( aliased, aliased );
+            CPPUNIT_ASSERT( gmtl::isEqual( inv_cof, aliased, eps ) );
+            aliased = mat;
+            gmtl::invert( aliased );
+            CPPUNIT_ASSERT( gmtl::isEqual( inv_cof, aliased, eps ) );
+            gmtl::invertFull( aliased, mat );
+            CPPUNIT_ASSERT( gmtl::isEqual( inv_cof, aliased, eps ) );
+         }
+
+         // the closed form should be in the same accuracy class as the
+         // pivoting routines for well conditioned input
+         CPPUNIT_ASSERT( max_err_cof < eps );
+         CPPUNIT_ASSERT( max_err_cof <= DATA_TYPE( 8 ) * gmtl::Math::Max( max_err_orig, max_err_gj ) + eps * DATA_TYPE( 0.01 ) );
+
+         // singular input flags the error and leaves the data alone
+         for (unsigned r = 0; r < SIZE; ++r)
+         for (unsigned c = 0; c < SIZE; ++c)
+         {
+            mat( r, c ) = DATA_TYPE( r + 1 );
+         }
+         mat.setState( MatType::FULL );
+         MatType untouched;
+         gmtl::invertFull_cofactor( untouched, mat );
+         CPPUNIT_ASSERT( untouched.isError() );
+         CPPUNIT_ASSERT( gmtl::isEqual( untouched, MatType(), DATA_TYPE( 0 ) ) );
+         MatType untouched_scalar;
+         gmtl::invertFull_cofactor<DATA_TYPE>( untouched_scalar, mat );
+         CPPUNIT_ASSERT( untouched_scalar.isError() );
+         MatType inv;
+         gmtl::invert( inv, mat );
+         CPPUNIT_ASSERT( inv.isError() );
+
+         // a small scale is not singular even though the determinant is
+         // far below any absolute threshold
+         const DATA_TYPE scales[2] = { DATA_TYPE( 1e-6 ), DATA_TYPE( 1e-7 ) };
+         for (unsigned k = 0; k < 2; ++k)
+         {
+            MatType small, scaled_ident;
+            for (unsigned r = 0; r < SIZE; ++r)
+            for (unsigned c = 0; c < SIZE; ++c)
+            {
+               small( r, c ) = scales[k] * (gmtl::Math::rangeRandom( -0.5, 0.5 ) + ((r == c) ? DATA_TYPE( 3 ) : DATA_TYPE( 0 )));
+               scaled_ident( r, c ) = (r == c) ? scales[k] : DATA_TYPE( 0 );
+            }
+            small.setState( MatType::FULL );
+            scaled_ident.setState( MatType::FULL );
+
+            const MatType* mats[2] = { &small, &scaled_ident };
+            for (unsigned m = 0; m < 2; ++m)
+            {
+               MatType inv_small;
+               gmtl::invert( inv_small, *mats[m] );
+               CPPUNIT_ASSERT( ! inv_small.isError() );
+               CPPUNIT_ASSERT( invertResidual( *mats[m], inv_small ) < eps );
+               gmtl::invertFull_cofactor<DATA_TYPE>( inv_small, *mats[m] );
+               CPPUNIT_ASSERT( ! inv_small.isError() );
+               CPPUNIT_ASSERT( invertResidual( *mats[m], inv_small ) < eps );
+            }
+         }
+      }
+   };
+
+   void MatrixOpsTest::testMatInvertCofactor()
+   {
+      matInvertCofactor<float, 3>::go();
+      matInvertCofactor<float, 4>::go();
+      matInvertCofactor<double, 3>::go();
+      matInvertCofactor<double, 4>::go();
+   }
+
    /*
    void MatrixOpsTest::testGetSetAxes()
    {
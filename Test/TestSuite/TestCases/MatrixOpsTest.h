@@ -22,8 +22,12 @@ namespace gmtlTest
       CPPUNIT_TEST(testMatrixTranspose);
       CPPUNIT_TEST(testMatrixAddSub);
       CPPUNIT_TEST(testMatrixMult);
+      CPPUNIT_TEST(testMatrixMultKernels);
       CPPUNIT_TEST(testMatrixScalarMult);
+      CPPUNIT_TEST(testMatrixExpression);
+      CPPUNIT_TEST(testMatrixUnrolledKernels);
       CPPUNIT_TEST(testMatInvert);
+      CPPUNIT_TEST(testMatInvertCofactor);
 
       CPPUNIT_TEST_SUITE_END();
 
@@ -33,8 +37,12 @@ namespace gmtlTest
       void testMatrixTranspose();
       void testMatrixAddSub();
       void testMatrixMult();
+      void testMatrixMultKernels();
       void testMatrixScalarMult();
+      void testMatrixExpression();
+      void testMatrixUnrolledKernels();
       void testMatInvert();
+      void testMatInvertCofactor();
    };
 
    /**
@@ -49,6 +57,11 @@ namespace gmtlTest
       CPPUNIT_TEST(testMatrixTimeTranspose44f);
       CPPUNIT_TEST(testMatrixTimeTranspose33d);
       CPPUNIT_TEST(testMatrixTimeMult44_mult);
+      CPPUNIT_TEST(testMatrixTimeMult44f_scalarMult);
+      CPPUNIT_TEST(testMatrixTimeMult44d_mult);
+      CPPUNIT_TEST(testMatrixTimeMult44d_scalarMult);
+      CPPUNIT_TEST(testMatrixTimeMult44f_affine);
+      CPPUNIT_TEST(testMatrixTimeMult44d_affine);
       CPPUNIT_TEST(testMatrixTimeMult44_operatorStar);
       CPPUNIT_TEST(testMatrixTimeMult44f_operatorStarStar);
       CPPUNIT_TEST(testMatrixTimeMult44d_operatorStarStar);
@@ -56,6 +69,12 @@ namespace gmtlTest
       CPPUNIT_TEST(testMatrixTimeMult33d_operatorStarStar);
       CPPUNIT_TEST(testMatrixTimeAdd44);
       CPPUNIT_TEST(testMatrixTimeSub44);
+      CPPUNIT_TEST(testMatrixTimeExpr44f);
+      CPPUNIT_TEST(testMatrixTimeUnrolled44f);
+      CPPUNIT_TEST(testMatrixTimeInvert44f);
+      CPPUNIT_TEST(testMatrixTimeInvert44d);
+      CPPUNIT_TEST(testMatrixTimeInvert33f);
+      CPPUNIT_TEST(testMatrixTimeInvert33d);
 
       CPPUNIT_TEST_SUITE_END();
 
@@ -65,6 +84,11 @@ namespace gmtlTest
       void testMatrixTimeTranspose44f();
       void testMatrixTimeTranspose33d();
       void testMatrixTimeMult44_mult();
+      void testMatrixTimeMult44f_scalarMult();
+      void testMatrixTimeMult44d_mult();
+      void testMatrixTimeMult44d_scalarMult();
+      void testMatrixTimeMult44f_affine();
+      void testMatrixTimeMult44d_affine();
       void testMatrixTimeMult44_operatorStar();
       void testMatrixTimeMult44f_operatorStarStar();
       void testMatrixTimeMult44d_operatorStarStar();
@@ -72,6 +96,12 @@ namespace gmtlTest
       void testMatrixTimeMult33d_operatorStarStar();
       void testMatrixTimeAdd44();
       void testMatrixTimeSub44();
+      void testMatrixTimeExpr44f();
+      void testMatrixTimeUnrolled44f();
+      void testMatrixTimeInvert44f();
+      void testMatrixTimeInvert44d();
+      void testMatrixTimeInvert33f();
+      void testMatrixTimeInvert33d();
    };
 }
 
@@ -224,19 +224,20 @@ namespace gmtlTest
             }
 
             // add(res, mat, mat), sub(res, mat, mat)
+            // the result no longer has its operands' form, so it is FULL
             {
                gmtl::Matrix44f mat1, mat2, result;
                mat1.mState = test_states[x];
                mat2.mState = test_states[y];
                gmtl::add( result, mat1, mat2 );
-               CPPUNIT_ASSERT( result.mState == gmtl::combineMatrixStates( test_states[x], test_states[y] ) && "postMult(res, mat, mat) does not combine matrix states properly" );
+               CPPUNIT_ASSERT( result.mState == gmtl::Matrix44f::FULL && "add(res, mat, mat) does not set matrix state properly" );
                gmtl::add( result, mat2, mat1 );
-               CPPUNIT_ASSERT( result.mState == gmtl::combineMatrixStates( test_states[x], test_states[y] ) && "postMult(res, mat, mat) does not combine matrix states properly" );
+               CPPUNIT_ASSERT( result.mState == gmtl::Matrix44f::FULL && "add(res, mat, mat) does not set matrix state properly" );
 
                gmtl::sub( result, mat1, mat2 );
-               CPPUNIT_ASSERT( result.mState == gmtl::combineMatrixStates( test_states[x], test_states[y] ) && "sub(res, mat, mat) does not combine matrix states properly" );
+               CPPUNIT_ASSERT( result.mState == gmtl::Matrix44f::FULL && "sub(res, mat, mat) does not set matrix state properly" );
                gmtl::sub( result, mat2, mat1 );
-               CPPUNIT_ASSERT( result.mState == gmtl::combineMatrixStates( test_states[x], test_states[y] ) && "sub(res, mat, mat) does not combine matrix states properly" );
+               CPPUNIT_ASSERT( result.mState == gmtl::Matrix44f::FULL && "sub(res, mat, mat) does not set matrix state properly" );
             }
 
             // mult(res, mat, scalar)
@@ -244,7 +245,7 @@ namespace gmtlTest
                gmtl::Matrix44f mat1, result;
                mat1.mState = test_states[x];
                gmtl::mult( result, mat1, 45.0f );
-               CPPUNIT_ASSERT( result.mState == mat1.mState && "mult(res, mat, scalar) does not propogate matrix states properly" );
+               CPPUNIT_ASSERT( result.mState == gmtl::Matrix44f::FULL && "mult(res, mat, scalar) does not set matrix state properly" );
             }
 
             // mult(res, scalar)
@@ -252,7 +253,7 @@ namespace gmtlTest
                gmtl::Matrix44f result;
                result.mState = test_states[x];
                gmtl::mult( result, 45.0f );
-               CPPUNIT_ASSERT( result.mState == test_states[x] && "mult(res, scalar) does not set matrix state properly" );
+               CPPUNIT_ASSERT( result.mState == gmtl::Matrix44f::FULL && "mult(res, scalar) does not set matrix state properly" );
             }
 
             // operator*=(mat, mat)
@@ -790,4 +791,259 @@ namespace gmtlTest
          }
       }
    }
+
+   // Builds one matrix per tracked state, multiplies every pair with the
+   // state dispatched mult() and checks it against the generic product.
+   template <typename T>
+   struct matrixMultByState
+   {
+      static void go()
+      {
+         typedef gmtl::Matrix<T, 4, 4> MatType;
+         const int num_mats = 6;
+         MatType mats[num_mats];
+
+         // mats[0] is identity
+         mats[1] = gmtl::makeTrans<MatType>( gmtl::Vec<T, 3>( 1, -2, 3 ) );
+         mats[2] = gmtl::makeRot<MatType>( gmtl::AxisAngle<T>( (T)0.7, 0, 1, 0 ) );
+         mats[3] = gmtl::makeRot<MatType>( gmtl::EulerAngle<T, gmtl::XYZ>( (T)0.3, (T)-0.2, (T)1.1 ) );
+         gmtl::setTrans( mats[3], gmtl::Vec<T, 3>( 4, 5, -6 ) );
+         mats[4] = gmtl::makeScale<MatType>( gmtl::Vec<T, 3>( 2, 3, (T)0.5 ) );
+         gmtl::setTrans( mats[4], gmtl::Vec<T, 3>( -1, 0, 2 ) );
+         mats[5].set( 1, 2, 3, 4,
+                      5, 6, 7, 8,
+                      9, 1, 2, 3,
+                      (T)0.1, (T)0.2, (T)0.3, 1 );
+
+         CPPUNIT_ASSERT( mats[0].mState == MatType::IDENTITY );
+         CPPUNIT_ASSERT( mats[1].mState == MatType::TRANS );
+         CPPUNIT_ASSERT( mats[2].mState == MatType::ORTHOGONAL );
+         CPPUNIT_ASSERT( mats[3].mState == MatType::AFFINE );
+         CPPUNIT_ASSERT( mats[4].mState == (MatType::AFFINE | MatType::NON_UNISCALE) );
+         CPPUNIT_ASSERT( mats[5].mState == MatType::FULL );
+
+         const T eps = (T)0.0001;
+         for (int x = 0; x < num_mats; ++x)
+         for (int y = 0; y < num_mats; ++y)
+         {
+            MatType expected, result;
+            gmtl::mult<T, 4, 4, 4>( expected, mats[x], mats[y] );
+            gmtl::mult( result, mats[x], mats[y] );
+            CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+            CPPUNIT_ASSERT( expected.mState == result.mState );
+
+            // aliased forms
+            result = mats[x];
+            gmtl::postMult( result, mats[y] );
+            CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+            result = mats[y];
+            gmtl::preMult( result, mats[x] );
+            CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+         }
+
+         // the specific kernels directly
+         {
+            MatType expected, result;
+            gmtl::mult<T, 4, 4, 4>( expected, mats[1], mats[1] );
+            gmtl::multTrans( result, mats[1], mats[1] );
+            CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+            gmtl::mult<T, 4, 4, 4>( expected, mats[3], mats[4] );
+            gmtl::multAffine( result, mats[3], mats[4] );
+            CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+            gmtl::mult<T, 4, 4, 4>( expected, mats[5], mats[3] );
+            gmtl::multFull( result, mats[5], mats[3] );
+            CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+
+            // the generic kernel skips lhs's bottom row, the SIMD kernels
+            // compute it; both have to agree on affine operands
+            MatType scalar_result, hscale( mats[4] );
+            hscale[3][3] = 2;
+            gmtl::multAffine<T>( scalar_result, hscale, mats[3] );
+            gmtl::multAffine( result, hscale, mats[3] );
+            gmtl::mult<T, 4, 4, 4>( expected, hscale, mats[3] );
+            CPPUNIT_ASSERT( gmtl::isEqual( expected, scalar_result, eps ) );
+            CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+         }
+
+         // ops whose result leaves the tracked form must not let mult()
+         // take a fast path afterwards
+         {
+            const MatType& trans = mats[1];
+            MatType expected, result, tmp;
+            gmtl::add( tmp, trans, trans );
+            gmtl::mult<T, 4, 4, 4>( expected, tmp, trans );
+            gmtl::mult( result, tmp, trans );
+            CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+            CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Vec<T, 3>( 4, -8, 12 ), gmtl::makeTrans<gmtl::Vec<T, 3> >( result ), eps ) );
+
+            gmtl::sub( tmp, mats[3], trans );
+            gmtl::mult<T, 4, 4, 4>( expected, tmp, mats[4] );
+            gmtl::mult( result, tmp, mats[4] );
+            CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+
+            gmtl::mult( tmp, trans, (T)2 );
+            gmtl::mult<T, 4, 4, 4>( expected, tmp, trans );
+            gmtl::mult( result, tmp, trans );
+            CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+            CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Vec<T, 3>( 4, -8, 12 ), gmtl::makeTrans<gmtl::Vec<T, 3> >( result ), eps ) );
+
+            tmp = trans;
+            tmp *= (T)2;
+            gmtl::mult( result, tmp, trans );
+            CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+
+            tmp = trans;
+            gmtl::transpose( tmp );
+            gmtl::mult<T, 4, 4, 4>( expected, tmp, trans );
+            gmtl::mult( result, tmp, trans );
+            CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+            gmtl::transpose( tmp, mats[3] );
+            gmtl::mult<T, 4, 4, 4>( expected, mats[4], tmp );
+            gmtl::mult( result, mats[4], tmp );
+            CPPUNIT_ASSERT( gmtl::isEqual( expected, result, eps ) );
+         }
+      }
+   };
+
+   void MatrixStateTrackingTest::testMatrixMultByState()
+   {
+      CPPUNIT_ASSERT( gmtl::isAffineState( gmtl::Matrix44f::AFFINE ) );
+      CPPUNIT_ASSERT( gmtl::isAffineState( gmtl::Matrix44f::AFFINE | gmtl::Matrix44f::NON_UNISCALE ) );
+      CPPUNIT_ASSERT( ! gmtl::isAffineState( gmtl::Matrix44f::FULL ) );
+      CPPUNIT_ASSERT( ! gmtl::isAffineState( gmtl::Matrix44f::AFFINE | gmtl::Matrix44f::XFORM_ERROR ) );
+
+      matrixMultByState<float>::go();
+      matrixMultByState<double>::go();
+   }
+
+   // Builds matrices with the generators, throws their state away with
+   // set() and checks that classifyState() gets it back.
+   template <typename T>
+   struct matrixClassifyState
+   {
+      static void go()
+      {
+         typedef gmtl::Matrix<T, 4, 4> MatType;
+         const int num_mats = 7;
+         MatType mats[num_mats];
+
+         // mats[0] is identity
+         mats[1] = gmtl::makeTrans<MatType>( gmtl::Vec<T, 3>( 1, -2, 3 ) );
+         mats[2] = gmtl::makeRot<MatType>( gmtl::AxisAngle<T>( (T)0.7, 0, 1, 0 ) );
+         mats[3] = gmtl::makeRot<MatType>( gmtl::EulerAngle<T, gmtl::XYZ>( (T)0.3, (T)-0.2, (T)1.1 ) );
+         gmtl::setTrans( mats[3], gmtl::Vec<T, 3>( 4, 5, -6 ) );
+         mats[4] = gmtl::makeScale<MatType>( gmtl::Vec<T, 3>( 2, 3, (T)0.5 ) );
+         gmtl::setTrans( mats[4], gmtl::Vec<T, 3>( -1, 0, 2 ) );
+         mats[5] = gmtl::makeRot<MatType>( gmtl::AxisAngle<T>( (T)1.3, (T)0.6, (T)0.8, 0 ) );
+         mats[5] = mats[5] * gmtl::makeScale<MatType>( gmtl::Vec<T, 3>( 2, 4, 1 ) );
+         mats[6].set( 1, 2, 3, 4,
+                      5, 6, 7, 8,
+                      9, 1, 2, 3,
+                      (T)0.1, (T)0.2, (T)0.3, 1 );
+
+         const int expected[num_mats] = {
+            MatType::IDENTITY,
+            MatType::TRANS,
+            MatType::ORTHOGONAL,
+            MatType::AFFINE,
+            MatType::AFFINE | MatType::NON_UNISCALE,
+            MatType::AFFINE | MatType::NON_UNISCALE,
+            MatType::FULL
+         };
+
+         for (int x = 0; x < num_mats; ++x)
+         {
+            CPPUNIT_ASSERT( gmtl::classifyState( mats[x] ) == expected[x] );
+
+            MatType imported;
+            imported.set( mats[x].getData() );
+            gmtl::detectState( imported );
+            CPPUNIT_ASSERT( imported.mState == expected[x] );
+
+            // the state specific inverse has to match the general one
+            MatType inv, full_inv;
+            gmtl::invert( inv, imported );
+            gmtl::invertFull_orig( full_inv, mats[x] );
+            CPPUNIT_ASSERT( gmtl::isEqual( full_inv, inv, (T)0.0001 ) );
+         }
+
+         // small noise is tolerated, but not beyond eps
+         MatType noisy( mats[2] );
+         noisy[0][1] += (T)1e-6;
+         CPPUNIT_ASSERT( gmtl::classifyState( noisy ) == MatType::ORTHOGONAL );
+         CPPUNIT_ASSERT( gmtl::classifyState( noisy, (T)1e-8 ) == MatType::FULL );
+
+         // ... but IDENTITY and TRANS have to be exact, since their fast
+         // paths drop the elements that are off by the noise
+         MatType near_ident[5];
+         near_ident[0][0][1] = (T)1e-6;
+         near_ident[1][1][3] = (T)1e-7;
+         near_ident[2][3][3] = (T)1 + (T)1e-6;
+         near_ident[3] = mats[1];
+         near_ident[3][2][0] = (T)1e-6;
+         near_ident[4][3][0] = (T)1e-7;
+         const int near_expected[5] = {
+            MatType::ORTHOGONAL,
+            MatType::TRANS,
+            MatType::AFFINE,
+            MatType::AFFINE,
+            MatType::FULL
+         };
+         for (int x = 0; x < 5; ++x)
+         {
+            MatType imported;
+            imported.set( near_ident[x].getData() );
+            gmtl::detectState( imported );
+            CPPUNIT_ASSERT( imported.mState == near_expected[x] );
+
+            MatType inv, full_inv;
+            gmtl::invert( inv, imported );
+            gmtl::invertFull_orig( full_inv, imported );
+            CPPUNIT_ASSERT( gmtl::isEqual( full_inv, inv, (T)1e-5 ) );
+            CPPUNIT_ASSERT( inv != MatType() );
+
+            MatType prod, full_prod;
+            gmtl::mult( prod, imported, mats[3] );
+            gmtl::multFull( full_prod, imported, mats[3] );
+            CPPUNIT_ASSERT( gmtl::isEqual( full_prod, prod, (T)1e-5 ) );
+         }
+         MatType trans_inv;
+         gmtl::invert( trans_inv, gmtl::detectState( near_ident[3] ) );
+         CPPUNIT_ASSERT( trans_inv[0][2] != 0 );
+
+         // shear, projection and singular matrices are all FULL
+         MatType shear;
+         shear[0][1] = (T)0.5;
+         CPPUNIT_ASSERT( gmtl::classifyState( shear ) == MatType::FULL );
+         MatType proj;
+         proj[3][2] = -1;
+         CPPUNIT_ASSERT( gmtl::classifyState( proj ) == MatType::FULL );
+         MatType singular;
+         singular[1][1] = 0;
+         CPPUNIT_ASSERT( gmtl::classifyState( singular ) == MatType::FULL );
+
+         // homogeneous scale
+         MatType hscale;
+         hscale[3][3] = 2;
+         CPPUNIT_ASSERT( gmtl::classifyState( hscale ) == MatType::AFFINE );
+
+         // other sizes
+         gmtl::Matrix<T, 3, 4> m34;
+         CPPUNIT_ASSERT( gmtl::classifyState( m34 ) == MatType::IDENTITY );
+         m34[1][3] = 2;
+         CPPUNIT_ASSERT( gmtl::classifyState( m34 ) == MatType::TRANS );
+         gmtl::Matrix<T, 3, 3> m33 = gmtl::makeRot<gmtl::Matrix<T, 3, 3> >( gmtl::AxisAngle<T>( (T)0.4, 0, 0, 1 ) );
+         CPPUNIT_ASSERT( gmtl::classifyState( m33 ) == MatType::ORTHOGONAL );
+         gmtl::Matrix<T, 2, 2> m22;
+         CPPUNIT_ASSERT( gmtl::classifyState( m22 ) == MatType::IDENTITY );
+         m22[0][1] = 1;
+         CPPUNIT_ASSERT( gmtl::classifyState( m22 ) == MatType::FULL );
+      }
+   };
+
+   void MatrixStateTrackingTest::testMatrixClassifyState()
+   {
+      matrixClassifyState<float>::go();
+      matrixClassifyState<double>::go();
+   }
 }
@@ -15,11 +15,15 @@ namespace gmtlTest
       CPPUNIT_TEST_SUITE( MatrixStateTrackingTest );
 
       CPPUNIT_TEST( testMatrixStateTracking );
+      CPPUNIT_TEST( testMatrixMultByState );
+      CPPUNIT_TEST( testMatrixClassifyState );
 
       CPPUNIT_TEST_SUITE_END();
 
    public:
       void testMatrixStateTracking();
+      void testMatrixMultByState();
+      void testMatrixClassifyState();
    };
 }
 
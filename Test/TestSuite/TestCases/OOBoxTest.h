@@ -32,48 +32,48 @@ public:
 
    void testBoxCreation()
    {
-      gmtl::OOBox box1;
-      gmtl::OOBox box2;
+      gmtl::OOBoxf box1;
+      gmtl::OOBoxf box2;
 
       box1.center().set(0.0, 1.0f, -2.0f);
-      box1.axis(0) = gmtl::XUnitVec3;
-      box1.axis(1) = gmtl::YUnitVec3;
-      box1.axis(2) = gmtl::ZUnitVec3;
+      box1.axis(0) = gmtl::Vec3f(1.0f, 0.0f, 0.0f);
+      box1.axis(1) = gmtl::Vec3f(0.0f, 1.0f, 0.0f);
+      box1.axis(2) = gmtl::Vec3f(0.0f, 0.0f, 1.0f);
 
       box2 = box1;
 
-      CPPUNIT_ASSERT(box2.center() == gmtl::Point3(0.0, 1.0f, -2.0f));
+      CPPUNIT_ASSERT(box2.center() == gmtl::Point3f(0.0, 1.0f, -2.0f));
       CPPUNIT_ASSERT(box2 == box1);
       CPPUNIT_ASSERT(box1 == box2);
    }
 
    void testGetBoxVerts()
    {
-      gmtl::OOBox box1;
+      gmtl::OOBoxf box1;
 
       // Create box centered on origin
       // Aligned with major axes
       // with half lens 1,2,3
       box1.center().set(0.0, 0.0f, 0.0f);
-      box1.axis(0) = gmtl::XUnitVec3;
-      box1.axis(1) = gmtl::YUnitVec3;
-      box1.axis(2) = gmtl::ZUnitVec3;
+      box1.axis(0) = gmtl::Vec3f(1.0f, 0.0f, 0.0f);
+      box1.axis(1) = gmtl::Vec3f(0.0f, 1.0f, 0.0f);
+      box1.axis(2) = gmtl::Vec3f(0.0f, 0.0f, 1.0f);
       box1.halfLen(0) = 1.0f;
       box1.halfLen(1) = 2.0f;
       box1.halfLen(2) = 3.0f;
 
-      gmtl::Point3 verts[8];
+      gmtl::Point3f verts[8];
       box1.getVerts(verts);
 
-      CPPUNIT_ASSERT(verts[0] == gmtl::Point3(-1.0f,-2.0f,-3.0f));   // 000
-      CPPUNIT_ASSERT(verts[1] == gmtl::Point3(1.0f,-2.0f,-3.0f));   // 100
-      CPPUNIT_ASSERT(verts[2] == gmtl::Point3(1.0f,2.0f,-3.0f));   // 110
-      CPPUNIT_ASSERT(verts[3] == gmtl::Point3(-1.0f,2.0f,-3.0f));   // 010
+      CPPUNIT_ASSERT(verts[0] == gmtl::Point3f(-1.0f,-2.0f,-3.0f));   // 000
+      CPPUNIT_ASSERT(verts[1] == gmtl::Point3f(1.0f,-2.0f,-3.0f));   // 100
+      CPPUNIT_ASSERT(verts[2] == gmtl::Point3f(1.0f,2.0f,-3.0f));   // 110
+      CPPUNIT_ASSERT(verts[3] == gmtl::Point3f(-1.0f,2.0f,-3.0f));   // 010
 
-      CPPUNIT_ASSERT(verts[4] == gmtl::Point3(-1.0f,-2.0f,3.0f));   // 001
-      CPPUNIT_ASSERT(verts[5] == gmtl::Point3(1.0f,-2.0f,3.0f));   // 101
-      CPPUNIT_ASSERT(verts[6] == gmtl::Point3(1.0f,2.0f,3.0f));   // 111
-      CPPUNIT_ASSERT(verts[7] == gmtl::Point3(-1.0f,2.0f,3.0f));   // 011
+      CPPUNIT_ASSERT(verts[4] == gmtl::Point3f(-1.0f,-2.0f,3.0f));   // 001
+      CPPUNIT_ASSERT(verts[5] == gmtl::Point3f(1.0f,-2.0f,3.0f));   // 101
+      CPPUNIT_ASSERT(verts[6] == gmtl::Point3f(1.0f,2.0f,3.0f));   // 111
+      CPPUNIT_ASSERT(verts[7] == gmtl::Point3f(-1.0f,2.0f,3.0f));   // 011
    }
 
 
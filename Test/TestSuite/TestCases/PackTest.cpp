@@ -0,0 +1,340 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#include "PackTest.h"
+#include "../Suites.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/MetricRegistry.h>
+
+#include <vector>
+#include <cstring>
+#include <gmtl/QuatPack.h>
+#include <gmtl/VecPack.h>
+#include <gmtl/QuatOps.h>
+#include <gmtl/VecOps.h>
+
+namespace gmtlTest
+{
+   CPPUNIT_TEST_SUITE_REGISTRATION(PackTest);
+   CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(PackMetricTest, Suites::metric());
+
+   /** Fills quats with count unit quaternions: a spread of rotations, with
+    *  the special cases mixed in.
+    */
+   static void fillQuats( std::vector<gmtl::Quatf>& quats, const std::size_t count )
+   {
+      const gmtl::Quatf special[] =
+      {
+         gmtl::Quatf( 0.0f, 0.0f, 0.0f, 1.0f ),
+         gmtl::Quatf( 0.0f, 0.0f, 0.0f, -1.0f ),
+         gmtl::Quatf( 1.0f, 0.0f, 0.0f, 0.0f ),
+         gmtl::Quatf( 0.0f, -1.0f, 0.0f, 0.0f ),
+         gmtl::Quatf( 0.5f, 0.5f, 0.5f, 0.5f ),
+         gmtl::Quatf( -0.5f, 0.5f, -0.5f, 0.5f ),
+         gmtl::Quatf( 0.5f, -0.5f, 0.5f, -0.5f ),
+         gmtl::Quatf( 0.70710678f, -0.70710678f, 0.0f, 0.0f )
+      };
+      const std::size_t num_special = sizeof(special) / sizeof(special[0]);
+      quats.resize( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         if (i % 3 == 0)
+         {
+            quats[i] = special[(i / 3) % num_special];
+         }
+         else
+         {
+            const float f = float( i );
+            quats[i].set( gmtl::Math::sin( f * 1.3f ), gmtl::Math::cos( f * 0.7f ),
+                          gmtl::Math::sin( f * 2.9f + 1.0f ), gmtl::Math::cos( f * 0.31f + 2.0f ) );
+            gmtl::normalize( quats[i] );
+         }
+      }
+   }
+
+   /** Fills normals with count unit vectors, including the axes and vectors
+    *  in the planes of the octahedron folds.
+    */
+   static void fillNormals( std::vector<gmtl::Vec3f>& normals, const std::size_t count )
+   {
+      const gmtl::Vec3f special[] =
+      {
+         gmtl::Vec3f( 1.0f, 0.0f, 0.0f ), gmtl::Vec3f( -1.0f, 0.0f, 0.0f ),
+         gmtl::Vec3f( 0.0f, 1.0f, 0.0f ), gmtl::Vec3f( 0.0f, -1.0f, 0.0f ),
+         gmtl::Vec3f( 0.0f, 0.0f, 1.0f ), gmtl::Vec3f( 0.0f, 0.0f, -1.0f ),
+         gmtl::Vec3f( 0.6f, -0.8f, 0.0f ), gmtl::Vec3f( -0.6f, 0.0f, -0.8f )
+      };
+      const std::size_t num_special = sizeof(special) / sizeof(special[0]);
+      normals.resize( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         if (i % 3 == 0)
+         {
+            normals[i] = special[(i / 3) % num_special];
+         }
+         else
+         {
+            const float f = float( i );
+            normals[i].set( gmtl::Math::sin( f * 1.3f ), gmtl::Math::cos( f * 0.7f ),
+                            gmtl::Math::sin( f * 2.9f + 1.0f ) );
+            gmtl::normalize( normals[i] );
+         }
+      }
+   }
+
+   /** The angle between the rotations q1 and q2, in degrees; accurate for
+    *  small angles, unlike acos( dot ).
+    */
+   static double rotAngle( const gmtl::Quatf& q1, const gmtl::Quatf& q2 )
+   {
+      const double l1 = gmtl::length( gmtl::Quatd( q1[0], q1[1], q1[2], q1[3] ) );
+      const double l2 = gmtl::length( gmtl::Quatd( q2[0], q2[1], q2[2], q2[3] ) );
+      const double sign = (gmtl::dot( q1, q2 ) < 0.0f) ? -1.0 : 1.0;
+      double dist2 = 0.0;
+      for (int i = 0; i < 4; ++i)
+      {
+         const double d = double( q1[i] ) / l1 - sign * double( q2[i] ) / l2;
+         dist2 += d * d;
+      }
+      return gmtl::Math::rad2Deg( 4.0 * gmtl::Math::aSin( gmtl::Math::sqrt( dist2 ) / 2.0 ) );
+   }
+
+   /** The angle between v1 and v2, in degrees. */
+   static double vecAngle( const gmtl::Vec3f& v1, const gmtl::Vec3f& v2 )
+   {
+      const gmtl::Vec3d d1( v1[0], v1[1], v1[2] ), d2( v2[0], v2[1], v2[2] );
+      const gmtl::Vec3d diff( d1 / gmtl::length( d1 ) - d2 / gmtl::length( d2 ) );
+      return gmtl::Math::rad2Deg( 2.0 * gmtl::Math::aSin( gmtl::length( diff ) / 2.0 ) );
+   }
+
+   template<class PACKED_TYPE>
+   static double maxQuatError( const std::vector<gmtl::Quatf>& quats, const float lengthTol )
+   {
+      double max_error = 0.0;
+      for (std::size_t i = 0; i < quats.size(); ++i)
+      {
+         PACKED_TYPE packed;
+         gmtl::Quatf unpacked;
+         gmtl::pack( packed, quats[i] );
+         gmtl::unpack( unpacked, packed );
+         max_error = gmtl::Math::Max( max_error, rotAngle( quats[i], unpacked ) );
+         CPPUNIT_ASSERT( gmtl::Math::isEqual( 1.0f, gmtl::length( unpacked ), lengthTol ) );
+      }
+      return max_error;
+   }
+
+   void PackTest::testQuatPack()
+   {
+      CPPUNIT_ASSERT( sizeof(gmtl::PackedQuat32) == 4 );
+      CPPUNIT_ASSERT( sizeof(gmtl::PackedQuat48) == 6 );
+      CPPUNIT_ASSERT( sizeof(gmtl::PackedQuat64) == 8 );
+
+      // the documented maximum errors
+      std::vector<gmtl::Quatf> quats;
+      fillQuats( quats, 20000 );
+      CPPUNIT_ASSERT( maxQuatError<gmtl::PackedQuat32>( quats, 1e-5f ) < 0.28 );
+      CPPUNIT_ASSERT( maxQuatError<gmtl::PackedQuat48>( quats, 1e-5f ) < 0.0086 );
+      CPPUNIT_ASSERT( maxQuatError<gmtl::PackedQuat64>( quats, 4e-5f ) < 0.0035 );
+
+      // exact for the axes, and the largest component comes back positive
+      gmtl::PackedQuat32 p32;
+      gmtl::PackedQuat48 p48;
+      gmtl::PackedQuat64 p64;
+      gmtl::Quatf res;
+      gmtl::unpack( res, gmtl::pack( p32, gmtl::Quatf( 0.0f, 0.0f, 0.0f, -1.0f ) ) );
+      CPPUNIT_ASSERT( (p32.mData >> 30) == 3 );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Quatf( 0.0f, 0.0f, 0.0f, 1.0f ), res, 0.002f ) );
+      gmtl::unpack( res, gmtl::pack( p48, gmtl::Quatf( 0.0f, -1.0f, 0.0f, 0.0f ) ) );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Quatf( 0.0f, 1.0f, 0.0f, 0.0f ), res, 0.0001f ) );
+      gmtl::unpack( res, gmtl::pack( p64, gmtl::Quatf( 0.0f, -1.0f, 0.0f, 0.0f ) ) );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Quatf( 0.0f, -1.0f, 0.0f, 0.0f ), res, 0.0f ) );
+
+      // the first of equal components is the largest
+      gmtl::pack( p32, gmtl::Quatf( -0.5f, 0.5f, 0.5f, 0.5f ) );
+      CPPUNIT_ASSERT( (p32.mData >> 30) == 0 );
+      gmtl::unpack( res, p32 );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Quatf( 0.5f, -0.5f, -0.5f, -0.5f ), res, 0.002f ) );
+
+      // the layout of the 48 bit version
+      gmtl::pack( p48, gmtl::Quatf( 0.0f, 0.0f, 1.0f, 0.0f ) );
+      CPPUNIT_ASSERT( (p48.mData[0] >> 15) == 0 && (p48.mData[1] >> 15) == 1 );
+
+      // double
+      gmtl::Quatd resd;
+      gmtl::unpack( resd, gmtl::pack( p48, gmtl::Quatd( 0.5, 0.5, -0.5, 0.5 ) ) );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Quatd( 0.5, 0.5, -0.5, 0.5 ), resd, 0.0001 ) );
+   }
+
+   template<class PACKED_TYPE>
+   static void testQuatBatch( const std::size_t count )
+   {
+      std::vector<gmtl::Quatf> quats;
+      fillQuats( quats, count );
+      std::vector<PACKED_TYPE> packed( count + 1 ), expected( count + 1 );
+      std::vector<gmtl::Quatf> unpacked( count + 1, gmtl::Quatf( 9.0f, 9.0f, 9.0f, 9.0f ) );
+      const gmtl::Quatf* src = count ? &quats[0] : NULL;
+
+      gmtl::pack( &packed[0], src, count );
+      gmtl::unpack( &unpacked[0], &packed[0], count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         gmtl::pack( expected[i], quats[i] );
+         CPPUNIT_ASSERT( std::memcmp( &expected[i], &packed[i], sizeof(PACKED_TYPE) ) == 0 );
+         // the compiler may contract the scalar unpack() into FMAs
+         gmtl::Quatf q;
+         gmtl::unpack( q, expected[i] );
+         CPPUNIT_ASSERT( gmtl::isEqual( q, unpacked[i], 1e-6f ) );
+      }
+      // nothing written past count
+      CPPUNIT_ASSERT( std::memcmp( &expected[count], &packed[count], sizeof(PACKED_TYPE) ) == 0 );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Quatf( 9.0f, 9.0f, 9.0f, 9.0f ), unpacked[count], 0.0f ) );
+   }
+
+   void PackTest::testQuatPackBatch()
+   {
+      const std::size_t counts[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 101 };
+      for (std::size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+      {
+         testQuatBatch<gmtl::PackedQuat32>( counts[c] );
+         testQuatBatch<gmtl::PackedQuat48>( counts[c] );
+         testQuatBatch<gmtl::PackedQuat64>( counts[c] );
+      }
+
+      // double
+      std::vector<gmtl::Quatd> quats( 5 ), unpacked( 5 );
+      for (std::size_t i = 0; i < quats.size(); ++i)
+      {
+         quats[i].set( double( i ), 1.0, -2.0, 0.5 );
+         gmtl::normalize( quats[i] );
+      }
+      std::vector<gmtl::PackedQuat48> packed( 5 );
+      gmtl::pack( &packed[0], &quats[0], quats.size() );
+      gmtl::unpack( &unpacked[0], &packed[0], packed.size() );
+      for (std::size_t i = 0; i < quats.size(); ++i)
+      {
+         CPPUNIT_ASSERT( gmtl::isEquiv( quats[i], unpacked[i], 0.0001 ) );
+      }
+   }
+
+   void PackTest::testNormalPack()
+   {
+      CPPUNIT_ASSERT( sizeof(gmtl::PackedNormal32) == 4 );
+
+      // the documented maximum error
+      std::vector<gmtl::Vec3f> normals;
+      fillNormals( normals, 20000 );
+      double max_error = 0.0;
+      for (std::size_t i = 0; i < normals.size(); ++i)
+      {
+         gmtl::PackedNormal32 packed;
+         gmtl::Vec3f unpacked;
+         gmtl::pack( packed, normals[i] );
+         gmtl::unpack( unpacked, packed );
+         max_error = gmtl::Math::Max( max_error, vecAngle( normals[i], unpacked ) );
+         CPPUNIT_ASSERT( gmtl::Math::isEqual( 1.0f, gmtl::length( unpacked ), 1e-5f ) );
+      }
+      CPPUNIT_ASSERT( max_error < 0.004 );
+
+      // the axes are exact, and the vector need not be unit length
+      gmtl::PackedNormal32 packed;
+      gmtl::Vec3f res;
+      gmtl::unpack( res, gmtl::pack( packed, gmtl::Vec3f( 0.0f, 0.0f, -2.0f ) ) );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Vec3f( 0.0f, 0.0f, -1.0f ), res, 0.0f ) );
+      gmtl::unpack( res, gmtl::pack( packed, gmtl::Vec3f( 0.0f, 3.0f, 0.0f ) ) );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Vec3f( 0.0f, 1.0f, 0.0f ), res, 0.0f ) );
+
+      // double
+      gmtl::Vec3d resd;
+      gmtl::unpack( resd, gmtl::pack( packed, gmtl::Vec3d( -0.48, 0.6, -0.64 ) ) );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Vec3d( -0.48, 0.6, -0.64 ), resd, 0.0001 ) );
+   }
+
+   void PackTest::testNormalPackBatch()
+   {
+      const std::size_t counts[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 101 };
+      for (std::size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+      {
+         const std::size_t count = counts[c];
+         std::vector<gmtl::Vec3f> normals;
+         fillNormals( normals, count );
+         std::vector<gmtl::PackedNormal32> packed( count + 1 );
+         std::vector<gmtl::Vec3f> unpacked( count + 1, gmtl::Vec3f( 9.0f, 9.0f, 9.0f ) );
+
+         gmtl::pack( &packed[0], count ? &normals[0] : NULL, count );
+         gmtl::unpack( &unpacked[0], &packed[0], count );
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            gmtl::PackedNormal32 expected;
+            gmtl::pack( expected, normals[i] );
+            CPPUNIT_ASSERT( expected.mData[0] == packed[i].mData[0] && expected.mData[1] == packed[i].mData[1] );
+            // the compiler may contract the scalar unpack() into FMAs
+            gmtl::Vec3f v;
+            gmtl::unpack( v, expected );
+            CPPUNIT_ASSERT( gmtl::isEqual( v, unpacked[i], 1e-6f ) );
+         }
+         CPPUNIT_ASSERT( packed[count].mData[0] == 0 && packed[count].mData[1] == 0 );
+         CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Vec3f( 9.0f, 9.0f, 9.0f ), unpacked[count], 0.0f ) );
+      }
+   }
+
+   template<class PACKED_TYPE>
+   static void timeQuatPack( const std::vector<gmtl::Quatf>& quats, const char* packName, const char* unpackName )
+   {
+      const long iters(100);
+      std::vector<PACKED_TYPE> packed( quats.size() );
+      std::vector<gmtl::Quatf> unpacked( quats.size() );
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::pack( &packed[0], &quats[0], quats.size() );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE(packName, iters * quats.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::unpack( &unpacked[0], &packed[0], packed.size() );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE(unpackName, iters * quats.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      CPPUNIT_ASSERT( unpacked[2][2] != 1234.5f );
+   }
+
+   void PackMetricTest::testTimingQuatPack()
+   {
+      std::vector<gmtl::Quatf> quats;
+      fillQuats( quats, 4096 );
+      timeQuatPack<gmtl::PackedQuat32>( quats, "PackTest/pack(PackedQuat32*)", "PackTest/unpack(PackedQuat32*)" );
+      timeQuatPack<gmtl::PackedQuat48>( quats, "PackTest/pack(PackedQuat48*)", "PackTest/unpack(PackedQuat48*)" );
+      timeQuatPack<gmtl::PackedQuat64>( quats, "PackTest/pack(PackedQuat64*)", "PackTest/unpack(PackedQuat64*)" );
+   }
+
+   void PackMetricTest::testTimingNormalPack()
+   {
+      std::vector<gmtl::Vec3f> normals, unpacked( 4096 );
+      fillNormals( normals, 4096 );
+      std::vector<gmtl::PackedNormal32> packed( normals.size() );
+      const long iters(100);
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::pack( &packed[0], &normals[0], normals.size() );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("PackTest/pack(PackedNormal32*)", iters * normals.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::unpack( &unpacked[0], &packed[0], packed.size() );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("PackTest/unpack(PackedNormal32*)", iters * normals.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      CPPUNIT_ASSERT( unpacked[2][2] != 1234.5f );
+   }
+}
@@ -0,0 +1,52 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_PACK_TEST_H_
+#define _GMTL_PACK_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace gmtlTest
+{
+   /**
+    * Functionality tests for packed quaternions and normals.
+    */
+   class PackTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(PackTest);
+
+      CPPUNIT_TEST(testQuatPack);
+      CPPUNIT_TEST(testQuatPackBatch);
+      CPPUNIT_TEST(testNormalPack);
+      CPPUNIT_TEST(testNormalPackBatch);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testQuatPack();
+      void testQuatPackBatch();
+      void testNormalPack();
+      void testNormalPackBatch();
+   };
+
+   /**
+    * Metric tests.
+    */
+   class PackMetricTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(PackMetricTest);
+
+      CPPUNIT_TEST(testTimingQuatPack);
+      CPPUNIT_TEST(testTimingNormalPack);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testTimingQuatPack();
+      void testTimingNormalPack();
+   };
+}
+
+#endif
@@ -9,6 +9,7 @@
 #include <cppunit/extensions/MetricRegistry.h>
 
 #include <gmtl/Quat.h>
+#include <gmtl/QuatOps.h>
 
 namespace gmtlTest
 {
@@ -100,6 +101,13 @@ namespace gmtlTest
       CPPUNIT_ASSERT( q11[gmtl::Welt] == 0.0f );
    }
 
+   void QuatClassTest::testQuatNoInitCreation()
+   {
+      gmtl::Quat<float> q( gmtl::NO_INIT );
+      q.set( 1.0f, 2.0f, 3.0f, 4.0f );
+      CPPUNIT_ASSERT( q == gmtl::Quatf( 1.0f, 2.0f, 3.0f, 4.0f ) );
+   }
+
    void QuatClassMetricTest::testQuatTimingDefaultConstructor()
    {
       const long iters( 400000 );
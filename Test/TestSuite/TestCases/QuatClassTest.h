@@ -15,11 +15,13 @@ namespace gmtlTest
       CPPUNIT_TEST_SUITE(QuatClassTest);
 
       CPPUNIT_TEST(testQuatClassTestCreation);
+      CPPUNIT_TEST(testQuatNoInitCreation);
 
       CPPUNIT_TEST_SUITE_END();
 
    public:
       void testQuatClassTestCreation();
+      void testQuatNoInitCreation();
    };
 
    class QuatClassMetricTest : public CppUnit::TestFixture
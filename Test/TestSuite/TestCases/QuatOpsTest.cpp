@@ -12,6 +12,8 @@
 #include <gmtl/QuatOps.h>
 #include <gmtl/Generate.h>
 #include <gmtl/Output.h>
+#include <vector>
+#include <iostream>
 
 namespace gmtlTest
 {
@@ -119,6 +121,74 @@ namespace gmtlTest
       CPPUNIT_ASSERT( result[2] != 1234.5f );
    }
 
+   void QuatOpsMetricTest::testQuatTimingBatchBlend()
+   {
+      // blend two poses of a skeleton
+      const std::size_t joints(4096);
+      std::vector<gmtl::Quatf> from( joints ), to( joints ), result( joints );
+      for (std::size_t i = 0; i < joints; ++i)
+      {
+         const float a = float(i);
+         gmtl::Vec3f axis( gmtl::Math::sin( a ), gmtl::Math::cos( a * 0.3f ), 0.5f );
+         gmtl::normalize( axis );
+         gmtl::setRot( from[i], gmtl::AxisAnglef( a * 0.01f, axis ) );
+         gmtl::setRot( to[i], gmtl::AxisAnglef( a * 0.01f + float(i % 180) * 0.0174533f, axis ) );
+      }
+      std::vector<gmtl::Quatf> exact( joints );
+      const float t = 0.3f;
+      gmtl::slerp( &exact[0], t, &from[0], &to[0], joints );
+
+      const long iters(100);
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < joints; ++i)
+         {
+            gmtl::slerp( result[i], t, from[i], to[i] );
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("QuatOpsTest/slerp() loop", iters * joints, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      CPPUNIT_ASSERT( result[2][2] != 1234.5f );
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::nlerp( &result[0], t, &from[0], &to[0], joints );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("QuatOpsTest/nlerp() batch", iters * joints, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      float nlerp_error( 0.0f );
+      for (std::size_t i = 0; i < joints; ++i)
+      {
+         for (int j = 0; j < 4; ++j)
+         {
+            nlerp_error = gmtl::Math::Max( nlerp_error, gmtl::Math::abs( result[i][j] - exact[i][j] ) );
+         }
+      }
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::fastSlerp( &result[0], t, &from[0], &to[0], joints );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("QuatOpsTest/fastSlerp() batch", iters * joints, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      float fast_error( 0.0f );
+      for (std::size_t i = 0; i < joints; ++i)
+      {
+         for (int j = 0; j < 4; ++j)
+         {
+            fast_error = gmtl::Math::Max( fast_error, gmtl::Math::abs( result[i][j] - exact[i][j] ) );
+         }
+      }
+
+      std::cout << "max error vs. slerp: nlerp " << nlerp_error
+                << ", fastSlerp " << fast_error << std::endl;
+      CPPUNIT_ASSERT( fast_error < 5e-5f );
+      CPPUNIT_ASSERT( nlerp_error < 0.1f );
+   }
+
    void QuatOpsMetricTest::testQuatTimingVectorMult()
    {
       gmtl::Quat<float> q3, q4;
@@ -617,6 +687,256 @@ namespace gmtlTest
       //        note: might have to test with two different angled quats, not sure...
    }
 
-   /** @todo, squad, meantangent, exp, log */
+   void QuatOpsTest::testQuatExpLog()
+   {
+      const float eps = 0.0001f;
+      gmtl::Quatf q;
+      gmtl::setRot( q, gmtl::AxisAnglef( 2.5f, gmtl::Vec3f( 0.6f, 0.0f, 0.8f ) ) );
+
+      // log of (v*sin(a), cos(a)) is (v*a, 0)
+      gmtl::Quatf l( q );
+      gmtl::log( l );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Quatf( 0.6f * 1.25f, 0.0f, 0.8f * 1.25f, 0.0f ), l, eps ) );
+      gmtl::exp( l );
+      CPPUNIT_ASSERT( gmtl::isEqual( q, l, eps ) );
+
+      // identity
+      gmtl::Quatf ident;
+      gmtl::log( ident );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Quatf( 0.0f, 0.0f, 0.0f, 0.0f ), ident, eps ) );
+      gmtl::exp( ident );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Quatf(), ident, eps ) );
+
+      // 180 degrees
+      gmtl::Quatf half_turn( 0.0f, 1.0f, 0.0f, 0.0f );
+      gmtl::log( half_turn );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Quatf( 0.0f, gmtl::Math::PI_OVER_2, 0.0f, 0.0f ), half_turn, eps ) );
+   }
+
+   void QuatOpsTest::testQuatSquad()
+   {
+      const float eps = 0.0001f;
+      const gmtl::Vec3f axis( 0.0f, 0.0f, 1.0f );
+      gmtl::Quatf q0, q1, q2, q3;
+      gmtl::setRot( q0, gmtl::AxisAnglef( 0.1f, axis ) );
+      gmtl::setRot( q1, gmtl::AxisAnglef( 0.5f, axis ) );
+      gmtl::setRot( q2, gmtl::AxisAnglef( 0.9f, axis ) );
+      gmtl::setRot( q3, gmtl::AxisAnglef( 1.3f, axis ) );
+
+      // keys evenly spaced about one axis, the tangents are the keys and
+      // squad is slerp
+      gmtl::Quatf a, b, res, expected;
+      gmtl::meanTangent( a, q0, q1, q2 );
+      gmtl::meanTangent( b, q1, q2, q3 );
+      CPPUNIT_ASSERT( gmtl::isEqual( q1, a, eps ) );
+      CPPUNIT_ASSERT( gmtl::isEqual( q2, b, eps ) );
+      for (int i = 0; i <= 10; ++i)
+      {
+         const float t = float(i) / 10.0f;
+         gmtl::squad( res, t, q1, q2, a, b );
+         gmtl::slerp( expected, t, q1, q2 );
+         CPPUNIT_ASSERT( gmtl::isEqual( expected, res, eps ) );
+      }
+
+      // unevenly spaced keys about different axes: squad goes through the
+      // keys and is a unit quaternion
+      gmtl::setRot( q0, gmtl::AxisAnglef( 0.3f, gmtl::Vec3f( 1.0f, 0.0f, 0.0f ) ) );
+      gmtl::setRot( q2, gmtl::AxisAnglef( 1.4f, gmtl::Vec3f( 0.0f, 1.0f, 0.0f ) ) );
+      gmtl::meanTangent( a, q0, q1, q2 );
+      gmtl::meanTangent( b, q1, q2, q3 );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( 1.0f, gmtl::length( a ), eps ) );
+      CPPUNIT_ASSERT( !gmtl::isEqual( q1, a, eps ) );
+      gmtl::squad( res, 0.0f, q1, q2, a, b );
+      CPPUNIT_ASSERT( gmtl::isEqual( q1, res, eps ) );
+      gmtl::squad( res, 1.0f, q1, q2, a, b );
+      CPPUNIT_ASSERT( gmtl::isEqual( q2, res, eps ) );
+      gmtl::squad( res, 0.4f, q1, q2, a, b );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( 1.0f, gmtl::length( res ), eps ) );
+
+      // result can be an argument
+      gmtl::squad( expected, 0.4f, q1, q2, a, b );
+      res = q1;
+      gmtl::squad( res, 0.4f, res, q2, a, b );
+      CPPUNIT_ASSERT( gmtl::isEqual( expected, res, 0.0f ) );
+      gmtl::meanTangent( expected, q0, q1, q2 );
+      res = q1;
+      gmtl::meanTangent( res, q0, res, q2 );
+      CPPUNIT_ASSERT( gmtl::isEqual( expected, res, 0.0f ) );
+   }
+
+   void QuatOpsTest::testQuatFastSlerp()
+   {
+      const float eps = 5e-5f;
+      gmtl::Quat<float> q1( 100, 2, 3, 4 ), q2( 9.01f, 8.4f, 7.1f, 6 );
+      gmtl::normalize( q1 );
+      gmtl::normalize( q2 );
+      gmtl::Quat<float> res, expected;
+
+      gmtl::fastSlerp( res, 0.0f, q1, q2 );
+      CPPUNIT_ASSERT( gmtl::isEqual( q1, res, eps ) );
+      gmtl::fastSlerp( res, 1.0f, q1, q2 );
+      CPPUNIT_ASSERT( gmtl::isEqual( q2, res, eps ) );
+
+      // within the documented error of slerp, for rotations up to 360
+      // degrees apart and both signs of the second quaternion (slerp()
+      // itself falls back to lerp() for very small angles, so allow a bit
+      // more than the 2.5e-5 of the polynomial)
+      for (int angle = 0; angle <= 360; angle += 15)
+      {
+         gmtl::Quat<double> from, to;
+         gmtl::setRot( from, gmtl::AxisAngled( 0.3, gmtl::Vec3d( 0.0, 1.0, 0.0 ) ) );
+         gmtl::setRot( to, gmtl::AxisAngled( gmtl::Math::deg2Rad( double(angle) ) + 0.3,
+                                             gmtl::Vec3d( 0.0, 1.0, 0.0 ) ) );
+         for (int i = 0; i <= 10; ++i)
+         {
+            const double t = double(i) / 10.0;
+            gmtl::Quat<double> fast, exact;
+            gmtl::fastSlerp( fast, t, from, to );
+            gmtl::slerp( exact, t, from, to );
+            CPPUNIT_ASSERT( gmtl::isEqual( exact, fast, 5e-5 ) );
+            gmtl::Quat<double> neg_to( -to );
+            gmtl::fastSlerp( fast, t, from, neg_to );
+            CPPUNIT_ASSERT( gmtl::isEqual( exact, fast, 5e-5 ) );
+         }
+      }
+
+      // from == to
+      gmtl::fastSlerp( res, 0.5f, q1, q1 );
+      CPPUNIT_ASSERT( gmtl::isEqual( q1, res, eps ) );
+
+      // result can be one of the arguments
+      gmtl::fastSlerp( expected, 0.3f, q1, q2 );
+      res = q1;
+      gmtl::fastSlerp( res, 0.3f, res, q2 );
+      CPPUNIT_ASSERT( gmtl::isEqual( expected, res, 0.0f ) );
+
+      // nlerp
+      gmtl::nlerp( res, 0.0f, q1, q2 );
+      CPPUNIT_ASSERT( gmtl::isEqual( q1, res, eps ) );
+      gmtl::nlerp( res, 0.5f, q1, q2 );
+      gmtl::slerp( expected, 0.5f, q1, q2 );
+      CPPUNIT_ASSERT( gmtl::isEqual( expected, res, 0.0001f ) );
+   }
+
+   namespace
+   {
+      /** Fills count quaternion pairs with rotations about different axes,
+       *  about half of them more than 180 degrees apart, and count t values.
+       */
+      template<typename T>
+      void makeBlendData( std::vector< gmtl::Quat<T> >& from,
+                          std::vector< gmtl::Quat<T> >& to,
+                          std::vector<T>& t, const std::size_t count )
+      {
+         from.resize( count );
+         to.resize( count );
+         t.resize( count );
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            const T a = T(i);
+            gmtl::Vec<T, 3> axis( gmtl::Math::sin( a ), gmtl::Math::cos( a * T(0.7) ), T(0.5) );
+            gmtl::normalize( axis );
+            gmtl::setRot( from[i], gmtl::AxisAngle<T>( a * T(0.37), axis ) );
+            gmtl::setRot( to[i], gmtl::AxisAngle<T>( a * T(0.37) + T(0.1) + a * T(0.61), axis ) );
+            if (i % 3 == 0)
+            {
+               to[i] = -to[i];
+            }
+            t[i] = T(i % 11) / T(10);
+         }
+      }
+
+      template<typename T>
+      void testBatchBlend()
+      {
+         typedef gmtl::Quat<T> QuatType;
+         // the batch and single versions do the same arithmetic, but the
+         // compiler may contract either one into FMAs (-ffp-contract)
+         const T eps = (sizeof( T ) == sizeof( float )) ? T( 1e-6 ) : T( 1e-14 );
+         const std::size_t counts[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 101 };
+         for (std::size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+         {
+            const std::size_t count = counts[c];
+            std::vector<QuatType> from, to, result( count + 1 );
+            std::vector<T> t;
+            makeBlendData( from, to, t, count );
+            const QuatType* f = count ? &from[0] : NULL;
+            const QuatType* g = count ? &to[0] : NULL;
+            QuatType* r = &result[0];
+            QuatType expected;
+
+            // the elements past count are not touched
+            const QuatType guard( T(9), T(9), T(9), T(9) );
+            result[count] = guard;
+
+            gmtl::nlerp( r, T(0.25), f, g, count );
+            for (std::size_t i = 0; i < count; ++i)
+            {
+               gmtl::nlerp( expected, T(0.25), from[i], to[i] );
+               CPPUNIT_ASSERT( gmtl::isEqual( expected, result[i], eps ) );
+            }
+            gmtl::nlerp( r, count ? &t[0] : NULL, f, g, count );
+            for (std::size_t i = 0; i < count; ++i)
+            {
+               gmtl::nlerp( expected, t[i], from[i], to[i] );
+               CPPUNIT_ASSERT( gmtl::isEqual( expected, result[i], eps ) );
+            }
+
+            gmtl::fastSlerp( r, T(0.25), f, g, count );
+            for (std::size_t i = 0; i < count; ++i)
+            {
+               gmtl::fastSlerp( expected, T(0.25), from[i], to[i] );
+               CPPUNIT_ASSERT( gmtl::isEqual( expected, result[i], eps ) );
+            }
+            gmtl::fastSlerp( r, count ? &t[0] : NULL, f, g, count );
+            for (std::size_t i = 0; i < count; ++i)
+            {
+               gmtl::fastSlerp( expected, t[i], from[i], to[i] );
+               CPPUNIT_ASSERT( gmtl::isEqual( expected, result[i], eps ) );
+               gmtl::slerp( expected, t[i], from[i], to[i] );
+               CPPUNIT_ASSERT( gmtl::isEqual( expected, result[i], T(5e-5) ) );
+            }
+
+            gmtl::slerp( r, T(0.25), f, g, count );
+            for (std::size_t i = 0; i < count; ++i)
+            {
+               gmtl::slerp( expected, T(0.25), from[i], to[i] );
+               CPPUNIT_ASSERT( gmtl::isEqual( expected, result[i], eps ) );
+            }
+            gmtl::slerp( r, count ? &t[0] : NULL, f, g, count );
+            for (std::size_t i = 0; i < count; ++i)
+            {
+               gmtl::slerp( expected, t[i], from[i], to[i] );
+               CPPUNIT_ASSERT( gmtl::isEqual( expected, result[i], eps ) );
+            }
+            CPPUNIT_ASSERT( gmtl::isEqual( guard, result[count], T(0) ) );
+
+            // in place
+            if (count > 0)
+            {
+               std::vector<QuatType> blended( from );
+               gmtl::fastSlerp( &blended[0], &t[0], &blended[0], g, count );
+               gmtl::fastSlerp( r, &t[0], f, g, count );
+               for (std::size_t i = 0; i < count; ++i)
+               {
+                  CPPUNIT_ASSERT( gmtl::isEqual( result[i], blended[i], eps ) );
+               }
+               blended = to;
+               gmtl::nlerp( &blended[0], T(0.75), f, &blended[0], count );
+               gmtl::nlerp( r, T(0.75), f, g, count );
+               for (std::size_t i = 0; i < count; ++i)
+               {
+                  CPPUNIT_ASSERT( gmtl::isEqual( result[i], blended[i], eps ) );
+               }
+            }
+         }
+      }
+   }
+
+   void QuatOpsTest::testQuatBatchBlend()
+   {
+      testBatchBlend<float>();
+      testBatchBlend<double>();
+   }
 
 }
@@ -31,6 +31,10 @@ namespace gmtlTest
       CPPUNIT_TEST(testQuatInvert);
       CPPUNIT_TEST(testQuatSlerp);
       CPPUNIT_TEST(testQuatLerp);
+      CPPUNIT_TEST(testQuatFastSlerp);
+      CPPUNIT_TEST(testQuatExpLog);
+      CPPUNIT_TEST(testQuatSquad);
+      CPPUNIT_TEST(testQuatBatchBlend);
 
       CPPUNIT_TEST_SUITE_END();
 
@@ -49,6 +53,10 @@ namespace gmtlTest
       void testQuatInvert();
       void testQuatSlerp();
       void testQuatLerp();
+      void testQuatFastSlerp();
+      void testQuatExpLog();
+      void testQuatSquad();
+      void testQuatBatchBlend();
    };
 
    /**
@@ -64,6 +72,7 @@ namespace gmtlTest
       CPPUNIT_TEST(testQuatTimingOperatorMult);
       CPPUNIT_TEST(testQuatTimingDiv);
       CPPUNIT_TEST(testQuatTimingLerp);
+      CPPUNIT_TEST(testQuatTimingBatchBlend);
       CPPUNIT_TEST(testQuatTimingVectorMult);
       CPPUNIT_TEST(testQuatTimingVectorAdd);
       CPPUNIT_TEST(testQuatTimingVectorSub);
@@ -83,6 +92,7 @@ namespace gmtlTest
       void testQuatTimingOperatorMult();
       void testQuatTimingDiv();
       void testQuatTimingLerp();
+      void testQuatTimingBatchBlend();
       void testQuatTimingVectorMult();
       void testQuatTimingVectorAdd();
       void testQuatTimingVectorSub();
@@ -0,0 +1,290 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#include "QuatSplineTest.h"
+#include "../Suites.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/MetricRegistry.h>
+
+#include <vector>
+#include <algorithm>
+#include <gmtl/QuatSpline.h>
+#include <gmtl/QuatOps.h>
+#include <gmtl/Generate.h>
+
+namespace gmtlTest
+{
+   CPPUNIT_TEST_SUITE_REGISTRATION(QuatSplineTest);
+   CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(QuatSplineMetricTest, Suites::metric());
+
+   /** Fills times and keys with count unevenly spaced keys that rotate
+    *  about changing axes, some of them with a flipped sign.
+    */
+   template<class T>
+   static void makeKeys( std::vector<T>& times, std::vector< gmtl::Quat<T> >& keys,
+                         const std::size_t count, const T offset )
+   {
+      times.resize( count );
+      keys.resize( count );
+      T time( 0 );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         const T f = T( i ) + offset;
+         gmtl::Vec<T, 3> axis( gmtl::Math::sin( f ), T(1), gmtl::Math::cos( T(0.3) * f ) );
+         gmtl::normalize( axis );
+         gmtl::setRot( keys[i], gmtl::AxisAngle<T>( T(0.4) * f, axis ) );
+         if (i % 4 == 3)
+         {
+            keys[i] = -keys[i];
+         }
+         times[i] = time;
+         time += T(0.5) + T(i % 3) * T(0.25);
+      }
+   }
+
+   /** The angle between two rotations. */
+   template<class T>
+   static T rotAngle( const gmtl::Quat<T>& q1, const gmtl::Quat<T>& q2 )
+   {
+      return T(2) * gmtl::Math::aCos( gmtl::Math::Min( gmtl::Math::abs( gmtl::dot( q1, q2 ) ), T(1) ) );
+   }
+
+   /** The rotation from q1 to q2 as axis * angle, in the frame of q1. */
+   template<class T>
+   static gmtl::Vec<T, 3> rotDelta( const gmtl::Quat<T>& q1, const gmtl::Quat<T>& q2 )
+   {
+      gmtl::Quat<T> delta( q1 );
+      gmtl::conj( delta );
+      delta = delta * q2;
+      gmtl::log( delta );
+      return gmtl::Vec<T, 3>( T(2) * delta[0], T(2) * delta[1], T(2) * delta[2] );
+   }
+
+   void QuatSplineTest::testKeys()
+   {
+      const float eps = 0.0001f;
+      gmtl::QuatSplineTrackf track;
+      gmtl::Quatf res( 1.0f, 2.0f, 3.0f, 4.0f );
+      CPPUNIT_ASSERT( track.empty() );
+      track.sample( res, 1.0f );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Quatf(), res, 0.0f ) );
+
+      std::vector<float> times;
+      std::vector<gmtl::Quatf> keys;
+      makeKeys( times, keys, 7, 0.5f );
+
+      // one key
+      track.setKeys( &times[0], &keys[0], 1 );
+      CPPUNIT_ASSERT( track.getNumKeys() == 1 );
+      track.sample( res, -1.0f );
+      CPPUNIT_ASSERT( gmtl::isEqual( keys[0], res, 0.0f ) );
+      track.sample( res, 5.0f );
+      CPPUNIT_ASSERT( gmtl::isEqual( keys[0], res, 0.0f ) );
+
+      // goes through the keys (up to sign), holds the ends
+      track.setKeys( &times[0], &keys[0], keys.size() );
+      CPPUNIT_ASSERT( track.getNumKeys() == keys.size() );
+      CPPUNIT_ASSERT( track.getStartTime() == times.front() );
+      CPPUNIT_ASSERT( track.getEndTime() == times.back() );
+      for (std::size_t i = 0; i < keys.size(); ++i)
+      {
+         CPPUNIT_ASSERT( track.getTime( i ) == times[i] );
+         CPPUNIT_ASSERT( gmtl::isEquiv( keys[i], track.getKey( i ), eps ) );
+         track.sample( res, times[i] );
+         CPPUNIT_ASSERT( gmtl::isEquiv( keys[i], res, eps ) );
+         if (i > 0)
+         {
+            CPPUNIT_ASSERT( gmtl::dot( track.getKey( i - 1 ), track.getKey( i ) ) >= 0.0f );
+         }
+      }
+      CPPUNIT_ASSERT( gmtl::isEqual( track.getKey( 0 ), track.getControl( 0 ), 0.0f ) );
+      track.sample( res, times.front() - 1.0f );
+      CPPUNIT_ASSERT( gmtl::isEqual( track.getKey( 0 ), res, 0.0f ) );
+      track.sample( res, times.back() + 1.0f );
+      CPPUNIT_ASSERT( gmtl::isEqual( track.getKey( keys.size() - 1 ), res, 0.0f ) );
+
+      // the control points are the ones from meanTangent()
+      gmtl::Quatf control;
+      gmtl::meanTangent( control, track.getKey( 2 ), track.getKey( 3 ), track.getKey( 4 ) );
+      CPPUNIT_ASSERT( gmtl::isEqual( control, track.getControl( 3 ), 0.0f ) );
+
+      // between keys it is squad()
+      gmtl::Quatf expected;
+      const float time = 0.3f * times[3] + 0.7f * times[4];
+      const float t = (time - times[3]) / (times[4] - times[3]);
+      gmtl::squad( expected, t, track.getKey( 3 ), track.getKey( 4 ),
+                   track.getControl( 3 ), track.getControl( 4 ) );
+      track.sample( res, time );
+      CPPUNIT_ASSERT( gmtl::isEqual( expected, res, 0.0f ) );
+   }
+
+   void QuatSplineTest::testSmooth()
+   {
+      // the curve is continuous, and so is the angular velocity at the
+      // inner keys (the track has uneven key times, so compare in units of
+      // the curve parameter of each segment)
+      std::vector<double> times;
+      std::vector<gmtl::Quatd> keys;
+      makeKeys( times, keys, 6, 0.0 );
+      gmtl::QuatSplineTrackd track( &times[0], &keys[0], keys.size() );
+
+      const double h = 1e-6;
+      for (std::size_t i = 1; i + 1 < keys.size(); ++i)
+      {
+         gmtl::Quatd before, at, after;
+         const double left = times[i] - times[i - 1];
+         const double right = times[i + 1] - times[i];
+         track.sample( before, times[i] - h * left );
+         track.sample( at, times[i] );
+         track.sample( after, times[i] + h * right );
+         const gmtl::Vec3d velocity_in = rotDelta( before, at ) / h;
+         const gmtl::Vec3d velocity_out = rotDelta( at, after ) / h;
+         CPPUNIT_ASSERT( gmtl::length( velocity_in ) > 0.01 );
+         CPPUNIT_ASSERT( gmtl::isEqual( velocity_in, velocity_out, 1e-3 * gmtl::length( velocity_in ) ) );
+      }
+
+      // nearby samples are close
+      gmtl::Quatd prev, cur;
+      track.sample( prev, times.front() );
+      for (int i = 1; i <= 1000; ++i)
+      {
+         track.sample( cur, times.back() * double(i) / 1000.0 );
+         CPPUNIT_ASSERT( rotAngle( prev, cur ) < 0.05 );
+         prev = cur;
+      }
+   }
+
+   void QuatSplineTest::testCursor()
+   {
+      std::vector<float> times;
+      std::vector<gmtl::Quatf> keys;
+      makeKeys( times, keys, 20, 0.25f );
+      gmtl::QuatSplineTrackf track( &times[0], &keys[0], keys.size() );
+
+      // forward in small and large steps, backward, jumps and out of range
+      std::vector<float> samples;
+      for (float time = -0.5f; time < track.getEndTime() + 0.5f; time += 0.07f)
+      {
+         samples.push_back( time );
+      }
+      samples.push_back( times[5] );
+      samples.push_back( times[5] );
+      samples.push_back( times[6] );
+      samples.push_back( times[4] );
+      samples.push_back( times[15] + 0.01f );
+      samples.push_back( times[2] - 0.01f );
+      samples.push_back( 100.0f );
+      samples.push_back( 101.0f );
+      samples.push_back( -100.0f );
+      samples.push_back( times[1] );
+
+      gmtl::QuatSplineTrackf::Cursor cursor;
+      gmtl::Quatf res, expected;
+      for (std::size_t i = 0; i < samples.size(); ++i)
+      {
+         track.sample( expected, samples[i] );
+         track.sample( res, samples[i], cursor );
+         CPPUNIT_ASSERT( gmtl::isEqual( expected, res, 0.0f ) );
+         CPPUNIT_ASSERT( cursor.mKey < keys.size() );
+         CPPUNIT_ASSERT( cursor.mKey == 0 || times[cursor.mKey] <= samples[i] );
+      }
+
+      // many samples at once
+      std::vector<gmtl::Quatf> results( samples.size() );
+      gmtl::QuatSplineTrackf::Cursor cursor2;
+      track.sample( &results[0], &samples[0], samples.size(), cursor2 );
+      for (std::size_t i = 0; i < samples.size(); ++i)
+      {
+         track.sample( expected, samples[i] );
+         CPPUNIT_ASSERT( gmtl::isEqual( expected, results[i], 0.0f ) );
+      }
+
+      // a cursor from a longer track
+      gmtl::QuatSplineTrackf short_track( &times[0], &keys[0], 3 );
+      cursor.mKey = 17;
+      short_track.sample( res, times[1], cursor );
+      short_track.sample( expected, times[1] );
+      CPPUNIT_ASSERT( gmtl::isEqual( expected, res, 0.0f ) );
+   }
+
+   void QuatSplineTest::testBatchSample()
+   {
+      const std::size_t num_tracks = 9;
+      std::vector<gmtl::QuatSplineTrackf> tracks( num_tracks );
+      for (std::size_t i = 0; i < num_tracks; ++i)
+      {
+         std::vector<float> times;
+         std::vector<gmtl::Quatf> keys;
+         makeKeys( times, keys, 3 + i, float( i ) );
+         tracks[i].setKeys( &times[0], &keys[0], keys.size() );
+      }
+
+      std::vector<gmtl::QuatSplineTrackf::Cursor> cursors( num_tracks );
+      std::vector<gmtl::Quatf> results( num_tracks );
+      for (float time = 0.0f; time < 10.0f; time += 0.1f)
+      {
+         gmtl::sample( &results[0], &tracks[0], &cursors[0], num_tracks, time );
+         for (std::size_t i = 0; i < num_tracks; ++i)
+         {
+            gmtl::Quatf expected;
+            tracks[i].sample( expected, time );
+            CPPUNIT_ASSERT( gmtl::isEqual( expected, results[i], 0.0f ) );
+         }
+      }
+   }
+
+   void QuatSplineMetricTest::testTimingSample()
+   {
+      // a 64 joint skeleton with 32 keys per joint, played forward
+      const std::size_t num_tracks = 64, num_keys = 32;
+      std::vector<gmtl::QuatSplineTrackf> tracks( num_tracks );
+      std::vector< std::vector<float> > times( num_tracks );
+      std::vector< std::vector<gmtl::Quatf> > keys( num_tracks );
+      for (std::size_t i = 0; i < num_tracks; ++i)
+      {
+         makeKeys( times[i], keys[i], num_keys, float( i ) );
+         tracks[i].setKeys( &times[i][0], &keys[i][0], num_keys );
+      }
+      const float end_time = tracks[0].getEndTime();
+      const long frames( 200 );
+      std::vector<gmtl::Quatf> pose( num_tracks );
+
+      // find the segment and compute the control points at every sample
+      CPPUNIT_METRIC_START_TIMING();
+      for (long frame = 0; frame < frames; ++frame)
+      {
+         const float time = end_time * float( frame ) / float( frames );
+         for (std::size_t i = 0; i < num_tracks; ++i)
+         {
+            const std::vector<float>& t = times[i];
+            const std::vector<gmtl::Quatf>& k = keys[i];
+            std::size_t key = std::upper_bound( t.begin(), t.end(), time ) - t.begin() - 1;
+            key = std::min( key, num_keys - 2 );
+            gmtl::Quatf k0( k[key == 0 ? 0 : key - 1] ), k1( k[key] ), k2( k[key + 1] ), k3( k[std::min( key + 2, num_keys - 1 )] );
+            if (gmtl::dot( k0, k1 ) < 0.0f) k0 = -k0;
+            if (gmtl::dot( k1, k2 ) < 0.0f) k2 = -k2;
+            if (gmtl::dot( k2, k3 ) < 0.0f) k3 = -k3;
+            gmtl::Quatf a, b;
+            gmtl::meanTangent( a, k0, k1, k2 );
+            gmtl::meanTangent( b, k1, k2, k3 );
+            gmtl::squad( pose[i], (time - t[key]) / (t[key + 1] - t[key]), k1, k2, a, b );
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("QuatSplineTest/squad() per sample", frames * num_tracks, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      CPPUNIT_ASSERT( pose[2][2] != 1234.5f );
+
+      std::vector<gmtl::QuatSplineTrackf::Cursor> cursors( num_tracks );
+      CPPUNIT_METRIC_START_TIMING();
+      for (long frame = 0; frame < frames; ++frame)
+      {
+         const float time = end_time * float( frame ) / float( frames );
+         gmtl::sample( &pose[0], &tracks[0], &cursors[0], num_tracks, time );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("QuatSplineTest/QuatSplineTrack::sample()", frames * num_tracks, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      CPPUNIT_ASSERT( pose[2][2] != 1234.5f );
+   }
+}
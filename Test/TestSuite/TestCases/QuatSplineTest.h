@@ -0,0 +1,50 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_QUAT_SPLINE_TEST_H_
+#define _GMTL_QUAT_SPLINE_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace gmtlTest
+{
+   /**
+    * Functionality tests for QuatSplineTrack.
+    */
+   class QuatSplineTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(QuatSplineTest);
+
+      CPPUNIT_TEST(testKeys);
+      CPPUNIT_TEST(testSmooth);
+      CPPUNIT_TEST(testCursor);
+      CPPUNIT_TEST(testBatchSample);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testKeys();
+      void testSmooth();
+      void testCursor();
+      void testBatchSample();
+   };
+
+   /**
+    * Metric tests.
+    */
+   class QuatSplineMetricTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(QuatSplineMetricTest);
+
+      CPPUNIT_TEST(testTimingSample);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testTimingSample();
+   };
+}
+
+#endif
@@ -0,0 +1,668 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#include "RayPacketTest.h"
+#include "../Suites.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/MetricRegistry.h>
+
+#include <sstream>
+#include <vector>
+#include <gmtl/RayPacket.h>
+#include <gmtl/RayPacketOps.h>
+#include <gmtl/BVH.h>
+#include <gmtl/BVHOps.h>
+#include <gmtl/RayOps.h>
+#include <gmtl/Intersection.h>
+
+namespace gmtlTest
+{
+   CPPUNIT_TEST_SUITE_REGISTRATION(RayPacketTest);
+   CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(RayPacketMetricTest, Suites::metric());
+
+   /** Fills tris with a bumpy grid of (2 * res * res) triangles facing +z
+    *  over [-1, 1]^2 and a few triangles floating above it, facing down
+    *  every other one.
+    */
+   template<class DATA_TYPE>
+   static void fillMesh( std::vector< gmtl::Tri<DATA_TYPE> >& tris, const unsigned int res )
+   {
+      typedef gmtl::Point<DATA_TYPE, 3> PointType;
+      tris.clear();
+      const DATA_TYPE step = DATA_TYPE( 2.0 ) / DATA_TYPE( res );
+      for (unsigned int j = 0; j < res; ++j)
+      {
+         for (unsigned int i = 0; i < res; ++i)
+         {
+            PointType p[4];
+            for (unsigned int k = 0; k < 4; ++k)
+            {
+               const DATA_TYPE x = DATA_TYPE( -1.0 ) + step * DATA_TYPE( i + (k & 1) );
+               const DATA_TYPE y = DATA_TYPE( -1.0 ) + step * DATA_TYPE( j + (k >> 1) );
+               p[k].set( x, y, DATA_TYPE( 0.1 ) * gmtl::Math::sin( x * DATA_TYPE( 5.0 ) ) *
+                                                   gmtl::Math::cos( y * DATA_TYPE( 3.0 ) ) );
+            }
+            tris.push_back( gmtl::Tri<DATA_TYPE>( p[0], p[1], p[3] ) );
+            tris.push_back( gmtl::Tri<DATA_TYPE>( p[0], p[3], p[2] ) );
+         }
+      }
+      for (unsigned int i = 0; i < 32; ++i)
+      {
+         const DATA_TYPE f = DATA_TYPE( i );
+         const PointType c( gmtl::Math::sin( f * DATA_TYPE( 1.3 ) ), gmtl::Math::cos( f * DATA_TYPE( 0.7 ) ),
+                            DATA_TYPE( 0.3 ) + DATA_TYPE( 0.01 ) * f );
+         const DATA_TYPE s = DATA_TYPE( 0.1 ) + DATA_TYPE( 0.004 ) * f;
+         const PointType a( c[0] - s, c[1] - s, c[2] ), b( c[0] + s, c[1] - s, c[2] ), d( c[0], c[1] + s, c[2] + s );
+         tris.push_back( (i & 1) ? gmtl::Tri<DATA_TYPE>( a, b, d ) : gmtl::Tri<DATA_TYPE>( a, d, b ) );
+      }
+   }
+
+   /** Fills rays with count incoherent rays from above the mesh, most of
+    *  them pointing down towards it, some along the axes and some up.
+    */
+   template<class DATA_TYPE>
+   static void fillRays( std::vector< gmtl::Ray<DATA_TYPE> >& rays, const std::size_t count )
+   {
+      typedef gmtl::Point<DATA_TYPE, 3> PointType;
+      typedef gmtl::Vec<DATA_TYPE, 3> VecType;
+      rays.resize( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         const DATA_TYPE f = DATA_TYPE( i );
+         const PointType origin( DATA_TYPE( 1.2 ) * gmtl::Math::sin( f * DATA_TYPE( 2.1 ) ),
+                                 DATA_TYPE( 1.2 ) * gmtl::Math::cos( f * DATA_TYPE( 0.9 ) + DATA_TYPE( 1.0 ) ),
+                                 DATA_TYPE( 1.0 ) + DATA_TYPE( 0.5 ) * gmtl::Math::sin( f * DATA_TYPE( 0.37 ) ) );
+         VecType dir( DATA_TYPE( 0.6 ) * gmtl::Math::sin( f * DATA_TYPE( 1.7 ) ),
+                      DATA_TYPE( 0.6 ) * gmtl::Math::cos( f * DATA_TYPE( 2.3 ) ),
+                      DATA_TYPE( -1.0 ) + DATA_TYPE( 0.4 ) * gmtl::Math::sin( f * DATA_TYPE( 0.53 ) ) );
+         switch (i % 8)
+         {
+         case 0:
+            dir.set( 0, 0, -1 );
+            break;
+         case 1:
+            dir.set( dir[0], 0, dir[2] );
+            break;
+         case 2:
+            dir = -dir;
+            break;
+         }
+         rays[i].setOrigin( origin );
+         rays[i].setDir( dir );
+      }
+   }
+
+   /** Fills rays with the (res * res) rays of a camera above the mesh,
+    *  ordered in tiles of 4 x 4 pixels so that packets of 4, 8 and 16
+    *  consecutive rays are coherent.  res must be a multiple of 4.
+    */
+   static void fillCameraRays( std::vector<gmtl::Rayf>& rays, const unsigned int res )
+   {
+      rays.clear();
+      const gmtl::Point3f eye( 0.1f, -0.2f, 3.0f );
+      const float step = 2.4f / float( res );
+      for (unsigned int tile_y = 0; tile_y < res; tile_y += 4)
+      {
+         for (unsigned int tile_x = 0; tile_x < res; tile_x += 4)
+         {
+            for (unsigned int y = tile_y; y < tile_y + 4; ++y)
+            {
+               for (unsigned int x = tile_x; x < tile_x + 4; ++x)
+               {
+                  const gmtl::Point3f target( -1.2f + step * float( x ), -1.2f + step * float( y ), 0.0f );
+                  rays.push_back( gmtl::Rayf( eye, gmtl::Vec3f( target - eye ) ) );
+               }
+            }
+         }
+      }
+   }
+
+   /** The masks the checks are run with, all lanes first. */
+   static std::vector<unsigned int> getTestMasks( const unsigned int size )
+   {
+      const unsigned int all = (size >= 32) ? ~0u : ((1u << size) - 1u);
+      std::vector<unsigned int> masks;
+      masks.push_back( all );
+      masks.push_back( all & 0x55555555u );
+      masks.push_back( all & 0x0000f0f6u );
+      masks.push_back( 1u << (size - 1) );
+      masks.push_back( 0u );
+      return masks;
+   }
+
+   /** The single ray triangle tests. */
+   template<class DATA_TYPE>
+   static bool triHit( const gmtl::Tri<DATA_TYPE>& tri, const gmtl::Ray<DATA_TYPE>& ray, const bool doubleSided,
+                       DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t )
+   {
+      return doubleSided ? gmtl::intersectDoubleSided( tri, ray, u, v, t ) : gmtl::intersect( tri, ray, u, v, t );
+   }
+
+   /** The single ray BVH queries. */
+   template<class DATA_TYPE>
+   static bool bvhHit( const gmtl::BVH<DATA_TYPE>& bvh, const gmtl::Ray<DATA_TYPE>& ray, const bool doubleSided,
+                       DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t, unsigned int& tri )
+   {
+      return doubleSided ? gmtl::intersectDoubleSided( bvh, ray, u, v, t, tri ) :
+                           gmtl::intersect( bvh, ray, u, v, t, tri );
+   }
+
+   /** Compares a packet result with the single ray one.  The packet tests
+    *  do the same arithmetic, but the compiler may contract either one into
+    *  FMAs (-ffp-contract), so they only have to agree to eps times the
+    *  larger of 1 and the value; u and v of grazing hits are less well
+    *  conditioned than t.
+    */
+   template<class DATA_TYPE>
+   static bool isClose( const DATA_TYPE a, const DATA_TYPE b, const bool barycentric = false )
+   {
+      const bool single = sizeof( DATA_TYPE ) == sizeof( float );
+      const DATA_TYPE eps = barycentric ? DATA_TYPE( single ? 1e-4 : 1e-10 ) : DATA_TYPE( single ? 1e-5 : 1e-13 );
+      return gmtl::Math::abs( a - b ) <= eps * gmtl::Math::Max( DATA_TYPE( 1 ), gmtl::Math::abs( b ) );
+   }
+
+   /** Checks the packet triangle test against the single ray one, lane by
+    *  lane and for several masks.
+    */
+   template<class DATA_TYPE, unsigned SIZE>
+   static void checkTriPacket( const std::vector< gmtl::Tri<DATA_TYPE> >& tris,
+                               const std::vector< gmtl::Ray<DATA_TYPE> >& rays, const bool doubleSided )
+   {
+      const std::vector<unsigned int> masks = getTestMasks( SIZE );
+      const DATA_TYPE unset( -7.0 );
+      unsigned int num_hits = 0;
+      for (std::size_t first = 0; first < rays.size(); first += SIZE)
+      {
+         gmtl::RayPacket<DATA_TYPE, SIZE> packet;
+         const unsigned int loaded = packet.set( &rays[first], rays.size() - first );
+         for (std::size_t m = 0; m < masks.size(); ++m)
+         {
+            const unsigned int active = masks[m] & loaded;
+            for (std::size_t i = 0; i < tris.size(); ++i)
+            {
+               DATA_TYPE u[SIZE], v[SIZE], t[SIZE];
+               for (unsigned int lane = 0; lane < SIZE; ++lane)
+               {
+                  u[lane] = v[lane] = t[lane] = unset;
+               }
+               const unsigned int hits = doubleSided ? gmtl::intersectDoubleSided( tris[i], packet, active, u, v, t ) :
+                                                       gmtl::intersect( tris[i], packet, active, u, v, t );
+               CPPUNIT_ASSERT( (hits & ~active) == 0 );
+               for (unsigned int lane = 0; lane < SIZE; ++lane)
+               {
+                  const unsigned int bit = 1u << lane;
+                  if (active & bit)
+                  {
+                     DATA_TYPE ray_u, ray_v, ray_t;
+                     const bool hit = triHit( tris[i], rays[first + lane], doubleSided, ray_u, ray_v, ray_t );
+                     CPPUNIT_ASSERT( hit == ((hits & bit) != 0) );
+                     if (hit)
+                     {
+                        CPPUNIT_ASSERT( isClose( u[lane], ray_u, true ) && isClose( v[lane], ray_v, true ) &&
+                                        isClose( t[lane], ray_t ) );
+                        ++num_hits;
+                        continue;
+                     }
+                  }
+                  CPPUNIT_ASSERT( u[lane] == unset && v[lane] == unset && t[lane] == unset );
+               }
+            }
+         }
+      }
+      CPPUNIT_ASSERT( num_hits > 0 );
+   }
+
+   /** Checks the packet BVH queries against the single ray ones, lane by
+    *  lane and for several masks.
+    */
+   template<class DATA_TYPE, unsigned SIZE>
+   static void checkBVHPacket( const gmtl::BVH<DATA_TYPE>& bvh, const std::vector< gmtl::Tri<DATA_TYPE> >& tris,
+                               const std::vector< gmtl::Ray<DATA_TYPE> >& rays, const bool doubleSided )
+   {
+      const std::vector<unsigned int> masks = getTestMasks( SIZE );
+      unsigned int num_hits = 0;
+      for (std::size_t first = 0; first < rays.size(); first += SIZE)
+      {
+         gmtl::RayPacket<DATA_TYPE, SIZE> packet;
+         const unsigned int loaded = packet.set( &rays[first], rays.size() - first );
+         for (std::size_t m = 0; m < masks.size(); ++m)
+         {
+            const unsigned int active = masks[m] & loaded;
+            gmtl::RayPacketHit<DATA_TYPE, SIZE> hit;
+            const unsigned int hits = doubleSided ? gmtl::intersectDoubleSided( bvh, packet, active, hit ) :
+                                                    gmtl::intersect( bvh, packet, active, hit );
+            const unsigned int any = doubleSided ? gmtl::intersectAnyDoubleSided( bvh, packet, active ) :
+                                                   gmtl::intersectAny( bvh, packet, active );
+            CPPUNIT_ASSERT( (hits & ~active) == 0 );
+            CPPUNIT_ASSERT( any == hits );
+            for (unsigned int lane = 0; lane < SIZE; ++lane)
+            {
+               const unsigned int bit = 1u << lane;
+               if (!(active & bit))
+               {
+                  continue;
+               }
+               DATA_TYPE u, v, t;
+               unsigned int tri;
+               const bool ray_hit = bvhHit( bvh, rays[first + lane], doubleSided, u, v, t, tri );
+               CPPUNIT_ASSERT( ray_hit == ((hits & bit) != 0) );
+               if (ray_hit)
+               {
+                  // the same closest t, maybe on another triangle at that t
+                  CPPUNIT_ASSERT( isClose( hit.mT[lane], t ) );
+                  CPPUNIT_ASSERT( hit.mTri[lane] < tris.size() );
+                  DATA_TYPE tri_u, tri_v, tri_t;
+                  CPPUNIT_ASSERT( triHit( tris[hit.mTri[lane]], rays[first + lane], doubleSided, tri_u, tri_v, tri_t ) );
+                  CPPUNIT_ASSERT( isClose( hit.mT[lane], tri_t ) && isClose( hit.mU[lane], tri_u, true ) &&
+                                  isClose( hit.mV[lane], tri_v, true ) );
+                  ++num_hits;
+               }
+            }
+         }
+      }
+      CPPUNIT_ASSERT( num_hits > 0 );
+   }
+
+   void RayPacketTest::testPacket()
+   {
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 5 );
+
+      gmtl::RayPacket4f packet;
+      for (unsigned int lane = 0; lane < 4; ++lane)
+      {
+         CPPUNIT_ASSERT( packet.getRay( lane ) == gmtl::Rayf( gmtl::Point3f(), gmtl::Vec3f() ) );
+      }
+
+      // full and partial loads
+      CPPUNIT_ASSERT( packet.set( &rays[0], rays.size() ) == 0xfu );
+      for (unsigned int lane = 0; lane < 4; ++lane)
+      {
+         CPPUNIT_ASSERT( packet.getRay( lane ) == rays[lane] );
+      }
+      CPPUNIT_ASSERT( packet.set( &rays[1], 2 ) == 0x3u );
+      CPPUNIT_ASSERT( packet.getRay( 0 ) == rays[1] && packet.getRay( 1 ) == rays[2] );
+      CPPUNIT_ASSERT( packet.getRay( 2 ) == rays[1] && packet.getRay( 3 ) == rays[1] );
+
+      packet.setRay( 2, rays[4] );
+      CPPUNIT_ASSERT( packet.getRay( 2 ) == rays[4] );
+      CPPUNIT_ASSERT( packet.mOrigin[1][2] == rays[4].getOrigin()[1] && packet.mDir[2][2] == rays[4].getDir()[2] );
+
+      CPPUNIT_ASSERT( gmtl::RayPacket4f::getMask() == 0xfu );
+      CPPUNIT_ASSERT( gmtl::RayPacket16f::getMask() == 0xffffu );
+      CPPUNIT_ASSERT( gmtl::RayPacket16f::getMask( 3 ) == 0x7u );
+      CPPUNIT_ASSERT( (gmtl::RayPacket<float, 32>::getMask()) == ~0u );
+      CPPUNIT_ASSERT( gmtl::RayPacket8f::Size == 8 );
+   }
+
+   void RayPacketTest::testTri()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillMesh( tris, 4 );
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 128 );
+
+      // grazing and degenerate cases: a ray in the plane of a triangle, a
+      // zero direction and a degenerate triangle
+      rays[5] = gmtl::Rayf( gmtl::Point3f( -2.0f, 0.0f, 0.5f ), gmtl::Vec3f( 1.0f, 0.0f, 0.0f ) );
+      rays[6] = gmtl::Rayf( gmtl::Point3f( 0.0f, 0.0f, 0.5f ), gmtl::Vec3f( 0.0f, 0.0f, 0.0f ) );
+      tris.push_back( gmtl::Trif( gmtl::Point3f( -2.0f, -1.0f, 0.5f ), gmtl::Point3f( 2.0f, -1.0f, 0.5f ),
+                                  gmtl::Point3f( 0.0f, 1.0f, 0.5f ) ) );
+      tris.push_back( gmtl::Trif( gmtl::Point3f( 0.1f, 0.1f, 0.5f ), gmtl::Point3f( 0.1f, 0.1f, 0.5f ),
+                                  gmtl::Point3f( 0.1f, 0.1f, 0.5f ) ) );
+
+      checkTriPacket<float, 4>( tris, rays, false );
+      checkTriPacket<float, 4>( tris, rays, true );
+      checkTriPacket<float, 8>( tris, rays, false );
+      checkTriPacket<float, 8>( tris, rays, true );
+      checkTriPacket<float, 16>( tris, rays, false );
+      checkTriPacket<float, 16>( tris, rays, true );
+      checkTriPacket<float, 13>( tris, rays, false );
+      checkTriPacket<float, 13>( tris, rays, true );
+
+      std::vector<gmtl::Trid> tris_d;
+      fillMesh( tris_d, 4 );
+      std::vector<gmtl::Rayd> rays_d;
+      fillRays( rays_d, 64 );
+      checkTriPacket<double, 4>( tris_d, rays_d, false );
+      checkTriPacket<double, 4>( tris_d, rays_d, true );
+
+      // the single sided double test culls the back faces of the double
+      // sided one
+      gmtl::RayPacket4d packet;
+      packet.set( &rays_d[0], 4 );
+      for (std::size_t i = 0; i < tris_d.size(); ++i)
+      {
+         double u[4], v[4], t[4], u2[4], v2[4], t2[4];
+         const unsigned int front = gmtl::intersect( tris_d[i], packet, 0xfu, u, v, t );
+         const unsigned int both = gmtl::intersectDoubleSided( tris_d[i], packet, 0xfu, u2, v2, t2 );
+         CPPUNIT_ASSERT( (front & ~both) == 0 );
+         for (unsigned int lane = 0; lane < 4; ++lane)
+         {
+            if (front & (1u << lane))
+            {
+               CPPUNIT_ASSERT( gmtl::Math::isEqual( t[lane], t2[lane], 1e-12 ) );
+            }
+         }
+      }
+   }
+
+   void RayPacketTest::testAABox()
+   {
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 256 );
+      std::vector<gmtl::AABoxf> boxes;
+      boxes.push_back( gmtl::AABoxf( gmtl::Point3f( -1.0f, -1.0f, -0.1f ), gmtl::Point3f( 1.0f, 1.0f, 0.1f ) ) );
+      boxes.push_back( gmtl::AABoxf( gmtl::Point3f( -0.3f, 0.2f, 0.0f ), gmtl::Point3f( 0.1f, 0.7f, 1.2f ) ) );
+      boxes.push_back( gmtl::AABoxf( gmtl::Point3f( 0.5f, -0.5f, 0.9f ), gmtl::Point3f( 0.6f, -0.4f, 1.0f ) ) );
+      boxes.push_back( gmtl::AABoxf( gmtl::Point3f( -5.0f, -5.0f, -5.0f ), gmtl::Point3f( 5.0f, 5.0f, 5.0f ) ) );
+
+      const std::vector<unsigned int> masks = getTestMasks( 8 );
+      unsigned int num_hits = 0, num_misses = 0;
+      for (std::size_t first = 0; first < rays.size(); first += 8)
+      {
+         gmtl::RayPacket8f packet;
+         packet.set( &rays[first], 8 );
+         for (std::size_t b = 0; b < boxes.size(); ++b)
+         {
+            for (std::size_t m = 0; m < masks.size(); ++m)
+            {
+               float t_in[8], t_out[8];
+               for (unsigned int lane = 0; lane < 8; ++lane)
+               {
+                  t_in[lane] = t_out[lane] = -7.0f;
+               }
+               const unsigned int hits = gmtl::intersect( boxes[b], packet, masks[m], t_in, t_out );
+               CPPUNIT_ASSERT( (hits & ~masks[m]) == 0 );
+               for (unsigned int lane = 0; lane < 8; ++lane)
+               {
+                  const unsigned int bit = 1u << lane;
+                  if (!(hits & bit))
+                  {
+                     CPPUNIT_ASSERT( t_in[lane] == -7.0f && t_out[lane] == -7.0f );
+                  }
+                  if (!(masks[m] & bit))
+                  {
+                     continue;
+                  }
+                  float ray_in, ray_out;
+                  const bool hit = gmtl::intersectAABoxRay( boxes[b], rays[first + lane], ray_in, ray_out ) &&
+                                   !(ray_in > ray_out || ray_out < 0.0f);
+                  CPPUNIT_ASSERT( hit == ((hits & bit) != 0) );
+                  if (hit)
+                  {
+                     CPPUNIT_ASSERT( gmtl::Math::isEqual( t_in[lane], ray_in, 1e-5f * (1.0f + gmtl::Math::abs( ray_in )) ) );
+                     CPPUNIT_ASSERT( gmtl::Math::isEqual( t_out[lane], ray_out, 1e-5f * (1.0f + gmtl::Math::abs( ray_out )) ) );
+                     ++num_hits;
+                  }
+                  else
+                  {
+                     ++num_misses;
+                  }
+               }
+            }
+         }
+      }
+      CPPUNIT_ASSERT( num_hits > 0 && num_misses > 0 );
+
+      // an empty box is never hit
+      gmtl::RayPacket8f packet;
+      packet.set( &rays[0], 8 );
+      float t_in[8], t_out[8];
+      CPPUNIT_ASSERT( gmtl::intersect( gmtl::AABoxf(), packet, 0xffu, t_in, t_out ) == 0 );
+   }
+
+   void RayPacketTest::testBVH()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillMesh( tris, 24 );
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 300 );
+      std::vector<gmtl::Rayf> camera;
+      fillCameraRays( camera, 16 );
+      rays.insert( rays.end(), camera.begin(), camera.end() );
+      const gmtl::BVHf bvh( &tris[0], tris.size() );
+
+      checkBVHPacket<float, 4>( bvh, tris, rays, false );
+      checkBVHPacket<float, 4>( bvh, tris, rays, true );
+      checkBVHPacket<float, 8>( bvh, tris, rays, false );
+      checkBVHPacket<float, 8>( bvh, tris, rays, true );
+      checkBVHPacket<float, 16>( bvh, tris, rays, false );
+      checkBVHPacket<float, 16>( bvh, tris, rays, true );
+      checkBVHPacket<float, 5>( bvh, tris, rays, false );
+
+      // an empty BVH is never hit
+      const gmtl::BVHf empty;
+      gmtl::RayPacket4f packet;
+      packet.set( &rays[0], 4 );
+      gmtl::RayPacketHit4f hit;
+      CPPUNIT_ASSERT( gmtl::intersect( empty, packet, 0xfu, hit ) == 0 );
+      CPPUNIT_ASSERT( gmtl::intersectAny( empty, packet, 0xfu ) == 0 );
+   }
+
+   void RayPacketTest::testBVHDouble()
+   {
+      std::vector<gmtl::Trid> tris;
+      fillMesh( tris, 16 );
+      std::vector<gmtl::Rayd> rays;
+      fillRays( rays, 200 );
+      const gmtl::BVHd bvh( &tris[0], tris.size() );
+      checkBVHPacket<double, 4>( bvh, tris, rays, false );
+      checkBVHPacket<double, 4>( bvh, tris, rays, true );
+
+      // the front face hits are never closer than the closest hit of
+      // either side
+      for (std::size_t first = 0; first < rays.size(); first += 4)
+      {
+         gmtl::RayPacket4d packet;
+         packet.set( &rays[first], 4 );
+         gmtl::RayPacketHit4d front, both;
+         const unsigned int front_hits = gmtl::intersect( bvh, packet, 0xfu, front );
+         const unsigned int both_hits = gmtl::intersectDoubleSided( bvh, packet, 0xfu, both );
+         CPPUNIT_ASSERT( (front_hits & ~both_hits) == 0 );
+         CPPUNIT_ASSERT( gmtl::intersectAny( bvh, packet, 0xfu ) == front_hits );
+         for (unsigned int lane = 0; lane < 4; ++lane)
+         {
+            if (front_hits & (1u << lane))
+            {
+               CPPUNIT_ASSERT( front.mT[lane] >= both.mT[lane] );
+            }
+         }
+      }
+   }
+
+   /*
+    * The timings are per ray, the throughput in rays per second is
+    * 1e6 / (us per ray).
+    */
+
+   void RayPacketMetricTest::testTimingTri()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillMesh( tris, 32 );
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 16 );
+      unsigned int hits = 0;
+
+      // one ray at a time
+      const long iters(20);
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < tris.size(); ++i)
+         {
+            for (std::size_t r = 0; r < rays.size(); ++r)
+            {
+               float u, v, t;
+               hits += gmtl::intersect( tris[i], rays[r], u, v, t ) ? 1 : 0;
+            }
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("RayPacketTest/intersect(Tri, Ray) per ray and tri", iters * tris.size() * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      // packets of 4
+      gmtl::RayPacket4f packet4[4];
+      for (unsigned int p = 0; p < 4; ++p)
+      {
+         packet4[p].set( &rays[4 * p], 4 );
+      }
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < tris.size(); ++i)
+         {
+            for (unsigned int p = 0; p < 4; ++p)
+            {
+               float u[4], v[4], t[4];
+               hits += gmtl::intersect( tris[i], packet4[p], 0xfu, u, v, t );
+            }
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("RayPacketTest/intersect(Tri, RayPacket4f) per ray and tri", iters * tris.size() * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      // packets of 8
+      gmtl::RayPacket8f packet8[2];
+      packet8[0].set( &rays[0], 8 );
+      packet8[1].set( &rays[8], 8 );
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < tris.size(); ++i)
+         {
+            for (unsigned int p = 0; p < 2; ++p)
+            {
+               float u[8], v[8], t[8];
+               hits += gmtl::intersect( tris[i], packet8[p], 0xffu, u, v, t );
+            }
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("RayPacketTest/intersect(Tri, RayPacket8f) per ray and tri", iters * tris.size() * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      // packets of 16
+      gmtl::RayPacket16f packet16;
+      packet16.set( &rays[0], 16 );
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < tris.size(); ++i)
+         {
+            float u[16], v[16], t[16];
+            hits += gmtl::intersect( tris[i], packet16, 0xffffu, u, v, t );
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("RayPacketTest/intersect(Tri, RayPacket16f) per ray and tri", iters * tris.size() * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( hits > 0 );
+   }
+
+   /** Traces rays through bvh in packets of SIZE, for the timings. */
+   template<unsigned SIZE>
+   static unsigned int tracePackets( const gmtl::BVHf& bvh, const std::vector<gmtl::Rayf>& rays, const bool anyHit )
+   {
+      unsigned int hits = 0;
+      gmtl::RayPacket<float, SIZE> packet;
+      gmtl::RayPacketHit<float, SIZE> hit;
+      for (std::size_t first = 0; first < rays.size(); first += SIZE)
+      {
+         const unsigned int active = packet.set( &rays[first], rays.size() - first );
+         const unsigned int mask = anyHit ? gmtl::intersectAny( bvh, packet, active ) :
+                                            gmtl::intersect( bvh, packet, active, hit );
+         hits += (mask != 0) ? 1 : 0;
+      }
+      return hits;
+   }
+
+   void RayPacketMetricTest::testTimingBVH()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillMesh( tris, 128 );
+      const gmtl::BVHf bvh( &tris[0], tris.size() );
+      std::vector<gmtl::Rayf> camera;
+      fillCameraRays( camera, 256 );
+      std::vector<gmtl::Rayf> scattered;
+      fillRays( scattered, camera.size() );
+      unsigned int hits = 0;
+
+      const long iters(4);
+      const std::vector<gmtl::Rayf>* ray_sets[2] = { &camera, &scattered };
+      const char* ray_names[2] = { "camera rays", "incoherent rays" };
+      for (unsigned int set = 0; set < 2; ++set)
+      {
+         const std::vector<gmtl::Rayf>& rays = *ray_sets[set];
+         std::ostringstream name;
+
+         CPPUNIT_METRIC_START_TIMING();
+         for (long iter = 0; iter < iters; ++iter)
+         {
+            for (std::size_t i = 0; i < rays.size(); ++i)
+            {
+               float u, v, t;
+               unsigned int tri;
+               hits += gmtl::intersect( bvh, rays[i], u, v, t, tri ) ? 1 : 0;
+            }
+         }
+         CPPUNIT_METRIC_STOP_TIMING();
+         name.str( "" );
+         name << "RayPacketTest/intersect(BVH, Ray) " << ray_names[set] << ", per ray";
+         CPPUNIT_ASSERT_METRIC_TIMING_LE(name.str(), iters * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+         CPPUNIT_METRIC_START_TIMING();
+         for (long iter = 0; iter < iters; ++iter)
+         {
+            hits += tracePackets<4>( bvh, rays, false );
+         }
+         CPPUNIT_METRIC_STOP_TIMING();
+         name.str( "" );
+         name << "RayPacketTest/intersect(BVH, RayPacket4f) " << ray_names[set] << ", per ray";
+         CPPUNIT_ASSERT_METRIC_TIMING_LE(name.str(), iters * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+         CPPUNIT_METRIC_START_TIMING();
+         for (long iter = 0; iter < iters; ++iter)
+         {
+            hits += tracePackets<8>( bvh, rays, false );
+         }
+         CPPUNIT_METRIC_STOP_TIMING();
+         name.str( "" );
+         name << "RayPacketTest/intersect(BVH, RayPacket8f) " << ray_names[set] << ", per ray";
+         CPPUNIT_ASSERT_METRIC_TIMING_LE(name.str(), iters * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+         CPPUNIT_METRIC_START_TIMING();
+         for (long iter = 0; iter < iters; ++iter)
+         {
+            hits += tracePackets<16>( bvh, rays, false );
+         }
+         CPPUNIT_METRIC_STOP_TIMING();
+         name.str( "" );
+         name << "RayPacketTest/intersect(BVH, RayPacket16f) " << ray_names[set] << ", per ray";
+         CPPUNIT_ASSERT_METRIC_TIMING_LE(name.str(), iters * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      }
+
+      // shadow rays: any hit
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < camera.size(); ++i)
+         {
+            hits += gmtl::intersectAny( bvh, camera[i] ) ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("RayPacketTest/intersectAny(BVH, Ray) camera rays, per ray", iters * camera.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         hits += tracePackets<16>( bvh, camera, true );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("RayPacketTest/intersectAny(BVH, RayPacket16f) camera rays, per ray", iters * camera.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( hits > 0 );
+   }
+}
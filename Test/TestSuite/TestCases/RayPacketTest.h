@@ -0,0 +1,54 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_RAY_PACKET_TEST_H_
+#define _GMTL_RAY_PACKET_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace gmtlTest
+{
+   /**
+    * Functionality tests for RayPacket and the packet intersection tests.
+    */
+   class RayPacketTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(RayPacketTest);
+
+      CPPUNIT_TEST(testPacket);
+      CPPUNIT_TEST(testTri);
+      CPPUNIT_TEST(testAABox);
+      CPPUNIT_TEST(testBVH);
+      CPPUNIT_TEST(testBVHDouble);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testPacket();
+      void testTri();
+      void testAABox();
+      void testBVH();
+      void testBVHDouble();
+   };
+
+   /**
+    * Metric tests.
+    */
+   class RayPacketMetricTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(RayPacketMetricTest);
+
+      CPPUNIT_TEST(testTimingTri);
+      CPPUNIT_TEST(testTimingBVH);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testTimingTri();
+      void testTimingBVH();
+   };
+}
+
+#endif
@@ -7,6 +7,9 @@
 #include "../Suites.h"
 #include <cppunit/extensions/MetricRegistry.h>
 
+#include <iostream>
+#include <list>
+#include <vector>
 #include <gmtl/Sphere.h>
 #include <gmtl/SphereOps.h>
 #include <gmtl/Containment.h>
@@ -610,6 +613,229 @@ namespace gmtlTest
       CPPUNIT_METRIC_STOP_TIMING();
       CPPUNIT_ASSERT_METRIC_TIMING_LE("SphereTest/makeVolumePointOverhead", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
    }
+
+   /** Fills pts with count points in a squashed, turned ellipsoid around
+    *  (3, -2, 5), denser near its center.
+    */
+   template<class DATA_TYPE>
+   static void fillPointCloud( std::vector< gmtl::Point<DATA_TYPE, 3> >& pts, const std::size_t count,
+                               const std::size_t seed = 0 )
+   {
+      pts.resize( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         const DATA_TYPE f = DATA_TYPE( i + seed * 7919 );
+         const DATA_TYPE x = DATA_TYPE( 10 ) * gmtl::Math::sin( f * DATA_TYPE( 0.37 ) ) * gmtl::Math::cos( f * DATA_TYPE( 1.3 ) );
+         const DATA_TYPE y = DATA_TYPE( 4 ) * gmtl::Math::sin( f * DATA_TYPE( 0.71 ) );
+         const DATA_TYPE z = DATA_TYPE( 6 ) * gmtl::Math::cos( f * DATA_TYPE( 0.13 ) ) * gmtl::Math::sin( f * DATA_TYPE( 2.9 ) );
+         pts[i].set( DATA_TYPE( 3 ) + DATA_TYPE( 0.8 ) * x - DATA_TYPE( 0.6 ) * y,
+                     DATA_TYPE( -2 ) + DATA_TYPE( 0.6 ) * x + DATA_TYPE( 0.8 ) * y,
+                     DATA_TYPE( 5 ) + z );
+      }
+   }
+
+   /** Fills pts with count points on a cone, denser near its tip, the
+    *  kind of lopsided set the centroid fits poorly.
+    */
+   static void fillConeCloud( std::vector<gmtl::Point3f>& pts, const std::size_t count )
+   {
+      pts.resize( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         const float f = float( i );
+         const float t = 0.5f + 0.5f * gmtl::Math::sin( f * 1.9f );
+         const float r = 4.0f * t * t;
+         pts[i].set( r * gmtl::Math::cos( f * 2.3f ), r * gmtl::Math::sin( f * 2.3f ), 10.0f * t * t );
+      }
+   }
+
+   /** The distance from center to the farthest of pts. */
+   template<class DATA_TYPE, class ITERATOR>
+   static DATA_TYPE farthestDistance( const gmtl::Point<DATA_TYPE, 3>& center, ITERATOR first, const ITERATOR last )
+   {
+      DATA_TYPE dist(0);
+      for (; first != last; ++first)
+      {
+         const DATA_TYPE d = gmtl::length( gmtl::Vec<DATA_TYPE, 3>( *first - center ) );
+         dist = (d > dist) ? d : dist;
+      }
+      return dist;
+   }
+
+   /** Checks that sph contains all of pts and, if exact, that no nearby
+    *  center gives a smaller sphere (the farthest distance is convex in the
+    *  center, so a local minimum is the global one).
+    */
+   template<class DATA_TYPE, class ITERATOR>
+   static void checkSphereFit( const gmtl::Sphere<DATA_TYPE>& sph, ITERATOR first, const ITERATOR last,
+                               const DATA_TYPE tol, const bool exact )
+   {
+      CPPUNIT_ASSERT( sph.isInitialized() );
+      const DATA_TYPE farthest = farthestDistance( sph.mCenter, first, last );
+      CPPUNIT_ASSERT( farthest <= sph.mRadius * (1 + tol) );
+      CPPUNIT_ASSERT( farthest >= sph.mRadius * (1 - tol) );
+      if (!exact)
+      {
+         return;
+      }
+      const DATA_TYPE step = (sph.mRadius > 0) ? sph.mRadius * DATA_TYPE( 1e-3 ) : DATA_TYPE( 1e-3 );
+      for (int dx = -1; dx <= 1; ++dx)
+      {
+         for (int dy = -1; dy <= 1; ++dy)
+         {
+            for (int dz = -1; dz <= 1; ++dz)
+            {
+               const gmtl::Point<DATA_TYPE, 3> c( sph.mCenter[0] + step * DATA_TYPE( dx ),
+                                                  sph.mCenter[1] + step * DATA_TYPE( dy ),
+                                                  sph.mCenter[2] + step * DATA_TYPE( dz ) );
+               CPPUNIT_ASSERT( farthestDistance( c, first, last ) >= farthest * (1 - tol) );
+            }
+         }
+      }
+   }
+
+   /** Fits all the policies to pts, checks them and returns the Welzl
+    *  sphere.
+    */
+   template<class DATA_TYPE>
+   static gmtl::Sphere<DATA_TYPE> checkSphereFits( const std::vector< gmtl::Point<DATA_TYPE, 3> >& pts,
+                                                   const DATA_TYPE tol )
+   {
+      gmtl::Sphere<DATA_TYPE> welzl, ritter, centroid, def;
+      gmtl::makeVolume( welzl, pts.begin(), pts.end(), gmtl::WelzlSphereFit() );
+      gmtl::makeVolume( ritter, pts.begin(), pts.end(), gmtl::RitterSphereFit() );
+      gmtl::makeVolume( centroid, pts.begin(), pts.end(), gmtl::CentroidSphereFit() );
+      gmtl::makeVolume( def, pts.begin(), pts.end() );
+      checkSphereFit( welzl, pts.begin(), pts.end(), tol, true );
+      checkSphereFit( ritter, pts.begin(), pts.end(), tol, false );
+      checkSphereFit( centroid, pts.begin(), pts.end(), tol, false );
+      CPPUNIT_ASSERT( def == welzl );
+      CPPUNIT_ASSERT( welzl.mRadius <= ritter.mRadius * (1 + tol) );
+      CPPUNIT_ASSERT( welzl.mRadius <= centroid.mRadius * (1 + tol) );
+      return welzl;
+   }
+
+   void SphereTest::testMakeVolumeRange()
+   {
+      const double tol = 1e-6;
+      std::vector<gmtl::Point3d> pts;
+
+      // the points of testMakeVolumePoint(): the two farthest apart are
+      // opposite each other on the smallest sphere
+      pts.push_back( gmtl::Point3d( 1, 0, 0 ) );
+      pts.push_back( gmtl::Point3d( 0, 5, 0 ) );
+      pts.push_back( gmtl::Point3d( 0, 5, 10 ) );
+      pts.push_back( gmtl::Point3d( 0, 5, -10 ) );
+      gmtl::Sphered sph = checkSphereFits( pts, tol );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( sph.mRadius, 10.0, 1e-9 ) );
+      CPPUNIT_ASSERT( gmtl::isEqual( sph.mCenter, gmtl::Point3d( 0, 5, 0 ), 1e-9 ) );
+
+      // the corners of a cube, four at a time on a plane
+      pts.clear();
+      for (unsigned int i = 0; i < 8; ++i)
+      {
+         pts.push_back( gmtl::Point3d( (i & 1) ? 3 : 1, (i & 2) ? 3 : 1, (i & 4) ? 3 : 1 ) );
+      }
+      sph = checkSphereFits( pts, tol );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( sph.mRadius, gmtl::Math::sqrt( 3.0 ), 1e-9 ) );
+      CPPUNIT_ASSERT( gmtl::isEqual( sph.mCenter, gmtl::Point3d( 2, 2, 2 ), 1e-9 ) );
+
+      // a circle on a tilted plane, and points on a line
+      pts.clear();
+      for (unsigned int i = 0; i < 16; ++i)
+      {
+         const double a = double( i ) * gmtl::Math::TWO_PI / 16.0;
+         const double c = 2.0 * gmtl::Math::cos( a ), s = 2.0 * gmtl::Math::sin( a );
+         pts.push_back( gmtl::Point3d( c * 0.6, s, c * 0.8 - 4.0 ) );
+      }
+      sph = checkSphereFits( pts, tol );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( sph.mRadius, 2.0, 1e-9 ) );
+      CPPUNIT_ASSERT( gmtl::isEqual( sph.mCenter, gmtl::Point3d( 0, 0, -4 ), 1e-9 ) );
+
+      pts.clear();
+      for (unsigned int i = 0; i < 10; ++i)
+      {
+         pts.push_back( gmtl::Point3d( 1.0 + i, 2.0 - 0.5 * i, 3.0 * i ) );
+      }
+      sph = checkSphereFits( pts, tol );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( sph.mRadius, 0.5 * gmtl::length( gmtl::Vec3d( pts[9] - pts[0] ) ), 1e-9 ) );
+
+      // one point, the same point many times, and no points
+      pts.assign( 1, gmtl::Point3d( 1, 2, 3 ) );
+      sph = checkSphereFits( pts, tol );
+      CPPUNIT_ASSERT( sph.mRadius == 0.0 && sph.mCenter == pts[0] );
+      pts.assign( 20, gmtl::Point3d( 1, 2, 3 ) );
+      sph = checkSphereFits( pts, tol );
+      CPPUNIT_ASSERT( sph.mRadius == 0.0 && sph.mCenter == pts[0] );
+      pts.clear();
+      gmtl::makeVolume( sph, pts.begin(), pts.end(), gmtl::RitterSphereFit() );
+      CPPUNIT_ASSERT( !sph.isInitialized() );
+      gmtl::makeVolume( sph, pts.begin(), pts.end() );
+      CPPUNIT_ASSERT( !sph.isInitialized() );
+
+      // clouds of all sizes
+      for (std::size_t count = 2; count < 300; count += 7)
+      {
+         fillPointCloud( pts, count, count );
+         checkSphereFits( pts, tol );
+      }
+
+      // floats, from a forward iterator range
+      std::vector<gmtl::Point3f> cloud;
+      fillConeCloud( cloud, 1000 );
+      const std::list<gmtl::Point3f> pt_list( cloud.begin(), cloud.end() );
+      gmtl::Spheref welzl, ritter, centroid;
+      gmtl::makeVolume( welzl, pt_list.begin(), pt_list.end(), gmtl::WelzlSphereFit() );
+      gmtl::makeVolume( ritter, pt_list.begin(), pt_list.end(), gmtl::RitterSphereFit() );
+      gmtl::makeVolume( centroid, pt_list.begin(), pt_list.end(), gmtl::CentroidSphereFit() );
+      checkSphereFit( welzl, pt_list.begin(), pt_list.end(), 1e-5f, true );
+      checkSphereFit( ritter, pt_list.begin(), pt_list.end(), 1e-5f, false );
+      checkSphereFit( centroid, pt_list.begin(), pt_list.end(), 1e-5f, false );
+      CPPUNIT_ASSERT( welzl.mRadius < ritter.mRadius && welzl.mRadius < centroid.mRadius );
+
+      // the centroid policy is the old makeVolume
+      gmtl::Spheref old;
+      gmtl::makeVolume( old, cloud );
+      CPPUNIT_ASSERT( old.mCenter == centroid.mCenter && old.mRadius == centroid.mRadius );
+   }
+
+   void SphereMetricTest::testTimingMakeVolumeRange()
+   {
+      std::vector<gmtl::Point3f> pts;
+      fillConeCloud( pts, 10000 );
+      gmtl::Spheref welzl, ritter, centroid;
+
+      const long iters(50);
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::makeVolume( centroid, pts.begin(), pts.end(), gmtl::CentroidSphereFit() );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("SphereTest/makeVolume(CentroidSphereFit) 10k points", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::makeVolume( ritter, pts.begin(), pts.end(), gmtl::RitterSphereFit() );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("SphereTest/makeVolume(RitterSphereFit) 10k points", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::makeVolume( welzl, pts.begin(), pts.end(), gmtl::WelzlSphereFit() );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("SphereTest/makeVolume(WelzlSphereFit) 10k points", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      // the quality of the fits, as radius over the smallest radius
+      std::cout << "   SphereTest/makeVolume radius / smallest radius, 10k points: centroid "
+                << centroid.mRadius / welzl.mRadius << ", Ritter " << ritter.mRadius / welzl.mRadius
+                << std::endl;
+      CPPUNIT_ASSERT( welzl.mRadius <= ritter.mRadius && welzl.mRadius <= centroid.mRadius );
+   }
 /*
    void SphereTest::testMakeVolumeSphere()
    {
@@ -27,6 +27,7 @@ namespace gmtlTest
       CPPUNIT_TEST(testExtendVolumePoint);
       CPPUNIT_TEST(testExtendVolumeSphere);
       CPPUNIT_TEST(testMakeVolumePoint);
+      CPPUNIT_TEST(testMakeVolumeRange);
       CPPUNIT_TEST(testSphereIntersections);
 //      CPPUNIT_TEST(testMakeVolumeSphere);
 
@@ -62,6 +63,7 @@ namespace gmtlTest
       void testExtendVolumePoint();
       void testExtendVolumeSphere();
       void testMakeVolumePoint();
+      void testMakeVolumeRange();
    //   void testMakeVolumeSphere();
    };
 
@@ -82,6 +84,7 @@ namespace gmtlTest
       CPPUNIT_TEST(testTimingExtendVolumePoint);
       CPPUNIT_TEST(testTimingExtendVolumeSphere);
       CPPUNIT_TEST(testTimingMakeVolumePoint);
+      CPPUNIT_TEST(testTimingMakeVolumeRange);
 
       CPPUNIT_TEST_SUITE_END();
 
@@ -111,6 +114,7 @@ namespace gmtlTest
       void testTimingExtendVolumePoint();
       void testTimingExtendVolumeSphere();
       void testTimingMakeVolumePoint();
+      void testTimingMakeVolumeRange();
    };
 }
 
@@ -0,0 +1,407 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#include "TriBlockTest.h"
+#include "../Suites.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/MetricRegistry.h>
+
+#include <vector>
+#include <gmtl/TriBlock.h>
+#include <gmtl/TriBlockOps.h>
+#include <gmtl/TriOps.h>
+#include <gmtl/Intersection.h>
+
+namespace gmtlTest
+{
+   CPPUNIT_TEST_SUITE_REGISTRATION(TriBlockTest);
+   CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TriBlockMetricTest, Suites::metric());
+
+   /** Fills tris with count triangles of various sizes and orientations
+    *  in [-1, 1]^3, with a few duplicates (hit at the same t) and
+    *  degenerate ones.
+    */
+   template<class DATA_TYPE>
+   static void fillSoup( std::vector< gmtl::Tri<DATA_TYPE> >& tris, const std::size_t count )
+   {
+      typedef gmtl::Point<DATA_TYPE, 3> PointType;
+      typedef gmtl::Vec<DATA_TYPE, 3> VecType;
+      tris.clear();
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         const DATA_TYPE f = DATA_TYPE( i );
+         const PointType c( gmtl::Math::sin( f * DATA_TYPE( 1.3 ) ), gmtl::Math::cos( f * DATA_TYPE( 0.7 ) ),
+                            gmtl::Math::sin( f * DATA_TYPE( 0.31 ) + DATA_TYPE( 0.5 ) ) );
+         const DATA_TYPE s = DATA_TYPE( 0.15 ) + DATA_TYPE( 0.1 ) * gmtl::Math::sin( f * DATA_TYPE( 2.9 ) );
+         const VecType a( s * gmtl::Math::cos( f ), s * gmtl::Math::sin( f ), DATA_TYPE( 0.3 ) * s );
+         const VecType b( -s * gmtl::Math::sin( f * DATA_TYPE( 1.9 ) ), s * gmtl::Math::cos( f * DATA_TYPE( 1.9 ) ),
+                          -DATA_TYPE( 0.2 ) * s );
+         switch (i % 16)
+         {
+         case 5:
+            tris.push_back( tris[i - 3] );
+            break;
+         case 9:
+            tris.push_back( gmtl::Tri<DATA_TYPE>( c, c, c ) );
+            break;
+         default:
+            tris.push_back( gmtl::Tri<DATA_TYPE>( c - a, c + a, c + b ) );
+            break;
+         }
+      }
+   }
+
+   /** Fills rays with count rays through the soup from all directions. */
+   template<class DATA_TYPE>
+   static void fillRays( std::vector< gmtl::Ray<DATA_TYPE> >& rays, const std::size_t count )
+   {
+      typedef gmtl::Point<DATA_TYPE, 3> PointType;
+      typedef gmtl::Vec<DATA_TYPE, 3> VecType;
+      rays.resize( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         const DATA_TYPE f = DATA_TYPE( i );
+         const VecType from( gmtl::Math::sin( f * DATA_TYPE( 0.77 ) ), gmtl::Math::cos( f * DATA_TYPE( 1.31 ) ),
+                             gmtl::Math::sin( f * DATA_TYPE( 2.17 ) + DATA_TYPE( 1.0 ) ) );
+         const PointType target( DATA_TYPE( 0.8 ) * gmtl::Math::sin( f * DATA_TYPE( 3.1 ) ),
+                                 DATA_TYPE( 0.8 ) * gmtl::Math::cos( f * DATA_TYPE( 1.7 ) ),
+                                 DATA_TYPE( 0.8 ) * gmtl::Math::sin( f * DATA_TYPE( 0.9 ) ) );
+         const PointType origin = target + from * DATA_TYPE( 2.0 );
+         rays[i].setOrigin( origin );
+         rays[i].setDir( (i % 7 == 0) ? VecType( 0, 0, -1 ) : VecType( target - origin ) );
+      }
+   }
+
+   /** The triangle tests of the brute force reference. */
+   template<class DATA_TYPE>
+   static bool triHit( const gmtl::Tri<DATA_TYPE>& tri, const gmtl::Ray<DATA_TYPE>& ray, const bool doubleSided,
+                       DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t )
+   {
+      return doubleSided ? gmtl::intersectDoubleSided( tri, ray, u, v, t ) : gmtl::intersect( tri, ray, u, v, t );
+   }
+
+   /** Compares a block result with the single triangle one.  The block
+    *  kernels do the same arithmetic, but the compiler may contract either
+    *  one into FMAs (-ffp-contract), so they only have to agree to eps
+    *  times the larger of 1 and the value.
+    */
+   template<class DATA_TYPE>
+   static bool isClose( const DATA_TYPE a, const DATA_TYPE b, const DATA_TYPE eps )
+   {
+      return gmtl::Math::abs( a - b ) <= eps * gmtl::Math::Max( DATA_TYPE( 1 ), gmtl::Math::abs( b ) );
+   }
+
+   /** Checks a block query against testing every triangle in order and
+    *  keeping the first closest hit at most tMax away.  A triangle hit at
+    *  nearly the same t may win instead of the first closest one; it must
+    *  then be hit with the returned u, v and t.
+    */
+   template<class DATA_TYPE>
+   static void checkHit( const std::vector< gmtl::Tri<DATA_TYPE> >& tris, const gmtl::Ray<DATA_TYPE>& ray,
+                         const DATA_TYPE tMax, const bool doubleSided, const bool hit,
+                         const DATA_TYPE u, const DATA_TYPE v, const DATA_TYPE t, const unsigned int triIndex )
+   {
+      bool found = false;
+      DATA_TYPE best_u( 0 ), best_v( 0 ), best_t( tMax );
+      unsigned int best_tri = 0;
+      for (std::size_t i = 0; i < tris.size(); ++i)
+      {
+         DATA_TYPE tri_u, tri_v, tri_t;
+         if (triHit( tris[i], ray, doubleSided, tri_u, tri_v, tri_t ) &&
+             (tri_t < best_t || (!found && tri_t <= best_t)))
+         {
+            found = true;
+            best_u = tri_u;
+            best_v = tri_v;
+            best_t = tri_t;
+            best_tri = static_cast<unsigned int>( i );
+         }
+      }
+      CPPUNIT_ASSERT( hit == found );
+      if (found)
+      {
+         // u and v of grazing hits are less well conditioned than t
+         const bool single = sizeof( DATA_TYPE ) == sizeof( float );
+         const DATA_TYPE t_eps( single ? 1e-5 : 1e-13 ), uv_eps( single ? 1e-4 : 1e-10 );
+         CPPUNIT_ASSERT( isClose( t, best_t, t_eps ) );
+         if (triIndex != best_tri)
+         {
+            CPPUNIT_ASSERT( triIndex < tris.size() );
+            CPPUNIT_ASSERT( triHit( tris[triIndex], ray, doubleSided, best_u, best_v, best_t ) );
+         }
+         CPPUNIT_ASSERT( isClose( u, best_u, uv_eps ) && isClose( v, best_v, uv_eps ) && isClose( t, best_t, t_eps ) );
+      }
+   }
+
+   void TriBlockTest::testBlock()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillSoup( tris, 21 );
+
+      gmtl::TriBlockf block;
+      CPPUNIT_ASSERT( block.empty() && block.size() == 0 && block.getPaddedSize() == 0 );
+      for (std::size_t i = 0; i < tris.size(); ++i)
+      {
+         block.push_back( tris[i] );
+         CPPUNIT_ASSERT( block.size() == i + 1 );
+         CPPUNIT_ASSERT( block.getPaddedSize() % gmtl::TriBlockf::Padding == 0 );
+         CPPUNIT_ASSERT( block.getPaddedSize() >= block.size() &&
+                         block.getPaddedSize() < block.size() + gmtl::TriBlockf::Padding );
+      }
+      CPPUNIT_ASSERT( block.getPaddedSize() == 24 );
+
+      // the columns hold the first vertex and the edges, the padding is zero
+      for (std::size_t i = 0; i < block.getPaddedSize(); ++i)
+      {
+         if (i < tris.size())
+         {
+            CPPUNIT_ASSERT( block.mVert0.get( i ) == gmtl::Vec3f( tris[i][0][0], tris[i][0][1], tris[i][0][2] ) );
+            CPPUNIT_ASSERT( block.mEdge1.get( i ) == gmtl::Vec3f( tris[i][1] - tris[i][0] ) );
+            CPPUNIT_ASSERT( block.mEdge2.get( i ) == gmtl::Vec3f( tris[i][2] - tris[i][0] ) );
+            const gmtl::Trif tri = block.getTri( i );
+            CPPUNIT_ASSERT( tri[0] == tris[i][0] );
+            CPPUNIT_ASSERT( gmtl::isEqual( tri[1], tris[i][1], 1e-6f ) && gmtl::isEqual( tri[2], tris[i][2], 1e-6f ) );
+         }
+         else
+         {
+            CPPUNIT_ASSERT( block.mEdge1.get( i ) == gmtl::Vec3f() && block.mEdge2.get( i ) == gmtl::Vec3f() );
+         }
+      }
+
+      const gmtl::TriBlockf copy( &tris[0], tris.size() );
+      CPPUNIT_ASSERT( copy.size() == tris.size() && copy.getPaddedSize() == 24 );
+      CPPUNIT_ASSERT( copy.mEdge2.mZ == block.mEdge2.mZ );
+
+      block.assign( &tris[0], 8 );
+      CPPUNIT_ASSERT( block.size() == 8 && block.getPaddedSize() == 8 );
+      block.clear();
+      CPPUNIT_ASSERT( block.empty() && block.getPaddedSize() == 0 );
+
+      // nothing to hit
+      const gmtl::Rayf ray( gmtl::Point3f( 0, 0, 2 ), gmtl::Vec3f( 0, 0, -1 ) );
+      float u, v, t;
+      unsigned int tri;
+      CPPUNIT_ASSERT( !gmtl::intersect( block, ray, u, v, t, tri ) );
+      CPPUNIT_ASSERT( !gmtl::intersectDoubleSided( block, ray, u, v, t, tri ) );
+   }
+
+   void TriBlockTest::testRay()
+   {
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 400 );
+      // a ray in the plane of a triangle and a zero direction
+      rays[1] = gmtl::Rayf( gmtl::Point3f( -2.0f, 0.0f, 0.0f ), gmtl::Vec3f( 1.0f, 0.0f, 0.0f ) );
+      rays[2] = gmtl::Rayf( gmtl::Point3f( 0.0f, 0.0f, 0.0f ), gmtl::Vec3f( 0.0f, 0.0f, 0.0f ) );
+
+      const std::size_t sizes[] = { 1, 3, 8, 13, 64, 203 };
+      unsigned int num_hits[2] = { 0, 0 };
+      for (std::size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+      {
+         std::vector<gmtl::Trif> tris;
+         fillSoup( tris, sizes[s] );
+         tris[0] = gmtl::Trif( gmtl::Point3f( -1.0f, -1.0f, 0.0f ), gmtl::Point3f( 1.0f, -1.0f, 0.0f ),
+                               gmtl::Point3f( 0.0f, 1.0f, 0.0f ) );
+         const gmtl::TriBlockf block( &tris[0], tris.size() );
+         for (std::size_t i = 0; i < rays.size(); ++i)
+         {
+            for (unsigned int sided = 0; sided < 2; ++sided)
+            {
+               float u = -7.0f, v = -7.0f, t = -7.0f;
+               unsigned int tri = ~0u;
+               const bool hit = sided ? gmtl::intersectDoubleSided( block, rays[i], u, v, t, tri ) :
+                                        gmtl::intersect( block, rays[i], u, v, t, tri );
+               checkHit( tris, rays[i], (std::numeric_limits<float>::max)(), sided != 0, hit, u, v, t, tri );
+               num_hits[sided] += hit ? 1 : 0;
+            }
+         }
+      }
+      // back face culling makes a difference
+      CPPUNIT_ASSERT( num_hits[0] > 0 && num_hits[1] > num_hits[0] );
+   }
+
+   void TriBlockTest::testLineSeg()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillSoup( tris, 100 );
+      const gmtl::TriBlockf block( &tris[0], tris.size() );
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 300 );
+
+      unsigned int num_hits = 0;
+      for (std::size_t i = 0; i < rays.size(); ++i)
+      {
+         // segments ending before, inside and beyond the soup
+         const float len = 0.5f + 0.25f * float( i % 5 );
+         const gmtl::LineSegf seg( rays[i].getOrigin(), gmtl::Vec3f( rays[i].getDir() * len ) );
+         const gmtl::Rayf ray( seg.getOrigin(), seg.getDir() );
+         for (unsigned int sided = 0; sided < 2; ++sided)
+         {
+            float u, v, t;
+            unsigned int tri;
+            const bool hit = sided ? gmtl::intersectDoubleSided( block, seg, u, v, t, tri ) :
+                                     gmtl::intersect( block, seg, u, v, t, tri );
+            checkHit( tris, ray, 1.0f, sided != 0, hit, u, v, t, tri );
+            if (hit)
+            {
+               // the same hit as the triangle test of the segment
+               float tri_u, tri_v, tri_t;
+               CPPUNIT_ASSERT( sided ? gmtl::intersectDoubleSided( tris[tri], seg, tri_u, tri_v, tri_t ) :
+                                       gmtl::intersect( tris[tri], seg, tri_u, tri_v, tri_t ) );
+               CPPUNIT_ASSERT( isClose( tri_t, t, 1e-5f ) );
+               ++num_hits;
+            }
+         }
+      }
+      CPPUNIT_ASSERT( num_hits > 0 );
+
+      // too short to test
+      const gmtl::LineSegf point( gmtl::Point3f( 0, 0, 0 ), gmtl::Vec3f( 0, 0, 1e-5f ) );
+      float u, v, t;
+      unsigned int tri;
+      CPPUNIT_ASSERT( !gmtl::intersect( block, point, u, v, t, tri ) );
+      CPPUNIT_ASSERT( !gmtl::intersectDoubleSided( block, point, u, v, t, tri ) );
+   }
+
+   void TriBlockTest::testDouble()
+   {
+      std::vector<gmtl::Trid> tris;
+      fillSoup( tris, 77 );
+      const gmtl::TriBlockd block( &tris[0], tris.size() );
+      std::vector<gmtl::Rayd> rays;
+      fillRays( rays, 200 );
+
+      unsigned int num_hits = 0;
+      for (std::size_t i = 0; i < rays.size(); ++i)
+      {
+         double u = -7.0, v = -7.0, t = -7.0;
+         unsigned int tri = ~0u;
+         const bool hit = gmtl::intersectDoubleSided( block, rays[i], u, v, t, tri );
+         checkHit( tris, rays[i], (std::numeric_limits<double>::max)(), true, hit, u, v, t, tri );
+         num_hits += hit ? 1 : 0;
+
+         // the front face hit is never closer than the hit from either side
+         double front_u = -7.0, front_v = -7.0, front_t = -7.0;
+         unsigned int front_tri = ~0u;
+         const bool front_hit = gmtl::intersect( block, rays[i], front_u, front_v, front_t, front_tri );
+         checkHit( tris, rays[i], (std::numeric_limits<double>::max)(), false, front_hit,
+                   front_u, front_v, front_t, front_tri );
+         if (front_hit)
+         {
+            CPPUNIT_ASSERT( hit && front_t >= t );
+         }
+      }
+      CPPUNIT_ASSERT( num_hits > 0 );
+   }
+
+   void TriBlockMetricTest::testTimingRay()
+   {
+      std::vector<gmtl::Trif> tris;
+      fillSoup( tris, 4096 );
+      const gmtl::TriBlockf block( &tris[0], tris.size() );
+      std::vector<gmtl::Rayf> rays;
+      fillRays( rays, 256 );
+      unsigned int hits = 0;
+
+      // every triangle, one at a time
+      const long iters(4);
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < rays.size(); ++i)
+         {
+            float best_t = 0.0f;
+            bool hit = false;
+            for (std::size_t j = 0; j < tris.size(); ++j)
+            {
+               float u, v, t;
+               if (gmtl::intersect( tris[j], rays[i], u, v, t ) && (!hit || t < best_t))
+               {
+                  hit = true;
+                  best_t = t;
+               }
+            }
+            hits += hit ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("TriBlockTest/intersect(Tri, Ray) loop 4096 tris", iters * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < rays.size(); ++i)
+         {
+            float u, v, t;
+            unsigned int tri;
+            hits += gmtl::intersect( block, rays[i], u, v, t, tri ) ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("TriBlockTest/intersect(TriBlock, Ray) 4096 tris", iters * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < rays.size(); ++i)
+         {
+            float u, v, t;
+            unsigned int tri;
+            hits += gmtl::intersectDoubleSided( block, rays[i], u, v, t, tri ) ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("TriBlockTest/intersectDoubleSided(TriBlock, Ray) 4096 tris", iters * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( hits > 0 );
+   }
+
+   void TriBlockMetricTest::testTimingRayDouble()
+   {
+      std::vector<gmtl::Trid> tris;
+      fillSoup( tris, 4096 );
+      const gmtl::TriBlockd block( &tris[0], tris.size() );
+      std::vector<gmtl::Rayd> rays;
+      fillRays( rays, 256 );
+      unsigned int hits = 0;
+
+      const long iters(4);
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < rays.size(); ++i)
+         {
+            double best_t = 0.0;
+            bool hit = false;
+            for (std::size_t j = 0; j < tris.size(); ++j)
+            {
+               double u, v, t;
+               if (gmtl::intersect( tris[j], rays[i], u, v, t ) && (!hit || t < best_t))
+               {
+                  hit = true;
+                  best_t = t;
+               }
+            }
+            hits += hit ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("TriBlockTest/intersect(Trid, Rayd) loop 4096 tris", iters * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < rays.size(); ++i)
+         {
+            double u, v, t;
+            unsigned int tri;
+            hits += gmtl::intersect( block, rays[i], u, v, t, tri ) ? 1 : 0;
+         }
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("TriBlockTest/intersect(TriBlockd, Rayd) 4096 tris", iters * rays.size(), 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( hits > 0 );
+   }
+}
@@ -0,0 +1,52 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_TRI_BLOCK_TEST_H_
+#define _GMTL_TRI_BLOCK_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace gmtlTest
+{
+   /**
+    * Functionality tests for TriBlock and its ray queries.
+    */
+   class TriBlockTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(TriBlockTest);
+
+      CPPUNIT_TEST(testBlock);
+      CPPUNIT_TEST(testRay);
+      CPPUNIT_TEST(testLineSeg);
+      CPPUNIT_TEST(testDouble);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testBlock();
+      void testRay();
+      void testLineSeg();
+      void testDouble();
+   };
+
+   /**
+    * Metric tests.
+    */
+   class TriBlockMetricTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(TriBlockMetricTest);
+
+      CPPUNIT_TEST(testTimingRay);
+      CPPUNIT_TEST(testTimingRayDouble);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testTimingRay();
+      void testTimingRayDouble();
+   };
+}
+
+#endif
@@ -0,0 +1,350 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#include "Vec3ArrayTest.h"
+#include "../Suites.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/MetricRegistry.h>
+
+#include <vector>
+#include <gmtl/Vec3Array.h>
+#include <gmtl/Vec3ArrayOps.h>
+#include <gmtl/VecOps.h>
+
+namespace gmtlTest
+{
+   CPPUNIT_TEST_SUITE_REGISTRATION(Vec3ArrayTest);
+   CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(Vec3ArrayMetricTest, Suites::metric());
+
+   /** Fills vecs with size non trivial vectors, including a zero vector. */
+   template<class T>
+   static void fillVecs( std::vector< gmtl::Vec<T, 3> >& vecs, const std::size_t size, const T offset )
+   {
+      vecs.resize( size );
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         const T f = T( i ) + offset;
+         vecs[i].set( T(0.7) * f - T(3.1), T(1.3) - T(0.45) * f, T(0.11) * f * f - T(2.0) );
+      }
+      if (size > 5)
+      {
+         vecs[5].set( T(0), T(0), T(0) );
+      }
+   }
+
+   /**
+    * Compares a batch result with the VecOps.h result.  Either of them may
+    * be contracted into FMAs by the compiler (-ffp-contract), so they are
+    * compared relative to scale, a bound on the magnitude of the products
+    * that went into them.
+    */
+   template<class T>
+   static bool isClose( const T a, const T b, const T scale )
+   {
+      const T eps = (sizeof( T ) == sizeof( float )) ? T(1e-6) : T(1e-14);
+      return gmtl::Math::abs( a - b ) <= eps * scale;
+   }
+
+   /**
+    * Runs all the batch ops on views of a and b, and checks each result
+    * against the VecOps.h function applied to one vector.  With packed true
+    * the views are of Vec3Arrays (the SIMD path for float), otherwise of the
+    * std::vectors (strided).
+    */
+   template<class T>
+   static void checkBatchOps( const std::size_t size, const bool packed )
+   {
+      typedef gmtl::Vec<T, 3> VecType;
+      std::vector<VecType> a, b;
+      fillVecs( a, size, T(0.25) );
+      fillVecs( b, size, T(-1.5) );
+      const std::vector<VecType>& ca = a;
+      const std::vector<VecType>& cb = b;
+      const gmtl::Vec3Array<T> sa( a ), sb( b );
+      const gmtl::Vec3ArrayView<const T> va = packed ? makeView( sa ) : makeView( ca );
+      const gmtl::Vec3ArrayView<const T> vb = packed ? makeView( sb ) : makeView( cb );
+
+      gmtl::Vec3Array<T> sr( size );
+      std::vector<VecType> r( size );
+      const gmtl::Vec3ArrayView<T> vr = packed ? makeView( sr ) : makeView( r );
+      std::vector<T> s( size + 1 ), s2( size + 1 );
+      VecType expected;
+      T expected_s;
+
+      std::vector<T> scale( size );
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         scale[i] = (T(1) + gmtl::length( a[i] )) * (T(1) + gmtl::length( b[i] ));
+      }
+
+#define CHECK_VIEW( view, i, exp, sc ) \
+      CPPUNIT_ASSERT( isClose( view.x( i ), exp[0], sc ) && \
+                      isClose( view.y( i ), exp[1], sc ) && \
+                      isClose( view.z( i ), exp[2], sc ) )
+#define CHECK_RESULT( i, exp ) CHECK_VIEW( vr, i, exp, scale[i] )
+
+      gmtl::add( vr, va, vb );
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         expected = a[i] + b[i];
+         CHECK_RESULT( i, expected );
+      }
+
+      gmtl::sub( vr, va, vb );
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         expected = a[i] - b[i];
+         CHECK_RESULT( i, expected );
+      }
+
+      gmtl::cross( vr, va, vb );
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         gmtl::cross( expected, a[i], b[i] );
+         CHECK_RESULT( i, expected );
+      }
+
+      gmtl::lerp( vr, T(0.3), va, vb );
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         gmtl::lerp( expected, T(0.3), a[i], b[i] );
+         CHECK_RESULT( i, expected );
+      }
+
+      gmtl::dot( &s[0], va, vb );
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         CPPUNIT_ASSERT( isClose( s[i], gmtl::dot( a[i], b[i] ), scale[i] ) );
+      }
+
+      gmtl::length( &s[0], va );
+      gmtl::lengthSquared( &s2[0], va );
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         CPPUNIT_ASSERT( isClose( s[i], gmtl::length( a[i] ), scale[i] ) );
+         CPPUNIT_ASSERT( isClose( s2[i], gmtl::lengthSquared( a[i] ), scale[i] ) );
+      }
+
+      // reflect about unit normals
+      std::vector<VecType> n( b );
+      gmtl::Vec3Array<T> sn( n );
+      const gmtl::Vec3ArrayView<T> vn = packed ? makeView( sn ) : makeView( n );
+      gmtl::normalize( vn, &s[0] );
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         expected = b[i];
+         expected_s = gmtl::normalize( expected );
+         CHECK_VIEW( vn, i, expected, T(1) );
+         CPPUNIT_ASSERT( isClose( s[i], expected_s, scale[i] ) );
+      }
+
+      gmtl::reflect( vr, va, vn );
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         const VecType normal( vn.x( i ), vn.y( i ), vn.z( i ) );
+         gmtl::reflect( expected, a[i], normal );
+         CHECK_RESULT( i, expected );
+      }
+
+      // in place, the result is also an input
+      gmtl::Vec3Array<T> sa2( a );
+      std::vector<VecType> a2( a );
+      const gmtl::Vec3ArrayView<T> va2 = packed ? makeView( sa2 ) : makeView( a2 );
+      gmtl::cross( va2, va2, vb );
+      gmtl::add( va2, va2, va2 );
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         gmtl::cross( expected, a[i], b[i] );
+         expected += expected;
+         CHECK_VIEW( va2, i, expected, scale[i] );
+      }
+#undef CHECK_RESULT
+#undef CHECK_VIEW
+   }
+
+   void Vec3ArrayTest::testContainer()
+   {
+      gmtl::Vec3fArray arr;
+      CPPUNIT_ASSERT( arr.empty() && arr.size() == 0 );
+
+      arr.push_back( gmtl::Vec3f( 1.0f, 2.0f, 3.0f ) );
+      arr.push_back( gmtl::Vec3f( 4.0f, 5.0f, 6.0f ) );
+      CPPUNIT_ASSERT( arr.size() == 2 );
+      CPPUNIT_ASSERT( arr.mX[1] == 4.0f && arr.mY[1] == 5.0f && arr.mZ[1] == 6.0f );
+      CPPUNIT_ASSERT( arr.get( 0 ) == gmtl::Vec3f( 1.0f, 2.0f, 3.0f ) );
+      arr.set( 0, gmtl::Vec3f( 7.0f, 8.0f, 9.0f ) );
+      CPPUNIT_ASSERT( arr.get( 0 ) == gmtl::Vec3f( 7.0f, 8.0f, 9.0f ) );
+
+      arr.resize( 3 );
+      CPPUNIT_ASSERT( arr.get( 2 ) == gmtl::Vec3f( 0.0f, 0.0f, 0.0f ) );
+      CPPUNIT_ASSERT( gmtl::Vec3fArray( 4 ).get( 3 ) == gmtl::Vec3f( 0.0f, 0.0f, 0.0f ) );
+
+      // conversion from and to an array of structures
+      std::vector<gmtl::Vec3f> vecs;
+      fillVecs( vecs, 9, 0.0f );
+      gmtl::Vec3fArray from_vecs( vecs );
+      CPPUNIT_ASSERT( from_vecs.size() == vecs.size() );
+      for (std::size_t i = 0; i < vecs.size(); ++i)
+      {
+         CPPUNIT_ASSERT( from_vecs.get( i ) == vecs[i] );
+      }
+      std::vector<gmtl::Vec3f> back;
+      from_vecs.copyTo( back );
+      CPPUNIT_ASSERT( back == vecs );
+
+      arr.clear();
+      CPPUNIT_ASSERT( arr.empty() );
+   }
+
+   void Vec3ArrayTest::testViews()
+   {
+      gmtl::Vec3fArray arr( 3 );
+      gmtl::Vec3ArrayView<float> view = makeView( arr );
+      CPPUNIT_ASSERT( view.size() == 3 && view.isPacked() );
+      view.y( 1 ) = 2.5f;
+      CPPUNIT_ASSERT( arr.mY[1] == 2.5f );
+
+      const gmtl::Vec3fArray& const_arr = arr;
+      gmtl::Vec3ArrayView<const float> const_view = makeView( const_arr );
+      CPPUNIT_ASSERT( const_view.y( 1 ) == 2.5f );
+      const_view = view;
+      CPPUNIT_ASSERT( const_view.mX == &arr.mX[0] );
+
+      // a view of an array of structures reads and writes it in place
+      std::vector<gmtl::Vec3f> vecs( 4 );
+      gmtl::Vec3ArrayView<float> aos = makeView( vecs );
+      CPPUNIT_ASSERT( aos.size() == 4 && !aos.isPacked() && aos.mStride == 3 );
+      aos.x( 2 ) = 1.0f;
+      aos.z( 3 ) = 2.0f;
+      CPPUNIT_ASSERT( vecs[2] == gmtl::Vec3f( 1.0f, 0.0f, 0.0f ) );
+      CPPUNIT_ASSERT( vecs[3] == gmtl::Vec3f( 0.0f, 0.0f, 2.0f ) );
+
+      // batch results written straight into a std::vector<Vec3f>
+      gmtl::Vec3fArray a( 4 ), b( 4 );
+      for (unsigned i = 0; i < 4; ++i)
+      {
+         a.set( i, gmtl::Vec3f( 1.0f, 0.0f, 0.0f ) );
+         b.set( i, gmtl::Vec3f( 0.0f, float( i ), 0.0f ) );
+      }
+      gmtl::cross( makeView( vecs ), makeView( a ), makeView( b ) );
+      for (unsigned i = 0; i < 4; ++i)
+      {
+         CPPUNIT_ASSERT( vecs[i] == gmtl::Vec3f( 0.0f, 0.0f, float( i ) ) );
+      }
+
+      // empty views
+      std::vector<gmtl::Vec3f> none;
+      CPPUNIT_ASSERT( makeView( none ).size() == 0 );
+      CPPUNIT_ASSERT( makeView( gmtl::Vec3fArray() ).size() == 0 );
+      gmtl::normalize( makeView( none ) );
+   }
+
+   void Vec3ArrayTest::testBatchOps()
+   {
+      // all the sizes up to three SIMD blocks plus a tail
+      for (std::size_t size = 0; size < 15; ++size)
+      {
+         checkBatchOps<float>( size, true );
+      }
+      checkBatchOps<float>( 1001, true );
+   }
+
+   void Vec3ArrayTest::testBatchOpsStrided()
+   {
+      for (std::size_t size = 0; size < 15; ++size)
+      {
+         checkBatchOps<float>( size, false );
+      }
+
+      // mixed layouts
+      std::vector<gmtl::Vec3f> a, b;
+      fillVecs( a, 10, 0.5f );
+      fillVecs( b, 10, 2.5f );
+      gmtl::Vec3fArray sb( b ), result( 10 );
+      gmtl::add( makeView( result ), makeView( a ), makeView( sb ) );
+      for (unsigned i = 0; i < 10; ++i)
+      {
+         CPPUNIT_ASSERT( result.get( i ) == gmtl::Vec3f( a[i] + b[i] ) );
+      }
+   }
+
+   void Vec3ArrayTest::testBatchOpsDouble()
+   {
+      for (std::size_t size = 0; size < 9; ++size)
+      {
+         checkBatchOps<double>( size, true );
+         checkBatchOps<double>( size, false );
+      }
+   }
+
+   void Vec3ArrayMetricTest::testTimingNormalize()
+   {
+      const std::size_t count(4096);
+      const long iters(100);
+      std::vector<gmtl::Vec3f> vecs;
+      fillVecs( vecs, count, 1.0f );
+      std::vector<gmtl::Vec3f> work( vecs );
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            gmtl::normalize( work[i] );
+         }
+         work[iter % count] = vecs[iter % count];
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("Vec3ArrayTest/normalize(std::vector<Vec3f>)", iters * count, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      gmtl::Vec3fArray soa( vecs );
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::normalize( makeView( soa ) );
+         soa.set( iter % count, vecs[iter % count] );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("Vec3ArrayTest/normalize(Vec3fArray)", iters * count, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( soa.get( 7 ) == work[7] );
+   }
+
+   void Vec3ArrayMetricTest::testTimingCrossLerp()
+   {
+      const std::size_t count(4096);
+      const long iters(100);
+      std::vector<gmtl::Vec3f> a, b, r( count );
+      fillVecs( a, count, 1.0f );
+      fillVecs( b, count, -7.0f );
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            gmtl::cross( r[i], a[i], b[i] );
+            gmtl::lerp( r[i], 0.25f, r[i], a[i] );
+         }
+         a[iter % count] = r[iter % count];
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("Vec3ArrayTest/cross,lerp(std::vector<Vec3f>)", iters * count, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      fillVecs( a, count, 1.0f );
+      gmtl::Vec3fArray sa( a ), sb( b ), sr( count );
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::cross( makeView( sr ), makeView( sa ), makeView( sb ) );
+         gmtl::lerp( makeView( sr ), 0.25f, makeView( sr ), makeView( sa ) );
+         sa.set( iter % count, sr.get( iter % count ) );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("Vec3ArrayTest/cross,lerp(Vec3fArray)", iters * count, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( sr.get( 11 ) == r[11] );
+   }
+}
@@ -0,0 +1,54 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_VEC3_ARRAY_TEST_H_
+#define _GMTL_VEC3_ARRAY_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace gmtlTest
+{
+   /**
+    * Functionality tests for Vec3Array, Vec3ArrayView and the batch ops.
+    */
+   class Vec3ArrayTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(Vec3ArrayTest);
+
+      CPPUNIT_TEST(testContainer);
+      CPPUNIT_TEST(testViews);
+      CPPUNIT_TEST(testBatchOps);
+      CPPUNIT_TEST(testBatchOpsStrided);
+      CPPUNIT_TEST(testBatchOpsDouble);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testContainer();
+      void testViews();
+      void testBatchOps();
+      void testBatchOpsStrided();
+      void testBatchOpsDouble();
+   };
+
+   /**
+    * Metric tests.
+    */
+   class Vec3ArrayMetricTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(Vec3ArrayMetricTest);
+
+      CPPUNIT_TEST(testTimingNormalize);
+      CPPUNIT_TEST(testTimingCrossLerp);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testTimingNormalize();
+      void testTimingCrossLerp();
+   };
+}
+
+#endif
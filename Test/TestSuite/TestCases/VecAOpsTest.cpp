@@ -0,0 +1,314 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#include "VecAOpsTest.h"
+#include "../Suites.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/MetricRegistry.h>
+
+#include <cstddef>
+#include <gmtl/VecA.h>
+#include <gmtl/VecAOps.h>
+#include <gmtl/QuatA.h>
+#include <gmtl/QuatAOps.h>
+#include <gmtl/Generate.h>
+
+namespace gmtlTest
+{
+   CPPUNIT_TEST_SUITE_REGISTRATION(VecAOpsTest);
+   CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(VecAOpsMetricTest, Suites::metric());
+
+   static bool isAligned( const void* p )
+   {
+      return (reinterpret_cast<std::size_t>( p ) & 15) == 0;
+   }
+
+   void VecAOpsTest::testLayout()
+   {
+      CPPUNIT_ASSERT( sizeof( gmtl::Vec3fA ) == 16 );
+      CPPUNIT_ASSERT( sizeof( gmtl::Vec4fA ) == sizeof( gmtl::Vec4f ) );
+      CPPUNIT_ASSERT( sizeof( gmtl::QuatfA ) == sizeof( gmtl::Quatf ) );
+
+      gmtl::Vec3fA v3[3];
+      gmtl::Vec4fA v4[3];
+      gmtl::QuatfA q[3];
+      for (unsigned i = 0; i < 3; ++i)
+      {
+         CPPUNIT_ASSERT( isAligned( &v3[i] ) );
+         CPPUNIT_ASSERT( isAligned( &v4[i] ) );
+         CPPUNIT_ASSERT( isAligned( &q[i] ) );
+      }
+
+      // the components are where a Vec3f has them, followed by the pad
+      gmtl::Vec3fA a( 1.0f, 2.0f, 3.0f );
+      const gmtl::Vec3f& a_ref = a;
+      CPPUNIT_ASSERT( static_cast<const void*>( &a_ref ) == static_cast<const void*>( &a ) );
+      CPPUNIT_ASSERT( &a.mPad == a.getData() + 3 );
+      CPPUNIT_ASSERT( a.mPad == 0.0f );
+      CPPUNIT_ASSERT( gmtl::Vec3fA().mPad == 0.0f );
+
+      // arrays of Vec4fA and QuatfA can be read as arrays of Vec4f and Quatf
+      v4[1].set( 1.0f, 2.0f, 3.0f, 4.0f );
+      q[2].set( 0.0f, 0.6f, 0.8f, 0.0f );
+      CPPUNIT_ASSERT( reinterpret_cast<gmtl::Vec4f*>( v4 )[1] == gmtl::Vec4f( 1.0f, 2.0f, 3.0f, 4.0f ) );
+      CPPUNIT_ASSERT( reinterpret_cast<gmtl::Quatf*>( q )[2] == gmtl::Quatf( 0.0f, 0.6f, 0.8f, 0.0f ) );
+
+      // conversions
+      const gmtl::Vec3f b( 4.0f, 5.0f, 6.0f );
+      gmtl::Vec3fA c( b );
+      CPPUNIT_ASSERT( c == b );
+      c = a + b;
+      CPPUNIT_ASSERT( c == gmtl::Vec3f( 5.0f, 7.0f, 9.0f ) );
+      const gmtl::QuatfA qa( gmtl::Quatf( 1.0f, 0.0f, 0.0f, 0.0f ) );
+      CPPUNIT_ASSERT( qa == gmtl::Quatf( 1.0f, 0.0f, 0.0f, 0.0f ) );
+   }
+
+   void VecAOpsTest::testVecOps()
+   {
+      const gmtl::Vec3f a( 1.5f, -2.25f, 3.1f ), b( -0.7f, 4.3f, 2.9f );
+      const gmtl::Vec3fA aa( a ), ba( b );
+      const gmtl::Vec4f c( 1.5f, -2.25f, 3.1f, 0.3f ), d( -0.7f, 4.3f, 2.9f, 5.1f );
+      const gmtl::Vec4fA ca( c ), da( d );
+
+      // the templates may be compiled with FMAs (-ffp-contract), so sums
+      // of products are compared with a tolerance
+      const float eps = 1e-5f;
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( gmtl::dot( aa, ba ), gmtl::dot( a, b ), eps ) );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( gmtl::dot( ca, da ), gmtl::dot( c, d ), eps ) );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( gmtl::lengthSquared( aa ), gmtl::lengthSquared( a ), eps ) );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( gmtl::lengthSquared( ca ), gmtl::lengthSquared( c ), eps ) );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( gmtl::length( aa ), gmtl::length( a ), eps ) );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( gmtl::length( ca ), gmtl::length( c ), eps ) );
+
+      gmtl::Vec3f n3( a );
+      gmtl::Vec3fA n3a( aa );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( gmtl::normalize( n3a ), gmtl::normalize( n3 ), eps ) );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Vec3f( n3a ), n3, eps ) );
+      CPPUNIT_ASSERT( gmtl::isNormalized( n3a ) );
+      gmtl::Vec4f n4( c );
+      gmtl::Vec4fA n4a( ca );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( gmtl::normalize( n4a ), gmtl::normalize( n4 ), eps ) );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Vec4f( n4a ), n4, eps ) );
+      gmtl::Vec3fA zero;
+      CPPUNIT_ASSERT( gmtl::normalize( zero ) == 0.0f );
+
+      gmtl::Vec3f cr;
+      gmtl::Vec3fA cra;
+      gmtl::cross( cr, a, b );
+      gmtl::cross( cra, aa, ba );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Vec3f( cra ), cr, eps ) );
+      CPPUNIT_ASSERT( cra.mPad == 0.0f );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Vec3f( aa ^ ba ), cr, eps ) );
+
+      gmtl::Vec3fA s( aa );
+      s += ba;
+      CPPUNIT_ASSERT( s == gmtl::Vec3f( a + b ) );
+      s -= aa;
+      CPPUNIT_ASSERT( s == gmtl::Vec3f( (a + b) - a ) );
+      s *= 2.0f;
+      CPPUNIT_ASSERT( s == gmtl::Vec3f( ((a + b) - a) * 2.0f ) );
+      CPPUNIT_ASSERT( s.mPad == 0.0f );
+      gmtl::Vec4fA s4( ca );
+      s4 += da;
+      s4 -= ca;
+      s4 *= 0.5f;
+      CPPUNIT_ASSERT( s4 == gmtl::Vec4f( ((c + d) - c) * 0.5f ) );
+
+      // an aligned vector still works with the templates
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( gmtl::dot( aa, b ), gmtl::dot( a, b ), eps ) );
+   }
+
+   void VecAOpsTest::testVecXform()
+   {
+      gmtl::Matrix44f m;
+      m.set( 0.5f, 1.0f, 2.0f, 3.0f,
+             4.0f, -1.5f, 6.0f, 7.0f,
+             8.0f, 9.0f, 0.25f, 11.0f,
+             0.0f, 0.0f, 0.0f, 1.0f );
+      const gmtl::Vec4f v4( 1.5f, -2.0f, 3.25f, 1.0f );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Vec4f( m * gmtl::Vec4fA( v4 ) ), m * v4, 1e-6f ) );
+
+      const gmtl::Vec3f v3( 1.5f, -2.0f, 3.25f );
+      gmtl::Vec3fA r3( m * gmtl::Vec3fA( v3 ) );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Vec3f( r3 ), m * v3, 1e-6f ) );
+      CPPUNIT_ASSERT( r3.mPad == 0.0f );
+
+      // projective matrix, w != 0 for a vector
+      m( 3, 0 ) = 0.5f;
+      r3 = m * gmtl::Vec3fA( v3 );
+      CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Vec3f( r3 ), m * v3, 1e-5f ) );
+   }
+
+   void VecAOpsTest::testQuatOps()
+   {
+      const gmtl::Quatf q1( 0.1f, -0.5f, 0.3f, 0.8f ), q2( -0.6f, 0.2f, 0.7f, 0.1f );
+      const gmtl::QuatfA q1a( q1 ), q2a( q2 );
+
+      const float eps = 1e-6f;
+      gmtl::Quatf r;
+      gmtl::QuatfA ra;
+      gmtl::mult( r, q1, q2 );
+      gmtl::mult( ra, q1a, q2a );
+      CPPUNIT_ASSERT( gmtl::isEqual( ra, r, eps ) );
+      CPPUNIT_ASSERT( gmtl::isEqual( q2a * q1a, q2 * q1, eps ) );
+      ra = q1a;
+      ra *= q2a;
+      CPPUNIT_ASSERT( gmtl::isEqual( ra, r, eps ) );
+
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( gmtl::dot( q1a, q2a ), gmtl::dot( q1, q2 ), eps ) );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( gmtl::lengthSquared( q1a ), gmtl::lengthSquared( q1 ), eps ) );
+      CPPUNIT_ASSERT( gmtl::Math::isEqual( gmtl::length( q1a ), gmtl::length( q1 ), eps ) );
+
+      r = q1;
+      ra = q1a;
+      gmtl::normalize( r );
+      gmtl::normalize( ra );
+      CPPUNIT_ASSERT( gmtl::isEqual( ra, r, eps ) );
+      gmtl::conj( r );
+      gmtl::conj( ra );
+      CPPUNIT_ASSERT( gmtl::isEqual( ra, r, eps ) );
+
+      // the templates still work on the aligned type
+      gmtl::invert( r );
+      gmtl::invert( ra );
+      CPPUNIT_ASSERT( gmtl::isEqual( ra, r, eps ) );
+   }
+
+   void VecAOpsTest::testQuatXform()
+   {
+      const float eps = 1e-5f;
+      gmtl::Quatf q;
+      for (unsigned i = 0; i < 20; ++i)
+      {
+         const float angle = 0.37f * float( i ) - 3.0f;
+         gmtl::Vec3f axis( 0.3f, -0.4f + 0.05f * float( i ), 0.8f );
+         gmtl::normalize( axis );
+         gmtl::set( q, gmtl::AxisAnglef( angle, axis ) );
+
+         const gmtl::Vec3f v( 1.5f - float( i ), 2.0f, -3.25f );
+         const gmtl::Vec3f expected = q * v;
+         const gmtl::Vec3fA result( gmtl::QuatfA( q ) * gmtl::Vec3fA( v ) );
+         CPPUNIT_ASSERT( gmtl::isEqual( gmtl::Vec3f( result ), expected, eps * gmtl::length( v ) ) );
+         CPPUNIT_ASSERT( result.mPad == 0.0f );
+      }
+   }
+
+   void VecAOpsMetricTest::testTimingNormalizeCross()
+   {
+      const long iters(100000);
+
+      gmtl::Vec3f a( 1.0f, 2.0f, 3.0f ), b( 0.5f, -1.0f, 0.25f ), c;
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::cross( c, a, b );
+         gmtl::normalize( c );
+         b = a;
+         a = c;
+         a[0] += gmtl::dot( b, c );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("VecAOpsTest/cross,normalize,dot(Vec3f)", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      CPPUNIT_ASSERT( c[0] != 1234.5f );
+
+      gmtl::Vec3fA aa( 1.0f, 2.0f, 3.0f ), ba( 0.5f, -1.0f, 0.25f ), ca;
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::cross( ca, aa, ba );
+         gmtl::normalize( ca );
+         ba = aa;
+         aa = ca;
+         aa[0] += gmtl::dot( ba, ca );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("VecAOpsTest/cross,normalize,dot(Vec3fA)", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      CPPUNIT_ASSERT( ca[0] != 1234.5f );
+   }
+
+   void VecAOpsMetricTest::testTimingMatrixXform()
+   {
+      const long iters(100000);
+      gmtl::Matrix44f m;
+      gmtl::setRot( m, gmtl::AxisAnglef( 0.1f, 0.0f, 0.6f, 0.8f ) );
+      gmtl::setTrans( m, gmtl::Vec3f( 0.1f, 0.2f, 0.3f ) );
+
+      gmtl::Vec4f v( 1.0f, 2.0f, 3.0f, 1.0f ), r;
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::xform( r, m, v );
+         v = r;
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("VecAOpsTest/xform(Vec4f,mat44f,Vec4f)", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      CPPUNIT_ASSERT( r[0] != 1234.5f );
+
+      gmtl::Vec4fA va( 1.0f, 2.0f, 3.0f, 1.0f ), ra;
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::xform( ra, m, va );
+         va = ra;
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("VecAOpsTest/xform(Vec4fA,mat44f,Vec4fA)", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      CPPUNIT_ASSERT( ra[0] != 1234.5f );
+   }
+
+   void VecAOpsMetricTest::testTimingQuatMult()
+   {
+      const long iters(100000);
+      const gmtl::Quatf q2( 0.0f, 0.0499792f, 0.0f, 0.99875f );
+
+      gmtl::Quatf q4;
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::mult( q4, q2, q4 );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("VecAOpsTest/mult(Quatf,Quatf)", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      CPPUNIT_ASSERT( q4[2] != 1234.5f );
+
+      const gmtl::QuatfA q2a( q2 );
+      gmtl::QuatfA q4a;
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::mult( q4a, q2a, q4a );
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("VecAOpsTest/mult(QuatfA,QuatfA)", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      CPPUNIT_ASSERT( q4a[2] != 1234.5f );
+   }
+
+   void VecAOpsMetricTest::testTimingQuatXform()
+   {
+      const long iters(100000);
+      const gmtl::Quatf q( 0.0f, 0.0499792f, 0.0f, 0.99875f );
+
+      gmtl::Vec3f v( 1.0f, 2.0f, 3.0f );
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         v = q * v;
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("VecAOpsTest/xform(Vec3f,Quatf,Vec3f)", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      CPPUNIT_ASSERT( v[0] != 1234.5f );
+
+      const gmtl::QuatfA qa( q );
+      gmtl::Vec3fA va( 1.0f, 2.0f, 3.0f );
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         va = qa * va;
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("VecAOpsTest/xform(Vec3fA,QuatfA,Vec3fA)", iters, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+      CPPUNIT_ASSERT( va[0] != 1234.5f );
+   }
+}
@@ -0,0 +1,58 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_VECA_OPS_TEST_H_
+#define _GMTL_VECA_OPS_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace gmtlTest
+{
+   /**
+    * Functionality tests for the aligned Vec3fA, Vec4fA and QuatfA types.
+    */
+   class VecAOpsTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(VecAOpsTest);
+
+      CPPUNIT_TEST(testLayout);
+      CPPUNIT_TEST(testVecOps);
+      CPPUNIT_TEST(testVecXform);
+      CPPUNIT_TEST(testQuatOps);
+      CPPUNIT_TEST(testQuatXform);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testLayout();
+      void testVecOps();
+      void testVecXform();
+      void testQuatOps();
+      void testQuatXform();
+   };
+
+   /**
+    * Metric tests.
+    */
+   class VecAOpsMetricTest : public CppUnit::TestFixture
+   {
+      CPPUNIT_TEST_SUITE(VecAOpsMetricTest);
+
+      CPPUNIT_TEST(testTimingNormalizeCross);
+      CPPUNIT_TEST(testTimingMatrixXform);
+      CPPUNIT_TEST(testTimingQuatMult);
+      CPPUNIT_TEST(testTimingQuatXform);
+
+      CPPUNIT_TEST_SUITE_END();
+
+   public:
+      void testTimingNormalizeCross();
+      void testTimingMatrixXform();
+      void testTimingQuatMult();
+      void testTimingQuatXform();
+   };
+}
+
+#endif
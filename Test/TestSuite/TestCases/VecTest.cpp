@@ -201,6 +201,17 @@ namespace gmtlTest
       CPPUNIT_ASSERT( use_value > 0.0f );
    }
 
+   void VecTest::testNoInitCreation()
+   {
+      gmtl::Vec<double, 3> vec( gmtl::NO_INIT );
+      vec.set( 1.0, 2.0, 3.0 );
+      CPPUNIT_ASSERT( vec == gmtl::Vec3d( 1.0, 2.0, 3.0 ) );
+
+      gmtl::Point<float, 4> pt( gmtl::NO_INIT );
+      pt.set( 1.0f, 2.0f, 3.0f, 4.0f );
+      CPPUNIT_ASSERT( pt == gmtl::Point4f( 1.0f, 2.0f, 3.0f, 4.0f ) );
+   }
+
    void VecTest::testCopyConstruct()
    {
       gmtl::Vec<double, 3> test_vec;
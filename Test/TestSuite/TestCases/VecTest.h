@@ -20,6 +20,7 @@ namespace gmtlTest
       CPPUNIT_TEST(testVecMeta);
 
       CPPUNIT_TEST(testCreation);
+      CPPUNIT_TEST(testNoInitCreation);
       CPPUNIT_TEST(testCopyConstruct);
       CPPUNIT_TEST(testConstructors);
       CPPUNIT_TEST(testSet);
@@ -52,6 +53,7 @@ namespace gmtlTest
       void testVecMeta();
 
       void testCreation();
+      void testNoInitCreation();
       void testCopyConstruct();
       void testConstructors();
       void testSet();
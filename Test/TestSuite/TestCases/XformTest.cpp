@@ -13,6 +13,8 @@
 #include <gmtl/LineSegOps.h>
 #include <gmtl/RayOps.h>
 
+#include <vector>
+
 namespace gmtlTest
 {
    CPPUNIT_TEST_SUITE_REGISTRATION(XformTest);
@@ -117,6 +119,52 @@ namespace gmtlTest
    }
 
    /** @todo Get testTimingXformMatVecComplete to work outside gcc */
+   void XformMetricTest::testTimingXformQuatVec3Batch()
+   {
+      const std::size_t count(4096);
+      const long iters(50);
+      std::vector<gmtl::Vec3f> vecs( count ), result( count );
+      std::vector<gmtl::Quatf> rots( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         vecs[i].set( float( i ) * 0.01f, 1.0f - float( i % 17 ), float( i % 5 ) * 0.3f );
+         gmtl::set( rots[i], gmtl::AxisAnglef( float( i ) * 0.001f, gmtl::Vec3f( 0.0f, 0.6f, 0.8f ) ) );
+      }
+      const gmtl::Quatf rot( rots[1000] );
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            gmtl::xform( result[i], rot, vecs[i] );
+         }
+         vecs[iter] = result[iter];
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("XformTest/xform(vec3f,quatf,vec3f) loop", iters * count, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::xformVecs( &result[0], rot, &vecs[0], count );
+         vecs[iter] = result[iter];
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("XformTest/xformVecs(vec3f,quatf,vec3f)", iters * count, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::xformVecs( &result[0], &rots[0], &vecs[0], count );
+         vecs[iter] = result[iter];
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("XformTest/xformVecs(vec3f,quatf[],vec3f) per vector quats", iters * count, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( result[1][0] != 1234.5f );
+   }
+
    void XformMetricTest::testTimingXformMatVecComplete()
    {
 // mips pro and VC7 can't handle template template params
@@ -203,6 +251,54 @@ namespace gmtlTest
 #endif // __GNUC__
    }
 
+   void XformMetricTest::testTimingXformMatPointBatch()
+   {
+      const std::size_t count(4096);
+      const long iters(50);
+      std::vector<gmtl::Point3f> points( count ), result( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         points[i].set( float( i ) * 0.01f, 1.0f - float( i % 17 ), float( i % 5 ) * 0.3f );
+      }
+      gmtl::Matrix44f mat;
+      gmtl::setRot( mat, gmtl::AxisAnglef( 0.7f, gmtl::makeNormal( gmtl::Vec3f( 1.0f, 2.0f, 3.0f ) ) ) );
+      gmtl::setTrans( mat, gmtl::Vec3f( 1.0f, -2.0f, 0.5f ) );
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            gmtl::xform( result[i], mat, points[i] );
+         }
+         points[iter] = result[iter];
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("XformTest/xform(pnt3f,mat44f,pnt3f) loop", iters * count, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::xformPoints( &result[0], mat, &points[0], count );
+         points[iter] = result[iter];
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("XformTest/xformPoints(pnt3f,mat44f affine)", iters * count, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      // the same matrix, without the state saying it is affine
+      mat.mState = gmtl::Matrix44f::FULL;
+      CPPUNIT_METRIC_START_TIMING();
+      for (long iter = 0; iter < iters; ++iter)
+      {
+         gmtl::xformPoints( &result[0], mat, &points[0], count );
+         points[iter] = result[iter];
+      }
+      CPPUNIT_METRIC_STOP_TIMING();
+      CPPUNIT_ASSERT_METRIC_TIMING_LE("XformTest/xformPoints(pnt3f,mat44f full)", iters * count, 0.075f, 0.1f);  // warn at 7.5%, error at 10%
+
+      CPPUNIT_ASSERT( result[1][0] != 1234.5f );
+   }
+
    void XformTest::testQuatVecXform()
    {
       {
@@ -922,4 +1018,250 @@ namespace gmtlTest
          CPPUNIT_ASSERT( gmtl::isEqual( expected2, result4, eps ) );
       }
    }
+
+   /** Compares a batch xform result with the xform() result.  Either may
+    *  be contracted into FMAs by the compiler (-ffp-contract), so they only
+    *  have to agree to a few ulps of the larger of 1 and each element.
+    */
+   template<typename T, unsigned SIZE>
+   static bool isClose( const gmtl::VecBase<T, SIZE>& a, const gmtl::VecBase<T, SIZE>& b )
+   {
+      const T eps = (sizeof( T ) == sizeof( float )) ? T( 1e-6 ) : T( 1e-14 );
+      for (unsigned i = 0; i < SIZE; ++i)
+      {
+         if (gmtl::Math::abs( a[i] - b[i] ) > eps * gmtl::Math::Max( T( 1 ), gmtl::Math::abs( b[i] ) ))
+            return false;
+      }
+      return true;
+   }
+
+   /** Checks xformPoints()/xformVecs() against xform() on each element. */
+   template<typename T, unsigned ROWS, unsigned COLS, unsigned SIZE>
+   static void checkBatchXform( const gmtl::Matrix<T, ROWS, COLS>& mat )
+   {
+      const std::size_t count = 23;
+      std::vector< gmtl::Point<T, SIZE> > points( count ), point_result( count );
+      std::vector< gmtl::Vec<T, SIZE> > vecs( count ), vec_result( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         for (unsigned j = 0; j < SIZE; ++j)
+         {
+            points[i][j] = T( 0.37 ) * T( i + 1 ) - T( 1.1 ) * T( j ) + T( 0.25 );
+            vecs[i][j] = T( 2.5 ) - T( 0.41 ) * T( i ) * T( j + 1 );
+         }
+      }
+
+      gmtl::xformPoints( &point_result[0], mat, &points[0], count );
+      gmtl::xformVecs( &vec_result[0], mat, &vecs[0], count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         gmtl::Point<T, SIZE> expected_point;
+         gmtl::Vec<T, SIZE> expected_vec;
+         gmtl::xform( expected_point, mat, points[i] );
+         gmtl::xform( expected_vec, mat, vecs[i] );
+         CPPUNIT_ASSERT( isClose( point_result[i], expected_point ) );
+         CPPUNIT_ASSERT( isClose( vec_result[i], expected_vec ) );
+      }
+
+      // in place
+      gmtl::xformPoints( &points[0], mat, &points[0], count );
+      gmtl::xformVecs( &vecs[0], mat, &vecs[0], count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         CPPUNIT_ASSERT( isClose( points[i], point_result[i] ) );
+         CPPUNIT_ASSERT( isClose( vecs[i], vec_result[i] ) );
+      }
+   }
+
+   template<typename T>
+   static void checkBatchXform44( const gmtl::Matrix<T, 4, 4>& mat )
+   {
+      checkBatchXform<T, 4, 4, 3>( mat );
+      checkBatchXform<T, 4, 4, 4>( mat );
+   }
+
+   void XformTest::testMatBatchXform()
+   {
+      typedef gmtl::Matrix<float, 4, 4> Mat44f;
+      typedef gmtl::Matrix<double, 4, 4> Mat44d;
+
+      // affine: rotation, translation and scale
+      Mat44f affine;
+      gmtl::setRot( affine, gmtl::AxisAnglef( 0.7f, gmtl::makeNormal( gmtl::Vec3f( 1.0f, 2.0f, 3.0f ) ) ) );
+      gmtl::setTrans( affine, gmtl::Vec3f( 1.0f, -2.0f, 0.5f ) );
+      gmtl::preMult( affine, gmtl::makeScale<Mat44f>( gmtl::Vec3f( 2.0f, 0.5f, 3.0f ) ) );
+      CPPUNIT_ASSERT( gmtl::isAffineState( affine.mState ) );
+      checkBatchXform44( affine );
+      checkBatchXform44( Mat44f() );
+      checkBatchXform44( gmtl::makeTrans<Mat44f>( gmtl::Vec3f( 4.0f, 5.0f, 6.0f ) ) );
+
+      // affine form with a homogeneous scale, all points get the same w
+      Mat44f scaled_w( affine );
+      scaled_w( 3, 3 ) = 2.0f;
+      checkBatchXform44( scaled_w );
+
+      // projective
+      Mat44f proj;
+      gmtl::setPerspective( proj, 60.0f, 1.3f, 0.5f, 100.0f );
+      CPPUNIT_ASSERT( !gmtl::isAffineState( proj.mState ) );
+      checkBatchXform44( proj );
+      Mat44f full( affine );
+      full( 3, 0 ) = 0.25f;
+      full.mState = Mat44f::FULL;
+      checkBatchXform44( full );
+
+      // the same matrices in double precision (no SIMD path)
+      Mat44d affine_d;
+      gmtl::setRot( affine_d, gmtl::AxisAngled( 0.7, gmtl::makeNormal( gmtl::Vec3d( 1.0, 2.0, 3.0 ) ) ) );
+      gmtl::setTrans( affine_d, gmtl::Vec3d( 1.0, -2.0, 0.5 ) );
+      checkBatchXform44( affine_d );
+      Mat44d proj_d;
+      gmtl::setPerspective( proj_d, 60.0, 1.3, 0.5, 100.0 );
+      checkBatchXform44( proj_d );
+
+      // other sizes
+      gmtl::Matrix33f mat33;
+      gmtl::setRot( mat33, gmtl::EulerAngleXYZf( 0.0f, 0.0f, 0.3f ) );
+      gmtl::setTrans( mat33, gmtl::Vec2f( 3.0f, -1.0f ) );
+      checkBatchXform<float, 3, 3, 2>( mat33 );
+      checkBatchXform<float, 3, 3, 3>( mat33 );
+      gmtl::Matrix34f mat34;
+      gmtl::setTrans( mat34, gmtl::Vec3f( 3.0f, -1.0f, 2.0f ) );
+      checkBatchXform<float, 3, 4, 3>( mat34 );
+
+      // a 3x3 rotation is ORTHOGONAL, but its bottom row is not (0, 0, w):
+      // 2D points and vectors must go through the full transform
+      gmtl::Matrix33f rot33;
+      gmtl::setRot( rot33, gmtl::AxisAnglef( 0.7f, gmtl::makeNormal( gmtl::Vec3f( 1.0f, 2.0f, 3.0f ) ) ) );
+      CPPUNIT_ASSERT( rot33.mState == gmtl::Matrix33f::ORTHOGONAL );
+      checkBatchXform<float, 3, 3, 2>( rot33 );
+      checkBatchXform<float, 3, 3, 3>( rot33 );
+      const gmtl::Point2f pt( 0.3f, 0.8f );
+      gmtl::Point2f batch_pt, single_pt;
+      gmtl::xformPoints( &batch_pt, rot33, &pt, 1 );
+      gmtl::xform( single_pt, rot33, pt );
+      CPPUNIT_ASSERT( gmtl::isEqual( batch_pt, single_pt, 1e-6f ) );
+
+      // empty batches are fine
+      gmtl::xformPoints( static_cast<gmtl::Point3f*>( NULL ), affine, static_cast<const gmtl::Point3f*>( NULL ), 0 );
+   }
+
+   void XformTest::testMatBatchXformStrided()
+   {
+      struct Vertex
+      {
+         gmtl::Point3f mPos;
+         gmtl::Vec3f mNormal;
+         float mTexCoord[2];
+      };
+
+      const std::size_t count = 9;
+      std::vector<Vertex> verts( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         verts[i].mPos.set( float( i ), 1.0f - float( i ), 0.5f * float( i ) );
+         verts[i].mNormal.set( 0.0f, 1.0f, float( i ) );
+         verts[i].mTexCoord[0] = verts[i].mTexCoord[1] = float( i );
+      }
+      const std::vector<Vertex> orig( verts );
+
+      gmtl::Matrix44f affine, proj;
+      gmtl::setRot( affine, gmtl::AxisAnglef( 1.2f, gmtl::Vec3f( 0.0f, 0.6f, 0.8f ) ) );
+      gmtl::setTrans( affine, gmtl::Vec3f( 1.0f, -2.0f, 0.5f ) );
+      gmtl::setPerspective( proj, 45.0f, 1.0f, 0.5f, 10.0f );
+
+      // interleaved data, transformed in place
+      gmtl::xformPoints( &verts[0].mPos, sizeof(Vertex), affine, &verts[0].mPos, sizeof(Vertex), count );
+      gmtl::xformVecs( &verts[0].mNormal, sizeof(Vertex), proj, &verts[0].mNormal, sizeof(Vertex), count );
+
+      // into a packed array
+      std::vector<gmtl::Point3f> packed( count );
+      gmtl::xformPoints( &packed[0], sizeof(gmtl::Point3f), proj, &orig[0].mPos, sizeof(Vertex), count );
+
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         CPPUNIT_ASSERT( isClose( verts[i].mPos, affine * orig[i].mPos ) );
+         CPPUNIT_ASSERT( isClose( verts[i].mNormal, proj * orig[i].mNormal ) );
+         CPPUNIT_ASSERT( verts[i].mTexCoord[0] == float( i ) && verts[i].mTexCoord[1] == float( i ) );
+         CPPUNIT_ASSERT( isClose( packed[i], proj * orig[i].mPos ) );
+      }
+   }
+
+   /** Checks the quaternion xformVecs() against xform() on each vector. */
+   template<typename T>
+   static void checkQuatBatchXform( const std::size_t count, const T eps )
+   {
+      std::vector< gmtl::Vec<T, 3> > vecs( count ), result( count ), result2( count );
+      std::vector< gmtl::Quat<T> > rots( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         vecs[i].set( T( 0.37 ) * T( i + 1 ) - T( 1.1 ), T( 2.5 ) - T( 0.41 ) * T( i ), T( 0.5 ) );
+         gmtl::Vec<T, 3> axis( T( 1 ), T( i ), T( 3 ) - T( i ) );
+         gmtl::normalize( axis );
+         gmtl::set( rots[i], gmtl::AxisAngle<T>( T( 0.3 ) * T( i ) - T( 2 ), axis ) );
+      }
+      const gmtl::Quat<T> rot( gmtl::makeNormal( gmtl::Quat<T>( T( 0.1 ), T( -0.7 ), T( 0.3 ), T( 0.5 ) ) ) );
+
+      gmtl::xformVecs( &result[0], rot, &vecs[0], count );
+      gmtl::xformVecs( &result2[0], &rots[0], &vecs[0], count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         gmtl::Vec<T, 3> expected, expected2;
+         gmtl::xform( expected, rot, vecs[i] );
+         gmtl::xform( expected2, rots[i], vecs[i] );
+         CPPUNIT_ASSERT( gmtl::isEqual( result[i], expected, eps * gmtl::length( vecs[i] ) ) );
+         CPPUNIT_ASSERT( gmtl::isEqual( result2[i], expected2, eps * gmtl::length( vecs[i] ) ) );
+      }
+
+      // in place gives the same results
+      std::vector< gmtl::Vec<T, 3> > in_place( vecs ), in_place2( vecs );
+      gmtl::xformVecs( &in_place[0], rot, &in_place[0], count );
+      gmtl::xformVecs( &in_place2[0], &rots[0], &in_place2[0], count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         CPPUNIT_ASSERT( isClose( in_place[i], result[i] ) );
+         CPPUNIT_ASSERT( isClose( in_place2[i], result2[i] ) );
+      }
+   }
+
+   void XformTest::testQuatBatchXform()
+   {
+      for (std::size_t count = 0; count < 11; ++count)
+      {
+         checkQuatBatchXform<float>( count, 1e-6f );
+         checkQuatBatchXform<double>( count, 1e-14 );
+      }
+      checkQuatBatchXform<float>( 101, 1e-6f );
+
+      // strided: the positions and orientations of interleaved instances
+      struct Instance
+      {
+         gmtl::Quatf mRot;
+         gmtl::Vec3f mOffset;
+         gmtl::Vec3f mScale;
+      };
+      const std::size_t count = 7;
+      std::vector<Instance> inst( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         gmtl::set( inst[i].mRot, gmtl::AxisAnglef( 0.5f * float( i ), gmtl::Vec3f( 0.0f, 0.0f, 1.0f ) ) );
+         inst[i].mOffset.set( 1.0f, float( i ), 0.0f );
+         inst[i].mScale.set( 2.0f, 2.0f, 2.0f );
+      }
+      const std::vector<Instance> orig( inst );
+      gmtl::xformVecs( &inst[0].mOffset, sizeof(Instance), &inst[0].mRot, sizeof(Instance),
+                       &inst[0].mOffset, sizeof(Instance), count );
+      std::vector<gmtl::Vec3f> rotated( count );
+      gmtl::xformVecs( &rotated[0], sizeof(gmtl::Vec3f), orig[3].mRot, &orig[0].mOffset, sizeof(Instance), count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         gmtl::Vec3f expected, expected2;
+         gmtl::xform( expected, orig[i].mRot, orig[i].mOffset );
+         gmtl::xform( expected2, orig[3].mRot, orig[i].mOffset );
+         CPPUNIT_ASSERT( gmtl::isEqual( inst[i].mOffset, expected, 1e-5f ) );
+         CPPUNIT_ASSERT( gmtl::isEqual( rotated[i], expected2, 1e-5f ) );
+         CPPUNIT_ASSERT( inst[i].mScale == orig[i].mScale );
+         CPPUNIT_ASSERT( inst[i].mRot == orig[i].mRot );
+      }
+   }
 }
@@ -19,20 +19,26 @@ namespace gmtlTest
 
       CPPUNIT_TEST(testQuatVecXform);
       CPPUNIT_TEST(weird_XformQuatVec_InvConj_SanityCheck);
+      CPPUNIT_TEST(testQuatBatchXform);
       CPPUNIT_TEST(testMatVecXform);
       CPPUNIT_TEST(testMatPointXform);
       CPPUNIT_TEST(testMatRayXform);
       CPPUNIT_TEST(testMatLineSegXform);
+      CPPUNIT_TEST(testMatBatchXform);
+      CPPUNIT_TEST(testMatBatchXformStrided);
       
       CPPUNIT_TEST_SUITE_END();
 
    public:
       void testQuatVecXform();
       void weird_XformQuatVec_InvConj_SanityCheck();
+      void testQuatBatchXform();
       void testMatVecXform();
       void testMatPointXform();
       void testMatLineSegXform();
       void testMatRayXform();
+      void testMatBatchXform();
+      void testMatBatchXformStrided();
    };
 
    /**
@@ -43,19 +49,23 @@ namespace gmtlTest
       CPPUNIT_TEST_SUITE(XformMetricTest);
 
       CPPUNIT_TEST(testTimingXformQuatVec3);
+      CPPUNIT_TEST(testTimingXformQuatVec3Batch);
       CPPUNIT_TEST(testTimingXformMatVecComplete);
       CPPUNIT_TEST(testTimingXformMatVecPartial);
       CPPUNIT_TEST(testTimingXformMatPointComplete);
       CPPUNIT_TEST(testTimingXformMatPointPartial);
+      CPPUNIT_TEST(testTimingXformMatPointBatch);
 
       CPPUNIT_TEST_SUITE_END();
 
    public:
       void testTimingXformQuatVec3();
+      void testTimingXformQuatVec3Batch();
       void testTimingXformMatVecComplete();
       void testTimingXformMatVecPartial();
       void testTimingXformMatPointComplete();
       void testTimingXformMatPointPartial();
+      void testTimingXformMatPointBatch();
    };
 }
 
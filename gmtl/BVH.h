@@ -0,0 +1,670 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_BVH_H_
+#define _GMTL_BVH_H_
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <gmtl/AABox.h>
+#include <gmtl/Point.h>
+#include <gmtl/VecOps.h>
+#include <gmtl/Tri.h>
+#include <gmtl/Math.h>
+#include <gmtl/Util/Assert.h>
+#include <gmtl/Util/ThreadPool.h>
+
+namespace gmtl
+{
+
+/**
+ * A node of a BVH.  A leaf holds mCount > 0 triangles, starting at
+ * BVH::mTris[mFirst].  An interior node has mCount == 0, and its two
+ * children are BVH::mNodes[mFirst] and BVH::mNodes[mFirst + 1].
+ *
+ * @see BVH
+ * @ingroup Types
+ */
+template<class DATA_TYPE>
+class BVHNode
+{
+public:
+   BVHNode()
+      : mFirst( 0 ), mCount( 0 )
+   {
+   }
+
+   bool isLeaf() const
+   {
+      return mCount != 0;
+   }
+
+public:
+   /// The bounds of all the triangles below this node.
+   AABox<DATA_TYPE> mBounds;
+
+   /// Leaf: the first triangle; interior node: the first child.
+   unsigned int mFirst;
+
+   /// Leaf: the number of triangles; interior node: 0.
+   unsigned int mCount;
+};
+
+/**
+ * A bounding volume hierarchy over a set of triangles, for ray and line
+ * segment queries that do not test every triangle.
+ *
+ * The hierarchy is a binary tree of axis aligned boxes, stored in mNodes
+ * with the root at index 0.  The triangles are copied into mTris in the
+ * order of the leaves, so that the triangles of a leaf are next to each
+ * other in memory; mTriIndices maps them back to the index they had in
+ * the array given to build().  The queries (see BVHOps.h) report that
+ * original index.
+ *
+ * build() splits the nodes top down with the surface area heuristic (SAH),
+ * evaluated at NumBins planes along each axis of the bounds of the
+ * triangle centroids: a node is split where the expected cost of
+ * traversing the children, sum( area(child) / area(node) * triangles(child) ),
+ * is the lowest, or made a leaf when that is not cheaper than testing its
+ * triangles and it has at most maxLeafSize of them.
+ *
+ * When the triangles move but keep their connectivity (a skinned or
+ * deforming mesh), refit() updates the bounds in place, which is much
+ * cheaper than a new build.  The tree is not changed, so as the triangles
+ * move away from where they were built the queries slow down; refit()
+ * returns how much, as the ratio of the SAH cost of the tree to its cost
+ * when it was built.
+ *
+ * <h3> "Example:" </h3>
+ * \code
+ *    BVH<float> bvh( &tris[0], tris.size() );
+ *    float u, v, t;
+ *    unsigned int tri;
+ *    if (intersect( bvh, ray, u, v, t, tri ))
+ *    {
+ *       Point3f hit = ray.getOrigin() + ray.getDir() * t;
+ *    }
+ * \endcode
+ *
+ * @param DATA_TYPE     the type of the triangle coordinates
+ *
+ * @see BVHNode, BVHOps.h
+ * @ingroup Types
+ */
+template<class DATA_TYPE>
+class BVH
+{
+public:
+   typedef DATA_TYPE DataType;
+   typedef BVHNode<DATA_TYPE> Node;
+   typedef Tri<DATA_TYPE> TriType;
+
+   enum
+   {
+      /// The number of candidate split planes per axis in build().
+      NumBins = 16,
+
+      /// The maximum depth of the tree; deeper nodes are made leaves.
+      MaxDepth = 64,
+
+      /// The number of subtrees refit() splits the tree into.
+      RefitSubtrees = 64
+   };
+
+public:
+   /** Creates an empty hierarchy. */
+   BVH()
+      : mDepth( 0 ), mBuildCost( 0 ), mSAHCost( 0 )
+   {
+   }
+
+   /** Creates a hierarchy over count triangles, see build(). */
+   BVH( const TriType* tris, const std::size_t count, const unsigned int maxLeafSize = 4 )
+      : mDepth( 0 ), mBuildCost( 0 ), mSAHCost( 0 )
+   {
+      build( tris, count, maxLeafSize );
+   }
+
+   /** Replaces the contents of this hierarchy with one over count
+    *  triangles, built with the binned SAH.
+    *  @param tris         the triangles, which are copied
+    *  @param count        the number of triangles
+    *  @param maxLeafSize  the most triangles a leaf may have, unless the
+    *                      triangles can not be split (their centroids are
+    *                      all the same, or the tree is MaxDepth deep)
+    */
+   void build( const TriType* tris, const std::size_t count, const unsigned int maxLeafSize = 4 )
+   {
+      gmtlASSERT( maxLeafSize > 0 );
+      gmtlASSERT( count < std::size_t( (std::numeric_limits<unsigned int>::max)() ) );
+      clear();
+      if (count == 0)
+      {
+         return;
+      }
+
+      // the bounds and centroid of each triangle
+      std::vector< Point<DATA_TYPE, 3> > tri_min( count ), tri_max( count ), centroids( count );
+      std::vector<unsigned int> indices( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         tri_min[i] = tri_max[i] = tris[i][0];
+         growBounds( tri_min[i], tri_max[i], tris[i][1] );
+         growBounds( tri_min[i], tri_max[i], tris[i][2] );
+         for (unsigned int axis = 0; axis < 3; ++axis)
+         {
+            centroids[i][axis] = (tri_min[i][axis] + tri_max[i][axis]) * static_cast<DATA_TYPE>(0.5);
+         }
+         indices[i] = static_cast<unsigned int>( i );
+      }
+
+      mNodes.reserve( 2 * count );
+      mNodes.push_back( Node() );
+
+      std::vector<Task> tasks;
+      Task root = { 0, 0, static_cast<unsigned int>( count ), 1 };
+      tasks.push_back( root );
+
+      while (!tasks.empty())
+      {
+         const Task task = tasks.back();
+         tasks.pop_back();
+         mDepth = Math::Max( mDepth, task.mDepth );
+
+         // the bounds of the triangles and of their centroids
+         Point<DATA_TYPE, 3> box_min( tri_min[indices[task.mBegin]] ), box_max( tri_max[indices[task.mBegin]] );
+         Point<DATA_TYPE, 3> cen_min( centroids[indices[task.mBegin]] ), cen_max( cen_min );
+         for (unsigned int i = task.mBegin + 1; i < task.mEnd; ++i)
+         {
+            growBounds( box_min, box_max, tri_min[indices[i]] );
+            growBounds( box_min, box_max, tri_max[indices[i]] );
+            growBounds( cen_min, cen_max, centroids[indices[i]] );
+         }
+         mNodes[task.mNode].mBounds = AABox<DATA_TYPE>( box_min, box_max );
+
+         const unsigned int count = task.mEnd - task.mBegin;
+         unsigned int split_axis = 0, split_bin = 0;
+         bool split = false;
+         if (count > 1 && task.mDepth < MaxDepth)
+         {
+            split = findSplit( split_axis, split_bin, indices, task.mBegin, task.mEnd,
+                               tri_min, tri_max, centroids, cen_min, cen_max,
+                               surfaceArea( box_min, box_max ), count <= maxLeafSize );
+         }
+         if (!split && (count <= maxLeafSize || task.mDepth >= MaxDepth || cen_min == cen_max))
+         {
+            mNodes[task.mNode].mFirst = task.mBegin;
+            mNodes[task.mNode].mCount = count;
+            continue;
+         }
+
+         unsigned int middle;
+         if (split)
+         {
+            const DATA_TYPE scale = binScale( cen_min[split_axis], cen_max[split_axis] );
+            middle = static_cast<unsigned int>(
+               std::partition( indices.begin() + task.mBegin, indices.begin() + task.mEnd,
+                               BinBelow( centroids, split_axis, cen_min[split_axis], scale, split_bin ) )
+               - indices.begin() );
+         }
+         else
+         {
+            // no split is better than another (e.g. equal areas), halve
+            // the triangles along the longest centroid axis
+            for (unsigned int axis = 1; axis < 3; ++axis)
+            {
+               if (cen_max[axis] - cen_min[axis] > cen_max[split_axis] - cen_min[split_axis])
+               {
+                  split_axis = axis;
+               }
+            }
+            middle = task.mBegin + count / 2;
+            std::nth_element( indices.begin() + task.mBegin, indices.begin() + middle,
+                              indices.begin() + task.mEnd, CentroidLess( centroids, split_axis ) );
+         }
+
+         const unsigned int left = static_cast<unsigned int>( mNodes.size() );
+         mNodes[task.mNode].mFirst = left;
+         mNodes[task.mNode].mCount = 0;
+         mNodes.push_back( Node() );
+         mNodes.push_back( Node() );
+         Task right_task = { left + 1, middle, task.mEnd, task.mDepth + 1 };
+         Task left_task = { left, task.mBegin, middle, task.mDepth + 1 };
+         tasks.push_back( right_task );
+         tasks.push_back( left_task );
+      }
+
+      mTris.resize( count );
+      mTriIndices.swap( indices );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         mTris[i] = tris[mTriIndices[i]];
+      }
+      mBuildCost = mSAHCost = computeSAHCost();
+   }
+
+   /** Refits the hierarchy to new positions of its triangles, see
+    *  refit(const TriType*, ThreadPool&).
+    */
+   DATA_TYPE refit( const TriType* tris )
+   {
+      ThreadPool pool( 1 );
+      return refit( tris, pool );
+   }
+
+   /** Refits the hierarchy to new positions of its triangles: copies them
+    *  into mTris and recomputes the bounds of every node, bottom up, without
+    *  changing the tree.  The tree is split into RefitSubtrees subtrees that
+    *  are refit in parallel on the threads of pool, and the nodes above
+    *  them are refit last.  The result does not depend on the number of
+    *  threads.
+    *
+    *  @param tris   the triangles, in the order of the array given to build()
+    *  @param pool   the threads to refit with
+    *
+    *  @return the quality of the refit tree, getSAHCost() / getBuildSAHCost():
+    *          1 when the triangles moved rigidly or were scaled, and larger as
+    *          they move relative to each other.  Rebuilding the tree when this
+    *          exceeds 1.5 or so keeps the queries fast.
+    */
+   DATA_TYPE refit( const TriType* tris, ThreadPool& pool )
+   {
+      if (empty())
+      {
+         return static_cast<DATA_TYPE>(1.0);
+      }
+
+      // the roots of the subtrees, and the nodes above them, level by level
+      std::vector<unsigned int> roots( 1, 0 ), top, next;
+      while (roots.size() < RefitSubtrees)
+      {
+         next.clear();
+         for (std::size_t i = 0; i < roots.size(); ++i)
+         {
+            const Node& node = mNodes[roots[i]];
+            if (node.isLeaf())
+            {
+               next.push_back( roots[i] );
+            }
+            else
+            {
+               top.push_back( roots[i] );
+               next.push_back( node.mFirst );
+               next.push_back( node.mFirst + 1 );
+            }
+         }
+         if (next.size() == roots.size())
+         {
+            break;
+         }
+         roots.swap( next );
+      }
+
+      std::vector<DATA_TYPE> costs( roots.size() );
+      pool.run( roots.size(), RefitCall( this, tris, &roots[0], &costs[0] ) );
+      DATA_TYPE cost = static_cast<DATA_TYPE>(0.0);
+      for (std::size_t i = 0; i < costs.size(); ++i)
+      {
+         cost += costs[i];
+      }
+
+      // the children of the top nodes are on later levels
+      for (std::size_t i = top.size(); i-- > 0; )
+      {
+         Node& node = mNodes[top[i]];
+         node.mBounds = mNodes[node.mFirst].mBounds;
+         extendBounds( node.mBounds, mNodes[node.mFirst + 1].mBounds );
+         cost += surfaceArea( node.mBounds.mMin, node.mBounds.mMax );
+      }
+      mSAHCost = normalizeCost( cost );
+      return (mBuildCost > static_cast<DATA_TYPE>(0.0)) ? mSAHCost / mBuildCost : static_cast<DATA_TYPE>(1.0);
+   }
+
+   /** Computes the SAH cost of the tree: the expected number of node and
+    *  triangle tests of a random ray that hits the root,
+    *  sum( area(node) / area(root) * cost(node) ), where the cost of an
+    *  interior node is 1 and the cost of a leaf its number of triangles.
+    */
+   DATA_TYPE computeSAHCost() const
+   {
+      DATA_TYPE cost = static_cast<DATA_TYPE>(0.0);
+      for (std::size_t i = 0; i < mNodes.size(); ++i)
+      {
+         const Node& node = mNodes[i];
+         cost += surfaceArea( node.mBounds.mMin, node.mBounds.mMax ) *
+                 static_cast<DATA_TYPE>( node.isLeaf() ? node.mCount : 1 );
+      }
+      return normalizeCost( cost );
+   }
+
+   /** Gets the SAH cost of the tree after the last build or refit(), see
+    *  computeSAHCost().
+    */
+   DATA_TYPE getSAHCost() const
+   {
+      return mSAHCost;
+   }
+
+   /** Gets the SAH cost of the tree as it was built, see computeSAHCost(). */
+   DATA_TYPE getBuildSAHCost() const
+   {
+      return mBuildCost;
+   }
+
+   /** Removes all the triangles. */
+   void clear()
+   {
+      mNodes.clear();
+      mTris.clear();
+      mTriIndices.clear();
+      mDepth = 0;
+      mBuildCost = mSAHCost = static_cast<DATA_TYPE>(0.0);
+   }
+
+   bool empty() const
+   {
+      return mNodes.empty();
+   }
+
+   /** Gets the number of triangles. */
+   std::size_t getNumTris() const
+   {
+      return mTris.size();
+   }
+
+   /** Gets the number of nodes, interior nodes and leaves. */
+   std::size_t getNumNodes() const
+   {
+      return mNodes.size();
+   }
+
+   /** Gets the number of levels of the tree, 1 for a single leaf. */
+   unsigned int getDepth() const
+   {
+      return mDepth;
+   }
+
+   /** Gets the bounds of all the triangles.
+    *  @pre !empty()
+    */
+   const AABox<DATA_TYPE>& getBounds() const
+   {
+      gmtlASSERT( !empty() );
+      return mNodes[0].mBounds;
+   }
+
+private:
+   /** A node of build() still to be split: indices[mBegin, mEnd). */
+   struct Task
+   {
+      unsigned int mNode, mBegin, mEnd, mDepth;
+   };
+
+   /** Calls refitSubtree() from the pool. */
+   class RefitCall
+   {
+   public:
+      RefitCall( BVH* bvh, const TriType* tris, const unsigned int* roots, DATA_TYPE* costs )
+         : mBVH( bvh ), mTris( tris ), mRoots( roots ), mCosts( costs )
+      {
+      }
+
+      void operator()( const std::size_t task, const unsigned int ) const
+      {
+         mCosts[task] = mBVH->refitSubtree( mRoots[task], mTris );
+      }
+
+   private:
+      BVH* mBVH;
+      const TriType* mTris;
+      const unsigned int* mRoots;
+      DATA_TYPE* mCosts;
+   };
+
+   /** Refits the subtree at root and returns its unnormalized SAH cost. */
+   DATA_TYPE refitSubtree( const unsigned int root, const TriType* tris )
+   {
+      // children come after their parent in depth first order
+      std::vector<unsigned int> order, stack( 1, root );
+      while (!stack.empty())
+      {
+         const unsigned int index = stack.back();
+         stack.pop_back();
+         order.push_back( index );
+         if (!mNodes[index].isLeaf())
+         {
+            stack.push_back( mNodes[index].mFirst + 1 );
+            stack.push_back( mNodes[index].mFirst );
+         }
+      }
+
+      DATA_TYPE cost = static_cast<DATA_TYPE>(0.0);
+      for (std::size_t i = order.size(); i-- > 0; )
+      {
+         Node& node = mNodes[order[i]];
+         if (node.isLeaf())
+         {
+            Point<DATA_TYPE, 3> min( tris[mTriIndices[node.mFirst]][0] ), max( min );
+            for (unsigned int t = node.mFirst; t < node.mFirst + node.mCount; ++t)
+            {
+               mTris[t] = tris[mTriIndices[t]];
+               growBounds( min, max, mTris[t][0] );
+               growBounds( min, max, mTris[t][1] );
+               growBounds( min, max, mTris[t][2] );
+            }
+            node.mBounds.mMin = min;
+            node.mBounds.mMax = max;
+            cost += surfaceArea( min, max ) * static_cast<DATA_TYPE>( node.mCount );
+         }
+         else
+         {
+            node.mBounds = mNodes[node.mFirst].mBounds;
+            extendBounds( node.mBounds, mNodes[node.mFirst + 1].mBounds );
+            cost += surfaceArea( node.mBounds.mMin, node.mBounds.mMax );
+         }
+      }
+      return cost;
+   }
+
+   /** Divides a sum of areas by the area of the root; a root with no area
+    *  (all the triangles on a line) counts as area 1.
+    */
+   DATA_TYPE normalizeCost( const DATA_TYPE cost ) const
+   {
+      if (empty())
+      {
+         return static_cast<DATA_TYPE>(0.0);
+      }
+      const DATA_TYPE root_area = surfaceArea( mNodes[0].mBounds.mMin, mNodes[0].mBounds.mMax );
+      return (root_area > static_cast<DATA_TYPE>(0.0)) ? cost / root_area : cost;
+   }
+
+   static void extendBounds( AABox<DATA_TYPE>& box, const AABox<DATA_TYPE>& other )
+   {
+      for (unsigned int axis = 0; axis < 3; ++axis)
+      {
+         box.mMin[axis] = Math::Min( box.mMin[axis], other.mMin[axis] );
+         box.mMax[axis] = Math::Max( box.mMax[axis], other.mMax[axis] );
+      }
+   }
+
+   static void growBounds( Point<DATA_TYPE, 3>& min, Point<DATA_TYPE, 3>& max, const Point<DATA_TYPE, 3>& p )
+   {
+      for (unsigned int axis = 0; axis < 3; ++axis)
+      {
+         min[axis] = Math::Min( min[axis], p[axis] );
+         max[axis] = Math::Max( max[axis], p[axis] );
+      }
+   }
+
+   static DATA_TYPE surfaceArea( const Point<DATA_TYPE, 3>& min, const Point<DATA_TYPE, 3>& max )
+   {
+      const DATA_TYPE dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+      return static_cast<DATA_TYPE>(2.0) * (dx * dy + dy * dz + dz * dx);
+   }
+
+   /** The factor that maps a centroid coordinate - min to its bin. */
+   static DATA_TYPE binScale( const DATA_TYPE min, const DATA_TYPE max )
+   {
+      return static_cast<DATA_TYPE>(NumBins) * (static_cast<DATA_TYPE>(1.0) - static_cast<DATA_TYPE>(1e-6)) / (max - min);
+   }
+
+   static unsigned int binIndex( const DATA_TYPE c, const DATA_TYPE min, const DATA_TYPE scale )
+   {
+      return Math::Min( static_cast<unsigned int>( (c - min) * scale ), static_cast<unsigned int>(NumBins - 1) );
+   }
+
+   /** True for triangles whose centroid is in bin split or below. */
+   class BinBelow
+   {
+   public:
+      BinBelow( const std::vector< Point<DATA_TYPE, 3> >& centroids, const unsigned int axis,
+                const DATA_TYPE min, const DATA_TYPE scale, const unsigned int split )
+         : mCentroids( centroids ), mAxis( axis ), mMin( min ), mScale( scale ), mSplit( split )
+      {
+      }
+
+      bool operator()( const unsigned int i ) const
+      {
+         return binIndex( mCentroids[i][mAxis], mMin, mScale ) <= mSplit;
+      }
+
+   private:
+      const std::vector< Point<DATA_TYPE, 3> >& mCentroids;
+      unsigned int mAxis;
+      DATA_TYPE mMin, mScale;
+      unsigned int mSplit;
+   };
+
+   /** Orders triangles by their centroid along one axis. */
+   class CentroidLess
+   {
+   public:
+      CentroidLess( const std::vector< Point<DATA_TYPE, 3> >& centroids, const unsigned int axis )
+         : mCentroids( centroids ), mAxis( axis )
+      {
+      }
+
+      bool operator()( const unsigned int a, const unsigned int b ) const
+      {
+         return mCentroids[a][mAxis] < mCentroids[b][mAxis];
+      }
+
+   private:
+      const std::vector< Point<DATA_TYPE, 3> >& mCentroids;
+      unsigned int mAxis;
+   };
+
+   /** Finds the cheapest SAH split of the triangles indices[begin, end).
+    *  @return false if there is no split, or (when mayBeLeaf) if no split
+    *          is cheaper than a leaf
+    */
+   static bool findSplit( unsigned int& bestAxis, unsigned int& bestBin,
+                          const std::vector<unsigned int>& indices,
+                          const unsigned int begin, const unsigned int end,
+                          const std::vector< Point<DATA_TYPE, 3> >& triMin,
+                          const std::vector< Point<DATA_TYPE, 3> >& triMax,
+                          const std::vector< Point<DATA_TYPE, 3> >& centroids,
+                          const Point<DATA_TYPE, 3>& cenMin, const Point<DATA_TYPE, 3>& cenMax,
+                          const DATA_TYPE area, const bool mayBeLeaf )
+   {
+      const DATA_TYPE inf = (std::numeric_limits<DATA_TYPE>::max)();
+
+      // cost of a leaf, in units of triangle tests, with traversing a
+      // node costing one triangle test
+      DATA_TYPE best_cost = mayBeLeaf ? static_cast<DATA_TYPE>( end - begin ) : inf;
+      bool found = false;
+
+      for (unsigned int axis = 0; axis < 3; ++axis)
+      {
+         if (!(cenMin[axis] < cenMax[axis]))
+         {
+            continue;
+         }
+         const DATA_TYPE scale = binScale( cenMin[axis], cenMax[axis] );
+
+         unsigned int bin_count[NumBins] = { 0 };
+         Point<DATA_TYPE, 3> bin_min[NumBins], bin_max[NumBins];
+         for (unsigned int b = 0; b < NumBins; ++b)
+         {
+            bin_min[b].set( inf, inf, inf );
+            bin_max[b].set( -inf, -inf, -inf );
+         }
+         for (unsigned int i = begin; i < end; ++i)
+         {
+            const unsigned int tri = indices[i];
+            const unsigned int b = binIndex( centroids[tri][axis], cenMin[axis], scale );
+            ++bin_count[b];
+            growBounds( bin_min[b], bin_max[b], triMin[tri] );
+            growBounds( bin_min[b], bin_max[b], triMax[tri] );
+         }
+
+         // sweep from the right for the areas and counts right of each plane
+         DATA_TYPE right_area[NumBins];
+         unsigned int right_count[NumBins];
+         Point<DATA_TYPE, 3> acc_min( inf, inf, inf ), acc_max( -inf, -inf, -inf );
+         unsigned int acc_count = 0;
+         for (unsigned int b = NumBins - 1; b > 0; --b)
+         {
+            growBounds( acc_min, acc_max, bin_min[b] );
+            growBounds( acc_min, acc_max, bin_max[b] );
+            acc_count += bin_count[b];
+            right_count[b] = acc_count;
+            right_area[b] = acc_count ? surfaceArea( acc_min, acc_max ) : static_cast<DATA_TYPE>(0.0);
+         }
+
+         // sweep from the left, evaluating the plane after bin b
+         acc_min.set( inf, inf, inf );
+         acc_max.set( -inf, -inf, -inf );
+         acc_count = 0;
+         for (unsigned int b = 0; b + 1 < NumBins; ++b)
+         {
+            growBounds( acc_min, acc_max, bin_min[b] );
+            growBounds( acc_min, acc_max, bin_max[b] );
+            acc_count += bin_count[b];
+            if (acc_count == 0 || right_count[b + 1] == 0)
+            {
+               continue;
+            }
+            const DATA_TYPE cost = static_cast<DATA_TYPE>(1.0) +
+               (surfaceArea( acc_min, acc_max ) * static_cast<DATA_TYPE>( acc_count ) +
+                right_area[b + 1] * static_cast<DATA_TYPE>( right_count[b + 1] )) / area;
+            if (cost < best_cost)
+            {
+               best_cost = cost;
+               bestAxis = axis;
+               bestBin = b;
+               found = true;
+            }
+         }
+      }
+      return found;
+   }
+
+public:
+   /// The nodes, the root is mNodes[0].
+   std::vector<Node> mNodes;
+
+   /// The triangles, in the order of the leaves.
+   std::vector<TriType> mTris;
+
+   /// mTris[i] is triangle mTriIndices[i] of the array given to build().
+   std::vector<unsigned int> mTriIndices;
+
+   /// The number of levels of the tree.
+   unsigned int mDepth;
+
+   /// The SAH cost when the tree was built, and after the last refit().
+   DATA_TYPE mBuildCost, mSAHCost;
+};
+
+typedef BVH<float> BVHf;
+typedef BVH<double> BVHd;
+
+} // end of namespace gmtl
+
+#endif
@@ -0,0 +1,637 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_BVH_OPS_H_
+#define _GMTL_BVH_OPS_H_
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <gmtl/BVH.h>
+#include <gmtl/Ray.h>
+#include <gmtl/LineSeg.h>
+#include <gmtl/Frustum.h>
+#include <gmtl/FrustumOps.h>
+#include <gmtl/VecOps.h>
+#include <gmtl/Intersection.h>
+#include <gmtl/RayPacket.h>
+#include <gmtl/RayPacketOps.h>
+
+namespace gmtl
+{
+namespace helpers
+{
+   /** The triangle test of the single sided BVH queries. */
+   template<class DATA_TYPE>
+   struct BVHTriTest
+   {
+      static bool test( const Tri<DATA_TYPE>& tri, const Ray<DATA_TYPE>& ray,
+                        DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t )
+      {
+         return intersect( tri, ray, u, v, t );
+      }
+   };
+
+   /** The triangle test of the double sided BVH queries. */
+   template<class DATA_TYPE>
+   struct BVHTriTestDoubleSided
+   {
+      static bool test( const Tri<DATA_TYPE>& tri, const Ray<DATA_TYPE>& ray,
+                        DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t )
+      {
+         return intersectDoubleSided( tri, ray, u, v, t );
+      }
+   };
+
+   /**
+    * Slab test of a ray against the bounds of a BVH node.  The far distance
+    * is enlarged by a few ulps, so that rounding never culls a node that
+    * contains a triangle the ray hits; a direction component of zero (an
+    * infinite invDir) works, and NaNs from 0 * infinity ignore that slab.
+    *
+    * @param tMax    nodes beyond this distance are missed
+    * @param tNear   set to the distance at which the ray enters the node
+    *
+    * @return true if the ray hits the node between 0 and tMax
+    */
+   template<class DATA_TYPE>
+   inline bool intersectBVHNode( const AABox<DATA_TYPE>& box, const Point<DATA_TYPE, 3>& origin,
+                                 const Vec<DATA_TYPE, 3>& invDir, const DATA_TYPE tMax,
+                                 DATA_TYPE& tNear )
+   {
+      const DATA_TYPE far_scale = static_cast<DATA_TYPE>(1.0) +
+                                  static_cast<DATA_TYPE>(4.0) * std::numeric_limits<DATA_TYPE>::epsilon();
+      DATA_TYPE t_near = static_cast<DATA_TYPE>(0.0);
+      DATA_TYPE t_far = tMax;
+      for (unsigned int axis = 0; axis < 3; ++axis)
+      {
+         const DATA_TYPE t0 = (box.mMin[axis] - origin[axis]) * invDir[axis];
+         const DATA_TYPE t1 = (box.mMax[axis] - origin[axis]) * invDir[axis];
+         const DATA_TYPE slab_near = (t1 < t0) ? t1 : t0;
+         const DATA_TYPE slab_far = ((t1 < t0) ? t0 : t1) * far_scale;
+         t_near = (slab_near > t_near) ? slab_near : t_near;
+         t_far = (slab_far < t_far) ? slab_far : t_far;
+      }
+      tNear = t_near;
+      return t_near <= t_far;
+   }
+
+   /**
+    * Traverses a BVH with a ray, front to back.  The triangles are tested
+    * with TRI_TEST::test(), and hits beyond tMax are ignored.
+    *
+    * @param anyHit  stop at the first hit found instead of the closest one
+    *
+    * @return true if a triangle was hit, with u, v, t and triIndex set
+    *         for that triangle
+    */
+   template<class TRI_TEST, class DATA_TYPE>
+   inline bool intersectBVH( const BVH<DATA_TYPE>& bvh, const Ray<DATA_TYPE>& ray,
+                             const DATA_TYPE tMax, const bool anyHit,
+                             DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t, unsigned int& triIndex )
+   {
+      typedef BVHNode<DATA_TYPE> Node;
+      if (bvh.empty())
+      {
+         return false;
+      }
+
+      const DATA_TYPE one = static_cast<DATA_TYPE>(1.0);
+      const Point<DATA_TYPE, 3>& origin = ray.getOrigin();
+      const Vec<DATA_TYPE, 3>& dir = ray.getDir();
+      const Vec<DATA_TYPE, 3> inv_dir( one / dir[0], one / dir[1], one / dir[2] );
+
+      DATA_TYPE t_limit = tMax;
+      DATA_TYPE t_node;
+      if (!intersectBVHNode( bvh.mNodes[0].mBounds, origin, inv_dir, t_limit, t_node ))
+      {
+         return false;
+      }
+
+      // the far children still to visit, with their entry distances
+      unsigned int stack[BVH<DATA_TYPE>::MaxDepth];
+      DATA_TYPE stack_near[BVH<DATA_TYPE>::MaxDepth];
+      unsigned int top = 0;
+
+      bool found = false;
+      unsigned int node = 0;
+      for (;;)
+      {
+         const Node& n = bvh.mNodes[node];
+         if (n.isLeaf())
+         {
+            for (unsigned int i = n.mFirst; i < n.mFirst + n.mCount; ++i)
+            {
+               DATA_TYPE tri_u, tri_v, tri_t;
+               if (TRI_TEST::test( bvh.mTris[i], ray, tri_u, tri_v, tri_t ) &&
+                   (tri_t < t_limit || (!found && tri_t <= t_limit)))
+               {
+                  u = tri_u;
+                  v = tri_v;
+                  t = tri_t;
+                  triIndex = bvh.mTriIndices[i];
+                  if (anyHit)
+                  {
+                     return true;
+                  }
+                  found = true;
+                  t_limit = tri_t;
+               }
+            }
+         }
+         else
+         {
+            DATA_TYPE t_left, t_right;
+            const bool hit_left = intersectBVHNode( bvh.mNodes[n.mFirst].mBounds, origin, inv_dir, t_limit, t_left );
+            const bool hit_right = intersectBVHNode( bvh.mNodes[n.mFirst + 1].mBounds, origin, inv_dir, t_limit, t_right );
+            if (hit_left && hit_right)
+            {
+               const bool left_first = !(t_right < t_left);
+               stack[top] = left_first ? n.mFirst + 1 : n.mFirst;
+               stack_near[top] = left_first ? t_right : t_left;
+               ++top;
+               node = left_first ? n.mFirst : n.mFirst + 1;
+               continue;
+            }
+            if (hit_left || hit_right)
+            {
+               node = hit_left ? n.mFirst : n.mFirst + 1;
+               continue;
+            }
+         }
+
+         // pop the next node that is not behind the closest hit so far
+         do
+         {
+            if (top == 0)
+            {
+               return found;
+            }
+            --top;
+         }
+         while (found && stack_near[top] > t_limit);
+         node = stack[top];
+      }
+   }
+
+   /** Whether a line segment is long enough for the triangle tests, the
+    *  same test as intersect(const Tri&, const LineSeg&, ...).
+    */
+   template<class DATA_TYPE>
+   inline bool isBVHSegmentValid( const LineSeg<DATA_TYPE>& seg )
+   {
+      return static_cast<DATA_TYPE>(0.0001010101) < length( seg.getDir() );
+   }
+}
+
+/** @ingroup Ops
+ * @name BVH Queries
+ * Ray, line segment and frustum queries against the triangles of a BVH.  The u, v
+ * and t of a hit are the ones the triangle intersect() (or
+ * intersectDoubleSided()) gives for the hit triangle, and triIndex is the
+ * index of that triangle in the array the BVH was built from.  When
+ * several triangles are hit at the same closest t, any one of them may be
+ * reported.
+ * @{
+ */
+
+   /**
+    * Finds the closest triangle of a BVH that the ray hits from the front.
+    * Equivalent to, but much faster than, calling
+    * intersect(const Tri&, const Ray&, u, v, t) for every triangle.
+    *
+    * @param bvh        the triangles
+    * @param ray        the ray
+    * @param u,v        the tangent space coordinates of the hit
+    * @param t          the hit location: ray.getOrigin() + ray.getDir() * t
+    * @param triIndex   the index of the hit triangle
+    *
+    * @return true if the ray hits a triangle
+    */
+   template<class DATA_TYPE>
+   inline bool intersect( const BVH<DATA_TYPE>& bvh, const Ray<DATA_TYPE>& ray,
+                          DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t, unsigned int& triIndex )
+   {
+      return helpers::intersectBVH< helpers::BVHTriTest<DATA_TYPE> >(
+         bvh, ray, (std::numeric_limits<DATA_TYPE>::max)(), false, u, v, t, triIndex );
+   }
+
+   /**
+    * Finds the closest triangle of a BVH that the line segment hits from the
+    * front, as intersect(const Tri&, const LineSeg&, u, v, t) would.
+    *
+    * @post t gives the hit location: seg.getOrigin() + seg.getDir() * t
+    *
+    * @return true if the line segment hits a triangle
+    */
+   template<class DATA_TYPE>
+   inline bool intersect( const BVH<DATA_TYPE>& bvh, const LineSeg<DATA_TYPE>& seg,
+                          DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t, unsigned int& triIndex )
+   {
+      return helpers::isBVHSegmentValid( seg ) &&
+             helpers::intersectBVH< helpers::BVHTriTest<DATA_TYPE> >(
+                bvh, seg, static_cast<DATA_TYPE>(1.0), false, u, v, t, triIndex );
+   }
+
+   /**
+    * Finds the closest triangle of a BVH that the ray hits from either side,
+    * as intersectDoubleSided(const Tri&, const Ray&, u, v, t) would.
+    *
+    * @return true if the ray hits a triangle
+    */
+   template<class DATA_TYPE>
+   inline bool intersectDoubleSided( const BVH<DATA_TYPE>& bvh, const Ray<DATA_TYPE>& ray,
+                                     DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t, unsigned int& triIndex )
+   {
+      return helpers::intersectBVH< helpers::BVHTriTestDoubleSided<DATA_TYPE> >(
+         bvh, ray, (std::numeric_limits<DATA_TYPE>::max)(), false, u, v, t, triIndex );
+   }
+
+   /**
+    * Finds the closest triangle of a BVH that the line segment hits from
+    * either side, as intersectDoubleSided(const Tri&, const LineSeg&, u, v, t)
+    * would.
+    *
+    * @return true if the line segment hits a triangle
+    */
+   template<class DATA_TYPE>
+   inline bool intersectDoubleSided( const BVH<DATA_TYPE>& bvh, const LineSeg<DATA_TYPE>& seg,
+                                     DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t, unsigned int& triIndex )
+   {
+      return helpers::isBVHSegmentValid( seg ) &&
+             helpers::intersectBVH< helpers::BVHTriTestDoubleSided<DATA_TYPE> >(
+                bvh, seg, static_cast<DATA_TYPE>(1.0), false, u, v, t, triIndex );
+   }
+
+   /**
+    * Tests if the ray hits any triangle of a BVH from the front, stopping at
+    * the first hit found (e.g. for shadow rays).
+    */
+   template<class DATA_TYPE>
+   inline bool intersectAny( const BVH<DATA_TYPE>& bvh, const Ray<DATA_TYPE>& ray )
+   {
+      DATA_TYPE u, v, t;
+      unsigned int tri;
+      return helpers::intersectBVH< helpers::BVHTriTest<DATA_TYPE> >(
+         bvh, ray, (std::numeric_limits<DATA_TYPE>::max)(), true, u, v, t, tri );
+   }
+
+   /**
+    * Tests if the line segment hits any triangle of a BVH from the front,
+    * stopping at the first hit found (e.g. for visibility between two
+    * points).
+    */
+   template<class DATA_TYPE>
+   inline bool intersectAny( const BVH<DATA_TYPE>& bvh, const LineSeg<DATA_TYPE>& seg )
+   {
+      DATA_TYPE u, v, t;
+      unsigned int tri;
+      return helpers::isBVHSegmentValid( seg ) &&
+             helpers::intersectBVH< helpers::BVHTriTest<DATA_TYPE> >(
+                bvh, seg, static_cast<DATA_TYPE>(1.0), true, u, v, t, tri );
+   }
+
+   /** Tests if the ray hits any triangle of a BVH from either side. */
+   template<class DATA_TYPE>
+   inline bool intersectAnyDoubleSided( const BVH<DATA_TYPE>& bvh, const Ray<DATA_TYPE>& ray )
+   {
+      DATA_TYPE u, v, t;
+      unsigned int tri;
+      return helpers::intersectBVH< helpers::BVHTriTestDoubleSided<DATA_TYPE> >(
+         bvh, ray, (std::numeric_limits<DATA_TYPE>::max)(), true, u, v, t, tri );
+   }
+
+   /** Tests if the line segment hits any triangle of a BVH from either side. */
+   template<class DATA_TYPE>
+   inline bool intersectAnyDoubleSided( const BVH<DATA_TYPE>& bvh, const LineSeg<DATA_TYPE>& seg )
+   {
+      DATA_TYPE u, v, t;
+      unsigned int tri;
+      return helpers::isBVHSegmentValid( seg ) &&
+             helpers::intersectBVH< helpers::BVHTriTestDoubleSided<DATA_TYPE> >(
+                bvh, seg, static_cast<DATA_TYPE>(1.0), true, u, v, t, tri );
+   }
+
+   /**
+    * Finds the triangles of a BVH in the leaves that are not outside a
+    * frustum, i.e. the triangles that may be visible.  A triangle outside
+    * the frustum may be reported when its leaf is not, but the triangles
+    * of leaves classify(f, leaf.mBounds) puts outside never are.
+    *
+    * Each node is only tested against the frustum planes its parent
+    * crosses (see classify(f, box, planeMask, lastPlane)), and the nodes
+    * below a node inside the frustum are not tested at all.  With a
+    * planeCache, the plane that culled each node is kept for the next call
+    * and tested first, which makes most of the rejections one plane test
+    * while the frustum moves little between calls (e.g. frames).
+    *
+    * @param bvh           the triangles
+    * @param f             the frustum
+    * @param triIndices    the indices of the triangles in the array the BVH
+    *                      was built from are appended to this
+    * @param planeCache    NULL, or an array of bvh.mNodes.size() elements
+    *                      kept between calls, initialized to any value
+    *
+    * @return the number of triangles appended to triIndices
+    */
+   template<class DATA_TYPE>
+   inline std::size_t cull( const BVH<DATA_TYPE>& bvh, const Frustum<DATA_TYPE>& f,
+                            std::vector<unsigned int>& triIndices, unsigned char* planeCache = NULL )
+   {
+      typedef BVHNode<DATA_TYPE> Node;
+      if (bvh.empty())
+      {
+         return 0;
+      }
+      const std::size_t first_size = triIndices.size();
+
+      // the second children still to visit, with the planes they need
+      unsigned int stack[BVH<DATA_TYPE>::MaxDepth];
+      unsigned int stack_mask[BVH<DATA_TYPE>::MaxDepth];
+      unsigned int top = 0;
+
+      unsigned int node = 0;
+      unsigned int plane_mask = CULL_ALL_PLANES;
+      for (;;)
+      {
+         const Node& n = bvh.mNodes[node];
+         bool visible = true;
+         if (plane_mask != 0)
+         {
+            unsigned int last_plane = (planeCache != NULL) ? planeCache[node] : 6;
+            visible = classify( f, n.mBounds, plane_mask, last_plane ) != CULL_OUTSIDE;
+            if (!visible && planeCache != NULL)
+            {
+               planeCache[node] = static_cast<unsigned char>( last_plane );
+            }
+         }
+         if (visible)
+         {
+            if (n.isLeaf())
+            {
+               for (unsigned int i = n.mFirst; i < n.mFirst + n.mCount; ++i)
+               {
+                  triIndices.push_back( bvh.mTriIndices[i] );
+               }
+            }
+            else
+            {
+               stack[top] = n.mFirst + 1;
+               stack_mask[top] = plane_mask;
+               ++top;
+               node = n.mFirst;
+               continue;
+            }
+         }
+
+         if (top == 0)
+         {
+            return triIndices.size() - first_size;
+         }
+         --top;
+         node = stack[top];
+         plane_mask = stack_mask[top];
+      }
+   }
+
+/** @} */
+
+namespace helpers
+{
+   /** The packet triangle test of the single sided BVH packet queries. */
+   template<class DATA_TYPE>
+   struct BVHPacketTriTest
+   {
+      template<unsigned SIZE>
+      static unsigned int test( const Tri<DATA_TYPE>& tri, const RayPacket<DATA_TYPE, SIZE>& packet,
+                                const unsigned int active, DATA_TYPE* u, DATA_TYPE* v, DATA_TYPE* t )
+      {
+         return intersectTriPacket( tri, packet, active, false, u, v, t );
+      }
+   };
+
+   /** The packet triangle test of the double sided BVH packet queries. */
+   template<class DATA_TYPE>
+   struct BVHPacketTriTestDoubleSided
+   {
+      template<unsigned SIZE>
+      static unsigned int test( const Tri<DATA_TYPE>& tri, const RayPacket<DATA_TYPE, SIZE>& packet,
+                                const unsigned int active, DATA_TYPE* u, DATA_TYPE* v, DATA_TYPE* t )
+      {
+         return intersectTriPacket( tri, packet, active, true, u, v, t );
+      }
+   };
+
+   /**
+    * Traverses a BVH with a packet of rays.  Each node is visited once for
+    * all the lanes that reach it and is tested with the slab test of
+    * intersectBVHNode() for those lanes only; a lane leaves the subtree
+    * when it misses the node or the node is behind its closest hit.  The
+    * children are visited in the order the first active lane would visit
+    * them.
+    *
+    * @param anyHit  a lane stops at the first hit found instead of the
+    *                closest one
+    *
+    * @return the mask of the lanes that hit, with their hits set in hit
+    */
+   template<class TRI_TEST, class DATA_TYPE, unsigned SIZE>
+   inline unsigned int intersectBVHPacket( const BVH<DATA_TYPE>& bvh, const RayPacket<DATA_TYPE, SIZE>& packet,
+                                           const unsigned int active, const bool anyHit,
+                                           RayPacketHit<DATA_TYPE, SIZE>& hit )
+   {
+      typedef BVHNode<DATA_TYPE> Node;
+      if (bvh.empty() || !active)
+      {
+         return 0;
+      }
+
+      const DATA_TYPE far_scale = static_cast<DATA_TYPE>(1.0) +
+                                  static_cast<DATA_TYPE>(4.0) * std::numeric_limits<DATA_TYPE>::epsilon();
+      DATA_TYPE inv_dir[3][SIZE];
+      invertPacketDirs( packet, inv_dir );
+
+      // the closest hit of each lane so far
+      DATA_TYPE t_limit[SIZE];
+      for (unsigned int lane = 0; lane < SIZE; ++lane)
+      {
+         t_limit[lane] = (std::numeric_limits<DATA_TYPE>::max)();
+      }
+
+      // the nodes still to visit, with the lanes that visit them
+      unsigned int stack[BVH<DATA_TYPE>::MaxDepth + 1];
+      unsigned int stack_mask[BVH<DATA_TYPE>::MaxDepth + 1];
+      unsigned int top = 0;
+      stack[top] = 0;
+      stack_mask[top] = active;
+      ++top;
+
+      unsigned int found = 0;
+      unsigned int remaining = active;
+      DATA_TYPE t_near[SIZE], t_far[SIZE];
+      DATA_TYPE tri_u[SIZE], tri_v[SIZE], tri_t[SIZE];
+      while (top != 0)
+      {
+         --top;
+         const Node& n = bvh.mNodes[stack[top]];
+         unsigned int mask = stack_mask[top] & remaining;
+         if (!mask)
+         {
+            continue;
+         }
+
+         for (unsigned int lane = 0; lane < SIZE; ++lane)
+         {
+            t_near[lane] = static_cast<DATA_TYPE>(0.0);
+            t_far[lane] = t_limit[lane];
+         }
+         mask = intersectSlabPacket( n.mBounds, packet, inv_dir, mask, far_scale, t_near, t_far );
+         if (!mask)
+         {
+            continue;
+         }
+
+         if (n.isLeaf())
+         {
+            for (unsigned int i = n.mFirst; i < n.mFirst + n.mCount && mask; ++i)
+            {
+               unsigned int hits = TRI_TEST::test( bvh.mTris[i], packet, mask, tri_u, tri_v, tri_t );
+               while (hits)
+               {
+                  unsigned int lane = 0;
+                  while (!(hits & (1u << lane)))
+                  {
+                     ++lane;
+                  }
+                  const unsigned int bit = 1u << lane;
+                  hits &= ~bit;
+                  if (tri_t[lane] < t_limit[lane] || (!(found & bit) && tri_t[lane] <= t_limit[lane]))
+                  {
+                     hit.mU[lane] = tri_u[lane];
+                     hit.mV[lane] = tri_v[lane];
+                     hit.mT[lane] = tri_t[lane];
+                     hit.mTri[lane] = bvh.mTriIndices[i];
+                     found |= bit;
+                     t_limit[lane] = tri_t[lane];
+                  }
+               }
+               if (anyHit)
+               {
+                  remaining &= ~found;
+                  mask &= remaining;
+                  if (!remaining)
+                  {
+                     return found;
+                  }
+               }
+            }
+         }
+         else
+         {
+            // push the far child first, so that the near one is popped next
+            unsigned int lane = 0;
+            while (!(mask & (1u << lane)))
+            {
+               ++lane;
+            }
+            const Node& left = bvh.mNodes[n.mFirst];
+            const Node& right = bvh.mNodes[n.mFirst + 1];
+            DATA_TYPE order = static_cast<DATA_TYPE>(0.0);
+            for (unsigned int axis = 0; axis < 3; ++axis)
+            {
+               order += ((right.mBounds.mMin[axis] + right.mBounds.mMax[axis]) -
+                         (left.mBounds.mMin[axis] + left.mBounds.mMax[axis])) * packet.mDir[axis][lane];
+            }
+            const bool left_first = !(order < static_cast<DATA_TYPE>(0.0));
+            stack[top] = left_first ? n.mFirst + 1 : n.mFirst;
+            stack_mask[top] = mask;
+            stack[top + 1] = left_first ? n.mFirst : n.mFirst + 1;
+            stack_mask[top + 1] = mask;
+            top += 2;
+         }
+      }
+      return found;
+   }
+}
+
+/** @ingroup Ops
+ * @name Ray Packet BVH Queries
+ * BVH traversal with packets of rays (see RayPacket and RayPacketOps.h).
+ * Like the other packet tests, each query takes the mask of the lanes to
+ * trace and returns the mask of the active lanes that hit.
+ * @{
+ */
+
+   /**
+    * Finds the closest triangle of a BVH that each active lane of a packet
+    * hits from the front.  Each lane gets the hit that
+    * intersect(const BVH&, const Ray&, u, v, t, triIndex) gives for its
+    * ray, but the lanes share the node visits, which is much faster for
+    * coherent rays (camera rays of a pixel tile, shadow rays to one light).
+    *
+    * @param bvh     the triangles
+    * @param packet  the rays
+    * @param active  the lanes to trace
+    * @param hit     the hit of each lane that hits
+    *
+    * @return the mask of the active lanes that hit a triangle
+    */
+   template<class DATA_TYPE, unsigned SIZE>
+   inline unsigned int intersect( const BVH<DATA_TYPE>& bvh, const RayPacket<DATA_TYPE, SIZE>& packet,
+                                  const unsigned int active, RayPacketHit<DATA_TYPE, SIZE>& hit )
+   {
+      return helpers::intersectBVHPacket< helpers::BVHPacketTriTest<DATA_TYPE> >(
+         bvh, packet, active, false, hit );
+   }
+
+   /**
+    * Finds the closest triangle of a BVH that each active lane of a packet
+    * hits from either side.
+    *
+    * @return the mask of the active lanes that hit a triangle
+    */
+   template<class DATA_TYPE, unsigned SIZE>
+   inline unsigned int intersectDoubleSided( const BVH<DATA_TYPE>& bvh, const RayPacket<DATA_TYPE, SIZE>& packet,
+                                             const unsigned int active, RayPacketHit<DATA_TYPE, SIZE>& hit )
+   {
+      return helpers::intersectBVHPacket< helpers::BVHPacketTriTestDoubleSided<DATA_TYPE> >(
+         bvh, packet, active, false, hit );
+   }
+
+   /**
+    * Tests which active lanes of a packet hit any triangle of a BVH from the
+    * front; a lane stops at the first hit found (e.g. for shadow rays).
+    *
+    * @return the mask of the active lanes that hit a triangle
+    */
+   template<class DATA_TYPE, unsigned SIZE>
+   inline unsigned int intersectAny( const BVH<DATA_TYPE>& bvh, const RayPacket<DATA_TYPE, SIZE>& packet,
+                                     const unsigned int active )
+   {
+      RayPacketHit<DATA_TYPE, SIZE> hit;
+      return helpers::intersectBVHPacket< helpers::BVHPacketTriTest<DATA_TYPE> >(
+         bvh, packet, active, true, hit );
+   }
+
+   /**
+    * Tests which active lanes of a packet hit any triangle of a BVH from
+    * either side.
+    *
+    * @return the mask of the active lanes that hit a triangle
+    */
+   template<class DATA_TYPE, unsigned SIZE>
+   inline unsigned int intersectAnyDoubleSided( const BVH<DATA_TYPE>& bvh, const RayPacket<DATA_TYPE, SIZE>& packet,
+                                                const unsigned int active )
+   {
+      RayPacketHit<DATA_TYPE, SIZE> hit;
+      return helpers::intersectBVHPacket< helpers::BVHPacketTriTestDoubleSided<DATA_TYPE> >(
+         bvh, packet, active, true, hit );
+   }
+
+/** @} */
+
+} // end of namespace gmtl
+
+#endif
@@ -13,6 +13,35 @@
  */
 //#define GMTL_COUNT_CONSTRUCT_CALLS 1
 
+/** If defined, the SSE/AVX code paths are disabled and the
+ * portable scalar implementations are used everywhere.
+ * @see gmtl/Util/Simd.h
+ */
+//#define GMTL_NO_SIMD 1
+
+/** If defined, ThreadPool does not start any threads and the parallel
+ * algorithms run on the calling thread only.  Required before C++11.  It
+ * changes the layout of ThreadPool, so define it for the whole program.
+ * @see gmtl/Util/ThreadPool.h
+ */
+//#define GMTL_NO_THREADS 1
+
+/** If defined, Matrix::set() and Matrix::setTranspose() classify the
+ * data they are given with gmtl::classifyState() instead of marking the
+ * matrix FULL.  This costs a few comparisons per set() but lets invert()
+ * and mult() take their cheaper paths for matrices that are loaded from
+ * files or other libraries.
+ */
+//#define GMTL_DETECT_STATE_ON_SET 1
+
+/** If defined, the matrix operators (*, +, -, scalar * and unary -) on
+ * plain matrices return expression templates that are evaluated when they
+ * are assigned to a Matrix, instead of temporaries.  An expression is not a
+ * Matrix, so code such as invert( r, a * b ) no longer compiles with it.
+ * Without it, expressions can still be started with gmtl::makeMatExpr().
+ * @see gmtl/MatExprMeta.h
+ */
+//#define GMTL_MAT_EXPR 1
 
 
 #endif
@@ -7,10 +7,14 @@
 #define _GMTL_CONTAINMENT_H_
 
 // new stuff
+#include <cstddef>
+#include <limits>
 #include <vector>
 #include <gmtl/Sphere.h>
 #include <gmtl/AABox.h>
 #include <gmtl/Frustum.h>
+#include <gmtl/FrustumOps.h>
+#include <gmtl/OOBox.h>
 #include <gmtl/Tri.h>
 #include <gmtl/VecOps.h>
 
@@ -204,6 +208,435 @@ void makeVolume( Sphere<DATA_TYPE>& container,
    container.mRadius = Math::sqrt( radiusSqr );
 }
 
+namespace helpers
+{
+   /** The squared distance between two points. */
+   template< class DATA_TYPE >
+   inline DATA_TYPE distanceSquared( const Point<DATA_TYPE, 3>& a, const Point<DATA_TYPE, 3>& b )
+   {
+      const DATA_TYPE dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+      return dx * dx + dy * dy + dz * dz;
+   }
+
+   /** Grows radiusSqr to the squared distance from center to pt if that
+    *  is larger.
+    */
+   template< class DATA_TYPE >
+   inline void includeInSphereFit( const Point<DATA_TYPE, 3>& center, DATA_TYPE& radiusSqr,
+                                   const Point<DATA_TYPE, 3>& pt )
+   {
+      const DATA_TYPE dist_sqr = distanceSquared( center, pt );
+      if (dist_sqr > radiusSqr)
+      {
+         radiusSqr = dist_sqr;
+      }
+   }
+
+   /** Whether pt is outside the sphere (center, radiusSqr) by more than
+    *  the rounding errors of the circumsphere computations.
+    */
+   template< class DATA_TYPE >
+   inline bool isOutsideSphereFit( const Point<DATA_TYPE, 3>& center, const DATA_TYPE radiusSqr,
+                                   const Point<DATA_TYPE, 3>& pt )
+   {
+      const DATA_TYPE tol = std::numeric_limits<DATA_TYPE>::epsilon() * static_cast<DATA_TYPE>(64);
+      return distanceSquared( center, pt ) > radiusSqr + radiusSqr * tol;
+   }
+
+   /** The smallest sphere through a and b. */
+   template< class DATA_TYPE >
+   inline void makeSphereFit( Point<DATA_TYPE, 3>& center, DATA_TYPE& radiusSqr,
+                              const Point<DATA_TYPE, 3>& a, const Point<DATA_TYPE, 3>& b )
+   {
+      const DATA_TYPE half = static_cast<DATA_TYPE>(0.5);
+      center.set( (a[0] + b[0]) * half, (a[1] + b[1]) * half, (a[2] + b[2]) * half );
+      radiusSqr = distanceSquared( center, a );
+      includeInSphereFit( center, radiusSqr, b );
+   }
+
+   /**
+    * The smallest sphere through a, b and c: the one centered on their
+    * circumcircle.  If the three points are (nearly) on a line, the
+    * smallest sphere through the two farthest apart, which contains the
+    * third.
+    */
+   template< class DATA_TYPE >
+   inline void makeSphereFit( Point<DATA_TYPE, 3>& center, DATA_TYPE& radiusSqr,
+                              const Point<DATA_TYPE, 3>& a, const Point<DATA_TYPE, 3>& b,
+                              const Point<DATA_TYPE, 3>& c )
+   {
+      const DATA_TYPE ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+      const DATA_TYPE ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+      DATA_TYPE n[3];
+      crossScalar( n, ab, ac );
+      const DATA_TYPE ab_sqr = dotScalar( ab, ab ), ac_sqr = dotScalar( ac, ac ), n_sqr = dotScalar( n, n );
+      if (n_sqr <= std::numeric_limits<DATA_TYPE>::epsilon() * ab_sqr * ac_sqr)
+      {
+         const DATA_TYPE bc_sqr = distanceSquared( b, c );
+         if (ab_sqr >= ac_sqr && ab_sqr >= bc_sqr)
+         {
+            makeSphereFit( center, radiusSqr, a, b );
+         }
+         else if (ac_sqr >= bc_sqr)
+         {
+            makeSphereFit( center, radiusSqr, a, c );
+         }
+         else
+         {
+            makeSphereFit( center, radiusSqr, b, c );
+         }
+         includeInSphereFit( center, radiusSqr, a );
+         includeInSphereFit( center, radiusSqr, b );
+         includeInSphereFit( center, radiusSqr, c );
+         return;
+      }
+
+      // a + (|ac|^2 (n x ab) + |ab|^2 (ac x n)) / (2 |n|^2)
+      DATA_TYPE n_ab[3], ac_n[3];
+      crossScalar( n_ab, n, ab );
+      crossScalar( ac_n, ac, n );
+      const DATA_TYPE scale = static_cast<DATA_TYPE>(0.5) / n_sqr;
+      center.set( a[0] + (ac_sqr * n_ab[0] + ab_sqr * ac_n[0]) * scale,
+                  a[1] + (ac_sqr * n_ab[1] + ab_sqr * ac_n[1]) * scale,
+                  a[2] + (ac_sqr * n_ab[2] + ab_sqr * ac_n[2]) * scale );
+      radiusSqr = distanceSquared( center, a );
+      includeInSphereFit( center, radiusSqr, b );
+      includeInSphereFit( center, radiusSqr, c );
+   }
+
+   /**
+    * The sphere through a, b, c and d, their circumsphere.  If the four
+    * points are (nearly) on a plane, there is none; then the smallest of
+    * the spheres through two or three of them that contains all four.
+    */
+   template< class DATA_TYPE >
+   inline void makeSphereFit( Point<DATA_TYPE, 3>& center, DATA_TYPE& radiusSqr,
+                              const Point<DATA_TYPE, 3>& a, const Point<DATA_TYPE, 3>& b,
+                              const Point<DATA_TYPE, 3>& c, const Point<DATA_TYPE, 3>& d )
+   {
+      const DATA_TYPE u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+      const DATA_TYPE v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+      const DATA_TYPE w[3] = { d[0] - a[0], d[1] - a[1], d[2] - a[2] };
+      DATA_TYPE v_w[3], w_u[3], u_v[3];
+      crossScalar( v_w, v, w );
+      crossScalar( w_u, w, u );
+      crossScalar( u_v, u, v );
+      const DATA_TYPE u_sqr = dotScalar( u, u ), v_sqr = dotScalar( v, v ), w_sqr = dotScalar( w, w );
+      const DATA_TYPE det = dotScalar( u, v_w );
+      if (det * det <= std::numeric_limits<DATA_TYPE>::epsilon() * u_sqr * v_sqr * w_sqr)
+      {
+         const Point<DATA_TYPE, 3>* pts[4] = { &a, &b, &c, &d };
+         bool found = false;
+         for (unsigned int i = 0; i < 4; ++i)
+         {
+            for (unsigned int j = i + 1; j < 4; ++j)
+            {
+               // the pair i, j, then the triples of i, j and a later point
+               for (unsigned int k = j; k < 4; ++k)
+               {
+                  Point<DATA_TYPE, 3> c_try;
+                  DATA_TYPE r_sqr_try;
+                  if (k == j)
+                  {
+                     makeSphereFit( c_try, r_sqr_try, *pts[i], *pts[j] );
+                  }
+                  else
+                  {
+                     makeSphereFit( c_try, r_sqr_try, *pts[i], *pts[j], *pts[k] );
+                  }
+                  if ((!found || r_sqr_try < radiusSqr) &&
+                      !isOutsideSphereFit( c_try, r_sqr_try, a ) && !isOutsideSphereFit( c_try, r_sqr_try, b ) &&
+                      !isOutsideSphereFit( c_try, r_sqr_try, c ) && !isOutsideSphereFit( c_try, r_sqr_try, d ))
+                  {
+                     center = c_try;
+                     radiusSqr = r_sqr_try;
+                     found = true;
+                  }
+               }
+            }
+         }
+         if (!found)
+         {
+            makeSphereFit( center, radiusSqr, a, b, c );
+         }
+         includeInSphereFit( center, radiusSqr, a );
+         includeInSphereFit( center, radiusSqr, b );
+         includeInSphereFit( center, radiusSqr, c );
+         includeInSphereFit( center, radiusSqr, d );
+         return;
+      }
+
+      // a + (|u|^2 (v x w) + |v|^2 (w x u) + |w|^2 (u x v)) / (2 u . (v x w))
+      const DATA_TYPE scale = static_cast<DATA_TYPE>(0.5) / det;
+      center.set( a[0] + (u_sqr * v_w[0] + v_sqr * w_u[0] + w_sqr * u_v[0]) * scale,
+                  a[1] + (u_sqr * v_w[1] + v_sqr * w_u[1] + w_sqr * u_v[1]) * scale,
+                  a[2] + (u_sqr * v_w[2] + v_sqr * w_u[2] + w_sqr * u_v[2]) * scale );
+      radiusSqr = distanceSquared( center, a );
+      includeInSphereFit( center, radiusSqr, b );
+      includeInSphereFit( center, radiusSqr, c );
+      includeInSphereFit( center, radiusSqr, d );
+   }
+}
+
+/**
+ * A policy for makeVolume( container, first, last, policy ): the sphere
+ * centered at the average of the points, as makeVolume( container, pts ).
+ * Two passes over the points and no sqrt() per point, but the sphere is
+ * often 20-40% larger than the smallest one.
+ */
+struct CentroidSphereFit
+{
+   template< class DATA_TYPE, class ITERATOR >
+   static void fit( Sphere<DATA_TYPE>& container, const ITERATOR first, const ITERATOR last )
+   {
+      container = Sphere<DATA_TYPE>();
+      if (first == last)
+      {
+         return;
+      }
+
+      Point<DATA_TYPE, 3> sum = *first;
+      std::size_t count = 1;
+      for (ITERATOR itr = first; ++itr != last; ++count)
+      {
+         sum += *itr;
+      }
+      const Point<DATA_TYPE, 3> center = sum / static_cast<DATA_TYPE>(count);
+
+      DATA_TYPE radius_sqr(0);
+      for (ITERATOR itr = first; itr != last; ++itr)
+      {
+         helpers::includeInSphereFit( center, radius_sqr, *itr );
+      }
+      container = Sphere<DATA_TYPE>( center, Math::sqrt( radius_sqr ) );
+   }
+};
+
+/**
+ * A policy for makeVolume( container, first, last, policy ): Ritter's
+ * bounding sphere, seeded with the extremal points along the 7 directions
+ * of EPOS-14 (the axes and the 4 diagonals of a cube) instead of Ritter's
+ * 3 axes.  The initial sphere is the smallest one through the pair of
+ * extremal points farthest apart; one more pass grows it just enough to
+ * take in each point outside it, as extendVolume( container, pt ) does.
+ *
+ * Two passes over the points.  The sphere is usually less than 20% larger
+ * than the smallest one, often much closer.
+ */
+struct RitterSphereFit
+{
+   template< class DATA_TYPE, class ITERATOR >
+   static void fit( Sphere<DATA_TYPE>& container, const ITERATOR first, const ITERATOR last )
+   {
+      container = Sphere<DATA_TYPE>();
+      if (first == last)
+      {
+         return;
+      }
+
+      // the points with the least and greatest projection on each direction
+      enum { NumDirs = 7 };
+      ITERATOR min_pt[NumDirs], max_pt[NumDirs];
+      DATA_TYPE min_proj[NumDirs], max_proj[NumDirs];
+      for (unsigned int i = 0; i < NumDirs; ++i)
+      {
+         min_pt[i] = max_pt[i] = first;
+         min_proj[i] = (std::numeric_limits<DATA_TYPE>::max)();
+         max_proj[i] = -min_proj[i];
+      }
+      for (ITERATOR itr = first; itr != last; ++itr)
+      {
+         const Point<DATA_TYPE, 3>& pt = *itr;
+         const DATA_TYPE proj[NumDirs] =
+         {
+            pt[0], pt[1], pt[2],
+            pt[0] + pt[1] + pt[2], pt[0] + pt[1] - pt[2],
+            pt[0] - pt[1] + pt[2], pt[0] - pt[1] - pt[2]
+         };
+         for (unsigned int i = 0; i < NumDirs; ++i)
+         {
+            if (proj[i] < min_proj[i])
+            {
+               min_proj[i] = proj[i];
+               min_pt[i] = itr;
+            }
+            if (proj[i] > max_proj[i])
+            {
+               max_proj[i] = proj[i];
+               max_pt[i] = itr;
+            }
+         }
+      }
+
+      unsigned int widest = 0;
+      DATA_TYPE widest_sqr = helpers::distanceSquared( *min_pt[0], *max_pt[0] );
+      for (unsigned int i = 1; i < NumDirs; ++i)
+      {
+         const DATA_TYPE dist_sqr = helpers::distanceSquared( *min_pt[i], *max_pt[i] );
+         if (dist_sqr > widest_sqr)
+         {
+            widest = i;
+            widest_sqr = dist_sqr;
+         }
+      }
+
+      Point<DATA_TYPE, 3> center;
+      DATA_TYPE radius_sqr;
+      helpers::makeSphereFit( center, radius_sqr, *min_pt[widest], *max_pt[widest] );
+      DATA_TYPE radius = Math::sqrt( radius_sqr );
+
+      for (ITERATOR itr = first; itr != last; ++itr)
+      {
+         const Point<DATA_TYPE, 3>& pt = *itr;
+         const DATA_TYPE dist_sqr = helpers::distanceSquared( center, pt );
+         if (dist_sqr > radius_sqr)
+         {
+            // move the center toward pt so that the far side of the sphere
+            // stays put and pt ends up on its surface
+            const DATA_TYPE dist = Math::sqrt( dist_sqr );
+            const DATA_TYPE new_radius = (radius + dist) * static_cast<DATA_TYPE>(0.5);
+            const DATA_TYPE t = (new_radius - radius) / dist;
+            center.set( center[0] + (pt[0] - center[0]) * t,
+                        center[1] + (pt[1] - center[1]) * t,
+                        center[2] + (pt[2] - center[2]) * t );
+            radius = new_radius;
+            radius_sqr = radius * radius;
+         }
+      }
+      container = Sphere<DATA_TYPE>( center, radius );
+   }
+};
+
+/**
+ * A policy for makeVolume( container, first, last, policy ): the smallest
+ * sphere containing all the points, with Welzl's algorithm in its
+ * iterative form.  The points are copied and shuffled (with a fixed seed,
+ * so the result does not change from run to run); then each point outside
+ * the sphere of the points before it is on the surface of the new sphere,
+ * found the same way with that point fixed, up to 4 fixed points.
+ *
+ * Expected linear time, about 2-3 times the cost of RitterSphereFit, and a
+ * copy of the points.  Degenerate sets (points on a line or a plane) are
+ * handled; the sphere is exact up to rounding and is grown at the end to
+ * contain all the points exactly.
+ */
+struct WelzlSphereFit
+{
+   template< class DATA_TYPE, class ITERATOR >
+   static void fit( Sphere<DATA_TYPE>& container, const ITERATOR first, const ITERATOR last )
+   {
+      container = Sphere<DATA_TYPE>();
+      std::vector< Point<DATA_TYPE, 3> > pts;
+      for (ITERATOR itr = first; itr != last; ++itr)
+      {
+         pts.push_back( *itr );
+      }
+      if (pts.empty())
+      {
+         return;
+      }
+
+      // Fisher-Yates shuffle with a linear congruential generator
+      unsigned int seed = 0x9e3779b9u;
+      for (std::size_t i = pts.size() - 1; i > 0; --i)
+      {
+         seed = seed * 1664525u + 1013904223u;
+         const std::size_t j = static_cast<std::size_t>( seed >> 8 ) % (i + 1);
+         const Point<DATA_TYPE, 3> tmp = pts[i];
+         pts[i] = pts[j];
+         pts[j] = tmp;
+      }
+
+      Point<DATA_TYPE, 3> center = pts[0];
+      DATA_TYPE radius_sqr(0);
+      for (std::size_t i = 1; i < pts.size(); ++i)
+      {
+         if (!helpers::isOutsideSphereFit( center, radius_sqr, pts[i] ))
+         {
+            continue;
+         }
+         // pts[i] is on the sphere of pts[0..i]
+         center = pts[i];
+         radius_sqr = static_cast<DATA_TYPE>(0);
+         for (std::size_t j = 0; j < i; ++j)
+         {
+            if (!helpers::isOutsideSphereFit( center, radius_sqr, pts[j] ))
+            {
+               continue;
+            }
+            // and pts[j] is on the sphere of pts[0..j] and pts[i]
+            helpers::makeSphereFit( center, radius_sqr, pts[i], pts[j] );
+            for (std::size_t k = 0; k < j; ++k)
+            {
+               if (!helpers::isOutsideSphereFit( center, radius_sqr, pts[k] ))
+               {
+                  continue;
+               }
+               helpers::makeSphereFit( center, radius_sqr, pts[i], pts[j], pts[k] );
+               for (std::size_t l = 0; l < k; ++l)
+               {
+                  if (helpers::isOutsideSphereFit( center, radius_sqr, pts[l] ))
+                  {
+                     helpers::makeSphereFit( center, radius_sqr, pts[i], pts[j], pts[k], pts[l] );
+                  }
+               }
+            }
+         }
+      }
+
+      // take in the points left just outside by the tolerance
+      for (std::size_t i = 0; i < pts.size(); ++i)
+      {
+         helpers::includeInSphereFit( center, radius_sqr, pts[i] );
+      }
+      container = Sphere<DATA_TYPE>( center, Math::sqrt( radius_sqr ) );
+   }
+};
+
+/**
+ * Modifies the given sphere to enclose all the points in [first, last),
+ * with the algorithm of the given policy:
+ *
+ *  - CentroidSphereFit, the sphere centered at the average of the points
+ *    (as makeVolume( container, pts ));
+ *  - RitterSphereFit, a close fit in two quick passes;
+ *  - WelzlSphereFit, the smallest sphere, in expected linear time;
+ *
+ * or any class with a static fit( container, first, last ) function
+ * template.  An empty range gives an uninitialized sphere.
+ *
+ * @param container  [out]    the sphere that will be modified to enclose
+ *                            all the points in [first, last)
+ * @param first      [in]     the first point, a forward iterator to
+ *                            Point<DATA_TYPE, 3>
+ * @param last       [in]     the end of the points
+ * @param policy     [in]     the fitting algorithm
+ */
+template< class DATA_TYPE, class ITERATOR, class POLICY >
+void makeVolume( Sphere<DATA_TYPE>& container, const ITERATOR first, const ITERATOR last,
+                 const POLICY& policy )
+{
+   (void)policy;
+   POLICY::fit( container, first, last );
+}
+
+/**
+ * Modifies the given sphere to be the smallest sphere enclosing all the
+ * points in [first, last) (see WelzlSphereFit).  An empty range gives an
+ * uninitialized sphere.
+ *
+ * @param container  [out]    the sphere that will be modified to tightly
+ *                            enclose all the points in [first, last)
+ * @param first      [in]     the first point, a forward iterator to
+ *                            Point<DATA_TYPE, 3>
+ * @param last       [in]     the end of the points
+ */
+template< class DATA_TYPE, class ITERATOR >
+void makeVolume( Sphere<DATA_TYPE>& container, const ITERATOR first, const ITERATOR last )
+{
+   WelzlSphereFit::fit( container, first, last );
+}
+
 /*
 template< class DATA_TYPE >
 void makeVolume( Sphere<DATA_TYPE>& container,
@@ -586,6 +1019,89 @@ inline bool isInVolume(const Frustum<T>& f, const AABox<T>& box)
    return false;
 }
 
+/**
+ * Tests if an oriented box is at least partly inside a frustum, with the
+ * separating axis test: the box is outside when its projection on the
+ * normal of a frustum plane, on one of its own axes, or on the cross
+ * product of one of its axes with an edge of the frustum does not overlap
+ * that of the frustum.  Unlike the plane tests, this also rejects boxes
+ * outside the frustum near its edges and corners; the result is exact up
+ * to rounding.  A frustum whose corners cannot be computed is only tested
+ * with its planes.
+ */
+template<typename T>
+inline bool isInVolume(const Frustum<T>& f, const OOBox<T>& box)
+{
+   const T* center = box.mCenter.getData();
+   const T* axes[3] = { box.mAxis[0].getData(), box.mAxis[1].getData(), box.mAxis[2].getData() };
+
+   // the frustum planes; a box in front of all of them, or whose center is,
+   // is in the frustum
+   bool inside = true, center_inside = true;
+   for ( unsigned int i = 0; i < 6; ++i )
+   {
+      const T* n = f.mPlanes[i].mNorm.getData();
+      const T radius = Math::abs( helpers::dotScalar(n, axes[0]) ) * box.mHalfLen[0] +
+                       Math::abs( helpers::dotScalar(n, axes[1]) ) * box.mHalfLen[1] +
+                       Math::abs( helpers::dotScalar(n, axes[2]) ) * box.mHalfLen[2];
+      const T dist = helpers::dotScalar(n, center) + f.mPlanes[i].mOffset;
+      if ( dist < -radius )
+      {
+         return false;
+      }
+      inside = inside && dist >= radius;
+      center_inside = center_inside && dist >= T(0);
+   }
+   if ( inside || center_inside )
+   {
+      return true;
+   }
+
+   Point<T, 3> corners[8];
+   if ( !helpers::getFrustumCorners(f, corners) )
+   {
+      return true;
+   }
+
+   // the box axes
+   T pmin, pmax;
+   for ( unsigned int k = 0; k < 3; ++k )
+   {
+      helpers::projectPoints(axes[k], corners, 8, pmin, pmax);
+      const T c = helpers::dotScalar(axes[k], center);
+      if ( pmin > c + box.mHalfLen[k] || pmax < c - box.mHalfLen[k] )
+      {
+         return false;
+      }
+   }
+
+   // the box axes crossed with the frustum edges
+   Vec<T, 3> edges[12];
+   const unsigned int num_edges = helpers::getFrustumEdgeDirs(corners, edges);
+   for ( unsigned int k = 0; k < 3; ++k )
+   {
+      for ( unsigned int e = 0; e < num_edges; ++e )
+      {
+         T axis[3];
+         if ( !helpers::getSeparatingAxis(axis, axes[k], edges[e].getData()) )
+         {
+            continue;
+         }
+         helpers::projectPoints(axis, corners, 8, pmin, pmax);
+         const T c = helpers::dotScalar(axis, center);
+         const T radius = Math::abs( helpers::dotScalar(axis, axes[0]) ) * box.mHalfLen[0] +
+                          Math::abs( helpers::dotScalar(axis, axes[1]) ) * box.mHalfLen[1] +
+                          Math::abs( helpers::dotScalar(axis, axes[2]) ) * box.mHalfLen[2];
+         if ( pmin > c + radius || pmax < c - radius )
+         {
+            return false;
+         }
+      }
+   }
+
+   return true;
+}
+
 template<typename T>
 inline bool isInVolume(const Frustum<T>& f, const Tri<T>& tri)
 {
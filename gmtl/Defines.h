@@ -36,6 +36,18 @@ namespace gmtl
       NEG_SIDE
    };
 
+   /**
+    * Selects the constructor of Matrix, Vec, Point or Quat that leaves the
+    * data uninitialized.  Only use it when every element is written before
+    * it is read, such as for the result of mult() or xform().
+    *
+    * \code
+    *    Matrix44f mat( NO_INIT );  // mData is garbage, mState is FULL
+    * \endcode
+    * @ingroup Defines
+    */
+   enum NoInit { NO_INIT };
+
    /** @ingroup Defines
     * @name Constants
     * @{
@@ -43,6 +55,7 @@ namespace gmtl
    const float GMTL_EPSILON = 1.0e-6f;
    const float GMTL_MAT_EQUAL_EPSILON = 0.001f;  // Epsilon for matrices to be equal
    const float GMTL_VEC_EQUAL_EPSILON = 0.0001f; // Epsilon for vectors to be equal
+   const float GMTL_MAT_STATE_EPSILON = 1.0e-5f; // Epsilon for the orthonormality test of classifyState()
    /** @} */
    
 #define GMTL_NEAR(x,y,eps) (gmtl::Math::abs((x)-(y))<(eps))
@@ -71,5 +84,14 @@ namespace gmtl
 #define GMTL_NO_METAPROG
 #endif
 
+/** Aligns a type to N bytes: class GMTL_ALIGN(16) Vec3fA { ... };
+ * @ingroup Defines
+ */
+#if defined(_MSC_VER)
+#define GMTL_ALIGN(N) __declspec(align(N))
+#else
+#define GMTL_ALIGN(N) __attribute__((aligned(N)))
+#endif
+
 
 #endif
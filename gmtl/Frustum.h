@@ -8,9 +8,12 @@
 #ifndef _GMTL_FRUSTUM_H_
 #define _GMTL_FRUSTUM_H_
 
+#include <limits>
 #include <gmtl/Defines.h>
+#include <gmtl/Math.h>
 #include <gmtl/Plane.h>
 #include <gmtl/MatrixOps.h>
+#include <gmtl/Util/Assert.h>
 
 
 namespace gmtl
@@ -55,10 +58,13 @@ public:
     *
     * @param projMatrix The projection matrix of your camera or light etc. to
     *                   construct the planes from.
+    * @param normalized If true, the planes are normalized (see
+    *                   extractPlanes()).
     */
-   Frustum(const gmtl::Matrix<DATA_TYPE, 4, 4>& projMatrix)
+   Frustum(const gmtl::Matrix<DATA_TYPE, 4, 4>& projMatrix,
+           const bool normalized = false)
    {
-      extractPlanes(projMatrix);
+      extractPlanes(projMatrix, normalized);
    }
 
    /**
@@ -75,11 +81,14 @@ public:
     *                        to construct the planes from.
     * @param projMatrix      The projection matrix of your camera or light or
     *                        whatever.
+    * @param normalized      If true, the planes are normalized (see
+    *                        extractPlanes()).
     */
    Frustum(const gmtl::Matrix<DATA_TYPE, 4, 4>& modelviewMatrix,
-           const gmtl::Matrix<DATA_TYPE, 4, 4>& projMatrix)
+           const gmtl::Matrix<DATA_TYPE, 4, 4>& projMatrix,
+           const bool normalized = false)
    {
-      extractPlanes(modelviewMatrix, projMatrix);
+      extractPlanes(modelviewMatrix, projMatrix, normalized);
    }
 
    /**
@@ -87,11 +96,14 @@ public:
     *
     * @param projMatrix The projection matrix of you camera or light or
     *                   what ever.
+    * @param normalized If true, the planes are normalized (see
+    *                   normalizePlanes()).
     */
    void extractPlanes(const gmtl::Matrix<DATA_TYPE, 4, 4>& modelviewMatrix,
-                      const gmtl::Matrix<DATA_TYPE, 4, 4>& projMatrix)
+                      const gmtl::Matrix<DATA_TYPE, 4, 4>& projMatrix,
+                      const bool normalized = false)
    {
-      extractPlanes(projMatrix * modelviewMatrix);
+      extractPlanes(projMatrix * modelviewMatrix, normalized);
    }
 
    /**
@@ -108,8 +120,13 @@ public:
     *                        to construct the planes from.
     * @param projMatrix      The projection matrix of you camera or light etc.
     *                        to construct the planes from.
+    * @param normalized      If true, the planes are normalized (see
+    *                        normalizePlanes()), so that plane equations give
+    *                        true distances.  The default keeps the planes
+    *                        as they come out of M.
     */
-   void extractPlanes(const gmtl::Matrix<DATA_TYPE, 4, 4>& projMatrix)
+   void extractPlanes(const gmtl::Matrix<DATA_TYPE, 4, 4>& projMatrix,
+                      const bool normalized = false)
    {
       const gmtl::Matrix<DATA_TYPE, 4, 4>& m = projMatrix;
 
@@ -143,14 +160,140 @@ public:
                                                            m[3][1] - m[2][1],
                                                            m[3][2] - m[2][2]));
       mPlanes[PLANE_FAR].setOffset(m[3][3] - m[2][3]);
+
+      if (normalized)
+      {
+         normalizePlanes();
+      }
+   }
+
+   /**
+    * Scales each plane so that its normal is unit length.  Then
+    * dot(mPlanes[i].mNorm, p) + mPlanes[i].mOffset is the signed distance
+    * from the point p to plane i, which the sphere tests need.
+    */
+   void normalizePlanes()
+   {
+      for ( unsigned int i = 0; i < 6; ++i )
+      {
+         Vec<DATA_TYPE, 3> n = mPlanes[i].getNormal();
+         DATA_TYPE o = mPlanes[i].getOffset();
+         DATA_TYPE len = Math::sqrt( n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+         n[0] /= len;
+         n[1] /= len;
+         n[2] /= len;
+         o /= len;
+         mPlanes[i].setNormal(n);
+         mPlanes[i].setOffset(o);
+      }
    }
 
    gmtl::Plane<DATA_TYPE> mPlanes[6];
 };
 
+/**
+ * The planes of a Frustum stored as structure of arrays, for testing a
+ * volume against all of them at once (see classify() in FrustumOps.h).
+ *
+ * The six planes are stored as two groups of four, one array per
+ * coefficient: lane i of mNormX, mNormY, mNormZ and mOffset is plane i of
+ * the frustum, in the order of Frustum::PlaneNames.  Lanes 6 and 7 pad the
+ * second group with a plane that everything is far in front of (a zero
+ * normal and the largest offset), so a 4 wide SIMD register evaluates
+ * four planes at once and never needs a scalar tail, and an 8 wide one
+ * evaluates all of them.
+ *
+ * The block is a copy: build it again after changing the planes of the
+ * frustum.
+ *
+ * <h3> "Example:" </h3>
+ * \code
+ *    const Frustumf frustum( modelview, proj, true );
+ *    const FrustumPlaneBlockf planes( frustum );
+ *    if (classify( planes, sphere ) != CULL_OUTSIDE)
+ *    {
+ *       // draw it
+ *    }
+ * \endcode
+ *
+ * @param DATA_TYPE     the type of the plane coefficients
+ *
+ * @see Frustum
+ * @ingroup Types
+ */
+template<typename DATA_TYPE>
+class FrustumPlaneBlock
+{
+public:
+   typedef DATA_TYPE DataType;
+
+   enum
+   {
+      GroupSize = 4,    /**< the number of planes in a group */
+      Size = 8          /**< the number of lanes, with the padding */
+   };
+
+public:
+   /** Creates a block of padding planes only, which cull nothing. */
+   FrustumPlaneBlock()
+   {
+      for (unsigned int i = 0; i < Size; ++i)
+      {
+         setPadding(i);
+      }
+   }
+
+   /** Creates a block with a copy of the planes of f. */
+   explicit FrustumPlaneBlock(const Frustum<DATA_TYPE>& f)
+   {
+      assign(f);
+   }
+
+   /** Replaces the planes of this block with a copy of the planes of f. */
+   void assign(const Frustum<DATA_TYPE>& f)
+   {
+      for (unsigned int i = 0; i < 6; ++i)
+      {
+         mNormX[i] = f.mPlanes[i].mNorm[0];
+         mNormY[i] = f.mPlanes[i].mNorm[1];
+         mNormZ[i] = f.mPlanes[i].mNorm[2];
+         mOffset[i] = f.mPlanes[i].mOffset;
+      }
+      setPadding(6);
+      setPadding(7);
+   }
+
+   /** Gets plane i of the frustum, i < 6. */
+   Plane<DATA_TYPE> getPlane(const unsigned int i) const
+   {
+      gmtlASSERT( i < 6 );
+      Plane<DATA_TYPE> plane;
+      plane.mNorm.set(mNormX[i], mNormY[i], mNormZ[i]);
+      plane.mOffset = mOffset[i];
+      return plane;
+   }
+
+private:
+   void setPadding(const unsigned int i)
+   {
+      mNormX[i] = mNormY[i] = mNormZ[i] = static_cast<DATA_TYPE>(0);
+      mOffset[i] = (std::numeric_limits<DATA_TYPE>::max)();
+   }
+
+public:
+   /// The normal coefficients of the planes, one lane per plane.
+   DATA_TYPE mNormX[Size], mNormY[Size], mNormZ[Size];
+
+   /// The offsets of the planes, one lane per plane.
+   DATA_TYPE mOffset[Size];
+};
+
 typedef Frustum<float> Frustumf;
 typedef Frustum<double> Frustumd;
 
+typedef FrustumPlaneBlock<float> FrustumPlaneBlockf;
+typedef FrustumPlaneBlock<double> FrustumPlaneBlockd;
+
 }
 
 
@@ -8,9 +8,16 @@
 #ifndef _GMTL_FRUSTUM_OPS_H_
 #define _GMTL_FRUSTUM_OPS_H_
 
+#include <cstddef>
 #include <gmtl/Defines.h>
 #include <gmtl/Frustum.h>
 #include <gmtl/Math.h>
+#include <gmtl/VecOps.h>
+#include <gmtl/AABox.h>
+#include <gmtl/Sphere.h>
+#include <gmtl/Vec3Array.h>
+#include <gmtl/Util/Assert.h>
+#include <gmtl/Util/Simd.h>
 
 
 namespace gmtl
@@ -19,20 +26,1023 @@ namespace gmtl
 template<class DATA_TYPE>
 void normalize(Frustum<DATA_TYPE>& f)
 {
-   for ( unsigned int i = 0; i < 6; ++i )
+   f.normalizePlanes();
+}
+
+/** Where a volume lies relative to a frustum, see classify(). */
+enum CullResult
+{
+   CULL_OUTSIDE = 0,       /**< entirely behind one of the planes */
+   CULL_INTERSECTING = 1,  /**< may cross the boundary of the frustum */
+   CULL_INSIDE = 2         /**< entirely in front of all the planes */
+};
+
+/** The plane mask of classify( f, box, planeMask, lastPlane ) with all
+ *  six planes of a frustum to test: bit i stands for Frustum::mPlanes[i].
+ */
+const unsigned int CULL_ALL_PLANES = 0x3f;
+
+namespace helpers
+{
+   /**
+    * Classifies a box against one plane with its p-vertex (the corner
+    * farthest along the plane normal) and n-vertex (the nearest corner):
+    * the box is outside the plane when its p-vertex is behind it, and
+    * crosses it when only its n-vertex is.
+    */
+   template<class DATA_TYPE>
+   inline CullResult classifyBoxPlane( const Plane<DATA_TYPE>& plane,
+                                       const DATA_TYPE minX, const DATA_TYPE minY, const DATA_TYPE minZ,
+                                       const DATA_TYPE maxX, const DATA_TYPE maxY, const DATA_TYPE maxZ )
+   {
+      const DATA_TYPE zero = static_cast<DATA_TYPE>(0);
+      const Vec<DATA_TYPE, 3>& n = plane.mNorm;
+      const bool pos_x = n[0] >= zero, pos_y = n[1] >= zero, pos_z = n[2] >= zero;
+      const DATA_TYPE p_dist = n[0] * (pos_x ? maxX : minX) + n[1] * (pos_y ? maxY : minY) +
+                               n[2] * (pos_z ? maxZ : minZ) + plane.mOffset;
+      if (p_dist < zero)
+      {
+         return CULL_OUTSIDE;
+      }
+      const DATA_TYPE n_dist = n[0] * (pos_x ? minX : maxX) + n[1] * (pos_y ? minY : maxY) +
+                               n[2] * (pos_z ? minZ : maxZ) + plane.mOffset;
+      return (n_dist < zero) ? CULL_INTERSECTING : CULL_INSIDE;
+   }
+
+   /** Classifies a sphere against one normalized plane. */
+   template<class DATA_TYPE>
+   inline CullResult classifySpherePlane( const Plane<DATA_TYPE>& plane,
+                                          const DATA_TYPE x, const DATA_TYPE y, const DATA_TYPE z,
+                                          const DATA_TYPE radius )
+   {
+      const Vec<DATA_TYPE, 3>& n = plane.mNorm;
+      const DATA_TYPE dist = n[0] * x + n[1] * y + n[2] * z + plane.mOffset;
+      if (dist <= -radius)
+      {
+         return CULL_OUTSIDE;
+      }
+      return (dist < radius) ? CULL_INTERSECTING : CULL_INSIDE;
+   }
+
+   /** Classifies a box against the planes of a frustum. */
+   template<class DATA_TYPE>
+   inline CullResult classifyBox( const Frustum<DATA_TYPE>& f,
+                                  const DATA_TYPE minX, const DATA_TYPE minY, const DATA_TYPE minZ,
+                                  const DATA_TYPE maxX, const DATA_TYPE maxY, const DATA_TYPE maxZ )
+   {
+      CullResult result = CULL_INSIDE;
+      for (unsigned int i = 0; i < 6; ++i)
+      {
+         const CullResult plane_result = classifyBoxPlane( f.mPlanes[i], minX, minY, minZ, maxX, maxY, maxZ );
+         if (plane_result == CULL_OUTSIDE)
+         {
+            return CULL_OUTSIDE;
+         }
+         if (plane_result == CULL_INTERSECTING)
+         {
+            result = CULL_INTERSECTING;
+         }
+      }
+      return result;
+   }
+
+   /** Classifies a sphere against the planes of a normalized frustum. */
+   template<class DATA_TYPE>
+   inline CullResult classifySphere( const Frustum<DATA_TYPE>& f,
+                                     const DATA_TYPE x, const DATA_TYPE y, const DATA_TYPE z,
+                                     const DATA_TYPE radius )
+   {
+      CullResult result = CULL_INSIDE;
+      for (unsigned int i = 0; i < 6; ++i)
+      {
+         const CullResult plane_result = classifySpherePlane( f.mPlanes[i], x, y, z, radius );
+         if (plane_result == CULL_OUTSIDE)
+         {
+            return CULL_OUTSIDE;
+         }
+         if (plane_result == CULL_INTERSECTING)
+         {
+            result = CULL_INTERSECTING;
+         }
+      }
+      return result;
+   }
+
+   /** The one plane test of classifyMasked() for a box. */
+   template<class DATA_TYPE>
+   struct BoxPlaneTest
+   {
+      explicit BoxPlaneTest( const AABox<DATA_TYPE>& box )
+         : mBox( box )
+      {
+      }
+
+      CullResult operator()( const Plane<DATA_TYPE>& plane ) const
+      {
+         return classifyBoxPlane( plane, mBox.mMin[0], mBox.mMin[1], mBox.mMin[2],
+                                  mBox.mMax[0], mBox.mMax[1], mBox.mMax[2] );
+      }
+
+      const AABox<DATA_TYPE>& mBox;
+   };
+
+   /** The one plane test of classifyMasked() for a sphere. */
+   template<class DATA_TYPE>
+   struct SpherePlaneTest
+   {
+      explicit SpherePlaneTest( const Sphere<DATA_TYPE>& sphere )
+         : mSphere( sphere )
+      {
+      }
+
+      CullResult operator()( const Plane<DATA_TYPE>& plane ) const
+      {
+         return classifySpherePlane( plane, mSphere.mCenter[0], mSphere.mCenter[1], mSphere.mCenter[2],
+                                     mSphere.mRadius );
+      }
+
+      const Sphere<DATA_TYPE>& mSphere;
+   };
+
+   /**
+    * Classifies a volume against the planes of planeMask with
+    * PLANE_TEST, testing lastPlane first.  See
+    * classify( f, box, planeMask, lastPlane ).
+    */
+   template<class DATA_TYPE, class PLANE_TEST>
+   inline CullResult classifyMasked( const Frustum<DATA_TYPE>& f, const PLANE_TEST& test,
+                                     unsigned int& planeMask, unsigned int& lastPlane )
+   {
+      unsigned int to_test = planeMask & CULL_ALL_PLANES;
+      unsigned int crossed = 0;
+      if (lastPlane < 6 && (to_test & (1u << lastPlane)))
+      {
+         const CullResult plane_result = test( f.mPlanes[lastPlane] );
+         if (plane_result == CULL_OUTSIDE)
+         {
+            return CULL_OUTSIDE;
+         }
+         if (plane_result == CULL_INTERSECTING)
+         {
+            crossed |= 1u << lastPlane;
+         }
+         to_test &= ~(1u << lastPlane);
+      }
+      for (unsigned int i = 0; to_test != 0; ++i, to_test >>= 1)
+      {
+         if (to_test & 1u)
+         {
+            const CullResult plane_result = test( f.mPlanes[i] );
+            if (plane_result == CULL_OUTSIDE)
+            {
+               lastPlane = i;
+               return CULL_OUTSIDE;
+            }
+            if (plane_result == CULL_INTERSECTING)
+            {
+               crossed |= 1u << i;
+            }
+         }
+      }
+      planeMask = crossed;
+      return (crossed != 0) ? CULL_INTERSECTING : CULL_INSIDE;
+   }
+
+   /** The dot product of a and b, without temporaries. */
+   template<class DATA_TYPE>
+   inline DATA_TYPE dotScalar( const DATA_TYPE a[3], const DATA_TYPE b[3] )
+   {
+      return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+   }
+
+   /** The cross product of a and b, without temporaries. */
+   template<class DATA_TYPE>
+   inline void crossScalar( DATA_TYPE result[3], const DATA_TYPE a[3], const DATA_TYPE b[3] )
+   {
+      result[0] = a[1] * b[2] - a[2] * b[1];
+      result[1] = a[2] * b[0] - a[0] * b[2];
+      result[2] = a[0] * b[1] - a[1] * b[0];
+   }
+
+   /**
+    * Computes the corners of a frustum, where three of its planes meet:
+    * the near corners (left bottom, right bottom, right top, left top),
+    * then the far corners in the same order.
+    *
+    * @return false if three of the planes do not meet in a point, e.g. for
+    *         a frustum with planes in their default state
+    */
+   template<class DATA_TYPE>
+   inline bool getFrustumCorners( const Frustum<DATA_TYPE>& f, Point<DATA_TYPE, 3> corners[8] )
+   {
+      typedef Frustum<DATA_TYPE> F;
+      static const unsigned int sides[4][2] = {
+         { F::PLANE_LEFT, F::PLANE_BOTTOM }, { F::PLANE_RIGHT, F::PLANE_BOTTOM },
+         { F::PLANE_RIGHT, F::PLANE_TOP }, { F::PLANE_LEFT, F::PLANE_TOP } };
+      for (unsigned int i = 0; i < 8; ++i)
+      {
+         const Plane<DATA_TYPE>& p1 = f.mPlanes[(i < 4) ? F::PLANE_NEAR : F::PLANE_FAR];
+         const Plane<DATA_TYPE>& p2 = f.mPlanes[sides[i & 3][0]];
+         const Plane<DATA_TYPE>& p3 = f.mPlanes[sides[i & 3][1]];
+         DATA_TYPE c23[3], c31[3], c12[3];
+         crossScalar( c23, p2.mNorm.getData(), p3.mNorm.getData() );
+         crossScalar( c31, p3.mNorm.getData(), p1.mNorm.getData() );
+         crossScalar( c12, p1.mNorm.getData(), p2.mNorm.getData() );
+         const DATA_TYPE det = p1.mNorm[0] * c23[0] + p1.mNorm[1] * c23[1] + p1.mNorm[2] * c23[2];
+         if (det == static_cast<DATA_TYPE>(0))
+         {
+            return false;
+         }
+         // the point where dot( n, p ) + offset is 0 for the three planes
+         const DATA_TYPE inv_det = static_cast<DATA_TYPE>(-1) / det;
+         for (unsigned int k = 0; k < 3; ++k)
+         {
+            corners[i][k] = (c23[k] * p1.mOffset + c31[k] * p2.mOffset + c12[k] * p3.mOffset) * inv_det;
+         }
+      }
+      return true;
+   }
+
+   /**
+    * Computes the separating axis a x b of the directions a and b.
+    *
+    * @return false if a and b are nearly parallel, |a x b|^2 <= 1e-6 |a|^2 |b|^2:
+    *         the axis is then too inexact to separate anything, and
+    *         skipping it is conservative
+    */
+   template<class DATA_TYPE>
+   inline bool getSeparatingAxis( DATA_TYPE axis[3], const DATA_TYPE a[3], const DATA_TYPE b[3] )
+   {
+      crossScalar( axis, a, b );
+      return dotScalar( axis, axis ) > static_cast<DATA_TYPE>(1e-6) * dotScalar( a, a ) * dotScalar( b, b );
+   }
+
+   /**
+    * Gets the directions of the edges of a frustum from its corners (see
+    * getFrustumCorners()).  Edges that are parallel in a perspective or
+    * orthographic frustum give one direction: the opposite edges of the
+    * near face, the far edges and the near ones, and the side edges of an
+    * orthographic frustum.  The directions are not normalized.
+    *
+    * @return the number of directions put in dirs
+    */
+   template<class DATA_TYPE>
+   inline unsigned int getFrustumEdgeDirs( const Point<DATA_TYPE, 3> corners[8], Vec<DATA_TYPE, 3> dirs[12] )
+   {
+      // the corners of each edge, and the earlier edges it may be parallel to
+      static const unsigned int edges[12][2] = {
+         { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 },
+         { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 },
+         { 4, 5 }, { 5, 6 }, { 6, 7 }, { 7, 4 } };
+      static const unsigned int candidates[12] = {
+         0x0, 0x1, 0x3, 0x7,
+         0x0, 0x0, 0x10, 0x20,
+         0x10, 0x20, 0x40, 0x80 };
+      const DATA_TYPE tolerance = static_cast<DATA_TYPE>(1e-6);
+      DATA_TYPE len2[12];
+      unsigned int dir_of[12];
+      unsigned int count = 0;
+      for (unsigned int i = 0; i < 12; ++i)
+      {
+         const Point<DATA_TYPE, 3>& from = corners[edges[i][0]];
+         const Point<DATA_TYPE, 3>& to = corners[edges[i][1]];
+         const DATA_TYPE d[3] = { to[0] - from[0], to[1] - from[1], to[2] - from[2] };
+         const DATA_TYPE d_len2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+         dir_of[i] = 12;
+         if (d_len2 == static_cast<DATA_TYPE>(0))
+         {
+            continue;
+         }
+         for (unsigned int j = 0; j < i && dir_of[i] == 12; ++j)
+         {
+            const unsigned int k = dir_of[j];
+            if (((candidates[i] >> j) & 1u) && k < count)
+            {
+               DATA_TYPE c[3];
+               crossScalar( c, d, dirs[k].getData() );
+               if (c[0] * c[0] + c[1] * c[1] + c[2] * c[2] <= tolerance * d_len2 * len2[k])
+               {
+                  dir_of[i] = k;
+               }
+            }
+         }
+         if (dir_of[i] == 12)
+         {
+            dirs[count].set( d[0], d[1], d[2] );
+            len2[count] = d_len2;
+            dir_of[i] = count++;
+         }
+      }
+      return count;
+   }
+
+   /** Projects count points on axis, giving the range [pmin, pmax]. */
+   template<class DATA_TYPE>
+   inline void projectPoints( const DATA_TYPE axis[3], const Point<DATA_TYPE, 3>* points,
+                              const unsigned int count, DATA_TYPE& pmin, DATA_TYPE& pmax )
+   {
+      pmin = pmax = axis[0] * points[0][0] + axis[1] * points[0][1] + axis[2] * points[0][2];
+      for (unsigned int i = 1; i < count; ++i)
+      {
+         const DATA_TYPE d = axis[0] * points[i][0] + axis[1] * points[i][1] + axis[2] * points[i][2];
+         pmin = (d < pmin) ? d : pmin;
+         pmax = (d > pmax) ? d : pmax;
+      }
+   }
+}
+
+namespace simd
+{
+/** @name Frustum culling kernels
+ *  Each kernel classifies the leading objects it can handle, adds the
+ *  number of them that are not outside to visible and returns how many it
+ *  did, the caller does the rest, with the arithmetic of the scalar
+ *  tests.  The generic versions do none; the float
+ *  (and, with AVX, double) overloads below handle packed views a multiple
+ *  of 4 or 8 objects at a time.
+ * @{
+ */
+template<class DATA_TYPE>
+inline std::size_t batchClassifyBoxes( const Frustum<DATA_TYPE>&, const Vec3ArrayView<const DATA_TYPE>&,
+                                       const Vec3ArrayView<const DATA_TYPE>&, unsigned char*, std::size_t& )
+{ return 0; }
+
+template<class DATA_TYPE>
+inline std::size_t batchClassifySpheres( const Frustum<DATA_TYPE>&, const Vec3ArrayView<const DATA_TYPE>&,
+                                         const DATA_TYPE*, unsigned char*, std::size_t& )
+{ return 0; }
+
+#ifdef GMTL_HAVE_SSE
+/** Stores the CullResult of each lane from the lane masks of the objects
+ *  outside a plane and of those crossing one.
+ *
+ * @return the number of lanes that are not outside
+ */
+template<class OPS>
+inline unsigned int storeCullResults( unsigned char* results, const unsigned int outside,
+                                      const unsigned int intersecting )
+{
+   static const unsigned char table[4] =
+   {
+      CULL_INSIDE, CULL_OUTSIDE, CULL_INTERSECTING, CULL_OUTSIDE
+   };
+   unsigned int visible = OPS::Width;
+   for (unsigned int lane = 0; lane < OPS::Width; ++lane)
+   {
+      results[lane] = table[((outside >> lane) & 1u) | (((intersecting >> lane) & 1u) << 1)];
+      visible -= (outside >> lane) & 1u;
+   }
+   return visible;
+}
+
+/** helpers::classifyBox() on OPS::Width boxes at a time.  The p-vertex of
+ *  a plane is the same corner for all the boxes, so it is a choice of
+ *  column rather than a per lane select.
+ */
+template<class OPS>
+inline std::size_t batchClassifyBoxesSimd( const Frustum<typename OPS::Scalar>& f,
+                                           const Vec3ArrayView<const typename OPS::Scalar>& mins,
+                                           const Vec3ArrayView<const typename OPS::Scalar>& maxs,
+                                           unsigned char* results, std::size_t& visible )
+{
+   typedef typename OPS::Scalar Scalar;
+   typedef typename OPS::Reg Reg;
+   if (!(mins.isPacked() && maxs.isPacked()))
+   {
+      return 0;
+   }
+   const Scalar zero = static_cast<Scalar>(0);
+   const Scalar* min_cols[3] = { mins.mX, mins.mY, mins.mZ };
+   const Scalar* max_cols[3] = { maxs.mX, maxs.mY, maxs.mZ };
+   const Scalar* p_cols[6][3];
+   const Scalar* n_cols[6][3];
+   for (unsigned int i = 0; i < 6; ++i)
+   {
+      for (unsigned int axis = 0; axis < 3; ++axis)
+      {
+         const bool pos = f.mPlanes[i].mNorm[axis] >= zero;
+         p_cols[i][axis] = pos ? max_cols[axis] : min_cols[axis];
+         n_cols[i][axis] = pos ? min_cols[axis] : max_cols[axis];
+      }
+   }
+
+   // the planes, broadcast once: the results may alias them
+   Reg planes[6][4];
+   for (unsigned int i = 0; i < 6; ++i)
+   {
+      planes[i][0] = OPS::set1( f.mPlanes[i].mNorm[0] );
+      planes[i][1] = OPS::set1( f.mPlanes[i].mNorm[1] );
+      planes[i][2] = OPS::set1( f.mPlanes[i].mNorm[2] );
+      planes[i][3] = OPS::set1( f.mPlanes[i].mOffset );
+   }
+
+   const Reg zeros = OPS::set1( zero );
+   const std::size_t n = mins.size() & ~std::size_t( OPS::Width - 1 );
+   for (std::size_t j = 0; j < n; j += OPS::Width)
+   {
+      Reg outside = zeros, intersecting = zeros;
+      for (unsigned int i = 0; i < 6; ++i)
+      {
+         const Reg p_dist = OPS::add( OPS::add( OPS::add( OPS::mul( planes[i][0], OPS::load( p_cols[i][0] + j ) ),
+                                                          OPS::mul( planes[i][1], OPS::load( p_cols[i][1] + j ) ) ),
+                                                 OPS::mul( planes[i][2], OPS::load( p_cols[i][2] + j ) ) ),
+                                      planes[i][3] );
+         const Reg n_dist = OPS::add( OPS::add( OPS::add( OPS::mul( planes[i][0], OPS::load( n_cols[i][0] + j ) ),
+                                                          OPS::mul( planes[i][1], OPS::load( n_cols[i][1] + j ) ) ),
+                                                 OPS::mul( planes[i][2], OPS::load( n_cols[i][2] + j ) ) ),
+                                      planes[i][3] );
+         outside = OPS::bitOr( outside, OPS::lt( p_dist, zeros ) );
+         intersecting = OPS::bitOr( intersecting, OPS::lt( n_dist, zeros ) );
+      }
+      visible += storeCullResults<OPS>( results + j, OPS::movemask( outside ), OPS::movemask( intersecting ) );
+   }
+   return n;
+}
+
+/** helpers::classifySphere() on OPS::Width spheres at a time. */
+template<class OPS>
+inline std::size_t batchClassifySpheresSimd( const Frustum<typename OPS::Scalar>& f,
+                                             const Vec3ArrayView<const typename OPS::Scalar>& centers,
+                                             const typename OPS::Scalar* radii, unsigned char* results,
+                                             std::size_t& visible )
+{
+   typedef typename OPS::Scalar Scalar;
+   typedef typename OPS::Reg Reg;
+   if (!centers.isPacked())
+   {
+      return 0;
+   }
+   Reg planes[6][4];
+   for (unsigned int i = 0; i < 6; ++i)
+   {
+      planes[i][0] = OPS::set1( f.mPlanes[i].mNorm[0] );
+      planes[i][1] = OPS::set1( f.mPlanes[i].mNorm[1] );
+      planes[i][2] = OPS::set1( f.mPlanes[i].mNorm[2] );
+      planes[i][3] = OPS::set1( f.mPlanes[i].mOffset );
+   }
+
+   const Reg zeros = OPS::set1( static_cast<Scalar>(0) );
+   const std::size_t n = centers.size() & ~std::size_t( OPS::Width - 1 );
+   for (std::size_t j = 0; j < n; j += OPS::Width)
+   {
+      const Reg x = OPS::load( centers.mX + j );
+      const Reg y = OPS::load( centers.mY + j );
+      const Reg z = OPS::load( centers.mZ + j );
+      const Reg radius = OPS::load( radii + j );
+      const Reg neg_radius = OPS::sub( zeros, radius );
+      Reg outside = zeros, intersecting = zeros;
+      for (unsigned int i = 0; i < 6; ++i)
+      {
+         const Reg dist = OPS::add( OPS::add( OPS::add( OPS::mul( planes[i][0], x ), OPS::mul( planes[i][1], y ) ),
+                                               OPS::mul( planes[i][2], z ) ),
+                                    planes[i][3] );
+         outside = OPS::bitOr( outside, OPS::le( dist, neg_radius ) );
+         intersecting = OPS::bitOr( intersecting, OPS::lt( dist, radius ) );
+      }
+      visible += storeCullResults<OPS>( results + j, OPS::movemask( outside ), OPS::movemask( intersecting ) );
+   }
+   return n;
+}
+
+inline std::size_t batchClassifyBoxes( const Frustum<float>& f, const Vec3ArrayView<const float>& mins,
+                                       const Vec3ArrayView<const float>& maxs, unsigned char* results,
+                                       std::size_t& visible )
+{
+#ifdef GMTL_HAVE_AVX
+   return batchClassifyBoxesSimd<Float8Ops>( f, mins, maxs, results, visible );
+#else
+   return batchClassifyBoxesSimd<Float4Ops>( f, mins, maxs, results, visible );
+#endif
+}
+
+inline std::size_t batchClassifySpheres( const Frustum<float>& f, const Vec3ArrayView<const float>& centers,
+                                         const float* radii, unsigned char* results, std::size_t& visible )
+{
+#ifdef GMTL_HAVE_AVX
+   return batchClassifySpheresSimd<Float8Ops>( f, centers, radii, results, visible );
+#else
+   return batchClassifySpheresSimd<Float4Ops>( f, centers, radii, results, visible );
+#endif
+}
+#endif
+
+#ifdef GMTL_HAVE_AVX
+inline std::size_t batchClassifyBoxes( const Frustum<double>& f, const Vec3ArrayView<const double>& mins,
+                                       const Vec3ArrayView<const double>& maxs, unsigned char* results,
+                                       std::size_t& visible )
+{
+   return batchClassifyBoxesSimd<Double4Ops>( f, mins, maxs, results, visible );
+}
+
+inline std::size_t batchClassifySpheres( const Frustum<double>& f, const Vec3ArrayView<const double>& centers,
+                                         const double* radii, unsigned char* results, std::size_t& visible )
+{
+   return batchClassifySpheresSimd<Double4Ops>( f, centers, radii, results, visible );
+}
+#endif
+/** @} */
+}
+
+namespace helpers
+{
+   /** Computes the plane equations of all the lanes of a FrustumPlaneBlock
+    *  at a point, padding included.
+    */
+   template<class DATA_TYPE>
+   inline void getPlaneBlockDistances( const FrustumPlaneBlock<DATA_TYPE>& planes,
+                                       const DATA_TYPE x, const DATA_TYPE y, const DATA_TYPE z,
+                                       DATA_TYPE* result )
+   {
+      for (unsigned int i = 0; i < FrustumPlaneBlock<DATA_TYPE>::Size; ++i)
+      {
+         result[i] = planes.mNormX[i] * x + planes.mNormY[i] * y + planes.mNormZ[i] * z + planes.mOffset[i];
+      }
+   }
+
+   /** classifyBox() against the planes of a FrustumPlaneBlock. */
+   template<class DATA_TYPE>
+   inline CullResult classifyBoxPlaneBlock( const FrustumPlaneBlock<DATA_TYPE>& planes,
+                                            const DATA_TYPE minX, const DATA_TYPE minY, const DATA_TYPE minZ,
+                                            const DATA_TYPE maxX, const DATA_TYPE maxY, const DATA_TYPE maxZ )
+   {
+      CullResult result = CULL_INSIDE;
+      for (unsigned int i = 0; i < 6; ++i)
+      {
+         const CullResult plane_result = classifyBoxPlane( planes.getPlane( i ), minX, minY, minZ,
+                                                           maxX, maxY, maxZ );
+         if (plane_result == CULL_OUTSIDE)
+         {
+            return CULL_OUTSIDE;
+         }
+         if (plane_result == CULL_INTERSECTING)
+         {
+            result = CULL_INTERSECTING;
+         }
+      }
+      return result;
+   }
+
+   /** classifySphere() against the planes of a FrustumPlaneBlock. */
+   template<class DATA_TYPE>
+   inline CullResult classifySpherePlaneBlock( const FrustumPlaneBlock<DATA_TYPE>& planes,
+                                               const DATA_TYPE x, const DATA_TYPE y, const DATA_TYPE z,
+                                               const DATA_TYPE radius )
+   {
+      CullResult result = CULL_INSIDE;
+      for (unsigned int i = 0; i < 6; ++i)
+      {
+         const DATA_TYPE dist = planes.mNormX[i] * x + planes.mNormY[i] * y + planes.mNormZ[i] * z +
+                                planes.mOffset[i];
+         if (dist <= -radius)
+         {
+            return CULL_OUTSIDE;
+         }
+         if (dist < radius)
+         {
+            result = CULL_INTERSECTING;
+         }
+      }
+      return result;
+   }
+
+#ifdef GMTL_HAVE_SSE
+   /** The plane equations of OPS::Width lanes of a FrustumPlaneBlock,
+    *  starting at lane i, at the point (x, y, z).
+    */
+   template<class OPS>
+   inline typename OPS::Reg evalPlaneBlock( const FrustumPlaneBlock<typename OPS::Scalar>& planes,
+                                            const unsigned int i, const typename OPS::Reg x,
+                                            const typename OPS::Reg y, const typename OPS::Reg z )
+   {
+      return OPS::add( OPS::add( OPS::add( OPS::mul( OPS::load( planes.mNormX + i ), x ),
+                                           OPS::mul( OPS::load( planes.mNormY + i ), y ) ),
+                                 OPS::mul( OPS::load( planes.mNormZ + i ), z ) ),
+                       OPS::load( planes.mOffset + i ) );
+   }
+
+   /** getPlaneBlockDistances() on OPS::Width lanes at a time. */
+   template<class OPS>
+   inline void getPlaneBlockDistancesSimd( const FrustumPlaneBlock<typename OPS::Scalar>& planes,
+                                           const typename OPS::Scalar x, const typename OPS::Scalar y,
+                                           const typename OPS::Scalar z, typename OPS::Scalar* result )
+   {
+      typedef typename OPS::Reg Reg;
+      const Reg vx = OPS::set1( x ), vy = OPS::set1( y ), vz = OPS::set1( z );
+      for (unsigned int i = 0; i < FrustumPlaneBlock<typename OPS::Scalar>::Size; i += OPS::Width)
+      {
+         OPS::store( result + i, evalPlaneBlock<OPS>( planes, i, vx, vy, vz ) );
+      }
+   }
+
+   /** classifyBoxPlaneBlock() on OPS::Width planes at a time.  Each lane
+    *  picks its own p-vertex and n-vertex from the signs of its normal.
+    */
+   template<class OPS>
+   inline CullResult classifyBoxPlaneBlockSimd( const FrustumPlaneBlock<typename OPS::Scalar>& planes,
+                                                const typename OPS::Scalar minX, const typename OPS::Scalar minY,
+                                                const typename OPS::Scalar minZ, const typename OPS::Scalar maxX,
+                                                const typename OPS::Scalar maxY, const typename OPS::Scalar maxZ )
+   {
+      typedef typename OPS::Scalar Scalar;
+      typedef typename OPS::Reg Reg;
+      const Reg zeros = OPS::set1( static_cast<Scalar>(0) );
+      const Reg min_x = OPS::set1( minX ), min_y = OPS::set1( minY ), min_z = OPS::set1( minZ );
+      const Reg max_x = OPS::set1( maxX ), max_y = OPS::set1( maxY ), max_z = OPS::set1( maxZ );
+      unsigned int outside = 0, intersecting = 0;
+      for (unsigned int i = 0; i < FrustumPlaneBlock<Scalar>::Size; i += OPS::Width)
+      {
+         const Reg nx = OPS::load( planes.mNormX + i ), ny = OPS::load( planes.mNormY + i ),
+                   nz = OPS::load( planes.mNormZ + i ), offset = OPS::load( planes.mOffset + i );
+         const Reg pos_x = OPS::ge( nx, zeros ), pos_y = OPS::ge( ny, zeros ), pos_z = OPS::ge( nz, zeros );
+         const Reg p_dist = OPS::add( OPS::add( OPS::add(
+            OPS::mul( nx, OPS::bitOr( OPS::bitAnd( pos_x, max_x ), OPS::bitAndNot( pos_x, min_x ) ) ),
+            OPS::mul( ny, OPS::bitOr( OPS::bitAnd( pos_y, max_y ), OPS::bitAndNot( pos_y, min_y ) ) ) ),
+            OPS::mul( nz, OPS::bitOr( OPS::bitAnd( pos_z, max_z ), OPS::bitAndNot( pos_z, min_z ) ) ) ), offset );
+         const Reg n_dist = OPS::add( OPS::add( OPS::add(
+            OPS::mul( nx, OPS::bitOr( OPS::bitAnd( pos_x, min_x ), OPS::bitAndNot( pos_x, max_x ) ) ),
+            OPS::mul( ny, OPS::bitOr( OPS::bitAnd( pos_y, min_y ), OPS::bitAndNot( pos_y, max_y ) ) ) ),
+            OPS::mul( nz, OPS::bitOr( OPS::bitAnd( pos_z, min_z ), OPS::bitAndNot( pos_z, max_z ) ) ) ), offset );
+         outside |= OPS::movemask( OPS::lt( p_dist, zeros ) );
+         intersecting |= OPS::movemask( OPS::lt( n_dist, zeros ) );
+      }
+      if (outside != 0)
+      {
+         return CULL_OUTSIDE;
+      }
+      return (intersecting != 0) ? CULL_INTERSECTING : CULL_INSIDE;
+   }
+
+   /** classifySpherePlaneBlock() on OPS::Width planes at a time. */
+   template<class OPS>
+   inline CullResult classifySpherePlaneBlockSimd( const FrustumPlaneBlock<typename OPS::Scalar>& planes,
+                                                   const typename OPS::Scalar x, const typename OPS::Scalar y,
+                                                   const typename OPS::Scalar z, const typename OPS::Scalar radius )
+   {
+      typedef typename OPS::Reg Reg;
+      const Reg vx = OPS::set1( x ), vy = OPS::set1( y ), vz = OPS::set1( z );
+      const Reg pos_radius = OPS::set1( radius ), neg_radius = OPS::set1( -radius );
+      unsigned int outside = 0, intersecting = 0;
+      for (unsigned int i = 0; i < FrustumPlaneBlock<typename OPS::Scalar>::Size; i += OPS::Width)
+      {
+         const Reg dist = evalPlaneBlock<OPS>( planes, i, vx, vy, vz );
+         outside |= OPS::movemask( OPS::le( dist, neg_radius ) );
+         intersecting |= OPS::movemask( OPS::lt( dist, pos_radius ) );
+      }
+      if (outside != 0)
+      {
+         return CULL_OUTSIDE;
+      }
+      return (intersecting != 0) ? CULL_INTERSECTING : CULL_INSIDE;
+   }
+
+   /** The float version of getPlaneBlockDistances(), all the planes at
+    *  once with AVX or a group of 4 at a time with SSE.
+    */
+   inline void getPlaneBlockDistances( const FrustumPlaneBlock<float>& planes,
+                                       const float x, const float y, const float z, float* result )
+   {
+#ifdef GMTL_HAVE_AVX
+      getPlaneBlockDistancesSimd<simd::Float8Ops>( planes, x, y, z, result );
+#else
+      getPlaneBlockDistancesSimd<simd::Float4Ops>( planes, x, y, z, result );
+#endif
+   }
+
+   /** The float version of classifyBoxPlaneBlock(). */
+   inline CullResult classifyBoxPlaneBlock( const FrustumPlaneBlock<float>& planes,
+                                            const float minX, const float minY, const float minZ,
+                                            const float maxX, const float maxY, const float maxZ )
+   {
+#ifdef GMTL_HAVE_AVX
+      return classifyBoxPlaneBlockSimd<simd::Float8Ops>( planes, minX, minY, minZ, maxX, maxY, maxZ );
+#else
+      return classifyBoxPlaneBlockSimd<simd::Float4Ops>( planes, minX, minY, minZ, maxX, maxY, maxZ );
+#endif
+   }
+
+   /** The float version of classifySpherePlaneBlock(). */
+   inline CullResult classifySpherePlaneBlock( const FrustumPlaneBlock<float>& planes,
+                                               const float x, const float y, const float z, const float radius )
+   {
+#ifdef GMTL_HAVE_AVX
+      return classifySpherePlaneBlockSimd<simd::Float8Ops>( planes, x, y, z, radius );
+#else
+      return classifySpherePlaneBlockSimd<simd::Float4Ops>( planes, x, y, z, radius );
+#endif
+   }
+#endif
+
+#ifdef GMTL_HAVE_AVX
+   /** The double versions, a group of 4 planes at a time with AVX. */
+   inline void getPlaneBlockDistances( const FrustumPlaneBlock<double>& planes,
+                                       const double x, const double y, const double z, double* result )
+   {
+      getPlaneBlockDistancesSimd<simd::Double4Ops>( planes, x, y, z, result );
+   }
+
+   inline CullResult classifyBoxPlaneBlock( const FrustumPlaneBlock<double>& planes,
+                                            const double minX, const double minY, const double minZ,
+                                            const double maxX, const double maxY, const double maxZ )
+   {
+      return classifyBoxPlaneBlockSimd<simd::Double4Ops>( planes, minX, minY, minZ, maxX, maxY, maxZ );
+   }
+
+   inline CullResult classifySpherePlaneBlock( const FrustumPlaneBlock<double>& planes,
+                                               const double x, const double y, const double z,
+                                               const double radius )
+   {
+      return classifySpherePlaneBlockSimd<simd::Double4Ops>( planes, x, y, z, radius );
+   }
+#endif
+}
+
+/** @ingroup Ops
+ * @name Frustum Culling
+ * Classification of boxes and spheres against the planes of a frustum as
+ * outside, intersecting or inside (see CullResult).  The frustum planes
+ * face inwards: a point p is in front of plane i when
+ * dot(mPlanes[i].mNorm, p) + mPlanes[i].mOffset >= 0, as Frustum extracts
+ * them.  The sphere tests need normalized planes (see normalize()), the box
+ * tests do not.
+ *
+ * The batch versions write one CullResult per object to results and
+ * return the number of objects that are not outside.  They do the same
+ * arithmetic as the single object versions, so an object only gets
+ * another result when it touches a plane to within rounding and the
+ * compiler contracts one of them into FMAs.  Packed views (see Vec3Array)
+ * are classified 4 (SSE) or 8 (AVX) objects at a time, and arrays of AABox
+ * or Sphere are copied to packed blocks first.
+ * @{
+ */
+
+/**
+ * Classifies a box against a frustum with the p-vertex/n-vertex test.  An
+ * uninitialized box is outside.
+ *
+ * The result is exact for each plane, but a large box outside the frustum
+ * near one of its edges, in front of every plane, is reported as
+ * intersecting.
+ */
+template<class DATA_TYPE>
+inline CullResult classify( const Frustum<DATA_TYPE>& f, const AABox<DATA_TYPE>& box )
+{
+   if (!box.isInitialized())
+   {
+      return CULL_OUTSIDE;
+   }
+   return helpers::classifyBox( f, box.mMin[0], box.mMin[1], box.mMin[2],
+                                box.mMax[0], box.mMax[1], box.mMax[2] );
+}
+
+/**
+ * Classifies a sphere against a normalized frustum.  An uninitialized
+ * sphere is outside; otherwise the sphere is outside exactly when
+ * isInVolume(f, sphere) is false.
+ */
+template<class DATA_TYPE>
+inline CullResult classify( const Frustum<DATA_TYPE>& f, const Sphere<DATA_TYPE>& sphere )
+{
+   if (!sphere.isInitialized())
+   {
+      return CULL_OUTSIDE;
+   }
+   return helpers::classifySphere( f, sphere.mCenter[0], sphere.mCenter[1], sphere.mCenter[2],
+                                   sphere.mRadius );
+}
+
+/**
+ * Classifies a box against the planes of a frustum in planeMask, for
+ * culling a hierarchy of bounding volumes front to back: a child only
+ * needs the planes its parent crosses, since it is inside the others too.
+ * Start the root with CULL_ALL_PLANES, and give each child the mask its
+ * parent was left with; a mask of 0 means the whole subtree is inside.
+ *
+ * lastPlane caches the plane that culled the box the last time (e.g. the
+ * previous frame).  That plane is tested first, as it is the one most
+ * likely to cull the box again; keep one per object, initialized to any
+ * value (6 or more for no plane).
+ *
+ * With planeMask == CULL_ALL_PLANES the result is the same as
+ * classify(f, box).
+ *
+ * @param planeMask  the planes to test, bit i for f.mPlanes[i]; if the
+ *                   box is not outside, set to the planes it crosses
+ * @param lastPlane  the plane to test first; if the box is outside, set to
+ *                   the plane that culled it
+ */
+template<class DATA_TYPE>
+inline CullResult classify( const Frustum<DATA_TYPE>& f, const AABox<DATA_TYPE>& box,
+                            unsigned int& planeMask, unsigned int& lastPlane )
+{
+   if (!box.isInitialized())
+   {
+      return CULL_OUTSIDE;
+   }
+   return helpers::classifyMasked( f, helpers::BoxPlaneTest<DATA_TYPE>( box ), planeMask, lastPlane );
+}
+
+/**
+ * Classifies a sphere against the planes of a normalized frustum in
+ * planeMask, testing lastPlane first; see
+ * classify(f, box, planeMask, lastPlane).
+ */
+template<class DATA_TYPE>
+inline CullResult classify( const Frustum<DATA_TYPE>& f, const Sphere<DATA_TYPE>& sphere,
+                            unsigned int& planeMask, unsigned int& lastPlane )
+{
+   if (!sphere.isInitialized())
+   {
+      return CULL_OUTSIDE;
+   }
+   return helpers::classifyMasked( f, helpers::SpherePlaneTest<DATA_TYPE>( sphere ), planeMask, lastPlane );
+}
+
+/**
+ * Classifies the boxes (mins[i], maxs[i]) against a frustum.
+ *
+ * @param results    array of mins.size() elements, each set to a CullResult
+ * @pre mins and maxs have the same size
+ * @return the number of boxes that are not outside
+ */
+template<class DATA_TYPE>
+inline std::size_t classify( const Frustum<DATA_TYPE>& f,
+                             const typename Vec3ArrayView<DATA_TYPE>::ConstView& mins,
+                             const typename Vec3ArrayView<DATA_TYPE>::ConstView& maxs,
+                             unsigned char* results )
+{
+   gmtlASSERT( mins.size() == maxs.size() );
+   std::size_t visible = 0;
+   for (std::size_t i = simd::batchClassifyBoxes( f, mins, maxs, results, visible ); i < mins.size(); ++i)
+   {
+      const CullResult result =
+         helpers::classifyBox( f, mins.x( i ), mins.y( i ), mins.z( i ), maxs.x( i ), maxs.y( i ), maxs.z( i ) );
+      results[i] = static_cast<unsigned char>( result );
+      visible += (result != CULL_OUTSIDE) ? 1 : 0;
+   }
+   return visible;
+}
+
+/**
+ * Classifies the spheres (centers[i], radii[i]) against a normalized
+ * frustum.
+ *
+ * @param results    array of centers.size() elements, each set to a
+ *                   CullResult
+ * @return the number of spheres that are not outside
+ */
+template<class DATA_TYPE>
+inline std::size_t classify( const Frustum<DATA_TYPE>& f,
+                             const typename Vec3ArrayView<DATA_TYPE>::ConstView& centers,
+                             const DATA_TYPE* radii, unsigned char* results )
+{
+   std::size_t visible = 0;
+   for (std::size_t i = simd::batchClassifySpheres( f, centers, radii, results, visible ); i < centers.size(); ++i)
+   {
+      const CullResult result =
+         helpers::classifySphere( f, centers.x( i ), centers.y( i ), centers.z( i ), radii[i] );
+      results[i] = static_cast<unsigned char>( result );
+      visible += (result != CULL_OUTSIDE) ? 1 : 0;
+   }
+   return visible;
+}
+
+/**
+ * Classifies count boxes against a frustum, as classify(f, boxes[i]).
+ *
+ * @param results    array of count elements, each set to a CullResult
+ * @return the number of boxes that are not outside
+ */
+template<class DATA_TYPE>
+inline std::size_t classify( const Frustum<DATA_TYPE>& f, const AABox<DATA_TYPE>* boxes,
+                             const std::size_t count, unsigned char* results )
+{
+   enum { BlockSize = 64 };
+   DATA_TYPE block[6][BlockSize];
+   std::size_t visible = 0;
+   for (std::size_t first = 0; first < count; first += BlockSize)
    {
-      Vec<DATA_TYPE, 3> n = f.mPlanes[i].getNormal();
-      DATA_TYPE o = f.mPlanes[i].getOffset();
-      DATA_TYPE len = Math::sqrt( n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
-      n[0] /= len;
-      n[1] /= len;
-      n[2] /= len;
-      o /= len;
-      f.mPlanes[i].setNormal(n);
-      f.mPlanes[i].setOffset(o);
+      const std::size_t size = (count - first < std::size_t( BlockSize )) ? count - first : std::size_t( BlockSize );
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         const AABox<DATA_TYPE>& box = boxes[first + i];
+         for (unsigned int axis = 0; axis < 3; ++axis)
+         {
+            block[axis][i] = box.mMin[axis];
+            block[axis + 3][i] = box.mMax[axis];
+         }
+      }
+      visible += classify( f, Vec3ArrayView<const DATA_TYPE>( block[0], block[1], block[2], size ),
+                           Vec3ArrayView<const DATA_TYPE>( block[3], block[4], block[5], size ),
+                           results + first );
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         if (!boxes[first + i].isInitialized() && results[first + i] != CULL_OUTSIDE)
+         {
+            results[first + i] = CULL_OUTSIDE;
+            --visible;
+         }
+      }
    }
+   return visible;
 }
 
+/**
+ * Classifies count spheres against a normalized frustum, as
+ * classify(f, spheres[i]).
+ *
+ * @param results    array of count elements, each set to a CullResult
+ * @return the number of spheres that are not outside
+ */
+template<class DATA_TYPE>
+inline std::size_t classify( const Frustum<DATA_TYPE>& f, const Sphere<DATA_TYPE>* spheres,
+                             const std::size_t count, unsigned char* results )
+{
+   enum { BlockSize = 64 };
+   DATA_TYPE block[4][BlockSize];
+   std::size_t visible = 0;
+   for (std::size_t first = 0; first < count; first += BlockSize)
+   {
+      const std::size_t size = (count - first < std::size_t( BlockSize )) ? count - first : std::size_t( BlockSize );
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         const Sphere<DATA_TYPE>& sphere = spheres[first + i];
+         block[0][i] = sphere.mCenter[0];
+         block[1][i] = sphere.mCenter[1];
+         block[2][i] = sphere.mCenter[2];
+         block[3][i] = sphere.mRadius;
+      }
+      visible += classify( f, Vec3ArrayView<const DATA_TYPE>( block[0], block[1], block[2], size ),
+                           static_cast<const DATA_TYPE*>( block[3] ), results + first );
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         if (!spheres[first + i].isInitialized() && results[first + i] != CULL_OUTSIDE)
+         {
+            results[first + i] = CULL_OUTSIDE;
+            --visible;
+         }
+      }
+   }
+   return visible;
+}
+
+/** @} */
+
+/** @ingroup Ops
+ * @name Packed Frustum Planes
+ * Tests against the planes of a frustum packed in a FrustumPlaneBlock,
+ * which evaluate 4 planes per instruction (SSE, and AVX for double) or
+ * all of them (AVX for float).  They do the same arithmetic as the tests
+ * against the frustum the block was copied from, so the results only
+ * differ by rounding where the compiler contracts one of them into FMAs;
+ * as there, the sphere test needs normalized planes.
+ * @{
+ */
+
+/**
+ * Computes the plane equation of each lane of a FrustumPlaneBlock at a
+ * point: result[i] is the signed distance from pt to plane i if the planes
+ * are normalized.  The padding lanes 6 and 7 get a huge positive value.
+ *
+ * @param result  array of FrustumPlaneBlock::Size (8) elements
+ */
+template<class DATA_TYPE>
+inline void getDistances( const FrustumPlaneBlock<DATA_TYPE>& planes, const Point<DATA_TYPE, 3>& pt,
+                          DATA_TYPE* result )
+{
+   helpers::getPlaneBlockDistances( planes, pt[0], pt[1], pt[2], result );
+}
+
+/**
+ * Classifies a box against packed frustum planes, as classify(f, box).
+ */
+template<class DATA_TYPE>
+inline CullResult classify( const FrustumPlaneBlock<DATA_TYPE>& planes, const AABox<DATA_TYPE>& box )
+{
+   if (!box.isInitialized())
+   {
+      return CULL_OUTSIDE;
+   }
+   return helpers::classifyBoxPlaneBlock( planes, box.mMin[0], box.mMin[1], box.mMin[2],
+                                          box.mMax[0], box.mMax[1], box.mMax[2] );
+}
+
+/**
+ * Classifies a sphere against normalized packed frustum planes, as
+ * classify(f, sphere).
+ */
+template<class DATA_TYPE>
+inline CullResult classify( const FrustumPlaneBlock<DATA_TYPE>& planes, const Sphere<DATA_TYPE>& sphere )
+{
+   if (!sphere.isInitialized())
+   {
+      return CULL_OUTSIDE;
+   }
+   return helpers::classifySpherePlaneBlock( planes, sphere.mCenter[0], sphere.mCenter[1], sphere.mCenter[2],
+                                             sphere.mRadius );
+}
+
+/** @} */
+
 }
 
 
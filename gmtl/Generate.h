@@ -767,7 +767,7 @@ namespace gmtl
         Vec<T, 3> s( f ^ up ); normalize( s );
         Vec<T, 3> u( s ^ f ); normalize( u );
 
-        Matrix<T, 4,4> orient;
+        Matrix<T, 4,4> orient( NO_INIT );
         zero( orient );
         orient(0,0) = s[0]; orient(1,0) = u[0]; orient(2,0) = -f[0];
         orient(0,1) = s[1]; orient(1,1) = u[1]; orient(2,1) = -f[1];
@@ -1203,11 +1203,13 @@ namespace gmtl
     *
     * @param src     the matrix to compute the inverse of
     *
-    * @return  the inverse of source
+    * @return  the inverse of source, or the identity with the error state
+    *          set if source is singular
     */
    template< typename DATA_TYPE, unsigned ROWS, unsigned COLS >
    inline Matrix<DATA_TYPE, ROWS, COLS> makeInvert(const Matrix<DATA_TYPE, ROWS, COLS>& src)
    {
+      // not NO_INIT: invert() does not write the result of a singular matrix
       Matrix<DATA_TYPE, ROWS, COLS> result;
       return invert( result, src );
    }
@@ -1484,7 +1486,7 @@ namespace gmtl
    template< typename DATA_TYPE, unsigned ROWS, unsigned COLS >
    Vec<DATA_TYPE, COLS> makeRow(const Matrix<DATA_TYPE, ROWS, COLS>& src, unsigned row)
    {
-      Vec<DATA_TYPE, COLS> result;
+      Vec<DATA_TYPE, COLS> result( NO_INIT );
       setRow(result, src, row);
       return result;
    }
@@ -1516,7 +1518,7 @@ namespace gmtl
    template< typename DATA_TYPE, unsigned ROWS, unsigned COLS >
    Vec<DATA_TYPE, ROWS> makeColumn(const Matrix<DATA_TYPE, ROWS, COLS>& src, unsigned col)
    {
-      Vec<DATA_TYPE, ROWS> result;
+      Vec<DATA_TYPE, ROWS> result( NO_INIT );
       setColumn(result, src, col);
       return result;
    }
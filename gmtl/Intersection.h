@@ -19,6 +19,8 @@
 #include <gmtl/LineSeg.h>
 #include <gmtl/Tri.h>
 #include <gmtl/PlaneOps.h>
+#include <gmtl/Frustum.h>
+#include <gmtl/FrustumOps.h>
 
 namespace gmtl
 {
@@ -790,14 +792,15 @@ namespace gmtl
     *         isect = ray.dir * t + ray.origin
     *  @return true if the ray intersects the triangle.
     *  @see from http://www.acm.org/jgt/papers/MollerTrumbore97/code.html
+    *  @see intersectWatertight(), and TriBlock to test many triangles at once
     */
    template<class DATA_TYPE>
    bool intersect(const Tri<DATA_TYPE>& tri, const Ray<DATA_TYPE>& ray,
-                  float& u, float& v, float& t)
+                  DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t)
    {
-      const float EPSILON = static_cast<DATA_TYPE>(0.00001);
+      const DATA_TYPE EPSILON = static_cast<DATA_TYPE>(0.00001);
       Vec<DATA_TYPE, 3> edge1, edge2, tvec, pvec, qvec;
-      float det,inv_det;
+      DATA_TYPE det,inv_det;
 
       /* find vectors for two edges sharing vert0 */
       edge1 = tri[1] - tri[0];
@@ -819,7 +822,7 @@ namespace gmtl
 
       /* calculate U parameter and test bounds */
       u = gmtl::dot(tvec, pvec);
-      if (u < 0.0 || u > det)
+      if (u < static_cast<DATA_TYPE>(0) || u > det)
       {
          return false;
       }
@@ -829,7 +832,7 @@ namespace gmtl
 
       /* calculate V parameter and test bounds */
       v = gmtl::dot( ray.getDir(), qvec );
-      if (v < 0.0 || u + v > det)
+      if (v < static_cast<DATA_TYPE>(0) || u + v > det)
       {
          return false;
       }
@@ -915,6 +918,134 @@ namespace gmtl
       return t >= static_cast<DATA_TYPE>(0);
    }
 
+namespace helpers
+{
+   /** The test of intersectWatertight() and intersectWatertightDoubleSided(). */
+   template<class DATA_TYPE>
+   bool intersectWatertight(const Tri<DATA_TYPE>& tri, const Ray<DATA_TYPE>& ray,
+                            const bool doubleSided,
+                            DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t)
+   {
+      const DATA_TYPE zero = static_cast<DATA_TYPE>(0);
+      const Vec<DATA_TYPE, 3>& dir = ray.getDir();
+
+      // Pick z as the largest axis of the direction; swapping x and y for a
+      // negative z keeps the winding of the triangle.
+      int kz = 0;
+      if (Math::abs(dir[1]) > Math::abs(dir[kz]))
+      {
+         kz = 1;
+      }
+      if (Math::abs(dir[2]) > Math::abs(dir[kz]))
+      {
+         kz = 2;
+      }
+      if (!(Math::abs(dir[kz]) > zero))
+      {
+         return false;
+      }
+      int kx = (kz + 1) % 3;
+      int ky = (kx + 1) % 3;
+      if (dir[kz] < zero)
+      {
+         std::swap(kx, ky);
+      }
+
+      // Move the vertices so the ray starts at the origin, and shear them
+      // so it points down +z.
+      const DATA_TYPE sx = dir[kx] / dir[kz];
+      const DATA_TYPE sy = dir[ky] / dir[kz];
+      const DATA_TYPE sz = static_cast<DATA_TYPE>(1.0) / dir[kz];
+      const Vec<DATA_TYPE, 3> a = tri[0] - ray.getOrigin();
+      const Vec<DATA_TYPE, 3> b = tri[1] - ray.getOrigin();
+      const Vec<DATA_TYPE, 3> c = tri[2] - ray.getOrigin();
+      const DATA_TYPE ax = a[kx] - sx * a[kz];
+      const DATA_TYPE ay = a[ky] - sy * a[kz];
+      const DATA_TYPE bx = b[kx] - sx * b[kz];
+      const DATA_TYPE by = b[ky] - sy * b[kz];
+      const DATA_TYPE cx = c[kx] - sx * c[kz];
+      const DATA_TYPE cy = c[ky] - sy * c[kz];
+
+      // The 2D edge functions, the barycentric coordinates of the hit
+      // scaled by det.  An edge shared by two triangles gives the same
+      // value (negated) in both, so a ray through it never misses both.
+      DATA_TYPE eu = cx * by - cy * bx;
+      DATA_TYPE ev = ax * cy - ay * cx;
+      DATA_TYPE ew = bx * ay - by * ax;
+      if (sizeof(DATA_TYPE) < sizeof(double) && (eu == zero || ev == zero || ew == zero))
+      {
+         // Exactly on an edge in single precision: redo it in double,
+         // where the products are exact.
+         eu = static_cast<DATA_TYPE>(double(cx) * double(by) - double(cy) * double(bx));
+         ev = static_cast<DATA_TYPE>(double(ax) * double(cy) - double(ay) * double(cx));
+         ew = static_cast<DATA_TYPE>(double(bx) * double(ay) - double(by) * double(ax));
+      }
+
+      const bool negative = eu < zero || ev < zero || ew < zero;
+      if (negative && (!doubleSided || eu > zero || ev > zero || ew > zero))
+      {
+         return false;
+      }
+      const DATA_TYPE det = eu + ev + ew;
+      if (det == zero)
+      {
+         return false;
+      }
+
+      // The distance scaled by det, which must not be behind the origin.
+      const DATA_TYPE det_t = eu * (sz * a[kz]) + ev * (sz * b[kz]) + ew * (sz * c[kz]);
+      if (det < zero ? det_t > zero : det_t < zero)
+      {
+         return false;
+      }
+
+      const DATA_TYPE inv_det = static_cast<DATA_TYPE>(1.0) / det;
+      u = ev * inv_det;
+      v = ew * inv_det;
+      t = det_t * inv_det;
+      return true;
+   }
+}
+
+   /**
+    * Tests if the given triangle and ray intersect with each other, without
+    * gaps: a ray through an edge or vertex shared by several triangles hits
+    * at least one of them, which intersect() does not guarantee.  It has no
+    * epsilon, only triangles with a zero area in the direction of the ray
+    * are missed, and its u, v and t agree with intersect() up to rounding.
+    * Use it in double for scenes with large coordinates.
+    *
+    *  @param tri - the triangle (ccw ordering), hit from the front only
+    *  @param ray - the ray
+    *  @param u,v - tangent space u/v coordinates of the intersection
+    *  @param t - an indicator of the intersection location
+    *  @post t gives you the intersection point:
+    *         isect = ray.dir * t + ray.origin
+    *  @return true if the ray intersects the triangle.
+    *  @see Woop, Benthin and Wald, "Watertight Ray/Triangle Intersection",
+    *       JCGT 2(1), 2013
+    */
+   template<class DATA_TYPE>
+   bool intersectWatertight(const Tri<DATA_TYPE>& tri, const Ray<DATA_TYPE>& ray,
+                            DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t)
+   {
+      return helpers::intersectWatertight(tri, ray, false, u, v, t);
+   }
+
+   /**
+    * Tests if the given triangle intersects with the given ray, from both
+    * sides and without gaps, as intersectWatertight().
+    *
+    * @return true if the ray intersects the triangle.
+    */
+   template<class DATA_TYPE>
+   bool intersectWatertightDoubleSided(const Tri<DATA_TYPE>& tri,
+                                       const Ray<DATA_TYPE>& ray,
+                                       DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t)
+   {
+      return helpers::intersectWatertight(tri, ray, true, u, v, t);
+   }
+
    /**
     * Tests if the given triangle and line segment intersect with each other.
     *
@@ -984,6 +1115,85 @@ namespace gmtl
          return false;
       }
    }
+
+   /**
+    * Tests if two frustums overlap, with the separating axis test: they are
+    * disjoint when their projections on the normal of one of their planes
+    * or on the cross product of an edge of each do not overlap.  The result
+    * is exact up to rounding; touching frustums intersect.  If the corners
+    * of either frustum cannot be computed, they are assumed to intersect.
+    *
+    * Useful to find the shadow cascades or portals a view frustum sees.
+    *
+    * @param f1   the first frustum
+    * @param f2   the second frustum
+    *
+    * @return  true if the frustums intersect
+    */
+   template<class DATA_TYPE>
+   bool intersect(const Frustum<DATA_TYPE>& f1, const Frustum<DATA_TYPE>& f2)
+   {
+      Point<DATA_TYPE, 3> c1[8], c2[8];
+      if (!helpers::getFrustumCorners(f1, c1) || !helpers::getFrustumCorners(f2, c2))
+      {
+         return true;
+      }
+
+      // the planes of each, against the corners of the other; a corner in
+      // front of all the planes of the other frustum is in both
+      unsigned int behind1[8] = { 0, 0, 0, 0, 0, 0, 0, 0 }, behind2[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+      for (unsigned int i = 0; i < 6; ++i)
+      {
+         bool all1 = true, all2 = true;
+         for (unsigned int k = 0; k < 8; ++k)
+         {
+            const bool out2 = helpers::dotScalar(f1.mPlanes[i].mNorm.getData(), c2[k].getData()) +
+                              f1.mPlanes[i].mOffset < static_cast<DATA_TYPE>(0);
+            const bool out1 = helpers::dotScalar(f2.mPlanes[i].mNorm.getData(), c1[k].getData()) +
+                              f2.mPlanes[i].mOffset < static_cast<DATA_TYPE>(0);
+            behind2[k] |= out2 ? 1u : 0u;
+            behind1[k] |= out1 ? 1u : 0u;
+            all2 = all2 && out2;
+            all1 = all1 && out1;
+         }
+         if (all1 || all2)
+         {
+            return false;
+         }
+      }
+      for (unsigned int k = 0; k < 8; ++k)
+      {
+         if (!behind1[k] || !behind2[k])
+         {
+            return true;
+         }
+      }
+
+      // the edges of one crossed with the edges of the other
+      Vec<DATA_TYPE, 3> e1[12], e2[12];
+      const unsigned int num_e1 = helpers::getFrustumEdgeDirs(c1, e1);
+      const unsigned int num_e2 = helpers::getFrustumEdgeDirs(c2, e2);
+      for (unsigned int i = 0; i < num_e1; ++i)
+      {
+         for (unsigned int j = 0; j < num_e2; ++j)
+         {
+            DATA_TYPE axis[3];
+            if (!helpers::getSeparatingAxis(axis, e1[i].getData(), e2[j].getData()))
+            {
+               continue;
+            }
+            DATA_TYPE min1, max1, min2, max2;
+            helpers::projectPoints(axis, c1, 8, min1, max1);
+            helpers::projectPoints(axis, c2, 8, min2, max2);
+            if (max1 < min2 || max2 < min1)
+            {
+               return false;
+            }
+         }
+      }
+
+      return true;
+   }
 }
 
 
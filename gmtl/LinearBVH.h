@@ -0,0 +1,491 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_LINEAR_BVH_H_
+#define _GMTL_LINEAR_BVH_H_
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <gmtl/BVH.h>
+#include <gmtl/Math.h>
+#include <gmtl/Util/ThreadPool.h>
+
+namespace gmtl
+{
+namespace helpers
+{
+   /** Spreads the low 10 bits of x out to every third bit. */
+   inline unsigned int expandMortonBits( unsigned int x )
+   {
+      x &= 0x3ff;
+      x = (x | (x << 16)) & 0x030000ff;
+      x = (x | (x << 8)) & 0x0300f00f;
+      x = (x | (x << 4)) & 0x030c30c3;
+      x = (x | (x << 2)) & 0x09249249;
+      return x;
+   }
+
+   /** The 30 bit Morton code of a point, quantized to 10 bits per axis by
+    *  (p - min) * scale.
+    */
+   template<class DATA_TYPE>
+   inline unsigned int mortonCode( const Point<DATA_TYPE, 3>& p, const Point<DATA_TYPE, 3>& min,
+                                   const Vec<DATA_TYPE, 3>& scale )
+   {
+      unsigned int code = 0;
+      for (unsigned int axis = 0; axis < 3; ++axis)
+      {
+         const unsigned int q = Math::Min( static_cast<unsigned int>( (p[axis] - min[axis]) * scale[axis] ), 1023u );
+         code |= expandMortonBits( q ) << (2 - axis);
+      }
+      return code;
+   }
+
+   /**
+    * The steps of buildLinear().  Each parallel step is a member function
+    * run by the thread pool once per task.
+    */
+   template<class DATA_TYPE>
+   class LinearBVHBuilder
+   {
+   public:
+      typedef BVHNode<DATA_TYPE> Node;
+      typedef Point<DATA_TYPE, 3> PointType;
+
+      LinearBVHBuilder( BVH<DATA_TYPE>& bvh, const Tri<DATA_TYPE>* tris, const std::size_t count,
+                        ThreadPool& pool, const unsigned int maxLeafSize )
+         : mBVH( bvh ), mInTris( tris ), mCount( count ), mPool( pool ), mMaxLeafSize( maxLeafSize ),
+           mNumChunks( Math::Max( std::size_t( 1 ), Math::Min( count / 1024, std::size_t( 4 * pool.getNumThreads() ) ) ) ),
+           mShift( 0 )
+      {
+      }
+
+      void build()
+      {
+         gmtlASSERT( mMaxLeafSize > 0 );
+         gmtlASSERT( mCount < std::size_t( (std::numeric_limits<unsigned int>::max)() ) );
+         mBVH.clear();
+         if (mCount == 0)
+         {
+            return;
+         }
+
+         // the centroids of the triangle bounds, and their bounds
+         mCentroids.resize( mCount );
+         mChunkMin.resize( mNumChunks );
+         mChunkMax.resize( mNumChunks );
+         runStep( mNumChunks, &LinearBVHBuilder::computeCentroids );
+         PointType min( mChunkMin[0] ), max( mChunkMax[0] );
+         for (std::size_t i = 1; i < mNumChunks; ++i)
+         {
+            for (unsigned int axis = 0; axis < 3; ++axis)
+            {
+               min[axis] = Math::Min( min[axis], mChunkMin[i][axis] );
+               max[axis] = Math::Max( max[axis], mChunkMax[i][axis] );
+            }
+         }
+         mCodeMin = min;
+         for (unsigned int axis = 0; axis < 3; ++axis)
+         {
+            const DATA_TYPE extent = max[axis] - min[axis];
+            mCodeScale[axis] = (extent > static_cast<DATA_TYPE>(0.0))
+                             ? static_cast<DATA_TYPE>(1024.0) * (static_cast<DATA_TYPE>(1.0) - static_cast<DATA_TYPE>(1e-6)) / extent
+                             : static_cast<DATA_TYPE>(0.0);
+         }
+
+         // sort the triangles by the Morton codes of their centroids
+         mCodes.resize( mCount );
+         mIndices.resize( mCount );
+         mSortCodes.resize( mCount );
+         mSortIndices.resize( mCount );
+         runStep( mNumChunks, &LinearBVHBuilder::computeCodes );
+         mHistogram.resize( mNumChunks * 256 );
+         for (mShift = 0; mShift < 30; mShift += 8)
+         {
+            runStep( mNumChunks, &LinearBVHBuilder::countDigits );
+            std::size_t offset = 0;
+            for (std::size_t digit = 0; digit < 256; ++digit)
+            {
+               for (std::size_t chunk = 0; chunk < mNumChunks; ++chunk)
+               {
+                  const std::size_t n = mHistogram[chunk * 256 + digit];
+                  mHistogram[chunk * 256 + digit] = offset;
+                  offset += n;
+               }
+            }
+            runStep( mNumChunks, &LinearBVHBuilder::scatterDigits );
+            mCodes.swap( mSortCodes );
+            mIndices.swap( mSortIndices );
+         }
+
+         mBVH.mTris.resize( mCount );
+         mBVH.mTriIndices.resize( mCount );
+         runStep( mNumChunks, &LinearBVHBuilder::gatherTris );
+
+         // split the top of the tree here, and the subtrees below in
+         // parallel; the number of subtrees does not depend on the number
+         // of threads, so that neither does the order of the nodes
+         const std::size_t subtree_size = Math::Max( mCount / 256, std::size_t( 256 ) );
+         std::vector<unsigned int> top_interiors;
+         mBVH.mNodes.push_back( Node() );
+         emit( mBVH.mNodes, 0, 0, static_cast<unsigned int>( mCount ), 1, mBVH.mDepth,
+               &mSubtrees, &top_interiors, subtree_size );
+
+         mSubtreeNodes.resize( mSubtrees.size() );
+         mSubtreeDepths.resize( mSubtrees.size(), 0 );
+         runStep( mSubtrees.size(), &LinearBVHBuilder::emitSubtree );
+
+         mSubtreeBases.resize( mSubtrees.size() );
+         std::size_t num_nodes = mBVH.mNodes.size();
+         for (std::size_t i = 0; i < mSubtrees.size(); ++i)
+         {
+            mSubtreeBases[i] = static_cast<unsigned int>( num_nodes );
+            num_nodes += mSubtreeNodes[i].size() - 1;
+            mBVH.mDepth = Math::Max( mBVH.mDepth, mSubtreeDepths[i] );
+         }
+         mBVH.mNodes.resize( num_nodes );
+         runStep( mSubtrees.size(), &LinearBVHBuilder::copySubtree );
+
+         for (std::size_t i = top_interiors.size(); i-- > 0; )
+         {
+            Node& node = mBVH.mNodes[top_interiors[i]];
+            node.mBounds = mBVH.mNodes[node.mFirst].mBounds;
+            extendBounds( node.mBounds, mBVH.mNodes[node.mFirst + 1].mBounds );
+         }
+         mBVH.mBuildCost = mBVH.mSAHCost = mBVH.computeSAHCost();
+      }
+
+   private:
+      /** A range of the sorted triangles, to be emitted below a node. */
+      struct Range
+      {
+         unsigned int mNode, mBegin, mEnd, mDepth;
+      };
+
+      typedef void (LinearBVHBuilder::*Step)( std::size_t );
+
+      /** Calls a step from the pool. */
+      class StepCall
+      {
+      public:
+         StepCall( LinearBVHBuilder* builder, const Step step )
+            : mBuilder( builder ), mStep( step )
+         {
+         }
+
+         void operator()( const std::size_t task, const unsigned int ) const
+         {
+            (mBuilder->*mStep)( task );
+         }
+
+      private:
+         LinearBVHBuilder* mBuilder;
+         Step mStep;
+      };
+
+      void runStep( const std::size_t numTasks, const Step step )
+      {
+         mPool.run( numTasks, StepCall( this, step ) );
+      }
+
+      void getChunk( const std::size_t chunk, std::size_t& begin, std::size_t& end ) const
+      {
+         ThreadPool::getRange( mCount, chunk, mNumChunks, begin, end );
+      }
+
+      static void extendBounds( AABox<DATA_TYPE>& box, const AABox<DATA_TYPE>& other )
+      {
+         for (unsigned int axis = 0; axis < 3; ++axis)
+         {
+            box.mMin[axis] = Math::Min( box.mMin[axis], other.mMin[axis] );
+            box.mMax[axis] = Math::Max( box.mMax[axis], other.mMax[axis] );
+         }
+      }
+
+      void computeCentroids( const std::size_t chunk )
+      {
+         std::size_t begin, end;
+         getChunk( chunk, begin, end );
+         for (std::size_t i = begin; i < end; ++i)
+         {
+            const Tri<DATA_TYPE>& tri = mInTris[i];
+            for (unsigned int axis = 0; axis < 3; ++axis)
+            {
+               const DATA_TYPE lo = Math::Min( Math::Min( tri[0][axis], tri[1][axis] ), tri[2][axis] );
+               const DATA_TYPE hi = Math::Max( Math::Max( tri[0][axis], tri[1][axis] ), tri[2][axis] );
+               mCentroids[i][axis] = (lo + hi) * static_cast<DATA_TYPE>(0.5);
+            }
+         }
+         PointType min( mCentroids[begin] ), max( min );
+         for (std::size_t i = begin + 1; i < end; ++i)
+         {
+            for (unsigned int axis = 0; axis < 3; ++axis)
+            {
+               min[axis] = Math::Min( min[axis], mCentroids[i][axis] );
+               max[axis] = Math::Max( max[axis], mCentroids[i][axis] );
+            }
+         }
+         mChunkMin[chunk] = min;
+         mChunkMax[chunk] = max;
+      }
+
+      void computeCodes( const std::size_t chunk )
+      {
+         std::size_t begin, end;
+         getChunk( chunk, begin, end );
+         for (std::size_t i = begin; i < end; ++i)
+         {
+            mCodes[i] = mortonCode( mCentroids[i], mCodeMin, mCodeScale );
+            mIndices[i] = static_cast<unsigned int>( i );
+         }
+      }
+
+      /** Radix sort: counts the digits of a chunk. */
+      void countDigits( const std::size_t chunk )
+      {
+         std::size_t begin, end;
+         getChunk( chunk, begin, end );
+         std::size_t* histogram = &mHistogram[chunk * 256];
+         std::fill( histogram, histogram + 256, std::size_t( 0 ) );
+         for (std::size_t i = begin; i < end; ++i)
+         {
+            ++histogram[(mCodes[i] >> mShift) & 0xff];
+         }
+      }
+
+      /** Radix sort: moves the items of a chunk to their sorted place, in
+       *  order, so that the sort is stable.
+       */
+      void scatterDigits( const std::size_t chunk )
+      {
+         std::size_t begin, end;
+         getChunk( chunk, begin, end );
+         std::size_t* offsets = &mHistogram[chunk * 256];
+         for (std::size_t i = begin; i < end; ++i)
+         {
+            const std::size_t dst = offsets[(mCodes[i] >> mShift) & 0xff]++;
+            mSortCodes[dst] = mCodes[i];
+            mSortIndices[dst] = mIndices[i];
+         }
+      }
+
+      void gatherTris( const std::size_t chunk )
+      {
+         std::size_t begin, end;
+         getChunk( chunk, begin, end );
+         for (std::size_t i = begin; i < end; ++i)
+         {
+            mBVH.mTris[i] = mInTris[mIndices[i]];
+            mBVH.mTriIndices[i] = mIndices[i];
+         }
+      }
+
+      /** Splits the sorted triangles [begin, end) where the highest bit
+       *  that differs in their Morton codes changes, or in the middle when
+       *  all the codes are the same.
+       */
+      unsigned int findSplit( const unsigned int begin, const unsigned int end ) const
+      {
+         const unsigned int first = mCodes[begin], last = mCodes[end - 1];
+         if (first == last)
+         {
+            return (begin + end) / 2;
+         }
+         unsigned int high = first ^ last;
+         high |= high >> 1;
+         high |= high >> 2;
+         high |= high >> 4;
+         high |= high >> 8;
+         high |= high >> 16;
+         high ^= high >> 1;
+
+         // the codes without the bit (first has it clear) come first
+         return static_cast<unsigned int>(
+            std::upper_bound( mCodes.begin() + begin, mCodes.begin() + end, first | (high - 1) ) - mCodes.begin() );
+      }
+
+      /** Emits the nodes below nodes[root], for the sorted triangles
+       *  [begin, end).  Ranges of at most pendingSize triangles are added
+       *  to pending instead, when it is not NULL, and the interior nodes
+       *  are added to interiors.
+       */
+      void emit( std::vector<Node>& nodes, const unsigned int root, const unsigned int begin,
+                 const unsigned int end, const unsigned int depth, unsigned int& maxDepth,
+                 std::vector<Range>* pending, std::vector<unsigned int>* interiors,
+                 const std::size_t pendingSize ) const
+      {
+         std::vector<Range> stack;
+         const Range first = { root, begin, end, depth };
+         stack.push_back( first );
+         while (!stack.empty())
+         {
+            const Range range = stack.back();
+            stack.pop_back();
+            const unsigned int count = range.mEnd - range.mBegin;
+            if (pending != NULL && count <= pendingSize)
+            {
+               pending->push_back( range );
+               continue;
+            }
+            maxDepth = Math::Max( maxDepth, range.mDepth );
+            if (count <= mMaxLeafSize || range.mDepth >= BVH<DATA_TYPE>::MaxDepth)
+            {
+               nodes[range.mNode].mFirst = range.mBegin;
+               nodes[range.mNode].mCount = count;
+               continue;
+            }
+
+            const unsigned int middle = findSplit( range.mBegin, range.mEnd );
+            const unsigned int left = static_cast<unsigned int>( nodes.size() );
+            nodes[range.mNode].mFirst = left;
+            nodes[range.mNode].mCount = 0;
+            if (interiors != NULL)
+            {
+               interiors->push_back( range.mNode );
+            }
+            nodes.push_back( Node() );
+            nodes.push_back( Node() );
+            const Range right_range = { left + 1, middle, range.mEnd, range.mDepth + 1 };
+            const Range left_range = { left, range.mBegin, middle, range.mDepth + 1 };
+            stack.push_back( right_range );
+            stack.push_back( left_range );
+         }
+      }
+
+      /** Emits a subtree into its own nodes, with local child indices, and
+       *  computes its bounds.
+       */
+      void emitSubtree( const std::size_t subtree )
+      {
+         const Range& range = mSubtrees[subtree];
+         std::vector<Node>& nodes = mSubtreeNodes[subtree];
+         nodes.reserve( 2 * (range.mEnd - range.mBegin) / mMaxLeafSize + 1 );
+         nodes.push_back( Node() );
+         emit( nodes, 0, range.mBegin, range.mEnd, range.mDepth, mSubtreeDepths[subtree], NULL, NULL, 0 );
+
+         // children come after their parent
+         for (std::size_t i = nodes.size(); i-- > 0; )
+         {
+            Node& node = nodes[i];
+            if (node.isLeaf())
+            {
+               const Tri<DATA_TYPE>& tri = mBVH.mTris[node.mFirst];
+               node.mBounds = AABox<DATA_TYPE>( tri[0], tri[0] );
+               for (unsigned int t = node.mFirst; t < node.mFirst + node.mCount; ++t)
+               {
+                  for (unsigned int k = 0; k < 3; ++k)
+                  {
+                     for (unsigned int axis = 0; axis < 3; ++axis)
+                     {
+                        node.mBounds.mMin[axis] = Math::Min( node.mBounds.mMin[axis], mBVH.mTris[t][k][axis] );
+                        node.mBounds.mMax[axis] = Math::Max( node.mBounds.mMax[axis], mBVH.mTris[t][k][axis] );
+                     }
+                  }
+               }
+            }
+            else
+            {
+               node.mBounds = nodes[node.mFirst].mBounds;
+               extendBounds( node.mBounds, nodes[node.mFirst + 1].mBounds );
+            }
+         }
+      }
+
+      /** Copies a subtree into the BVH: its root to the node it was
+       *  emitted for, the rest after the nodes of the subtrees before it.
+       */
+      void copySubtree( const std::size_t subtree )
+      {
+         const std::vector<Node>& nodes = mSubtreeNodes[subtree];
+         const unsigned int base = mSubtreeBases[subtree];
+         for (std::size_t i = 0; i < nodes.size(); ++i)
+         {
+            Node& node = mBVH.mNodes[i == 0 ? mSubtrees[subtree].mNode : base + i - 1];
+            node = nodes[i];
+            if (!node.isLeaf())
+            {
+               node.mFirst = base + node.mFirst - 1;
+            }
+         }
+         std::vector<Node>().swap( mSubtreeNodes[subtree] );
+      }
+
+   private:
+      BVH<DATA_TYPE>& mBVH;
+      const Tri<DATA_TYPE>* mInTris;
+      std::size_t mCount;
+      ThreadPool& mPool;
+      unsigned int mMaxLeafSize;
+      std::size_t mNumChunks;
+
+      std::vector<PointType> mCentroids, mChunkMin, mChunkMax;
+      PointType mCodeMin;
+      Vec<DATA_TYPE, 3> mCodeScale;
+
+      std::vector<unsigned int> mCodes, mIndices, mSortCodes, mSortIndices;
+      std::vector<std::size_t> mHistogram;
+      unsigned int mShift;
+
+      std::vector<Range> mSubtrees;
+      std::vector< std::vector<Node> > mSubtreeNodes;
+      std::vector<unsigned int> mSubtreeDepths, mSubtreeBases;
+   };
+}
+
+/** @ingroup Ops
+ * @name BVH Construction
+ * @{
+ */
+
+   /**
+    * Replaces the contents of a BVH with a linear BVH (LBVH) over count
+    * triangles, built in parallel on the threads of pool.
+    *
+    * The centroids of the triangle bounds are quantized to 10 bits per axis
+    * and sorted along the Z-order curve by their Morton codes, with a
+    * parallel radix sort.  The tree is then emitted top down, splitting
+    * each node where the highest differing bit of the sorted codes changes:
+    * the top of the tree on the calling thread, and the subtrees below it
+    * in parallel.  This is over ten times faster than BVH::build() even on
+    * one thread.  The splits ignore the sizes of the triangles, so for
+    * meshes of uneven triangles the tree is usually slower to query than
+    * one from build(); it suits scenes that change every frame.
+    *
+    * The result is an ordinary BVH for the BVH queries, and does not depend
+    * on the number of threads.
+    *
+    * @param bvh           the hierarchy to build
+    * @param tris          the triangles, which are copied
+    * @param count         the number of triangles
+    * @param pool          the threads to build with
+    * @param maxLeafSize   the most triangles a leaf may have, unless the
+    *                      tree is BVH::MaxDepth deep
+    *
+    * @see BVH::build()
+    */
+   template<class DATA_TYPE>
+   inline void buildLinear( BVH<DATA_TYPE>& bvh, const Tri<DATA_TYPE>* tris, const std::size_t count,
+                            ThreadPool& pool, const unsigned int maxLeafSize = 4 )
+   {
+      helpers::LinearBVHBuilder<DATA_TYPE> builder( bvh, tris, count, pool, maxLeafSize );
+      builder.build();
+   }
+
+   /** buildLinear() on the calling thread only. */
+   template<class DATA_TYPE>
+   inline void buildLinear( BVH<DATA_TYPE>& bvh, const Tri<DATA_TYPE>* tris, const std::size_t count,
+                            const unsigned int maxLeafSize = 4 )
+   {
+      ThreadPool pool( 1 );
+      buildLinear( bvh, tris, count, pool, maxLeafSize );
+   }
+
+/** @} */
+
+} // end of namespace gmtl
+
+#endif
@@ -0,0 +1,347 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_MAT_EXPR_META_H
+#define _GMTL_MAT_EXPR_META_H
+
+#include <gmtl/Matrix.h>
+
+/** Expression template classes for matrix operations
+ */
+namespace gmtl
+{
+namespace meta
+{
+/** @ingroup MatExprMeta */
+//@{
+
+// ------------ Expression templates primitives ----------- //
+// Expression templates for matrices
+//
+// Concepts:
+//
+// MatrixExpression:
+//    interface:
+//       TYPE operator()(r,c):        Returns evaluation of expression at elt (r,c)
+//       int state():                 Matrix state of the result (see Matrix::XformState)
+//       bool aliases(p):             True if the matrix at p is used as an operand
+//       bool readsOther(p):          True if evaluating elt (r,c) reads elements of
+//                                    the matrix at p other than (r,c)
+//
+// Element-wise operations (+, -, scalar *, unary -) are evaluated lazily,
+// one element at a time, so chains of them run in a single pass.  The
+// operands of a product are always concrete matrices: a plain Matrix is
+// referenced, anything else is evaluated once when the product is built.
+// This keeps the cost of a chained product linear in its length, and lets
+// a product that is assigned directly go through gmtl::mult() and its
+// state/SIMD specific kernels.
+
+
+/** Leaf of a matrix expression: refers to an existing matrix. */
+template <typename T, unsigned ROWS, unsigned COLS>
+struct MatLeaf
+{
+   typedef T DataType;
+
+   const Matrix<T, ROWS, COLS>& mMat;
+
+   inline MatLeaf(const Matrix<T, ROWS, COLS>& mat) : mMat(mat) {;}
+   inline T operator()(const unsigned r, const unsigned c) const
+   { return mMat(r, c); }
+   inline const Matrix<T, ROWS, COLS>& matrix() const
+   { return mMat; }
+   inline int state() const
+   { return mMat.mState; }
+   inline bool aliases(const void* p) const
+   { return p == static_cast<const void*>(&mMat); }
+   inline bool readsOther(const void*) const
+   { return false; }
+};
+
+/** Leaf of a matrix expression: holds an evaluated sub expression. */
+template <typename T, unsigned ROWS, unsigned COLS>
+struct MatValue
+{
+   typedef T DataType;
+
+   Matrix<T, ROWS, COLS> mMat;
+
+   template <typename EXP_T>
+   inline MatValue(const EXP_T& exp) : mMat(NO_INIT)
+   { exp.evalTo(mMat); }
+   inline T operator()(const unsigned r, const unsigned c) const
+   { return mMat(r, c); }
+   inline const Matrix<T, ROWS, COLS>& matrix() const
+   { return mMat; }
+   inline int state() const
+   { return mMat.mState; }
+   inline bool aliases(const void*) const
+   { return false; }
+   inline bool readsOther(const void*) const
+   { return false; }
+};
+
+/** Scalar operand of a matrix expression. */
+template <typename T>
+struct MatScalarArg
+{
+   typedef T DataType;
+
+   const T mScalar;
+
+   inline MatScalarArg(const T scalar) : mScalar(scalar) {;}
+   inline T operator()(const unsigned, const unsigned) const
+   { return mScalar; }
+   inline int state() const
+   { return 0; }
+   inline bool aliases(const void*) const
+   { return false; }
+   inline bool readsOther(const void*) const
+   { return false; }
+};
+
+// -- Expressions -- //
+/** Binary matrix expression.
+ *  Stores the two operand expressions and applies OP to them.
+ */
+template <typename EXP1_T, typename EXP2_T, typename OP>
+struct MatBinaryExpr
+{
+   typedef typename EXP1_T::DataType DataType;
+
+   const EXP1_T Exp1;
+   const EXP2_T Exp2;
+
+   inline MatBinaryExpr(const EXP1_T& e1, const EXP2_T& e2) : Exp1(e1), Exp2(e2) {;}
+   inline DataType operator()(const unsigned r, const unsigned c) const
+   { return OP::eval(Exp1, Exp2, r, c); }
+   inline int state() const
+   { return OP::template state<DataType>(Exp1.state(), Exp2.state()); }
+   inline bool aliases(const void* p) const
+   { return Exp1.aliases(p) || Exp2.aliases(p); }
+   inline bool readsOther(const void* p) const
+   {
+      return OP::CrossElement ? aliases(p)
+                              : (Exp1.readsOther(p) || Exp2.readsOther(p));
+   }
+};
+
+/** Unary matrix expression. */
+template <typename EXP1_T, typename OP>
+struct MatUnaryExpr
+{
+   typedef typename EXP1_T::DataType DataType;
+
+   const EXP1_T Exp1;
+
+   inline MatUnaryExpr(const EXP1_T& e1) : Exp1(e1) {;}
+   inline DataType operator()(const unsigned r, const unsigned c) const
+   { return OP::eval(Exp1(r, c)); }
+   inline int state() const
+   { return OP::template state<DataType>(Exp1.state()); }
+   inline bool aliases(const void* p) const
+   { return Exp1.aliases(p); }
+   inline bool readsOther(const void* p) const
+   { return Exp1.readsOther(p); }
+};
+
+// --- Operations --- //
+// The result of an element-wise operation is FULL, since adding or scaling
+// matrices does not preserve orthonormal axes or the (0,0,0,s) bottom row
+// in general.  Use detectState() if a tracked state is needed.
+
+/** Element-wise addition. */
+struct MatPlusBinary
+{
+   enum { CrossElement = 0 };
+
+   template <typename E1, typename E2>
+   static inline typename E1::DataType eval(const E1& e1, const E2& e2, const unsigned r, const unsigned c)
+   { return e1(r, c) + e2(r, c); }
+   template <typename T>
+   static inline int state(const int, const int)
+   { return Matrix<T, 1, 1>::FULL; }
+};
+
+/** Element-wise subtraction. */
+struct MatMinusBinary
+{
+   enum { CrossElement = 0 };
+
+   template <typename E1, typename E2>
+   static inline typename E1::DataType eval(const E1& e1, const E2& e2, const unsigned r, const unsigned c)
+   { return e1(r, c) - e2(r, c); }
+   template <typename T>
+   static inline int state(const int, const int)
+   { return Matrix<T, 1, 1>::FULL; }
+};
+
+/** Element-wise multiplication, used with a MatScalarArg. */
+struct MatScaleBinary
+{
+   enum { CrossElement = 0 };
+
+   template <typename E1, typename E2>
+   static inline typename E1::DataType eval(const E1& e1, const E2& e2, const unsigned r, const unsigned c)
+   { return e1(r, c) * e2(r, c); }
+   template <typename T>
+   static inline int state(const int, const int)
+   { return Matrix<T, 1, 1>::FULL; }
+};
+
+/** Matrix product, INTERNAL is the shared dimension. */
+template <unsigned INTERNAL>
+struct MatMultBinary
+{
+   enum { CrossElement = 1 };
+
+   template <typename E1, typename E2>
+   static inline typename E1::DataType eval(const E1& e1, const E2& e2, const unsigned r, const unsigned c)
+   {
+      typename E1::DataType sum( e1(r, 0) * e2(0, c) );
+      for (unsigned k = 1; k < INTERNAL; ++k)
+         sum += e1(r, k) * e2(k, c);
+      return sum;
+   }
+   template <typename T>
+   static inline int state(const int s1, const int s2)
+   { return combineMatrixStates(s1, s2); }
+};
+
+/** Negation of the values. */
+struct MatNegUnary
+{
+   template <typename T>
+   static inline T eval(const T a1)
+   { return -a1; }
+   template <typename T>
+   static inline int state(const int)
+   { return Matrix<T, 1, 1>::FULL; }
+};
+
+// --- Evaluation --- //
+/** Writes an expression into a matrix, one element at a time. */
+template <typename EXP_T>
+struct MatEval
+{
+   enum { AliasSafe = 0 };
+
+   template <typename T, unsigned ROWS, unsigned COLS>
+   static inline void eval(Matrix<T, ROWS, COLS>& dst, const EXP_T& exp)
+   {
+      for (unsigned c = 0; c < COLS; ++c)
+      for (unsigned r = 0; r < ROWS; ++r)
+         dst(r, c) = exp(r, c);
+      dst.mState = exp.state();
+   }
+};
+
+/** A product at the top of an expression goes through gmtl::mult(), which
+ *  picks the kernel by matrix state and handles aliasing itself.
+ */
+template <typename EXP1_T, typename EXP2_T, unsigned INTERNAL>
+struct MatEval< MatBinaryExpr<EXP1_T, EXP2_T, MatMultBinary<INTERNAL> > >
+{
+   enum { AliasSafe = 1 };
+
+   template <typename T, unsigned ROWS, unsigned COLS>
+   static inline void eval(Matrix<T, ROWS, COLS>& dst,
+                           const MatBinaryExpr<EXP1_T, EXP2_T, MatMultBinary<INTERNAL> >& exp)
+   {
+      mult( dst, exp.Exp1.matrix(), exp.Exp2.matrix() );
+   }
+};
+
+//@}
+
+} // namespace meta
+
+/** Matrix expression.
+ *  It lives in namespace gmtl (as VecBase does for vector expressions) so
+ *  that the matrix operators are found for expression operands.
+ *
+ *  Wraps an expression node together with the size of its result; this is
+ *  the type that the matrix operators take and return.
+ */
+template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP_T>
+struct MatExpr
+{
+   typedef DATA_TYPE DataType;
+   typedef EXP_T ExpType;
+   enum Params { Rows = ROWS, Cols = COLS };
+
+   EXP_T mExp;
+
+   inline explicit MatExpr(const EXP_T& exp) : mExp(exp) {;}
+
+   inline DATA_TYPE operator()(const unsigned r, const unsigned c) const
+   { return mExp(r, c); }
+   inline int state() const
+   { return mExp.state(); }
+   inline bool aliases(const void* p) const
+   { return mExp.aliases(p); }
+
+   /** True if writing the result into the matrix at p while evaluating
+    *  would change operands that are still to be read.
+    */
+   inline bool needsTemporary(const void* p) const
+   { return !meta::MatEval<EXP_T>::AliasSafe && mExp.readsOther(p); }
+
+   /** Evaluates into dst.  dst must not be needed by the expression, see
+    *  needsTemporary().
+    */
+   inline void evalTo(Matrix<DATA_TYPE, ROWS, COLS>& dst) const
+   { meta::MatEval<EXP_T>::eval(dst, mExp); }
+
+   /** Evaluates into a new matrix. */
+   inline Matrix<DATA_TYPE, ROWS, COLS> eval() const
+   { return Matrix<DATA_TYPE, ROWS, COLS>(*this); }
+};
+
+namespace meta
+{
+/** @ingroup MatExprMeta */
+//@{
+
+/** Operand of a product: plain matrices are referenced, any other
+ *  expression is evaluated once.
+ */
+template <typename T, unsigned ROWS, unsigned COLS, typename EXP_T>
+struct MatProdOperand
+{
+   typedef MatValue<T, ROWS, COLS> Type;
+   static inline Type make(const MatExpr<T, ROWS, COLS, EXP_T>& e)
+   { return Type(e); }
+};
+
+template <typename T, unsigned ROWS, unsigned COLS>
+struct MatProdOperand<T, ROWS, COLS, MatLeaf<T, ROWS, COLS> >
+{
+   typedef MatLeaf<T, ROWS, COLS> Type;
+   static inline Type make(const MatExpr<T, ROWS, COLS, MatLeaf<T, ROWS, COLS> >& e)
+   { return e.mExp; }
+};
+
+//@}
+
+} // namespace meta
+
+/** Wraps a matrix as an expression leaf.  The matrix operators applied to
+ *  the result build expressions instead of temporaries:
+ *  m = makeMatExpr( a ) * s + b - c;
+ *  The matrix must outlive the expression.
+ */
+template <typename T, unsigned ROWS, unsigned COLS>
+inline MatExpr<T, ROWS, COLS, meta::MatLeaf<T, ROWS, COLS> > makeMatExpr(const Matrix<T, ROWS, COLS>& mat)
+{ return MatExpr<T, ROWS, COLS, meta::MatLeaf<T, ROWS, COLS> >(meta::MatLeaf<T, ROWS, COLS>(mat)); }
+
+template <typename T, unsigned ROWS, unsigned COLS, typename EXP_T>
+inline const MatExpr<T, ROWS, COLS, EXP_T>& makeMatExpr(const MatExpr<T, ROWS, COLS, EXP_T>& exp)
+{ return exp; }
+
+} // end namespace
+
+
+#endif
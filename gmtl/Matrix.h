@@ -6,14 +6,23 @@
 #ifndef _GMTL_MATRIX_H_
 #define _GMTL_MATRIX_H_
 
+#include <gmtl/Config.h>
 #include <gmtl/Defines.h>
 #include <gmtl/Math.h>
 #include <gmtl/Util/Assert.h>
 #include <gmtl/Util/StaticAssert.h>
+#ifndef GMTL_NO_METAPROG
+#include <gmtl/MatrixOpsMeta.h>
+#endif
 
 namespace gmtl
 {
 
+#ifndef GMTL_NO_METAPROG
+template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP_T>
+struct MatExpr;
+#endif
+
 /**
  * State tracked NxM dimensional Matrix (ordered in memory by Column)
  *
@@ -212,7 +221,7 @@ public:
    /** Default Constructor (Identity constructor) */
    Matrix()
    {
-      /** @todo mp */
+#ifdef GMTL_NO_METAPROG
       for (unsigned int r = 0; r < ROWS; ++r)
       {
          for (unsigned int c = 0; c < COLS; ++c)
@@ -221,23 +230,70 @@ public:
          }
       }
 
-      /** @todo mp */
       for (unsigned int x = 0; x < Math::Min(COLS, ROWS); ++x)
       {
          this->operator()(x, x) = static_cast<DATA_TYPE>(1.0);
       }
+#else
+      gmtl::meta::IdentityMatUnrolled<ROWS*COLS-1, ROWS, DATA_TYPE>::func(mData);
+#endif
 
       /** @todo Set initial state to IDENTITY and test other stuff */
       mState = IDENTITY;
    }
 
+   /** No-init constructor.
+    *  Leaves mData uninitialized and marks the matrix FULL, so that the
+    *  state based shortcuts of identity() and zero() are not taken.
+    *  @see NoInit
+    */
+   explicit Matrix( NoInit )
+      : mState( FULL )
+   {
+   }
+
    /** copy constructor */
    Matrix( const Matrix<DATA_TYPE, ROWS, COLS>& matrix )
    {
-      this->set( matrix.getData() );
+#ifdef GMTL_NO_METAPROG
+      for (unsigned int x = 0; x < ROWS * COLS; ++x)
+         mData[x] = matrix.mData[x];
+#else
+      gmtl::meta::AssignMatUnrolled<ROWS*COLS-1, DATA_TYPE>::func(mData, matrix.mData);
+#endif
       mState = matrix.mState;
    }
 
+#ifndef GMTL_NO_METAPROG
+   /** Evaluates a matrix expression (see MatExprMeta.h). */
+   template <typename EXP_T>
+   Matrix( const MatExpr<DATA_TYPE, ROWS, COLS, EXP_T>& expr )
+   {
+      expr.evalTo( *this );
+   }
+
+   /** Evaluates a matrix expression into this matrix.
+    *  If the expression reads elements of this matrix after they would be
+    *  overwritten (such as m = m * a + b), it is evaluated into a temporary
+    *  first.
+    */
+   template <typename EXP_T>
+   Matrix& operator=( const MatExpr<DATA_TYPE, ROWS, COLS, EXP_T>& expr )
+   {
+      if (expr.needsTemporary( this ))
+      {
+         Matrix<DATA_TYPE, ROWS, COLS> temporary( NO_INIT );
+         expr.evalTo( temporary );
+         *this = temporary;
+      }
+      else
+      {
+         expr.evalTo( *this );
+      }
+      return *this;
+   }
+#endif
+
    /** element wise setter for 2x2.
     * @note variable names specify the row,column number to put the data into
     *  @todo needs mp!!
@@ -250,7 +306,7 @@ public:
       mData[1] = v10;
       mData[2] = v01;
       mData[3] = v11;
-      mState = FULL;
+      setStateFromData();
    }
 
    /** element wise setter for 2x3.
@@ -266,7 +322,7 @@ public:
       mData[3] = v11;
       mData[4] = v02;
       mData[5] = v12;
-      mState = FULL;
+      setStateFromData();
    }
 
    /** element wise setter for 3x3.
@@ -288,7 +344,7 @@ public:
       mData[6] = v02;
       mData[7] = v12;
       mData[8] = v22;
-      mState = FULL;
+      setStateFromData();
    }
 
    /** element wise setter for 3x4.
@@ -313,7 +369,7 @@ public:
       mData[9]  = v03;
       mData[10] = v13;
       mData[11] = v23;
-      mState = FULL;
+      setStateFromData();
    }
 
    /** element wise setter for 4x4.
@@ -345,7 +401,7 @@ public:
       mData[7]  = v31;
       mData[11] = v32;
       mData[15] = v33;
-      mState = FULL;
+      setStateFromData();
    }
 
    /** comma operator
@@ -373,10 +429,13 @@ public:
     */
    void set( const DATA_TYPE* data )
    {
-      /** @todo mp */
+#ifdef GMTL_NO_METAPROG
       for (unsigned int x = 0; x < ROWS * COLS; ++x)
          mData[x] = data[x];
-      mState = FULL;
+#else
+      gmtl::meta::AssignMatUnrolled<ROWS*COLS-1, DATA_TYPE>::func(mData, data);
+#endif
+      setStateFromData();
    }
 
    /** set the matrix to the transpose of the given data.
@@ -407,7 +466,7 @@ public:
       for (unsigned int r = 0; r < ROWS; ++r)
       for (unsigned int c = 0; c < COLS; ++c)
          this->operator()( r, c ) = data[(r * COLS) + c];
-      mState = FULL;
+      setStateFromData();
    }
 
    /** access [row, col] in the matrix
@@ -481,6 +540,21 @@ public:
       mState = state;
    }
 
+   /** Updates mState after the whole matrix has been written by set() or
+    *  setTranspose().  The matrix is marked FULL, unless
+    *  GMTL_DETECT_STATE_ON_SET is defined, in which case the state is
+    *  computed from the data.
+    *  @see classifyState()
+    */
+   void setStateFromData()
+   {
+#ifdef GMTL_DETECT_STATE_ON_SET
+      mState = classifyState( *this );
+#else
+      mState = FULL;
+#endif
+   }
+
 public:
    /** Column major.  In other words {Column1, Column2, Column3, Column4} in memory
     * access element mData[column][row]
@@ -634,6 +708,121 @@ inline int combineMatrixStates( int state1, int state2 )
    }
 }
 
+/** Classifies the transform held by a matrix by looking at its elements.
+ *  Use this to recover a useful state for matrices whose data came from
+ *  set(), setTranspose() or direct writes to mData, all of which leave the
+ *  matrix FULL.
+ *
+ *  The 3x3, 3x4, 4x3 and 4x4 matrices are checked for:
+ *  - IDENTITY:   every element matches the identity matrix
+ *  - TRANS:      identity except for the translation column
+ *  - ORTHOGONAL: orthonormal 3x3 part, no translation, no homogeneous scale
+ *  - AFFINE:     orthonormal 3x3 part, with translation and/or a
+ *                homogeneous scale in the bottom right element
+ *  - AFFINE | NON_UNISCALE: mutually perpendicular (scaled) columns in
+ *                the 3x3 part
+ *  - FULL:       anything else, including a bottom row other than
+ *                (0,0,0,s), shear, and singular 3x3 parts
+ *
+ *  Other sizes are only checked for IDENTITY.
+ *
+ *  The elements that a state fixes (those of IDENTITY and the rotation of
+ *  TRANS, the bottom row, the translation of ORTHOGONAL and a w of 1) are
+ *  compared exactly, because the fast paths chosen by the state ignore
+ *  them.  Only the orthonormality of the 3x3 part is tested within eps,
+ *  so that rotations built in floating point are still ORTHOGONAL or
+ *  AFFINE; the inverse of such a matrix by transposing is then off by
+ *  about eps.
+ *
+ *  @param mat  the matrix to classify
+ *  @param eps  tolerance of the unit length and perpendicular column
+ *              tests.  The perpendicular test is scaled by the column
+ *              lengths.
+ *  @return  the state, suitable for Matrix::mState
+ */
+template <typename DATA_TYPE, unsigned ROWS, unsigned COLS>
+inline int classifyState( const Matrix<DATA_TYPE, ROWS, COLS>& mat,
+                          const DATA_TYPE eps = static_cast<DATA_TYPE>(GMTL_MAT_STATE_EPSILON) )
+{
+   typedef Matrix<DATA_TYPE, ROWS, COLS> MatType;
+   const DATA_TYPE zero( 0 ), one( 1 );
+
+   bool ident = true;
+   for (unsigned int r = 0; r < ROWS && ident; ++r)
+   for (unsigned int c = 0; c < COLS && ident; ++c)
+      ident = (mat( r, c ) == ((r == c) ? one : zero));
+   if (ident)
+      return MatType::IDENTITY;
+
+   if (ROWS < 3 || ROWS > 4 || COLS < 3 || COLS > 4)
+      return MatType::FULL;
+
+   // bottom row has to be (0,0,0,w)
+   DATA_TYPE w = one;
+   if (ROWS == 4)
+   {
+      for (unsigned int c = 0; c < 3; ++c)
+         if (mat( 3, c ) != zero)
+            return MatType::FULL;
+      if (COLS == 4)
+         w = mat( 3, 3 );
+   }
+
+   bool has_trans = false;
+   if (COLS == 4)
+   {
+      for (unsigned int r = 0; r < 3; ++r)
+         has_trans = has_trans || (mat( r, 3 ) != zero);
+   }
+
+   // columns of the 3x3 part: perpendicular, then unit length
+   DATA_TYPE len_sqr[3];
+   for (unsigned int c = 0; c < 3; ++c)
+   {
+      len_sqr[c] = mat( 0, c ) * mat( 0, c ) + mat( 1, c ) * mat( 1, c ) + mat( 2, c ) * mat( 2, c );
+      if (len_sqr[c] <= eps)
+         return MatType::FULL;
+   }
+   for (unsigned int i = 0; i < 2; ++i)
+   for (unsigned int j = i + 1; j < 3; ++j)
+   {
+      const DATA_TYPE d = mat( 0, i ) * mat( 0, j ) + mat( 1, i ) * mat( 1, j ) + mat( 2, i ) * mat( 2, j );
+      if (Math::abs( d ) > eps * Math::sqrt( len_sqr[i] * len_sqr[j] ))
+         return MatType::FULL;
+   }
+
+   bool unit = true;
+   for (unsigned int c = 0; c < 3; ++c)
+      unit = unit && Math::isEqual( len_sqr[c], one, eps );
+   if (!unit)
+      return MatType::AFFINE | MatType::NON_UNISCALE;
+
+   if (w != one)
+      return MatType::AFFINE;
+
+   bool rot_ident = true;
+   for (unsigned int r = 0; r < 3 && rot_ident; ++r)
+   for (unsigned int c = 0; c < 3 && rot_ident; ++c)
+      rot_ident = (mat( r, c ) == ((r == c) ? one : zero));
+   if (rot_ident)
+      return MatType::TRANS;
+
+   return has_trans ? MatType::AFFINE : MatType::ORTHOGONAL;
+}
+
+/** Sets the state of a matrix from its elements.
+ *  @see classifyState()
+ *  @post mat.mState == classifyState( mat, eps )
+ *  @return  a reference to mat for convenience
+ */
+template <typename DATA_TYPE, unsigned ROWS, unsigned COLS>
+inline Matrix<DATA_TYPE, ROWS, COLS>& detectState( Matrix<DATA_TYPE, ROWS, COLS>& mat,
+                                                   const DATA_TYPE eps = static_cast<DATA_TYPE>(GMTL_MAT_STATE_EPSILON) )
+{
+   mat.mState = classifyState( mat, eps );
+   return mat;
+}
+
 } // end namespace gmtl
 
 
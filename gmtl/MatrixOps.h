@@ -9,10 +9,15 @@
 #include <iostream>         // for std::cerr
 #include <algorithm>        // needed for std::swap
 #include <gmtl/Matrix.h>
+#ifndef GMTL_NO_METAPROG
+#include <gmtl/MatrixOpsMeta.h>
+#include <gmtl/MatExprMeta.h>
+#endif
 #include <gmtl/Math.h>
 #include <gmtl/Vec.h>
 #include <gmtl/VecOps.h>
 #include <gmtl/Util/Assert.h>
+#include <gmtl/Util/Simd.h>
 
 namespace gmtl
 {
@@ -33,7 +38,7 @@ namespace gmtl
    {
       if(result.mState != Matrix<DATA_TYPE, ROWS, COLS>::IDENTITY)   // if not already ident
       {
-         // TODO: mp
+#ifdef GMTL_NO_METAPROG
          for (unsigned int r = 0; r < ROWS; ++r)
          {
             for (unsigned int c = 0; c < COLS; ++c)
@@ -42,11 +47,13 @@ namespace gmtl
             }
          }
 
-         // TODO: mp
          for (unsigned int x = 0; x < Math::Min(COLS, ROWS); ++x)
          {
             result(x, x) = static_cast<DATA_TYPE>(1.0);
          }
+#else
+         gmtl::meta::IdentityMatUnrolled<ROWS*COLS-1, ROWS, DATA_TYPE>::func(result.mData);
+#endif
 
          result.mState = Matrix<DATA_TYPE, ROWS, COLS>::IDENTITY;
 //         result.mState = Matrix<DATA_TYPE, ROWS, COLS>::FULL;
@@ -73,10 +80,14 @@ namespace gmtl
       }
       else
       {
+#ifdef GMTL_NO_METAPROG
          for (unsigned int x = 0; x < ROWS * COLS; ++x)
          {
             result.mData[x] = static_cast<DATA_TYPE>(0);
          }
+#else
+         gmtl::meta::ZeroMatUnrolled<ROWS*COLS-1, DATA_TYPE>::func(result.mData);
+#endif
       }
       result.mState = Matrix<DATA_TYPE, ROWS, COLS>::ORTHOGONAL;
       return result;
@@ -93,22 +104,405 @@ namespace gmtl
                  const Matrix<DATA_TYPE, ROWS, INTERNAL>& lhs,
                  const Matrix<DATA_TYPE, INTERNAL, COLS>& rhs )
    {
-      Matrix<DATA_TYPE, ROWS, COLS> ret_mat; // prevent aliasing
-      zero( ret_mat );
+      Matrix<DATA_TYPE, ROWS, COLS> ret_mat( NO_INIT ); // prevent aliasing
 
       // p. 150 Numerical Analysis (second ed.)
       // if A is m x p, and B is p x n, then AB is m x n
       // (AB)ij  =  [k = 1 to p] (a)ik (b)kj     (where:  1 <= i <= m, 1 <= j <= n)
       for (unsigned int i = 0; i < ROWS; ++i)           // 1 <= i <= m
       for (unsigned int j = 0; j < COLS; ++j)           // 1 <= j <= n
-      for (unsigned int k = 0; k < INTERNAL; ++k)       // [k = 1 to p]
-         ret_mat( i, j ) += lhs( i, k ) * rhs( k, j );
+      {
+         DATA_TYPE sum( 0 );
+         for (unsigned int k = 0; k < INTERNAL; ++k)    // [k = 1 to p]
+            sum += lhs( i, k ) * rhs( k, j );
+         ret_mat( i, j ) = sum;
+      }
 
       // track state
       ret_mat.mState = combineMatrixStates( lhs.mState, rhs.mState );
       return result = ret_mat;
    }
 
+   /** Tests if a matrix state guarantees the 4x4 "affine form".
+    *  That is, the bottom row of the matrix is (0,0,0,s).  This is true for
+    *  every tracked state except FULL (and error states).
+    */
+   inline bool isAffineState( const int state )
+   {
+      switch (state)
+      {
+      case Matrix44f::IDENTITY:
+      case Matrix44f::TRANS:
+      case Matrix44f::ORTHOGONAL:
+      case Matrix44f::AFFINE:
+      case Matrix44f::AFFINE | Matrix44f::NON_UNISCALE:
+         return true;
+      default:
+         return false;
+      }
+   }
+
+   /** translational matrix multiply.
+    *  Multiplies two 4x4 matrices that both contain only a translation, which
+    *  reduces to adding the translation columns.
+    *  @pre: lhs.mState and rhs.mState are TRANS
+    *  @post: result = lhs * rhs
+    */
+   template <typename DATA_TYPE>
+   inline Matrix<DATA_TYPE, 4, 4>& multTrans( Matrix<DATA_TYPE, 4, 4>& result,
+                                              const Matrix<DATA_TYPE, 4, 4>& lhs,
+                                              const Matrix<DATA_TYPE, 4, 4>& rhs )
+   {
+      const int state = combineMatrixStates( lhs.mState, rhs.mState );
+      const DATA_TYPE tx = lhs.mData[12] + rhs.mData[12];
+      const DATA_TYPE ty = lhs.mData[13] + rhs.mData[13];
+      const DATA_TYPE tz = lhs.mData[14] + rhs.mData[14];
+      if (&result != &lhs)
+         result = lhs;
+      result.mData[12] = tx;
+      result.mData[13] = ty;
+      result.mData[14] = tz;
+      result.mState = state;
+      return result;
+   }
+
+   /** affine matrix multiply.
+    *  Multiplies two 4x4 matrices whose bottom row is (0,0,0,s).  The zeros
+    *  in rhs's bottom row mean lhs's last column only contributes to the
+    *  translation, and the zeros in lhs's bottom row give the result's
+    *  bottom row (0,0,0,s*s') directly, so only 40 of the 64 products are
+    *  computed.  The SIMD versions below still compute lhs's bottom row,
+    *  which is free in a full vector lane, and give the same result.
+    *  result may alias lhs and/or rhs.
+    *  @pre: isAffineState( lhs.mState ) && isAffineState( rhs.mState )
+    *  @post: result = lhs * rhs  (where rhs is applied first)
+    */
+   template <typename DATA_TYPE>
+   inline Matrix<DATA_TYPE, 4, 4>& multAffine( Matrix<DATA_TYPE, 4, 4>& result,
+                                               const Matrix<DATA_TYPE, 4, 4>& lhs,
+                                               const Matrix<DATA_TYPE, 4, 4>& rhs )
+   {
+      const int state = combineMatrixStates( lhs.mState, rhs.mState );
+      const DATA_TYPE* a = lhs.mData;
+      const DATA_TYPE* b = rhs.mData;
+      DATA_TYPE r[16];
+
+      // rotation/scale columns
+      for (unsigned j = 0; j < 3; ++j)
+      {
+         for (unsigned i = 0; i < 3; ++i)
+            r[j*4 + i] = a[i] * b[j*4] + a[4 + i] * b[j*4 + 1] + a[8 + i] * b[j*4 + 2];
+         r[j*4 + 3] = DATA_TYPE( 0 );
+      }
+
+      // translation and homogeneous scale
+      for (unsigned i = 0; i < 3; ++i)
+         r[12 + i] = a[i] * b[12] + a[4 + i] * b[13] + a[8 + i] * b[14] + a[12 + i] * b[15];
+      r[15] = a[15] * b[15];
+
+      for (unsigned x = 0; x < 16; ++x)
+         result.mData[x] = r[x];
+      result.mState = state;
+      return result;
+   }
+
+   /** full matrix multiply.
+    *  Multiplies two 4x4 matrices without looking at their state.
+    *  @post: result = lhs * rhs  (where rhs is applied first)
+    */
+   template <typename DATA_TYPE>
+   inline Matrix<DATA_TYPE, 4, 4>& multFull( Matrix<DATA_TYPE, 4, 4>& result,
+                                             const Matrix<DATA_TYPE, 4, 4>& lhs,
+                                             const Matrix<DATA_TYPE, 4, 4>& rhs )
+   {
+      return mult<DATA_TYPE, 4, 4, 4>( result, lhs, rhs );
+   }
+
+#ifdef GMTL_HAVE_SSE
+   /** 4x4 single precision SSE/AVX version of multAffine().
+    *  @see multAffine(Matrix<DATA_TYPE,4,4>&, const Matrix<DATA_TYPE,4,4>&, const Matrix<DATA_TYPE,4,4>&)
+    */
+   inline Matrix<float, 4, 4>& multAffine( Matrix<float, 4, 4>& result,
+                                           const Matrix<float, 4, 4>& lhs,
+                                           const Matrix<float, 4, 4>& rhs )
+   {
+      const int state = combineMatrixStates( lhs.mState, rhs.mState );
+      const float* a = lhs.mData;
+      const float* b = rhs.mData;
+      float* r = result.mData;
+
+      const __m128 c0 = _mm_loadu_ps( a );
+      const __m128 c1 = _mm_loadu_ps( a + 4 );
+      const __m128 c2 = _mm_loadu_ps( a + 8 );
+      const __m128 c3 = _mm_loadu_ps( a + 12 );
+
+#ifdef GMTL_HAVE_AVX
+      const __m256 a0 = _mm256_insertf128_ps( _mm256_castps128_ps256( c0 ), c0, 1 );
+      const __m256 a1 = _mm256_insertf128_ps( _mm256_castps128_ps256( c1 ), c1, 1 );
+      const __m256 a2 = _mm256_insertf128_ps( _mm256_castps128_ps256( c2 ), c2, 1 );
+      const __m256 a3 = _mm256_insertf128_ps( _mm256_castps128_ps256( c3 ), c3, 1 );
+
+      // columns 0 and 1 never see lhs's last column
+      const __m256 b01 = _mm256_loadu_ps( b );
+      __m256 col = _mm256_mul_ps( a0, _mm256_shuffle_ps( b01, b01, 0x00 ) );
+      col = _mm256_add_ps( col, _mm256_mul_ps( a1, _mm256_shuffle_ps( b01, b01, 0x55 ) ) );
+      col = _mm256_add_ps( col, _mm256_mul_ps( a2, _mm256_shuffle_ps( b01, b01, 0xAA ) ) );
+
+      const __m256 b23 = _mm256_loadu_ps( b + 8 );
+      __m256 col23 = _mm256_mul_ps( a0, _mm256_shuffle_ps( b23, b23, 0x00 ) );
+      col23 = _mm256_add_ps( col23, _mm256_mul_ps( a1, _mm256_shuffle_ps( b23, b23, 0x55 ) ) );
+      col23 = _mm256_add_ps( col23, _mm256_mul_ps( a2, _mm256_shuffle_ps( b23, b23, 0xAA ) ) );
+      col23 = _mm256_add_ps( col23, _mm256_mul_ps( a3, _mm256_shuffle_ps( b23, b23, 0xFF ) ) );
+      _mm256_storeu_ps( r, col );
+      _mm256_storeu_ps( r + 8, col23 );
+#else
+      for (unsigned j = 0; j < 3; ++j)
+      {
+         const __m128 bj = _mm_loadu_ps( b + j * 4 );
+         __m128 col = _mm_mul_ps( c0, _mm_shuffle_ps( bj, bj, 0x00 ) );
+         col = _mm_add_ps( col, _mm_mul_ps( c1, _mm_shuffle_ps( bj, bj, 0x55 ) ) );
+         col = _mm_add_ps( col, _mm_mul_ps( c2, _mm_shuffle_ps( bj, bj, 0xAA ) ) );
+         _mm_storeu_ps( r + j * 4, col );
+      }
+      const __m128 b3 = _mm_loadu_ps( b + 12 );
+      __m128 col = _mm_mul_ps( c0, _mm_shuffle_ps( b3, b3, 0x00 ) );
+      col = _mm_add_ps( col, _mm_mul_ps( c1, _mm_shuffle_ps( b3, b3, 0x55 ) ) );
+      col = _mm_add_ps( col, _mm_mul_ps( c2, _mm_shuffle_ps( b3, b3, 0xAA ) ) );
+      col = _mm_add_ps( col, _mm_mul_ps( c3, _mm_shuffle_ps( b3, b3, 0xFF ) ) );
+      _mm_storeu_ps( r + 12, col );
+#endif
+
+      result.mState = state;
+      return result;
+   }
+
+   /** 4x4 single precision SSE/AVX version of multFull().
+    *  Each column of the result is built as a linear combination of the
+    *  columns of lhs, weighted by the matching column of rhs.
+    *  result may alias lhs and/or rhs.
+    *  @post: result = lhs * rhs  (where rhs is applied first)
+    */
+   inline Matrix<float, 4, 4>& multFull( Matrix<float, 4, 4>& result,
+                                         const Matrix<float, 4, 4>& lhs,
+                                         const Matrix<float, 4, 4>& rhs )
+   {
+      const int state = combineMatrixStates( lhs.mState, rhs.mState );
+      const float* a = lhs.mData;
+      const float* b = rhs.mData;
+      float* r = result.mData;
+
+      // lhs is read completely up front, rhs one column (pair) at a time
+      // before that column is written, so aliasing is harmless.
+      const __m128 c0 = _mm_loadu_ps( a );
+      const __m128 c1 = _mm_loadu_ps( a + 4 );
+      const __m128 c2 = _mm_loadu_ps( a + 8 );
+      const __m128 c3 = _mm_loadu_ps( a + 12 );
+
+#ifdef GMTL_HAVE_AVX
+      // two result columns per iteration, one in each 128bit lane
+      const __m256 a0 = _mm256_insertf128_ps( _mm256_castps128_ps256( c0 ), c0, 1 );
+      const __m256 a1 = _mm256_insertf128_ps( _mm256_castps128_ps256( c1 ), c1, 1 );
+      const __m256 a2 = _mm256_insertf128_ps( _mm256_castps128_ps256( c2 ), c2, 1 );
+      const __m256 a3 = _mm256_insertf128_ps( _mm256_castps128_ps256( c3 ), c3, 1 );
+      for (unsigned j = 0; j < 4; j += 2)
+      {
+         const __m256 bj = _mm256_loadu_ps( b + j * 4 );
+         __m256 col = _mm256_mul_ps( a0, _mm256_shuffle_ps( bj, bj, 0x00 ) );
+         col = _mm256_add_ps( col, _mm256_mul_ps( a1, _mm256_shuffle_ps( bj, bj, 0x55 ) ) );
+         col = _mm256_add_ps( col, _mm256_mul_ps( a2, _mm256_shuffle_ps( bj, bj, 0xAA ) ) );
+         col = _mm256_add_ps( col, _mm256_mul_ps( a3, _mm256_shuffle_ps( bj, bj, 0xFF ) ) );
+         _mm256_storeu_ps( r + j * 4, col );
+      }
+#else
+      for (unsigned j = 0; j < 4; ++j)
+      {
+         const __m128 bj = _mm_loadu_ps( b + j * 4 );
+         __m128 col = _mm_mul_ps( c0, _mm_shuffle_ps( bj, bj, 0x00 ) );
+         col = _mm_add_ps( col, _mm_mul_ps( c1, _mm_shuffle_ps( bj, bj, 0x55 ) ) );
+         col = _mm_add_ps( col, _mm_mul_ps( c2, _mm_shuffle_ps( bj, bj, 0xAA ) ) );
+         col = _mm_add_ps( col, _mm_mul_ps( c3, _mm_shuffle_ps( bj, bj, 0xFF ) ) );
+         _mm_storeu_ps( r + j * 4, col );
+      }
+#endif
+
+      result.mState = state;
+      return result;
+   }
+#endif
+
+#ifdef GMTL_HAVE_SSE2
+   /** 4x4 double precision SSE2/AVX version of multAffine().
+    *  @see multAffine(Matrix<DATA_TYPE,4,4>&, const Matrix<DATA_TYPE,4,4>&, const Matrix<DATA_TYPE,4,4>&)
+    */
+   inline Matrix<double, 4, 4>& multAffine( Matrix<double, 4, 4>& result,
+                                            const Matrix<double, 4, 4>& lhs,
+                                            const Matrix<double, 4, 4>& rhs )
+   {
+      const int state = combineMatrixStates( lhs.mState, rhs.mState );
+      const double* a = lhs.mData;
+      const double* b = rhs.mData;
+      double* r = result.mData;
+
+#ifdef GMTL_HAVE_AVX
+      const __m256d a0 = _mm256_loadu_pd( a );
+      const __m256d a1 = _mm256_loadu_pd( a + 4 );
+      const __m256d a2 = _mm256_loadu_pd( a + 8 );
+      const __m256d a3 = _mm256_loadu_pd( a + 12 );
+      for (unsigned j = 0; j < 4; ++j)
+      {
+         const __m256d b0 = _mm256_set1_pd( b[j * 4] );
+         const __m256d b1 = _mm256_set1_pd( b[j * 4 + 1] );
+         const __m256d b2 = _mm256_set1_pd( b[j * 4 + 2] );
+         __m256d col = _mm256_mul_pd( a0, b0 );
+         col = _mm256_add_pd( col, _mm256_mul_pd( a1, b1 ) );
+         col = _mm256_add_pd( col, _mm256_mul_pd( a2, b2 ) );
+         if (j == 3)
+            col = _mm256_add_pd( col, _mm256_mul_pd( a3, _mm256_set1_pd( b[15] ) ) );
+         _mm256_storeu_pd( r + j * 4, col );
+      }
+#else
+      const __m128d a0l = _mm_loadu_pd( a ),      a0h = _mm_loadu_pd( a + 2 );
+      const __m128d a1l = _mm_loadu_pd( a + 4 ),  a1h = _mm_loadu_pd( a + 6 );
+      const __m128d a2l = _mm_loadu_pd( a + 8 ),  a2h = _mm_loadu_pd( a + 10 );
+      const __m128d a3l = _mm_loadu_pd( a + 12 ), a3h = _mm_loadu_pd( a + 14 );
+      for (unsigned j = 0; j < 4; ++j)
+      {
+         const __m128d b0 = _mm_set1_pd( b[j * 4] );
+         const __m128d b1 = _mm_set1_pd( b[j * 4 + 1] );
+         const __m128d b2 = _mm_set1_pd( b[j * 4 + 2] );
+         __m128d lo = _mm_mul_pd( a0l, b0 );
+         __m128d hi = _mm_mul_pd( a0h, b0 );
+         lo = _mm_add_pd( lo, _mm_mul_pd( a1l, b1 ) );
+         hi = _mm_add_pd( hi, _mm_mul_pd( a1h, b1 ) );
+         lo = _mm_add_pd( lo, _mm_mul_pd( a2l, b2 ) );
+         hi = _mm_add_pd( hi, _mm_mul_pd( a2h, b2 ) );
+         if (j == 3)
+         {
+            const __m128d b3 = _mm_set1_pd( b[15] );
+            lo = _mm_add_pd( lo, _mm_mul_pd( a3l, b3 ) );
+            hi = _mm_add_pd( hi, _mm_mul_pd( a3h, b3 ) );
+         }
+         _mm_storeu_pd( r + j * 4, lo );
+         _mm_storeu_pd( r + j * 4 + 2, hi );
+      }
+#endif
+
+      result.mState = state;
+      return result;
+   }
+
+   /** 4x4 double precision SSE2/AVX version of multFull().
+    *  @see multFull(Matrix<float,4,4>&, const Matrix<float,4,4>&, const Matrix<float,4,4>&)
+    *  @post: result = lhs * rhs  (where rhs is applied first)
+    */
+   inline Matrix<double, 4, 4>& multFull( Matrix<double, 4, 4>& result,
+                                          const Matrix<double, 4, 4>& lhs,
+                                          const Matrix<double, 4, 4>& rhs )
+   {
+      const int state = combineMatrixStates( lhs.mState, rhs.mState );
+      const double* a = lhs.mData;
+      const double* b = rhs.mData;
+      double* r = result.mData;
+
+#ifdef GMTL_HAVE_AVX
+      const __m256d a0 = _mm256_loadu_pd( a );
+      const __m256d a1 = _mm256_loadu_pd( a + 4 );
+      const __m256d a2 = _mm256_loadu_pd( a + 8 );
+      const __m256d a3 = _mm256_loadu_pd( a + 12 );
+      for (unsigned j = 0; j < 4; ++j)
+      {
+         const __m256d b0 = _mm256_set1_pd( b[j * 4] );
+         const __m256d b1 = _mm256_set1_pd( b[j * 4 + 1] );
+         const __m256d b2 = _mm256_set1_pd( b[j * 4 + 2] );
+         const __m256d b3 = _mm256_set1_pd( b[j * 4 + 3] );
+         __m256d col = _mm256_mul_pd( a0, b0 );
+         col = _mm256_add_pd( col, _mm256_mul_pd( a1, b1 ) );
+         col = _mm256_add_pd( col, _mm256_mul_pd( a2, b2 ) );
+         col = _mm256_add_pd( col, _mm256_mul_pd( a3, b3 ) );
+         _mm256_storeu_pd( r + j * 4, col );
+      }
+#else
+      // each column is split in a low (rows 0,1) and high (rows 2,3) half
+      const __m128d a0l = _mm_loadu_pd( a ),      a0h = _mm_loadu_pd( a + 2 );
+      const __m128d a1l = _mm_loadu_pd( a + 4 ),  a1h = _mm_loadu_pd( a + 6 );
+      const __m128d a2l = _mm_loadu_pd( a + 8 ),  a2h = _mm_loadu_pd( a + 10 );
+      const __m128d a3l = _mm_loadu_pd( a + 12 ), a3h = _mm_loadu_pd( a + 14 );
+      for (unsigned j = 0; j < 4; ++j)
+      {
+         const __m128d b0 = _mm_set1_pd( b[j * 4] );
+         const __m128d b1 = _mm_set1_pd( b[j * 4 + 1] );
+         const __m128d b2 = _mm_set1_pd( b[j * 4 + 2] );
+         const __m128d b3 = _mm_set1_pd( b[j * 4 + 3] );
+         __m128d lo = _mm_mul_pd( a0l, b0 );
+         __m128d hi = _mm_mul_pd( a0h, b0 );
+         lo = _mm_add_pd( lo, _mm_mul_pd( a1l, b1 ) );
+         hi = _mm_add_pd( hi, _mm_mul_pd( a1h, b1 ) );
+         lo = _mm_add_pd( lo, _mm_mul_pd( a2l, b2 ) );
+         hi = _mm_add_pd( hi, _mm_mul_pd( a2h, b2 ) );
+         lo = _mm_add_pd( lo, _mm_mul_pd( a3l, b3 ) );
+         hi = _mm_add_pd( hi, _mm_mul_pd( a3h, b3 ) );
+         _mm_storeu_pd( r + j * 4, lo );
+         _mm_storeu_pd( r + j * 4 + 2, hi );
+      }
+#endif
+
+      result.mState = state;
+      return result;
+   }
+#endif
+
+   /** 4x4 matrix multiply.
+    *  Selects a multiplication kernel based on the state of the operands,
+    *  the same way invert() selects an inversion method:
+    *  - IDENTITY on either side copies the other operand
+    *  - TRANS * TRANS adds the translations (see multTrans())
+    *  - any other pair of tracked states skips the known bottom row (see multAffine())
+    *  - everything else does the full product (see multFull())
+    *
+    *  result may alias lhs and/or rhs.
+    *  @post: result = lhs * rhs  (where rhs is applied first)
+    */
+   template <typename DATA_TYPE>
+   inline Matrix<DATA_TYPE, 4, 4>& mult( Matrix<DATA_TYPE, 4, 4>& result,
+                                         const Matrix<DATA_TYPE, 4, 4>& lhs,
+                                         const Matrix<DATA_TYPE, 4, 4>& rhs )
+   {
+      typedef Matrix<DATA_TYPE, 4, 4> MatType;
+
+      if (lhs.mState == MatType::IDENTITY)
+      {
+         const int state = combineMatrixStates( lhs.mState, rhs.mState );
+         result = rhs;
+         result.mState = state;
+         return result;
+      }
+      else if (rhs.mState == MatType::IDENTITY)
+      {
+         const int state = combineMatrixStates( lhs.mState, rhs.mState );
+         result = lhs;
+         result.mState = state;
+         return result;
+      }
+      else if (lhs.mState == MatType::TRANS && rhs.mState == MatType::TRANS)
+         return multTrans( result, lhs, rhs );
+      else if (isAffineState( lhs.mState ) && isAffineState( rhs.mState ))
+         return multAffine( result, lhs, rhs );
+      else
+         return multFull( result, lhs, rhs );
+   }
+
+#ifdef GMTL_NO_METAPROG
+   /** Without expression templates an expression is the matrix itself, so
+    *  code written with makeMatExpr() still compiles.
+    */
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS>
+   inline const Matrix<DATA_TYPE, ROWS, COLS>& makeMatExpr( const Matrix<DATA_TYPE, ROWS, COLS>& mat )
+   {
+      return mat;
+   }
+#endif
+
+#if defined(GMTL_NO_METAPROG) || !defined(GMTL_MAT_EXPR)
    /** matrix * matrix.
     *  @PRE: With regard to size (ROWS/COLS): if lhs is m x p, and rhs is p x n, then result is m x n (mult func undefined otherwise)
     *  @POST: returns a m x n sized matrix == lhs * rhs (where rhs is applied first)
@@ -118,10 +512,255 @@ namespace gmtl
    inline Matrix<DATA_TYPE, ROWS, COLS> operator*( const Matrix<DATA_TYPE, ROWS, INTERNAL>& lhs,
                                                    const Matrix<DATA_TYPE, INTERNAL, COLS>& rhs )
    {
-      Matrix<DATA_TYPE, ROWS, COLS> temporary;
+      Matrix<DATA_TYPE, ROWS, COLS> temporary( NO_INIT );
       return mult( temporary, lhs, rhs );
    }
 
+   /** matrix + matrix.
+    *  returns a temporary, the result is FULL.
+    */
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS>
+   inline Matrix<DATA_TYPE, ROWS, COLS> operator+( const Matrix<DATA_TYPE, ROWS, COLS>& lhs,
+                                                   const Matrix<DATA_TYPE, ROWS, COLS>& rhs )
+   {
+      Matrix<DATA_TYPE, ROWS, COLS> temporary( NO_INIT );
+      add( temporary, lhs, rhs );
+      temporary.mState = Matrix<DATA_TYPE, ROWS, COLS>::FULL;
+      return temporary;
+   }
+
+   /** matrix - matrix.
+    *  returns a temporary, the result is FULL.
+    */
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS>
+   inline Matrix<DATA_TYPE, ROWS, COLS> operator-( const Matrix<DATA_TYPE, ROWS, COLS>& lhs,
+                                                   const Matrix<DATA_TYPE, ROWS, COLS>& rhs )
+   {
+      Matrix<DATA_TYPE, ROWS, COLS> temporary( NO_INIT );
+      sub( temporary, lhs, rhs );
+      temporary.mState = Matrix<DATA_TYPE, ROWS, COLS>::FULL;
+      return temporary;
+   }
+
+   /** matrix * scalar.
+    *  returns a temporary, the result is FULL.
+    */
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS>
+   inline Matrix<DATA_TYPE, ROWS, COLS> operator*( const Matrix<DATA_TYPE, ROWS, COLS>& mat,
+                                                   const DATA_TYPE& scalar )
+   {
+      Matrix<DATA_TYPE, ROWS, COLS> temporary( NO_INIT );
+      mult( temporary, mat, scalar );
+      temporary.mState = Matrix<DATA_TYPE, ROWS, COLS>::FULL;
+      return temporary;
+   }
+
+   /** scalar * matrix.
+    *  returns a temporary, the result is FULL.
+    */
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS>
+   inline Matrix<DATA_TYPE, ROWS, COLS> operator*( const DATA_TYPE& scalar,
+                                                   const Matrix<DATA_TYPE, ROWS, COLS>& mat )
+   {
+      return mat * scalar;
+   }
+
+   /** -matrix.
+    *  returns a temporary, the result is FULL.
+    */
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS>
+   inline Matrix<DATA_TYPE, ROWS, COLS> operator-( const Matrix<DATA_TYPE, ROWS, COLS>& mat )
+   {
+      Matrix<DATA_TYPE, ROWS, COLS> temporary( NO_INIT );
+      for (unsigned i = 0; i < ROWS * COLS; ++i)
+         temporary.mData[i] = -mat.mData[i];
+      temporary.mState = Matrix<DATA_TYPE, ROWS, COLS>::FULL;
+      return temporary;
+   }
+#endif
+
+#ifndef GMTL_NO_METAPROG
+   // --- Expression template versions (see MatExprMeta.h) --- //
+   // The operators below return a MatExpr that is evaluated when it
+   // is assigned to a Matrix, so a chain such as a * b + c * s is computed
+   // in a single pass without intermediate matrices.  The operands of a
+   // product are evaluated once, and a product that is assigned directly
+   // goes through mult().  Assignment checks for aliasing: m = m * a + b
+   // gives the same result as with temporaries.  Results of +, -, scalar *
+   // and unary - are FULL.
+   //
+   // An expression is started with makeMatExpr(), e.g.
+   //    m = makeMatExpr( a ) * s + b - c;
+   // The operators on two plain matrices only build expressions when
+   // GMTL_MAT_EXPR is defined (see Config.h).  Otherwise they return a
+   // Matrix, so a * b can still be passed to invert(), xform(), etc.
+
+   /** matrix * matrix.
+    *  @PRE: With regard to size (ROWS/COLS): if lhs is m x p, and rhs is p x n, then result is m x n (mult func undefined otherwise)
+    *  @POST: returns an expression for the m x n matrix lhs * rhs (where rhs is applied first)
+    */
+   template <typename DATA_TYPE, unsigned ROWS, unsigned INTERNAL, unsigned COLS, typename EXP1_T, typename EXP2_T>
+   inline MatExpr<DATA_TYPE, ROWS, COLS,
+                        meta::MatBinaryExpr<typename meta::MatProdOperand<DATA_TYPE, ROWS, INTERNAL, EXP1_T>::Type,
+                                            typename meta::MatProdOperand<DATA_TYPE, INTERNAL, COLS, EXP2_T>::Type,
+                                            meta::MatMultBinary<INTERNAL> > >
+   operator*( const MatExpr<DATA_TYPE, ROWS, INTERNAL, EXP1_T>& lhs,
+              const MatExpr<DATA_TYPE, INTERNAL, COLS, EXP2_T>& rhs )
+   {
+      typedef meta::MatProdOperand<DATA_TYPE, ROWS, INTERNAL, EXP1_T> Op1;
+      typedef meta::MatProdOperand<DATA_TYPE, INTERNAL, COLS, EXP2_T> Op2;
+      typedef meta::MatBinaryExpr<typename Op1::Type, typename Op2::Type,
+                                  meta::MatMultBinary<INTERNAL> > ExprType;
+      return MatExpr<DATA_TYPE, ROWS, COLS, ExprType>( ExprType( Op1::make( lhs ), Op2::make( rhs ) ) );
+   }
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned INTERNAL, unsigned COLS, typename EXP1_T>
+   inline MatExpr<DATA_TYPE, ROWS, COLS,
+                        meta::MatBinaryExpr<typename meta::MatProdOperand<DATA_TYPE, ROWS, INTERNAL, EXP1_T>::Type,
+                                            meta::MatLeaf<DATA_TYPE, INTERNAL, COLS>,
+                                            meta::MatMultBinary<INTERNAL> > >
+   operator*( const MatExpr<DATA_TYPE, ROWS, INTERNAL, EXP1_T>& lhs,
+              const Matrix<DATA_TYPE, INTERNAL, COLS>& rhs )
+   {
+      return lhs * makeMatExpr( rhs );
+   }
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned INTERNAL, unsigned COLS, typename EXP2_T>
+   inline MatExpr<DATA_TYPE, ROWS, COLS,
+                        meta::MatBinaryExpr<meta::MatLeaf<DATA_TYPE, ROWS, INTERNAL>,
+                                            typename meta::MatProdOperand<DATA_TYPE, INTERNAL, COLS, EXP2_T>::Type,
+                                            meta::MatMultBinary<INTERNAL> > >
+   operator*( const Matrix<DATA_TYPE, ROWS, INTERNAL>& lhs,
+              const MatExpr<DATA_TYPE, INTERNAL, COLS, EXP2_T>& rhs )
+   {
+      return makeMatExpr( lhs ) * rhs;
+   }
+
+/** Declares the three overloads of an element-wise binary operator that
+ *  take at least one expression.
+ */
+#define GMTL_MAT_EXPR_BINARY_OP(OPNAME, OP_T) \
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP1_T, typename EXP2_T> \
+   inline MatExpr<DATA_TYPE, ROWS, COLS, meta::MatBinaryExpr<EXP1_T, EXP2_T, OP_T> > \
+   OPNAME( const MatExpr<DATA_TYPE, ROWS, COLS, EXP1_T>& lhs, \
+           const MatExpr<DATA_TYPE, ROWS, COLS, EXP2_T>& rhs ) \
+   { \
+      typedef meta::MatBinaryExpr<EXP1_T, EXP2_T, OP_T> ExprType; \
+      return MatExpr<DATA_TYPE, ROWS, COLS, ExprType>( ExprType( lhs.mExp, rhs.mExp ) ); \
+   } \
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP1_T> \
+   inline MatExpr<DATA_TYPE, ROWS, COLS, meta::MatBinaryExpr<EXP1_T, \
+                                                                    meta::MatLeaf<DATA_TYPE, ROWS, COLS>, OP_T> > \
+   OPNAME( const MatExpr<DATA_TYPE, ROWS, COLS, EXP1_T>& lhs, \
+           const Matrix<DATA_TYPE, ROWS, COLS>& rhs ) \
+   { \
+      return OPNAME( lhs, makeMatExpr( rhs ) ); \
+   } \
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP2_T> \
+   inline MatExpr<DATA_TYPE, ROWS, COLS, meta::MatBinaryExpr<meta::MatLeaf<DATA_TYPE, ROWS, COLS>, \
+                                                                    EXP2_T, OP_T> > \
+   OPNAME( const Matrix<DATA_TYPE, ROWS, COLS>& lhs, \
+           const MatExpr<DATA_TYPE, ROWS, COLS, EXP2_T>& rhs ) \
+   { \
+      return OPNAME( makeMatExpr( lhs ), rhs ); \
+   }
+
+   /** matrix + matrix, element-wise. */
+   GMTL_MAT_EXPR_BINARY_OP(operator+, meta::MatPlusBinary)
+
+   /** matrix - matrix, element-wise. */
+   GMTL_MAT_EXPR_BINARY_OP(operator-, meta::MatMinusBinary)
+
+#undef GMTL_MAT_EXPR_BINARY_OP
+
+   /** matrix * scalar. */
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP_T>
+   inline MatExpr<DATA_TYPE, ROWS, COLS,
+                        meta::MatBinaryExpr<EXP_T, meta::MatScalarArg<DATA_TYPE>, meta::MatScaleBinary> >
+   operator*( const MatExpr<DATA_TYPE, ROWS, COLS, EXP_T>& mat, const DATA_TYPE& scalar )
+   {
+      typedef meta::MatBinaryExpr<EXP_T, meta::MatScalarArg<DATA_TYPE>, meta::MatScaleBinary> ExprType;
+      return MatExpr<DATA_TYPE, ROWS, COLS, ExprType>( ExprType( mat.mExp, meta::MatScalarArg<DATA_TYPE>( scalar ) ) );
+   }
+
+   /** scalar * matrix. */
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP_T>
+   inline MatExpr<DATA_TYPE, ROWS, COLS,
+                        meta::MatBinaryExpr<EXP_T, meta::MatScalarArg<DATA_TYPE>, meta::MatScaleBinary> >
+   operator*( const DATA_TYPE& scalar, const MatExpr<DATA_TYPE, ROWS, COLS, EXP_T>& mat )
+   {
+      return mat * scalar;
+   }
+
+   /** -matrix. */
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP_T>
+   inline MatExpr<DATA_TYPE, ROWS, COLS, meta::MatUnaryExpr<EXP_T, meta::MatNegUnary> >
+   operator-( const MatExpr<DATA_TYPE, ROWS, COLS, EXP_T>& mat )
+   {
+      typedef meta::MatUnaryExpr<EXP_T, meta::MatNegUnary> ExprType;
+      return MatExpr<DATA_TYPE, ROWS, COLS, ExprType>( ExprType( mat.mExp ) );
+   }
+
+#ifdef GMTL_MAT_EXPR
+   // the same operators on two plain matrices
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned INTERNAL, unsigned COLS>
+   inline MatExpr<DATA_TYPE, ROWS, COLS,
+                        meta::MatBinaryExpr<meta::MatLeaf<DATA_TYPE, ROWS, INTERNAL>,
+                                            meta::MatLeaf<DATA_TYPE, INTERNAL, COLS>,
+                                            meta::MatMultBinary<INTERNAL> > >
+   operator*( const Matrix<DATA_TYPE, ROWS, INTERNAL>& lhs,
+              const Matrix<DATA_TYPE, INTERNAL, COLS>& rhs )
+   {
+      return makeMatExpr( lhs ) * makeMatExpr( rhs );
+   }
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS>
+   inline MatExpr<DATA_TYPE, ROWS, COLS, meta::MatBinaryExpr<meta::MatLeaf<DATA_TYPE, ROWS, COLS>,
+                                                             meta::MatLeaf<DATA_TYPE, ROWS, COLS>,
+                                                             meta::MatPlusBinary> >
+   operator+( const Matrix<DATA_TYPE, ROWS, COLS>& lhs, const Matrix<DATA_TYPE, ROWS, COLS>& rhs )
+   {
+      return makeMatExpr( lhs ) + makeMatExpr( rhs );
+   }
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS>
+   inline MatExpr<DATA_TYPE, ROWS, COLS, meta::MatBinaryExpr<meta::MatLeaf<DATA_TYPE, ROWS, COLS>,
+                                                             meta::MatLeaf<DATA_TYPE, ROWS, COLS>,
+                                                             meta::MatMinusBinary> >
+   operator-( const Matrix<DATA_TYPE, ROWS, COLS>& lhs, const Matrix<DATA_TYPE, ROWS, COLS>& rhs )
+   {
+      return makeMatExpr( lhs ) - makeMatExpr( rhs );
+   }
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS>
+   inline MatExpr<DATA_TYPE, ROWS, COLS,
+                        meta::MatBinaryExpr<meta::MatLeaf<DATA_TYPE, ROWS, COLS>, meta::MatScalarArg<DATA_TYPE>,
+                                            meta::MatScaleBinary> >
+   operator*( const Matrix<DATA_TYPE, ROWS, COLS>& mat, const DATA_TYPE& scalar )
+   {
+      return makeMatExpr( mat ) * scalar;
+   }
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS>
+   inline MatExpr<DATA_TYPE, ROWS, COLS,
+                        meta::MatBinaryExpr<meta::MatLeaf<DATA_TYPE, ROWS, COLS>, meta::MatScalarArg<DATA_TYPE>,
+                                            meta::MatScaleBinary> >
+   operator*( const DATA_TYPE& scalar, const Matrix<DATA_TYPE, ROWS, COLS>& mat )
+   {
+      return makeMatExpr( mat ) * scalar;
+   }
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS>
+   inline MatExpr<DATA_TYPE, ROWS, COLS,
+                        meta::MatUnaryExpr<meta::MatLeaf<DATA_TYPE, ROWS, COLS>, meta::MatNegUnary> >
+   operator-( const Matrix<DATA_TYPE, ROWS, COLS>& mat )
+   {
+      return -makeMatExpr( mat );
+   }
+#endif
+#endif
+
    /** matrix subtraction (algebraic operation for matrix).
     *  @PRE: if lhs is m x n, and rhs is m x n, then result is m x n (mult func undefined otherwise)
     *  @POST: returns a m x n matrix
@@ -135,12 +774,17 @@ namespace gmtl
       // p. 150 Numerical Analysis (second ed.)
       // if A is m x n, and B is m x n, then AB is m x n
       // (A - B)ij  = (a)ij - (b)ij     (where:  1 <= i <= m, 1 <= j <= n)
+#ifdef GMTL_NO_METAPROG
       for (unsigned int i = 0; i < ROWS; ++i)           // 1 <= i <= m
       for (unsigned int j = 0; j < COLS; ++j)           // 1 <= j <= n
          result( i, j ) = lhs( i, j ) - rhs( i, j );
+#else
+      gmtl::meta::SubMatUnrolled<ROWS*COLS-1, DATA_TYPE>::func(result.mData, lhs.mData, rhs.mData);
+#endif
 
-      // track state
-      result.mState = combineMatrixStates( lhs.mState, rhs.mState );
+      // the sum of two affine matrices does not keep their bottom row, so
+      // mult() must not take a fast path on the result
+      result.mState = Matrix<DATA_TYPE, ROWS, COLS>::FULL;
       return result;
    }
 
@@ -157,12 +801,17 @@ namespace gmtl
       // p. 150 Numerical Analysis (second ed.)
       // if A is m x n, and B is m x n, then AB is m x n
       // (A - B)ij  = (a)ij + (b)ij     (where:  1 <= i <= m, 1 <= j <= n)
+#ifdef GMTL_NO_METAPROG
       for (unsigned int i = 0; i < ROWS; ++i)           // 1 <= i <= m
       for (unsigned int j = 0; j < COLS; ++j)           // 1 <= j <= n
          result( i, j ) = lhs( i, j ) + rhs( i, j );
+#else
+      gmtl::meta::AddMatUnrolled<ROWS*COLS-1, DATA_TYPE>::func(result.mData, lhs.mData, rhs.mData);
+#endif
 
-      // track state
-      result.mState = combineMatrixStates( lhs.mState, rhs.mState );
+      // the sum of two affine matrices does not keep their bottom row, so
+      // mult() must not take a fast path on the result
+      result.mState = Matrix<DATA_TYPE, ROWS, COLS>::FULL;
       return result;
    }
 
@@ -207,9 +856,14 @@ namespace gmtl
    template <typename DATA_TYPE, unsigned ROWS, unsigned COLS>
    inline Matrix<DATA_TYPE, ROWS, COLS>& mult( Matrix<DATA_TYPE, ROWS, COLS>& result, const Matrix<DATA_TYPE, ROWS, COLS>& mat, const DATA_TYPE& scalar )
    {
+#ifdef GMTL_NO_METAPROG
       for (unsigned i = 0; i < ROWS * COLS; ++i)
          result.mData[i] = mat.mData[i] * scalar;
-      result.mState = mat.mState;
+#else
+      gmtl::meta::ScaleMatUnrolled<ROWS*COLS-1, DATA_TYPE>::func(result.mData, mat.mData, scalar);
+#endif
+      // scaling also scales the bottom row
+      result.mState = Matrix<DATA_TYPE, ROWS, COLS>::FULL;
       return result;
    }
 
@@ -220,8 +874,13 @@ namespace gmtl
    template <typename DATA_TYPE, unsigned ROWS, unsigned COLS>
    inline Matrix<DATA_TYPE, ROWS, COLS>& mult( Matrix<DATA_TYPE, ROWS, COLS>& result, DATA_TYPE scalar )
    {
+#ifdef GMTL_NO_METAPROG
       for (unsigned i = 0; i < ROWS * COLS; ++i)
          result.mData[i] *= scalar;
+#else
+      gmtl::meta::ScaleMatUnrolled<ROWS*COLS-1, DATA_TYPE>::func(result.mData, result.mData, scalar);
+#endif
+      result.mState = Matrix<DATA_TYPE, ROWS, COLS>::FULL;
       return result;
    }
 
@@ -242,10 +901,17 @@ namespace gmtl
    template <typename DATA_TYPE, unsigned SIZE>
    Matrix<DATA_TYPE, SIZE, SIZE>& transpose( Matrix<DATA_TYPE, SIZE, SIZE>& result )
    {
+#ifdef GMTL_NO_METAPROG
       // p. 27 game programming gems #1
       for (unsigned c = 0; c < SIZE; ++c)
          for (unsigned r = c + 1; r < SIZE; ++r)
             std::swap( result( r, c ), result( c, r ) );
+#else
+      gmtl::meta::TransposeInPlaceMatUnrolled<SIZE*SIZE-1, SIZE, DATA_TYPE>::func(result.mData);
+#endif
+      // the translation moves into the bottom row
+      if (result.mState != Matrix<DATA_TYPE, SIZE, SIZE>::IDENTITY)
+         result.mState = Matrix<DATA_TYPE, SIZE, SIZE>::FULL;
 
       return result;
    }
@@ -260,6 +926,7 @@ namespace gmtl
       // in case result is == source... :(
       Matrix<DATA_TYPE, COLS, ROWS> temp = source;
 
+#ifdef GMTL_NO_METAPROG
       // p. 149 Numerical Analysis (second ed.)
       for (unsigned i = 0; i < ROWS; ++i)
       {
@@ -268,7 +935,13 @@ namespace gmtl
             result( i, j ) = temp( j, i );
          }
       }
-      result.mState = temp.mState;
+#else
+      gmtl::meta::TransposeMatUnrolled<ROWS*COLS-1, ROWS, COLS, DATA_TYPE>::func(result.mData, temp.mData);
+#endif
+      // the translation moves into the bottom row
+      result.mState = (temp.mState == Matrix<DATA_TYPE, COLS, ROWS>::IDENTITY)
+                    ? Matrix<DATA_TYPE, ROWS, COLS>::IDENTITY
+                    : Matrix<DATA_TYPE, ROWS, COLS>::FULL;
       return result;
    }
 
@@ -648,6 +1321,280 @@ namespace gmtl
    }
 
 
+   namespace helpers
+   {
+      /** Tests the determinant of a SIZE x SIZE matrix against zero.
+       *  The determinant scales with the SIZE-th power of the entries, so
+       *  it is divided by the largest entry once per row first.  A small
+       *  scale matrix is then not mistaken for a singular one.
+       */
+      template <typename DATA_TYPE, unsigned SIZE>
+      inline bool isSingularDet( DATA_TYPE det, const Matrix<DATA_TYPE, SIZE, SIZE>& mat )
+      {
+         DATA_TYPE scale( 0 );
+         for (unsigned i = 0; i < SIZE * SIZE; ++i)
+            scale = Math::Max( scale, Math::abs( mat.mData[i] ) );
+         if (scale == DATA_TYPE( 0 ))
+            return true;
+
+         const DATA_TYPE inv_scale = DATA_TYPE( 1 ) / scale;
+         for (unsigned i = 0; i < SIZE; ++i)
+            det *= inv_scale;
+         return Math::abs( det ) <= DATA_TYPE( 1e-20 );
+      }
+   }
+
+   /** Closed form 3x3 matrix inversion.
+    *  Builds the inverse from the adjugate: the rows of the inverse are the
+    *  cross products of pairs of columns, divided by the determinant.
+    *  result may alias src.
+    *  Check for error with Matrix::isError().
+    * @post: result' = inv( src )
+    * @post: If src is singular, then error bit is set within the Matrix
+    *        and the data of result is left unchanged.  The test is
+    *        relative to the largest entry of src.
+    */
+   template <typename DATA_TYPE>
+   inline Matrix<DATA_TYPE, 3, 3>& invertFull_cofactor( Matrix<DATA_TYPE, 3, 3>& result,
+                                                        const Matrix<DATA_TYPE, 3, 3>& src )
+   {
+      const DATA_TYPE* m = src.mData;
+
+      // adjugate rows: b x c, c x a, a x b   (a, b, c are the columns of src)
+      const DATA_TYPE r00 = m[4] * m[8] - m[5] * m[7];
+      const DATA_TYPE r01 = m[5] * m[6] - m[3] * m[8];
+      const DATA_TYPE r02 = m[3] * m[7] - m[4] * m[6];
+      const DATA_TYPE r10 = m[7] * m[2] - m[8] * m[1];
+      const DATA_TYPE r11 = m[8] * m[0] - m[6] * m[2];
+      const DATA_TYPE r12 = m[6] * m[1] - m[7] * m[0];
+      const DATA_TYPE r20 = m[1] * m[5] - m[2] * m[4];
+      const DATA_TYPE r21 = m[2] * m[3] - m[0] * m[5];
+      const DATA_TYPE r22 = m[0] * m[4] - m[1] * m[3];
+
+      const DATA_TYPE det = m[0] * r00 + m[1] * r01 + m[2] * r02;
+      if (helpers::isSingularDet( det, src ))
+      {
+         result.setError();
+         return result;
+      }
+      const DATA_TYPE inv_det = DATA_TYPE( 1 ) / det;
+      const int state = src.mState;
+
+      DATA_TYPE* r = result.mData;
+      r[0] = r00 * inv_det;  r[3] = r01 * inv_det;  r[6] = r02 * inv_det;
+      r[1] = r10 * inv_det;  r[4] = r11 * inv_det;  r[7] = r12 * inv_det;
+      r[2] = r20 * inv_det;  r[5] = r21 * inv_det;  r[8] = r22 * inv_det;
+      result.mState = state;
+      return result;
+   }
+
+   /** Closed form 4x4 matrix inversion.
+    *  With a, b, c, d the upper three elements of the columns of src and
+    *  x, y, z, w its bottom row, the inverse is assembled from the four
+    *  vectors s = a x b, t = c x d, u = y*a - x*b and v = w*c - z*d, whose
+    *  combination s.v + t.u is the determinant (see Lengyel, "Foundations
+    *  of Game Engine Development, Vol. 1").
+    *  result may alias src.
+    *  Check for error with Matrix::isError().
+    * @post: result' = inv( src )
+    * @post: If src is singular, then error bit is set within the Matrix
+    *        and the data of result is left unchanged.  The test is
+    *        relative to the largest entry of src.
+    */
+   template <typename DATA_TYPE>
+   inline Matrix<DATA_TYPE, 4, 4>& invertFull_cofactor( Matrix<DATA_TYPE, 4, 4>& result,
+                                                        const Matrix<DATA_TYPE, 4, 4>& src )
+   {
+      const DATA_TYPE* m = src.mData;
+      const DATA_TYPE ax = m[0],  ay = m[1],  az = m[2],  x = m[3];
+      const DATA_TYPE bx = m[4],  by = m[5],  bz = m[6],  y = m[7];
+      const DATA_TYPE cx = m[8],  cy = m[9],  cz = m[10], z = m[11];
+      const DATA_TYPE dx = m[12], dy = m[13], dz = m[14], w = m[15];
+
+      const DATA_TYPE sx = ay * bz - az * by, sy = az * bx - ax * bz, sz = ax * by - ay * bx;
+      const DATA_TYPE tx = cy * dz - cz * dy, ty = cz * dx - cx * dz, tz = cx * dy - cy * dx;
+      const DATA_TYPE ux = y * ax - x * bx,   uy = y * ay - x * by,   uz = y * az - x * bz;
+      const DATA_TYPE vx = w * cx - z * dx,   vy = w * cy - z * dy,   vz = w * cz - z * dz;
+
+      const DATA_TYPE det = sx * vx + sy * vy + sz * vz + tx * ux + ty * uy + tz * uz;
+      if (helpers::isSingularDet( det, src ))
+      {
+         result.setError();
+         return result;
+      }
+      const DATA_TYPE inv_det = DATA_TYPE( 1 ) / det;
+      const int state = src.mState;
+
+      DATA_TYPE* r = result.mData;
+      // row 0: b x v + y*t,  -b.t
+      r[0]  = ( by * vz - bz * vy + y * tx ) * inv_det;
+      r[4]  = ( bz * vx - bx * vz + y * ty ) * inv_det;
+      r[8]  = ( bx * vy - by * vx + y * tz ) * inv_det;
+      r[12] = -( bx * tx + by * ty + bz * tz ) * inv_det;
+      // row 1: v x a - x*t,  a.t
+      r[1]  = ( vy * az - vz * ay - x * tx ) * inv_det;
+      r[5]  = ( vz * ax - vx * az - x * ty ) * inv_det;
+      r[9]  = ( vx * ay - vy * ax - x * tz ) * inv_det;
+      r[13] = ( ax * tx + ay * ty + az * tz ) * inv_det;
+      // row 2: d x u + w*s,  -d.s
+      r[2]  = ( dy * uz - dz * uy + w * sx ) * inv_det;
+      r[6]  = ( dz * ux - dx * uz + w * sy ) * inv_det;
+      r[10] = ( dx * uy - dy * ux + w * sz ) * inv_det;
+      r[14] = -( dx * sx + dy * sy + dz * sz ) * inv_det;
+      // row 3: u x c - z*s,  c.s
+      r[3]  = ( uy * cz - uz * cy - z * sx ) * inv_det;
+      r[7]  = ( uz * cx - ux * cz - z * sy ) * inv_det;
+      r[11] = ( ux * cy - uy * cx - z * sz ) * inv_det;
+      r[15] = ( cx * sx + cy * sy + cz * sz ) * inv_det;
+
+      result.mState = state;
+      return result;
+   }
+
+#ifdef GMTL_HAVE_SSE
+   /** 4x4 single precision SSE version of invertFull_cofactor().
+    *  The columns of src are kept in registers with the bottom row in the
+    *  fourth lane.  The cross products then produce 0 in that lane, which
+    *  lets the dot products run over all four lanes.
+    *  @see invertFull_cofactor(Matrix<DATA_TYPE,4,4>&, const Matrix<DATA_TYPE,4,4>&)
+    */
+   inline Matrix<float, 4, 4>& invertFull_cofactor( Matrix<float, 4, 4>& result,
+                                                    const Matrix<float, 4, 4>& src )
+   {
+      const __m128 a = _mm_loadu_ps( src.mData );
+      const __m128 b = _mm_loadu_ps( src.mData + 4 );
+      const __m128 c = _mm_loadu_ps( src.mData + 8 );
+      const __m128 d = _mm_loadu_ps( src.mData + 12 );
+
+#define GMTL_CROSS_PS( p, q ) \
+      _mm_sub_ps( _mm_mul_ps( _mm_shuffle_ps( p, p, _MM_SHUFFLE( 3, 0, 2, 1 ) ), \
+                              _mm_shuffle_ps( q, q, _MM_SHUFFLE( 3, 1, 0, 2 ) ) ), \
+                  _mm_mul_ps( _mm_shuffle_ps( p, p, _MM_SHUFFLE( 3, 1, 0, 2 ) ), \
+                              _mm_shuffle_ps( q, q, _MM_SHUFFLE( 3, 0, 2, 1 ) ) ) )
+
+      const __m128 x = _mm_shuffle_ps( a, a, 0xFF );
+      const __m128 y = _mm_shuffle_ps( b, b, 0xFF );
+      const __m128 z = _mm_shuffle_ps( c, c, 0xFF );
+      const __m128 w = _mm_shuffle_ps( d, d, 0xFF );
+
+      const __m128 s = GMTL_CROSS_PS( a, b );
+      const __m128 t = GMTL_CROSS_PS( c, d );
+      const __m128 u = _mm_sub_ps( _mm_mul_ps( y, a ), _mm_mul_ps( x, b ) );
+      const __m128 v = _mm_sub_ps( _mm_mul_ps( w, c ), _mm_mul_ps( z, d ) );
+
+      // det = s.v + t.u, summed across the lanes
+      __m128 det = _mm_add_ps( _mm_mul_ps( s, v ), _mm_mul_ps( t, u ) );
+      det = _mm_add_ps( det, _mm_movehl_ps( det, det ) );
+      det = _mm_add_ss( det, _mm_shuffle_ps( det, det, 0x55 ) );
+      const float det_val = _mm_cvtss_f32( det );
+      if (helpers::isSingularDet( det_val, src ))
+      {
+         result.setError();
+         return result;
+      }
+      const __m128 inv_det = _mm_div_ps( _mm_set1_ps( 1.0f ), _mm_shuffle_ps( det, det, 0x00 ) );
+
+      // rows of the inverse with 0 in the fourth lane
+      __m128 r0 = _mm_add_ps( GMTL_CROSS_PS( b, v ), _mm_mul_ps( y, t ) );
+      __m128 r1 = _mm_sub_ps( GMTL_CROSS_PS( v, a ), _mm_mul_ps( x, t ) );
+      __m128 r2 = _mm_add_ps( GMTL_CROSS_PS( d, u ), _mm_mul_ps( w, s ) );
+      __m128 r3 = _mm_sub_ps( GMTL_CROSS_PS( u, c ), _mm_mul_ps( z, s ) );
+#undef GMTL_CROSS_PS
+
+      // last column: (-b.t, a.t, -d.s, c.s)
+      __m128 p0 = _mm_mul_ps( b, t );
+      __m128 p1 = _mm_mul_ps( a, t );
+      __m128 p2 = _mm_mul_ps( d, s );
+      __m128 p3 = _mm_mul_ps( c, s );
+      _MM_TRANSPOSE4_PS( p0, p1, p2, p3 );
+      __m128 col3 = _mm_add_ps( _mm_add_ps( p0, p1 ), _mm_add_ps( p2, p3 ) );
+      col3 = _mm_mul_ps( col3, _mm_set_ps( 1.0f, -1.0f, 1.0f, -1.0f ) );
+
+      _MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+      _mm_storeu_ps( result.mData,      _mm_mul_ps( r0, inv_det ) );
+      _mm_storeu_ps( result.mData + 4,  _mm_mul_ps( r1, inv_det ) );
+      _mm_storeu_ps( result.mData + 8,  _mm_mul_ps( r2, inv_det ) );
+      _mm_storeu_ps( result.mData + 12, _mm_mul_ps( col3, inv_det ) );
+
+      result.mState = src.mState;
+      return result;
+   }
+#endif
+
+#ifdef GMTL_HAVE_AVX
+   /** 4x4 double precision AVX version of invertFull_cofactor().
+    *  Same scheme as the single precision SSE version, with one column of
+    *  src per 256bit register.
+    *  @see invertFull_cofactor(Matrix<DATA_TYPE,4,4>&, const Matrix<DATA_TYPE,4,4>&)
+    */
+   inline Matrix<double, 4, 4>& invertFull_cofactor( Matrix<double, 4, 4>& result,
+                                                     const Matrix<double, 4, 4>& src )
+   {
+      const __m256d a = _mm256_loadu_pd( src.mData );
+      const __m256d b = _mm256_loadu_pd( src.mData + 4 );
+      const __m256d c = _mm256_loadu_pd( src.mData + 8 );
+      const __m256d d = _mm256_loadu_pd( src.mData + 12 );
+
+      // (x,y,z,w) -> (y,z,x,w) and (z,x,y,w) without crossing into AVX2
+#define GMTL_YZXW_PD( p ) \
+      _mm256_permute_pd( _mm256_shuffle_pd( p, _mm256_permute2f128_pd( p, p, 0x01 ), 0x5 ), 0x6 )
+#define GMTL_ZXYW_PD( p ) \
+      _mm256_shuffle_pd( _mm256_permute2f128_pd( p, p, 0x01 ), p, 0xC )
+#define GMTL_CROSS_PD( p, q ) \
+      _mm256_sub_pd( _mm256_mul_pd( GMTL_YZXW_PD( p ), GMTL_ZXYW_PD( q ) ), \
+                     _mm256_mul_pd( GMTL_ZXYW_PD( p ), GMTL_YZXW_PD( q ) ) )
+
+      const __m256d x = _mm256_set1_pd( src.mData[3] );
+      const __m256d y = _mm256_set1_pd( src.mData[7] );
+      const __m256d z = _mm256_set1_pd( src.mData[11] );
+      const __m256d w = _mm256_set1_pd( src.mData[15] );
+
+      const __m256d s = GMTL_CROSS_PD( a, b );
+      const __m256d t = GMTL_CROSS_PD( c, d );
+      const __m256d u = _mm256_sub_pd( _mm256_mul_pd( y, a ), _mm256_mul_pd( x, b ) );
+      const __m256d v = _mm256_sub_pd( _mm256_mul_pd( w, c ), _mm256_mul_pd( z, d ) );
+
+      __m256d det4 = _mm256_add_pd( _mm256_mul_pd( s, v ), _mm256_mul_pd( t, u ) );
+      __m128d det = _mm_add_pd( _mm256_castpd256_pd128( det4 ), _mm256_extractf128_pd( det4, 1 ) );
+      det = _mm_add_sd( det, _mm_unpackhi_pd( det, det ) );
+      const double det_val = _mm_cvtsd_f64( det );
+      if (helpers::isSingularDet( det_val, src ))
+      {
+         result.setError();
+         return result;
+      }
+      const __m256d inv_det = _mm256_set1_pd( 1.0 / det_val );
+
+      const __m256d r0 = _mm256_add_pd( GMTL_CROSS_PD( b, v ), _mm256_mul_pd( y, t ) );
+      const __m256d r1 = _mm256_sub_pd( GMTL_CROSS_PD( v, a ), _mm256_mul_pd( x, t ) );
+      const __m256d r2 = _mm256_add_pd( GMTL_CROSS_PD( d, u ), _mm256_mul_pd( w, s ) );
+      const __m256d r3 = _mm256_sub_pd( GMTL_CROSS_PD( u, c ), _mm256_mul_pd( z, s ) );
+#undef GMTL_CROSS_PD
+#undef GMTL_ZXYW_PD
+#undef GMTL_YZXW_PD
+
+      // last column: (-b.t, a.t, -d.s, c.s)
+      const __m256d h01 = _mm256_hadd_pd( _mm256_mul_pd( b, t ), _mm256_mul_pd( a, t ) );
+      const __m256d h23 = _mm256_hadd_pd( _mm256_mul_pd( d, s ), _mm256_mul_pd( c, s ) );
+      __m256d col3 = _mm256_add_pd( _mm256_permute2f128_pd( h01, h23, 0x20 ),
+                                    _mm256_permute2f128_pd( h01, h23, 0x31 ) );
+      col3 = _mm256_mul_pd( col3, _mm256_set_pd( 1.0, -1.0, 1.0, -1.0 ) );
+
+      // transpose the rows into columns, the fourth one is replaced by col3
+      const __m256d t0 = _mm256_unpacklo_pd( r0, r1 );
+      const __m256d t1 = _mm256_unpackhi_pd( r0, r1 );
+      const __m256d t2 = _mm256_unpacklo_pd( r2, r3 );
+      const __m256d t3 = _mm256_unpackhi_pd( r2, r3 );
+      _mm256_storeu_pd( result.mData,      _mm256_mul_pd( _mm256_permute2f128_pd( t0, t2, 0x20 ), inv_det ) );
+      _mm256_storeu_pd( result.mData + 4,  _mm256_mul_pd( _mm256_permute2f128_pd( t1, t3, 0x20 ), inv_det ) );
+      _mm256_storeu_pd( result.mData + 8,  _mm256_mul_pd( _mm256_permute2f128_pd( t0, t2, 0x31 ), inv_det ) );
+      _mm256_storeu_pd( result.mData + 12, _mm256_mul_pd( col3, inv_det ) );
+
+      result.mState = src.mState;
+      return result;
+   }
+#endif
+
    /** Invert method.
     * Calls invertFull_orig to do the work.
     */
@@ -657,6 +1604,24 @@ namespace gmtl
       return invertFull_orig(result,src);
    }
 
+   /** Invert method for 3x3 matrices.
+    * Calls invertFull_cofactor to do the work.
+    */
+   template <typename DATA_TYPE>
+   inline Matrix<DATA_TYPE, 3, 3>& invertFull( Matrix<DATA_TYPE, 3, 3>& result, const Matrix<DATA_TYPE, 3, 3>& src )
+   {
+      return invertFull_cofactor(result,src);
+   }
+
+   /** Invert method for 4x4 matrices.
+    * Calls invertFull_cofactor to do the work.
+    */
+   template <typename DATA_TYPE>
+   inline Matrix<DATA_TYPE, 4, 4>& invertFull( Matrix<DATA_TYPE, 4, 4>& result, const Matrix<DATA_TYPE, 4, 4>& src )
+   {
+      return invertFull_cofactor(result,src);
+   }
+
    /** smart matrix inversion.
     *  Does matrix inversion by intelligently selecting what type of inversion to use depending
     *  on the types of operations your Matrix has been through.
@@ -680,7 +1645,7 @@ namespace gmtl
                src.mState == (Matrix<DATA_TYPE, ROWS, COLS>::AFFINE | Matrix<DATA_TYPE, ROWS, COLS>::NON_UNISCALE))
          return invertAffine( result, src );
       else
-         return invertFull_orig( result, src );
+         return invertFull( result, src );
    }
 
    /** smart matrix inversion (in place)
@@ -721,6 +1686,7 @@ namespace gmtl
    inline bool operator==(const Matrix<DATA_TYPE, ROWS, COLS>& lhs,
                           const Matrix<DATA_TYPE, ROWS, COLS>& rhs)
    {
+#ifdef GMTL_NO_METAPROG
       for (unsigned int i = 0; i < ROWS * COLS; ++i)
       {
          if (lhs.mData[i] != rhs.mData[i])
@@ -730,6 +1696,9 @@ namespace gmtl
       }
 
       return true;
+#else
+      return gmtl::meta::EqualMatUnrolled<ROWS*COLS-1, DATA_TYPE>::func(lhs.mData, rhs.mData);
+#endif
 
       /*  Would like this
       return( lhs[0] == rhs[0] &&
@@ -774,6 +1743,69 @@ namespace gmtl
       }
       return true;
    }
+
+#ifndef GMTL_NO_METAPROG
+   /** Compares the result of a matrix expression with a matrix. */
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP_T>
+   inline bool operator==(const MatExpr<DATA_TYPE, ROWS, COLS, EXP_T>& lhs,
+                          const Matrix<DATA_TYPE, ROWS, COLS>& rhs)
+   {
+      return lhs.eval() == rhs;
+   }
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP_T>
+   inline bool operator!=(const MatExpr<DATA_TYPE, ROWS, COLS, EXP_T>& lhs,
+                          const Matrix<DATA_TYPE, ROWS, COLS>& rhs)
+   {
+      return ! (lhs == rhs);
+   }
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP_T>
+   inline bool isEqual( const MatExpr<DATA_TYPE, ROWS, COLS, EXP_T>& lhs, const Matrix<DATA_TYPE, ROWS, COLS>& rhs, const DATA_TYPE eps = 0 )
+   {
+      return isEqual( lhs.eval(), rhs, eps );
+   }
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP_T>
+   inline bool operator==(const Matrix<DATA_TYPE, ROWS, COLS>& lhs,
+                          const MatExpr<DATA_TYPE, ROWS, COLS, EXP_T>& rhs)
+   {
+      return lhs == rhs.eval();
+   }
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP_T>
+   inline bool operator!=(const Matrix<DATA_TYPE, ROWS, COLS>& lhs,
+                          const MatExpr<DATA_TYPE, ROWS, COLS, EXP_T>& rhs)
+   {
+      return ! (lhs == rhs);
+   }
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP_T>
+   inline bool isEqual( const Matrix<DATA_TYPE, ROWS, COLS>& lhs, const MatExpr<DATA_TYPE, ROWS, COLS, EXP_T>& rhs, const DATA_TYPE eps = 0 )
+   {
+      return isEqual( lhs, rhs.eval(), eps );
+   }
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP1_T, typename EXP2_T>
+   inline bool operator==(const MatExpr<DATA_TYPE, ROWS, COLS, EXP1_T>& lhs,
+                          const MatExpr<DATA_TYPE, ROWS, COLS, EXP2_T>& rhs)
+   {
+      return lhs.eval() == rhs.eval();
+   }
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP1_T, typename EXP2_T>
+   inline bool operator!=(const MatExpr<DATA_TYPE, ROWS, COLS, EXP1_T>& lhs,
+                          const MatExpr<DATA_TYPE, ROWS, COLS, EXP2_T>& rhs)
+   {
+      return ! (lhs == rhs);
+   }
+
+   template <typename DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP1_T, typename EXP2_T>
+   inline bool isEqual( const MatExpr<DATA_TYPE, ROWS, COLS, EXP1_T>& lhs, const MatExpr<DATA_TYPE, ROWS, COLS, EXP2_T>& rhs, const DATA_TYPE eps = 0 )
+   {
+      return isEqual( lhs.eval(), rhs.eval(), eps );
+   }
+#endif
 /** @} */
 
 } // end of namespace gmtl
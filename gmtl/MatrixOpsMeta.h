@@ -0,0 +1,315 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_MATRIX_OPS_META_H
+#define _GMTL_MATRIX_OPS_META_H
+
+#include <gmtl/Util/Meta.h>
+
+/** Meta programming classes for matrix operations.
+ *
+ * These work on the flat, column ordered element array of a matrix
+ * (Matrix::mData).  ELT is the last element to process, so an operation
+ * over a ROWS x COLS matrix starts at ELT = ROWS*COLS-1.  The loops are
+ * unrolled at compile time, which does not depend on the unrolling
+ * heuristics of the compiler (many stop at 16 iterations or less).
+ *
+ * Only matrices of up to MatUnrollMaxElts elements are unrolled; the
+ * recursion is one template instantiation per element, so larger ones
+ * (a 32x32 matrix would exceed the instantiation depth limit) pick the
+ * specialization for UNROLL == false, a plain loop.
+ */
+namespace gmtl
+{
+namespace meta
+{
+/** @ingroup MatrixOpsMeta */
+//@{
+
+/** The largest number of elements the meta classes below unroll. */
+enum { MatUnrollMaxElts = 16 };
+
+/** meta class to unroll element copies: dst = src. */
+template<int ELT, typename T, bool UNROLL = (ELT < MatUnrollMaxElts)>
+struct AssignMatUnrolled
+{
+   static void func(T* dst, const T* src)
+   {
+      AssignMatUnrolled<ELT-1,T>::func(dst, src);
+      dst[ELT] = src[ELT];
+   }
+};
+
+template<typename T>
+struct AssignMatUnrolled<0,T,true>
+{
+   static void func(T* dst, const T* src)
+   {  dst[0] = src[0]; }
+};
+
+template<int ELT, typename T>
+struct AssignMatUnrolled<ELT,T,false>
+{
+   static void func(T* dst, const T* src)
+   {
+      for (int i = 0; i <= ELT; ++i)
+         dst[i] = src[i];
+   }
+};
+
+/** meta class to unroll setting the elements to zero. */
+template<int ELT, typename T, bool UNROLL = (ELT < MatUnrollMaxElts)>
+struct ZeroMatUnrolled
+{
+   static void func(T* dst)
+   {
+      ZeroMatUnrolled<ELT-1,T>::func(dst);
+      dst[ELT] = static_cast<T>(0);
+   }
+};
+
+template<typename T>
+struct ZeroMatUnrolled<0,T,true>
+{
+   static void func(T* dst)
+   {  dst[0] = static_cast<T>(0); }
+};
+
+template<int ELT, typename T>
+struct ZeroMatUnrolled<ELT,T,false>
+{
+   static void func(T* dst)
+   {
+      for (int i = 0; i <= ELT; ++i)
+         dst[i] = static_cast<T>(0);
+   }
+};
+
+/** meta class to unroll the identity of a matrix with ROWS rows. */
+template<int ELT, unsigned ROWS, typename T, bool UNROLL = (ELT < MatUnrollMaxElts)>
+struct IdentityMatUnrolled
+{
+   enum { IsDiagonal = ((ELT % ROWS) == (ELT / ROWS)) };
+
+   static void func(T* dst)
+   {
+      IdentityMatUnrolled<ELT-1,ROWS,T>::func(dst);
+      dst[ELT] = static_cast<T>(IsDiagonal ? 1 : 0);
+   }
+};
+
+template<unsigned ROWS, typename T>
+struct IdentityMatUnrolled<0,ROWS,T,true>
+{
+   static void func(T* dst)
+   {  dst[0] = static_cast<T>(1); }
+};
+
+template<int ELT, unsigned ROWS, typename T>
+struct IdentityMatUnrolled<ELT,ROWS,T,false>
+{
+   static void func(T* dst)
+   {
+      for (int i = 0; i <= ELT; ++i)
+         dst[i] = static_cast<T>((unsigned(i) % ROWS) == (unsigned(i) / ROWS) ? 1 : 0);
+   }
+};
+
+/** meta class to unroll element-wise addition: dst = lhs + rhs. */
+template<int ELT, typename T, bool UNROLL = (ELT < MatUnrollMaxElts)>
+struct AddMatUnrolled
+{
+   static void func(T* dst, const T* lhs, const T* rhs)
+   {
+      AddMatUnrolled<ELT-1,T>::func(dst, lhs, rhs);
+      dst[ELT] = lhs[ELT] + rhs[ELT];
+   }
+};
+
+template<typename T>
+struct AddMatUnrolled<0,T,true>
+{
+   static void func(T* dst, const T* lhs, const T* rhs)
+   {  dst[0] = lhs[0] + rhs[0]; }
+};
+
+template<int ELT, typename T>
+struct AddMatUnrolled<ELT,T,false>
+{
+   static void func(T* dst, const T* lhs, const T* rhs)
+   {
+      for (int i = 0; i <= ELT; ++i)
+         dst[i] = lhs[i] + rhs[i];
+   }
+};
+
+/** meta class to unroll element-wise subtraction: dst = lhs - rhs. */
+template<int ELT, typename T, bool UNROLL = (ELT < MatUnrollMaxElts)>
+struct SubMatUnrolled
+{
+   static void func(T* dst, const T* lhs, const T* rhs)
+   {
+      SubMatUnrolled<ELT-1,T>::func(dst, lhs, rhs);
+      dst[ELT] = lhs[ELT] - rhs[ELT];
+   }
+};
+
+template<typename T>
+struct SubMatUnrolled<0,T,true>
+{
+   static void func(T* dst, const T* lhs, const T* rhs)
+   {  dst[0] = lhs[0] - rhs[0]; }
+};
+
+template<int ELT, typename T>
+struct SubMatUnrolled<ELT,T,false>
+{
+   static void func(T* dst, const T* lhs, const T* rhs)
+   {
+      for (int i = 0; i <= ELT; ++i)
+         dst[i] = lhs[i] - rhs[i];
+   }
+};
+
+/** meta class to unroll scaling: dst = src * scalar. */
+template<int ELT, typename T, bool UNROLL = (ELT < MatUnrollMaxElts)>
+struct ScaleMatUnrolled
+{
+   static void func(T* dst, const T* src, const T scalar)
+   {
+      ScaleMatUnrolled<ELT-1,T>::func(dst, src, scalar);
+      dst[ELT] = src[ELT] * scalar;
+   }
+};
+
+template<typename T>
+struct ScaleMatUnrolled<0,T,true>
+{
+   static void func(T* dst, const T* src, const T scalar)
+   {  dst[0] = src[0] * scalar; }
+};
+
+template<int ELT, typename T>
+struct ScaleMatUnrolled<ELT,T,false>
+{
+   static void func(T* dst, const T* src, const T scalar)
+   {
+      for (int i = 0; i <= ELT; ++i)
+         dst[i] = src[i] * scalar;
+   }
+};
+
+/** meta class to unroll a transpose.
+ *  dst is ROWS x COLS, src is COLS x ROWS, they must not be the same array.
+ */
+template<int ELT, unsigned ROWS, unsigned COLS, typename T, bool UNROLL = (ELT < MatUnrollMaxElts)>
+struct TransposeMatUnrolled
+{
+   // dst(r, c) = src(c, r)
+   enum { SrcElt = (ELT % ROWS) * COLS + (ELT / ROWS) };
+
+   static void func(T* dst, const T* src)
+   {
+      TransposeMatUnrolled<ELT-1,ROWS,COLS,T>::func(dst, src);
+      dst[ELT] = src[SrcElt];
+   }
+};
+
+template<unsigned ROWS, unsigned COLS, typename T>
+struct TransposeMatUnrolled<0,ROWS,COLS,T,true>
+{
+   static void func(T* dst, const T* src)
+   {  dst[0] = src[0]; }
+};
+
+template<int ELT, unsigned ROWS, unsigned COLS, typename T>
+struct TransposeMatUnrolled<ELT,ROWS,COLS,T,false>
+{
+   static void func(T* dst, const T* src)
+   {
+      for (int i = 0; i <= ELT; ++i)
+         dst[i] = src[(unsigned(i) % ROWS) * COLS + (unsigned(i) / ROWS)];
+   }
+};
+
+/** meta class to unroll an in place transpose of a SIZE x SIZE matrix.
+ *  Swaps each element below the diagonal with its mirror.
+ */
+template<int ELT, unsigned SIZE, typename T, bool UNROLL = (ELT < MatUnrollMaxElts)>
+struct TransposeInPlaceMatUnrolled
+{
+   enum { Row = ELT % SIZE, Col = ELT / SIZE, MirrorElt = Row * SIZE + Col };
+
+   static void func(T* dst)
+   {
+      TransposeInPlaceMatUnrolled<ELT-1,SIZE,T>::func(dst);
+      if (Row > Col)
+      {
+         const T temp = dst[ELT];
+         dst[ELT] = dst[MirrorElt];
+         dst[MirrorElt] = temp;
+      }
+   }
+};
+
+template<unsigned SIZE, typename T>
+struct TransposeInPlaceMatUnrolled<0,SIZE,T,true>
+{
+   static void func(T*)
+   {}
+};
+
+template<int ELT, unsigned SIZE, typename T>
+struct TransposeInPlaceMatUnrolled<ELT,SIZE,T,false>
+{
+   static void func(T* dst)
+   {
+      for (unsigned col = 0; col < SIZE; ++col)
+      {
+         for (unsigned row = col + 1; row < SIZE; ++row)
+         {
+            const T temp = dst[col * SIZE + row];
+            dst[col * SIZE + row] = dst[row * SIZE + col];
+            dst[row * SIZE + col] = temp;
+         }
+      }
+   }
+};
+
+/** meta class to test element-wise equality. */
+template<int ELT, typename T, bool UNROLL = (ELT < MatUnrollMaxElts)>
+struct EqualMatUnrolled
+{
+   static bool func(const T* lhs, const T* rhs)
+   {  return (lhs[ELT] == rhs[ELT]) && EqualMatUnrolled<ELT-1,T>::func(lhs, rhs); }
+};
+
+template<typename T>
+struct EqualMatUnrolled<0,T,true>
+{
+   static bool func(const T* lhs, const T* rhs)
+   {  return (lhs[0] == rhs[0]); }
+};
+
+template<int ELT, typename T>
+struct EqualMatUnrolled<ELT,T,false>
+{
+   static bool func(const T* lhs, const T* rhs)
+   {
+      for (int i = 0; i <= ELT; ++i)
+      {
+         if (!(lhs[i] == rhs[i]))
+            return false;
+      }
+      return true;
+   }
+};
+//@}
+
+} // namespace meta
+} // end namespace
+
+
+#endif
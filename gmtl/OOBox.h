@@ -6,177 +6,165 @@
 #ifndef _GMTL_OOBox_H_
 #define _GMTL_OOBox_H_
 
-#include <gmtl/Vec3.h>
-#include <gmtl/Point3.h>
-#include <gmtl/matVecFuncs.h>
+#include <gmtl/Point.h>
+#include <gmtl/Vec.h>
 
 namespace gmtl
 {
-
-// AABox : Defines an object aligned box
-//
-// For definition of an OOB, see pg 293-294 of Real-Time Rendering
-class  OOBox
-{
-
-public:
-   OOBox()
-   { ident(); }
-
-   OOBox(OOBox& box);
-
-public:
-   // Accessors
-   Point3& center();
-   const Point3& center() const;
-
-   Vec3& axis (int i);
-   const Vec3& axis (int i) const;
-   Vec3* axes ();
-   const Vec3* axes () const;
-
-   float& halfLen(int i);
-   const float& halfLen(int i) const;
-   float* halfLens();
-   const float* halfLens() const;
-
-   // Assignment
-   OOBox& operator=(const OOBox& box);
-
-   // Comparison
-   bool operator==(const OOBox& box) const;
-
-   //  return the verts that define the box
-   // Order: XYZ: 000, 100, 110, 010,
-   //             001, 101, 111, 011
-   void getVerts(Point3 verts[8]) const;
-
-   // Merge current box with other box to get new box covering both
-   void mergeWith(const OOBox& box);
-
-   void ident()
+   /**
+    * Describes an object oriented box in 3D space: a center, three
+    * orthonormal axes and the half length of the box along each of them.
+    * For the definition of an OOB, see pg 293-294 of Real-Time Rendering.
+    *
+    * @param DATA_TYPE     the internal type used for the points
+    *
+    * @ingroup Types
+    */
+   template< class DATA_TYPE >
+   class OOBox
    {
-      mCenter = ZeroVec3;
-      mAxis[0] = XUnitVec3;
-      mAxis[1] = YUnitVec3;
-      mAxis[2] = ZUnitVec3;
-      mHalfLen[0] = mHalfLen[1] = mHalfLen[2] = 0.0f;
-   }
-
-public:
-   Point3  mCenter;     // The center point of the box
-   Vec3    mAxis[3];    // The axes of the oriented box (xAxis, yAxis, zAxis)
-   float   mHalfLen[3]; // Half lengths of the box  ASSERT: HalfLens >= 0.0f
-};
-
-
-// ------------------------------------------------- //
-// --------------- Member definitions -------------- //
-// ------------------------------------------------- //
-inline
-OOBox::OOBox(OOBox& box)
-{
-   mCenter = box.mCenter;
-   mAxis[0] = box.mAxis[0];
-   mAxis[1] = box.mAxis[1];
-   mAxis[2] = box.mAxis[2];
-   mHalfLen[0] = box.mHalfLen[0];
-   mHalfLen[1] = box.mHalfLen[1];
-   mHalfLen[2] = box.mHalfLen[2];
+   public:
+      typedef DATA_TYPE DataType;
+
+   public:
+      /**
+       * Creates a box of size zero at the origin, aligned with the x, y and
+       * z axes.
+       */
+      OOBox()
+      {
+         ident();
+      }
+
+      /**
+       * Creates a new box.
+       *
+       * @param center     the center of the box
+       * @param axes       the three axes of the box
+       * @param halfLens   the half lengths of the box along axes
+       *
+       * @pre  axes are orthonormal and halfLens are >= 0
+       */
+      OOBox(const Point<DATA_TYPE, 3>& center, const Vec<DATA_TYPE, 3> axes[3],
+            const DATA_TYPE halfLens[3])
+         : mCenter(center)
+      {
+         for (unsigned int i = 0; i < 3; ++i)
+         {
+            mAxis[i] = axes[i];
+            mHalfLen[i] = halfLens[i];
+         }
+      }
+
+      /** Accessors */
+      Point<DATA_TYPE, 3>& center()
+      {
+         return mCenter;
+      }
+
+      const Point<DATA_TYPE, 3>& center() const
+      {
+         return mCenter;
+      }
+
+      Vec<DATA_TYPE, 3>& axis(int i)
+      {
+         return mAxis[i];
+      }
+
+      const Vec<DATA_TYPE, 3>& axis(int i) const
+      {
+         return mAxis[i];
+      }
+
+      Vec<DATA_TYPE, 3>* axes()
+      {
+         return mAxis;
+      }
+
+      const Vec<DATA_TYPE, 3>* axes() const
+      {
+         return mAxis;
+      }
+
+      DATA_TYPE& halfLen(int i)
+      {
+         return mHalfLen[i];
+      }
+
+      const DATA_TYPE& halfLen(int i) const
+      {
+         return mHalfLen[i];
+      }
+
+      DATA_TYPE* halfLens()
+      {
+         return mHalfLen;
+      }
+
+      const DATA_TYPE* halfLens() const
+      {
+         return mHalfLen;
+      }
+
+      /** Comparison */
+      bool operator==(const OOBox<DATA_TYPE>& box) const
+      {
+         return ((mCenter == box.mCenter) &&
+                 (mAxis[0] == box.mAxis[0]) &&
+                 (mAxis[1] == box.mAxis[1]) &&
+                 (mAxis[2] == box.mAxis[2]) &&
+                 (mHalfLen[0] == box.mHalfLen[0]) &&
+                 (mHalfLen[1] == box.mHalfLen[1]) &&
+                 (mHalfLen[2] == box.mHalfLen[2]));
+      }
+
+      /**
+       * Gets the corners of the box.
+       * Order: XYZ: 000, 100, 110, 010,
+       *             001, 101, 111, 011
+       */
+      void getVerts(Point<DATA_TYPE, 3> verts[8]) const
+      {
+         const Vec<DATA_TYPE, 3> x_half_axis = mAxis[0] * mHalfLen[0];
+         const Vec<DATA_TYPE, 3> y_half_axis = mAxis[1] * mHalfLen[1];
+         const Vec<DATA_TYPE, 3> z_half_axis = mAxis[2] * mHalfLen[2];
+
+         verts[0] = mCenter - x_half_axis - y_half_axis - z_half_axis;
+         verts[1] = mCenter + x_half_axis - y_half_axis - z_half_axis;
+         verts[2] = mCenter + x_half_axis + y_half_axis - z_half_axis;
+         verts[3] = mCenter - x_half_axis + y_half_axis - z_half_axis;
+         verts[4] = mCenter - x_half_axis - y_half_axis + z_half_axis;
+         verts[5] = mCenter + x_half_axis - y_half_axis + z_half_axis;
+         verts[6] = mCenter + x_half_axis + y_half_axis + z_half_axis;
+         verts[7] = mCenter - x_half_axis + y_half_axis + z_half_axis;
+      }
+
+      /** Makes this a box of size zero at the origin, aligned with x, y and z. */
+      void ident()
+      {
+         const DATA_TYPE zero(0), one(1);
+         mCenter.set(zero, zero, zero);
+         mAxis[0].set(one, zero, zero);
+         mAxis[1].set(zero, one, zero);
+         mAxis[2].set(zero, zero, one);
+         mHalfLen[0] = mHalfLen[1] = mHalfLen[2] = zero;
+      }
+
+   public:
+      /** The center point of the box. */
+      Point<DATA_TYPE, 3> mCenter;
+
+      /** The axes of the oriented box (xAxis, yAxis, zAxis). */
+      Vec<DATA_TYPE, 3> mAxis[3];
+
+      /** Half lengths of the box along its axes, all >= 0. */
+      DATA_TYPE mHalfLen[3];
+   };
+
+   // --- helper types --- //
+   typedef OOBox<float>    OOBoxf;
+   typedef OOBox<double>   OOBoxd;
 }
 
-// Accessors
-inline Point3& OOBox::center()
-{
-   return mCenter;
-}
-
-inline const Point3& OOBox::center() const
-{
-   return mCenter;
-}
-
-inline Vec3& OOBox::axis (int i)
-{
-   return mAxis[i];
-}
-
-inline const Vec3& OOBox::axis (int i) const
-{
-   return mAxis[i];
-}
-
-inline Vec3* OOBox::axes ()
-{
-   return mAxis;
-}
-
-inline const Vec3* OOBox::axes () const
-{
-   return mAxis;
-}
-
-inline float& OOBox::halfLen(int i)
-{
-   return mHalfLen[i];
-}
-
-inline const float& OOBox::halfLen(int i) const
-{
-   return mHalfLen[i];
-}
-
-inline float* OOBox::halfLens()
-{
-   return mHalfLen;
-}
-
-inline const float* OOBox::halfLens() const
-{
-   return mHalfLen;
-}
-
-// Assignment
-inline OOBox& OOBox::operator=(const OOBox& box)
-{
-   mCenter = box.mCenter;
-   mAxis[0] = box.mAxis[0];
-   mAxis[1] = box.mAxis[1];
-   mAxis[2] = box.mAxis[2];
-   mHalfLen[0] = box.mHalfLen[0];
-   mHalfLen[1] = box.mHalfLen[1];
-   mHalfLen[2] = box.mHalfLen[2];
-   return *this;
-}
-
-// Comparison
-inline bool OOBox::operator==(const OOBox& box) const
-{
-   return ((mCenter == box.mCenter) &&
-           (mAxis[0] == box.mAxis[0]) &&
-           (mAxis[1] == box.mAxis[1]) &&
-           (mAxis[2] == box.mAxis[2]) &&
-           (mHalfLen[0] == box.mHalfLen[0]) &&
-           (mHalfLen[1] == box.mHalfLen[1]) &&
-           (mHalfLen[2] == box.mHalfLen[2]));
-}
-
-inline void OOBox::getVerts(Point3 verts[8]) const
-{
-   Vec3 x_half_axis = mAxis[0]*mHalfLen[0];
-   Vec3 y_half_axis = mAxis[1]*mHalfLen[1];
-   Vec3 z_half_axis = mAxis[2]*mHalfLen[2];
-
-   verts[0] = mCenter - x_half_axis - y_half_axis - z_half_axis;
-   verts[1] = mCenter + x_half_axis - y_half_axis - z_half_axis;
-   verts[2] = mCenter + x_half_axis + y_half_axis - z_half_axis;
-   verts[3] = mCenter - x_half_axis + y_half_axis - z_half_axis;
-   verts[4] = mCenter - x_half_axis - y_half_axis + z_half_axis;
-   verts[5] = mCenter + x_half_axis - y_half_axis + z_half_axis;
-   verts[6] = mCenter + x_half_axis + y_half_axis + z_half_axis;
-   verts[7] = mCenter - x_half_axis + y_half_axis + z_half_axis;
-}
-
-};
-
 #endif
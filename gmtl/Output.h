@@ -144,6 +144,19 @@ namespace gmtl
       return out;
    }
 
+#ifndef GMTL_NO_METAPROG
+   /**
+    * Outputs the result of a matrix expression (such as a * b) in the same
+    * format as a Matrix.
+    */
+   template< class DATA_TYPE, unsigned ROWS, unsigned COLS, typename EXP_T >
+   std::ostream& operator<<( std::ostream& out,
+                             const MatExpr<DATA_TYPE, ROWS, COLS, EXP_T>& m )
+   {
+      return out << m.eval();
+   }
+#endif
+
    /**
     * Outputs a string representation of the given Matrix to the given output
     * stream. The output is formatted such that Quat<int>(1,2,3,4) will appear
@@ -48,6 +48,13 @@ public:
       }
    }
 
+   /** No-init constructor. The components are left uninitialized.
+    *  @see NoInit
+    */
+   explicit Point( NoInit )
+   {
+   }
+
    /** @name Value constructors
     * Construct with copy of rVec
     */
@@ -63,6 +63,14 @@ public:
    {
    }
    
+   /** no-init constructor, leaves the quaternion uninitialized.
+    *  @see NoInit
+    */
+   explicit Quat( NoInit )
+      : mData( NO_INIT )
+   {
+   }
+
    /** data constructor, initializes to quaternion multiplication identity
     *  [x,y,z,w] == [0,0,0,1].
     *  NOTE: the addition identity is [0,0,0,0]
@@ -79,6 +87,14 @@ public:
    {
    }
 
+   /** assignment operator, declared along with the copy constructor
+    */
+   Quat& operator=( const Quat<DATA_TYPE>& q )
+   {
+      mData = q.mData;
+      return *this;
+   }
+
    /** directly set the quaternion's values
     *  @pre x,y,z,w should be normalized
     *  @post the quaternion is set with the given values
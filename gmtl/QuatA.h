@@ -0,0 +1,64 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_QUATA_H_
+#define _GMTL_QUATA_H_
+
+#include <gmtl/Defines.h>
+#include <gmtl/Quat.h>
+
+namespace gmtl
+{
+
+/**
+ * A Quatf that is aligned to 16 bytes.  The layout is the same as Quatf
+ * ([x,y,z,w]), so arrays of the two can be converted into each other.
+ *
+ * QuatfA is a Quatf: every function that takes a Quatf takes a QuatfA as
+ * well.  The SIMD versions of the QuatOps.h functions are in QuatAOps.h.
+ *
+ * @see Quatf
+ * @ingroup Types
+ */
+class GMTL_ALIGN(16) QuatfA : public Quat<float>
+{
+public:
+   /// The superclass type.
+   typedef Quat<float> BaseType;
+
+   /** default constructor, initializes to the multiplication identity
+    *  [x,y,z,w] == [0,0,0,1].
+    */
+   QuatfA()
+   {
+   }
+
+   /** no-init constructor, leaves the quaternion uninitialized. */
+   explicit QuatfA( NoInit )
+      : BaseType( NO_INIT )
+   {
+   }
+
+   QuatfA( const float& x, const float& y, const float& z, const float& w )
+      : BaseType( x, y, z, w )
+   {
+   }
+
+   /** Creates an aligned copy of the given quaternion (explicit, see Vec3fA). */
+   explicit QuatfA( const Quat<float>& q )
+      : BaseType( q )
+   {
+   }
+
+   QuatfA& operator=( const Quat<float>& q )
+   {
+      BaseType::operator=( q );
+      return *this;
+   }
+};
+
+} // end of namespace gmtl
+
+#endif
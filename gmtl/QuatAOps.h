@@ -0,0 +1,152 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_QUATA_OPS_H_
+#define _GMTL_QUATA_OPS_H_
+
+#include <gmtl/QuatA.h>
+#include <gmtl/QuatOps.h>
+#include <gmtl/VecAOps.h>
+#include <gmtl/Util/Simd.h>
+
+/** @file QuatAOps.h
+ * SSE2 versions of the QuatOps.h functions for the aligned QuatfA type,
+ * and of the quaternion rotation of a Vec3fA.
+ *
+ * Like VecAOps.h these are non-template overloads.  Except for xform(),
+ * the operations are done in the same order as in the QuatOps.h
+ * templates, so the results only differ where the compiler contracts the
+ * templates into FMAs.  Without SSE2 (or with GMTL_NO_SIMD) the templates
+ * are used.
+ */
+
+#ifdef GMTL_HAVE_SSE2
+namespace gmtl
+{
+/** @ingroup Ops
+ * @name Aligned Quat Operations
+ * @{
+ */
+
+/** @see mult(Quat<DATA_TYPE>&, const Quat<DATA_TYPE>&, const Quat<DATA_TYPE>&) */
+inline QuatfA& mult( QuatfA& result, const QuatfA& q1, const QuatfA& q2 )
+{
+   const __m128 a = _mm_load_ps( q1.getData() );
+   const __m128 b = _mm_load_ps( q2.getData() );
+
+   // x = w1*x2 + x1*w2 + y1*z2 - z1*y2   (and y, z alike)
+   // w = w1*w2 - x1*x2 - y1*y2 - z1*z2
+   // the second and third terms of w are negated through the sign bit
+   const __m128 w_sign = _mm_castsi128_ps( _mm_set_epi32( (int)0x80000000, 0, 0, 0 ) );
+   const __m128 p1 = _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(3, 3, 3, 3) ), b );
+   const __m128 p2 = _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(0, 2, 1, 0) ),
+                                 _mm_shuffle_ps( b, b, _MM_SHUFFLE(0, 3, 3, 3) ) );
+   const __m128 p3 = _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(1, 0, 2, 1) ),
+                                 _mm_shuffle_ps( b, b, _MM_SHUFFLE(1, 1, 0, 2) ) );
+   const __m128 p4 = _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(2, 1, 0, 2) ),
+                                 _mm_shuffle_ps( b, b, _MM_SHUFFLE(2, 0, 2, 1) ) );
+   __m128 r = _mm_add_ps( p1, _mm_xor_ps( p2, w_sign ) );
+   r = _mm_add_ps( r, _mm_xor_ps( p3, w_sign ) );
+   r = _mm_sub_ps( r, p4 );
+   _mm_store_ps( result.mData.getData(), r );
+   return result;
+}
+
+inline QuatfA operator*( const QuatfA& q1, const QuatfA& q2 )
+{
+   QuatfA temporary( NO_INIT );
+   return mult( temporary, q1, q2 );
+}
+
+inline QuatfA& operator*=( QuatfA& result, const QuatfA& q2 )
+{
+   return mult( result, result, q2 );
+}
+
+/** @see dot(const Quat<DATA_TYPE>&, const Quat<DATA_TYPE>&) */
+inline float dot( const QuatfA& q1, const QuatfA& q2 )
+{
+   const __m128 m = _mm_mul_ps( _mm_load_ps( q1.getData() ), _mm_load_ps( q2.getData() ) );
+   return _mm_cvtss_f32( simd::sum4( m ) );
+}
+
+inline float lengthSquared( const QuatfA& q )
+{
+   return dot( q, q );
+}
+
+inline float length( const QuatfA& q )
+{
+   return Math::sqrt( lengthSquared( q ) );
+}
+
+/** @see normalize(Quat<DATA_TYPE>&) */
+inline QuatfA& normalize( QuatfA& result )
+{
+   const float l = length( result );
+
+   // return if no magnitude (already as normalized as possible)
+   if (l < 0.0001f)
+   {
+      return result;
+   }
+
+   const float l_inv = 1.0f / l;
+   _mm_store_ps( result.mData.getData(), _mm_mul_ps( _mm_load_ps( result.getData() ), _mm_set1_ps( l_inv ) ) );
+   return result;
+}
+
+/** @see conj(Quat<DATA_TYPE>&) */
+inline QuatfA& conj( QuatfA& result )
+{
+   const __m128 xyz_sign = _mm_castsi128_ps( _mm_set_epi32( 0, (int)0x80000000, (int)0x80000000, (int)0x80000000 ) );
+   _mm_store_ps( result.mData.getData(), _mm_xor_ps( _mm_load_ps( result.getData() ), xyz_sign ) );
+   return result;
+}
+
+/** @} */
+
+/** @ingroup Transforms
+ * @name Aligned Vector Transform (Quaternion)
+ * @{
+ */
+
+/** transform a vector by a rotation quaternion.
+ *  Uses v' = v + w*t + cross(q.xyz, t) with t = 2*cross(q.xyz, v), which
+ *  needs two cross products instead of two quaternion products.  The
+ *  result equals the template xform() up to rounding.
+ *  @pre rot is normalized
+ *  @see xform(VecBase<DATA_TYPE, 3>&, const Quat<DATA_TYPE>&, const VecBase<DATA_TYPE, 3>&)
+ */
+inline Vec3fA& xform( Vec3fA& result, const QuatfA& rot, const Vec3fA& vector )
+{
+   gmtlASSERT( Math::isEqual( length( rot ), 1.0f, 0.0001f ) && "must pass a rotation quaternion to xform(result,quat,vec) - by definition, a rotation quaternion is normalized)." );
+
+   const __m128 xyz_mask = _mm_castsi128_ps( _mm_set_epi32( 0, -1, -1, -1 ) );
+   const __m128 q = _mm_load_ps( rot.getData() );
+   const __m128 qv = _mm_and_ps( q, xyz_mask );
+   const __m128 v = _mm_and_ps( _mm_load_ps( vector.mData ), xyz_mask );
+   const __m128 w = _mm_shuffle_ps( q, q, _MM_SHUFFLE(3, 3, 3, 3) );
+
+   const __m128 c = simd::cross3( qv, v );
+   const __m128 t = _mm_add_ps( c, c );
+   __m128 r = _mm_add_ps( v, _mm_mul_ps( w, t ) );
+   r = _mm_add_ps( r, simd::cross3( qv, t ) );
+   _mm_store_ps( result.mData, r );
+   return result;
+}
+
+inline Vec3fA operator*( const QuatfA& rot, const Vec3fA& vector )
+{
+   Vec3fA temporary( NO_INIT );
+   return xform( temporary, rot, vector );
+}
+
+/** @} */
+
+} // end namespace gmtl
+#endif
+
+#endif
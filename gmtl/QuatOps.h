@@ -6,8 +6,10 @@
 #ifndef _GMTL_QUAT_OPS_H_
 #define _GMTL_QUAT_OPS_H_
 
+#include <cstddef>
 #include <gmtl/Math.h>
 #include <gmtl/Quat.h>
+#include <gmtl/Util/Simd.h>
 
 namespace gmtl
 {
@@ -48,7 +50,7 @@ namespace gmtl
       */
 
       // Here is the same, only expanded... (grassman product)
-      Quat<DATA_TYPE> temporary; // avoid aliasing problems...
+      Quat<DATA_TYPE> temporary( NO_INIT ); // avoid aliasing problems...
       temporary[Xelt] = q1[Welt]*q2[Xelt] + q1[Xelt]*q2[Welt] + q1[Yelt]*q2[Zelt] - q1[Zelt]*q2[Yelt];
       temporary[Yelt] = q1[Welt]*q2[Yelt] + q1[Yelt]*q2[Welt] + q1[Zelt]*q2[Xelt] - q1[Xelt]*q2[Zelt];
       temporary[Zelt] = q1[Welt]*q2[Zelt] + q1[Zelt]*q2[Welt] + q1[Xelt]*q2[Yelt] - q1[Yelt]*q2[Xelt];
@@ -140,7 +142,7 @@ namespace gmtl
    template <typename DATA_TYPE>
    Quat<DATA_TYPE> operator*( const Quat<DATA_TYPE>& q, DATA_TYPE s )
    {
-      Quat<DATA_TYPE> temporary;
+      Quat<DATA_TYPE> temporary( NO_INIT );
       return mult( temporary, q, s );
    }
 
@@ -206,7 +208,7 @@ namespace gmtl
    template <typename DATA_TYPE>
    Quat<DATA_TYPE> operator/( const Quat<DATA_TYPE>& q, DATA_TYPE s )
    {
-      Quat<DATA_TYPE> temporary;
+      Quat<DATA_TYPE> temporary( NO_INIT );
       return div( temporary, q, s );
    }
 
@@ -240,7 +242,7 @@ namespace gmtl
    template <typename DATA_TYPE>
    Quat<DATA_TYPE> operator+( const Quat<DATA_TYPE>& q1, const Quat<DATA_TYPE>& q2 )
    {
-      Quat<DATA_TYPE> temporary;
+      Quat<DATA_TYPE> temporary( NO_INIT );
       return add( temporary, q1, q2 );
    }
 
@@ -274,7 +276,7 @@ namespace gmtl
    template <typename DATA_TYPE>
    Quat<DATA_TYPE> operator-( const Quat<DATA_TYPE>& q1, const Quat<DATA_TYPE>& q2 )
    {
-      Quat<DATA_TYPE> temporary;
+      Quat<DATA_TYPE> temporary( NO_INIT );
       return sub( temporary, q1, q2 );
    }
 
@@ -441,6 +443,9 @@ namespace gmtl
    }
 
    /** complex logarithm
+    *  For a unit quaternion (v*sin(a), cos(a)) the log is (v*a, 0), so
+    *  that exp() of the log gives back the quaternion.
+    *  @pre result is a unit quaternion
     *  @post sets self to the log of quat
     *  @see Quat
     */
@@ -453,39 +458,73 @@ namespace gmtl
                            result[Yelt] * result[Yelt] +
                            result[Zelt] * result[Zelt] );
 
-      // avoid divide by 0
-      if (Math::isEqual(result[Welt], static_cast<DATA_TYPE>(0.0), static_cast<DATA_TYPE>(0.00001)) == false)
+      // avoid divide by 0, the log of the identity is 0
+      DATA_TYPE scale = static_cast<DATA_TYPE>(0.0);
+      if (length > static_cast<DATA_TYPE>(0.0))
       {
-         length = Math::aTan(length / result[Welt]);
-      }
-      else
-      {
-         length = Math::PI_OVER_2;
+         scale = Math::aTan2( length, result[Welt] ) / length;
       }
 
       result[Welt] = static_cast<DATA_TYPE>(0.0);
-      result[Xelt] = result[Xelt] * length;
-      result[Yelt] = result[Yelt] * length;
-      result[Zelt] = result[Zelt] * length;
+      result[Xelt] = result[Xelt] * scale;
+      result[Yelt] = result[Yelt] * scale;
+      result[Zelt] = result[Zelt] * scale;
       return result;
    }
-   
-   /** WARNING: not implemented (do not use) */
+
+   /** spherical quadrangle interpolation.
+    *  Interpolates between q1 and q2 along a smooth curve, using the inner
+    *  control points a (for q1) and b (for q2) computed by meanTangent():
+    *  squad = slerp( slerp(q1, q2, t), slerp(a, b, t), 2t(1-t) ).
+    *  Chaining squad() over a sequence of keys gives a rotation curve with
+    *  a continuous angular velocity (see QuatSplineTrack).
+    *  None of the slerps adjust signs, so q1 and q2 must be in the same
+    *  hemisphere (dot( q1, q2 ) >= 0), otherwise the curve takes the
+    *  long way around.
+    *  @pre all quaternions are unit quaternions
+    *  @post result can be any of the arguments
+    *  @see meanTangent(), slerp()
+    *  @see K. Shoemake, "Animating Rotation with Quaternion Curves",
+    *       SIGGRAPH 1985.
+    */
    template <typename DATA_TYPE>
-   void squad( Quat<DATA_TYPE>& result, DATA_TYPE t, const Quat<DATA_TYPE>& q1, const Quat<DATA_TYPE>& q2, const Quat<DATA_TYPE>& a, const Quat<DATA_TYPE>& b )
+   Quat<DATA_TYPE>& squad( Quat<DATA_TYPE>& result, DATA_TYPE t, const Quat<DATA_TYPE>& q1, const Quat<DATA_TYPE>& q2, const Quat<DATA_TYPE>& a, const Quat<DATA_TYPE>& b )
    {
-      gmtlASSERT( false );
+      Quat<DATA_TYPE> keys( NO_INIT ), controls( NO_INIT );
+      slerp( keys, t, q1, q2, false );
+      slerp( controls, t, a, b, false );
+      const DATA_TYPE h = static_cast<DATA_TYPE>(2.0) * t * (static_cast<DATA_TYPE>(1.0) - t);
+      return slerp( result, h, keys, controls, false );
    }
 
-   /** WARNING: not implemented (do not use) */
+   /** computes the squad() inner control point for q2, the middle of three
+    *  consecutive keys q1, q2 and q3:
+    *  q2 * exp( -(log(q2^-1 * q1) + log(q2^-1 * q3)) / 4 ).
+    *  @pre all quaternions are unit quaternions, and neighbors are in the
+    *       same hemisphere
+    *  @post result can be any of the arguments
+    *  @see squad()
+    */
    template <typename DATA_TYPE>
-   void meanTangent( Quat<DATA_TYPE>& result, const Quat<DATA_TYPE>& q1, const Quat<DATA_TYPE>& q2, const Quat<DATA_TYPE>& q3 )
+   Quat<DATA_TYPE>& meanTangent( Quat<DATA_TYPE>& result, const Quat<DATA_TYPE>& q1, const Quat<DATA_TYPE>& q2, const Quat<DATA_TYPE>& q3 )
    {
-       gmtlASSERT( false );
-   }
+      Quat<DATA_TYPE> q2_inv( q2 );
+      conj( q2_inv );
 
+      Quat<DATA_TYPE> log1( NO_INIT ), log3( NO_INIT );
+      mult( log1, q2_inv, q1 );
+      mult( log3, q2_inv, q3 );
+      log( log1 );
+      log( log3 );
+
+      Quat<DATA_TYPE> tangent( NO_INIT );
+      add( tangent, log1, log3 );
+      mult( tangent, tangent, static_cast<DATA_TYPE>(-0.25) );
+      exp( tangent );
+
+      return mult( result, q2, tangent );
+   }
 
-   
 /** @} */
    
 /** @ingroup Interp Quat 
@@ -517,7 +556,7 @@ namespace gmtl
       DATA_TYPE cosom = dot( from, to );
 
       // adjust signs (if necessary)
-      Quat<DATA_TYPE> q;
+      Quat<DATA_TYPE> q( NO_INIT );
       if (adjustSign && (cosom < static_cast<DATA_TYPE>(0.0)))
       {
          cosom = -cosom;
@@ -577,7 +616,7 @@ namespace gmtl
       DATA_TYPE cosom = dot( from, to );
 
       // adjust signs (if necessary)
-      Quat<DATA_TYPE> q;
+      Quat<DATA_TYPE> q( NO_INIT );
       if (cosom < static_cast<DATA_TYPE>(0.0))
       {
          q[0] = -to[0];   // Reverse all signs
@@ -602,6 +641,363 @@ namespace gmtl
       return result;
    }
 
+   /** normalized linear interpolation between two rotation quaternions.
+    *  lerp() followed by normalize().  The result is always on the arc
+    *  between from and to (along the shortest path), but unlike slerp() it
+    *  does not move along the arc at constant speed.  It has no trig calls
+    *  and no branches besides the sign adjustment, so it is the cheapest
+    *  way to blend rotations.
+    * @pre no aliasing problems to worry about ("result" can be "from" or "to" param).
+    * @see lerp(), slerp()
+    */
+   template <typename DATA_TYPE>
+   Quat<DATA_TYPE>& nlerp(Quat<DATA_TYPE>& result, const DATA_TYPE t,
+                          const Quat<DATA_TYPE>& from,
+                          const Quat<DATA_TYPE>& to)
+   {
+      lerp( result, t, from, to );
+      return normalize( result );
+   }
+
+   /** The coefficients of the fastSlerp() polynomial.
+    *  u(i) = 1/(n*(2n+1)) and v(i) = n/(2n+1) with n = i+1; the last pair is
+    *  scaled by 1.85298109240830 to make up for the terms left out.
+    */
+   template <typename DATA_TYPE>
+   struct FastSlerpCoefficients
+   {
+      enum { NumTerms = 8 };
+
+      static const DATA_TYPE* u()
+      {
+         static const DATA_TYPE values[NumTerms] =
+         {
+            DATA_TYPE(1.0 / 3.0), DATA_TYPE(1.0 / 10.0), DATA_TYPE(1.0 / 21.0), DATA_TYPE(1.0 / 36.0),
+            DATA_TYPE(1.0 / 55.0), DATA_TYPE(1.0 / 78.0), DATA_TYPE(1.0 / 105.0),
+            DATA_TYPE(1.85298109240830 / 136.0)
+         };
+         return values;
+      }
+
+      static const DATA_TYPE* v()
+      {
+         static const DATA_TYPE values[NumTerms] =
+         {
+            DATA_TYPE(1.0 / 3.0), DATA_TYPE(2.0 / 5.0), DATA_TYPE(3.0 / 7.0), DATA_TYPE(4.0 / 9.0),
+            DATA_TYPE(5.0 / 11.0), DATA_TYPE(6.0 / 13.0), DATA_TYPE(7.0 / 15.0),
+            DATA_TYPE(1.85298109240830 * 8.0 / 17.0)
+         };
+         return values;
+      }
+   };
+
+   /** approximate spherical linear interpolation between two rotation quaternions.
+    *  Computes the slerp() weights sin((1-t)a)/sin(a) and sin(ta)/sin(a)
+    *  with a polynomial in cos(a) instead of acos() and sin(), using the
+    *  series sin(ta)/sin(a) = t * (1 + b1*(1 + b2*(1 + ...))), with
+    *  bn = (t^2 - n^2) / (n*(2n+1)) * (cos(a) - 1), cut off after 8 terms.
+    *  For unit quaternions the components of the result are within 2.5e-5
+    *  of the exact slerp (the error is largest when from and to are more
+    *  than 150 degrees of rotation apart), and there is no special case
+    *  for small angles.  Always takes the shortest path, like slerp() with
+    *  adjustSign.
+    * @pre no aliasing problems to worry about ("result" can be "from" or "to" param).
+    * @see slerp()
+    * @see D. Eberly, "A Fast and Accurate Algorithm for Computing SLERP",
+    *      Journal of Graphics, GPU, and Game Tools, 2011.
+    */
+   template <typename DATA_TYPE>
+   Quat<DATA_TYPE>& fastSlerp(Quat<DATA_TYPE>& result, const DATA_TYPE t,
+                              const Quat<DATA_TYPE>& from,
+                              const Quat<DATA_TYPE>& to)
+   {
+      const DATA_TYPE* u = FastSlerpCoefficients<DATA_TYPE>::u();
+      const DATA_TYPE* v = FastSlerpCoefficients<DATA_TYPE>::v();
+
+      // cos(a), adjusted for the shortest path
+      DATA_TYPE cosom = dot( from, to );
+      const bool negate = cosom < static_cast<DATA_TYPE>(0.0);
+      if (negate)
+      {
+         cosom = -cosom;
+      }
+
+      const DATA_TYPE xm1 = cosom - static_cast<DATA_TYPE>(1.0);
+      const DATA_TYPE d = static_cast<DATA_TYPE>(1.0) - t;
+      const DATA_TYPE sqr_t = t * t;
+      const DATA_TYPE sqr_d = d * d;
+      DATA_TYPE f_t = static_cast<DATA_TYPE>(1.0), f_d = static_cast<DATA_TYPE>(1.0);
+      for (int i = FastSlerpCoefficients<DATA_TYPE>::NumTerms - 1; i >= 0; --i)
+      {
+         f_t = static_cast<DATA_TYPE>(1.0) + ((u[i] * sqr_t - v[i]) * xm1) * f_t;
+         f_d = static_cast<DATA_TYPE>(1.0) + ((u[i] * sqr_d - v[i]) * xm1) * f_d;
+      }
+
+      const DATA_TYPE sclp = d * f_d;
+      const DATA_TYPE sclq = negate ? -(t * f_t) : t * f_t;
+
+      // from may be result
+      const DATA_TYPE x = sclp * from[Xelt] + sclq * to[Xelt];
+      const DATA_TYPE y = sclp * from[Yelt] + sclq * to[Yelt];
+      const DATA_TYPE z = sclp * from[Zelt] + sclq * to[Zelt];
+      const DATA_TYPE w = sclp * from[Welt] + sclq * to[Welt];
+      result.set( x, y, z, w );
+      return result;
+   }
+
+/** @} */
+
+/** @ingroup Interp Quat
+ * @name Batch Quaternion Interpolation
+ * Blend arrays of quaternions, for example two animation poses: result[i]
+ * is the interpolation of from[i] and to[i], with either one t for all of
+ * them or t[i].  Each element gets the result of the single quaternion
+ * version, up to rounding where the compiler contracts either one into
+ * FMAs.  With SSE, nlerp() and fastSlerp() on float quaternions blend
+ * four quaternions at a time; slerp() always uses the scalar code.
+ * result may be from or to; otherwise the arrays must not overlap.
+ * @{
+ */
+
+   /** spherical linear interpolation of count quaternion pairs with one t.
+    *  @see slerp(Quat<DATA_TYPE>&, const DATA_TYPE, const Quat<DATA_TYPE>&, const Quat<DATA_TYPE>&, const bool)
+    */
+   template <typename DATA_TYPE>
+   void slerp(Quat<DATA_TYPE>* result, const DATA_TYPE t,
+              const Quat<DATA_TYPE>* from, const Quat<DATA_TYPE>* to,
+              const std::size_t count)
+   {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         slerp( result[i], t, from[i], to[i] );
+      }
+   }
+
+   /** spherical linear interpolation of count quaternion pairs, pair i with t[i].
+    *  @see slerp(Quat<DATA_TYPE>&, const DATA_TYPE, const Quat<DATA_TYPE>&, const Quat<DATA_TYPE>&, const bool)
+    */
+   template <typename DATA_TYPE>
+   void slerp(Quat<DATA_TYPE>* result, const DATA_TYPE* t,
+              const Quat<DATA_TYPE>* from, const Quat<DATA_TYPE>* to,
+              const std::size_t count)
+   {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         slerp( result[i], t[i], from[i], to[i] );
+      }
+   }
+
+   /** normalized linear interpolation of count quaternion pairs with one t.
+    *  @see nlerp(Quat<DATA_TYPE>&, const DATA_TYPE, const Quat<DATA_TYPE>&, const Quat<DATA_TYPE>&)
+    */
+   template <typename DATA_TYPE>
+   void nlerp(Quat<DATA_TYPE>* result, const DATA_TYPE t,
+              const Quat<DATA_TYPE>* from, const Quat<DATA_TYPE>* to,
+              const std::size_t count)
+   {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         nlerp( result[i], t, from[i], to[i] );
+      }
+   }
+
+   /** normalized linear interpolation of count quaternion pairs, pair i with t[i].
+    *  @see nlerp(Quat<DATA_TYPE>&, const DATA_TYPE, const Quat<DATA_TYPE>&, const Quat<DATA_TYPE>&)
+    */
+   template <typename DATA_TYPE>
+   void nlerp(Quat<DATA_TYPE>* result, const DATA_TYPE* t,
+              const Quat<DATA_TYPE>* from, const Quat<DATA_TYPE>* to,
+              const std::size_t count)
+   {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         nlerp( result[i], t[i], from[i], to[i] );
+      }
+   }
+
+   /** approximate spherical linear interpolation of count quaternion pairs with one t.
+    *  @see fastSlerp(Quat<DATA_TYPE>&, const DATA_TYPE, const Quat<DATA_TYPE>&, const Quat<DATA_TYPE>&)
+    */
+   template <typename DATA_TYPE>
+   void fastSlerp(Quat<DATA_TYPE>* result, const DATA_TYPE t,
+                  const Quat<DATA_TYPE>* from, const Quat<DATA_TYPE>* to,
+                  const std::size_t count)
+   {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         fastSlerp( result[i], t, from[i], to[i] );
+      }
+   }
+
+   /** approximate spherical linear interpolation of count quaternion pairs, pair i with t[i].
+    *  @see fastSlerp(Quat<DATA_TYPE>&, const DATA_TYPE, const Quat<DATA_TYPE>&, const Quat<DATA_TYPE>&)
+    */
+   template <typename DATA_TYPE>
+   void fastSlerp(Quat<DATA_TYPE>* result, const DATA_TYPE* t,
+                  const Quat<DATA_TYPE>* from, const Quat<DATA_TYPE>* to,
+                  const std::size_t count)
+   {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         fastSlerp( result[i], t[i], from[i], to[i] );
+      }
+   }
+
+#ifdef GMTL_HAVE_SSE2
+   namespace simd
+   {
+      /** Loads four Quat<float> as x, y, z and w lanes. */
+      inline void loadQuat4( __m128& x, __m128& y, __m128& z, __m128& w, const Quat<float>* q )
+      {
+         x = _mm_loadu_ps( q[0].getData() );
+         y = _mm_loadu_ps( q[1].getData() );
+         z = _mm_loadu_ps( q[2].getData() );
+         w = _mm_loadu_ps( q[3].getData() );
+         _MM_TRANSPOSE4_PS( x, y, z, w );
+      }
+
+      /** Stores the x, y, z and w lanes as four Quat<float>. */
+      inline void storeQuat4( Quat<float>* q, __m128 x, __m128 y, __m128 z, __m128 w )
+      {
+         _MM_TRANSPOSE4_PS( x, y, z, w );
+         _mm_storeu_ps( &q[0][Xelt], x );
+         _mm_storeu_ps( &q[1][Xelt], y );
+         _mm_storeu_ps( &q[2][Xelt], z );
+         _mm_storeu_ps( &q[3][Xelt], w );
+      }
+
+      /** nlerp() of four quaternion pairs, with the operations in the same
+       *  order as the template.
+       */
+      inline void nlerp4( Quat<float>* result, const __m128 t,
+                          const Quat<float>* from, const Quat<float>* to )
+      {
+         __m128 px, py, pz, pw, qx, qy, qz, qw;
+         loadQuat4( px, py, pz, pw, from );
+         loadQuat4( qx, qy, qz, qw, to );
+
+         // adjust signs for the shortest path
+         const __m128 cosom = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( px, qx ), _mm_mul_ps( py, qy ) ),
+                                                      _mm_mul_ps( pz, qz ) ), _mm_mul_ps( pw, qw ) );
+         const __m128 flip = _mm_and_ps( _mm_cmplt_ps( cosom, _mm_setzero_ps() ), _mm_set1_ps( -0.0f ) );
+         qx = _mm_xor_ps( qx, flip );
+         qy = _mm_xor_ps( qy, flip );
+         qz = _mm_xor_ps( qz, flip );
+         qw = _mm_xor_ps( qw, flip );
+
+         const __m128 sclp = _mm_sub_ps( _mm_set1_ps( 1.0f ), t );
+         __m128 x = _mm_add_ps( _mm_mul_ps( sclp, px ), _mm_mul_ps( t, qx ) );
+         __m128 y = _mm_add_ps( _mm_mul_ps( sclp, py ), _mm_mul_ps( t, qy ) );
+         __m128 z = _mm_add_ps( _mm_mul_ps( sclp, pz ), _mm_mul_ps( t, qz ) );
+         __m128 w = _mm_add_ps( _mm_mul_ps( sclp, pw ), _mm_mul_ps( t, qw ) );
+
+         // normalize, unless the length is (almost) zero
+         const __m128 len = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ),
+                                                                 _mm_mul_ps( z, z ) ), _mm_mul_ps( w, w ) ) );
+         const __m128 keep = _mm_cmplt_ps( len, _mm_set1_ps( 0.0001f ) );
+         const __m128 l_inv = _mm_or_ps( _mm_andnot_ps( keep, _mm_div_ps( _mm_set1_ps( 1.0f ), len ) ),
+                                         _mm_and_ps( keep, _mm_set1_ps( 1.0f ) ) );
+         storeQuat4( result, _mm_mul_ps( x, l_inv ), _mm_mul_ps( y, l_inv ),
+                             _mm_mul_ps( z, l_inv ), _mm_mul_ps( w, l_inv ) );
+      }
+
+      /** fastSlerp() of four quaternion pairs, with the operations in the
+       *  same order as the template.
+       */
+      inline void fastSlerp4( Quat<float>* result, const __m128 t,
+                              const Quat<float>* from, const Quat<float>* to )
+      {
+         const float* u = FastSlerpCoefficients<float>::u();
+         const float* v = FastSlerpCoefficients<float>::v();
+
+         __m128 px, py, pz, pw, qx, qy, qz, qw;
+         loadQuat4( px, py, pz, pw, from );
+         loadQuat4( qx, qy, qz, qw, to );
+
+         __m128 cosom = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( px, qx ), _mm_mul_ps( py, qy ) ),
+                                                _mm_mul_ps( pz, qz ) ), _mm_mul_ps( pw, qw ) );
+         const __m128 flip = _mm_and_ps( _mm_cmplt_ps( cosom, _mm_setzero_ps() ), _mm_set1_ps( -0.0f ) );
+         cosom = _mm_xor_ps( cosom, flip );
+
+         const __m128 one = _mm_set1_ps( 1.0f );
+         const __m128 xm1 = _mm_sub_ps( cosom, one );
+         const __m128 d = _mm_sub_ps( one, t );
+         const __m128 sqr_t = _mm_mul_ps( t, t );
+         const __m128 sqr_d = _mm_mul_ps( d, d );
+         __m128 f_t = one, f_d = one;
+         for (int i = FastSlerpCoefficients<float>::NumTerms - 1; i >= 0; --i)
+         {
+            const __m128 ui = _mm_set1_ps( u[i] );
+            const __m128 vi = _mm_set1_ps( v[i] );
+            f_t = _mm_add_ps( one, _mm_mul_ps( _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( ui, sqr_t ), vi ), xm1 ), f_t ) );
+            f_d = _mm_add_ps( one, _mm_mul_ps( _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( ui, sqr_d ), vi ), xm1 ), f_d ) );
+         }
+
+         const __m128 sclp = _mm_mul_ps( d, f_d );
+         const __m128 sclq = _mm_xor_ps( _mm_mul_ps( t, f_t ), flip );
+         storeQuat4( result,
+                     _mm_add_ps( _mm_mul_ps( sclp, px ), _mm_mul_ps( sclq, qx ) ),
+                     _mm_add_ps( _mm_mul_ps( sclp, py ), _mm_mul_ps( sclq, qy ) ),
+                     _mm_add_ps( _mm_mul_ps( sclp, pz ), _mm_mul_ps( sclq, qz ) ),
+                     _mm_add_ps( _mm_mul_ps( sclp, pw ), _mm_mul_ps( sclq, qw ) ) );
+      }
+   }
+
+   /** SSE version of the batch nlerp() for float quaternions and one t. */
+   inline void nlerp(Quat<float>* result, const float t,
+                     const Quat<float>* from, const Quat<float>* to,
+                     const std::size_t count)
+   {
+      const std::size_t blocks = count & ~std::size_t(3);
+      const __m128 t4 = _mm_set1_ps( t );
+      for (std::size_t i = 0; i < blocks; i += 4)
+      {
+         simd::nlerp4( result + i, t4, from + i, to + i );
+      }
+      nlerp<float>( result + blocks, t, from + blocks, to + blocks, count - blocks );
+   }
+
+   /** SSE version of the batch nlerp() for float quaternions and t per pair. */
+   inline void nlerp(Quat<float>* result, const float* t,
+                     const Quat<float>* from, const Quat<float>* to,
+                     const std::size_t count)
+   {
+      const std::size_t blocks = count & ~std::size_t(3);
+      for (std::size_t i = 0; i < blocks; i += 4)
+      {
+         simd::nlerp4( result + i, _mm_loadu_ps( t + i ), from + i, to + i );
+      }
+      nlerp<float>( result + blocks, t + blocks, from + blocks, to + blocks, count - blocks );
+   }
+
+   /** SSE version of the batch fastSlerp() for float quaternions and one t. */
+   inline void fastSlerp(Quat<float>* result, const float t,
+                         const Quat<float>* from, const Quat<float>* to,
+                         const std::size_t count)
+   {
+      const std::size_t blocks = count & ~std::size_t(3);
+      const __m128 t4 = _mm_set1_ps( t );
+      for (std::size_t i = 0; i < blocks; i += 4)
+      {
+         simd::fastSlerp4( result + i, t4, from + i, to + i );
+      }
+      fastSlerp<float>( result + blocks, t, from + blocks, to + blocks, count - blocks );
+   }
+
+   /** SSE version of the batch fastSlerp() for float quaternions and t per pair. */
+   inline void fastSlerp(Quat<float>* result, const float* t,
+                         const Quat<float>* from, const Quat<float>* to,
+                         const std::size_t count)
+   {
+      const std::size_t blocks = count & ~std::size_t(3);
+      for (std::size_t i = 0; i < blocks; i += 4)
+      {
+         simd::fastSlerp4( result + i, _mm_loadu_ps( t + i ), from + i, to + i );
+      }
+      fastSlerp<float>( result + blocks, t + blocks, from + blocks, to + blocks, count - blocks );
+   }
+#endif
+
 /** @} */
 
 /** @ingroup Compare Quat 
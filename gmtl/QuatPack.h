@@ -0,0 +1,539 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_QUAT_PACK_H_
+#define _GMTL_QUAT_PACK_H_
+
+#include <cstddef>
+#include <gmtl/Defines.h>
+#include <gmtl/Math.h>
+#include <gmtl/Quat.h>
+#include <gmtl/QuatOps.h>
+#include <gmtl/Util/Simd.h>
+#include <gmtl/Util/StaticAssert.h>
+
+namespace gmtl
+{
+
+/** @ingroup Types
+ * @name Packed Quaternions
+ * Compact storage for rotation quaternions, for streams and buffers that
+ * are limited by memory bandwidth.  A Quat<float> is 16 bytes.
+ *
+ * PackedQuat32 and PackedQuat48 use the "smallest three" encoding: of a
+ * unit quaternion only the three components other than the largest one
+ * are stored, with the index of the largest one.  Those three are within
+ * [-1/sqrt(2), 1/sqrt(2)] and the largest is rebuilt as
+ * sqrt(1 - a^2 - b^2 - c^2).  q and -q are the same rotation, so the
+ * quaternion is negated as needed to make the largest component positive.
+ * Unpacked quaternions are unit length (up to rounding).
+ *
+ * PackedQuat64 stores each component as a 16 bit signed fixed point
+ * number.  It also works for quaternions that are not rotations (as long
+ * as the components are within [-1, 1]), but the unpacked quaternion is
+ * only unit length to about 3e-5.
+ *
+ * The maximum angle between a unit quaternion and its unpacked rotation:
+ * - PackedQuat32 (2 bit index, three 10 bit components): 0.28 degrees
+ * - PackedQuat48 (2 bit index, three 15 bit components): 0.0086 degrees
+ * - PackedQuat64 (four 16 bit components): 0.0035 degrees
+ * The worst case of the smallest three encoding is when all four
+ * components are +-0.5: the error of the rebuilt component is then the
+ * sum of the errors of the other three.
+ *
+ * Use pack() and unpack() to convert, one quaternion at a time or in
+ * batches.  With SSE2, the float batch versions convert four quaternions
+ * at a time, with the same arithmetic as the single quaternion versions.
+ * Results only differ where the compiler contracts the single versions
+ * into FMAs: an unpacked component in its last bits, or very rarely a
+ * packed component by one step.
+ * @{
+ */
+
+/** A rotation packed into 32 bits: bits 30-31 are the index of the largest
+ *  component, bits 20-29, 10-19 and 0-9 are the other three components in
+ *  order.
+ */
+class PackedQuat32
+{
+public:
+   PackedQuat32()
+      : mData( 0 )
+   {
+   }
+
+   unsigned int mData;
+};
+
+/** A rotation packed into 48 bits: bits 0-14 of each element are the three
+ *  components other than the largest one, in order; bit 15 of mData[0] and
+ *  mData[1] are bits 0 and 1 of the index of the largest component.
+ */
+class PackedQuat48
+{
+public:
+   PackedQuat48()
+   {
+      mData[0] = mData[1] = mData[2] = 0;
+   }
+
+   unsigned short mData[3];
+};
+
+/** A quaternion packed into 64 bits: x, y, z and w multiplied by 32767. */
+class PackedQuat64
+{
+public:
+   PackedQuat64()
+   {
+      mData[0] = mData[1] = mData[2] = mData[3] = 0;
+   }
+
+   short mData[4];
+};
+
+/** @} */
+
+/** The fixed point conversions of the packed quaternions.
+ *  Smallest three components use BITS bits, encode( v ) maps
+ *  [-1/sqrt(2), 1/sqrt(2)] to [0, 2^BITS - 1].  The 16 bit signed
+ *  components of PackedQuat64 and of packed normals use encodeSigned().
+ *  Both round to the nearest value, by adding 0.5 and truncating a
+ *  positive number (so that the SSE code can do exactly the same).
+ */
+template <typename DATA_TYPE, unsigned BITS>
+struct PackQuantizer
+{
+   static DATA_TYPE maxValue()
+   {
+      return static_cast<DATA_TYPE>( (1u << BITS) - 1 );
+   }
+
+   static DATA_TYPE scale()
+   {
+      return static_cast<DATA_TYPE>( ((1u << BITS) - 1) * 0.70710678118654752 );
+   }
+
+   static DATA_TYPE bias()
+   {
+      return static_cast<DATA_TYPE>( ((1u << BITS) - 1) * 0.5 + 0.5 );
+   }
+
+   static DATA_TYPE step()
+   {
+      return static_cast<DATA_TYPE>( 1.4142135623730950 / ((1u << BITS) - 1) );
+   }
+
+   static DATA_TYPE offset()
+   {
+      return static_cast<DATA_TYPE>( -0.70710678118654752 );
+   }
+
+   static unsigned int encode( const DATA_TYPE v )
+   {
+      const DATA_TYPE u = Math::Min( Math::Max( v * scale() + bias(), static_cast<DATA_TYPE>(0.0) ), maxValue() );
+      return static_cast<unsigned int>( u );
+   }
+
+   static DATA_TYPE decode( const unsigned int value )
+   {
+      return static_cast<DATA_TYPE>( value ) * step() + offset();
+   }
+
+   static short encodeSigned( const DATA_TYPE v )
+   {
+      const DATA_TYPE c = Math::Min( Math::Max( v, static_cast<DATA_TYPE>(-1.0) ), static_cast<DATA_TYPE>(1.0) );
+      const int u = static_cast<int>( c * static_cast<DATA_TYPE>(32767.0) + static_cast<DATA_TYPE>(32768.5) );
+      return static_cast<short>( u - 32768 );
+   }
+
+   static DATA_TYPE decodeSigned( const short value )
+   {
+      return static_cast<DATA_TYPE>( value ) * static_cast<DATA_TYPE>( 1.0 / 32767.0 );
+   }
+};
+
+/** Finds the largest component of q and quantizes the other three with
+ *  BITS bits each, negated if the largest component is negative.
+ */
+template <unsigned BITS, typename DATA_TYPE>
+inline void packSmallestThree( unsigned int& largest, unsigned int& a, unsigned int& b, unsigned int& c,
+                               const Quat<DATA_TYPE>& q )
+{
+   typedef PackQuantizer<DATA_TYPE, BITS> Quantizer;
+
+   largest = 0;
+   DATA_TYPE max_abs = Math::abs( q[0] );
+   for (unsigned int i = 1; i < 4; ++i)
+   {
+      if (Math::abs( q[i] ) > max_abs)
+      {
+         max_abs = Math::abs( q[i] );
+         largest = i;
+      }
+   }
+
+   DATA_TYPE others[3];
+   unsigned int n = 0;
+   for (unsigned int i = 0; i < 4; ++i)
+   {
+      if (i != largest)
+      {
+         others[n++] = (q[largest] < static_cast<DATA_TYPE>(0.0)) ? -q[i] : q[i];
+      }
+   }
+   a = Quantizer::encode( others[0] );
+   b = Quantizer::encode( others[1] );
+   c = Quantizer::encode( others[2] );
+}
+
+/** Rebuilds a quaternion from the output of packSmallestThree(). */
+template <unsigned BITS, typename DATA_TYPE>
+inline Quat<DATA_TYPE>& unpackSmallestThree( Quat<DATA_TYPE>& result, const unsigned int largest,
+                                             const unsigned int a, const unsigned int b, const unsigned int c )
+{
+   typedef PackQuantizer<DATA_TYPE, BITS> Quantizer;
+
+   const DATA_TYPE va = Quantizer::decode( a );
+   const DATA_TYPE vb = Quantizer::decode( b );
+   const DATA_TYPE vc = Quantizer::decode( c );
+   const DATA_TYPE vl = Math::sqrt( Math::Max( static_cast<DATA_TYPE>(1.0) - ((va * va + vb * vb) + vc * vc),
+                                               static_cast<DATA_TYPE>(0.0) ) );
+   switch (largest)
+   {
+   case 0:  result.set( vl, va, vb, vc ); break;
+   case 1:  result.set( va, vl, vb, vc ); break;
+   case 2:  result.set( va, vb, vl, vc ); break;
+   default: result.set( va, vb, vc, vl ); break;
+   }
+   return result;
+}
+
+/** @ingroup Types
+ * @name Packing Quaternions
+ * @{
+ */
+
+   /** packs a rotation quaternion into 32 bits.
+    *  @pre q is a unit quaternion
+    *  @return result
+    */
+   template <typename DATA_TYPE>
+   inline PackedQuat32& pack( PackedQuat32& result, const Quat<DATA_TYPE>& q )
+   {
+      GMTL_STATIC_ASSERT( sizeof(PackedQuat32) == 4, PackedQuat32_is_not_32_bits );
+      unsigned int largest, a, b, c;
+      packSmallestThree<10>( largest, a, b, c, q );
+      result.mData = (largest << 30) | (a << 20) | (b << 10) | c;
+      return result;
+   }
+
+   /** unpacks a rotation quaternion packed into 32 bits.
+    *  @return result
+    */
+   template <typename DATA_TYPE>
+   inline Quat<DATA_TYPE>& unpack( Quat<DATA_TYPE>& result, const PackedQuat32& packed )
+   {
+      const unsigned int mask = (1u << 10) - 1;
+      return unpackSmallestThree<10>( result, packed.mData >> 30, (packed.mData >> 20) & mask,
+                                      (packed.mData >> 10) & mask, packed.mData & mask );
+   }
+
+   /** packs a rotation quaternion into 48 bits.
+    *  @pre q is a unit quaternion
+    *  @return result
+    */
+   template <typename DATA_TYPE>
+   inline PackedQuat48& pack( PackedQuat48& result, const Quat<DATA_TYPE>& q )
+   {
+      GMTL_STATIC_ASSERT( sizeof(PackedQuat48) == 6, PackedQuat48_is_not_48_bits );
+      unsigned int largest, a, b, c;
+      packSmallestThree<15>( largest, a, b, c, q );
+      result.mData[0] = static_cast<unsigned short>( a | ((largest & 1) << 15) );
+      result.mData[1] = static_cast<unsigned short>( b | ((largest >> 1) << 15) );
+      result.mData[2] = static_cast<unsigned short>( c );
+      return result;
+   }
+
+   /** unpacks a rotation quaternion packed into 48 bits.
+    *  @return result
+    */
+   template <typename DATA_TYPE>
+   inline Quat<DATA_TYPE>& unpack( Quat<DATA_TYPE>& result, const PackedQuat48& packed )
+   {
+      const unsigned int mask = (1u << 15) - 1;
+      const unsigned int largest = (packed.mData[0] >> 15) | ((packed.mData[1] >> 15) << 1);
+      return unpackSmallestThree<15>( result, largest, packed.mData[0] & mask,
+                                      packed.mData[1] & mask, packed.mData[2] & mask );
+   }
+
+   /** packs a quaternion into 64 bits, 16 bits per component.
+    *  @pre the components of q are within [-1, 1]
+    *  @return result
+    */
+   template <typename DATA_TYPE>
+   inline PackedQuat64& pack( PackedQuat64& result, const Quat<DATA_TYPE>& q )
+   {
+      GMTL_STATIC_ASSERT( sizeof(PackedQuat64) == 8, PackedQuat64_is_not_64_bits );
+      for (int i = 0; i < 4; ++i)
+      {
+         result.mData[i] = PackQuantizer<DATA_TYPE, 16>::encodeSigned( q[i] );
+      }
+      return result;
+   }
+
+   /** unpacks a quaternion packed into 64 bits.
+    *  @return result
+    */
+   template <typename DATA_TYPE>
+   inline Quat<DATA_TYPE>& unpack( Quat<DATA_TYPE>& result, const PackedQuat64& packed )
+   {
+      result.set( PackQuantizer<DATA_TYPE, 16>::decodeSigned( packed.mData[0] ),
+                  PackQuantizer<DATA_TYPE, 16>::decodeSigned( packed.mData[1] ),
+                  PackQuantizer<DATA_TYPE, 16>::decodeSigned( packed.mData[2] ),
+                  PackQuantizer<DATA_TYPE, 16>::decodeSigned( packed.mData[3] ) );
+      return result;
+   }
+
+/** @} */
+
+/** @ingroup Types
+ * @name Batch Packing Quaternions
+ * pack() and unpack() for count quaternions.  PACKED_TYPE is PackedQuat32,
+ * PackedQuat48 or PackedQuat64.
+ * @{
+ */
+
+   /** packs count quaternions. */
+   template <typename PACKED_TYPE, typename DATA_TYPE>
+   inline void pack( PACKED_TYPE* result, const Quat<DATA_TYPE>* quats, const std::size_t count )
+   {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         pack( result[i], quats[i] );
+      }
+   }
+
+   /** unpacks count quaternions. */
+   template <typename DATA_TYPE, typename PACKED_TYPE>
+   inline void unpack( Quat<DATA_TYPE>* result, const PACKED_TYPE* packed, const std::size_t count )
+   {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         unpack( result[i], packed[i] );
+      }
+   }
+
+#ifdef GMTL_HAVE_SSE2
+   namespace simd
+   {
+      /** Rounds the lanes of v * scale + bias, clamped to [0, maxValue],
+       *  like PackQuantizer::encode().
+       */
+      inline __m128i quantize4( const __m128 v, const __m128 scale, const __m128 bias, const __m128 maxValue )
+      {
+         const __m128 u = _mm_min_ps( _mm_max_ps( _mm_add_ps( _mm_mul_ps( v, scale ), bias ), _mm_setzero_ps() ), maxValue );
+         return _mm_cvttps_epi32( u );
+      }
+
+      /** packSmallestThree() of the four quaternions (x, y, z, w) with BITS
+       *  bits per component.
+       */
+      template <unsigned BITS>
+      inline void packSmallestThree4( __m128i& largest, __m128i& a, __m128i& b, __m128i& c,
+                                      const __m128 x, const __m128 y, const __m128 z, const __m128 w )
+      {
+         const __m128 sign = _mm_set1_ps( -0.0f );
+         const __m128 ax = _mm_andnot_ps( sign, x );
+         const __m128 ay = _mm_andnot_ps( sign, y );
+         const __m128 az = _mm_andnot_ps( sign, z );
+         const __m128 aw = _mm_andnot_ps( sign, w );
+         const __m128 max_abs = _mm_max_ps( _mm_max_ps( ax, ay ), _mm_max_ps( az, aw ) );
+
+         // the first component that is the largest
+         const __m128 is0 = _mm_cmpeq_ps( ax, max_abs );
+         const __m128 is1 = _mm_andnot_ps( is0, _mm_cmpeq_ps( ay, max_abs ) );
+         const __m128 is01 = _mm_or_ps( is0, is1 );
+         const __m128 is2 = _mm_andnot_ps( is01, _mm_cmpeq_ps( az, max_abs ) );
+         const __m128 is3 = _mm_andnot_ps( _mm_or_ps( is01, is2 ), _mm_castsi128_ps( _mm_set1_epi32( -1 ) ) );
+         largest = _mm_or_si128( _mm_and_si128( _mm_castps_si128( is1 ), _mm_set1_epi32( 1 ) ),
+                   _mm_or_si128( _mm_and_si128( _mm_castps_si128( is2 ), _mm_set1_epi32( 2 ) ),
+                                 _mm_and_si128( _mm_castps_si128( is3 ), _mm_set1_epi32( 3 ) ) ) );
+
+         // the other three in order, with the sign of the largest
+         const __m128 l = select( is0, x, select( is1, y, select( is2, z, w ) ) );
+         const __m128 flip = _mm_and_ps( _mm_cmplt_ps( l, _mm_setzero_ps() ), sign );
+         const __m128 va = _mm_xor_ps( select( is0, y, x ), flip );
+         const __m128 vb = _mm_xor_ps( select( is01, z, y ), flip );
+         const __m128 vc = _mm_xor_ps( select( is3, z, w ), flip );
+
+         typedef PackQuantizer<float, BITS> Quantizer;
+         const __m128 scale = _mm_set1_ps( Quantizer::scale() );
+         const __m128 bias = _mm_set1_ps( Quantizer::bias() );
+         const __m128 max_value = _mm_set1_ps( Quantizer::maxValue() );
+         a = quantize4( va, scale, bias, max_value );
+         b = quantize4( vb, scale, bias, max_value );
+         c = quantize4( vc, scale, bias, max_value );
+      }
+
+      /** unpackSmallestThree() of four quaternions, as x, y, z and w lanes. */
+      template <unsigned BITS>
+      inline void unpackSmallestThree4( __m128& x, __m128& y, __m128& z, __m128& w,
+                                        const __m128i largest, const __m128i a, const __m128i b, const __m128i c )
+      {
+         typedef PackQuantizer<float, BITS> Quantizer;
+         const __m128 step = _mm_set1_ps( Quantizer::step() );
+         const __m128 offset = _mm_set1_ps( Quantizer::offset() );
+         const __m128 va = _mm_add_ps( _mm_mul_ps( _mm_cvtepi32_ps( a ), step ), offset );
+         const __m128 vb = _mm_add_ps( _mm_mul_ps( _mm_cvtepi32_ps( b ), step ), offset );
+         const __m128 vc = _mm_add_ps( _mm_mul_ps( _mm_cvtepi32_ps( c ), step ), offset );
+         const __m128 sum = _mm_add_ps( _mm_add_ps( _mm_mul_ps( va, va ), _mm_mul_ps( vb, vb ) ), _mm_mul_ps( vc, vc ) );
+         const __m128 vl = _mm_sqrt_ps( _mm_max_ps( _mm_sub_ps( _mm_set1_ps( 1.0f ), sum ), _mm_setzero_ps() ) );
+
+         const __m128 is0 = _mm_castsi128_ps( _mm_cmpeq_epi32( largest, _mm_setzero_si128() ) );
+         const __m128 is1 = _mm_castsi128_ps( _mm_cmpeq_epi32( largest, _mm_set1_epi32( 1 ) ) );
+         const __m128 is2 = _mm_castsi128_ps( _mm_cmpeq_epi32( largest, _mm_set1_epi32( 2 ) ) );
+         const __m128 is3 = _mm_castsi128_ps( _mm_cmpeq_epi32( largest, _mm_set1_epi32( 3 ) ) );
+         x = select( is0, vl, va );
+         y = select( is0, va, select( is1, vl, vb ) );
+         z = select( is2, vl, select( is3, vc, vb ) );
+         w = select( is3, vl, vc );
+      }
+   }
+
+   /** SSE2 version of the batch pack() for PackedQuat32. */
+   inline void pack( PackedQuat32* result, const Quat<float>* quats, const std::size_t count )
+   {
+      const std::size_t blocks = count & ~std::size_t(3);
+      for (std::size_t i = 0; i < blocks; i += 4)
+      {
+         __m128 x, y, z, w;
+         __m128i largest, a, b, c;
+         simd::loadQuat4( x, y, z, w, quats + i );
+         simd::packSmallestThree4<10>( largest, a, b, c, x, y, z, w );
+         const __m128i bits = _mm_or_si128( _mm_or_si128( _mm_slli_epi32( largest, 30 ), _mm_slli_epi32( a, 20 ) ),
+                                            _mm_or_si128( _mm_slli_epi32( b, 10 ), c ) );
+         _mm_storeu_si128( reinterpret_cast<__m128i*>( &result[i].mData ), bits );
+      }
+      pack<PackedQuat32, float>( result + blocks, quats + blocks, count - blocks );
+   }
+
+   /** SSE2 version of the batch unpack() for PackedQuat32. */
+   inline void unpack( Quat<float>* result, const PackedQuat32* packed, const std::size_t count )
+   {
+      const std::size_t blocks = count & ~std::size_t(3);
+      const __m128i mask = _mm_set1_epi32( (1 << 10) - 1 );
+      for (std::size_t i = 0; i < blocks; i += 4)
+      {
+         const __m128i bits = _mm_loadu_si128( reinterpret_cast<const __m128i*>( &packed[i].mData ) );
+         __m128 x, y, z, w;
+         simd::unpackSmallestThree4<10>( x, y, z, w, _mm_srli_epi32( bits, 30 ),
+                                         _mm_and_si128( _mm_srli_epi32( bits, 20 ), mask ),
+                                         _mm_and_si128( _mm_srli_epi32( bits, 10 ), mask ),
+                                         _mm_and_si128( bits, mask ) );
+         simd::storeQuat4( result + i, x, y, z, w );
+      }
+      unpack<float, PackedQuat32>( result + blocks, packed + blocks, count - blocks );
+   }
+
+   /** SSE2 version of the batch pack() for PackedQuat48.  The components
+    *  are computed four quaternions at a time and then interleaved.
+    */
+   inline void pack( PackedQuat48* result, const Quat<float>* quats, const std::size_t count )
+   {
+      const std::size_t blocks = count & ~std::size_t(3);
+      for (std::size_t i = 0; i < blocks; i += 4)
+      {
+         __m128 x, y, z, w;
+         __m128i largest, a, b, c;
+         simd::loadQuat4( x, y, z, w, quats + i );
+         simd::packSmallestThree4<15>( largest, a, b, c, x, y, z, w );
+         GMTL_ALIGN(16) int words[3][4];
+         _mm_store_si128( reinterpret_cast<__m128i*>( words[0] ),
+                          _mm_or_si128( a, _mm_slli_epi32( _mm_and_si128( largest, _mm_set1_epi32( 1 ) ), 15 ) ) );
+         _mm_store_si128( reinterpret_cast<__m128i*>( words[1] ),
+                          _mm_or_si128( b, _mm_slli_epi32( _mm_srli_epi32( largest, 1 ), 15 ) ) );
+         _mm_store_si128( reinterpret_cast<__m128i*>( words[2] ), c );
+         for (std::size_t j = 0; j < 4; ++j)
+         {
+            result[i + j].mData[0] = static_cast<unsigned short>( words[0][j] );
+            result[i + j].mData[1] = static_cast<unsigned short>( words[1][j] );
+            result[i + j].mData[2] = static_cast<unsigned short>( words[2][j] );
+         }
+      }
+      pack<PackedQuat48, float>( result + blocks, quats + blocks, count - blocks );
+   }
+
+   /** SSE2 version of the batch unpack() for PackedQuat48. */
+   inline void unpack( Quat<float>* result, const PackedQuat48* packed, const std::size_t count )
+   {
+      const std::size_t blocks = count & ~std::size_t(3);
+      const __m128i mask = _mm_set1_epi32( (1 << 15) - 1 );
+      for (std::size_t i = 0; i < blocks; i += 4)
+      {
+         const PackedQuat48* p = packed + i;
+         const __m128i w0 = _mm_set_epi32( p[3].mData[0], p[2].mData[0], p[1].mData[0], p[0].mData[0] );
+         const __m128i w1 = _mm_set_epi32( p[3].mData[1], p[2].mData[1], p[1].mData[1], p[0].mData[1] );
+         const __m128i w2 = _mm_set_epi32( p[3].mData[2], p[2].mData[2], p[1].mData[2], p[0].mData[2] );
+         const __m128i largest = _mm_or_si128( _mm_srli_epi32( w0, 15 ), _mm_slli_epi32( _mm_srli_epi32( w1, 15 ), 1 ) );
+         __m128 x, y, z, w;
+         simd::unpackSmallestThree4<15>( x, y, z, w, largest, _mm_and_si128( w0, mask ),
+                                         _mm_and_si128( w1, mask ), _mm_and_si128( w2, mask ) );
+         simd::storeQuat4( result + i, x, y, z, w );
+      }
+      unpack<float, PackedQuat48>( result + blocks, packed + blocks, count - blocks );
+   }
+
+   namespace simd
+   {
+      /** PackQuantizer::encodeSigned() of the four lanes of v. */
+      inline __m128i quantizeSigned4( const __m128 v )
+      {
+         const __m128 c = _mm_min_ps( _mm_max_ps( v, _mm_set1_ps( -1.0f ) ), _mm_set1_ps( 1.0f ) );
+         const __m128i u = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( c, _mm_set1_ps( 32767.0f ) ), _mm_set1_ps( 32768.5f ) ) );
+         return _mm_sub_epi32( u, _mm_set1_epi32( 32768 ) );
+      }
+   }
+
+   /** SSE2 version of the batch pack() for PackedQuat64, two quaternions
+    *  at a time.
+    */
+   inline void pack( PackedQuat64* result, const Quat<float>* quats, const std::size_t count )
+   {
+      const std::size_t blocks = count & ~std::size_t(1);
+      for (std::size_t i = 0; i < blocks; i += 2)
+      {
+         const __m128i q0 = simd::quantizeSigned4( _mm_loadu_ps( quats[i].getData() ) );
+         const __m128i q1 = simd::quantizeSigned4( _mm_loadu_ps( quats[i + 1].getData() ) );
+         _mm_storeu_si128( reinterpret_cast<__m128i*>( result[i].mData ), _mm_packs_epi32( q0, q1 ) );
+      }
+      pack<PackedQuat64, float>( result + blocks, quats + blocks, count - blocks );
+   }
+
+   /** SSE2 version of the batch unpack() for PackedQuat64, two quaternions
+    *  at a time.
+    */
+   inline void unpack( Quat<float>* result, const PackedQuat64* packed, const std::size_t count )
+   {
+      const std::size_t blocks = count & ~std::size_t(1);
+      const __m128 scale = _mm_set1_ps( PackQuantizer<float, 16>::decodeSigned( 1 ) );
+      for (std::size_t i = 0; i < blocks; i += 2)
+      {
+         const __m128i bits = _mm_loadu_si128( reinterpret_cast<const __m128i*>( packed[i].mData ) );
+         // sign extend to 32 bits
+         const __m128i q0 = _mm_srai_epi32( _mm_unpacklo_epi16( bits, bits ), 16 );
+         const __m128i q1 = _mm_srai_epi32( _mm_unpackhi_epi16( bits, bits ), 16 );
+         _mm_storeu_ps( &result[i][Xelt], _mm_mul_ps( _mm_cvtepi32_ps( q0 ), scale ) );
+         _mm_storeu_ps( &result[i + 1][Xelt], _mm_mul_ps( _mm_cvtepi32_ps( q1 ), scale ) );
+      }
+      unpack<float, PackedQuat64>( result + blocks, packed + blocks, count - blocks );
+   }
+#endif
+
+/** @} */
+
+} // end of namespace gmtl
+
+#endif
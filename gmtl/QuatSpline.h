@@ -0,0 +1,292 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_QUAT_SPLINE_H_
+#define _GMTL_QUAT_SPLINE_H_
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <gmtl/Quat.h>
+#include <gmtl/QuatOps.h>
+#include <gmtl/Util/Assert.h>
+
+namespace gmtl
+{
+
+/**
+ * A rotation keyframe track, interpolated with squad().
+ *
+ * The track keeps the keys together with their squad() inner control
+ * points, which are computed once by setKeys() instead of at every sample
+ * (each control point costs two quaternion logs and an exp).  Sampling
+ * then only needs to find the segment that contains the time and do the
+ * three slerps of squad().
+ *
+ * Finding the segment is a binary search, unless the sample is given a
+ * Cursor: the cursor remembers the segment of the last sample, so that
+ * playing the track forward (or sampling it several times per frame)
+ * finds the segment in constant time.  The cursor falls back to a binary
+ * search when the time jumps.  A cursor is not tied to a track, but it
+ * should only be used with one track at a time.
+ *
+ * The curve goes through all the keys, with a continuous angular velocity
+ * at the keys.  The time between keys does not change the shape of the
+ * curve, only the speed along it.  At the first and last key the control
+ * point is the key itself.  Outside of the key times the track holds the
+ * first or last key.
+ *
+ * <h3> "Example:" </h3>
+ * \code
+ *    QuatSplineTrack<float> track( times, keys, num_keys );
+ *    QuatSplineTrack<float>::Cursor cursor;
+ *    for (float time = 0.0f; time < track.getEndTime(); time += dt)
+ *    {
+ *       track.sample( rot, time, cursor );
+ *    }
+ * \endcode
+ *
+ * @param DATA_TYPE     the type of the quaternion components and times
+ *
+ * @see squad(), meanTangent()
+ * @ingroup Interp Quat
+ */
+template<typename DATA_TYPE>
+class QuatSplineTrack
+{
+public:
+   typedef DATA_TYPE DataType;
+   typedef Quat<DATA_TYPE> QuatType;
+
+   /** The segment of the last sample, see sample(). */
+   class Cursor
+   {
+   public:
+      Cursor()
+         : mKey( 0 )
+      {
+      }
+
+      /// The index of the key at the start of the segment.
+      std::size_t mKey;
+   };
+
+public:
+   /** Creates an empty track, which samples as the identity. */
+   QuatSplineTrack()
+   {
+   }
+
+   /** Creates a track with count keys, see setKeys(). */
+   QuatSplineTrack( const DATA_TYPE* times, const QuatType* keys, const std::size_t count )
+   {
+      setKeys( times, keys, count );
+   }
+
+   /** Replaces the keys of this track and computes their control points.
+    *  The signs of the keys are adjusted so that each key is in the same
+    *  hemisphere as the one before it; getKey() returns the adjusted keys.
+    *  @pre times are increasing, the keys are unit quaternions
+    */
+   void setKeys( const DATA_TYPE* times, const QuatType* keys, const std::size_t count )
+   {
+      mTimes.assign( times, times + count );
+      mKeys.assign( keys, keys + count );
+      for (std::size_t i = 1; i < count; ++i)
+      {
+         gmtlASSERT( mTimes[i - 1] < mTimes[i] && "key times must increase" );
+         if (dot( mKeys[i - 1], mKeys[i] ) < static_cast<DATA_TYPE>(0.0))
+         {
+            mKeys[i] = -mKeys[i];
+         }
+      }
+
+      mControls.resize( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         if (i == 0 || i + 1 == count)
+         {
+            mControls[i] = mKeys[i];
+         }
+         else
+         {
+            meanTangent( mControls[i], mKeys[i - 1], mKeys[i], mKeys[i + 1] );
+         }
+      }
+   }
+
+   /** Gets the number of keys. */
+   std::size_t getNumKeys() const
+   {
+      return mKeys.size();
+   }
+
+   bool empty() const
+   {
+      return mKeys.empty();
+   }
+
+   /** Gets the time of key i. */
+   DATA_TYPE getTime( const std::size_t i ) const
+   {
+      gmtlASSERT( i < mTimes.size() );
+      return mTimes[i];
+   }
+
+   /** Gets key i, with its sign adjusted by setKeys(). */
+   const QuatType& getKey( const std::size_t i ) const
+   {
+      gmtlASSERT( i < mKeys.size() );
+      return mKeys[i];
+   }
+
+   /** Gets the squad() inner control point of key i. */
+   const QuatType& getControl( const std::size_t i ) const
+   {
+      gmtlASSERT( i < mControls.size() );
+      return mControls[i];
+   }
+
+   /** Gets the time of the first key. */
+   DATA_TYPE getStartTime() const
+   {
+      return mTimes.empty() ? static_cast<DATA_TYPE>(0.0) : mTimes.front();
+   }
+
+   /** Gets the time of the last key. */
+   DATA_TYPE getEndTime() const
+   {
+      return mTimes.empty() ? static_cast<DATA_TYPE>(0.0) : mTimes.back();
+   }
+
+   /** Samples the track at the given time, finding the segment with a
+    *  binary search.
+    *  @return result
+    */
+   QuatType& sample( QuatType& result, const DATA_TYPE time ) const
+   {
+      return sampleSegment( result, time, findKey( time ) );
+   }
+
+   /** Samples the track at the given time, starting the search for the
+    *  segment at the cursor, and moves the cursor to that segment.
+    *  Constant time when time is in the cursor's segment or the next one.
+    *  @return result
+    */
+   QuatType& sample( QuatType& result, const DATA_TYPE time, Cursor& cursor ) const
+   {
+      cursor.mKey = findKey( time, cursor.mKey );
+      return sampleSegment( result, time, cursor.mKey );
+   }
+
+   /** Samples the track at count times, using and updating the cursor as
+    *  in sample(result, time, cursor).  Increasing times take constant
+    *  time per sample.
+    */
+   void sample( QuatType* result, const DATA_TYPE* times, const std::size_t count,
+                Cursor& cursor ) const
+   {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         cursor.mKey = findKey( times[i], cursor.mKey );
+         sampleSegment( result[i], times[i], cursor.mKey );
+      }
+   }
+
+private:
+   /** Gets the index of the last key at or before time, or 0 before the
+    *  first key.
+    */
+   std::size_t findKey( const DATA_TYPE time ) const
+   {
+      if (mTimes.size() < 2)
+      {
+         return 0;
+      }
+      const std::size_t key = std::upper_bound( mTimes.begin(), mTimes.end(), time ) - mTimes.begin();
+      return key == 0 ? 0 : key - 1;
+   }
+
+   /** findKey(), checking the segment at hint and the one after it first. */
+   std::size_t findKey( const DATA_TYPE time, const std::size_t hint ) const
+   {
+      if (mTimes.size() < 2)
+      {
+         return 0;
+      }
+      const std::size_t last = mTimes.size() - 1;
+      if (hint < last && mTimes[hint] <= time)
+      {
+         if (time < mTimes[hint + 1])
+         {
+            return hint;
+         }
+         if (hint + 1 == last || time < mTimes[hint + 2])
+         {
+            return hint + 1;
+         }
+      }
+      else if (hint == last && mTimes[last] <= time)
+      {
+         return last;
+      }
+      return findKey( time );
+   }
+
+   /** Samples the segment that starts at key, holding the first and last
+    *  key outside of the track.
+    */
+   QuatType& sampleSegment( QuatType& result, const DATA_TYPE time, const std::size_t key ) const
+   {
+      if (mKeys.empty())
+      {
+         result = QuatType();
+         return result;
+      }
+      if (key + 1 == mKeys.size() || time <= mTimes[key])
+      {
+         result = mKeys[key];
+         return result;
+      }
+
+      const DATA_TYPE t = (time - mTimes[key]) / (mTimes[key + 1] - mTimes[key]);
+      return squad( result, t, mKeys[key], mKeys[key + 1], mControls[key], mControls[key + 1] );
+   }
+
+public:
+   std::vector<DATA_TYPE> mTimes;
+   std::vector<QuatType> mKeys;
+   std::vector<QuatType> mControls;
+};
+
+/** @ingroup Interp Quat
+ * @name Batch Track Sampling
+ * @{
+ */
+
+/** Samples count tracks at the same time, for example all the joints of a
+ *  skeleton for one frame: result[i] is tracks[i] at time, and cursors[i]
+ *  is the cursor of tracks[i].
+ *  @see QuatSplineTrack::sample()
+ */
+template<typename DATA_TYPE>
+inline void sample( Quat<DATA_TYPE>* result, const QuatSplineTrack<DATA_TYPE>* tracks,
+                    typename QuatSplineTrack<DATA_TYPE>::Cursor* cursors,
+                    const std::size_t count, const DATA_TYPE time )
+{
+   for (std::size_t i = 0; i < count; ++i)
+   {
+      tracks[i].sample( result[i], time, cursors[i] );
+   }
+}
+
+/** @} */
+
+typedef QuatSplineTrack<float> QuatSplineTrackf;
+typedef QuatSplineTrack<double> QuatSplineTrackd;
+
+} // end of namespace gmtl
+
+#endif
@@ -0,0 +1,136 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_RAY_PACKET_H_
+#define _GMTL_RAY_PACKET_H_
+
+#include <cstddef>
+#include <gmtl/Ray.h>
+#include <gmtl/Util/Assert.h>
+#include <gmtl/Util/StaticAssert.h>
+
+namespace gmtl
+{
+
+/**
+ * A packet of SIZE rays, stored as structure of arrays so that the packet
+ * versions of the intersection tests (see RayPacketOps.h) can process
+ * several rays per SIMD instruction.
+ *
+ * The lanes of a packet are the rays in it.  The packet tests take a mask
+ * of the active lanes (bit i for lane i) and return the mask of the lanes
+ * that hit; inactive lanes are not tested and their results are not
+ * written.  Rays that start near each other and point in similar
+ * directions (camera rays of a pixel tile, shadow rays to one light) make
+ * good packets: they visit mostly the same BVH nodes.
+ *
+ * @param DATA_TYPE     the type of the coordinates
+ * @param SIZE          the number of rays, at most 32 (4, 8 or 16 for
+ *                      the SIMD code paths)
+ *
+ * @see RayPacketHit, RayPacketOps.h
+ * @ingroup Types
+ */
+template<class DATA_TYPE, unsigned SIZE>
+class RayPacket
+{
+public:
+   typedef DATA_TYPE DataType;
+   enum
+   {
+      Size = SIZE
+   };
+
+public:
+   /** Creates a packet of rays with zero origins and directions. */
+   RayPacket()
+   {
+      GMTL_STATIC_ASSERT( SIZE > 0 && SIZE <= 32, RayPacket_SIZE_must_be_1_to_32 );
+      for (unsigned int lane = 0; lane < SIZE; ++lane)
+      {
+         setRay( lane, Ray<DATA_TYPE>() );
+      }
+   }
+
+   /** Sets the ray of one lane. */
+   void setRay( const unsigned int lane, const Ray<DATA_TYPE>& ray )
+   {
+      gmtlASSERT( lane < SIZE );
+      for (unsigned int axis = 0; axis < 3; ++axis)
+      {
+         mOrigin[axis][lane] = ray.getOrigin()[axis];
+         mDir[axis][lane] = ray.getDir()[axis];
+      }
+   }
+
+   /** Gets the ray of one lane. */
+   Ray<DATA_TYPE> getRay( const unsigned int lane ) const
+   {
+      gmtlASSERT( lane < SIZE );
+      return Ray<DATA_TYPE>( Point<DATA_TYPE, 3>( mOrigin[0][lane], mOrigin[1][lane], mOrigin[2][lane] ),
+                             Vec<DATA_TYPE, 3>( mDir[0][lane], mDir[1][lane], mDir[2][lane] ) );
+   }
+
+   /** Loads up to SIZE rays into the lanes, the unused lanes get a copy of
+    *  the first ray.
+    *  @return the mask of the lanes that were loaded
+    */
+   unsigned int set( const Ray<DATA_TYPE>* rays, const std::size_t count )
+   {
+      const unsigned int n = (count < SIZE) ? static_cast<unsigned int>( count ) : SIZE;
+      for (unsigned int lane = 0; lane < SIZE; ++lane)
+      {
+         setRay( lane, rays[lane < n ? lane : 0] );
+      }
+      return getMask( n );
+   }
+
+   /** Gets the mask of the first count lanes. */
+   static unsigned int getMask( const unsigned int count = SIZE )
+   {
+      return (count >= 32) ? ~0u : ((1u << count) - 1u);
+   }
+
+public:
+   /// The ray origins, mOrigin[axis][lane].
+   DATA_TYPE mOrigin[3][SIZE];
+
+   /// The ray directions, mDir[axis][lane].
+   DATA_TYPE mDir[3][SIZE];
+};
+
+/**
+ * The closest hits of a packet of rays, see intersect(const BVH&, const
+ * RayPacket&, unsigned int, RayPacketHit&).
+ *
+ * @ingroup Types
+ */
+template<class DATA_TYPE, unsigned SIZE>
+class RayPacketHit
+{
+public:
+   /// The tangent space coordinates of the hit of each lane.
+   DATA_TYPE mU[SIZE], mV[SIZE];
+
+   /// The ray parameter of the hit of each lane.
+   DATA_TYPE mT[SIZE];
+
+   /// The index of the hit triangle of each lane.
+   unsigned int mTri[SIZE];
+};
+
+typedef RayPacket<float, 4> RayPacket4f;
+typedef RayPacket<float, 8> RayPacket8f;
+typedef RayPacket<float, 16> RayPacket16f;
+typedef RayPacket<double, 4> RayPacket4d;
+
+typedef RayPacketHit<float, 4> RayPacketHit4f;
+typedef RayPacketHit<float, 8> RayPacketHit8f;
+typedef RayPacketHit<float, 16> RayPacketHit16f;
+typedef RayPacketHit<double, 4> RayPacketHit4d;
+
+} // end of namespace gmtl
+
+#endif
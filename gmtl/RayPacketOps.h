@@ -0,0 +1,363 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_RAY_PACKET_OPS_H_
+#define _GMTL_RAY_PACKET_OPS_H_
+
+#include <limits>
+#include <gmtl/RayPacket.h>
+#include <gmtl/AABox.h>
+#include <gmtl/Tri.h>
+#include <gmtl/VecOps.h>
+#include <gmtl/Util/Simd.h>
+#include <gmtl/Util/TriKernel.h>
+
+namespace gmtl
+{
+namespace helpers
+{
+   /** The portable packet triangle test, one lane at a time. */
+   template<class DATA_TYPE, unsigned SIZE>
+   inline unsigned int intersectTriPacket( const Tri<DATA_TYPE>& tri, const RayPacket<DATA_TYPE, SIZE>& packet,
+                                           const unsigned int active, const bool doubleSided,
+                                           DATA_TYPE* u, DATA_TYPE* v, DATA_TYPE* t,
+                                           const unsigned int firstLane = 0 )
+   {
+      const Vec<DATA_TYPE, 3> edge1 = tri[1] - tri[0];
+      const Vec<DATA_TYPE, 3> edge2 = tri[2] - tri[0];
+      unsigned int hits = 0;
+      for (unsigned int lane = firstLane; lane < SIZE; ++lane)
+      {
+         if (!(active & (1u << lane)))
+         {
+            continue;
+         }
+         const Point<DATA_TYPE, 3> origin( packet.mOrigin[0][lane], packet.mOrigin[1][lane], packet.mOrigin[2][lane] );
+         const Vec<DATA_TYPE, 3> dir( packet.mDir[0][lane], packet.mDir[1][lane], packet.mDir[2][lane] );
+         DATA_TYPE lane_u, lane_v, lane_t;
+         if (intersectTriLane( edge1, edge2, tri[0], origin, dir, doubleSided, lane_u, lane_v, lane_t ))
+         {
+            u[lane] = lane_u;
+            v[lane] = lane_v;
+            t[lane] = lane_t;
+            hits |= 1u << lane;
+         }
+      }
+      return hits;
+   }
+
+   /**
+    * The portable packet slab test, one lane at a time.  tNear and tFar
+    * hold the interval each lane is clipped to on entry and the clipped
+    * interval on return; the far end of every slab is scaled by farScale.
+    */
+   template<class DATA_TYPE, unsigned SIZE>
+   inline unsigned int intersectSlabPacket( const AABox<DATA_TYPE>& box, const RayPacket<DATA_TYPE, SIZE>& packet,
+                                            const DATA_TYPE (&invDir)[3][SIZE], const unsigned int active,
+                                            const DATA_TYPE farScale, DATA_TYPE* tNear, DATA_TYPE* tFar,
+                                            const unsigned int firstLane = 0 )
+   {
+      unsigned int hits = 0;
+      for (unsigned int lane = firstLane; lane < SIZE; ++lane)
+      {
+         if (!(active & (1u << lane)))
+         {
+            continue;
+         }
+         DATA_TYPE t_near = tNear[lane];
+         DATA_TYPE t_far = tFar[lane];
+         for (unsigned int axis = 0; axis < 3; ++axis)
+         {
+            const DATA_TYPE t0 = (box.mMin[axis] - packet.mOrigin[axis][lane]) * invDir[axis][lane];
+            const DATA_TYPE t1 = (box.mMax[axis] - packet.mOrigin[axis][lane]) * invDir[axis][lane];
+            const DATA_TYPE slab_near = (t1 < t0) ? t1 : t0;
+            const DATA_TYPE slab_far = ((t1 < t0) ? t0 : t1) * farScale;
+            t_near = (slab_near > t_near) ? slab_near : t_near;
+            t_far = (slab_far < t_far) ? slab_far : t_far;
+         }
+         tNear[lane] = t_near;
+         tFar[lane] = t_far;
+         if (t_near <= t_far)
+         {
+            hits |= 1u << lane;
+         }
+      }
+      return hits;
+   }
+
+#ifdef GMTL_HAVE_SSE
+   /**
+    * The packet triangle test on the OPS::Width lanes starting at lane of a
+    * float packet, with the arithmetic of intersectTriLane().  Only the u, v
+    * and t of the active lanes that hit are changed.
+    *
+    * @param active  the active lanes of the block, bit 0 for the first lane
+    *
+    * @return the hit mask of the block, bit 0 for the first lane
+    */
+   template<class OPS, unsigned SIZE>
+   inline unsigned int intersectTriPacketBlock( const float* edge1, const float* edge2, const float* vert0,
+                                                const RayPacket<float, SIZE>& packet, const unsigned int lane,
+                                                const unsigned int active, const bool doubleSided,
+                                                float* u, float* v, float* t )
+   {
+      typedef typename OPS::Reg Reg;
+      const Reg e1x = OPS::set1( edge1[0] ), e1y = OPS::set1( edge1[1] ), e1z = OPS::set1( edge1[2] );
+      const Reg e2x = OPS::set1( edge2[0] ), e2y = OPS::set1( edge2[1] ), e2z = OPS::set1( edge2[2] );
+      const Reg dx = OPS::load( packet.mDir[0] + lane );
+      const Reg dy = OPS::load( packet.mDir[1] + lane );
+      const Reg dz = OPS::load( packet.mDir[2] + lane );
+      const Reg tx = OPS::sub( OPS::load( packet.mOrigin[0] + lane ), OPS::set1( vert0[0] ) );
+      const Reg ty = OPS::sub( OPS::load( packet.mOrigin[1] + lane ), OPS::set1( vert0[1] ) );
+      const Reg tz = OPS::sub( OPS::load( packet.mOrigin[2] + lane ), OPS::set1( vert0[2] ) );
+
+      Reg hit_u, hit_v, hit_t;
+      const Reg hit = intersectTriRegs<OPS>( dx, dy, dz, tx, ty, tz, e1x, e1y, e1z, e2x, e2y, e2z,
+                                             doubleSided, hit_u, hit_v, hit_t );
+      const unsigned int hits = OPS::movemask( hit ) & active;
+      if (hits)
+      {
+         float block_u[OPS::Width], block_v[OPS::Width], block_t[OPS::Width];
+         OPS::store( block_u, hit_u );
+         OPS::store( block_v, hit_v );
+         OPS::store( block_t, hit_t );
+         for (unsigned int i = 0; i < OPS::Width; ++i)
+         {
+            if (hits & (1u << i))
+            {
+               u[lane + i] = block_u[i];
+               v[lane + i] = block_v[i];
+               t[lane + i] = block_t[i];
+            }
+         }
+      }
+      return hits;
+   }
+
+   /**
+    * The packet slab test on the OPS::Width lanes starting at lane of a
+    * float packet, with the arithmetic of intersectSlabPacket().
+    *
+    * @return the hit mask of the block, bit 0 for the first lane
+    */
+   template<class OPS, unsigned SIZE>
+   inline unsigned int intersectSlabPacketBlock( const AABox<float>& box, const RayPacket<float, SIZE>& packet,
+                                                 const float (&invDir)[3][SIZE], const unsigned int lane,
+                                                 const float farScale, float* tNear, float* tFar )
+   {
+      typedef typename OPS::Reg Reg;
+      const Reg far_scale = OPS::set1( farScale );
+      Reg t_near = OPS::load( tNear + lane );
+      Reg t_far = OPS::load( tFar + lane );
+      for (unsigned int axis = 0; axis < 3; ++axis)
+      {
+         const Reg origin = OPS::load( packet.mOrigin[axis] + lane );
+         const Reg inv_dir = OPS::load( invDir[axis] + lane );
+         const Reg t0 = OPS::mul( OPS::sub( OPS::set1( box.mMin[axis] ), origin ), inv_dir );
+         const Reg t1 = OPS::mul( OPS::sub( OPS::set1( box.mMax[axis] ), origin ), inv_dir );
+         // (t1 < t0) ? t1 : t0 and (t1 < t0) ? t0 : t1
+         const Reg slab_near = OPS::minimum( t1, t0 );
+         const Reg slab_far = OPS::mul( OPS::maximum( t0, t1 ), far_scale );
+         t_near = OPS::maximum( slab_near, t_near );
+         t_far = OPS::minimum( slab_far, t_far );
+      }
+      OPS::store( tNear + lane, t_near );
+      OPS::store( tFar + lane, t_far );
+      return OPS::movemask( OPS::le( t_near, t_far ) );
+   }
+
+   /** The float packet triangle test: AVX blocks of 8 lanes, then SSE
+    *  blocks of 4 and the remaining lanes one at a time.
+    */
+   template<unsigned SIZE>
+   inline unsigned int intersectTriPacket( const Tri<float>& tri, const RayPacket<float, SIZE>& packet,
+                                           const unsigned int active, const bool doubleSided,
+                                           float* u, float* v, float* t )
+   {
+      const Vec<float, 3> edge1 = tri[1] - tri[0];
+      const Vec<float, 3> edge2 = tri[2] - tri[0];
+      unsigned int hits = 0;
+      unsigned int lane = 0;
+#ifdef GMTL_HAVE_AVX
+      for (; lane + 8 <= SIZE; lane += 8)
+      {
+         const unsigned int block_active = (active >> lane) & 0xffu;
+         if (block_active)
+         {
+            hits |= intersectTriPacketBlock<simd::Float8Ops>( edge1.getData(), edge2.getData(),
+                                                                 tri[0].getData(), packet, lane, block_active,
+                                                                 doubleSided, u, v, t ) << lane;
+         }
+      }
+#endif
+      for (; lane + 4 <= SIZE; lane += 4)
+      {
+         const unsigned int block_active = (active >> lane) & 0xfu;
+         if (block_active)
+         {
+            hits |= intersectTriPacketBlock<simd::Float4Ops>( edge1.getData(), edge2.getData(),
+                                                                 tri[0].getData(), packet, lane, block_active,
+                                                                 doubleSided, u, v, t ) << lane;
+         }
+      }
+      if (lane < SIZE)
+      {
+         hits |= intersectTriPacket<float, SIZE>( tri, packet, active, doubleSided, u, v, t, lane );
+      }
+      return hits;
+   }
+
+   /** The float packet slab test, blocked as the triangle test. */
+   template<unsigned SIZE>
+   inline unsigned int intersectSlabPacket( const AABox<float>& box, const RayPacket<float, SIZE>& packet,
+                                            const float (&invDir)[3][SIZE], const unsigned int active,
+                                            const float farScale, float* tNear, float* tFar )
+   {
+      unsigned int hits = 0;
+      unsigned int lane = 0;
+#ifdef GMTL_HAVE_AVX
+      for (; lane + 8 <= SIZE; lane += 8)
+      {
+         if ((active >> lane) & 0xffu)
+         {
+            hits |= (intersectSlabPacketBlock<simd::Float8Ops>( box, packet, invDir, lane, farScale,
+                                                                  tNear, tFar ) & (active >> lane)) << lane;
+         }
+      }
+#endif
+      for (; lane + 4 <= SIZE; lane += 4)
+      {
+         if ((active >> lane) & 0xfu)
+         {
+            hits |= (intersectSlabPacketBlock<simd::Float4Ops>( box, packet, invDir, lane, farScale,
+                                                                  tNear, tFar ) & (active >> lane)) << lane;
+         }
+      }
+      if (lane < SIZE)
+      {
+         hits |= intersectSlabPacket<float, SIZE>( box, packet, invDir, active, farScale, tNear, tFar, lane );
+      }
+      return hits;
+   }
+#endif
+
+   /** Sets invDir to the reciprocals of the packet directions. */
+   template<class DATA_TYPE, unsigned SIZE>
+   inline void invertPacketDirs( const RayPacket<DATA_TYPE, SIZE>& packet, DATA_TYPE (&invDir)[3][SIZE] )
+   {
+      const DATA_TYPE one = static_cast<DATA_TYPE>(1.0);
+      for (unsigned int axis = 0; axis < 3; ++axis)
+      {
+         for (unsigned int lane = 0; lane < SIZE; ++lane)
+         {
+            invDir[axis][lane] = one / packet.mDir[axis][lane];
+         }
+      }
+   }
+}
+
+/** @ingroup Ops
+ * @name Ray Packet Intersection
+ * Intersection tests of packets of rays (see RayPacket).  Each test takes
+ * the mask of the lanes to test, bit i for lane i, and returns the mask of
+ * the active lanes that hit; the results of the other lanes are not
+ * changed.  For float packets the lanes are tested 4 (SSE) or 8 (AVX) at
+ * a time, with the same operations as the single ray tests, so a lane
+ * gives the result the single ray test gives for its ray, up to rounding
+ * where the compiler contracts one of them into FMAs.
+ * @{
+ */
+
+   /**
+    * Tests a packet of rays against a triangle, as
+    * intersect(const Tri&, const Ray&, u, v, t) does for each active lane.
+    *
+    * @param tri     the triangle (ccw ordering)
+    * @param packet  the rays
+    * @param active  the lanes to test
+    * @param u,v     the tangent space coordinates of the hit of each lane
+    * @param t       the hit of each lane: origin + dir * t
+    *
+    * @return the mask of the active lanes that hit the triangle
+    */
+   template<class DATA_TYPE, unsigned SIZE>
+   inline unsigned int intersect( const Tri<DATA_TYPE>& tri, const RayPacket<DATA_TYPE, SIZE>& packet,
+                                  const unsigned int active,
+                                  DATA_TYPE (&u)[SIZE], DATA_TYPE (&v)[SIZE], DATA_TYPE (&t)[SIZE] )
+   {
+      return helpers::intersectTriPacket( tri, packet, active, false, u, v, t );
+   }
+
+   /**
+    * Tests a packet of rays against a triangle from both sides, as
+    * intersectDoubleSided(const Tri&, const Ray&, u, v, t) does for each
+    * active lane.
+    *
+    * @return the mask of the active lanes that hit the triangle
+    */
+   template<class DATA_TYPE, unsigned SIZE>
+   inline unsigned int intersectDoubleSided( const Tri<DATA_TYPE>& tri, const RayPacket<DATA_TYPE, SIZE>& packet,
+                                             const unsigned int active,
+                                             DATA_TYPE (&u)[SIZE], DATA_TYPE (&v)[SIZE], DATA_TYPE (&t)[SIZE] )
+   {
+      return helpers::intersectTriPacket( tri, packet, active, true, u, v, t );
+   }
+
+   /**
+    * Tests a packet of rays against an axis aligned box with the slab test.
+    * A lane hits when its ray enters the box at or after its origin or
+    * starts inside it, as with intersectAABoxRay(); the entry and exit
+    * parameters are computed from the reciprocals of the directions, so
+    * they may differ from the ones intersectAABoxRay() gives in the last
+    * bits.
+    *
+    * @param box     the box
+    * @param packet  the rays
+    * @param active  the lanes to test
+    * @param tIn     the ray parameter where each lane enters the box
+    * @param tOut    the ray parameter where each lane leaves the box
+    *
+    * @return the mask of the active lanes that hit the box
+    */
+   template<class DATA_TYPE, unsigned SIZE>
+   inline unsigned int intersect( const AABox<DATA_TYPE>& box, const RayPacket<DATA_TYPE, SIZE>& packet,
+                                  const unsigned int active,
+                                  DATA_TYPE (&tIn)[SIZE], DATA_TYPE (&tOut)[SIZE] )
+   {
+      if (box.isEmpty() || !active)
+      {
+         return 0;
+      }
+      DATA_TYPE inv_dir[3][SIZE];
+      helpers::invertPacketDirs( packet, inv_dir );
+      DATA_TYPE t_in[SIZE], t_out[SIZE];
+      for (unsigned int lane = 0; lane < SIZE; ++lane)
+      {
+         t_in[lane] = -(std::numeric_limits<DATA_TYPE>::max)();
+         t_out[lane] = (std::numeric_limits<DATA_TYPE>::max)();
+      }
+      unsigned int hits = helpers::intersectSlabPacket( box, packet, inv_dir, active,
+                                                        static_cast<DATA_TYPE>(1.0), t_in, t_out );
+      for (unsigned int lane = 0; lane < SIZE; ++lane)
+      {
+         const unsigned int bit = 1u << lane;
+         if ((hits & bit) && t_out[lane] >= static_cast<DATA_TYPE>(0.0))
+         {
+            tIn[lane] = t_in[lane];
+            tOut[lane] = t_out[lane];
+         }
+         else
+         {
+            hits &= ~bit;
+         }
+      }
+      return hits;
+   }
+
+/** @} */
+
+} // end of namespace gmtl
+
+#endif
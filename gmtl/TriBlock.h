@@ -0,0 +1,163 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_TRI_BLOCK_H_
+#define _GMTL_TRI_BLOCK_H_
+
+#include <cstddef>
+#include <gmtl/Tri.h>
+#include <gmtl/Vec3Array.h>
+#include <gmtl/Util/Assert.h>
+
+namespace gmtl
+{
+
+/**
+ * A block of triangles stored as structure of arrays, for testing a ray
+ * against many triangles at once (see TriBlockOps.h).
+ *
+ * Each triangle is stored the way the Moller-Trumbore test uses it: its
+ * first vertex and its two edges tri[1] - tri[0] and tri[2] - tri[0], each
+ * as a Vec3Array column.  The columns are padded to a multiple of Padding
+ * entries with degenerate triangles (zero edges), which no ray hits, so
+ * the SIMD kernels never need a scalar tail loop.
+ *
+ * <h3> "Example:" </h3>
+ * \code
+ *    TriBlockf block( &tris[0], tris.size() );
+ *    float u, v, t;
+ *    unsigned int tri;
+ *    if (intersect( block, ray, u, v, t, tri ))
+ *    {
+ *       // tris[tri] is the closest triangle hit
+ *    }
+ * \endcode
+ *
+ * @param DATA_TYPE     the type of the coordinates
+ *
+ * @see Tri, BVH
+ * @ingroup Types
+ */
+template<class DATA_TYPE>
+class TriBlock
+{
+public:
+   typedef DATA_TYPE DataType;
+   typedef Tri<DATA_TYPE> TriType;
+
+   enum
+   {
+      Padding = 8    /**< the columns are padded to a multiple of this */
+   };
+
+public:
+   /** Creates an empty block. */
+   TriBlock()
+      : mSize( 0 )
+   {
+   }
+
+   /** Creates a block with a copy of count triangles. */
+   TriBlock( const TriType* tris, const std::size_t count )
+      : mSize( 0 )
+   {
+      assign( tris, count );
+   }
+
+   /** Replaces the triangles of this block with a copy of count triangles. */
+   void assign( const TriType* tris, const std::size_t count )
+   {
+      clear();
+      reserve( count );
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         push_back( tris[i] );
+      }
+   }
+
+   /** Appends a triangle. */
+   void push_back( const TriType& tri )
+   {
+      if (mSize == mVert0.size())
+      {
+         resizeColumns( mSize + Padding );
+      }
+      mVert0.set( mSize, Vec<DATA_TYPE, 3>( tri[0][0], tri[0][1], tri[0][2] ) );
+      mEdge1.set( mSize, tri[1] - tri[0] );
+      mEdge2.set( mSize, tri[2] - tri[0] );
+      ++mSize;
+   }
+
+   /** Gets triangle i, rebuilt from its first vertex and edges, so the
+    *  second and third vertices can differ from the ones stored in the
+    *  last bits.
+    */
+   TriType getTri( const std::size_t i ) const
+   {
+      gmtlASSERT( i < mSize );
+      const Point<DATA_TYPE, 3> v0( mVert0.mX[i], mVert0.mY[i], mVert0.mZ[i] );
+      return TriType( v0, v0 + mEdge1.get( i ), v0 + mEdge2.get( i ) );
+   }
+
+   /** Gets the number of triangles. */
+   std::size_t size() const
+   {
+      return mSize;
+   }
+
+   bool empty() const
+   {
+      return mSize == 0;
+   }
+
+   /** Gets the size of the columns, size() rounded up to Padding. */
+   std::size_t getPaddedSize() const
+   {
+      return mVert0.size();
+   }
+
+   /** Removes all the triangles. */
+   void clear()
+   {
+      mVert0.clear();
+      mEdge1.clear();
+      mEdge2.clear();
+      mSize = 0;
+   }
+
+   /** Reserves room for count triangles. */
+   void reserve( const std::size_t count )
+   {
+      const std::size_t padded = (count + Padding - 1) / Padding * Padding;
+      mVert0.reserve( padded );
+      mEdge1.reserve( padded );
+      mEdge2.reserve( padded );
+   }
+
+private:
+   void resizeColumns( const std::size_t size )
+   {
+      mVert0.resize( size );
+      mEdge1.resize( size );
+      mEdge2.resize( size );
+   }
+
+public:
+   /// The first vertex of each triangle.
+   Vec3Array<DATA_TYPE> mVert0;
+
+   /// The edges tri[1] - tri[0] and tri[2] - tri[0] of each triangle.
+   Vec3Array<DATA_TYPE> mEdge1, mEdge2;
+
+   /// The number of triangles, the columns hold padding beyond it.
+   std::size_t mSize;
+};
+
+typedef TriBlock<float> TriBlockf;
+typedef TriBlock<double> TriBlockd;
+
+} // end of namespace gmtl
+
+#endif
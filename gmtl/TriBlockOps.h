@@ -0,0 +1,250 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_TRI_BLOCK_OPS_H_
+#define _GMTL_TRI_BLOCK_OPS_H_
+
+#include <limits>
+#include <gmtl/TriBlock.h>
+#include <gmtl/Ray.h>
+#include <gmtl/LineSeg.h>
+#include <gmtl/VecOps.h>
+#include <gmtl/Util/Simd.h>
+#include <gmtl/Util/TriKernel.h>
+
+namespace gmtl
+{
+namespace helpers
+{
+   /**
+    * Finds the closest triangle of a block that a ray hits, testing one
+    * triangle at a time.  Hits beyond tMax are ignored, and of several
+    * triangles hit at the same t the first one is reported.
+    *
+    * @return true if a triangle was hit, with u, v, t and triIndex set
+    *         for that triangle
+    */
+   template<class DATA_TYPE>
+   inline bool intersectTriBlockRay( const TriBlock<DATA_TYPE>& block, const Point<DATA_TYPE, 3>& origin,
+                                     const Vec<DATA_TYPE, 3>& dir, const DATA_TYPE tMax,
+                                     const bool doubleSided,
+                                     DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t, unsigned int& triIndex )
+   {
+      bool found = false;
+      DATA_TYPE t_limit = tMax;
+      for (std::size_t i = 0; i < block.size(); ++i)
+      {
+         const Point<DATA_TYPE, 3> vert0( block.mVert0.mX[i], block.mVert0.mY[i], block.mVert0.mZ[i] );
+         DATA_TYPE tri_u, tri_v, tri_t;
+         if (intersectTriLane( block.mEdge1.get( i ), block.mEdge2.get( i ), vert0, origin, dir, doubleSided,
+                               tri_u, tri_v, tri_t ) &&
+             (tri_t < t_limit || (!found && tri_t <= t_limit)))
+         {
+            u = tri_u;
+            v = tri_v;
+            t = tri_t;
+            triIndex = static_cast<unsigned int>( i );
+            found = true;
+            t_limit = tri_t;
+         }
+      }
+      return found;
+   }
+
+#ifdef GMTL_HAVE_SSE
+   /**
+    * intersectTriBlockRay() testing OPS::Width triangles at a time with
+    * intersectTriRegs(), with the same arithmetic.  The columns are padded
+    * with triangles that no ray hits, so the last block of lanes needs no
+    * special case.
+    */
+   template<class OPS>
+   inline bool intersectTriBlockRaySimd( const TriBlock<typename OPS::Scalar>& block,
+                                         const Point<typename OPS::Scalar, 3>& origin,
+                                         const Vec<typename OPS::Scalar, 3>& dir,
+                                         const typename OPS::Scalar tMax, const bool doubleSided,
+                                         typename OPS::Scalar& u, typename OPS::Scalar& v,
+                                         typename OPS::Scalar& t, unsigned int& triIndex )
+   {
+      typedef typename OPS::Scalar Scalar;
+      typedef typename OPS::Reg Reg;
+      if (block.empty())
+      {
+         return false;
+      }
+      const Reg dx = OPS::set1( dir[0] ), dy = OPS::set1( dir[1] ), dz = OPS::set1( dir[2] );
+      const Reg ox = OPS::set1( origin[0] ), oy = OPS::set1( origin[1] ), oz = OPS::set1( origin[2] );
+      const Scalar* vert0[3] = { &block.mVert0.mX[0], &block.mVert0.mY[0], &block.mVert0.mZ[0] };
+      const Scalar* edge1[3] = { &block.mEdge1.mX[0], &block.mEdge1.mY[0], &block.mEdge1.mZ[0] };
+      const Scalar* edge2[3] = { &block.mEdge2.mX[0], &block.mEdge2.mY[0], &block.mEdge2.mZ[0] };
+
+      bool found = false;
+      Scalar t_limit = tMax;
+      const std::size_t padded = block.getPaddedSize();
+      for (std::size_t i = 0; i < padded; i += OPS::Width)
+      {
+         Reg hit_u, hit_v, hit_t;
+         const Reg hit = intersectTriRegs<OPS>(
+            dx, dy, dz,
+            OPS::sub( ox, OPS::load( vert0[0] + i ) ),
+            OPS::sub( oy, OPS::load( vert0[1] + i ) ),
+            OPS::sub( oz, OPS::load( vert0[2] + i ) ),
+            OPS::load( edge1[0] + i ), OPS::load( edge1[1] + i ), OPS::load( edge1[2] + i ),
+            OPS::load( edge2[0] + i ), OPS::load( edge2[1] + i ), OPS::load( edge2[2] + i ),
+            doubleSided, hit_u, hit_v, hit_t );
+
+         // the lanes that may replace the closest hit, checked in order
+         unsigned int hits = OPS::movemask( OPS::bitAnd( hit, OPS::le( hit_t, OPS::set1( t_limit ) ) ) );
+         if (!hits)
+         {
+            continue;
+         }
+         Scalar lane_u[OPS::Width], lane_v[OPS::Width], lane_t[OPS::Width];
+         OPS::store( lane_u, hit_u );
+         OPS::store( lane_v, hit_v );
+         OPS::store( lane_t, hit_t );
+         for (unsigned int lane = 0; hits; ++lane, hits >>= 1)
+         {
+            if ((hits & 1u) && (lane_t[lane] < t_limit || (!found && lane_t[lane] <= t_limit)))
+            {
+               u = lane_u[lane];
+               v = lane_v[lane];
+               t = lane_t[lane];
+               triIndex = static_cast<unsigned int>( i + lane );
+               found = true;
+               t_limit = lane_t[lane];
+            }
+         }
+      }
+      return found;
+   }
+
+   /** The float version of intersectTriBlockRay(), 8 triangles at a time
+    *  with AVX or 4 with SSE.
+    */
+   inline bool intersectTriBlockRay( const TriBlock<float>& block, const Point<float, 3>& origin,
+                                     const Vec<float, 3>& dir, const float tMax, const bool doubleSided,
+                                     float& u, float& v, float& t, unsigned int& triIndex )
+   {
+#ifdef GMTL_HAVE_AVX
+      return intersectTriBlockRaySimd<simd::Float8Ops>( block, origin, dir, tMax, doubleSided, u, v, t, triIndex );
+#else
+      return intersectTriBlockRaySimd<simd::Float4Ops>( block, origin, dir, tMax, doubleSided, u, v, t, triIndex );
+#endif
+   }
+#endif
+
+#ifdef GMTL_HAVE_AVX
+   /** The double version of intersectTriBlockRay(), 4 triangles at a time
+    *  with AVX.
+    */
+   inline bool intersectTriBlockRay( const TriBlock<double>& block, const Point<double, 3>& origin,
+                                     const Vec<double, 3>& dir, const double tMax, const bool doubleSided,
+                                     double& u, double& v, double& t, unsigned int& triIndex )
+   {
+      return intersectTriBlockRaySimd<simd::Double4Ops>( block, origin, dir, tMax, doubleSided, u, v, t, triIndex );
+   }
+#endif
+
+   /** Whether a line segment is long enough for the triangle tests, the
+    *  same test as intersect(const Tri&, const LineSeg&, ...).
+    */
+   template<class DATA_TYPE>
+   inline bool isTriBlockSegmentValid( const LineSeg<DATA_TYPE>& seg )
+   {
+      return static_cast<DATA_TYPE>(0.0001010101) < length( seg.getDir() );
+   }
+}
+
+/** @ingroup Ops
+ * @name TriBlock Queries
+ * Ray and line segment queries against all the triangles of a TriBlock.
+ * They give the hit that calling the triangle intersect() (or
+ * intersectDoubleSided()) on every triangle in order and keeping the
+ * closest gives: of several triangles hit at the same t, the one with the
+ * lowest index is reported.  The SIMD kernels do the same arithmetic as
+ * the triangle test, so u, v and t only differ in the last bits where the
+ * compiler contracts one of them into FMAs (which can also change the
+ * order of two hits at nearly the same t).
+ * Float blocks are tested 4 (SSE) or 8 (AVX) triangles at a time, and
+ * double blocks 4 at a time with AVX.
+ * @{
+ */
+
+   /**
+    * Finds the closest triangle of a block that the ray hits from the
+    * front, as intersect(const Tri&, const Ray&, u, v, t) would; back
+    * facing triangles are culled.
+    *
+    * @param block      the triangles
+    * @param ray        the ray
+    * @param u,v        the tangent space coordinates of the hit
+    * @param t          the hit location: ray.getOrigin() + ray.getDir() * t
+    * @param triIndex   the index of the hit triangle in the block
+    *
+    * @return true if the ray hits a triangle
+    */
+   template<class DATA_TYPE>
+   inline bool intersect( const TriBlock<DATA_TYPE>& block, const Ray<DATA_TYPE>& ray,
+                          DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t, unsigned int& triIndex )
+   {
+      return helpers::intersectTriBlockRay( block, ray.getOrigin(), ray.getDir(),
+                                            (std::numeric_limits<DATA_TYPE>::max)(), false,
+                                            u, v, t, triIndex );
+   }
+
+   /**
+    * Finds the closest triangle of a block that the line segment hits from
+    * the front, as intersect(const Tri&, const LineSeg&, u, v, t) would.
+    *
+    * @post t gives the hit location: seg.getOrigin() + seg.getDir() * t
+    *
+    * @return true if the line segment hits a triangle
+    */
+   template<class DATA_TYPE>
+   inline bool intersect( const TriBlock<DATA_TYPE>& block, const LineSeg<DATA_TYPE>& seg,
+                          DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t, unsigned int& triIndex )
+   {
+      return helpers::isTriBlockSegmentValid( seg ) &&
+             helpers::intersectTriBlockRay( block, seg.getOrigin(), seg.getDir(), static_cast<DATA_TYPE>(1.0),
+                                            false, u, v, t, triIndex );
+   }
+
+   /**
+    * Finds the closest triangle of a block that the ray hits from either
+    * side, as intersectDoubleSided(const Tri&, const Ray&, u, v, t) would.
+    *
+    * @return true if the ray hits a triangle
+    */
+   template<class DATA_TYPE>
+   inline bool intersectDoubleSided( const TriBlock<DATA_TYPE>& block, const Ray<DATA_TYPE>& ray,
+                                     DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t, unsigned int& triIndex )
+   {
+      return helpers::intersectTriBlockRay( block, ray.getOrigin(), ray.getDir(),
+                                            (std::numeric_limits<DATA_TYPE>::max)(), true,
+                                            u, v, t, triIndex );
+   }
+
+   /**
+    * Finds the closest triangle of a block that the line segment hits from
+    * either side, as intersectDoubleSided(const Tri&, const LineSeg&, u, v,
+    * t) would.
+    *
+    * @return true if the line segment hits a triangle
+    */
+   template<class DATA_TYPE>
+   inline bool intersectDoubleSided( const TriBlock<DATA_TYPE>& block, const LineSeg<DATA_TYPE>& seg,
+                                     DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t, unsigned int& triIndex )
+   {
+      return helpers::isTriBlockSegmentValid( seg ) &&
+             helpers::intersectTriBlockRay( block, seg.getOrigin(), seg.getDir(), static_cast<DATA_TYPE>(1.0),
+                                            true, u, v, t, triIndex );
+   }
+
+/** @} */
+
+} // end of namespace gmtl
+
+#endif
@@ -0,0 +1,221 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_SIMD_H_
+#define _GMTL_SIMD_H_
+
+#include <cstddef>
+#include <gmtl/Config.h>
+
+/** @file Simd.h
+ * Detection of the SIMD instruction sets GMTL can use.
+ *
+ * GMTL never turns on an instruction set by itself; it only uses what the
+ * compiler has been told the target supports (-msse2, -mavx, /arch:AVX,
+ * etc).  For each instruction set found, the matching GMTL_HAVE_* macro is
+ * defined and the intrinsics header is included.  Every SIMD code path in
+ * GMTL has a scalar fallback that is used when the macro is not defined.
+ *
+ * Define GMTL_NO_SIMD (see Config.h) to force the scalar code paths.
+ */
+
+#ifndef GMTL_NO_SIMD
+#  if defined(__SSE__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#     define GMTL_HAVE_SSE 1
+#  endif
+#  if defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#     define GMTL_HAVE_SSE2 1
+#  endif
+#  if defined(__AVX__)
+#     define GMTL_HAVE_AVX 1
+#  endif
+#endif
+
+#ifdef GMTL_HAVE_SSE
+#  include <xmmintrin.h>
+#endif
+#ifdef GMTL_HAVE_SSE2
+#  include <emmintrin.h>
+#endif
+#ifdef GMTL_HAVE_AVX
+#  include <immintrin.h>
+#endif
+
+#ifdef GMTL_HAVE_SSE
+namespace gmtl
+{
+/** Small helpers shared by the SSE code paths. */
+namespace simd
+{
+   /** Lane 0 = (v0 + v1) + v2, the other lanes are unspecified. */
+   inline __m128 sum3( const __m128 v )
+   {
+      const __m128 s = _mm_add_ss( v, _mm_shuffle_ps( v, v, _MM_SHUFFLE(1, 1, 1, 1) ) );
+      return _mm_add_ss( s, _mm_movehl_ps( v, v ) );
+   }
+
+   /** Lane 0 = ((v0 + v1) + v2) + v3, the other lanes are unspecified. */
+   inline __m128 sum4( const __m128 v )
+   {
+      return _mm_add_ss( sum3( v ), _mm_shuffle_ps( v, v, _MM_SHUFFLE(3, 3, 3, 3) ) );
+   }
+
+   /** Loads p[0], p[1] and p[2] into lanes 0, 1 and 2 without reading past
+    *  them; p need not be aligned and lane 3 is zero.
+    */
+   inline __m128 load3( const float* p )
+   {
+      const __m128 xy = _mm_loadl_pi( _mm_setzero_ps(), reinterpret_cast<const __m64*>( p ) );
+      return _mm_movelh_ps( xy, _mm_load_ss( p + 2 ) );
+   }
+
+   /** Stores lanes 0, 1 and 2 to p, which need not be aligned. */
+   inline void store3( float* p, const __m128 v )
+   {
+      _mm_storel_pi( reinterpret_cast<__m64*>( p ), v );
+      _mm_store_ss( p + 2, _mm_movehl_ps( v, v ) );
+   }
+
+   /** Cross product of the xyz lanes, the w lane is a.w*b.w - a.w*b.w. */
+   inline __m128 cross3( const __m128 a, const __m128 b )
+   {
+      const __m128 a_yzx = _mm_shuffle_ps( a, a, _MM_SHUFFLE(3, 0, 2, 1) );
+      const __m128 b_yzx = _mm_shuffle_ps( b, b, _MM_SHUFFLE(3, 0, 2, 1) );
+      const __m128 a_zxy = _mm_shuffle_ps( a, a, _MM_SHUFFLE(3, 1, 0, 2) );
+      const __m128 b_zxy = _mm_shuffle_ps( b, b, _MM_SHUFFLE(3, 1, 0, 2) );
+      return _mm_sub_ps( _mm_mul_ps( a_yzx, b_zxy ), _mm_mul_ps( a_zxy, b_yzx ) );
+   }
+
+   /** Lanes of a where mask is set, lanes of b elsewhere. */
+   inline __m128 select( const __m128 mask, const __m128 a, const __m128 b )
+   {
+      return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+   }
+
+   /** Loads the four Vec3f at src, src + stride, ... as x, y and z lanes. */
+   inline void loadVec3x4( __m128& x, __m128& y, __m128& z, const char* src, const std::size_t stride )
+   {
+      __m128 v0 = load3( reinterpret_cast<const float*>( src ) );
+      __m128 v1 = load3( reinterpret_cast<const float*>( src + stride ) );
+      __m128 v2 = load3( reinterpret_cast<const float*>( src + 2 * stride ) );
+      __m128 v3 = load3( reinterpret_cast<const float*>( src + 3 * stride ) );
+      _MM_TRANSPOSE4_PS( v0, v1, v2, v3 );
+      x = v0;
+      y = v1;
+      z = v2;
+   }
+
+   /** Stores the x, y and z lanes as four Vec3f at dst, dst + stride, ... */
+   inline void storeVec3x4( char* dst, const std::size_t stride, __m128 x, __m128 y, __m128 z )
+   {
+      __m128 w = _mm_setzero_ps();
+      _MM_TRANSPOSE4_PS( x, y, z, w );
+      store3( reinterpret_cast<float*>( dst ), x );
+      store3( reinterpret_cast<float*>( dst + stride ), y );
+      store3( reinterpret_cast<float*>( dst + 2 * stride ), z );
+      store3( reinterpret_cast<float*>( dst + 3 * stride ), w );
+   }
+
+   /**
+    * SSE operations on 4 float lanes, for kernels that are written once for
+    * SSE and AVX (Float8Ops, 8 lanes) as templates on the operations.
+    * minimum(a, b) is (a < b) ? a : b and maximum(a, b) is (a > b) ? a : b,
+    * as in scalar code, so a NaN in a gives b; the comparisons are false
+    * for NaNs.
+    */
+   struct Float4Ops
+   {
+      typedef float Scalar;
+      typedef __m128 Reg;
+      enum { Width = 4 };
+
+      static Reg set1( const float a ) { return _mm_set1_ps( a ); }
+      static Reg load( const float* p ) { return _mm_loadu_ps( p ); }
+      static void store( float* p, const Reg a ) { _mm_storeu_ps( p, a ); }
+      static Reg add( const Reg a, const Reg b ) { return _mm_add_ps( a, b ); }
+      static Reg sub( const Reg a, const Reg b ) { return _mm_sub_ps( a, b ); }
+      static Reg mul( const Reg a, const Reg b ) { return _mm_mul_ps( a, b ); }
+      static Reg div( const Reg a, const Reg b ) { return _mm_div_ps( a, b ); }
+      static Reg minimum( const Reg a, const Reg b ) { return _mm_min_ps( a, b ); }
+      static Reg maximum( const Reg a, const Reg b ) { return _mm_max_ps( a, b ); }
+      static Reg lt( const Reg a, const Reg b ) { return _mm_cmplt_ps( a, b ); }
+      static Reg gt( const Reg a, const Reg b ) { return _mm_cmpgt_ps( a, b ); }
+      static Reg le( const Reg a, const Reg b ) { return _mm_cmple_ps( a, b ); }
+      static Reg ge( const Reg a, const Reg b ) { return _mm_cmpge_ps( a, b ); }
+      static Reg bitOr( const Reg a, const Reg b ) { return _mm_or_ps( a, b ); }
+      static Reg bitAnd( const Reg a, const Reg b ) { return _mm_and_ps( a, b ); }
+      /** ~a & b */
+      static Reg bitAndNot( const Reg a, const Reg b ) { return _mm_andnot_ps( a, b ); }
+      static unsigned int movemask( const Reg a ) { return static_cast<unsigned int>( _mm_movemask_ps( a ) ); }
+   };
+}
+}
+#endif
+
+#ifdef GMTL_HAVE_AVX
+namespace gmtl
+{
+namespace simd
+{
+   /** AVX operations on 8 float lanes. */
+   struct Float8Ops
+   {
+      typedef float Scalar;
+      typedef __m256 Reg;
+      enum { Width = 8 };
+
+      static Reg set1( const float a ) { return _mm256_set1_ps( a ); }
+      static Reg load( const float* p ) { return _mm256_loadu_ps( p ); }
+      static void store( float* p, const Reg a ) { _mm256_storeu_ps( p, a ); }
+      static Reg add( const Reg a, const Reg b ) { return _mm256_add_ps( a, b ); }
+      static Reg sub( const Reg a, const Reg b ) { return _mm256_sub_ps( a, b ); }
+      static Reg mul( const Reg a, const Reg b ) { return _mm256_mul_ps( a, b ); }
+      static Reg div( const Reg a, const Reg b ) { return _mm256_div_ps( a, b ); }
+      static Reg minimum( const Reg a, const Reg b ) { return _mm256_min_ps( a, b ); }
+      static Reg maximum( const Reg a, const Reg b ) { return _mm256_max_ps( a, b ); }
+      static Reg lt( const Reg a, const Reg b ) { return _mm256_cmp_ps( a, b, _CMP_LT_OQ ); }
+      static Reg gt( const Reg a, const Reg b ) { return _mm256_cmp_ps( a, b, _CMP_GT_OQ ); }
+      static Reg le( const Reg a, const Reg b ) { return _mm256_cmp_ps( a, b, _CMP_LE_OQ ); }
+      static Reg ge( const Reg a, const Reg b ) { return _mm256_cmp_ps( a, b, _CMP_GE_OQ ); }
+      static Reg bitOr( const Reg a, const Reg b ) { return _mm256_or_ps( a, b ); }
+      static Reg bitAnd( const Reg a, const Reg b ) { return _mm256_and_ps( a, b ); }
+      /** ~a & b */
+      static Reg bitAndNot( const Reg a, const Reg b ) { return _mm256_andnot_ps( a, b ); }
+      static unsigned int movemask( const Reg a ) { return static_cast<unsigned int>( _mm256_movemask_ps( a ) ); }
+   };
+
+   /** AVX operations on 4 double lanes. */
+   struct Double4Ops
+   {
+      typedef double Scalar;
+      typedef __m256d Reg;
+      enum { Width = 4 };
+
+      static Reg set1( const double a ) { return _mm256_set1_pd( a ); }
+      static Reg load( const double* p ) { return _mm256_loadu_pd( p ); }
+      static void store( double* p, const Reg a ) { _mm256_storeu_pd( p, a ); }
+      static Reg add( const Reg a, const Reg b ) { return _mm256_add_pd( a, b ); }
+      static Reg sub( const Reg a, const Reg b ) { return _mm256_sub_pd( a, b ); }
+      static Reg mul( const Reg a, const Reg b ) { return _mm256_mul_pd( a, b ); }
+      static Reg div( const Reg a, const Reg b ) { return _mm256_div_pd( a, b ); }
+      static Reg minimum( const Reg a, const Reg b ) { return _mm256_min_pd( a, b ); }
+      static Reg maximum( const Reg a, const Reg b ) { return _mm256_max_pd( a, b ); }
+      static Reg lt( const Reg a, const Reg b ) { return _mm256_cmp_pd( a, b, _CMP_LT_OQ ); }
+      static Reg gt( const Reg a, const Reg b ) { return _mm256_cmp_pd( a, b, _CMP_GT_OQ ); }
+      static Reg le( const Reg a, const Reg b ) { return _mm256_cmp_pd( a, b, _CMP_LE_OQ ); }
+      static Reg ge( const Reg a, const Reg b ) { return _mm256_cmp_pd( a, b, _CMP_GE_OQ ); }
+      static Reg bitOr( const Reg a, const Reg b ) { return _mm256_or_pd( a, b ); }
+      static Reg bitAnd( const Reg a, const Reg b ) { return _mm256_and_pd( a, b ); }
+      /** ~a & b */
+      static Reg bitAndNot( const Reg a, const Reg b ) { return _mm256_andnot_pd( a, b ); }
+      static unsigned int movemask( const Reg a ) { return static_cast<unsigned int>( _mm256_movemask_pd( a ) ); }
+   };
+}
+}
+#endif
+
+#endif
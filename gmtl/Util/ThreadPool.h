@@ -0,0 +1,347 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_THREAD_POOL_H_
+#define _GMTL_THREAD_POOL_H_
+
+#include <cstddef>
+#include <vector>
+#include <gmtl/Config.h>
+#include <gmtl/Util/Assert.h>
+
+/** @file ThreadPool.h
+ * A small pool of worker threads for the parallel algorithms of GMTL.
+ *
+ * The pool uses the C++11 thread library.  GMTL_HAVE_THREADS is defined
+ * unless GMTL_NO_THREADS is (see Config.h); with GMTL_NO_THREADS a
+ * ThreadPool has one thread, the caller's, and runs everything in place,
+ * with the same results.  The choice changes the layout of ThreadPool, so
+ * it has to be made for the whole program, not per translation unit:
+ * pre-C++11 code must define GMTL_NO_THREADS, and it is an error not to.
+ * Programs that use the pool may have to link with the platform thread
+ * library (-pthread).  gmtl/gmtl.h includes neither the pool nor the BVH
+ * headers that use it, so the rest of GMTL is not affected.
+ */
+
+#ifndef GMTL_NO_THREADS
+#  if __cplusplus < 201103L && !(defined(_MSVC_LANG) && _MSVC_LANG >= 201103L) && \
+      !(defined(_MSC_VER) && _MSC_VER >= 1700)
+#    error "gmtl::ThreadPool needs C++11 threads; define GMTL_NO_THREADS for the whole program to build without them"
+#  endif
+#  define GMTL_HAVE_THREADS 1
+#endif
+
+#ifdef GMTL_HAVE_THREADS
+#  include <atomic>
+#  include <condition_variable>
+#  include <exception>
+#  include <mutex>
+#  include <thread>
+#endif
+
+namespace gmtl
+{
+
+/**
+ * A fixed set of threads that run tasks for the caller.
+ *
+ * run() executes the tasks 0 to numTasks - 1 on the threads of the pool
+ * and returns when all of them are done.  The calling thread is thread 0
+ * of the pool and works on the tasks too, so a pool of N threads starts
+ * N - 1 worker threads.  Tasks are handed out in order, one at a time, to
+ * whichever thread is free, so tasks of uneven cost balance well when
+ * there are several per thread.
+ *
+ * A pool runs one run() at a time; it must not be called from a task.
+ * If a task throws, the tasks not started yet are skipped and run()
+ * rethrows the first exception once every thread is done with the job.
+ *
+ * <h3> "Example:" </h3>
+ * \code
+ *    struct Square
+ *    {
+ *       float* mData;
+ *       void operator()( std::size_t task, unsigned int thread ) const
+ *       {
+ *          mData[task] *= mData[task];
+ *       }
+ *    };
+ *
+ *    ThreadPool pool;   // one thread per core
+ *    Square square = { data };
+ *    pool.run( count, square );
+ * \endcode
+ *
+ * @ingroup Types
+ */
+class ThreadPool
+{
+public:
+   /** Creates a pool of numThreads threads, or of one thread per hardware
+    *  thread if numThreads is 0.
+    */
+   explicit ThreadPool( const unsigned int numThreads = 0 )
+      : mNumThreads( 1 )
+#ifdef GMTL_HAVE_THREADS
+      , mJob( NULL ), mGeneration( 0 ), mBusy( 0 ), mStop( false )
+#endif
+   {
+#ifdef GMTL_HAVE_THREADS
+      mNumThreads = numThreads ? numThreads : getHardwareThreads();
+      for (unsigned int thread = 1; thread < mNumThreads; ++thread)
+      {
+         mThreads.push_back( std::thread( &ThreadPool::workerLoop, this, thread ) );
+      }
+#else
+      (void)numThreads;
+#endif
+   }
+
+   ~ThreadPool()
+   {
+#ifdef GMTL_HAVE_THREADS
+      {
+         std::lock_guard<std::mutex> lock( mMutex );
+         mStop = true;
+      }
+      mStart.notify_all();
+      for (std::size_t i = 0; i < mThreads.size(); ++i)
+      {
+         mThreads[i].join();
+      }
+#endif
+   }
+
+   /** Gets the number of threads, including the calling thread. */
+   unsigned int getNumThreads() const
+   {
+      return mNumThreads;
+   }
+
+   /** Gets the number of threads the hardware runs at once, at least 1. */
+   static unsigned int getHardwareThreads()
+   {
+#ifdef GMTL_HAVE_THREADS
+      const unsigned int count = std::thread::hardware_concurrency();
+      return count ? count : 1;
+#else
+      return 1;
+#endif
+   }
+
+   /** Calls func( task, thread ) for every task from 0 to numTasks - 1,
+    *  where thread (0 to getNumThreads() - 1) is the pool thread running the
+    *  task, and waits for all the calls to return.  An exception thrown by
+    *  a task is rethrown here, after the other threads have stopped.
+    */
+   template<class FUNC>
+   void run( const std::size_t numTasks, const FUNC& func )
+   {
+      FuncJob<FUNC> job( func, numTasks );
+#ifdef GMTL_HAVE_THREADS
+      if (!mThreads.empty() && numTasks > 1)
+      {
+         runJob( job );
+      }
+      else
+      {
+         job.runTasks( 0 );
+      }
+      job.rethrowError();
+#else
+      job.runTasks( 0 );
+#endif
+   }
+
+   /** Gets the part of [0, count) that task (of numTasks) should process
+    *  when the items are split into numTasks contiguous ranges of nearly
+    *  equal size.
+    */
+   static void getRange( const std::size_t count, const std::size_t task, const std::size_t numTasks,
+                         std::size_t& begin, std::size_t& end )
+   {
+      gmtlASSERT( task < numTasks );
+      const std::size_t size = count / numTasks, extra = count % numTasks;
+      begin = task * size + (task < extra ? task : extra);
+      end = begin + size + (task < extra ? 1 : 0);
+   }
+
+private:
+   ThreadPool( const ThreadPool& );
+   ThreadPool& operator=( const ThreadPool& );
+
+   /** The tasks of one run(). */
+   class Job
+   {
+   public:
+      explicit Job( const std::size_t numTasks )
+         : mNumTasks( numTasks )
+#ifndef GMTL_HAVE_THREADS
+         , mNext( 0 )
+#endif
+      {
+#ifdef GMTL_HAVE_THREADS
+         mNext.store( 0 );
+#endif
+      }
+
+      virtual ~Job()
+      {
+      }
+
+      /** Runs tasks on the given thread until there are none left. */
+      void runTasks( const unsigned int thread )
+      {
+         for (;;)
+         {
+#ifdef GMTL_HAVE_THREADS
+            const std::size_t task = mNext.fetch_add( 1 );
+#else
+            const std::size_t task = mNext++;
+#endif
+            if (task >= mNumTasks)
+            {
+               return;
+            }
+#ifdef GMTL_HAVE_THREADS
+            // a worker must not let it escape, and the caller has to wait
+            // for the workers before it leaves run()
+            try
+            {
+               runTask( task, thread );
+            }
+            catch (...)
+            {
+               setError( std::current_exception() );
+            }
+#else
+            runTask( task, thread );
+#endif
+         }
+      }
+
+#ifdef GMTL_HAVE_THREADS
+      /** Rethrows the first exception a task threw, if any. */
+      void rethrowError()
+      {
+         if (mError)
+         {
+            std::rethrow_exception( mError );
+         }
+      }
+#endif
+
+   protected:
+      virtual void runTask( const std::size_t task, const unsigned int thread ) = 0;
+
+   private:
+#ifdef GMTL_HAVE_THREADS
+      /** Keeps the first error and skips the tasks not started yet. */
+      void setError( const std::exception_ptr& error )
+      {
+         std::lock_guard<std::mutex> lock( mErrorMutex );
+         if (!mError)
+         {
+            mError = error;
+         }
+         mNext.store( mNumTasks );
+      }
+#endif
+
+      std::size_t mNumTasks;
+#ifdef GMTL_HAVE_THREADS
+      std::atomic<std::size_t> mNext;
+      std::mutex mErrorMutex;
+      std::exception_ptr mError;
+#else
+      std::size_t mNext;
+#endif
+   };
+
+   template<class FUNC>
+   class FuncJob : public Job
+   {
+   public:
+      FuncJob( const FUNC& func, const std::size_t numTasks )
+         : Job( numTasks ), mFunc( func )
+      {
+      }
+
+   protected:
+      virtual void runTask( const std::size_t task, const unsigned int thread )
+      {
+         mFunc( task, thread );
+      }
+
+   private:
+      const FUNC& mFunc;
+   };
+
+#ifdef GMTL_HAVE_THREADS
+   /** Hands job to the workers, works on it and waits for the workers. */
+   void runJob( Job& job )
+   {
+      {
+         std::lock_guard<std::mutex> lock( mMutex );
+         mJob = &job;
+         mBusy = static_cast<unsigned int>( mThreads.size() );
+         ++mGeneration;
+      }
+      mStart.notify_all();
+      job.runTasks( 0 );
+
+      std::unique_lock<std::mutex> lock( mMutex );
+      while (mBusy != 0)
+      {
+         mDone.wait( lock );
+      }
+      mJob = NULL;
+   }
+
+   void workerLoop( const unsigned int thread )
+   {
+      unsigned int generation = 0;
+      for (;;)
+      {
+         Job* job;
+         {
+            std::unique_lock<std::mutex> lock( mMutex );
+            while (!mStop && mGeneration == generation)
+            {
+               mStart.wait( lock );
+            }
+            if (mStop)
+            {
+               return;
+            }
+            generation = mGeneration;
+            job = mJob;
+         }
+         job->runTasks( thread );
+         {
+            std::lock_guard<std::mutex> lock( mMutex );
+            --mBusy;
+         }
+         mDone.notify_one();
+      }
+   }
+#endif
+
+private:
+   unsigned int mNumThreads;
+#ifdef GMTL_HAVE_THREADS
+   std::vector<std::thread> mThreads;
+   std::mutex mMutex;
+   std::condition_variable mStart, mDone;
+   Job* mJob;
+   unsigned int mGeneration;
+   unsigned int mBusy;
+   bool mStop;
+#endif
+};
+
+} // end of namespace gmtl
+
+#endif
@@ -0,0 +1,153 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_TRI_KERNEL_H_
+#define _GMTL_TRI_KERNEL_H_
+
+#include <gmtl/Vec.h>
+#include <gmtl/Point.h>
+#include <gmtl/VecOps.h>
+#include <gmtl/Util/Simd.h>
+
+/** @file TriKernel.h
+ * The ray/triangle test shared by the batched intersection kernels (ray
+ * packets, triangle blocks), in a scalar and a SIMD version that do the
+ * same arithmetic in the same order.  Their results only differ where the
+ * compiler contracts the scalar version into FMAs (-ffp-contract).
+ */
+
+namespace gmtl
+{
+namespace helpers
+{
+   /**
+    * The Moller-Trumbore test of intersect(const Tri&, const Ray&, ...) (or
+    * of intersectDoubleSided()) with the same operations in the same order,
+    * for the kernels that test many rays or triangles.  edge1 and edge2 are
+    * tri[1] - tri[0] and tri[2] - tri[0].
+    */
+   template<class DATA_TYPE>
+   inline bool intersectTriLane( const Vec<DATA_TYPE, 3>& edge1, const Vec<DATA_TYPE, 3>& edge2,
+                                 const Point<DATA_TYPE, 3>& vert0,
+                                 const Point<DATA_TYPE, 3>& origin, const Vec<DATA_TYPE, 3>& dir,
+                                 const bool doubleSided,
+                                 DATA_TYPE& u, DATA_TYPE& v, DATA_TYPE& t )
+   {
+      const DATA_TYPE eps = static_cast<DATA_TYPE>(0.00001);
+      const DATA_TYPE zero = static_cast<DATA_TYPE>(0.0);
+      const DATA_TYPE one = static_cast<DATA_TYPE>(1.0);
+      Vec<DATA_TYPE, 3> pvec, qvec;
+      cross( pvec, dir, edge2 );
+      const DATA_TYPE det = dot( edge1, pvec );
+      const Vec<DATA_TYPE, 3> tvec = origin - vert0;
+      cross( qvec, tvec, edge1 );
+
+      if (!doubleSided)
+      {
+         if (det < eps)
+         {
+            return false;
+         }
+         const DATA_TYPE det_u = dot( tvec, pvec );
+         if (det_u < zero || det_u > det)
+         {
+            return false;
+         }
+         const DATA_TYPE det_v = dot( dir, qvec );
+         if (det_v < zero || det_u + det_v > det)
+         {
+            return false;
+         }
+         const DATA_TYPE inv_det = one / det;
+         t = dot( edge2, qvec ) * inv_det;
+         u = det_u * inv_det;
+         v = det_v * inv_det;
+         return t >= zero;
+      }
+
+      if (det < eps && det > -eps)
+      {
+         return false;
+      }
+      const DATA_TYPE inv_det = one / det;
+      u = inv_det * dot( tvec, pvec );
+      if (u < zero || u > one)
+      {
+         return false;
+      }
+      v = inv_det * dot( dir, qvec );
+      if (v < zero || u + v > one)
+      {
+         return false;
+      }
+      t = inv_det * dot( edge2, qvec );
+      return t >= zero;
+   }
+
+#ifdef GMTL_HAVE_SSE
+   /**
+    * intersectTriLane() on the lanes of SIMD registers (simd::Float4Ops,
+    * simd::Float8Ops or simd::Double4Ops), with the same arithmetic: d is
+    * the ray direction, t the ray origin minus the first vertex of the
+    * triangle and e1, e2 its edges.
+    *
+    * @return the mask of the lanes that hit, with hitU, hitV and hitT set
+    *         for them
+    */
+   template<class OPS>
+   inline typename OPS::Reg intersectTriRegs( const typename OPS::Reg dx, const typename OPS::Reg dy,
+                                              const typename OPS::Reg dz, const typename OPS::Reg tx,
+                                              const typename OPS::Reg ty, const typename OPS::Reg tz,
+                                              const typename OPS::Reg e1x, const typename OPS::Reg e1y,
+                                              const typename OPS::Reg e1z, const typename OPS::Reg e2x,
+                                              const typename OPS::Reg e2y, const typename OPS::Reg e2z,
+                                              const bool doubleSided, typename OPS::Reg& hitU,
+                                              typename OPS::Reg& hitV, typename OPS::Reg& hitT )
+   {
+      typedef typename OPS::Reg Reg;
+      // pvec = cross( dir, edge2 ), qvec = cross( tvec, edge1 )
+      const Reg px = OPS::sub( OPS::mul( dy, e2z ), OPS::mul( dz, e2y ) );
+      const Reg py = OPS::sub( OPS::mul( dz, e2x ), OPS::mul( dx, e2z ) );
+      const Reg pz = OPS::sub( OPS::mul( dx, e2y ), OPS::mul( dy, e2x ) );
+      const Reg qx = OPS::sub( OPS::mul( ty, e1z ), OPS::mul( tz, e1y ) );
+      const Reg qy = OPS::sub( OPS::mul( tz, e1x ), OPS::mul( tx, e1z ) );
+      const Reg qz = OPS::sub( OPS::mul( tx, e1y ), OPS::mul( ty, e1x ) );
+
+      const Reg det = OPS::add( OPS::add( OPS::mul( e1x, px ), OPS::mul( e1y, py ) ), OPS::mul( e1z, pz ) );
+      const Reg det_u = OPS::add( OPS::add( OPS::mul( tx, px ), OPS::mul( ty, py ) ), OPS::mul( tz, pz ) );
+      const Reg det_v = OPS::add( OPS::add( OPS::mul( dx, qx ), OPS::mul( dy, qy ) ), OPS::mul( dz, qz ) );
+      const Reg det_t = OPS::add( OPS::add( OPS::mul( e2x, qx ), OPS::mul( e2y, qy ) ), OPS::mul( e2z, qz ) );
+
+      typedef typename OPS::Scalar Scalar;
+      const Reg zero = OPS::set1( static_cast<Scalar>(0.0) );
+      const Reg one = OPS::set1( static_cast<Scalar>(1.0) );
+      const Reg eps = OPS::set1( static_cast<Scalar>(0.00001) );
+      const Reg inv_det = OPS::div( one, det );
+      Reg miss;
+      if (!doubleSided)
+      {
+         miss = OPS::bitOr( OPS::lt( det, eps ),
+                OPS::bitOr( OPS::bitOr( OPS::lt( det_u, zero ), OPS::gt( det_u, det ) ),
+                            OPS::bitOr( OPS::lt( det_v, zero ), OPS::gt( OPS::add( det_u, det_v ), det ) ) ) );
+         hitT = OPS::mul( det_t, inv_det );
+         hitU = OPS::mul( det_u, inv_det );
+         hitV = OPS::mul( det_v, inv_det );
+      }
+      else
+      {
+         hitU = OPS::mul( inv_det, det_u );
+         hitV = OPS::mul( inv_det, det_v );
+         hitT = OPS::mul( inv_det, det_t );
+         miss = OPS::bitOr( OPS::bitAnd( OPS::lt( det, eps ), OPS::gt( det, OPS::sub( zero, eps ) ) ),
+                OPS::bitOr( OPS::bitOr( OPS::lt( hitU, zero ), OPS::gt( hitU, one ) ),
+                            OPS::bitOr( OPS::lt( hitV, zero ), OPS::gt( OPS::add( hitU, hitV ), one ) ) ) );
+      }
+      return OPS::bitAndNot( miss, OPS::ge( hitT, zero ) );
+   }
+#endif
+}
+}
+
+#endif
@@ -56,6 +56,14 @@ public:
       }
    }
 
+   /**
+    * No-init constructor. The components are left uninitialized.
+    * @see NoInit
+    */
+   explicit Vec( NoInit )
+   {
+   }
+
    /// @name Value constructors
    //@{
    /**
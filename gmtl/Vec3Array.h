@@ -0,0 +1,323 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_VEC3_ARRAY_H_
+#define _GMTL_VEC3_ARRAY_H_
+
+#include <cstddef>
+#include <vector>
+#include <gmtl/Defines.h>
+#include <gmtl/Vec.h>
+#include <gmtl/Util/Assert.h>
+#include <gmtl/Util/StaticAssert.h>
+
+namespace gmtl
+{
+
+/**
+ * A shallow view of N three component vectors, given as three element
+ * arrays (x, y and z) that are read with a common stride.
+ *
+ * A view does not own its data.  It is what the batch functions in
+ * Vec3ArrayOps.h work on, and it can look at either layout without copying:
+ * - structure of arrays (Vec3Array): x, y and z are separate arrays and the
+ *   stride is 1.  This is the layout the SIMD code paths need.
+ * - array of structures (std::vector<Vec3f>): x, y and z point into the
+ *   first vector and the stride is 3.  The batch functions read and write
+ *   the vectors in place, using the scalar code path.
+ *
+ * Use makeView() to create views.  DATA_TYPE is const for read only views;
+ * a view converts to its read only version implicitly.
+ *
+ * @see Vec3Array
+ * @ingroup Types
+ */
+template<class DATA_TYPE>
+class Vec3ArrayView
+{
+public:
+   typedef DATA_TYPE DataType;
+
+   /// The read only version of this view.
+   typedef Vec3ArrayView<const DATA_TYPE> ConstView;
+
+public:
+   /** Creates an empty view. */
+   Vec3ArrayView()
+      : mX( NULL ), mY( NULL ), mZ( NULL ), mSize( 0 ), mStride( 1 )
+   {
+   }
+
+   /**
+    * Creates a view of size vectors.  Vector i is
+    * (x[i*stride], y[i*stride], z[i*stride]).
+    */
+   Vec3ArrayView( DATA_TYPE* x, DATA_TYPE* y, DATA_TYPE* z,
+                  std::size_t size, std::size_t stride = 1 )
+      : mX( x ), mY( y ), mZ( z ), mSize( size ), mStride( stride )
+   {
+   }
+
+   /** Converts a view to its read only version. */
+   template<class DATA_TYPE2>
+   Vec3ArrayView( const Vec3ArrayView<DATA_TYPE2>& view )
+      : mX( view.mX ), mY( view.mY ), mZ( view.mZ ),
+        mSize( view.mSize ), mStride( view.mStride )
+   {
+   }
+
+   /** Gets the number of vectors in the view. */
+   std::size_t size() const
+   {
+      return mSize;
+   }
+
+   /** Returns true if x, y and z are each contiguous (the stride is 1). */
+   bool isPacked() const
+   {
+      return mStride == 1;
+   }
+
+   /** @name Component access
+    *  The view is shallow: the elements are writable unless DATA_TYPE is
+    *  const, even through a const view.
+    * @{
+    */
+   DATA_TYPE& x( const std::size_t i ) const
+   {
+      gmtlASSERT( i < mSize );
+      return mX[i * mStride];
+   }
+
+   DATA_TYPE& y( const std::size_t i ) const
+   {
+      gmtlASSERT( i < mSize );
+      return mY[i * mStride];
+   }
+
+   DATA_TYPE& z( const std::size_t i ) const
+   {
+      gmtlASSERT( i < mSize );
+      return mZ[i * mStride];
+   }
+   /** @} */
+
+public:
+   DATA_TYPE* mX;
+   DATA_TYPE* mY;
+   DATA_TYPE* mZ;
+
+   /// The number of vectors.
+   std::size_t mSize;
+
+   /// The distance between two vectors, in elements.
+   std::size_t mStride;
+};
+
+/**
+ * A structure of arrays container of three component vectors.
+ *
+ * An array of Vec3f stores x, y, z, x, y, z, ... (12 bytes per vector).
+ * Vec3Array stores all the x components, then all the y components, then
+ * all the z components, so that the batch functions in Vec3ArrayOps.h can
+ * process several vectors at once with SIMD instructions.
+ *
+ * Converting from and to std::vector<Vec3f> copies the data.  To use the
+ * batch functions on a std::vector<Vec3f> without copying, work on
+ * makeView() of the vector instead.
+ *
+ * @param DATA_TYPE     the type of the components
+ *
+ * @see Vec3ArrayView
+ * @ingroup Types
+ */
+template<class DATA_TYPE>
+class Vec3Array
+{
+public:
+   typedef DATA_TYPE DataType;
+   typedef Vec<DATA_TYPE, 3> VecType;
+
+public:
+   /** Creates an empty array. */
+   Vec3Array()
+   {
+   }
+
+   /** Creates an array of size zero vectors. */
+   explicit Vec3Array( const std::size_t size )
+      : mX( size, DATA_TYPE(0) ), mY( size, DATA_TYPE(0) ), mZ( size, DATA_TYPE(0) )
+   {
+   }
+
+   /** Creates an array with a copy of the given vectors. */
+   explicit Vec3Array( const std::vector<VecType>& vecs )
+   {
+      assign( vecs );
+   }
+
+   /** Replaces the contents of this array with a copy of the given vectors. */
+   void assign( const std::vector<VecType>& vecs )
+   {
+      resize( vecs.size() );
+      for (std::size_t i = 0; i < vecs.size(); ++i)
+      {
+         set( i, vecs[i] );
+      }
+   }
+
+   /** Copies the vectors of this array into vecs, resizing it to fit. */
+   void copyTo( std::vector<VecType>& vecs ) const
+   {
+      vecs.resize( size() );
+      for (std::size_t i = 0; i < size(); ++i)
+      {
+         vecs[i].set( mX[i], mY[i], mZ[i] );
+      }
+   }
+
+   /** Gets the number of vectors in the array. */
+   std::size_t size() const
+   {
+      return mX.size();
+   }
+
+   bool empty() const
+   {
+      return mX.empty();
+   }
+
+   /** Resizes the array, new vectors are zero. */
+   void resize( const std::size_t size )
+   {
+      mX.resize( size, DATA_TYPE(0) );
+      mY.resize( size, DATA_TYPE(0) );
+      mZ.resize( size, DATA_TYPE(0) );
+   }
+
+   void reserve( const std::size_t size )
+   {
+      mX.reserve( size );
+      mY.reserve( size );
+      mZ.reserve( size );
+   }
+
+   void clear()
+   {
+      mX.clear();
+      mY.clear();
+      mZ.clear();
+   }
+
+   void push_back( const VecType& vec )
+   {
+      mX.push_back( vec[0] );
+      mY.push_back( vec[1] );
+      mZ.push_back( vec[2] );
+   }
+
+   /** Gets a copy of vector i. */
+   VecType get( const std::size_t i ) const
+   {
+      gmtlASSERT( i < size() );
+      return VecType( mX[i], mY[i], mZ[i] );
+   }
+
+   /** Sets vector i. */
+   void set( const std::size_t i, const VecType& vec )
+   {
+      gmtlASSERT( i < size() );
+      mX[i] = vec[0];
+      mY[i] = vec[1];
+      mZ[i] = vec[2];
+   }
+
+public:
+   std::vector<DATA_TYPE> mX;
+   std::vector<DATA_TYPE> mY;
+   std::vector<DATA_TYPE> mZ;
+};
+
+/** @ingroup Types
+ * @name Vec3Array views
+ * @{
+ */
+
+/** Creates a writable view of a Vec3Array. */
+template<class DATA_TYPE>
+inline Vec3ArrayView<DATA_TYPE> makeView( Vec3Array<DATA_TYPE>& array )
+{
+   if (array.empty())
+   {
+      return Vec3ArrayView<DATA_TYPE>();
+   }
+   return Vec3ArrayView<DATA_TYPE>( &array.mX[0], &array.mY[0], &array.mZ[0], array.size() );
+}
+
+/** Creates a read only view of a Vec3Array. */
+template<class DATA_TYPE>
+inline Vec3ArrayView<const DATA_TYPE> makeView( const Vec3Array<DATA_TYPE>& array )
+{
+   if (array.empty())
+   {
+      return Vec3ArrayView<const DATA_TYPE>();
+   }
+   return Vec3ArrayView<const DATA_TYPE>( &array.mX[0], &array.mY[0], &array.mZ[0], array.size() );
+}
+
+/** Creates a writable view of size vectors starting at vecs, without
+ *  copying them.
+ */
+template<class DATA_TYPE>
+inline Vec3ArrayView<DATA_TYPE> makeView( Vec<DATA_TYPE, 3>* vecs, const std::size_t size )
+{
+   GMTL_STATIC_ASSERT( sizeof(Vec<DATA_TYPE, 3>) == 3 * sizeof(DATA_TYPE),
+                       Vec_is_not_three_packed_components );
+   if (size == 0)
+   {
+      return Vec3ArrayView<DATA_TYPE>();
+   }
+   DATA_TYPE* data = vecs->getData();
+   return Vec3ArrayView<DATA_TYPE>( data, data + 1, data + 2, size, 3 );
+}
+
+/** Creates a read only view of size vectors starting at vecs, without
+ *  copying them.
+ */
+template<class DATA_TYPE>
+inline Vec3ArrayView<const DATA_TYPE> makeView( const Vec<DATA_TYPE, 3>* vecs, const std::size_t size )
+{
+   GMTL_STATIC_ASSERT( sizeof(Vec<DATA_TYPE, 3>) == 3 * sizeof(DATA_TYPE),
+                       Vec_is_not_three_packed_components );
+   if (size == 0)
+   {
+      return Vec3ArrayView<const DATA_TYPE>();
+   }
+   const DATA_TYPE* data = vecs->getData();
+   return Vec3ArrayView<const DATA_TYPE>( data, data + 1, data + 2, size, 3 );
+}
+
+/** Creates a writable view of a std::vector of Vec, without copying it. */
+template<class DATA_TYPE>
+inline Vec3ArrayView<DATA_TYPE> makeView( std::vector< Vec<DATA_TYPE, 3> >& vecs )
+{
+   return vecs.empty() ? Vec3ArrayView<DATA_TYPE>() : makeView( &vecs[0], vecs.size() );
+}
+
+/** Creates a read only view of a std::vector of Vec, without copying it. */
+template<class DATA_TYPE>
+inline Vec3ArrayView<const DATA_TYPE> makeView( const std::vector< Vec<DATA_TYPE, 3> >& vecs )
+{
+   return vecs.empty() ? Vec3ArrayView<const DATA_TYPE>() : makeView( &vecs[0], vecs.size() );
+}
+
+/** @} */
+
+typedef Vec3Array<float> Vec3fArray;
+typedef Vec3Array<double> Vec3dArray;
+
+} // end of namespace gmtl
+
+#endif
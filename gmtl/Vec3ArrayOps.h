@@ -0,0 +1,431 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_VEC3_ARRAY_OPS_H_
+#define _GMTL_VEC3_ARRAY_OPS_H_
+
+#include <cstddef>
+#include <gmtl/Math.h>
+#include <gmtl/Vec3Array.h>
+#include <gmtl/Util/Assert.h>
+#include <gmtl/Util/Simd.h>
+
+/** @file Vec3ArrayOps.h
+ * Batch versions of the VecOps.h functions, working on Vec3ArrayView.
+ *
+ * Each function applies the VecOps.h operation to every vector of its
+ * views, with the same operation order as VecOps.h.  All the
+ * views passed to one call must have the same size.  The result view may
+ * be the same as an input view.
+ *
+ * For float views that are all packed (stride 1, see Vec3Array), the
+ * vectors are processed four at a time with SSE.  Other views (for example
+ * views of a std::vector<Vec3f>) use a scalar loop.
+ */
+
+namespace gmtl
+{
+
+namespace simd
+{
+/** @name Vec3Array kernels
+ *  Each kernel processes the leading vectors it can handle and returns how
+ *  many it did, the caller does the rest.  The generic versions do none;
+ *  the float overloads below handle packed views a multiple of four
+ *  vectors at a time.
+ * @{
+ */
+template<class DATA_TYPE>
+inline std::size_t batchAdd( const Vec3ArrayView<DATA_TYPE>&, const Vec3ArrayView<const DATA_TYPE>&,
+                             const Vec3ArrayView<const DATA_TYPE>& )
+{ return 0; }
+
+template<class DATA_TYPE>
+inline std::size_t batchSub( const Vec3ArrayView<DATA_TYPE>&, const Vec3ArrayView<const DATA_TYPE>&,
+                             const Vec3ArrayView<const DATA_TYPE>& )
+{ return 0; }
+
+template<class DATA_TYPE>
+inline std::size_t batchDot( DATA_TYPE*, const Vec3ArrayView<const DATA_TYPE>&,
+                             const Vec3ArrayView<const DATA_TYPE>& )
+{ return 0; }
+
+template<class DATA_TYPE>
+inline std::size_t batchCross( const Vec3ArrayView<DATA_TYPE>&, const Vec3ArrayView<const DATA_TYPE>&,
+                               const Vec3ArrayView<const DATA_TYPE>& )
+{ return 0; }
+
+template<class DATA_TYPE>
+inline std::size_t batchLength( DATA_TYPE*, const Vec3ArrayView<const DATA_TYPE>&, const bool )
+{ return 0; }
+
+template<class DATA_TYPE>
+inline std::size_t batchNormalize( const Vec3ArrayView<DATA_TYPE>&, DATA_TYPE* )
+{ return 0; }
+
+template<class DATA_TYPE>
+inline std::size_t batchLerp( const Vec3ArrayView<DATA_TYPE>&, const DATA_TYPE&,
+                              const Vec3ArrayView<const DATA_TYPE>&, const Vec3ArrayView<const DATA_TYPE>& )
+{ return 0; }
+
+template<class DATA_TYPE>
+inline std::size_t batchReflect( const Vec3ArrayView<DATA_TYPE>&, const Vec3ArrayView<const DATA_TYPE>&,
+                                 const Vec3ArrayView<const DATA_TYPE>& )
+{ return 0; }
+
+#ifdef GMTL_HAVE_SSE
+inline std::size_t batchAdd( const Vec3ArrayView<float>& result, const Vec3ArrayView<const float>& v1,
+                             const Vec3ArrayView<const float>& v2 )
+{
+   if (!(result.isPacked() && v1.isPacked() && v2.isPacked()))
+   {
+      return 0;
+   }
+   const std::size_t n = result.size() & ~std::size_t(3);
+   for (std::size_t i = 0; i < n; i += 4)
+   {
+      const __m128 x = _mm_add_ps( _mm_loadu_ps( v1.mX + i ), _mm_loadu_ps( v2.mX + i ) );
+      const __m128 y = _mm_add_ps( _mm_loadu_ps( v1.mY + i ), _mm_loadu_ps( v2.mY + i ) );
+      const __m128 z = _mm_add_ps( _mm_loadu_ps( v1.mZ + i ), _mm_loadu_ps( v2.mZ + i ) );
+      _mm_storeu_ps( result.mX + i, x );
+      _mm_storeu_ps( result.mY + i, y );
+      _mm_storeu_ps( result.mZ + i, z );
+   }
+   return n;
+}
+
+inline std::size_t batchSub( const Vec3ArrayView<float>& result, const Vec3ArrayView<const float>& v1,
+                             const Vec3ArrayView<const float>& v2 )
+{
+   if (!(result.isPacked() && v1.isPacked() && v2.isPacked()))
+   {
+      return 0;
+   }
+   const std::size_t n = result.size() & ~std::size_t(3);
+   for (std::size_t i = 0; i < n; i += 4)
+   {
+      const __m128 x = _mm_sub_ps( _mm_loadu_ps( v1.mX + i ), _mm_loadu_ps( v2.mX + i ) );
+      const __m128 y = _mm_sub_ps( _mm_loadu_ps( v1.mY + i ), _mm_loadu_ps( v2.mY + i ) );
+      const __m128 z = _mm_sub_ps( _mm_loadu_ps( v1.mZ + i ), _mm_loadu_ps( v2.mZ + i ) );
+      _mm_storeu_ps( result.mX + i, x );
+      _mm_storeu_ps( result.mY + i, y );
+      _mm_storeu_ps( result.mZ + i, z );
+   }
+   return n;
+}
+
+/** (x1*x2 + y1*y2) + z1*z2, the order of dot(). */
+inline __m128 dot3( const __m128 x1, const __m128 y1, const __m128 z1,
+                    const __m128 x2, const __m128 y2, const __m128 z2 )
+{
+   return _mm_add_ps( _mm_add_ps( _mm_mul_ps( x1, x2 ), _mm_mul_ps( y1, y2 ) ), _mm_mul_ps( z1, z2 ) );
+}
+
+inline std::size_t batchDot( float* result, const Vec3ArrayView<const float>& v1,
+                             const Vec3ArrayView<const float>& v2 )
+{
+   if (!(v1.isPacked() && v2.isPacked()))
+   {
+      return 0;
+   }
+   const std::size_t n = v1.size() & ~std::size_t(3);
+   for (std::size_t i = 0; i < n; i += 4)
+   {
+      _mm_storeu_ps( result + i, dot3( _mm_loadu_ps( v1.mX + i ), _mm_loadu_ps( v1.mY + i ), _mm_loadu_ps( v1.mZ + i ),
+                                       _mm_loadu_ps( v2.mX + i ), _mm_loadu_ps( v2.mY + i ), _mm_loadu_ps( v2.mZ + i ) ) );
+   }
+   return n;
+}
+
+inline std::size_t batchCross( const Vec3ArrayView<float>& result, const Vec3ArrayView<const float>& v1,
+                               const Vec3ArrayView<const float>& v2 )
+{
+   if (!(result.isPacked() && v1.isPacked() && v2.isPacked()))
+   {
+      return 0;
+   }
+   const std::size_t n = result.size() & ~std::size_t(3);
+   for (std::size_t i = 0; i < n; i += 4)
+   {
+      const __m128 x1 = _mm_loadu_ps( v1.mX + i ), y1 = _mm_loadu_ps( v1.mY + i ), z1 = _mm_loadu_ps( v1.mZ + i );
+      const __m128 x2 = _mm_loadu_ps( v2.mX + i ), y2 = _mm_loadu_ps( v2.mY + i ), z2 = _mm_loadu_ps( v2.mZ + i );
+      _mm_storeu_ps( result.mX + i, _mm_sub_ps( _mm_mul_ps( y1, z2 ), _mm_mul_ps( z1, y2 ) ) );
+      _mm_storeu_ps( result.mY + i, _mm_sub_ps( _mm_mul_ps( z1, x2 ), _mm_mul_ps( x1, z2 ) ) );
+      _mm_storeu_ps( result.mZ + i, _mm_sub_ps( _mm_mul_ps( x1, y2 ), _mm_mul_ps( y1, x2 ) ) );
+   }
+   return n;
+}
+
+inline std::size_t batchLength( float* result, const Vec3ArrayView<const float>& v, const bool squared )
+{
+   if (!v.isPacked())
+   {
+      return 0;
+   }
+   const std::size_t n = v.size() & ~std::size_t(3);
+   for (std::size_t i = 0; i < n; i += 4)
+   {
+      const __m128 x = _mm_loadu_ps( v.mX + i ), y = _mm_loadu_ps( v.mY + i ), z = _mm_loadu_ps( v.mZ + i );
+      const __m128 len_sqr = dot3( x, y, z, x, y, z );
+      _mm_storeu_ps( result + i, squared ? len_sqr : _mm_sqrt_ps( len_sqr ) );
+   }
+   return n;
+}
+
+inline std::size_t batchNormalize( const Vec3ArrayView<float>& v, float* lengths )
+{
+   if (!v.isPacked())
+   {
+      return 0;
+   }
+   const std::size_t n = v.size() & ~std::size_t(3);
+   for (std::size_t i = 0; i < n; i += 4)
+   {
+      const __m128 x = _mm_loadu_ps( v.mX + i ), y = _mm_loadu_ps( v.mY + i ), z = _mm_loadu_ps( v.mZ + i );
+      const __m128 len = _mm_sqrt_ps( dot3( x, y, z, x, y, z ) );
+      // zero length vectors are left unchanged
+      const __m128 non_zero = _mm_cmpneq_ps( len, _mm_setzero_ps() );
+      _mm_storeu_ps( v.mX + i, _mm_or_ps( _mm_and_ps( non_zero, _mm_div_ps( x, len ) ), _mm_andnot_ps( non_zero, x ) ) );
+      _mm_storeu_ps( v.mY + i, _mm_or_ps( _mm_and_ps( non_zero, _mm_div_ps( y, len ) ), _mm_andnot_ps( non_zero, y ) ) );
+      _mm_storeu_ps( v.mZ + i, _mm_or_ps( _mm_and_ps( non_zero, _mm_div_ps( z, len ) ), _mm_andnot_ps( non_zero, z ) ) );
+      if (NULL != lengths)
+      {
+         _mm_storeu_ps( lengths + i, len );
+      }
+   }
+   return n;
+}
+
+inline std::size_t batchLerp( const Vec3ArrayView<float>& result, const float& lerpVal,
+                              const Vec3ArrayView<const float>& from, const Vec3ArrayView<const float>& to )
+{
+   if (!(result.isPacked() && from.isPacked() && to.isPacked()))
+   {
+      return 0;
+   }
+   const __m128 t = _mm_set1_ps( lerpVal );
+   const std::size_t n = result.size() & ~std::size_t(3);
+   for (std::size_t i = 0; i < n; i += 4)
+   {
+      // from + (to - from) * t, the order of Math::lerp()
+      const __m128 x = _mm_loadu_ps( from.mX + i ), y = _mm_loadu_ps( from.mY + i ), z = _mm_loadu_ps( from.mZ + i );
+      _mm_storeu_ps( result.mX + i, _mm_add_ps( x, _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( to.mX + i ), x ), t ) ) );
+      _mm_storeu_ps( result.mY + i, _mm_add_ps( y, _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( to.mY + i ), y ), t ) ) );
+      _mm_storeu_ps( result.mZ + i, _mm_add_ps( z, _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( to.mZ + i ), z ), t ) ) );
+   }
+   return n;
+}
+
+inline std::size_t batchReflect( const Vec3ArrayView<float>& result, const Vec3ArrayView<const float>& vec,
+                                 const Vec3ArrayView<const float>& normal )
+{
+   if (!(result.isPacked() && vec.isPacked() && normal.isPacked()))
+   {
+      return 0;
+   }
+   const __m128 two = _mm_set1_ps( 2.0f );
+   const std::size_t n = result.size() & ~std::size_t(3);
+   for (std::size_t i = 0; i < n; i += 4)
+   {
+      // vec - 2 * (dot(vec, normal) * normal)
+      const __m128 x = _mm_loadu_ps( vec.mX + i ), y = _mm_loadu_ps( vec.mY + i ), z = _mm_loadu_ps( vec.mZ + i );
+      const __m128 nx = _mm_loadu_ps( normal.mX + i ), ny = _mm_loadu_ps( normal.mY + i ), nz = _mm_loadu_ps( normal.mZ + i );
+      const __m128 d = dot3( x, y, z, nx, ny, nz );
+      _mm_storeu_ps( result.mX + i, _mm_sub_ps( x, _mm_mul_ps( two, _mm_mul_ps( d, nx ) ) ) );
+      _mm_storeu_ps( result.mY + i, _mm_sub_ps( y, _mm_mul_ps( two, _mm_mul_ps( d, ny ) ) ) );
+      _mm_storeu_ps( result.mZ + i, _mm_sub_ps( z, _mm_mul_ps( two, _mm_mul_ps( d, nz ) ) ) );
+   }
+   return n;
+}
+#endif
+/** @} */
+}
+
+/** @ingroup Ops
+ * @name Batch Vector Operations
+ * @{
+ */
+
+/**
+ * Adds the vectors of v1 and v2: result[i] = v1[i] + v2[i].
+ *
+ * @pre all the views have the same size
+ */
+template<class DATA_TYPE>
+inline void add( const Vec3ArrayView<DATA_TYPE>& result,
+                 const typename Vec3ArrayView<DATA_TYPE>::ConstView& v1,
+                 const typename Vec3ArrayView<DATA_TYPE>::ConstView& v2 )
+{
+   gmtlASSERT( v1.size() == result.size() && v2.size() == result.size() );
+   for (std::size_t i = simd::batchAdd( result, v1, v2 ); i < result.size(); ++i)
+   {
+      result.x( i ) = v1.x( i ) + v2.x( i );
+      result.y( i ) = v1.y( i ) + v2.y( i );
+      result.z( i ) = v1.z( i ) + v2.z( i );
+   }
+}
+
+/**
+ * Subtracts the vectors of v2 from those of v1: result[i] = v1[i] - v2[i].
+ *
+ * @pre all the views have the same size
+ */
+template<class DATA_TYPE>
+inline void sub( const Vec3ArrayView<DATA_TYPE>& result,
+                 const typename Vec3ArrayView<DATA_TYPE>::ConstView& v1,
+                 const typename Vec3ArrayView<DATA_TYPE>::ConstView& v2 )
+{
+   gmtlASSERT( v1.size() == result.size() && v2.size() == result.size() );
+   for (std::size_t i = simd::batchSub( result, v1, v2 ); i < result.size(); ++i)
+   {
+      result.x( i ) = v1.x( i ) - v2.x( i );
+      result.y( i ) = v1.y( i ) - v2.y( i );
+      result.z( i ) = v1.z( i ) - v2.z( i );
+   }
+}
+
+/**
+ * Computes the dot products result[i] = dot(v1[i], v2[i]).
+ *
+ * @param result  array of v1.size() elements, filled with the dot products
+ * @pre v1 and v2 have the same size
+ */
+template<class DATA_TYPE>
+inline void dot( DATA_TYPE* result,
+                 const typename Vec3ArrayView<DATA_TYPE>::ConstView& v1,
+                 const typename Vec3ArrayView<DATA_TYPE>::ConstView& v2 )
+{
+   gmtlASSERT( v1.size() == v2.size() );
+   for (std::size_t i = simd::batchDot( result, v1, v2 ); i < v1.size(); ++i)
+   {
+      result[i] = (v1.x( i ) * v2.x( i )) + (v1.y( i ) * v2.y( i )) + (v1.z( i ) * v2.z( i ));
+   }
+}
+
+/**
+ * Computes the cross products result[i] = v1[i] x v2[i].
+ *
+ * @pre all the views have the same size
+ */
+template<class DATA_TYPE>
+inline void cross( const Vec3ArrayView<DATA_TYPE>& result,
+                   const typename Vec3ArrayView<DATA_TYPE>::ConstView& v1,
+                   const typename Vec3ArrayView<DATA_TYPE>::ConstView& v2 )
+{
+   gmtlASSERT( v1.size() == result.size() && v2.size() == result.size() );
+   for (std::size_t i = simd::batchCross( result, v1, v2 ); i < result.size(); ++i)
+   {
+      const DATA_TYPE x = (v1.y( i ) * v2.z( i )) - (v1.z( i ) * v2.y( i ));
+      const DATA_TYPE y = (v1.z( i ) * v2.x( i )) - (v1.x( i ) * v2.z( i ));
+      const DATA_TYPE z = (v1.x( i ) * v2.y( i )) - (v1.y( i ) * v2.x( i ));
+      result.x( i ) = x;
+      result.y( i ) = y;
+      result.z( i ) = z;
+   }
+}
+
+/**
+ * Computes the lengths result[i] = length(v[i]).
+ *
+ * @param result  array of v.size() elements, filled with the lengths
+ */
+template<class DATA_TYPE>
+inline void length( DATA_TYPE* result, const typename Vec3ArrayView<DATA_TYPE>::ConstView& v )
+{
+   for (std::size_t i = simd::batchLength( result, v, false ); i < v.size(); ++i)
+   {
+      const DATA_TYPE len_sqr = (v.x( i ) * v.x( i )) + (v.y( i ) * v.y( i )) + (v.z( i ) * v.z( i ));
+      result[i] = (len_sqr == DATA_TYPE(0)) ? DATA_TYPE(0) : Math::sqrt( len_sqr );
+   }
+}
+
+/**
+ * Computes the squared lengths result[i] = lengthSquared(v[i]).
+ *
+ * @param result  array of v.size() elements, filled with the squared lengths
+ */
+template<class DATA_TYPE>
+inline void lengthSquared( DATA_TYPE* result, const typename Vec3ArrayView<DATA_TYPE>::ConstView& v )
+{
+   for (std::size_t i = simd::batchLength( result, v, true ); i < v.size(); ++i)
+   {
+      result[i] = (v.x( i ) * v.x( i )) + (v.y( i ) * v.y( i )) + (v.z( i ) * v.z( i ));
+   }
+}
+
+/**
+ * Normalizes the vectors of v in place.  Vectors of length zero are left
+ * unchanged, like normalize() does.
+ *
+ * @param lengths  if not NULL, an array of v.size() elements that is filled
+ *                 with the lengths of the vectors before normalization
+ */
+template<class DATA_TYPE>
+inline void normalize( const Vec3ArrayView<DATA_TYPE>& v, DATA_TYPE* lengths = NULL )
+{
+   for (std::size_t i = simd::batchNormalize( v, lengths ); i < v.size(); ++i)
+   {
+      const DATA_TYPE len_sqr = (v.x( i ) * v.x( i )) + (v.y( i ) * v.y( i )) + (v.z( i ) * v.z( i ));
+      const DATA_TYPE len = (len_sqr == DATA_TYPE(0)) ? DATA_TYPE(0) : Math::sqrt( len_sqr );
+      if (len != DATA_TYPE(0))
+      {
+         v.x( i ) /= len;
+         v.y( i ) /= len;
+         v.z( i ) /= len;
+      }
+      if (NULL != lengths)
+      {
+         lengths[i] = len;
+      }
+   }
+}
+
+/**
+ * Linearly interpolates between the vectors of from and to, with the same
+ * lerpVal for all of them.
+ *
+ * @pre all the views have the same size
+ * @see lerp(VecBase<DATA_TYPE, SIZE>&, const DATA_TYPE&, const VecBase<DATA_TYPE, SIZE>&, const VecBase<DATA_TYPE, SIZE>&)
+ */
+template<class DATA_TYPE>
+inline void lerp( const Vec3ArrayView<DATA_TYPE>& result, const DATA_TYPE& lerpVal,
+                  const typename Vec3ArrayView<DATA_TYPE>::ConstView& from,
+                  const typename Vec3ArrayView<DATA_TYPE>::ConstView& to )
+{
+   gmtlASSERT( from.size() == result.size() && to.size() == result.size() );
+   for (std::size_t i = simd::batchLerp( result, lerpVal, from, to ); i < result.size(); ++i)
+   {
+      Math::lerp( result.x( i ), lerpVal, from.x( i ), to.x( i ) );
+      Math::lerp( result.y( i ), lerpVal, from.y( i ), to.y( i ) );
+      Math::lerp( result.z( i ), lerpVal, from.z( i ), to.z( i ) );
+   }
+}
+
+/**
+ * Reflects each vector of vec about the matching normal.
+ *
+ * @pre all the views have the same size
+ * @see reflect(VecBase<DATA_TYPE, SIZE>&, const VecBase<DATA_TYPE, SIZE>&, const Vec<DATA_TYPE, SIZE>&)
+ */
+template<class DATA_TYPE>
+inline void reflect( const Vec3ArrayView<DATA_TYPE>& result,
+                     const typename Vec3ArrayView<DATA_TYPE>::ConstView& vec,
+                     const typename Vec3ArrayView<DATA_TYPE>::ConstView& normal )
+{
+   gmtlASSERT( vec.size() == result.size() && normal.size() == result.size() );
+   for (std::size_t i = simd::batchReflect( result, vec, normal ); i < result.size(); ++i)
+   {
+      const DATA_TYPE d = (vec.x( i ) * normal.x( i )) + (vec.y( i ) * normal.y( i )) + (vec.z( i ) * normal.z( i ));
+      result.x( i ) = vec.x( i ) - (DATA_TYPE(2.0) * (d * normal.x( i )));
+      result.y( i ) = vec.y( i ) - (DATA_TYPE(2.0) * (d * normal.y( i )));
+      result.z( i ) = vec.z( i ) - (DATA_TYPE(2.0) * (d * normal.z( i )));
+   }
+}
+
+/** @} */
+
+} // end namespace gmtl
+
+#endif
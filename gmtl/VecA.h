@@ -0,0 +1,156 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_VECA_H_
+#define _GMTL_VECA_H_
+
+#include <gmtl/Defines.h>
+#include <gmtl/Vec.h>
+
+namespace gmtl
+{
+
+/**
+ * A Vec3f that is aligned to 16 bytes and padded to four floats, so that it
+ * can be loaded into a SIMD register in one aligned load.
+ *
+ * Vec3fA is a Vec3f: every function that takes a Vec3f (or a VecBase) takes
+ * a Vec3fA as well, and the x, y, z components are at the same offsets.
+ * The SIMD versions of the VecOps.h functions are in VecAOps.h.  The pad
+ * element is not a component: the value constructors set it to zero and
+ * no result depends on it.
+ *
+ * Arrays of Vec3fA are 16 bytes per element instead of 12.  Containers must
+ * honor the alignment, which std::vector does from C++17 on.
+ *
+ * @see Vec3f
+ * @see Vec4fA
+ * @ingroup Types
+ */
+class GMTL_ALIGN(16) Vec3fA : public Vec<float, 3>
+{
+public:
+   /// The superclass type.
+   typedef Vec<float, 3> BaseType;
+
+   /** Default constructor. All components are initialized to zero. */
+   Vec3fA()
+      : mPad( 0.0f )
+   {
+   }
+
+   /** No-init constructor. The components are left uninitialized. */
+   explicit Vec3fA( NoInit )
+      : BaseType( NO_INIT )
+   {
+   }
+
+   Vec3fA( const float& val0, const float& val1, const float& val2 )
+      : BaseType( val0, val1, val2 ), mPad( 0.0f )
+   {
+   }
+
+   /** Creates an aligned copy of the given vector or vector expression.
+    *  Explicit, so that mixing aligned and unaligned arguments picks the
+    *  templates instead of being ambiguous.
+    */
+#ifdef GMTL_NO_METAPROG
+   explicit Vec3fA( const VecBase<float, 3>& rVec )
+      : BaseType( rVec ), mPad( 0.0f )
+   {
+   }
+
+   inline Vec3fA& operator=( const VecBase<float, 3>& rhs )
+   {
+      BaseType::operator=( rhs );
+      return *this;
+   }
+#else
+   template<typename REP2>
+   explicit Vec3fA( const VecBase<float, 3, REP2>& rVec )
+      : BaseType( rVec ), mPad( 0.0f )
+   {
+   }
+
+   template<typename REP2>
+   inline Vec3fA& operator=( const VecBase<float, 3, REP2>& rhs )
+   {
+      BaseType::operator=( rhs );
+      return *this;
+   }
+#endif
+
+public:
+   /// Pads the vector to 16 bytes, not a component.
+   float mPad;
+};
+
+/**
+ * A Vec4f that is aligned to 16 bytes.  The layout is the same as Vec4f, so
+ * arrays of the two can be converted into each other.
+ *
+ * Vec4fA is a Vec4f: every function that takes a Vec4f takes a Vec4fA as
+ * well.  The SIMD versions of the VecOps.h functions are in VecAOps.h.
+ *
+ * @see Vec4f
+ * @see Vec3fA
+ * @ingroup Types
+ */
+class GMTL_ALIGN(16) Vec4fA : public Vec<float, 4>
+{
+public:
+   /// The superclass type.
+   typedef Vec<float, 4> BaseType;
+
+   /** Default constructor. All components are initialized to zero. */
+   Vec4fA()
+   {
+   }
+
+   /** No-init constructor. The components are left uninitialized. */
+   explicit Vec4fA( NoInit )
+      : BaseType( NO_INIT )
+   {
+   }
+
+   Vec4fA( const float& val0, const float& val1, const float& val2, const float& val3 )
+      : BaseType( val0, val1, val2, val3 )
+   {
+   }
+
+   /** Creates an aligned copy of the given vector or vector expression.
+    *  Explicit, so that mixing aligned and unaligned arguments picks the
+    *  templates instead of being ambiguous.
+    */
+#ifdef GMTL_NO_METAPROG
+   explicit Vec4fA( const VecBase<float, 4>& rVec )
+      : BaseType( rVec )
+   {
+   }
+
+   inline Vec4fA& operator=( const VecBase<float, 4>& rhs )
+   {
+      BaseType::operator=( rhs );
+      return *this;
+   }
+#else
+   template<typename REP2>
+   explicit Vec4fA( const VecBase<float, 4, REP2>& rVec )
+      : BaseType( rVec )
+   {
+   }
+
+   template<typename REP2>
+   inline Vec4fA& operator=( const VecBase<float, 4, REP2>& rhs )
+   {
+      BaseType::operator=( rhs );
+      return *this;
+   }
+#endif
+};
+
+} // end of namespace gmtl
+
+#endif
@@ -0,0 +1,218 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_VECA_OPS_H_
+#define _GMTL_VECA_OPS_H_
+
+#include <gmtl/VecA.h>
+#include <gmtl/VecOps.h>
+#include <gmtl/Matrix.h>
+#include <gmtl/Xforms.h>
+#include <gmtl/Util/Simd.h>
+
+/** @file VecAOps.h
+ * SSE2 versions of the VecOps.h and Xforms.h functions for the aligned
+ * Vec3fA and Vec4fA types.
+ *
+ * They are non-template overloads, so they are picked over the templates
+ * whenever all the vector arguments are aligned types.  The operations are
+ * done in the same order as in the templates, so the results only differ
+ * where the compiler contracts the templates into FMAs.  Without SSE2 (or
+ * with GMTL_NO_SIMD) the templates are used.
+ */
+
+#ifdef GMTL_HAVE_SSE2
+namespace gmtl
+{
+/** @ingroup Ops
+ * @name Aligned Vector Operations
+ * @{
+ */
+
+// --- dot, length and normalize --- //
+
+inline float dot( const Vec3fA& v1, const Vec3fA& v2 )
+{
+   const __m128 m = _mm_mul_ps( _mm_load_ps( v1.mData ), _mm_load_ps( v2.mData ) );
+   return _mm_cvtss_f32( simd::sum3( m ) );
+}
+
+inline float dot( const Vec4fA& v1, const Vec4fA& v2 )
+{
+   const __m128 m = _mm_mul_ps( _mm_load_ps( v1.mData ), _mm_load_ps( v2.mData ) );
+   return _mm_cvtss_f32( simd::sum4( m ) );
+}
+
+inline float lengthSquared( const Vec3fA& v1 )
+{
+   return dot( v1, v1 );
+}
+
+inline float lengthSquared( const Vec4fA& v1 )
+{
+   return dot( v1, v1 );
+}
+
+inline float length( const Vec3fA& v1 )
+{
+   const float len_sqr = lengthSquared( v1 );
+   return (len_sqr == 0.0f) ? 0.0f : Math::sqrt( len_sqr );
+}
+
+inline float length( const Vec4fA& v1 )
+{
+   const float len_sqr = lengthSquared( v1 );
+   return (len_sqr == 0.0f) ? 0.0f : Math::sqrt( len_sqr );
+}
+
+/** @see normalize(Vec<DATA_TYPE, SIZE>&) */
+inline float normalize( Vec3fA& v1 )
+{
+   const float len = length( v1 );
+   if (len != 0.0f)
+   {
+      _mm_store_ps( v1.mData, _mm_div_ps( _mm_load_ps( v1.mData ), _mm_set1_ps( len ) ) );
+   }
+   return len;
+}
+
+/** @see normalize(Vec<DATA_TYPE, SIZE>&) */
+inline float normalize( Vec4fA& v1 )
+{
+   const float len = length( v1 );
+   if (len != 0.0f)
+   {
+      _mm_store_ps( v1.mData, _mm_div_ps( _mm_load_ps( v1.mData ), _mm_set1_ps( len ) ) );
+   }
+   return len;
+}
+
+inline bool isNormalized( const Vec3fA& v1, const float eps = 0.0001f )
+{
+   return Math::isEqual( lengthSquared( v1 ), 1.0f, eps );
+}
+
+inline bool isNormalized( const Vec4fA& v1, const float eps = 0.0001f )
+{
+   return Math::isEqual( lengthSquared( v1 ), 1.0f, eps );
+}
+
+// --- cross --- //
+
+/** @see cross(Vec<DATA_TYPE,3>&, const Vec<DATA_TYPE,3>&, const Vec<DATA_TYPE,3>&) */
+inline Vec3fA& cross( Vec3fA& result, const Vec3fA& v1, const Vec3fA& v2 )
+{
+   const __m128 c = simd::cross3( _mm_load_ps( v1.mData ), _mm_load_ps( v2.mData ) );
+   // keep the pad at zero
+   const __m128 xyz_mask = _mm_castsi128_ps( _mm_set_epi32( 0, -1, -1, -1 ) );
+   _mm_store_ps( result.mData, _mm_and_ps( c, xyz_mask ) );
+   return result;
+}
+
+inline Vec3fA operator^( const Vec3fA& v1, const Vec3fA& v2 )
+{
+   Vec3fA result( NO_INIT );
+   return cross( result, v1, v2 );
+}
+
+// --- element-wise ops --- //
+// The pad of a Vec3fA stays zero: 0 + 0, 0 - 0 and 0 * s are all zero.
+
+inline Vec3fA& operator+=( Vec3fA& v1, const Vec3fA& v2 )
+{
+   _mm_store_ps( v1.mData, _mm_add_ps( _mm_load_ps( v1.mData ), _mm_load_ps( v2.mData ) ) );
+   return v1;
+}
+
+inline Vec4fA& operator+=( Vec4fA& v1, const Vec4fA& v2 )
+{
+   _mm_store_ps( v1.mData, _mm_add_ps( _mm_load_ps( v1.mData ), _mm_load_ps( v2.mData ) ) );
+   return v1;
+}
+
+inline Vec3fA& operator-=( Vec3fA& v1, const Vec3fA& v2 )
+{
+   _mm_store_ps( v1.mData, _mm_sub_ps( _mm_load_ps( v1.mData ), _mm_load_ps( v2.mData ) ) );
+   return v1;
+}
+
+inline Vec4fA& operator-=( Vec4fA& v1, const Vec4fA& v2 )
+{
+   _mm_store_ps( v1.mData, _mm_sub_ps( _mm_load_ps( v1.mData ), _mm_load_ps( v2.mData ) ) );
+   return v1;
+}
+
+inline Vec3fA& operator*=( Vec3fA& v1, const float scalar )
+{
+   _mm_store_ps( v1.mData, _mm_mul_ps( _mm_load_ps( v1.mData ), _mm_set1_ps( scalar ) ) );
+   return v1;
+}
+
+inline Vec4fA& operator*=( Vec4fA& v1, const float scalar )
+{
+   _mm_store_ps( v1.mData, _mm_mul_ps( _mm_load_ps( v1.mData ), _mm_set1_ps( scalar ) ) );
+   return v1;
+}
+
+/** @} */
+
+/** @ingroup Transforms
+ * @name Aligned Vector Transforms (Matrix)
+ * @{
+ */
+
+/** @see xform(Vec<DATA_TYPE, COLS>&, const Matrix<DATA_TYPE, ROWS, COLS>&, const Vec<DATA_TYPE, COLS>&) */
+inline Vec4fA& xform( Vec4fA& result, const Matrix44f& matrix, const Vec4fA& vector )
+{
+   const float* m = matrix.mData;
+   const __m128 v = _mm_load_ps( vector.mData );
+   __m128 r = _mm_mul_ps( _mm_loadu_ps( m ), _mm_shuffle_ps( v, v, _MM_SHUFFLE(0, 0, 0, 0) ) );
+   r = _mm_add_ps( r, _mm_mul_ps( _mm_loadu_ps( m + 4 ), _mm_shuffle_ps( v, v, _MM_SHUFFLE(1, 1, 1, 1) ) ) );
+   r = _mm_add_ps( r, _mm_mul_ps( _mm_loadu_ps( m + 8 ), _mm_shuffle_ps( v, v, _MM_SHUFFLE(2, 2, 2, 2) ) ) );
+   r = _mm_add_ps( r, _mm_mul_ps( _mm_loadu_ps( m + 12 ), _mm_shuffle_ps( v, v, _MM_SHUFFLE(3, 3, 3, 3) ) ) );
+   _mm_store_ps( result.mData, r );
+   return result;
+}
+
+inline Vec4fA operator*( const Matrix44f& matrix, const Vec4fA& vector )
+{
+   Vec4fA temporary( NO_INIT );
+   return xform( temporary, matrix, vector );
+}
+
+/** The vector is treated as [vector, 0.0].
+ *  @see xform(Vec<DATA_TYPE, VEC_SIZE>&, const Matrix<DATA_TYPE, ROWS, COLS>&, const Vec<DATA_TYPE, VEC_SIZE>&)
+ */
+inline Vec3fA& xform( Vec3fA& result, const Matrix44f& matrix, const Vec3fA& vector )
+{
+   const float* m = matrix.mData;
+   const __m128 v = _mm_load_ps( vector.mData );
+   __m128 r = _mm_mul_ps( _mm_loadu_ps( m ), _mm_shuffle_ps( v, v, _MM_SHUFFLE(0, 0, 0, 0) ) );
+   r = _mm_add_ps( r, _mm_mul_ps( _mm_loadu_ps( m + 4 ), _mm_shuffle_ps( v, v, _MM_SHUFFLE(1, 1, 1, 1) ) ) );
+   r = _mm_add_ps( r, _mm_mul_ps( _mm_loadu_ps( m + 8 ), _mm_shuffle_ps( v, v, _MM_SHUFFLE(2, 2, 2, 2) ) ) );
+
+   // some matrices will make W non-zero even for a true vector
+   const float w = _mm_cvtss_f32( _mm_shuffle_ps( r, r, _MM_SHUFFLE(3, 3, 3, 3) ) );
+   if (Math::isEqual( w, 0.0f, 0.0001f ) == false)
+   {
+      r = _mm_mul_ps( r, _mm_set1_ps( 1.0f / w ) );
+   }
+   const __m128 xyz_mask = _mm_castsi128_ps( _mm_set_epi32( 0, -1, -1, -1 ) );
+   _mm_store_ps( result.mData, _mm_and_ps( r, xyz_mask ) );
+   return result;
+}
+
+inline Vec3fA operator*( const Matrix44f& matrix, const Vec3fA& vector )
+{
+   Vec3fA temporary( NO_INIT );
+   return xform( temporary, matrix, vector );
+}
+
+/** @} */
+
+} // end namespace gmtl
+#endif
+
+#endif
@@ -35,7 +35,7 @@ namespace gmtl
 template<typename DATA_TYPE, unsigned SIZE>
 Vec<DATA_TYPE, SIZE> operator- (const VecBase<DATA_TYPE, SIZE>& v1)
 {
-   Vec<DATA_TYPE, SIZE> ret_val;
+   Vec<DATA_TYPE, SIZE> ret_val( NO_INIT );
    for ( unsigned i=0; i < SIZE; ++i )
    {
       ret_val[i] = -v1[i];
@@ -496,7 +496,7 @@ template<class DATA_TYPE>
 inline Vec<DATA_TYPE, 3> operator^( const Vec<DATA_TYPE, 3>& v1,
                          const Vec<DATA_TYPE, 3>& v2 )
 {
-    Vec<DATA_TYPE, 3> result;
+    Vec<DATA_TYPE, 3> result( NO_INIT );
     cross( result, v1, v2 );
     return( result );
 }
@@ -0,0 +1,195 @@
+// GMTL is (C) Copyright 2001-2011 by Allen Bierbaum
+// Distributed under the GNU Lesser General Public License 2.1 with an
+// addendum covering inlined code. (See accompanying files LICENSE and
+// LICENSE.addendum or http://www.gnu.org/copyleft/lesser.txt)
+
+#ifndef _GMTL_VEC_PACK_H_
+#define _GMTL_VEC_PACK_H_
+
+#include <cstddef>
+#include <gmtl/Math.h>
+#include <gmtl/Vec.h>
+#include <gmtl/QuatPack.h>
+#include <gmtl/Util/Simd.h>
+#include <gmtl/Util/StaticAssert.h>
+
+namespace gmtl
+{
+
+/** A unit vector packed into 32 bits with the octahedral encoding.
+ *
+ * The unit sphere is projected onto the octahedron |x| + |y| + |z| = 1,
+ * and the lower half of the octahedron is folded over the upper half, which
+ * maps the sphere onto the square [-1, 1]^2.  The two coordinates in the
+ * square are stored as 16 bit signed fixed point numbers.  A Vec3f is 12
+ * bytes.
+ *
+ * The maximum angle between a unit vector and its unpacked vector is
+ * 0.004 degrees.  Unpacked vectors are unit length (up to rounding).
+ *
+ * @see pack(PackedNormal32&, const Vec<DATA_TYPE, 3>&)
+ * @ingroup Types
+ */
+class PackedNormal32
+{
+public:
+   PackedNormal32()
+   {
+      mData[0] = mData[1] = 0;
+   }
+
+   short mData[2];
+};
+
+/** @ingroup Types
+ * @name Packing Normals
+ * With SSE2, the float batch versions convert four vectors at a time, with
+ * the same arithmetic as the single vector versions.  Results only differ
+ * where the compiler contracts the single versions into FMAs: an unpacked
+ * component in its last bits, or very rarely a packed component by one
+ * step.
+ * @{
+ */
+
+   /** packs a unit vector into 32 bits with the octahedral encoding.
+    *  @pre normal is not zero (it need not be unit length)
+    *  @return result
+    */
+   template <typename DATA_TYPE>
+   inline PackedNormal32& pack( PackedNormal32& result, const Vec<DATA_TYPE, 3>& normal )
+   {
+      GMTL_STATIC_ASSERT( sizeof(PackedNormal32) == 4, PackedNormal32_is_not_32_bits );
+      const DATA_TYPE zero = static_cast<DATA_TYPE>(0.0);
+      const DATA_TYPE one = static_cast<DATA_TYPE>(1.0);
+
+      // project onto the octahedron
+      const DATA_TYPE inv_sum = one / ((Math::abs( normal[0] ) + Math::abs( normal[1] )) + Math::abs( normal[2] ));
+      DATA_TYPE x = normal[0] * inv_sum;
+      DATA_TYPE y = normal[1] * inv_sum;
+
+      // fold the lower half over the upper half
+      if (normal[2] < zero)
+      {
+         const DATA_TYPE folded_x = one - Math::abs( y );
+         const DATA_TYPE folded_y = one - Math::abs( x );
+         x = (x < zero) ? -folded_x : folded_x;
+         y = (y < zero) ? -folded_y : folded_y;
+      }
+
+      result.mData[0] = PackQuantizer<DATA_TYPE, 16>::encodeSigned( x );
+      result.mData[1] = PackQuantizer<DATA_TYPE, 16>::encodeSigned( y );
+      return result;
+   }
+
+   /** unpacks a unit vector packed with the octahedral encoding.
+    *  @return result
+    */
+   template <typename DATA_TYPE>
+   inline Vec<DATA_TYPE, 3>& unpack( Vec<DATA_TYPE, 3>& result, const PackedNormal32& packed )
+   {
+      const DATA_TYPE zero = static_cast<DATA_TYPE>(0.0);
+      const DATA_TYPE one = static_cast<DATA_TYPE>(1.0);
+      DATA_TYPE x = PackQuantizer<DATA_TYPE, 16>::decodeSigned( packed.mData[0] );
+      DATA_TYPE y = PackQuantizer<DATA_TYPE, 16>::decodeSigned( packed.mData[1] );
+      const DATA_TYPE z = (one - Math::abs( x )) - Math::abs( y );
+
+      // unfold the lower half
+      const DATA_TYPE t = Math::Max( -z, zero );
+      x = x + ((x >= zero) ? -t : t);
+      y = y + ((y >= zero) ? -t : t);
+
+      const DATA_TYPE inv_len = one / Math::sqrt( (x * x + y * y) + z * z );
+      result.set( x * inv_len, y * inv_len, z * inv_len );
+      return result;
+   }
+
+   /** packs count unit vectors. */
+   template <typename DATA_TYPE>
+   inline void pack( PackedNormal32* result, const Vec<DATA_TYPE, 3>* normals, const std::size_t count )
+   {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         pack( result[i], normals[i] );
+      }
+   }
+
+   /** unpacks count unit vectors. */
+   template <typename DATA_TYPE>
+   inline void unpack( Vec<DATA_TYPE, 3>* result, const PackedNormal32* packed, const std::size_t count )
+   {
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         unpack( result[i], packed[i] );
+      }
+   }
+
+#ifdef GMTL_HAVE_SSE2
+   /** SSE2 version of the batch pack() for PackedNormal32. */
+   inline void pack( PackedNormal32* result, const Vec<float, 3>* normals, const std::size_t count )
+   {
+      const std::size_t blocks = count & ~std::size_t(3);
+      const __m128 sign = _mm_set1_ps( -0.0f );
+      const __m128 one = _mm_set1_ps( 1.0f );
+      for (std::size_t i = 0; i < blocks; i += 4)
+      {
+         __m128 nx, ny, nz;
+         simd::loadVec3x4( nx, ny, nz, reinterpret_cast<const char*>( normals + i ), sizeof(Vec<float, 3>) );
+
+         const __m128 sum = _mm_add_ps( _mm_add_ps( _mm_andnot_ps( sign, nx ), _mm_andnot_ps( sign, ny ) ),
+                                        _mm_andnot_ps( sign, nz ) );
+         const __m128 inv_sum = _mm_div_ps( one, sum );
+         const __m128 x = _mm_mul_ps( nx, inv_sum );
+         const __m128 y = _mm_mul_ps( ny, inv_sum );
+
+         const __m128 folded_x = _mm_xor_ps( _mm_sub_ps( one, _mm_andnot_ps( sign, y ) ),
+                                             _mm_and_ps( _mm_cmplt_ps( x, _mm_setzero_ps() ), sign ) );
+         const __m128 folded_y = _mm_xor_ps( _mm_sub_ps( one, _mm_andnot_ps( sign, x ) ),
+                                             _mm_and_ps( _mm_cmplt_ps( y, _mm_setzero_ps() ), sign ) );
+         const __m128 lower = _mm_cmplt_ps( nz, _mm_setzero_ps() );
+         const __m128i qx = simd::quantizeSigned4( simd::select( lower, folded_x, x ) );
+         const __m128i qy = simd::quantizeSigned4( simd::select( lower, folded_y, y ) );
+
+         // interleave x and y as 16 bit values
+         const __m128i lo = _mm_unpacklo_epi32( qx, qy );
+         const __m128i hi = _mm_unpackhi_epi32( qx, qy );
+         _mm_storeu_si128( reinterpret_cast<__m128i*>( result[i].mData ), _mm_packs_epi32( lo, hi ) );
+      }
+      pack<float>( result + blocks, normals + blocks, count - blocks );
+   }
+
+   /** SSE2 version of the batch unpack() for PackedNormal32. */
+   inline void unpack( Vec<float, 3>* result, const PackedNormal32* packed, const std::size_t count )
+   {
+      const std::size_t blocks = count & ~std::size_t(3);
+      const __m128 sign = _mm_set1_ps( -0.0f );
+      const __m128 one = _mm_set1_ps( 1.0f );
+      const __m128 scale = _mm_set1_ps( PackQuantizer<float, 16>::decodeSigned( 1 ) );
+      for (std::size_t i = 0; i < blocks; i += 4)
+      {
+         // sign extend the x and y of four normals to 32 bits, and split them
+         const __m128i bits = _mm_loadu_si128( reinterpret_cast<const __m128i*>( packed[i].mData ) );
+         const __m128i qx = _mm_srai_epi32( _mm_slli_epi32( bits, 16 ), 16 );
+         const __m128i qy = _mm_srai_epi32( bits, 16 );
+         __m128 x = _mm_mul_ps( _mm_cvtepi32_ps( qx ), scale );
+         __m128 y = _mm_mul_ps( _mm_cvtepi32_ps( qy ), scale );
+         const __m128 z = _mm_sub_ps( _mm_sub_ps( one, _mm_andnot_ps( sign, x ) ), _mm_andnot_ps( sign, y ) );
+
+         const __m128 t = _mm_max_ps( _mm_xor_ps( z, sign ), _mm_setzero_ps() );
+         x = _mm_add_ps( x, _mm_xor_ps( t, _mm_and_ps( _mm_cmpge_ps( x, _mm_setzero_ps() ), sign ) ) );
+         y = _mm_add_ps( y, _mm_xor_ps( t, _mm_and_ps( _mm_cmpge_ps( y, _mm_setzero_ps() ), sign ) ) );
+
+         const __m128 len = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ),
+                                                     _mm_mul_ps( z, z ) ) );
+         const __m128 inv_len = _mm_div_ps( one, len );
+         simd::storeVec3x4( reinterpret_cast<char*>( result + i ), sizeof(Vec<float, 3>),
+                            _mm_mul_ps( x, inv_len ), _mm_mul_ps( y, inv_len ), _mm_mul_ps( z, inv_len ) );
+      }
+      unpack<float>( result + blocks, packed + blocks, count - blocks );
+   }
+#endif
+
+/** @} */
+
+} // end of namespace gmtl
+
+#endif
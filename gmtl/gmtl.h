@@ -6,6 +6,8 @@
 #ifndef _GMTL_GMTL_H_
 #define _GMTL_GMTL_H_
 
+// BVH.h, BVHOps.h and LinearBVH.h are not included here: the BVH builds
+// and refits with gmtl/Util/ThreadPool.h, which needs C++11 threads.
 #include <gmtl/AABox.h>
 #include <gmtl/AABoxOps.h>
 #include <gmtl/AxisAngle.h>
@@ -16,6 +18,8 @@
 #include <gmtl/Defines.h>
 #include <gmtl/EulerAngle.h>
 #include <gmtl/EulerAngleOps.h>
+#include <gmtl/Frustum.h>
+#include <gmtl/FrustumOps.h>
 #include <gmtl/Generate.h>
 #include <gmtl/Intersection.h>
 #include <gmtl/LineSeg.h>
@@ -23,20 +27,34 @@
 #include <gmtl/Math.h>
 #include <gmtl/Matrix.h>
 #include <gmtl/MatrixOps.h>
+#include <gmtl/OOBox.h>
 #include <gmtl/Output.h>
 #include <gmtl/Plane.h>
 #include <gmtl/PlaneOps.h>
 #include <gmtl/Point.h>
 #include <gmtl/Quat.h>
 #include <gmtl/QuatOps.h>
+#include <gmtl/QuatA.h>
+#include <gmtl/QuatAOps.h>
+#include <gmtl/QuatSpline.h>
+#include <gmtl/QuatPack.h>
 #include <gmtl/Ray.h>
+#include <gmtl/RayPacket.h>
+#include <gmtl/RayPacketOps.h>
 #include <gmtl/Sphere.h>
 #include <gmtl/SphereOps.h>
 #include <gmtl/Tri.h>
 #include <gmtl/TriOps.h>
+#include <gmtl/TriBlock.h>
+#include <gmtl/TriBlockOps.h>
 #include <gmtl/VecBase.h>
 #include <gmtl/Vec.h>
+#include <gmtl/Vec3Array.h>
+#include <gmtl/Vec3ArrayOps.h>
 #include <gmtl/VecOps.h>
+#include <gmtl/VecA.h>
+#include <gmtl/VecAOps.h>
+#include <gmtl/VecPack.h>
 #include <gmtl/Version.h>
 #include <gmtl/Xforms.h>
 